@@ -9,6 +9,7 @@
 */
 
 #include <cstdio>
+#include <cstdlib>
 #include <thread>
 #include <iostream>
 #include <vector>
@@ -20,6 +21,7 @@ using namespace hixl;
 namespace {
 constexpr int32_t kWaitTransTime = 20;
 constexpr int32_t kExpectedArgCnt = 8;
+constexpr int32_t kExpectedArgCntWithTransport = 9;
 constexpr uint32_t kArgIndexDeviceId = 1;
 constexpr uint32_t kArgIndexLocalEngine = 2;
 constexpr uint32_t kArgIndexRemoteEngine = 3;
@@ -27,6 +29,7 @@ constexpr uint32_t kArgIndexTcpPort = 4;
 constexpr uint32_t kArgIndexTransferMode = 5;
 constexpr uint32_t kArgIndexTransferOp = 6;
 constexpr uint32_t kArgIndexUseBufferPool = 7;
+constexpr uint32_t kArgIndexTransport = 8;
 constexpr uint32_t kTransferMemSize = 134217728;  // 128M
 constexpr uint32_t kBaseBlockSize = 262144;       // 0.25M
 constexpr uint32_t kExecuteRepeatNum = 5;
@@ -42,6 +45,29 @@ constexpr int32_t kPortMaxValue = 65535;
   } while (0)
 }  // namespace
 
+// hccl为默认的硬件链路; loopback为HixlCS的host内存回环传输, 需要hixl以ENABLE_CS_LOOPBACK编译, 只支持h2h
+int32_t SelectTransport(const std::string &transport, const std::string &transfer_mode) {
+  if (transport == "hccl") {
+    return 0;
+  }
+  if (transport != "loopback") {
+    printf("[ERROR] Invalid value for transport: %s\n", transport.c_str());
+    return -1;
+  }
+#ifdef HIXL_CS_LOOPBACK_ENABLED
+  if (transfer_mode != "h2h") {
+    printf("[ERROR] Loopback transport only supports h2h, but got transfer_mode: %s\n", transfer_mode.c_str());
+    return -1;
+  }
+  (void)setenv("HIXL_CS_LOOPBACK", "1", 1);
+  return 0;
+#else
+  (void)transfer_mode;
+  printf("[ERROR] Loopback transport is not available, rebuild with -DENABLE_CS_LOOPBACK=ON\n");
+  return -1;
+#endif
+}
+
 int32_t Initialize(Hixl &hixl_engine, const char *local_engine, bool use_buffer_pool) {
   std::map<AscendString, AscendString> options;
   // 在不需要使用中转buffer进行传输的场景下，关闭中转内存池
@@ -104,6 +130,11 @@ int32_t Transfer(Hixl &hixl_engine, int32_t &src, const char *remote_engine, uin
     printf(
         "[INFO] Transfer success, block size: %u Bytes, transfer num: %u, time cost: %ld us, throughput: %.3lf GB/s\n",
         block_size, trans_num, time_cost, throughput);
+    // 机器可读的结果行
+    printf(
+        "[RESULT] {\"benchmark\":\"hixl\",\"transfer_op\":\"%s\",\"block_size\":%u,\"transfer_num\":%u,"
+        "\"time_cost_us\":%ld,\"throughput_gbps\":%.3lf}\n",
+        (transfer_op == TransferOp::WRITE) ? "write" : "read", block_size, trans_num, time_cost, throughput);
   }
   return 0;
 }
@@ -288,7 +319,8 @@ int32_t main(int32_t argc, char **argv) {
   std::string transfer_mode;
   std::string transfer_op_str;
   std::string use_buffer_pool_str;
-  if (argc == kExpectedArgCnt) {
+  std::string transport = "hccl";
+  if (argc == kExpectedArgCnt || argc == kExpectedArgCntWithTransport) {
     device_id = argv[kArgIndexDeviceId];
     local_engine = argv[kArgIndexLocalEngine];
     remote_engine = argv[kArgIndexRemoteEngine];
@@ -296,13 +328,16 @@ int32_t main(int32_t argc, char **argv) {
     transfer_mode = argv[kArgIndexTransferMode];
     transfer_op_str = argv[kArgIndexTransferOp];
     use_buffer_pool_str = argv[kArgIndexUseBufferPool];
+    if (argc == kExpectedArgCntWithTransport) {
+      transport = argv[kArgIndexTransport];
+    }
     use_buffer_pool = (use_buffer_pool_str == "true");
     is_client = (remote_engine.find(':') != std::string::npos);
-    printf("[INFO] device_id = %s, local_engine = %s, remote_engine = %s, tcp_port = %s, transfer_mode = %s, transfer_op = %s, use_buffer_pool = %s\n", 
+    printf("[INFO] device_id = %s, local_engine = %s, remote_engine = %s, tcp_port = %s, transfer_mode = %s, transfer_op = %s, use_buffer_pool = %s, transport = %s\n", 
             device_id.c_str(), local_engine.c_str(), remote_engine.c_str(), tcp_port_str.c_str(), 
-            transfer_mode.c_str(), transfer_op_str.c_str(), use_buffer_pool_str.c_str());
+            transfer_mode.c_str(), transfer_op_str.c_str(), use_buffer_pool_str.c_str(), transport.c_str());
   } else {
-    printf("[ERROR] Expect 7 args(device_id, local_engine, remote_engine, tcp_port, transfer_mode, transfer_op, use_buffer_pool), but got %d\n", argc - 1);
+    printf("[ERROR] Expect 7 or 8 args(device_id, local_engine, remote_engine, tcp_port, transfer_mode, transfer_op, use_buffer_pool[, transport]), but got %d\n", argc - 1);
     return -1;
   }
   int32_t device = std::stoi(device_id);
@@ -324,6 +359,9 @@ int32_t main(int32_t argc, char **argv) {
     return -1;
   }
   TransferOp transfer_op = (transfer_op_str == "read") ? TransferOp::READ : TransferOp::WRITE;
+  if (SelectTransport(transport, transfer_mode) != 0) {
+    return -1;
+  }
 
   int32_t ret = 0;
   if (is_client) {
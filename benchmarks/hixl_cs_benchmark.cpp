@@ -9,6 +9,7 @@
  */
 
 #include <cstdio>
+#include <cstdlib>
 #include <thread>
 #include <iostream>
 #include <vector>
@@ -82,6 +83,13 @@ constexpr int32_t kBackLog = 1024;
 constexpr const char *kServerMemTagName = "server_mem";
 constexpr const char *kClientMemTagName = "client_mem";
 constexpr const int32_t kStatus = 0;
+constexpr int32_t kLoopbackMinArgCnt = 3;
+constexpr int32_t kLoopbackMaxArgCnt = 5;
+constexpr uint32_t kArgIndexLoopbackOp = 2;
+constexpr uint32_t kArgIndexLoopbackLatency = 3;
+constexpr uint32_t kArgIndexLoopbackBandwidth = 4;
+constexpr uint32_t kLoopbackPort = 26000;
+constexpr const char *kLoopbackIp = "127.0.0.1";
 
 #define CHECK_ACL_RETURN(x)                                                           \
   do {                                                                                \
@@ -113,7 +121,22 @@ int32_t InitEndPointInfo(const std::string &comm_res, EndpointDesc &ep) {
   return 0;
 }
 
-int32_t Transfer(HixlClientHandle client_handle, uint8_t *local_addr, const std::string &transfer_op) {
+// 每个测量点额外输出一行json, 便于脚本采集
+void PrintResult(const std::string &transfer_mode, const std::string &transfer_op, uint32_t block_size,
+                 uint32_t trans_num, int64_t time_cost, double throughput) {
+  json result;
+  result["benchmark"] = "hixl_cs";
+  result["transfer_mode"] = transfer_mode;
+  result["transfer_op"] = transfer_op;
+  result["block_size"] = block_size;
+  result["transfer_num"] = trans_num;
+  result["time_cost_us"] = time_cost;
+  result["throughput_gbps"] = throughput;
+  (void)printf("[RESULT] %s\n", result.dump().c_str());
+}
+
+int32_t Transfer(HixlClientHandle client_handle, uint8_t *local_addr, const std::string &transfer_op,
+                 const std::string &transfer_mode) {
   HcommMem *remote_mem_list = nullptr;
   char **mem_tag_list = nullptr;
   uint32_t list_num = 0U;
@@ -134,10 +157,15 @@ int32_t Transfer(HixlClientHandle client_handle, uint8_t *local_addr, const std:
     auto trans_num = kTransferMemSize / block_size;
     std::vector<const void *> local_addrs;
     std::vector<void *> remote_addrs;
+    // read时本端为目的地址, 远端为源地址
+    std::vector<void *> local_dst_addrs;
+    std::vector<const void *> remote_src_addrs;
     std::vector<uint64_t> lens;
     for (uint32_t j = 0; j < trans_num; j++) {
       local_addrs.emplace_back(local_addr + j * block_size);
       remote_addrs.emplace_back(remote_addr + j * block_size);
+      local_dst_addrs.emplace_back(local_addr + j * block_size);
+      remote_src_addrs.emplace_back(remote_addr + j * block_size);
       lens.emplace_back(block_size);
     }
     void *complete_handle = nullptr;
@@ -146,8 +174,8 @@ int32_t Transfer(HixlClientHandle client_handle, uint8_t *local_addr, const std:
       ret =
           HixlCSClientBatchPut(client_handle, trans_num, &remote_addrs[0], &local_addrs[0], &lens[0], &complete_handle);
     } else {
-      ret =
-          HixlCSClientBatchGet(client_handle, trans_num, &remote_addrs[0], &local_addrs[0], &lens[0], &complete_handle);
+      ret = HixlCSClientBatchGet(client_handle, trans_num, &local_dst_addrs[0], &remote_src_addrs[0], &lens[0],
+                                 &complete_handle);
     }
     if (ret != HIXL_SUCCESS) {
       (void)printf("[ERROR] HixlCSClientBatchPut/HixlCSClientBatchGet failed, ret = %u\n", ret);
@@ -156,15 +184,13 @@ int32_t Transfer(HixlClientHandle client_handle, uint8_t *local_addr, const std:
     int32_t status = kStatus;
     while (true) {
       ret = HixlCSClientQueryCompleteStatus(client_handle, complete_handle, &status);
-      if (status == BatchTransferStatus::COMPLETED) {
-        break;
-      } else if (status == BatchTransferStatus::WAITING) {
-        continue;
-      }
       if (ret != HIXL_SUCCESS) {
         (void)printf("[ERROR] HixlCSClientQueryCompleteStatus failed, ret = %u\n", ret);
         return -1;
       }
+      if (status == BatchTransferStatus::COMPLETED) {
+        break;
+      }
     }
     auto time_cost =
         std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
@@ -173,6 +199,7 @@ int32_t Transfer(HixlClientHandle client_handle, uint8_t *local_addr, const std:
     (void)printf(
         "[INFO] Transfer success, block size: %u Bytes, transfer num: %u, time cost: %ld us, throughput: %.3lf GB/s\n",
         block_size, trans_num, time_cost, throughput);
+    PrintResult(transfer_mode, transfer_op, block_size, trans_num, time_cost, throughput);
   }
   return 0;
 }
@@ -268,7 +295,7 @@ int32_t RunClient(const Args &args) {
   }
 
   // 4. 与server进行内存传输
-  if (Transfer(client_handle, static_cast<uint8_t *>(mem.addr), args.transfer_op) != 0) {
+  if (Transfer(client_handle, static_cast<uint8_t *>(mem.addr), args.transfer_op, args.transfer_mode) != 0) {
     ClientFinalize(client_handle, {mem_handle});
     return -1;
   }
@@ -356,9 +383,80 @@ int32_t RunServer(const Args &args) {
   (void)printf("[INFO] Server Sample end\n");
   return 0;
 }
+// 不依赖昇腾设备, server和client在同一进程内通过host内存回环传输, 用于评估host侧开销, 需要hixl以ENABLE_CS_LOOPBACK编译
+int32_t RunLoopback(int32_t argc, char **argv) {
+  const std::string transfer_op = argv[kArgIndexLoopbackOp];
+  if (transfer_op != "write" && transfer_op != "read") {
+    (void)printf("[ERROR] Invalid value for transfer_op: %s\n", transfer_op.c_str());
+    return -1;
+  }
+  (void)setenv("HIXL_CS_LOOPBACK", "1", 1);
+  if (argc > static_cast<int32_t>(kArgIndexLoopbackLatency)) {
+    (void)setenv("HIXL_CS_LOOPBACK_LATENCY_US", argv[kArgIndexLoopbackLatency], 1);
+  }
+  if (argc > static_cast<int32_t>(kArgIndexLoopbackBandwidth)) {
+    (void)setenv("HIXL_CS_LOOPBACK_BANDWIDTH_MBPS", argv[kArgIndexLoopbackBandwidth], 1);
+  }
+  EndpointDesc ep{};
+  ep.loc.locType = ENDPOINT_LOC_TYPE_HOST;
+  ep.protocol = COMM_PROTOCOL_ROCE;
+  ep.commAddr.type = COMM_ADDR_TYPE_IP_V4;
+  (void)inet_pton(AF_INET, kLoopbackIp, &ep.commAddr.addr);
+
+  HixlServerHandle server_handle = nullptr;
+  HixlServerConfig config{};
+  auto ret = HixlCSServerCreate(kLoopbackIp, kLoopbackPort, &ep, 1U, &config, &server_handle);
+  if (ret != HIXL_SUCCESS) {
+    (void)printf("[ERROR] HixlCSServerCreate failed, ret = %u\n", ret);
+    return -1;
+  }
+  std::vector<uint8_t> server_buf(kTransferMemSize, 0U);
+  std::vector<uint8_t> client_buf(kTransferMemSize, 1U);
+  HcommMem server_mem{};
+  server_mem.type = HCCL_MEM_TYPE_HOST;
+  server_mem.addr = server_buf.data();
+  server_mem.size = kTransferMemSize;
+  MemHandle server_mem_handle = nullptr;
+  ret = HixlCSServerRegMem(server_handle, kServerMemTagName, &server_mem, &server_mem_handle);
+  if (ret == HIXL_SUCCESS) {
+    ret = HixlCSServerListen(server_handle, kBackLog);
+  }
+  if (ret != HIXL_SUCCESS) {
+    (void)printf("[ERROR] Start loopback server failed, ret = %u\n", ret);
+    ServerFinalize(server_handle, {server_mem_handle});
+    return -1;
+  }
+
+  HixlClientHandle client_handle = nullptr;
+  HcommMem client_mem{};
+  client_mem.type = HCCL_MEM_TYPE_HOST;
+  client_mem.addr = client_buf.data();
+  client_mem.size = kTransferMemSize;
+  MemHandle client_mem_handle = nullptr;
+  ret = HixlCSClientCreate(kLoopbackIp, kLoopbackPort, &ep, &ep, &client_handle);
+  if (ret == HIXL_SUCCESS) {
+    ret = HixlCSClientRegMem(client_handle, kClientMemTagName, &client_mem, &client_mem_handle);
+  }
+  if (ret == HIXL_SUCCESS) {
+    ret = HixlCSClientConnectSync(client_handle, kClientConnectTimeoutMs);
+  }
+  int32_t result = -1;
+  if (ret != HIXL_SUCCESS) {
+    (void)printf("[ERROR] Start loopback client failed, ret = %u\n", ret);
+  } else {
+    result = Transfer(client_handle, client_buf.data(), transfer_op, "loopback");
+  }
+  ClientFinalize(client_handle, {client_mem_handle});
+  ServerFinalize(server_handle, {server_mem_handle});
+  (void)printf("[INFO] Loopback benchmark end\n");
+  return result;
+}
 }  // namespace
 
 int32_t main(int32_t argc, char **argv) {
+  if ((argc >= kLoopbackMinArgCnt) && (argc <= kLoopbackMaxArgCnt) && (std::string(argv[1]) == "loopback")) {
+    return RunLoopback(argc, argv);
+  }
   bool is_client = false;
   Args args{};
   std::string device_id_str;
@@ -94,6 +94,22 @@ class ASCEND_FUNC_VISIBILITY AdxlEngine {
                       TransferOp operation,
                       const std::vector<TransferOpDesc> &op_descs,
                       int32_t timeout_in_millis = 1000);
+
+  /**
+   * @brief 与远端AdxlEngine进行内存传输，可指定传输优先级等可选参数
+   * @param [in] remote_engine 远端AdxlEngine的唯一标识
+   * @param [in] operation 将远端内存读到本地或者将本地内存写到远端
+   * @param [in] op_descs 批量操作的本地以及远端地址
+   * @param [in] optional_args 可选参数，priority为HIGH时优先于排队中的普通请求下发，
+   *        allow_lossy_compression为true时中转传输可使用fp8/int8有损压缩
+   * @param [in] timeout_in_millis 传输的超时时间，单位ms
+   * @return 成功:SUCCESS, 失败:其它.
+   */
+  Status TransferSync(const AscendString &remote_engine,
+                      TransferOp operation,
+                      const std::vector<TransferOpDesc> &op_descs,
+                      const TransferArgs &optional_args,
+                      int32_t timeout_in_millis = 1000);
   
   /**
    * @brief 批量异步传输，下发传输请求
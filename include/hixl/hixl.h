@@ -66,6 +66,21 @@ class ASCEND_FUNC_VISIBILITY Hixl {
    */
   Status DeregisterMem(MemHandle mem_handle);
 
+  /**
+   * @brief 申请可在同机进程间共享的host内存, 以MEM_HOST注册后, 开启同机共享内存传输时同机client可直接拷贝
+   * @param [in] size 申请的内存大小
+   * @param [out] ptr 申请到的内存地址
+   * @return 成功:SUCCESS, 失败:其它.
+   */
+  Status MallocHostMem(size_t size, void *&ptr);
+
+  /**
+   * @brief 释放MallocHostMem申请的host内存, 释放前需先解注册
+   * @param [in] ptr MallocHostMem申请到的内存地址
+   * @return 成功:SUCCESS, 失败:其它.
+   */
+  Status FreeHostMem(void *ptr);
+
   /**
    * @brief 与远端Hixl进行建链
    * @param [in] remote_engine 远端Hixl的唯一标识
@@ -95,6 +110,22 @@ class ASCEND_FUNC_VISIBILITY Hixl {
                       const std::vector<TransferOpDesc> &op_descs,
                       int32_t timeout_in_millis = 1000);
 
+  /**
+   * @brief 与远端Hixl进行内存传输，可指定传输优先级等可选参数
+   * @param [in] remote_engine 远端Hixl的唯一标识
+   * @param [in] operation 将远端内存读到本地或者将本地内存写到远端
+   * @param [in] op_descs 批量操作的本地以及远端地址
+   * @param [in] optional_args 可选参数，priority为HIGH时优先于排队中的普通请求下发，
+   *        allow_lossy_compression为true时中转传输可使用fp8/int8有损压缩
+   * @param [in] timeout_in_millis 传输的超时时间，单位ms
+   * @return 成功:SUCCESS, 失败:其它.
+   */
+  Status TransferSync(const AscendString &remote_engine,
+                      TransferOp operation,
+                      const std::vector<TransferOpDesc> &op_descs,
+                      const TransferArgs &optional_args,
+                      int32_t timeout_in_millis = 1000);
+
   /**
    * @brief 批量异步传输，下发传输请求
    * @param [in] remote_engine 远端Hixl的唯一标识
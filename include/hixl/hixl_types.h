@@ -29,7 +29,10 @@ using TransferReq = void *;
 constexpr const char OPTION_ENABLE_USE_FABRIC_MEM[] = "EnableUseFabricMem";
 constexpr const char OPTION_RDMA_TRAFFIC_CLASS[] = "RdmaTrafficClass";
 constexpr const char OPTION_RDMA_SERVICE_LEVEL[] = "RdmaServiceLevel";
+constexpr const char OPTION_RDMA_HIGH_PRIORITY_TRAFFIC_CLASS[] = "RdmaHighPriorityTrafficClass";
+constexpr const char OPTION_RDMA_HIGH_PRIORITY_SERVICE_LEVEL[] = "RdmaHighPriorityServiceLevel";
 constexpr const char OPTION_BUFFER_POOL[] = "BufferPool";
+constexpr const char OPTION_BUFFER_COMPRESSION[] = "BufferCompression";
 constexpr const char OPTION_GLOBAL_RESOURCE_CONFIG[] = "GlobalResourceConfig";
  
 // status codes
@@ -73,8 +76,17 @@ enum class TransferStatus {
   FAILED
 };
 
+enum class TransferPriority : uint8_t {
+  NORMAL,
+  HIGH
+};
+
 struct TransferArgs{
-  uint8_t reserved[128] = {};
+  // HIGH的请求优先于排队中的NORMAL请求下发，配置了高优先级流量类时走独立的通信域
+  TransferPriority priority = TransferPriority::NORMAL;
+  // BufferCompression配置为fp8/int8时，仅置为true的请求使用有损压缩，其余请求不压缩
+  bool allow_lossy_compression = false;
+  uint8_t reserved[126] = {};
 };
 
 struct NotifyDesc {
@@ -12,7 +12,9 @@
 #define CANN_GRAPH_ENGINE_INC_EXTERNAL_LLM_DATADIST_LLM_DATA_DIST_H_
 
 #include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 #include "external/ge_common/ge_api_error_codes.h"
 
@@ -126,7 +128,9 @@ struct CacheIndex {
   uint64_t cluster_id;
   int64_t cache_id;
   uint32_t batch_index;
-  uint8_t reserved[128];
+  // 远端cache内容的版本, 由prompt侧在改写cache中的block后递增; 0表示未知, 此时拉取不使用预取的block
+  uint64_t generation;
+  uint8_t reserved[120];
 };
 
 enum class CachePlacement : uint32_t {
@@ -159,6 +163,36 @@ struct KvCacheExtParam {
 struct RegisterCfg {
   uint8_t reserved[128] = {0};
 };
+
+/**
+ * @brief 逐层push KV Cache的任务, 由PushKvCacheByLayers返回, 可在任意线程查询
+ */
+class LayerTransferTask {
+ public:
+  virtual ~LayerTransferTask() = default;
+
+  /**
+   * @brief 查询某一层是否已传输完成
+   * @param [in] layer_offset 相对于起始层的偏移
+   * @return 已完成:true, 未完成:false
+   */
+  virtual bool IsLayerReady(uint32_t layer_offset) const = 0;
+
+  /**
+   * @brief 获取已传输完成的层数, 各层按顺序完成
+   * @return 已完成的层数
+   */
+  virtual uint32_t GetReadyLayerNum() const = 0;
+
+  /**
+   * @brief 等待所有层传输结束
+   * @return 成功:LLM_SUCCESS, 失败:其它
+   */
+  virtual Status Wait() = 0;
+};
+
+// 某一层传输完成后在后台传输线程上调用, 参数为源cache的层号
+using LayerReadyCallback = std::function<void(uint32_t layer_index)>;
 class ASCEND_FUNC_VISIBILITY LlmDataDist {
  public:
   /**
@@ -248,7 +282,7 @@ class ASCEND_FUNC_VISIBILITY LlmDataDist {
 
   /**
    * @brief 从远端拉取KV blocks
-   * @param [in] src_cache_index 远端cache索引
+   * @param [in] src_cache_index 远端cache索引, 开启llm.KvPrefetchConfig时需填写generation才能命中预取的block
    * @param [in] dst_cache 拉取到的本地目标cache
    * @param [in] src_blocks 源block列表
    * @param [in] dst_blocks 目标block列表
@@ -306,6 +340,23 @@ class ASCEND_FUNC_VISIBILITY LlmDataDist {
                      int64_t size = -1,
                      const KvCacheExtParam &ext_param = {});
 
+  /**
+   * @brief 逐层向远端push连续KV Cache, 接口在任务下发后即返回, 每层完成后对端即可使用该层
+   * @param [in] src_cache 本地cache
+   * @param [in] dst_cache_index 远端cache索引
+   * @param [in] src_batch_index 本地cache的batch index
+   * @param [in] ext_param 扩展参数, 层范围的含义与PushKvCache相同
+   * @param [out] task 逐层传输任务, 用于查询每层的完成情况及等待传输结束
+   * @param [in] callback 每层完成时的回调, 在后台传输线程上按层序调用, 可为空
+   * @return 成功:LLM_SUCCESS, 失败:其它
+   */
+  Status PushKvCacheByLayers(const Cache &src_cache,
+                             const CacheIndex &dst_cache_index,
+                             uint32_t src_batch_index,
+                             const KvCacheExtParam &ext_param,
+                             std::shared_ptr<LayerTransferTask> &task,
+                             const LayerReadyCallback &callback = nullptr);
+
   /**
    * @brief 向远端push KV blocks
    * @param [in] src_cache 本地cache
@@ -46,9 +46,15 @@ struct CreateChannelResp {
   uint64_t dst_ep_handle = 0UL;
 };
 
+// GetRemoteMemReq.flags, client能解析二进制格式的GetRemoteMemResp
+const uint32_t kGetRemoteMemFlagBinaryResp = 0x1U;
 struct GetRemoteMemReq {
   uint64_t dst_ep_handle = 0UL;
+  uint32_t flags = 0U;
+  uint32_t reserved = 0U;
 };
+// 旧版本client的GetRemoteMemReq只有dst_ep_handle, server回复json格式
+const uint64_t kLegacyGetRemoteMemReqSize = sizeof(uint64_t);
 
 struct HixlMemDesc {
   HcommMem mem;
@@ -62,6 +68,25 @@ struct GetRemoteMemResp {
   std::vector<HixlMemDesc> mem_descs;
 };
 
+// GetRemoteMemResp的二进制格式: [MemDescListHead][MemDescEntryHead tag export_desc]..., 各字段按主机字节序紧密排列,
+// 仅在GetRemoteMemReq携带kGetRemoteMemFlagBinaryResp时使用
+const uint32_t kMemDescListMagic = 0x4C444D48U;
+struct MemDescListHead {
+  uint32_t magic;
+  uint32_t result;
+  uint32_t desc_num;
+  uint32_t reserved;
+};
+
+struct MemDescEntryHead {
+  uint32_t type;
+  uint32_t tag_len;
+  uint32_t export_len;
+  uint32_t reserved;
+  uint64_t addr;
+  uint64_t size;
+};
+
 struct DestroyChannelReq {
   uint64_t endpoint_handle;
   uint64_t channel_handle;
@@ -254,9 +254,27 @@ Status CtrlMsgPlugin::Recv(int32_t fd, void *buf, size_t len, uint32_t timeout_m
   auto nbytes = static_cast<ssize_t>(len);
   auto start_time = std::chrono::steady_clock::now();
   while (nbytes > 0) {
+    // 先非阻塞读, 数据已到达时不再经过poll
+    auto rc = recv(fd, pos, static_cast<size_t>(nbytes), MSG_DONTWAIT);
+    if (rc > 0) {
+      pos += rc;
+      nbytes -= rc;
+      continue;
+    }
+    if (rc == 0) {
+      HIXL_LOGE(FAILED, "Socket read failed, connection closed by peer, fd:%d", fd);
+      return FAILED;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      HIXL_LOGE(FAILED, "Socket read failed, error msg:%s, errno:%d", strerror(errno), errno);
+      return FAILED;
+    }
     auto now = std::chrono::steady_clock::now();
     auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time).count();
-        int64_t remaining_ms = static_cast<int64_t>(timeout_ms) - elapsed_ms;
+    int64_t remaining_ms = static_cast<int64_t>(timeout_ms) - elapsed_ms;
     if (remaining_ms <= 0) {
       HIXL_LOGE(TIMEOUT, "Socket read timeout! Target: %zu bytes, Left: %zd bytes, Elapsed: %ld ms",
                 len, nbytes, elapsed_ms);
@@ -269,24 +287,10 @@ Status CtrlMsgPlugin::Recv(int32_t fd, void *buf, size_t len, uint32_t timeout_m
     if (ret == 0) {
       HIXL_LOGE(TIMEOUT, "Socket read poll timeout! Waited %ld ms", remaining_ms);
       return TIMEOUT;
-    } else if (ret < 0) {
-      if (errno == EINTR) {
-        continue;
-      }
+    } else if (ret < 0 && errno != EINTR) {
       HIXL_LOGE(FAILED, "Socket poll failed, errno:%d, msg:%s", errno, strerror(errno));
       return FAILED;
     }
-
-    auto rc = read(fd, pos, static_cast<size_t>(nbytes));
-    if (rc < 0 && (errno == EAGAIN || errno == EINTR)) {
-      HIXL_LOGI("Socket read need to eagain");
-      continue;
-    } else if (rc <= 0) {
-      HIXL_LOGE(FAILED, "Socket read failed, error msg:%s, errno:%d", strerror(errno), errno);
-      return FAILED;
-    }
-    pos += rc;
-    nbytes -= rc;
   }
   HIXL_LOGI("Socket read completed: %zu bytes, fd:%d", len, fd);
   return SUCCESS;
@@ -0,0 +1,393 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "pinned_host_arena.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "acl/acl.h"
+#include "hixl_log.h"
+#include "hixl_checker.h"
+
+namespace hixl {
+namespace {
+constexpr size_t kMinObjectShift = 6U;  // 64B
+constexpr size_t kSizeClassNum = 11U;   // 64B ~ 64KB
+constexpr size_t kMaxObjectSize = 1UL << (kMinObjectShift + kSizeClassNum - 1U);
+constexpr size_t kSlabSize = 2UL * 1024UL * 1024UL;
+constexpr size_t kHuge2MSize = 2UL * 1024UL * 1024UL;
+constexpr size_t kHuge1GSize = 1024UL * 1024UL * 1024UL;
+constexpr size_t kMaxSampledPages = 1024U;
+constexpr int32_t kHugePageShift = 26;
+constexpr int32_t kHuge2MFlag = 21 << kHugePageShift;
+constexpr int32_t kHuge1GFlag = 30 << kHugePageShift;
+// values of linux/mempolicy.h, not depending on libnuma
+constexpr int32_t kMpolPreferred = 1;
+constexpr unsigned long kMaxNumaNodes = 1024UL;
+constexpr size_t kBitsPerMaskWord = sizeof(unsigned long) * 8U;
+constexpr const char *kNodeOnlinePath = "/sys/devices/system/node/online";
+
+size_t RoundUp(size_t size, size_t align) {
+  return (size + align - 1U) / align * align;
+}
+
+size_t GetSystemPageSize() {
+  const long page_size = sysconf(_SC_PAGESIZE);
+  return page_size > 0 ? static_cast<size_t>(page_size) : 4096U;
+}
+
+size_t GetPageSize(HostPageType page_type) {
+  if (page_type == HostPageType::kHuge1G) {
+    return kHuge1GSize;
+  }
+  if (page_type == HostPageType::kHuge2M) {
+    return kHuge2MSize;
+  }
+  return GetSystemPageSize();
+}
+
+void FillNodeMask(int32_t numa_node, std::vector<unsigned long> &node_mask) {
+  node_mask.assign(kMaxNumaNodes / kBitsPerMaskWord, 0UL);
+  const auto node = static_cast<size_t>(numa_node);
+  node_mask[node / kBitsPerMaskWord] |= (1UL << (node % kBitsPerMaskWord));
+}
+
+// prefer numa node for pages faulted by current thread, restore previous policy on leave
+class ScopedNumaPolicy {
+ public:
+  explicit ScopedNumaPolicy(int32_t numa_node) {
+    if (numa_node < 0) {
+      return;
+    }
+    old_mask_.assign(kMaxNumaNodes / kBitsPerMaskWord, 0UL);
+    if (syscall(SYS_get_mempolicy, &old_mode_, old_mask_.data(), kMaxNumaNodes, nullptr, 0UL) != 0) {
+      HIXL_LOGW("get_mempolicy failed, errno:%d, numa policy is not applied", errno);
+      return;
+    }
+    std::vector<unsigned long> node_mask;
+    FillNodeMask(numa_node, node_mask);
+    if (syscall(SYS_set_mempolicy, kMpolPreferred, node_mask.data(), kMaxNumaNodes) != 0) {
+      HIXL_LOGW("set_mempolicy to node:%d failed, errno:%d", numa_node, errno);
+      return;
+    }
+    applied_ = true;
+  }
+
+  ~ScopedNumaPolicy() {
+    if (applied_ && (syscall(SYS_set_mempolicy, old_mode_, old_mask_.data(), kMaxNumaNodes) != 0)) {
+      HIXL_LOGW("restore mempolicy failed, errno:%d", errno);
+    }
+  }
+
+ private:
+  bool applied_ = false;
+  int32_t old_mode_ = 0;
+  std::vector<unsigned long> old_mask_;
+};
+}  // namespace
+
+PinnedHostArena::PinnedHostArena(const PinnedHostArenaOptions &options) : options_(options) {}
+
+PinnedHostArena::~PinnedHostArena() {
+  Finalize();
+}
+
+int32_t PinnedHostArena::GetCurrentNumaNode() {
+  uint32_t cpu = 0U;
+  uint32_t node = 0U;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return kAnyNumaNode;
+  }
+  return static_cast<int32_t>(node);
+}
+
+int32_t PinnedHostArena::GetNumaNodeNum() {
+  // content like "0" or "0-3"
+  std::ifstream online_file(kNodeOnlinePath);
+  std::string online;
+  if ((!online_file.is_open()) || (!std::getline(online_file, online)) || online.empty()) {
+    return 1;
+  }
+  const auto pos = online.find_last_of("-,");
+  const std::string last_node = (pos == std::string::npos) ? online : online.substr(pos + 1U);
+  try {
+    return std::stoi(last_node) + 1;
+  } catch (...) {
+    return 1;
+  }
+}
+
+Status PinnedHostArena::Initialize() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  HIXL_CHK_BOOL_RET_STATUS(!initialized_, FAILED, "pinned host arena is already initialized");
+  HIXL_CHK_BOOL_RET_STATUS((options_.numa_node >= kAnyNumaNode) && (options_.numa_node < GetNumaNodeNum()),
+                           PARAM_INVALID,
+                           "numa node:%d is out of range, numa node num:%d", options_.numa_node, GetNumaNodeNum());
+  numa_node_ = options_.numa_node;
+  options_.chunk_size = RoundUp(std::max(options_.chunk_size, kSlabSize), kSlabSize);
+  free_lists_.resize(kSizeClassNum);
+  initialized_ = true;
+  HIXL_LOGI("pinned host arena initialized, backend:%u, numa node:%d, chunk size:%zu",
+            static_cast<uint32_t>(options_.backend), numa_node_, options_.chunk_size);
+  return SUCCESS;
+}
+
+void PinnedHostArena::Finalize() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReleaseAll();
+  initialized_ = false;
+}
+
+int32_t PinnedHostArena::GetNumaNode() const {
+  return numa_node_;
+}
+
+Status PinnedHostArena::Alloc(size_t size, void *&ptr) {
+  HIXL_CHK_BOOL_RET_STATUS(size > 0U, PARAM_INVALID, "alloc size should not be 0");
+  std::lock_guard<std::mutex> lock(mutex_);
+  HIXL_CHK_BOOL_RET_STATUS(initialized_, FAILED, "pinned host arena is not initialized");
+  if (size > kMaxObjectSize) {
+    return AllocLarge(size, ptr);
+  }
+  size_t class_index = 0U;
+  while ((1UL << (kMinObjectShift + class_index)) < size) {
+    ++class_index;
+  }
+  auto &free_list = free_lists_[class_index];
+  if (free_list.empty()) {
+    HIXL_CHK_STATUS_RET(CarveSlab(class_index), "Failed to carve slab for size:%zu", size);
+  }
+  ptr = free_list.back();
+  free_list.pop_back();
+  const auto addr = reinterpret_cast<uintptr_t>(ptr);
+  auto &slab = FindSlab(addr)->second;
+  slab.in_use[(addr - slab.base) >> (kMinObjectShift + class_index)] = true;
+  allocated_bytes_ += (1UL << (kMinObjectShift + class_index));
+  return SUCCESS;
+}
+
+void PinnedHostArena::Free(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto large_it = large_chunks_.find(ptr);
+  if (large_it != large_chunks_.end()) {
+    allocated_bytes_ -= large_it->second.used;
+    ReleaseChunk(large_it->second);
+    (void)large_chunks_.erase(large_it);
+    return;
+  }
+  const auto addr = reinterpret_cast<uintptr_t>(ptr);
+  const auto slab_it = FindSlab(addr);
+  if (slab_it == slabs_.end()) {
+    HIXL_LOGW("ptr:%p is not allocated from pinned host arena", ptr);
+    return;
+  }
+  auto &slab = slab_it->second;
+  const auto object_shift = kMinObjectShift + slab.class_index;
+  const auto offset = addr - slab.base;
+  if ((offset & ((1UL << object_shift) - 1U)) != 0U) {
+    HIXL_LOGW("ptr:%p is not the start of an object, slab base:%p, object size:%zu", ptr,
+              reinterpret_cast<void *>(slab.base), 1UL << object_shift);
+    return;
+  }
+  const auto slot = offset >> object_shift;
+  if (!slab.in_use[slot]) {
+    HIXL_LOGW("ptr:%p is already freed", ptr);
+    return;
+  }
+  slab.in_use[slot] = false;
+  free_lists_[slab.class_index].emplace_back(ptr);
+  allocated_bytes_ -= (1UL << object_shift);
+}
+
+std::map<uintptr_t, PinnedHostArena::Slab>::iterator PinnedHostArena::FindSlab(uintptr_t addr) {
+  auto slab_it = slabs_.upper_bound(addr);
+  if ((slab_it == slabs_.begin()) || (addr >= std::prev(slab_it)->first + kSlabSize)) {
+    return slabs_.end();
+  }
+  return std::prev(slab_it);
+}
+
+Status PinnedHostArena::CarveSlab(size_t class_index) {
+  if (slab_chunks_.empty() || (slab_chunks_.back().used + kSlabSize > slab_chunks_.back().size)) {
+    Chunk chunk;
+    HIXL_CHK_STATUS_RET(ReserveChunk(options_.chunk_size, chunk), "Failed to reserve chunk, size:%zu",
+                        options_.chunk_size);
+    slab_chunks_.emplace_back(chunk);
+  }
+  auto &chunk = slab_chunks_.back();
+  const auto base = reinterpret_cast<uintptr_t>(chunk.addr) + chunk.used;
+  chunk.used += kSlabSize;
+  const size_t object_size = 1UL << (kMinObjectShift + class_index);
+  Slab slab;
+  slab.base = base;
+  slab.class_index = class_index;
+  slab.in_use.assign(kSlabSize / object_size, false);
+  slabs_[base] = std::move(slab);
+  auto &free_list = free_lists_[class_index];
+  // lower address is handed out first
+  for (size_t offset = kSlabSize; offset >= object_size; offset -= object_size) {
+    free_list.emplace_back(reinterpret_cast<void *>(base + offset - object_size));
+  }
+  return SUCCESS;
+}
+
+Status PinnedHostArena::AllocLarge(size_t size, void *&ptr) {
+  Chunk chunk;
+  HIXL_CHK_STATUS_RET(ReserveChunk(size, chunk), "Failed to reserve chunk, size:%zu", size);
+  chunk.used = size;
+  ptr = chunk.addr;
+  large_chunks_[ptr] = chunk;
+  allocated_bytes_ += size;
+  return SUCCESS;
+}
+
+Status PinnedHostArena::ReserveChunk(size_t size, Chunk &chunk) const {
+  if (options_.backend == HostArenaBackend::kMmap) {
+    return ReserveMmapChunk(size, chunk);
+  }
+  return ReserveRuntimeChunk(size, chunk);
+}
+
+Status PinnedHostArena::ReserveRuntimeChunk(size_t size, Chunk &chunk) const {
+  ScopedNumaPolicy numa_policy(numa_node_);
+  void *addr = nullptr;
+  HIXL_CHK_ACL_RET(aclrtMallocHost(&addr, size));
+  chunk.addr = addr;
+  chunk.size = size;
+  chunk.page_type = HostPageType::kNormal;
+  return SUCCESS;
+}
+
+Status PinnedHostArena::ReserveMmapChunk(size_t size, Chunk &chunk) const {
+  constexpr int32_t kProt = PROT_READ | PROT_WRITE;
+  constexpr int32_t kFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+  void *addr = MAP_FAILED;
+  if (options_.huge_page && (size >= kHuge1GSize)) {
+    chunk.size = RoundUp(size, kHuge1GSize);
+    chunk.page_type = HostPageType::kHuge1G;
+    addr = mmap(nullptr, chunk.size, kProt, kFlags | MAP_HUGETLB | kHuge1GFlag, -1, 0);
+  }
+  if (options_.huge_page && (addr == MAP_FAILED)) {
+    chunk.size = RoundUp(size, kHuge2MSize);
+    chunk.page_type = HostPageType::kHuge2M;
+    addr = mmap(nullptr, chunk.size, kProt, kFlags | MAP_HUGETLB | kHuge2MFlag, -1, 0);
+  }
+  if (addr == MAP_FAILED) {
+    // no reserved hugetlb pages, fall back to normal pages and advise transparent huge pages
+    chunk.size = RoundUp(size, options_.huge_page ? kHuge2MSize : GetSystemPageSize());
+    chunk.page_type = HostPageType::kNormal;
+    addr = mmap(nullptr, chunk.size, kProt, kFlags, -1, 0);
+    HIXL_CHK_BOOL_RET_STATUS(addr != MAP_FAILED, RESOURCE_EXHAUSTED, "mmap failed, size:%zu, errno:%d", chunk.size,
+                             errno);
+    if (options_.huge_page && (madvise(addr, chunk.size, MADV_HUGEPAGE) == 0)) {
+      chunk.page_type = HostPageType::kTransparentHuge;
+    }
+  }
+  chunk.addr = addr;
+  if (numa_node_ >= 0) {
+    std::vector<unsigned long> node_mask;
+    FillNodeMask(numa_node_, node_mask);
+    if (syscall(SYS_mbind, addr, chunk.size, kMpolPreferred, node_mask.data(), kMaxNumaNodes, 0U) != 0) {
+      HIXL_LOGW("mbind to numa node:%d failed, errno:%d", numa_node_, errno);
+    }
+  }
+  // fault all pages in now, so that placement is done here instead of on the transfer path
+  if ((!options_.lock_pages) || (mlock(addr, chunk.size) != 0)) {
+    if (options_.lock_pages) {
+      HIXL_LOGW("mlock failed, size:%zu, errno:%d, pages are touched instead", chunk.size, errno);
+    }
+    const size_t page_size = GetPageSize(chunk.page_type);
+    for (size_t offset = 0U; offset < chunk.size; offset += page_size) {
+      static_cast<volatile uint8_t *>(addr)[offset] = 0U;
+    }
+  }
+  const auto ret = RegisterChunk(chunk);
+  if (ret != SUCCESS) {
+    (void)munmap(addr, chunk.size);
+    return ret;
+  }
+  HIXL_LOGI("reserve chunk success, size:%zu, page type:%u, numa node:%d", chunk.size,
+            static_cast<uint32_t>(chunk.page_type), numa_node_);
+  return SUCCESS;
+}
+
+// pages of the mapping are not known by the runtime, register them before handing out to device copies
+Status PinnedHostArena::RegisterChunk(const Chunk &chunk) const {
+  void *dev_addr = nullptr;
+  HIXL_CHK_ACL_RET(aclrtHostRegister(chunk.addr, chunk.size, ACL_HOST_REGISTER_MAPPED, &dev_addr));
+  return SUCCESS;
+}
+
+void PinnedHostArena::ReleaseChunk(const Chunk &chunk) const {
+  if (options_.backend == HostArenaBackend::kMmap) {
+    HIXL_CHK_ACL(aclrtHostUnregister(chunk.addr));
+    if (munmap(chunk.addr, chunk.size) != 0) {
+      HIXL_LOGW("munmap failed, addr:%p, size:%zu, errno:%d", chunk.addr, chunk.size, errno);
+    }
+    return;
+  }
+  HIXL_CHK_ACL(aclrtFreeHost(chunk.addr));
+}
+
+void PinnedHostArena::ReleaseAll() {
+  for (const auto &chunk : slab_chunks_) {
+    ReleaseChunk(chunk);
+  }
+  for (const auto &it : large_chunks_) {
+    ReleaseChunk(it.second);
+  }
+  slab_chunks_.clear();
+  large_chunks_.clear();
+  slabs_.clear();
+  free_lists_.clear();
+  allocated_bytes_ = 0UL;
+}
+
+PinnedHostArenaStats PinnedHostArena::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PinnedHostArenaStats stats;
+  stats.numa_node = numa_node_;
+  stats.chunk_num = slab_chunks_.size() + large_chunks_.size();
+  stats.slab_num = slabs_.size();
+  stats.large_alloc_num = large_chunks_.size();
+  stats.allocated_bytes = allocated_bytes_;
+  std::vector<Chunk> chunks(slab_chunks_);
+  for (const auto &it : large_chunks_) {
+    chunks.emplace_back(it.second);
+  }
+  for (const auto &chunk : chunks) {
+    stats.reserved_bytes += chunk.size;
+    stats.page_type_bytes[chunk.page_type] += chunk.size;
+    // sample at most kMaxSampledPages pages of each chunk
+    const size_t page_size = GetPageSize(chunk.page_type);
+    const size_t page_num = std::max<size_t>(chunk.size / page_size, 1U);
+    const size_t stride = (page_num + kMaxSampledPages - 1U) / kMaxSampledPages;
+    std::vector<void *> pages;
+    for (size_t i = 0U; i < page_num; i += stride) {
+      pages.emplace_back(static_cast<uint8_t *>(chunk.addr) + i * page_size);
+    }
+    std::vector<int32_t> status(pages.size(), kAnyNumaNode);
+    const bool queried = syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) == 0;
+    const uint64_t sample_bytes = chunk.size / pages.size();
+    for (const auto node : status) {
+      stats.node_bytes[(queried && (node >= 0)) ? node : kAnyNumaNode] += sample_bytes;
+    }
+  }
+  return stats;
+}
+}  // namespace hixl
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_HIXL_SRC_HIXL_COMMON_PINNED_HOST_ARENA_H_
+#define CANN_HIXL_SRC_HIXL_COMMON_PINNED_HOST_ARENA_H_
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "hixl/hixl_types.h"
+
+namespace hixl {
+constexpr int32_t kAnyNumaNode = -1;
+
+enum class HostPageType : uint32_t { kNormal = 0U, kTransparentHuge = 1U, kHuge2M = 2U, kHuge1G = 3U };
+
+enum class HostArenaBackend : uint32_t {
+  kRuntime = 0U,  // aclrtMallocHost, optionally under a preferred NUMA policy
+  kMmap = 1U      // anonymous mapping backed by huge pages, locked with mlock and registered by aclrtHostRegister
+};
+
+struct PinnedHostArenaOptions {
+  HostArenaBackend backend = HostArenaBackend::kRuntime;
+  // opt-in, pages are preferred on this node by MPOL_PREFERRED, kAnyNumaNode keeps the default policy of the process
+  int32_t numa_node = kAnyNumaNode;
+  bool huge_page = true;             // mmap backend only, try 1G and 2M hugetlb pages, then transparent huge pages
+  bool lock_pages = true;            // mmap backend only
+  size_t chunk_size = 64UL * 1024UL * 1024UL;
+};
+
+struct PinnedHostArenaStats {
+  int32_t numa_node = kAnyNumaNode;
+  uint64_t chunk_num = 0UL;
+  uint64_t slab_num = 0UL;
+  uint64_t large_alloc_num = 0UL;
+  uint64_t reserved_bytes = 0UL;
+  uint64_t allocated_bytes = 0UL;
+  std::map<HostPageType, uint64_t> page_type_bytes;
+  // resident bytes on each numa node sampled by move_pages, kAnyNumaNode for pages not resolved
+  std::map<int32_t, uint64_t> node_bytes;
+};
+
+// Shared host staging arena, small objects are carved from slabs of equal-sized slots,
+// requests larger than the biggest size class get a dedicated chunk.
+// Every chunk is registered with the runtime, so it can be used by aclrtMemcpyAsync and registered to hccl as host
+// memory. Used by the host cache pool of DataCacheEngine only: RegBufferPool and EntityMemInfo allocate one fixed
+// buffer per pool or link that is registered and freed by its owner, there is nothing to share or carve for them.
+class PinnedHostArena {
+ public:
+  explicit PinnedHostArena(const PinnedHostArenaOptions &options = PinnedHostArenaOptions{});
+  ~PinnedHostArena();
+  PinnedHostArena(const PinnedHostArena &) = delete;
+  PinnedHostArena &operator=(const PinnedHostArena &) = delete;
+
+  Status Initialize();
+  void Finalize();
+  Status Alloc(size_t size, void *&ptr);
+  void Free(void *ptr);
+  int32_t GetNumaNode() const;
+  PinnedHostArenaStats GetStats() const;
+
+  static int32_t GetCurrentNumaNode();
+  static int32_t GetNumaNodeNum();
+
+ private:
+  struct Chunk {
+    void *addr = nullptr;
+    size_t size = 0UL;
+    size_t used = 0UL;
+    HostPageType page_type = HostPageType::kNormal;
+  };
+
+  struct Slab {
+    uintptr_t base = 0UL;
+    size_t class_index = 0UL;
+    std::vector<bool> in_use;
+  };
+
+  Status ReserveChunk(size_t size, Chunk &chunk) const;
+  Status ReserveMmapChunk(size_t size, Chunk &chunk) const;
+  Status ReserveRuntimeChunk(size_t size, Chunk &chunk) const;
+  Status RegisterChunk(const Chunk &chunk) const;
+  void ReleaseChunk(const Chunk &chunk) const;
+  std::map<uintptr_t, Slab>::iterator FindSlab(uintptr_t addr);
+  Status CarveSlab(size_t class_index);
+  Status AllocLarge(size_t size, void *&ptr);
+  void ReleaseAll();
+
+  PinnedHostArenaOptions options_;
+  mutable std::mutex mutex_;
+  bool initialized_ = false;
+  int32_t numa_node_ = kAnyNumaNode;
+  std::vector<Chunk> slab_chunks_;
+  std::map<uintptr_t, Slab> slabs_;
+  std::vector<std::vector<void *>> free_lists_;
+  std::unordered_map<void *, Chunk> large_chunks_;
+  uint64_t allocated_bytes_ = 0UL;
+};
+}  // namespace hixl
+
+#endif  // CANN_HIXL_SRC_HIXL_COMMON_PINNED_HOST_ARENA_H_
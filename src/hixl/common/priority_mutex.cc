@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "priority_mutex.h"
+
+namespace hixl {
+void PriorityMutex::Lock(bool high_priority) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (high_priority) {
+    ++high_waiters_;
+    high_cv_.wait(lock, [this]() { return !locked_; });
+    --high_waiters_;
+  } else {
+    ++normal_waiters_;
+    normal_cv_.wait(lock, [this]() { return (!locked_) && (high_waiters_ == 0U); });
+    --normal_waiters_;
+  }
+  locked_ = true;
+}
+
+void PriorityMutex::unlock() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  locked_ = false;
+  if (high_waiters_ > 0U) {
+    high_cv_.notify_one();
+  } else if (normal_waiters_ > 0U) {
+    normal_cv_.notify_one();
+  }
+}
+}  // namespace hixl
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_HIXL_SRC_HIXL_COMMON_PRIORITY_MUTEX_H_
+#define CANN_HIXL_SRC_HIXL_COMMON_PRIORITY_MUTEX_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace hixl {
+// Mutex that is handed to waiting high priority lockers before waiting normal ones, so a latency critical
+// submission only waits for the current holder and never for the bulk submissions queued behind it.
+// Normal lockers wait as long as high priority ones keep arriving, high priority is meant for small batches.
+class PriorityMutex {
+ public:
+  PriorityMutex() = default;
+  ~PriorityMutex() = default;
+  PriorityMutex(const PriorityMutex &) = delete;
+  PriorityMutex &operator=(const PriorityMutex &) = delete;
+
+  // std::lock_guard compatible, locks with normal priority
+  void lock() {
+    Lock(false);
+  }
+  void unlock();
+  void Lock(bool high_priority);
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable high_cv_;
+  std::condition_variable normal_cv_;
+  bool locked_ = false;
+  uint32_t high_waiters_ = 0U;
+  uint32_t normal_waiters_ = 0U;
+};
+
+class PriorityLockGuard {
+ public:
+  PriorityLockGuard(PriorityMutex &mutex, bool high_priority) : mutex_(mutex) {
+    mutex_.Lock(high_priority);
+  }
+  ~PriorityLockGuard() {
+    mutex_.unlock();
+  }
+  PriorityLockGuard(const PriorityLockGuard &) = delete;
+  PriorityLockGuard &operator=(const PriorityLockGuard &) = delete;
+
+ private:
+  PriorityMutex &mutex_;
+};
+}  // namespace hixl
+
+#endif  // CANN_HIXL_SRC_HIXL_COMMON_PRIORITY_MUTEX_H_
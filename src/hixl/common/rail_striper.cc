@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "rail_striper.h"
+#include <algorithm>
+#include <cstdlib>
+#include "hixl_checker.h"
+#include "hixl_log.h"
+#include "hixl_utils.h"
+
+namespace hixl {
+namespace {
+// weight of a new sample in the smoothed bandwidth
+constexpr double kMeasureAlpha = 0.25;
+// a slow rail keeps at least this share of the mean weight, so that it is still measured and can recover
+constexpr double kMinWeightRatio = 0.05;
+constexpr const char *kEnvMultiRail = "HIXL_MULTI_RAIL";
+constexpr const char *kEnvMultiRailMinBytes = "HIXL_MULTI_RAIL_MIN_BYTES";
+constexpr const char *kEnvRailBandwidth = "HIXL_RAIL_BANDWIDTH";
+}  // namespace
+
+void RailStriper::Init(size_t rail_num, const RailStripeConfig &config) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  rail_num_ = std::max(rail_num, static_cast<size_t>(1U));
+  config_ = config;
+  if (config_.bandwidths.size() != rail_num_) {
+    if (!config_.bandwidths.empty()) {
+      HIXL_LOGW("Configured %zu rail bandwidths for %zu rails, measure them instead", config_.bandwidths.size(),
+                rail_num_);
+    }
+    config_.bandwidths.clear();
+  }
+  measured_.assign(rail_num_, 0.0);
+}
+
+bool RailStriper::ShouldStripe(const std::vector<TransferOpDesc> &op_descs) const {
+  if ((!config_.enable) || (rail_num_ < 2U)) {
+    return false;
+  }
+  uint64_t total = 0U;
+  for (const auto &op_desc : op_descs) {
+    total += op_desc.len;
+    if (total >= config_.min_stripe_bytes) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<double> RailStriper::GetWeights() const {
+  std::vector<double> weights;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    weights = config_.bandwidths.empty() ? measured_ : config_.bandwidths;
+  }
+  double known_sum = 0.0;
+  size_t known_num = 0U;
+  for (const double weight : weights) {
+    if (weight > 0.0) {
+      known_sum += weight;
+      ++known_num;
+    }
+  }
+  // rails without a sample yet are assumed to be as fast as the average measured one
+  const double mean = (known_num == 0U) ? 1.0 : known_sum / static_cast<double>(known_num);
+  double sum = 0.0;
+  for (auto &weight : weights) {
+    weight = (weight > 0.0) ? std::max(weight, mean * kMinWeightRatio) : mean;
+    sum += weight;
+  }
+  for (auto &weight : weights) {
+    weight /= sum;
+  }
+  return weights;
+}
+
+void RailStriper::Split(const std::vector<TransferOpDesc> &op_descs,
+                        std::vector<std::vector<TransferOpDesc>> &rail_op_descs) const {
+  rail_op_descs.assign(rail_num_, {});
+  if (!ShouldStripe(op_descs)) {
+    rail_op_descs[0U] = op_descs;
+    return;
+  }
+  uint64_t total = 0U;
+  for (const auto &op_desc : op_descs) {
+    total += op_desc.len;
+  }
+  // ends[i] is where the piece of rail i stops in the byte stream
+  const auto weights = GetWeights();
+  std::vector<uint64_t> ends(rail_num_, total);
+  double acc = 0.0;
+  for (size_t i = 0U; i + 1U < rail_num_; ++i) {
+    acc += weights[i];
+    const auto end = static_cast<uint64_t>(acc * static_cast<double>(total));
+    ends[i] = std::min(total, end / kStripeAlign * kStripeAlign);
+    if ((i > 0U) && (ends[i] < ends[i - 1U])) {
+      ends[i] = ends[i - 1U];
+    }
+  }
+  size_t rail = 0U;
+  uint64_t pos = 0U;
+  for (const auto &op_desc : op_descs) {
+    uint64_t offset = 0U;
+    do {
+      while ((rail + 1U < rail_num_) && (pos >= ends[rail])) {
+        ++rail;
+      }
+      const uint64_t piece = std::min(static_cast<uint64_t>(op_desc.len) - offset, ends[rail] - pos);
+      rail_op_descs[rail].emplace_back(TransferOpDesc{op_desc.local_addr + offset, op_desc.remote_addr + offset,
+                                                      static_cast<size_t>(piece)});
+      offset += piece;
+      pos += piece;
+    } while (offset < op_desc.len);
+  }
+}
+
+void RailStriper::RecordTransfer(size_t rail, uint64_t bytes, uint64_t cost_us) {
+  if ((bytes == 0U) || (rail >= rail_num_)) {
+    return;
+  }
+  const double sample = static_cast<double>(bytes) / static_cast<double>(std::max(cost_us, static_cast<uint64_t>(1U)));
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &measured = measured_[rail];
+  measured = (measured > 0.0) ? (measured * (1.0 - kMeasureAlpha) + sample * kMeasureAlpha) : sample;
+}
+
+Status RailStriper::ParseBandwidths(const std::string &value, std::vector<double> &bandwidths) {
+  bandwidths.clear();
+  for (const auto &item : hixl::Split(value, ',')) {
+    double bandwidth = 0.0;
+    HIXL_CHK_STATUS_RET(ToNumber(item, bandwidth), "Invalid rail bandwidth [%s] in [%s]", item.c_str(),
+                        value.c_str());
+    HIXL_CHK_BOOL_RET_STATUS(bandwidth > 0.0, PARAM_INVALID, "Rail bandwidth must be positive, value:[%s]",
+                             value.c_str());
+    bandwidths.emplace_back(bandwidth);
+  }
+  return SUCCESS;
+}
+
+Status RailStriper::LoadConfigFromEnv(RailStripeConfig &config) {
+  const char *enable = std::getenv(kEnvMultiRail);
+  config.enable = (enable != nullptr) && (std::string(enable) == "1");
+  const char *min_bytes = std::getenv(kEnvMultiRailMinBytes);
+  if (min_bytes != nullptr) {
+    HIXL_CHK_STATUS_RET(ToNumber(std::string(min_bytes), config.min_stripe_bytes), "Invalid %s:[%s]",
+                        kEnvMultiRailMinBytes, min_bytes);
+  }
+  const char *bandwidths = std::getenv(kEnvRailBandwidth);
+  if (bandwidths != nullptr) {
+    HIXL_CHK_STATUS_RET(ParseBandwidths(bandwidths, config.bandwidths), "Invalid %s:[%s]", kEnvRailBandwidth,
+                        bandwidths);
+  }
+  HIXL_LOGI("Multi rail striping enable:%d, min stripe bytes:%lu, configured bandwidths:%zu",
+            static_cast<int32_t>(config.enable), config.min_stripe_bytes, config.bandwidths.size());
+  return SUCCESS;
+}
+}  // namespace hixl
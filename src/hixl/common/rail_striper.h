@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_HIXL_SRC_HIXL_COMMON_RAIL_STRIPER_H_
+#define CANN_HIXL_SRC_HIXL_COMMON_RAIL_STRIPER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "hixl/hixl_types.h"
+
+namespace hixl {
+struct RailStripeConfig {
+  bool enable = false;
+  // batches smaller than this stay on the first rail
+  uint64_t min_stripe_bytes = 8UL * 1024UL * 1024UL;
+  // relative bandwidth of each rail in endpoint match order, empty means measure it from completed transfers
+  std::vector<double> bandwidths;
+};
+
+// Splits a batch over several endpoint pairs (rails) of one comm type. The ops are laid end to end and the byte
+// stream is cut into one contiguous piece per rail, sized by the rail weight, so every byte is moved exactly once
+// and an op crossing a cut becomes two ops.
+class RailStriper {
+ public:
+  // cut points are rounded to this so that pieces stay page sized
+  static constexpr uint64_t kStripeAlign = 4096U;
+
+  RailStriper() = default;
+  ~RailStriper() = default;
+
+  void Init(size_t rail_num, const RailStripeConfig &config);
+  size_t GetRailNum() const {
+    return rail_num_;
+  }
+  bool ShouldStripe(const std::vector<TransferOpDesc> &op_descs) const;
+  // rail_op_descs[i] holds the ops of rail i, a batch that is not striped goes to rail 0 unchanged
+  void Split(const std::vector<TransferOpDesc> &op_descs,
+             std::vector<std::vector<TransferOpDesc>> &rail_op_descs) const;
+  // feeds measured bandwidth, ignored when bandwidths are configured
+  void RecordTransfer(size_t rail, uint64_t bytes, uint64_t cost_us);
+  // normalized, sums to 1
+  std::vector<double> GetWeights() const;
+
+  // HIXL_MULTI_RAIL=1 enables striping, HIXL_MULTI_RAIL_MIN_BYTES sets the threshold and HIXL_RAIL_BANDWIDTH
+  // takes a comma separated bandwidth per rail
+  static Status LoadConfigFromEnv(RailStripeConfig &config);
+  static Status ParseBandwidths(const std::string &value, std::vector<double> &bandwidths);
+
+ private:
+  size_t rail_num_ = 1U;
+  RailStripeConfig config_;
+  mutable std::mutex mutex_;
+  // bytes per microsecond, smoothed, 0 until the rail completed a transfer
+  std::vector<double> measured_;
+};
+}  // namespace hixl
+
+#endif  // CANN_HIXL_SRC_HIXL_COMMON_RAIL_STRIPER_H_
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "range_cover_index.h"
+#include <algorithm>
+
+namespace hixl {
+void RangeCoverIndex::Build(const std::vector<std::pair<uint64_t, uint64_t>> &sorted_ranges) {
+  covers_.clear();
+  last_hit_.store(0U, std::memory_order_relaxed);
+  // ranges reachable from each other form a group, every cover of a group reaches the group end
+  bool in_group = false;
+  size_t group_begin = 0U;
+  uint64_t group_end = 0U;
+  for (const auto &range : sorted_ranges) {
+    if (in_group && (range.first > group_end) && (range.first - group_end > 1U)) {
+      for (size_t i = group_begin; i < covers_.size(); ++i) {
+        covers_[i].reach = group_end;
+      }
+      group_begin = covers_.size();
+      in_group = false;
+    }
+    group_end = in_group ? std::max(group_end, range.second) : range.second;
+    in_group = true;
+    if (range.second <= range.first) {
+      continue;
+    }
+    if ((covers_.size() > group_begin) && (range.first <= covers_.back().end)) {
+      covers_.back().end = std::max(covers_.back().end, range.second);
+    } else {
+      covers_.emplace_back(Cover{range.first, range.second, 0U});
+    }
+  }
+  for (size_t i = group_begin; i < covers_.size(); ++i) {
+    covers_[i].reach = group_end;
+  }
+}
+
+bool RangeCoverIndex::Contains(uint64_t start, uint64_t end) const {
+  if ((start > end) || covers_.empty()) {
+    return false;
+  }
+  size_t index = last_hit_.load(std::memory_order_relaxed);
+  if ((index >= covers_.size()) || (start < covers_[index].start) || (start >= covers_[index].end)) {
+    auto it = std::upper_bound(covers_.begin(), covers_.end(), start,
+                               [](uint64_t val, const Cover &cover) { return val < cover.start; });
+    if (it == covers_.begin()) {
+      return false;
+    }
+    --it;
+    if (start >= it->end) {
+      return false;
+    }
+    index = static_cast<size_t>(it - covers_.begin());
+    last_hit_.store(index, std::memory_order_relaxed);
+  }
+  return covers_[index].reach >= end;
+}
+}  // namespace hixl
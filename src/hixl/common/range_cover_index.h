@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_HIXL_SRC_HIXL_COMMON_RANGE_COVER_INDEX_H_
+#define CANN_HIXL_SRC_HIXL_COMMON_RANGE_COVER_INDEX_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace hixl {
+// Answers Segment::Contains with one binary search. Ranges are [start, end) sorted by start, a query start must lie
+// inside a range, from there the query may extend over following ranges that begin at most one byte after the
+// end reached so far. Build merges the ranges into disjoint covered intervals, each carrying the farthest end
+// reachable from it.
+class RangeCoverIndex {
+ public:
+  RangeCoverIndex() = default;
+  RangeCoverIndex(const RangeCoverIndex &other) : covers_(other.covers_) {}
+  RangeCoverIndex &operator=(const RangeCoverIndex &other) {
+    covers_ = other.covers_;
+    last_hit_.store(0U, std::memory_order_relaxed);
+    return *this;
+  }
+
+  void Build(const std::vector<std::pair<uint64_t, uint64_t>> &sorted_ranges);
+  bool Contains(uint64_t start, uint64_t end) const;
+
+ private:
+  struct Cover {
+    uint64_t start;
+    uint64_t end;
+    uint64_t reach;
+  };
+
+  std::vector<Cover> covers_;
+  // transfers tend to hit the same registration repeatedly, try the last found cover first
+  mutable std::atomic<size_t> last_hit_{0U};
+};
+}  // namespace hixl
+
+#endif  // CANN_HIXL_SRC_HIXL_COMMON_RANGE_COVER_INDEX_H_
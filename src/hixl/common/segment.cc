@@ -36,6 +36,7 @@ Status Segment::AddRange(uint64_t start, uint64_t len) {
     HIXL_LOGI("Range already exists, start:%llu, end:%llu", start, end);
   }
   ranges_.insert(it, {start, end});
+  cover_index_.Build(ranges_);
   return SUCCESS;
 }
 
@@ -47,6 +48,7 @@ void Segment::RemoveRange(uint64_t start, uint64_t end) {
   for (; it != ranges_.end() && it->first == start; ++it) {
     if (it->second == end) {
       ranges_.erase(it);
+      cover_index_.Build(ranges_);
       HIXL_LOGI("Remove range %lu-%lu, left ranges size:%zu", start, end, ranges_.size());
       return;
     }
@@ -54,45 +56,7 @@ void Segment::RemoveRange(uint64_t start, uint64_t end) {
 }
 
 bool Segment::Contains(uint64_t start, uint64_t end) const {
-  if (start > end) {
-    return false;
-  }
-  auto it = std::upper_bound(ranges_.begin(), ranges_.end(), start,
-                             [](uint64_t val, const std::pair<uint64_t, uint64_t> &range) {
-                               return val < range.first;
-                             });
-
-  uint64_t max_reached = start;
-  bool covered_start = false;
-  // left range make sure range.start <= start
-  for (auto r_it = std::make_reverse_iterator(it); r_it != ranges_.rend(); ++r_it) {
-    if (r_it->second > start) {
-      if (r_it->second > max_reached) {
-        max_reached = r_it->second;
-      }
-      covered_start = true;
-      if (max_reached >= end) {
-        return true;
-      }
-    }
-  }
-
-  if (!covered_start) {
-    return false;
-  }
-
-  for (; it != ranges_.end(); ++it) {
-    if (it->first > (max_reached + 1)) {
-      break;
-    }
-    if (it->second > max_reached) {
-      max_reached = it->second;
-      if (max_reached >= end) {
-        return true;
-      }
-    }
-  }
-  return max_reached >= end;
+  return cover_index_.Contains(start, end);
 }
 
 MemType Segment::GetMemType() const {
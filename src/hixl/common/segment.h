@@ -13,6 +13,7 @@
 
 #include <vector>
 #include "hixl/hixl_types.h"
+#include "range_cover_index.h"
 
 namespace hixl {
 class Segment {
@@ -25,6 +26,7 @@ class Segment {
 
  private:
   std::vector<std::pair<uint64_t, uint64_t>> ranges_;
+  RangeCoverIndex cover_index_;  // rebuilt on every range change
   MemType mem_type_;
 };
 
@@ -0,0 +1,668 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "shm_transport.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include "securec.h"
+#include "hixl_checker.h"
+#include "hixl_log.h"
+#include "hixl_utils.h"
+
+namespace hixl {
+namespace {
+constexpr uint32_t kShmMagic = 0x53484D31U;
+constexpr size_t kTokenLen = 32U;
+// descriptors of one SCM_RIGHTS message, index 0 is the revocation table and every region has its own
+constexpr size_t kMaxShmFds = 64U;
+constexpr size_t kMaxShmRegions = kMaxShmFds - 1U;
+constexpr size_t kRevocationTableSize = sizeof(std::atomic<uint64_t>) * kMaxShmRegions;
+constexpr uint64_t kRevokedGeneration = 0U;
+constexpr uint32_t kShmSeals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+constexpr size_t kCopyChunkSize = 2UL * 1024UL * 1024UL;
+constexpr int32_t kAcceptPollMs = 100;
+constexpr int32_t kServeTimeoutMs = 3000;
+constexpr const char *kEnvShmTransport = "HIXL_SHM_TRANSPORT";
+constexpr const char *kEnvShmCopyThreads = "HIXL_SHM_COPY_THREADS";
+constexpr const char *kPlacementHost = "host";
+
+struct ShmRespHeader {
+  uint32_t magic;
+  uint32_t region_num;
+  uint32_t fd_num;
+  uint32_t reserved;
+};
+
+struct ShmRegionMsg {
+  uint64_t addr;
+  uint64_t len;
+  uint64_t generation;
+  uint32_t fd_index;
+  uint32_t slot;
+};
+
+struct ShmBlock {
+  size_t size;
+  int32_t fd;
+};
+
+std::mutex &GetBlockMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<uintptr_t, ShmBlock> &GetBlocks() {
+  static std::map<uintptr_t, ShmBlock> blocks;
+  return blocks;
+}
+
+std::string ReadFirstLine(const std::string &path) {
+  std::ifstream file(path);
+  std::string line;
+  (void)std::getline(file, line);
+  return line;
+}
+
+std::string GenerateToken() {
+  std::random_device device;
+  std::string token;
+  static const char kHex[] = "0123456789abcdef";
+  while (token.size() < kTokenLen) {
+    uint32_t value = device();
+    for (size_t i = 0U; (i < 8U) && (token.size() < kTokenLen); ++i) {
+      token.push_back(kHex[value & 0xFU]);
+      value >>= 4U;
+    }
+  }
+  return token;
+}
+
+void SetTimeout(int32_t fd, int32_t timeout_ms) {
+  struct timeval tv {};
+  tv.tv_sec = timeout_ms / 1000;
+  tv.tv_usec = (timeout_ms % 1000) * 1000;
+  (void)setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  (void)setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+Status FillAbstractAddr(const std::string &name, struct sockaddr_un &addr, socklen_t &addr_len) {
+  HIXL_CHK_BOOL_RET_STATUS(name.size() + 1U < sizeof(addr.sun_path), PARAM_INVALID, "Invalid shm socket name:%s",
+                           name.c_str());
+  addr = {};
+  addr.sun_family = AF_UNIX;
+  // leading zero byte selects the abstract namespace, nothing is left behind in the file system
+  addr.sun_path[0] = '\0';
+  (void)memcpy_s(addr.sun_path + 1, sizeof(addr.sun_path) - 1U, name.data(), name.size());
+  addr_len = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + 1U + name.size());
+  return SUCCESS;
+}
+
+Status SendAll(int32_t fd, const void *buf, size_t len) {
+  const auto *data = static_cast<const uint8_t *>(buf);
+  size_t sent = 0U;
+  while (sent < len) {
+    const ssize_t n = send(fd, data + sent, len - sent, MSG_NOSIGNAL);
+    if ((n < 0) && (errno == EINTR)) {
+      continue;
+    }
+    HIXL_CHK_BOOL_RET_STATUS(n > 0, FAILED, "Shm socket send failed, fd:%d, errno:%d", fd, errno);
+    sent += static_cast<size_t>(n);
+  }
+  return SUCCESS;
+}
+
+// sized once and sealed, so a peer mapping never runs past the end of the file
+int32_t CreateSealedMemFd(const char *name, size_t size) {
+  const int32_t fd = memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd < 0) {
+    HIXL_LOGE(FAILED, "memfd_create failed, size:%zu, errno:%d", size, errno);
+    return -1;
+  }
+  if ((ftruncate(fd, static_cast<off_t>(size)) != 0) || (fcntl(fd, F_ADD_SEALS, kShmSeals) != 0)) {
+    HIXL_LOGE(FAILED, "Size memfd failed, size:%zu, errno:%d", size, errno);
+    (void)close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+Status RecvAll(int32_t fd, void *buf, size_t len) {
+  auto *data = static_cast<uint8_t *>(buf);
+  size_t received = 0U;
+  while (received < len) {
+    const ssize_t n = recv(fd, data + received, len - received, 0);
+    if ((n < 0) && (errno == EINTR)) {
+      continue;
+    }
+    HIXL_CHK_BOOL_RET_STATUS(n > 0, FAILED, "Shm socket recv failed, fd:%d, ret:%zd, errno:%d", fd, n, errno);
+    received += static_cast<size_t>(n);
+  }
+  return SUCCESS;
+}
+}  // namespace
+
+Status LoadShmTransportConfigFromEnv(ShmTransportConfig &config) {
+  const char *enable = std::getenv(kEnvShmTransport);
+  config.enable = (enable != nullptr) && (std::string(enable) == "1");
+  const char *thread_num = std::getenv(kEnvShmCopyThreads);
+  if (thread_num != nullptr) {
+    HIXL_CHK_STATUS_RET(ToNumber(std::string(thread_num), config.copy_thread_num), "Invalid %s:[%s]",
+                        kEnvShmCopyThreads, thread_num);
+  }
+  HIXL_LOGI("Shm transport enable:%d, copy threads:%u", static_cast<int32_t>(config.enable), config.copy_thread_num);
+  return SUCCESS;
+}
+
+std::string GetShmHostId() {
+  // abstract unix sockets are scoped by network namespace, so peers must share the boot and the namespace
+  char net_ns[64] = {};
+  const ssize_t len = readlink("/proc/self/ns/net", net_ns, sizeof(net_ns) - 1U);
+  const std::string net_ns_str = (len > 0) ? std::string(net_ns, static_cast<size_t>(len)) : "";
+  return ReadFirstLine("/proc/sys/kernel/random/boot_id") + "/" + net_ns_str;
+}
+
+Status ShmHostMemory::Alloc(size_t size, void *&ptr) {
+  HIXL_CHK_BOOL_RET_STATUS(size > 0U, PARAM_INVALID, "Shm host memory size must be positive");
+  const int32_t fd = CreateSealedMemFd("hixl_shm", size);
+  HIXL_CHK_BOOL_RET_STATUS(fd >= 0, FAILED, "Create shm host memory failed, size:%zu", size);
+  void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    HIXL_LOGE(FAILED, "mmap memfd failed, size:%zu, errno:%d", size, errno);
+    (void)close(fd);
+    return FAILED;
+  }
+  std::lock_guard<std::mutex> lock(GetBlockMutex());
+  GetBlocks()[reinterpret_cast<uintptr_t>(addr)] = ShmBlock{size, fd};
+  ptr = addr;
+  return SUCCESS;
+}
+
+Status ShmHostMemory::Free(void *ptr) {
+  ShmBlock block{};
+  {
+    std::lock_guard<std::mutex> lock(GetBlockMutex());
+    auto it = GetBlocks().find(reinterpret_cast<uintptr_t>(ptr));
+    HIXL_CHK_BOOL_RET_STATUS(it != GetBlocks().end(), PARAM_INVALID,
+                             "Shm host memory %p is not allocated by ShmHostMemory", ptr);
+    block = it->second;
+    GetBlocks().erase(it);
+  }
+  (void)munmap(ptr, block.size);
+  (void)close(block.fd);
+  return SUCCESS;
+}
+
+bool ShmHostMemory::FindBlock(uintptr_t addr, size_t len, int32_t &fd) {
+  std::lock_guard<std::mutex> lock(GetBlockMutex());
+  const auto &blocks = GetBlocks();
+  auto it = blocks.find(addr);
+  if ((it == blocks.end()) || (it->second.size != len)) {
+    return false;
+  }
+  fd = it->second.fd;
+  return true;
+}
+
+ShmExporter::~ShmExporter() {
+  Finalize();
+}
+
+Status ShmExporter::Initialize() {
+  static std::atomic<uint32_t> exporter_seq{0U};
+  revocation_fd_ = CreateSealedMemFd("hixl_shm_revocation", kRevocationTableSize);
+  HIXL_CHK_BOOL_RET_STATUS(revocation_fd_ >= 0, FAILED, "Create shm revocation table failed");
+  void *table = mmap(nullptr, kRevocationTableSize, PROT_READ | PROT_WRITE, MAP_SHARED, revocation_fd_, 0);
+  if (table == MAP_FAILED) {
+    HIXL_LOGE(FAILED, "Map shm revocation table failed, errno:%d", errno);
+    Finalize();
+    return FAILED;
+  }
+  // zero filled, every slot starts revoked
+  revocation_table_ = static_cast<std::atomic<uint64_t> *>(table);
+  used_slots_.assign(kMaxShmRegions, false);
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listen_fd_ < 0) {
+    HIXL_LOGE(FAILED, "Create shm socket failed, errno:%d", errno);
+    Finalize();
+    return FAILED;
+  }
+  socket_name_ = "hixl_shm_" + std::to_string(getpid()) + "_" + std::to_string(exporter_seq.fetch_add(1U));
+  struct sockaddr_un addr {};
+  socklen_t addr_len = 0;
+  Status ret = FillAbstractAddr(socket_name_, addr, addr_len);
+  if ((ret != SUCCESS) || (bind(listen_fd_, reinterpret_cast<struct sockaddr *>(&addr), addr_len) != 0) ||
+      (listen(listen_fd_, SOMAXCONN) != 0)) {
+    HIXL_LOGE(FAILED, "Listen on shm socket %s failed, errno:%d", socket_name_.c_str(), errno);
+    Finalize();
+    return FAILED;
+  }
+  token_ = GenerateToken();
+  running_.store(true);
+  accept_thread_ = std::thread([this]() { AcceptLoop(); });
+  HIXL_LOGI("Shm exporter listen on %s", socket_name_.c_str());
+  return SUCCESS;
+}
+
+void ShmExporter::Finalize() {
+  running_.store(false);
+  if (accept_thread_.joinable()) {
+    accept_thread_.join();
+  }
+  if (listen_fd_ >= 0) {
+    (void)close(listen_fd_);
+    listen_fd_ = -1;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &region : regions_) {
+    RevokeLocked(region.second);
+  }
+  regions_.clear();
+  if (revocation_table_ != nullptr) {
+    (void)munmap(static_cast<void *>(revocation_table_), kRevocationTableSize);
+    revocation_table_ = nullptr;
+  }
+  if (revocation_fd_ >= 0) {
+    (void)close(revocation_fd_);
+    revocation_fd_ = -1;
+  }
+}
+
+void ShmExporter::AddRegion(uintptr_t addr, size_t len) {
+  int32_t block_fd = -1;
+  if (!ShmHostMemory::FindBlock(addr, len, block_fd)) {
+    HIXL_LOGI("Host region 0x%lx is not allocated by Hixl::MallocHostMem, same host peers use the data endpoints",
+              addr);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (revocation_table_ == nullptr) {
+    HIXL_LOGW("Shm exporter is not initialized, region 0x%lx is not exported", addr);
+    return;
+  }
+  auto it = regions_.find(addr);
+  if (it != regions_.end()) {
+    RevokeLocked(it->second);
+    regions_.erase(it);
+  }
+  auto slot = std::find(used_slots_.begin(), used_slots_.end(), false);
+  if (slot == used_slots_.end()) {
+    HIXL_LOGW("Shm exporter %s exports %zu regions already, region 0x%lx uses the data endpoints",
+              socket_name_.c_str(), kMaxShmRegions, addr);
+    return;
+  }
+  // the block may be freed while exported, keep a descriptor of our own
+  ExportedRegion region{};
+  region.fd = fcntl(block_fd, F_DUPFD_CLOEXEC, 0);
+  if (region.fd < 0) {
+    HIXL_LOGW("Dup shm block of region 0x%lx failed, errno:%d", addr, errno);
+    return;
+  }
+  *slot = true;
+  region.len = len;
+  region.slot = static_cast<uint32_t>(slot - used_slots_.begin());
+  region.generation = next_generation_++;
+  revocation_table_[region.slot].store(region.generation, std::memory_order_release);
+  regions_[addr] = region;
+}
+
+void ShmExporter::RemoveRegion(uintptr_t addr) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = regions_.find(addr);
+  if (it == regions_.end()) {
+    return;
+  }
+  RevokeLocked(it->second);
+  regions_.erase(it);
+}
+
+void ShmExporter::RevokeLocked(ExportedRegion &region) {
+  // peers check the slot before every piece they copy, a reused slot gets a new generation
+  revocation_table_[region.slot].store(kRevokedGeneration, std::memory_order_release);
+  used_slots_[region.slot] = false;
+  (void)close(region.fd);
+  region.fd = -1;
+}
+
+EndPointConfig ShmExporter::GetEndPointConfig() const {
+  EndPointConfig endpoint{};
+  endpoint.protocol = kProtocolShm;
+  endpoint.comm_id = socket_name_;
+  endpoint.placement = kPlacementHost;
+  endpoint.dst_eid = token_;
+  endpoint.net_instance_id = GetShmHostId();
+  return endpoint;
+}
+
+void ShmExporter::AcceptLoop() {
+  while (running_.load()) {
+    struct pollfd poll_fd {};
+    poll_fd.fd = listen_fd_;
+    poll_fd.events = POLLIN;
+    if (poll(&poll_fd, 1U, kAcceptPollMs) <= 0) {
+      continue;
+    }
+    const int32_t fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      continue;
+    }
+    SetTimeout(fd, kServeTimeoutMs);
+    const Status ret = ServeClient(fd);
+    if (ret != SUCCESS) {
+      HIXL_LOGW("Shm exporter %s failed to serve a peer, ret:%u", socket_name_.c_str(), ret);
+    }
+    (void)close(fd);
+  }
+}
+
+Status ShmExporter::ServeClient(int32_t fd) {
+  struct ucred cred {};
+  socklen_t cred_len = sizeof(cred);
+  HIXL_CHK_BOOL_RET_STATUS(getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) == 0, FAILED,
+                           "Get shm peer credential failed, errno:%d", errno);
+  HIXL_CHK_BOOL_RET_STATUS(cred.uid == geteuid(), FAILED, "Shm peer pid:%d uid:%u differs from uid:%u", cred.pid,
+                           cred.uid, geteuid());
+  char token[kTokenLen] = {};
+  HIXL_CHK_STATUS_RET(RecvAll(fd, token, kTokenLen), "Recv shm token failed");
+  HIXL_CHK_BOOL_RET_STATUS(std::string(token, kTokenLen) == token_, FAILED, "Shm peer pid:%d sent a wrong token",
+                           cred.pid);
+
+  // descriptors are sent under the lock, a region removed meanwhile cannot have its fd closed under us
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<int32_t> fds{revocation_fd_};
+  std::vector<ShmRegionMsg> region_msgs;
+  for (const auto &region : regions_) {
+    region_msgs.emplace_back(ShmRegionMsg{region.first, region.second.len, region.second.generation,
+                                          static_cast<uint32_t>(fds.size()), region.second.slot});
+    fds.emplace_back(region.second.fd);
+  }
+
+  ShmRespHeader header{kShmMagic, static_cast<uint32_t>(region_msgs.size()), static_cast<uint32_t>(fds.size()), 0U};
+  struct iovec iov {};
+  iov.iov_base = &header;
+  iov.iov_len = sizeof(header);
+  std::vector<char> control(CMSG_SPACE(sizeof(int32_t) * fds.size()));
+  struct msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1U;
+  msg.msg_control = control.data();
+  msg.msg_controllen = control.size();
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int32_t) * fds.size());
+  (void)memcpy_s(CMSG_DATA(cmsg), sizeof(int32_t) * fds.size(), fds.data(), sizeof(int32_t) * fds.size());
+  HIXL_CHK_BOOL_RET_STATUS(sendmsg(fd, &msg, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(header)), FAILED,
+                           "Send shm descriptors failed, errno:%d", errno);
+  if (!region_msgs.empty()) {
+    HIXL_CHK_STATUS_RET(SendAll(fd, region_msgs.data(), sizeof(ShmRegionMsg) * region_msgs.size()),
+                        "Send shm regions failed");
+  }
+  HIXL_LOGI("Shm exporter %s served peer pid:%d, regions:%zu", socket_name_.c_str(), cred.pid, region_msgs.size());
+  return SUCCESS;
+}
+
+ShmImporter::~ShmImporter() {
+  Finalize();
+}
+
+bool ShmImporter::IsLocalPeer(const EndPointConfig &endpoint) {
+  return (endpoint.protocol == kProtocolShm) && (!endpoint.comm_id.empty()) &&
+         (endpoint.net_instance_id == GetShmHostId());
+}
+
+Status ShmImporter::Connect(const EndPointConfig &endpoint, uint32_t timeout_ms) {
+  HIXL_CHK_BOOL_RET_STATUS(endpoint.dst_eid.size() == kTokenLen, PARAM_INVALID, "Invalid shm endpoint:%s",
+                           endpoint.ToString().c_str());
+  const int32_t fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  HIXL_CHK_BOOL_RET_STATUS(fd >= 0, FAILED, "Create shm socket failed, errno:%d", errno);
+  SetTimeout(fd, static_cast<int32_t>(timeout_ms));
+  struct sockaddr_un addr {};
+  socklen_t addr_len = 0;
+  Status ret = FillAbstractAddr(endpoint.comm_id, addr, addr_len);
+  if ((ret == SUCCESS) && (connect(fd, reinterpret_cast<struct sockaddr *>(&addr), addr_len) != 0)) {
+    HIXL_LOGE(FAILED, "Connect shm socket %s failed, errno:%d", endpoint.comm_id.c_str(), errno);
+    ret = FAILED;
+  }
+  if (ret == SUCCESS) {
+    ret = SendAll(fd, endpoint.dst_eid.data(), kTokenLen);
+  }
+  if (ret == SUCCESS) {
+    ret = RecvRegions(fd);
+  }
+  (void)close(fd);
+  if (ret != SUCCESS) {
+    Finalize();
+    return ret;
+  }
+  if (config_.copy_thread_num > 1U) {
+    executor_ = MakeUnique<WorkStealingExecutor>("hixl_shm", config_.copy_thread_num);
+    HIXL_CHECK_NOTNULL(executor_);
+  }
+  connected_ = true;
+  HIXL_LOGI("Shm importer connected to %s, regions:%zu", endpoint.comm_id.c_str(), regions_.size());
+  return SUCCESS;
+}
+
+Status ShmImporter::RecvRegions(int32_t fd) {
+  ShmRespHeader header{};
+  struct iovec iov {};
+  iov.iov_base = &header;
+  iov.iov_len = sizeof(header);
+  std::vector<char> control(CMSG_SPACE(sizeof(int32_t) * kMaxShmFds));
+  struct msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1U;
+  msg.msg_control = control.data();
+  msg.msg_controllen = control.size();
+  const ssize_t n = recvmsg(fd, &msg, MSG_WAITALL | MSG_CMSG_CLOEXEC);
+  std::vector<int32_t> fds;
+  for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_RIGHTS)) {
+      const size_t fd_num = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int32_t);
+      fds.resize(fd_num);
+      (void)memcpy_s(fds.data(), sizeof(int32_t) * fd_num, CMSG_DATA(cmsg), sizeof(int32_t) * fd_num);
+    }
+  }
+  // every descriptor is closed once mapped, index 0 is the revocation table and is mapped read only
+  std::vector<uint8_t *> bases(fds.size(), nullptr);
+  std::vector<size_t> sizes(fds.size(), 0U);
+  Status ret = SUCCESS;
+  if ((n != static_cast<ssize_t>(sizeof(header))) || (header.magic != kShmMagic) || (fds.empty()) ||
+      (header.fd_num != fds.size()) || (header.region_num + 1U != fds.size()) ||
+      ((msg.msg_flags & MSG_CTRUNC) != 0)) {
+    HIXL_LOGE(FAILED, "Invalid shm response, ret:%zd, magic:0x%X, fds:%zu, errno:%d", n, header.magic, fds.size(),
+              errno);
+    ret = FAILED;
+  }
+  for (size_t i = 0U; (ret == SUCCESS) && (i < fds.size()); ++i) {
+    struct stat file_stat {};
+    void *addr = MAP_FAILED;
+    const int32_t prot = (i == 0U) ? PROT_READ : (PROT_READ | PROT_WRITE);
+    if ((fstat(fds[i], &file_stat) == 0) && (file_stat.st_size > 0) &&
+        ((i != 0U) || (static_cast<size_t>(file_stat.st_size) == kRevocationTableSize))) {
+      addr = mmap(nullptr, static_cast<size_t>(file_stat.st_size), prot, MAP_SHARED, fds[i], 0);
+    }
+    if (addr == MAP_FAILED) {
+      HIXL_LOGE(FAILED, "Map shm descriptor %zu failed, errno:%d", i, errno);
+      ret = FAILED;
+      break;
+    }
+    mappings_.emplace_back(addr, static_cast<size_t>(file_stat.st_size));
+    bases[i] = static_cast<uint8_t *>(addr);
+    sizes[i] = static_cast<size_t>(file_stat.st_size);
+  }
+  for (const auto fd : fds) {
+    (void)close(fd);
+  }
+  HIXL_CHK_STATUS_RET(ret, "Import shm descriptors failed");
+  revocation_table_ = reinterpret_cast<const std::atomic<uint64_t> *>(bases[0U]);
+
+  std::vector<ShmRegionMsg> region_msgs(header.region_num);
+  if (!region_msgs.empty()) {
+    HIXL_CHK_STATUS_RET(RecvAll(fd, region_msgs.data(), sizeof(ShmRegionMsg) * region_msgs.size()),
+                        "Recv shm regions failed");
+  }
+  for (size_t i = 0U; i < region_msgs.size(); ++i) {
+    const auto &region_msg = region_msgs[i];
+    HIXL_CHK_BOOL_RET_STATUS((region_msg.fd_index == i + 1U) && (region_msg.slot < kMaxShmRegions), FAILED,
+                             "Invalid shm region, fd index:%u, slot:%u", region_msg.fd_index, region_msg.slot);
+    HIXL_CHK_BOOL_RET_STATUS(region_msg.len <= sizes[region_msg.fd_index], FAILED,
+                             "Shm region exceeds its mapping, addr:0x%lx", region_msg.addr);
+    Region region{};
+    region.len = static_cast<size_t>(region_msg.len);
+    region.mapped = bases[region_msg.fd_index];
+    region.slot = region_msg.slot;
+    region.generation = region_msg.generation;
+    regions_[static_cast<uintptr_t>(region_msg.addr)] = region;
+  }
+  return SUCCESS;
+}
+
+void ShmImporter::Finalize() {
+  {
+    // copies still running reference the mappings
+    std::lock_guard<std::mutex> lock(requests_mutex_);
+    for (const auto &request : requests_) {
+      while (request.second->running.load(std::memory_order_acquire) != 0U) {
+        std::this_thread::yield();
+      }
+    }
+    requests_.clear();
+  }
+  if (executor_ != nullptr) {
+    executor_->Stop();
+    executor_.reset();
+  }
+  for (const auto &mapping : mappings_) {
+    (void)munmap(mapping.first, mapping.second);
+  }
+  mappings_.clear();
+  regions_.clear();
+  revocation_table_ = nullptr;
+  connected_ = false;
+}
+
+bool ShmImporter::IsRevoked(const Region &region) const {
+  return revocation_table_[region.slot].load(std::memory_order_acquire) != region.generation;
+}
+
+const ShmImporter::Region *ShmImporter::FindRegion(uintptr_t remote_addr, size_t len, uintptr_t &base) const {
+  auto it = regions_.upper_bound(remote_addr);
+  if (it == regions_.begin()) {
+    return nullptr;
+  }
+  --it;
+  if ((remote_addr + len > it->first + it->second.len) || IsRevoked(it->second)) {
+    return nullptr;
+  }
+  base = it->first;
+  return &it->second;
+}
+
+bool ShmImporter::Contains(uintptr_t remote_addr, size_t len) const {
+  uintptr_t base = 0U;
+  return connected_ && (FindRegion(remote_addr, len, base) != nullptr);
+}
+
+Status ShmImporter::CopyPiece(const Piece &piece, TransferOp operation) const {
+  HIXL_CHK_BOOL_RET_STATUS(!IsRevoked(*piece.region), FAILED, "Shm region is deregistered by peer during transfer");
+  void *dst = (operation == READ) ? static_cast<void *>(piece.local) : static_cast<void *>(piece.mapped);
+  const void *src = (operation == READ) ? static_cast<const void *>(piece.mapped) : piece.local;
+  const errno_t rc = memcpy_s(dst, piece.len, src, piece.len);
+  HIXL_CHK_BOOL_RET_STATUS(rc == EOK, FAILED, "Shm copy failed, rc:%d, len:%zu", static_cast<int32_t>(rc),
+                           piece.len);
+  return SUCCESS;
+}
+
+void ShmImporter::DrainPieces(Request &request) const {
+  while (true) {
+    const size_t index = request.next.fetch_add(1U, std::memory_order_relaxed);
+    if ((index >= request.pieces.size()) || request.failed.load(std::memory_order_relaxed)) {
+      return;
+    }
+    if (CopyPiece(request.pieces[index], request.operation) != SUCCESS) {
+      request.failed.store(true, std::memory_order_relaxed);
+    }
+  }
+}
+
+Status ShmImporter::TransferAsync(const std::vector<TransferOpDesc> &op_descs, TransferOp operation,
+                                  bool high_priority, void *&handle) {
+  HIXL_CHK_BOOL_RET_STATUS(connected_, NOT_CONNECTED, "Shm importer is not connected");
+  auto request = MakeUnique<Request>();
+  HIXL_CHECK_NOTNULL(request);
+  request->operation = operation;
+  uint64_t total = 0U;
+  for (const auto &op_desc : op_descs) {
+    uintptr_t base = 0U;
+    const Region *region = FindRegion(op_desc.remote_addr, op_desc.len, base);
+    HIXL_CHK_BOOL_RET_STATUS(region != nullptr, PARAM_INVALID, "Remote range [0x%lx, 0x%lx) is not exported by peer",
+                             op_desc.remote_addr, op_desc.remote_addr + op_desc.len);
+    for (size_t offset = 0U; offset < op_desc.len; offset += kCopyChunkSize) {
+      Piece piece{};
+      piece.local = reinterpret_cast<uint8_t *>(op_desc.local_addr) + offset;
+      piece.mapped = region->mapped + (op_desc.remote_addr + offset - base);
+      piece.len = std::min(kCopyChunkSize, op_desc.len - offset);
+      piece.region = region;
+      request->pieces.emplace_back(piece);
+    }
+    total += op_desc.len;
+  }
+
+  Request *raw = request.get();
+  if ((executor_ != nullptr) && (total >= config_.parallel_min_bytes) && (request->pieces.size() > 1U)) {
+    const auto task_num =
+        static_cast<uint32_t>(std::min(static_cast<size_t>(executor_->GetWorkerNum()), request->pieces.size()));
+    raw->running.store(task_num, std::memory_order_relaxed);
+    const auto priority = high_priority ? TaskPriority::kHigh : TaskPriority::kNormal;
+    for (uint32_t i = 0U; i < task_num; ++i) {
+      auto task = [this, raw]() {
+        DrainPieces(*raw);
+        (void)raw->running.fetch_sub(1U, std::memory_order_acq_rel);
+      };
+      if (!executor_->Submit(task, priority)) {
+        task();
+      }
+    }
+  } else {
+    DrainPieces(*raw);
+  }
+  handle = raw;
+  std::lock_guard<std::mutex> lock(requests_mutex_);
+  requests_[raw] = std::move(request);
+  return SUCCESS;
+}
+
+Status ShmImporter::QueryCompleteStatus(void *handle, bool &completed) {
+  std::lock_guard<std::mutex> lock(requests_mutex_);
+  auto it = requests_.find(handle);
+  HIXL_CHK_BOOL_RET_STATUS(it != requests_.end(), PARAM_INVALID, "Invalid shm transfer handle:%p", handle);
+  completed = (it->second->running.load(std::memory_order_acquire) == 0U);
+  if (!completed) {
+    return SUCCESS;
+  }
+  const bool failed = it->second->failed.load(std::memory_order_relaxed);
+  requests_.erase(it);
+  HIXL_CHK_BOOL_RET_STATUS(!failed, FAILED, "Shm transfer failed, handle:%p", handle);
+  return SUCCESS;
+}
+}  // namespace hixl
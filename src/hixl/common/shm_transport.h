@@ -0,0 +1,161 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_HIXL_SRC_HIXL_COMMON_SHM_TRANSPORT_H_
+#define CANN_HIXL_SRC_HIXL_COMMON_SHM_TRANSPORT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hixl/hixl_types.h"
+#include "common/hixl_inner_types.h"
+#include "common/work_stealing_executor.h"
+
+namespace hixl {
+constexpr const char *kProtocolShm = "shm";
+
+struct ShmTransportConfig {
+  bool enable = false;
+  uint32_t copy_thread_num = 4U;
+  // batches smaller than this are copied by the submitting thread
+  uint64_t parallel_min_bytes = 4UL * 1024UL * 1024UL;
+};
+
+// HIXL_SHM_TRANSPORT=1 enables the transport, HIXL_SHM_COPY_THREADS sets the copy thread number
+Status LoadShmTransportConfigFromEnv(ShmTransportConfig &config);
+// peers with the same host id reach each other through abstract unix sockets
+std::string GetShmHostId();
+
+// Host memory backed by a memfd, users get it through Hixl::MallocHostMem. Only these blocks are exported to
+// same-host peers, which map them and copy with memcpy. Other registered host memory is reached through the data
+// endpoints.
+class ShmHostMemory {
+ public:
+  static Status Alloc(size_t size, void *&ptr);
+  static Status Free(void *ptr);
+  // true if [addr, addr + len) is exactly one block, fd stays owned by the registry
+  static bool FindBlock(uintptr_t addr, size_t len, int32_t &fd);
+};
+
+// Server side. Whole ShmHostMemory blocks registered with the server are handed out over a unix socket, each with
+// its own descriptor, so a peer can reach nothing beyond them. A peer is served only if it runs under the same uid
+// and presents the token advertised in the endpoint list. Every exported region owns a slot of a shared revocation
+// table that peers map read only, removing the region clears its slot and peers stop using it.
+class ShmExporter {
+ public:
+  ShmExporter() = default;
+  ~ShmExporter();
+  ShmExporter(const ShmExporter &) = delete;
+  ShmExporter &operator=(const ShmExporter &) = delete;
+
+  Status Initialize();
+  void Finalize();
+  bool IsInitialized() const {
+    return running_.load();
+  }
+  // regions that are not a whole ShmHostMemory block are not exported
+  void AddRegion(uintptr_t addr, size_t len);
+  void RemoveRegion(uintptr_t addr);
+  // endpoint appended to the endpoint list, peers that do not know the protocol skip it
+  EndPointConfig GetEndPointConfig() const;
+
+ private:
+  struct ExportedRegion {
+    size_t len = 0U;
+    int32_t fd = -1;
+    uint32_t slot = 0U;
+    uint64_t generation = 0U;
+  };
+
+  void AcceptLoop();
+  Status ServeClient(int32_t fd);
+  void RevokeLocked(ExportedRegion &region);
+
+  int32_t listen_fd_ = -1;
+  int32_t revocation_fd_ = -1;
+  std::atomic<uint64_t> *revocation_table_ = nullptr;
+  std::string socket_name_;
+  std::string token_;
+  std::atomic<bool> running_{false};
+  std::thread accept_thread_;
+  std::mutex mutex_;
+  std::map<uintptr_t, ExportedRegion> regions_;
+  std::vector<bool> used_slots_;
+  uint64_t next_generation_ = 1U;
+};
+
+// Client side, imports the regions of a same-host server and serves host to host transfers by copying directly.
+class ShmImporter {
+ public:
+  explicit ShmImporter(const ShmTransportConfig &config = ShmTransportConfig{}) : config_(config) {}
+  ~ShmImporter();
+  ShmImporter(const ShmImporter &) = delete;
+  ShmImporter &operator=(const ShmImporter &) = delete;
+
+  // true if the endpoint is a shm endpoint of a process on this host and in this network namespace
+  static bool IsLocalPeer(const EndPointConfig &endpoint);
+  Status Connect(const EndPointConfig &endpoint, uint32_t timeout_ms);
+  void Finalize();
+  bool IsConnected() const {
+    return connected_;
+  }
+  bool Contains(uintptr_t remote_addr, size_t len) const;
+  // small batches complete before returning, large ones are split over the copy threads
+  Status TransferAsync(const std::vector<TransferOpDesc> &op_descs, TransferOp operation, bool high_priority,
+                       void *&handle);
+  // the handle is released once it is reported complete or failed
+  Status QueryCompleteStatus(void *handle, bool &completed);
+
+ private:
+  struct Region {
+    size_t len = 0U;
+    uint8_t *mapped = nullptr;
+    uint32_t slot = 0U;
+    uint64_t generation = 0U;
+  };
+  struct Piece {
+    uint8_t *local = nullptr;
+    uint8_t *mapped = nullptr;  // peer memory in this process
+    size_t len = 0U;
+    const Region *region = nullptr;
+  };
+  struct Request {
+    std::vector<Piece> pieces;
+    TransferOp operation = READ;
+    std::atomic<size_t> next{0U};
+    std::atomic<uint32_t> running{0U};
+    std::atomic<bool> failed{false};
+  };
+
+  Status RecvRegions(int32_t fd);
+  bool IsRevoked(const Region &region) const;
+  // revoked regions are not found
+  const Region *FindRegion(uintptr_t remote_addr, size_t len, uintptr_t &base) const;
+  Status CopyPiece(const Piece &piece, TransferOp operation) const;
+  void DrainPieces(Request &request) const;
+
+  ShmTransportConfig config_;
+  bool connected_ = false;
+  const std::atomic<uint64_t> *revocation_table_ = nullptr;
+  std::map<uintptr_t, Region> regions_;  // keyed by remote start address
+  std::vector<std::pair<void *, size_t>> mappings_;
+  std::unique_ptr<WorkStealingExecutor> executor_;
+  std::mutex requests_mutex_;
+  std::map<void *, std::unique_ptr<Request>> requests_;
+};
+}  // namespace hixl
+
+#endif  // CANN_HIXL_SRC_HIXL_COMMON_SHM_TRANSPORT_H_
@@ -12,11 +12,9 @@
 #define CANN_HIXL_SRC_HIXL_COMMON_THREAD_POOL_H_
 
 #include <atomic>
-#include <condition_variable>
 #include <functional>
 #include <future>
 #include <memory>
-#include <queue>
 #include <stdexcept>
 #include <thread>
 #include <vector>
@@ -25,6 +23,7 @@
 #include "hixl_cs.h"
 #include "common/hixl_log.h"
 #include "common/hixl_utils.h"
+#include "common/work_stealing_executor.h"
 
 namespace hixl {
 using ThreadTask = std::function<void()>;
@@ -52,25 +51,17 @@ class ThreadPool {
       return fail_future;
     }
     std::future<retType> future = task->get_future();
-    {
-      const std::lock_guard<std::mutex> lock{m_lock_};
-      tasks_.emplace([task]() { (*task)(); });
+    if (!executor_.Submit([task]() { (*task)(); })) {
+      HIXL_LOGE(ge::FAILED, "Submit task failed.");
+      return fail_future;
     }
-    cond_var_.notify_one();
     HIXL_LOGD("commit run task end");
     return future;
   }
 
-  static void ThreadFunc(ThreadPool *const thread_pool, uint32_t thread_idx);
-
  private:
-  std::string thread_name_prefix_;
-  std::vector<std::thread> pool_;
-  std::queue<ThreadTask> tasks_;
-  std::mutex m_lock_;
-  std::condition_variable cond_var_;
+  WorkStealingExecutor executor_;
   std::atomic<bool> is_stoped_;
-  std::atomic<uint32_t> idle_thrd_num_;
 };
 }  // namespace hixl
 
@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "trace_recorder.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "hixl_log.h"
+#include "hixl_checker.h"
+
+namespace hixl {
+namespace {
+constexpr size_t kRingMask = TraceRecorder::kRingCapacity - 1U;
+constexpr size_t kThreadNameLen = 16U;
+constexpr double kNsPerUs = 1000.0;
+
+thread_local uint64_t current_request_id = 0UL;
+
+void AppendEscaped(std::ostringstream &oss, const std::string &str) {
+  for (const char c : str) {
+    if ((c == '"') || (c == '\\')) {
+      oss << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20U) {
+      oss << ' ';
+    } else {
+      oss << c;
+    }
+  }
+}
+
+// make sure HIXL_TRACE_FILE takes effect before the first span even if nothing else touches the recorder
+const bool kTraceRecorderInited = (static_cast<void>(TraceRecorder::GetInstance()), true);
+}  // namespace
+
+std::atomic<bool> TraceRecorder::enabled_{false};
+
+TraceRecorder &TraceRecorder::GetInstance() {
+  static TraceRecorder instance;
+  return instance;
+}
+
+TraceRecorder::TraceRecorder() {
+  (void)kTraceRecorderInited;
+  const char *trace_file = std::getenv(kTraceFileEnv);
+  if ((trace_file != nullptr) && (trace_file[0] != '\0')) {
+    trace_file_ = trace_file;
+    enabled_.store(true, std::memory_order_relaxed);
+  }
+}
+
+TraceRecorder::~TraceRecorder() {
+  if (!trace_file_.empty()) {
+    (void)Flush(trace_file_);
+  }
+}
+
+void TraceRecorder::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+  HIXL_LOGI("Span tracing is %s.", enabled ? "enabled" : "disabled");
+}
+
+uint64_t TraceRecorder::NowNs() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+uint64_t TraceRecorder::GetCurrentRequestId() {
+  return current_request_id;
+}
+
+void TraceRecorder::SetCurrentRequestId(uint64_t request_id) {
+  current_request_id = request_id;
+}
+
+uint64_t TraceRecorder::NewRequestId() {
+  return next_request_id_.fetch_add(1UL, std::memory_order_relaxed);
+}
+
+TraceRecorder::ThreadBuffer *TraceRecorder::GetLocalBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> local_buffer;
+  if (local_buffer == nullptr) {
+    auto buffer = std::make_shared<ThreadBuffer>();
+    buffer->tid = static_cast<uint64_t>(syscall(__NR_gettid));
+    char thread_name[kThreadNameLen] = {};
+    if (pthread_getname_np(pthread_self(), thread_name, sizeof(thread_name)) == 0) {
+      buffer->thread_name = thread_name;
+    }
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    buffers_.emplace_back(buffer);
+    local_buffer = std::move(buffer);
+  }
+  return local_buffer.get();
+}
+
+void TraceRecorder::Record(const char *name, uint64_t request_id, uint64_t begin_ns, uint64_t end_ns) {
+  ThreadBuffer *buffer = GetLocalBuffer();
+  const uint64_t pos = buffer->write_pos.load(std::memory_order_relaxed);
+  // claim the slot first, a reader that sees any of the new fields also sees the claim
+  buffer->claim_pos.store(pos + 1UL, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  auto &slot = buffer->slots[pos & kRingMask];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.request_id.store(request_id, std::memory_order_relaxed);
+  slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+  slot.end_ns.store(end_ns, std::memory_order_relaxed);
+  buffer->write_pos.store(pos + 1UL, std::memory_order_release);
+}
+
+void TraceRecorder::CollectEvents(ThreadBuffer &buffer, std::vector<TraceEvent> &events) {
+  const uint64_t end = buffer.write_pos.load(std::memory_order_acquire);
+  const uint64_t begin = std::max(buffer.read_pos, (end > kRingCapacity) ? end - kRingCapacity : 0UL);
+  const size_t first = events.size();
+  for (uint64_t pos = begin; pos < end; ++pos) {
+    const auto &slot = buffer.slots[pos & kRingMask];
+    events.emplace_back(TraceEvent{slot.name.load(std::memory_order_relaxed),
+                                   slot.request_id.load(std::memory_order_relaxed),
+                                   slot.begin_ns.load(std::memory_order_relaxed),
+                                   slot.end_ns.load(std::memory_order_relaxed)});
+  }
+  // the owner may keep writing while copying, drop the slots that could have been overwritten meanwhile
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const uint64_t claimed = buffer.claim_pos.load(std::memory_order_relaxed);
+  const uint64_t valid_begin = (claimed > kRingCapacity) ? claimed - kRingCapacity : 0UL;
+  if (valid_begin > begin) {
+    const size_t drop_num = static_cast<size_t>(std::min(valid_begin, end) - begin);
+    (void)events.erase(events.begin() + static_cast<std::ptrdiff_t>(first),
+                       events.begin() + static_cast<std::ptrdiff_t>(first + drop_num));
+  }
+  buffer.read_pos = end;
+}
+
+std::string TraceRecorder::DumpToJson() {
+  std::lock_guard<std::mutex> dump_lock(dump_mutex_);
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    buffers = buffers_;
+    // buffers of exited threads are referenced by the list and the copy above only, drop them once collected
+    buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                  [](const std::shared_ptr<ThreadBuffer> &buffer) { return buffer.use_count() == 2; }),
+                   buffers_.end());
+  }
+  const auto pid = static_cast<uint64_t>(getpid());
+  std::ostringstream oss;
+  oss.setf(std::ios::fixed);
+  oss.precision(3);
+  oss << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  std::vector<TraceEvent> events;
+  for (const auto &buffer : buffers) {
+    events.clear();
+    CollectEvents(*buffer, events);
+    oss << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+        << ",\"args\":{\"name\":\"";
+    AppendEscaped(oss, buffer->thread_name);
+    oss << "\"}}";
+    first = false;
+    for (const auto &event : events) {
+      oss << ",{\"name\":\"";
+      AppendEscaped(oss, (event.name == nullptr) ? "" : event.name);
+      oss << "\",\"cat\":\"hixl\",\"ph\":\"X\",\"ts\":" << (static_cast<double>(event.begin_ns) / kNsPerUs)
+          << ",\"dur\":" << (static_cast<double>(event.end_ns - event.begin_ns) / kNsPerUs) << ",\"pid\":" << pid
+          << ",\"tid\":" << buffer->tid << ",\"args\":{\"request_id\":" << event.request_id << "}}";
+    }
+  }
+  oss << "]}";
+  return oss.str();
+}
+
+Status TraceRecorder::Flush(const std::string &file_path) {
+  const std::string json = DumpToJson();
+  std::ofstream ofs(file_path, std::ios::out | std::ios::trunc);
+  HIXL_CHK_BOOL_RET_STATUS(ofs.is_open(), FAILED, "Failed to open trace file:%s", file_path.c_str());
+  ofs << json;
+  ofs.close();
+  HIXL_CHK_BOOL_RET_STATUS(!ofs.fail(), FAILED, "Failed to write trace file:%s", file_path.c_str());
+  HIXL_LOGI("Flush trace to file:%s, size:%zu", file_path.c_str(), json.size());
+  return SUCCESS;
+}
+
+void TraceRecorder::Clear() {
+  (void)DumpToJson();
+}
+}  // namespace hixl
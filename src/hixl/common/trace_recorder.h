@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_HIXL_SRC_HIXL_COMMON_TRACE_RECORDER_H_
+#define CANN_HIXL_SRC_HIXL_COMMON_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "hixl/hixl_types.h"
+
+namespace hixl {
+// environment variable naming the chrome trace file, tracing is enabled at start and flushed at exit when set
+constexpr const char kTraceFileEnv[] = "HIXL_TRACE_FILE";
+
+// Collects begin/end spans into per-thread ring buffers and writes them as Chrome trace JSON,
+// which can be opened in chrome://tracing or Perfetto. Span names must be string literals.
+class TraceRecorder {
+ public:
+  static constexpr size_t kRingCapacity = 16384U;  // power of two, oldest spans are overwritten
+
+  static TraceRecorder &GetInstance();
+  ~TraceRecorder();
+  TraceRecorder(const TraceRecorder &) = delete;
+  TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+  void SetEnabled(bool enabled);
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+  void Record(const char *name, uint64_t request_id, uint64_t begin_ns, uint64_t end_ns);
+  // takes the recorded spans out of all ring buffers
+  std::string DumpToJson();
+  Status Flush(const std::string &file_path);
+  void Clear();
+  uint64_t NewRequestId();
+
+  static uint64_t NowNs();
+  static uint64_t GetCurrentRequestId();
+  static void SetCurrentRequestId(uint64_t request_id);
+
+ private:
+  struct TraceSlot {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<uint64_t> request_id{0UL};
+    std::atomic<uint64_t> begin_ns{0UL};
+    std::atomic<uint64_t> end_ns{0UL};
+  };
+
+  // written by the owner thread only, read by the flushing thread
+  struct ThreadBuffer {
+    uint64_t tid = 0UL;
+    std::string thread_name;
+    std::vector<TraceSlot> slots = std::vector<TraceSlot>(kRingCapacity);
+    std::atomic<uint64_t> claim_pos{0UL};
+    std::atomic<uint64_t> write_pos{0UL};
+    uint64_t read_pos = 0UL;  // guarded by dump_mutex_
+  };
+
+  struct TraceEvent {
+    const char *name;
+    uint64_t request_id;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+  };
+
+  TraceRecorder();
+  ThreadBuffer *GetLocalBuffer();
+  static void CollectEvents(ThreadBuffer &buffer, std::vector<TraceEvent> &events);
+
+  static std::atomic<bool> enabled_;
+  std::atomic<uint64_t> next_request_id_{1UL};
+  std::string trace_file_;
+  std::mutex dump_mutex_;
+  std::mutex buffers_mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+};
+
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char *name) : name_(name) {
+    if (TraceRecorder::IsEnabled()) {
+      request_id_ = TraceRecorder::GetCurrentRequestId();
+      begin_ns_ = TraceRecorder::NowNs();
+    }
+  }
+  TraceSpan(const char *name, uint64_t request_id) : name_(name), request_id_(request_id) {
+    if (TraceRecorder::IsEnabled()) {
+      begin_ns_ = TraceRecorder::NowNs();
+    }
+  }
+  ~TraceSpan() {
+    if (begin_ns_ != 0UL) {
+      TraceRecorder::GetInstance().Record(name_, request_id_, begin_ns_, TraceRecorder::NowNs());
+    }
+  }
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+ private:
+  const char *name_;
+  uint64_t request_id_ = 0UL;
+  uint64_t begin_ns_ = 0UL;  // 0 when tracing was disabled at the beginning of the span
+};
+
+// spans opened on this thread inside the scope carry request_id unless given their own
+class TraceRequestScope {
+ public:
+  explicit TraceRequestScope(uint64_t request_id) : last_request_id_(TraceRecorder::GetCurrentRequestId()) {
+    TraceRecorder::SetCurrentRequestId(request_id);
+  }
+  ~TraceRequestScope() {
+    TraceRecorder::SetCurrentRequestId(last_request_id_);
+  }
+  TraceRequestScope(const TraceRequestScope &) = delete;
+  TraceRequestScope &operator=(const TraceRequestScope &) = delete;
+
+ private:
+  uint64_t last_request_id_;
+};
+}  // namespace hixl
+
+#define HIXL_TRACE_CONCAT_IMPL(a, b) a##b
+#define HIXL_TRACE_CONCAT(a, b) HIXL_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef HIXL_TRACE_DISABLED
+#define HIXL_TRACE_SPAN(name)
+#define HIXL_TRACE_SPAN_WITH_ID(name, request_id)
+#define HIXL_TRACE_REQUEST(name, request_id)
+#else
+#define HIXL_TRACE_SPAN(name) const ::hixl::TraceSpan HIXL_TRACE_CONCAT(hixl_trace_span_, __LINE__)(name)
+#define HIXL_TRACE_SPAN_WITH_ID(name, request_id) \
+  const ::hixl::TraceSpan HIXL_TRACE_CONCAT(hixl_trace_span_, __LINE__)(name, (request_id))
+// request_id is only evaluated while tracing is enabled, so it may allocate a new id
+#define HIXL_TRACE_REQUEST(name, request_id)                                                               \
+  const ::hixl::TraceRequestScope HIXL_TRACE_CONCAT(hixl_trace_scope_, __LINE__)(                          \
+      ::hixl::TraceRecorder::IsEnabled() ? (request_id) : 0UL);                                            \
+  HIXL_TRACE_SPAN(name)
+#endif
+
+#endif  // CANN_HIXL_SRC_HIXL_COMMON_TRACE_RECORDER_H_
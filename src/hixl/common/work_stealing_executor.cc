@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "work_stealing_executor.h"
+#include <pthread.h>
+#include "common/hixl_log.h"
+
+namespace hixl {
+namespace {
+constexpr size_t kInitRingCapacity = 64U;
+// rounds of looking for work before an idle worker goes to sleep
+constexpr uint32_t kSpinRounds = 64U;
+
+struct CurrentWorker {
+  const void *executor;
+  uint32_t index;
+};
+thread_local CurrentWorker g_current_worker{nullptr, 0U};
+}  // namespace
+
+void WorkStealingExecutor::TaskRing::Push(ExecutorTask &&task) {
+  if (size_ == slots_.size()) {
+    std::vector<ExecutorTask> slots(slots_.empty() ? kInitRingCapacity : (slots_.size() << 1U));
+    for (size_t i = 0U; i < size_; ++i) {
+      slots[i] = std::move(slots_[(head_ + i) & (slots_.size() - 1U)]);
+    }
+    slots_.swap(slots);
+    head_ = 0U;
+  }
+  slots_[(head_ + size_) & (slots_.size() - 1U)] = std::move(task);
+  ++size_;
+}
+
+void WorkStealingExecutor::TaskRing::Pop(ExecutorTask &task) {
+  task = std::move(slots_[head_]);
+  head_ = (head_ + 1U) & (slots_.size() - 1U);
+  --size_;
+}
+
+WorkStealingExecutor::WorkStealingExecutor(std::string thread_name_prefix, uint32_t worker_num,
+                                           WorkerInitFunc init_func)
+    : thread_name_prefix_(std::move(thread_name_prefix)), init_func_(std::move(init_func)) {
+  worker_num = (worker_num < 1U) ? 1U : worker_num;
+  for (uint32_t i = 0U; i < worker_num; ++i) {
+    queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+  for (uint32_t i = 0U; i < worker_num; ++i) {
+    workers_.emplace_back(&WorkStealingExecutor::WorkerLoop, this, i);
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  Stop();
+}
+
+bool WorkStealingExecutor::Submit(ExecutorTask task, TaskPriority priority) {
+  if (!task) {
+    return false;
+  }
+  const bool on_worker = (g_current_worker.executor == this);
+  if (!on_worker) {
+    // pairs with Stop, either Stop sees this submit in progress or we see the stop
+    (void)submitting_.fetch_add(1U);
+    if (stopped_.load()) {
+      (void)submitting_.fetch_sub(1U);
+      return false;
+    }
+  }
+  const size_t level = static_cast<size_t>(priority);
+  const uint32_t index =
+      on_worker ? g_current_worker.index : (next_queue_.fetch_add(1U, std::memory_order_relaxed) % GetWorkerNum());
+  auto &queue = *queues_[index];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.rings[level].Push(std::move(task));
+    (void)queue.sizes[level].fetch_add(1U, std::memory_order_relaxed);
+  }
+  // pairs with Park, either the sleeper sees the task or we see the sleeper
+  (void)pending_.fetch_add(1L);
+  if (!on_worker) {
+    (void)submitting_.fetch_sub(1U);
+  }
+  if (sleepers_.load() > 0U) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cv_.notify_one();
+  }
+  return true;
+}
+
+void WorkStealingExecutor::Stop() {
+  if (stopped_.exchange(true)) {
+    return;
+  }
+  while (submitting_.load() > 0U) {
+    std::this_thread::yield();
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cv_.notify_all();
+  }
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      try {
+        worker.join();
+      } catch (...) {
+        HIXL_LOGW("thread join exception");
+      }
+    }
+  }
+}
+
+bool WorkStealingExecutor::PopFrom(uint32_t index, size_t priority, ExecutorTask &task) {
+  auto &queue = *queues_[index];
+  if (queue.sizes[priority].load(std::memory_order_relaxed) == 0U) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.rings[priority].Empty()) {
+    return false;
+  }
+  queue.rings[priority].Pop(task);
+  (void)queue.sizes[priority].fetch_sub(1U, std::memory_order_relaxed);
+  (void)pending_.fetch_sub(1L, std::memory_order_relaxed);
+  return true;
+}
+
+bool WorkStealingExecutor::TakeTask(uint32_t index, ExecutorTask &task) {
+  const uint32_t worker_num = GetWorkerNum();
+  for (size_t priority = 0U; priority < kPriorityNum; ++priority) {
+    if (PopFrom(index, priority, task)) {
+      return true;
+    }
+    for (uint32_t i = 1U; i < worker_num; ++i) {
+      if (PopFrom((index + i) % worker_num, priority, task)) {
+        (void)steal_count_.fetch_add(1UL, std::memory_order_relaxed);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void WorkStealingExecutor::Park() {
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  (void)sleepers_.fetch_add(1U);
+  sleep_cv_.wait(lock, [this]() { return (pending_.load() > 0L) || stopped_.load(); });
+  (void)sleepers_.fetch_sub(1U);
+}
+
+void WorkStealingExecutor::WorkerLoop(uint32_t index) {
+  if (!thread_name_prefix_.empty()) {
+    auto thread_name = thread_name_prefix_ + std::to_string(index);
+    int32_t set_ret = pthread_setname_np(pthread_self(), thread_name.c_str());
+    HIXL_LOGD("set thread name to [%s], ret=%d", thread_name.c_str(), set_ret);
+  }
+  if (init_func_ != nullptr) {
+    init_func_();
+  }
+  g_current_worker = CurrentWorker{this, index};
+  ExecutorTask task;
+  uint32_t idle_rounds = 0U;
+  while (true) {
+    if (TakeTask(index, task)) {
+      task();
+      task.Reset();
+      idle_rounds = 0U;
+      continue;
+    }
+    // tasks submitted by a running task go to the queue of its own worker, which takes them before leaving
+    if (stopped_.load() && (pending_.load() <= 0L)) {
+      break;
+    }
+    if (++idle_rounds < kSpinRounds) {
+      std::this_thread::yield();
+      continue;
+    }
+    idle_rounds = 0U;
+    Park();
+  }
+  g_current_worker = CurrentWorker{nullptr, 0U};
+}
+}  // namespace hixl
@@ -0,0 +1,294 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_HIXL_SRC_HIXL_COMMON_WORK_STEALING_EXECUTOR_H_
+#define CANN_HIXL_SRC_HIXL_COMMON_WORK_STEALING_EXECUTOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hixl {
+enum class TaskPriority : uint32_t {
+  kHigh = 0U,
+  kNormal = 1U,
+};
+
+// Move-only callable. Callables up to kInlineSize bytes are stored in place, so queuing one does not allocate.
+class ExecutorTask {
+ public:
+  static constexpr size_t kInlineSize = 48U;
+
+  ExecutorTask() = default;
+  template <typename Func, typename = typename std::enable_if<
+                               !std::is_same<typename std::decay<Func>::type, ExecutorTask>::value>::type>
+  ExecutorTask(Func &&func) {  // NOLINT(google-explicit-constructor)
+    using Callable = typename std::decay<Func>::type;
+    if constexpr ((sizeof(Callable) <= kInlineSize) && (alignof(Callable) <= alignof(std::max_align_t)) &&
+                  std::is_nothrow_move_constructible<Callable>::value) {
+      new (storage_) Callable(std::forward<Func>(func));
+      ops_ = &InlineOps<Callable>::kOps;
+    } else {
+      auto *callable = new (std::nothrow) Callable(std::forward<Func>(func));
+      if (callable != nullptr) {
+        new (storage_) Callable *(callable);
+        ops_ = &HeapOps<Callable>::kOps;
+      }
+    }
+  }
+  ExecutorTask(ExecutorTask &&other) noexcept {
+    MoveFrom(other);
+  }
+  ExecutorTask &operator=(ExecutorTask &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+  ExecutorTask(const ExecutorTask &) = delete;
+  ExecutorTask &operator=(const ExecutorTask &) = delete;
+  ~ExecutorTask() {
+    Reset();
+  }
+
+  void operator()() {
+    ops_->invoke(storage_);
+  }
+  explicit operator bool() const {
+    return ops_ != nullptr;
+  }
+  void Reset() {
+    if (ops_ != nullptr) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+ private:
+  struct Ops {
+    void (*invoke)(void *storage);
+    void (*relocate)(void *dst, void *src);
+    void (*destroy)(void *storage);
+  };
+
+  template <typename Callable>
+  struct InlineOps {
+    static void Invoke(void *storage) {
+      (*static_cast<Callable *>(storage))();
+    }
+    static void Relocate(void *dst, void *src) {
+      new (dst) Callable(std::move(*static_cast<Callable *>(src)));
+      static_cast<Callable *>(src)->~Callable();
+    }
+    static void Destroy(void *storage) {
+      static_cast<Callable *>(storage)->~Callable();
+    }
+    static constexpr Ops kOps{&Invoke, &Relocate, &Destroy};
+  };
+
+  template <typename Callable>
+  struct HeapOps {
+    static void Invoke(void *storage) {
+      (**static_cast<Callable **>(storage))();
+    }
+    static void Relocate(void *dst, void *src) {
+      new (dst) Callable *(*static_cast<Callable **>(src));
+    }
+    static void Destroy(void *storage) {
+      delete *static_cast<Callable **>(storage);
+    }
+    static constexpr Ops kOps{&Invoke, &Relocate, &Destroy};
+  };
+
+  void MoveFrom(ExecutorTask &other) {
+    if (other.ops_ != nullptr) {
+      other.ops_->relocate(storage_, other.storage_);
+      ops_ = other.ops_;
+      other.ops_ = nullptr;
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+  const Ops *ops_ = nullptr;
+};
+
+// Fixed set of workers, each owning one queue per priority. Tasks submitted by a worker go to its own queue,
+// tasks from other threads are spread round robin. A worker takes high priority tasks first, its own before stolen
+// ones, then normal priority tasks the same way, so a busy worker never holds up a queued latency critical task
+// while another worker is idle. Tasks of one queue are taken in submission order, tasks of different queues run in
+// no particular order; use SerialTaskQueue where order matters.
+class WorkStealingExecutor {
+ public:
+  using WorkerInitFunc = std::function<void()>;
+
+  // init_func runs once on every worker before it takes tasks, e.g. to bind a device context
+  explicit WorkStealingExecutor(std::string thread_name_prefix, uint32_t worker_num = 4U,
+                                WorkerInitFunc init_func = nullptr);
+  ~WorkStealingExecutor();
+  WorkStealingExecutor(const WorkStealingExecutor &) = delete;
+  WorkStealingExecutor &operator=(const WorkStealingExecutor &) = delete;
+
+  // returns false once the executor is stopped or the task could not be stored,
+  // only tasks running on a worker can still submit while Stop drains the queues
+  bool Submit(ExecutorTask task, TaskPriority priority = TaskPriority::kNormal);
+  // rejects new tasks, then waits until every queued task and the tasks they submit have run
+  void Stop();
+  bool IsStopped() const {
+    return stopped_.load();
+  }
+
+  uint32_t GetWorkerNum() const {
+    return static_cast<uint32_t>(queues_.size());
+  }
+  uint64_t GetStealCount() const {
+    return steal_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kPriorityNum = 2U;
+
+  // growable ring, storage is reused once it reached the working set size
+  class TaskRing {
+   public:
+    bool Empty() const {
+      return size_ == 0U;
+    }
+    void Push(ExecutorTask &&task);
+    void Pop(ExecutorTask &task);
+
+   private:
+    std::vector<ExecutorTask> slots_;
+    size_t head_ = 0U;
+    size_t size_ = 0U;
+  };
+
+  struct alignas(64) WorkerQueue {
+    std::mutex mutex;
+    TaskRing rings[kPriorityNum];
+    // lets other workers skip empty queues without taking the lock
+    std::atomic<size_t> sizes[kPriorityNum]{};
+  };
+
+  void WorkerLoop(uint32_t index);
+  bool TakeTask(uint32_t index, ExecutorTask &task);
+  bool PopFrom(uint32_t index, size_t priority, ExecutorTask &task);
+  void Park();
+
+  std::string thread_name_prefix_;
+  WorkerInitFunc init_func_;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<bool> stopped_{false};
+  // Submit calls from outside the workers in progress, Stop waits for them so no task is queued behind the drain
+  std::atomic<uint32_t> submitting_{0U};
+  std::atomic<uint32_t> next_queue_{0U};
+  std::atomic<uint64_t> steal_count_{0UL};
+
+  // queued tasks not taken yet, may drop below zero for a moment because it is counted after the push
+  std::atomic<int64_t> pending_{0L};
+  std::atomic<uint32_t> sleepers_{0U};
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+};
+
+// Runs handler on the items in push order, one item at a time, on whichever worker of the executor is free.
+// Several queues share the executor without one long stage starving the others of threads.
+template <typename Item>
+class SerialTaskQueue {
+ public:
+  using Handler = std::function<void(Item &)>;
+
+  SerialTaskQueue(WorkStealingExecutor &executor, TaskPriority priority, Handler handler)
+      : executor_(executor), priority_(priority), handler_(std::move(handler)) {}
+  SerialTaskQueue(const SerialTaskQueue &) = delete;
+  SerialTaskQueue &operator=(const SerialTaskQueue &) = delete;
+
+  // returns false once the executor is stopped, items pushed before are still handled by its drain
+  bool Push(Item item) {
+    if (executor_.IsStopped()) {
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      items_.emplace_back(std::move(item));
+      if (scheduled_) {
+        return true;
+      }
+      scheduled_ = true;
+    }
+    return Schedule();
+  }
+
+  size_t Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.size();
+  }
+
+ private:
+  // items handled by one drain before it yields the worker to other tasks
+  static constexpr size_t kDrainBatch = 16U;
+
+  bool Schedule() {
+    if (executor_.Submit([this]() { Drain(); }, priority_)) {
+      return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    items_.clear();
+    scheduled_ = false;
+    return false;
+  }
+
+  void Drain() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      while ((!items_.empty()) && (batch_.size() < kDrainBatch)) {
+        batch_.emplace_back(std::move(items_.front()));
+        items_.pop_front();
+      }
+    }
+    for (auto &item : batch_) {
+      handler_(item);
+    }
+    batch_.clear();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (items_.empty()) {
+        scheduled_ = false;
+        return;
+      }
+    }
+    (void)Schedule();
+  }
+
+  WorkStealingExecutor &executor_;
+  const TaskPriority priority_;
+  const Handler handler_;
+  mutable std::mutex mutex_;
+  std::deque<Item> items_;
+  // a drain is queued or running, only one at a time so items never run concurrently
+  bool scheduled_ = false;
+  // only touched by the running drain
+  std::vector<Item> batch_;
+};
+}  // namespace hixl
+
+#endif  // CANN_HIXL_SRC_HIXL_COMMON_WORK_STEALING_EXECUTOR_H_
@@ -10,14 +10,23 @@
 
 #include "endpoint.h"
 
+#include <cstdlib>
 #include "common/hixl_utils.h"
 #include "common/hixl_checker.h"
 #include "common/hixl_log.h"
+#include "loopback_transport.h"
 
 namespace hixl {
 
 Status Endpoint::Initialize() {
   std::lock_guard<std::mutex> lock(mutex_);
+  loopback_ = GetLoopbackConfig().enable;
+  if (loopback_) {
+    // 回环模式不创建hcomm endpoint, handle只用于标识
+    handle_ = this;
+    HIXL_LOGW("Endpoint initialized in loopback mode without hcomm, handle_:=%p", handle_);
+    return SUCCESS;
+  }
   HIXL_LOGI("[JZY] HcommEndpointCreate start");
   HIXL_LOGI("endpoint:=%d", endpoint_.protocol);
   HIXL_LOGI("[JZY] [endpoint.cc]endpoint_.loc.device.devPhyId=%u", endpoint_.loc.device.devPhyId);
@@ -31,6 +40,15 @@ Status Endpoint::Initialize() {
 Status Endpoint::Finalize() {
   std::lock_guard<std::mutex> lock(mutex_);
   Status ret = SUCCESS;
+  if (loopback_) {
+    for (auto &it : reg_mems_) {
+      std::free(it.second.export_desc);
+    }
+    reg_mems_.clear();
+    channels_.clear();
+    handle_ = nullptr;
+    return ret;
+  }
   for (const auto &it : channels_) {
     auto chn_ret = it.second->Destroy();
     if (chn_ret != SUCCESS) {
@@ -67,7 +85,13 @@ const EndpointDesc &Endpoint::GetEndpoint() const {
 
 Status Endpoint::RegisterMem(const char *mem_tag, const HcommMem &mem, MemHandle &mem_handle) {
   std::lock_guard<std::mutex> lock(mutex_);
-  HIXL_CHK_HCCL_RET(HcommMemReg(handle_, mem_tag, mem, &mem_handle));
+  if (loopback_) {
+    HIXL_CHK_BOOL_RET_STATUS(mem.type == HCCL_MEM_TYPE_HOST, PARAM_INVALID,
+                             "Loopback transport only supports host memory, addr:%p", mem.addr);
+    mem_handle = reinterpret_cast<MemHandle>(static_cast<uintptr_t>(++loopback_handle_id_));
+  } else {
+    HIXL_CHK_HCCL_RET(HcommMemReg(handle_, mem_tag, mem, &mem_handle));
+  }
   HixlMemDesc desc{};
   if (mem_tag != nullptr) {
     desc.tag = mem_tag;
@@ -84,7 +108,11 @@ Status Endpoint::DeregisterMem(MemHandle mem_handle) {
     HIXL_LOGW("mem handle:%p is not registered, please use the handle generated by register mem.", mem_handle);
     return SUCCESS; 
   }
-  HIXL_CHK_HCCL_RET(HcommMemUnreg(handle_, mem_handle));
+  if (loopback_) {
+    std::free(it->second.export_desc);
+  } else {
+    HIXL_CHK_HCCL_RET(HcommMemUnreg(handle_, mem_handle));
+  }
   reg_mems_.erase(it);
   return SUCCESS;
 }
@@ -94,7 +122,10 @@ Status Endpoint::ExportMem(std::vector<HixlMemDesc> &mem_descs) {
   for (auto &it : reg_mems_) {
     auto mem_handle = it.first;
     auto &mem = it.second;
-    if (mem.export_desc == nullptr) {
+    if ((mem.export_desc == nullptr) && loopback_) {
+      HIXL_CHK_STATUS_RET(BuildLoopbackMemDesc(mem.mem, mem.export_desc, mem.export_len),
+                          "Build loopback mem desc failed, mem handle:%p", mem_handle);
+    } else if (mem.export_desc == nullptr) {
       HIXL_CHK_HCCL_RET(HcommMemExport(handle_, mem_handle, &mem.export_desc, &mem.export_len));
     }
     mem_descs.emplace_back(mem);
@@ -105,6 +136,12 @@ Status Endpoint::ExportMem(std::vector<HixlMemDesc> &mem_descs) {
 Status Endpoint::CreateChannel(const EndpointDesc &remote_endpoint, ChannelHandle &channel_handle) {
   std::lock_guard<std::mutex> lock(mutex_);
   HIXL_CHK_BOOL_RET_STATUS(handle_ != nullptr, FAILED, "[channel] CreateChannel called before Initialize");
+  if (loopback_) {
+    // 数据面由LoopbackTransport承载, channel只保留句柄
+    channel_handle = ++loopback_handle_id_;
+    channels_[channel_handle] = nullptr;
+    return SUCCESS;
+  }
   CommEngine engine = CommEngine::COMM_ENGINE_RESERVED;
   if (endpoint_.loc.locType == EndpointLocType::ENDPOINT_LOC_TYPE_HOST) {
     engine = CommEngine::COMM_ENGINE_CPU;
@@ -135,6 +172,10 @@ Status Endpoint::GetChannelStatus(ChannelHandle channel_handle, int32_t *status_
   auto it = channels_.find(channel_handle);
   HIXL_CHK_BOOL_RET_STATUS(it != channels_.end(), PARAM_INVALID,
                            "GetChannelStatus failed, channel not found, handle=%lu", channel_handle);
+  if (loopback_) {
+    *status_out = 0;
+    return SUCCESS;
+  }
   return it->second->GetStatus(channel_handle, status_out);
 }
 
@@ -143,6 +184,10 @@ Status Endpoint::DestroyChannel(ChannelHandle channel_handle) {
   auto it = channels_.find(channel_handle);
   HIXL_CHK_BOOL_RET_STATUS(it != channels_.end(), PARAM_INVALID,
                            "DestroyChannel failed, channel not found, handle=%lu", channel_handle);
+  if (loopback_) {
+    channels_.erase(it);
+    return SUCCESS;
+  }
 
   Status ret = it->second->Destroy();
   HIXL_CHK_STATUS_RET(ret, "Channel::Destroy failed, handle=%lu", channel_handle);
@@ -156,11 +201,33 @@ Status Endpoint::MemImport(const void *mem_desc, uint32_t desc_len, HcommMem &ou
   std::lock_guard<std::mutex> lock(mutex_);
   HIXL_CHECK_NOTNULL(handle_);
   HIXL_CHECK_NOTNULL(mem_desc);
+  if (loopback_) {
+    return LoopbackMemImport(mem_desc, desc_len, out_buf);
+  }
 
   HIXL_CHK_HCCL_RET(HcommMemImport(handle_, mem_desc, desc_len, &out_buf));
   return SUCCESS;
 }
 
+Status Endpoint::LoopbackMemImport(const void *mem_desc, uint32_t desc_len, HcommMem &out_buf) {
+  LoopbackMemDesc desc{};
+  HIXL_CHK_STATUS_RET(ParseLoopbackMemDesc(mem_desc, desc_len, desc), "Parse loopback mem desc failed");
+  out_buf.type = static_cast<HcclMemType>(desc.type);
+  out_buf.addr = reinterpret_cast<void *>(static_cast<uintptr_t>(desc.addr));
+  out_buf.size = desc.size;
+  loopback_peer_pid_ = desc.pid;
+  return SUCCESS;
+}
+
+bool Endpoint::IsLoopback() const {
+  return loopback_;
+}
+
+int32_t Endpoint::GetLoopbackPeerPid() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return loopback_peer_pid_;
+}
+
 Status Endpoint::GetMemDesc(MemHandle mem_handle, HixlMemDesc &desc) {
   std::lock_guard<std::mutex> lock(mutex_);
   auto it = reg_mems_.find(mem_handle);
@@ -42,13 +42,21 @@ class Endpoint {
   Status DestroyChannel(ChannelHandle channel_handle);
   Status GetMemDesc(MemHandle mem_handle, HixlMemDesc &desc);
   Status MemImport(const void *mem_desc, uint32_t desc_len, HcommMem &out_buf);
+  bool IsLoopback() const;
+  // 回环模式下最近一次导入的内存所在进程
+  int32_t GetLoopbackPeerPid();
 
  private:
+  Status LoopbackMemImport(const void *mem_desc, uint32_t desc_len, HcommMem &out_buf);
+
   std::mutex mutex_;
   EndpointDesc endpoint_{};
   EndPointHandle handle_ = nullptr;
   std::map<MemHandle, HixlMemDesc> reg_mems_;
   std::map<ChannelHandle, ChannelPtr> channels_;
+  bool loopback_ = false;
+  uint64_t loopback_handle_id_ = 0UL;
+  int32_t loopback_peer_pid_ = -1;
 };
 
 using EndpointPtr = std::shared_ptr<Endpoint>;
@@ -12,6 +12,7 @@
 #include <chrono>
 #include <thread>
 #include <cstring>
+#include <cstdlib>
 #include <algorithm>
 #include <securec.h>
 #include "acl/acl.h"
@@ -20,6 +21,7 @@
 #include "common/hixl_log.h"
 #include "common/hixl_utils.h"
 #include "common/scope_guard.h"
+#include "common/trace_recorder.h"
 #include "common/ctrl_msg_plugin.h"
 #include "conn_msg_handler.h"
 #include "mem_msg_handler.h"
@@ -70,7 +72,13 @@ Status HixlCSClient::InitFlagQueue() noexcept {
     return SUCCESS;  // 已初始化
   }
   void *tmp = nullptr;
-  rtError_t ret = rtMallocHost(&tmp, kFlagQueueSize * sizeof(uint64_t), HCCL);
+  rtError_t ret = RT_ERROR_NONE;
+  if (loopback_ != nullptr) {
+    // 回环模式不依赖runtime, flag由后台线程写入
+    tmp = std::calloc(kFlagQueueSize, sizeof(uint64_t));
+  } else {
+    ret = rtMallocHost(&tmp, kFlagQueueSize * sizeof(uint64_t), HCCL);
+  }
   if (ret != RT_ERROR_NONE || tmp == nullptr) {
     HIXL_LOGE(RESOURCE_EXHAUSTED, "rtMallocHost failed, ret=%d", ret);
     return RESOURCE_EXHAUSTED;
@@ -84,7 +92,14 @@ Status HixlCSClient::InitFlagQueue() noexcept {
 }
 
 HixlCSClient::~HixlCSClient() {
-  if (flag_queue_ != nullptr) {
+  if (loopback_ != nullptr) {
+    // 先等后台线程结束, 避免写入已释放的flag
+    loopback_->Finalize();
+  }
+  if (flag_queue_ != nullptr && loopback_ != nullptr) {
+    std::free(flag_queue_);
+    flag_queue_ = nullptr;
+  } else if (flag_queue_ != nullptr) {
     rtError_t ret = rtFreeHost(flag_queue_);
     if (ret != RT_ERROR_NONE) {
       HIXL_LOGI("rtFreeHost failed, ret=%d", ret);
@@ -121,6 +136,11 @@ Status HixlCSClient::Create(const char *server_ip, uint32_t server_port, const E
                       "Check Config: [Loc:%d, Proto:%d, AddrVal:0x%x]",
                       src_endpoint->loc, src_endpoint->protocol, src_endpoint->commAddr.id);
   HIXL_LOGI("[HixlClient] src_endpoint initialized. ep_handle=%p", src_endpoint_->GetHandle());
+  if (src_endpoint_->IsLoopback() && loopback_ == nullptr) {
+    loopback_ = MakeUnique<LoopbackTransport>(GetLoopbackConfig());
+    HIXL_CHECK_NOTNULL(loopback_);
+    HIXL_CHK_STATUS_RET(loopback_->Initialize(), "[HixlClient] Failed to initialize loopback transport.");
+  }
   dst_endpoint_ = *dst_endpoint;
   CtrlMsgPlugin::Initialize();
   HIXL_LOGD("[HixlClient] CtrlMsgPlugin initialized");
@@ -135,7 +155,7 @@ Status HixlCSClient::Create(const char *server_ip, uint32_t server_port, const E
   const EndpointDesc &ep = src_endpoint_->GetEndpoint();
   const bool ub_device_mode =
       (ep.protocol == COMM_PROTOCOL_UBC_CTP || ep.protocol == COMM_PROTOCOL_UBC_TP) &&
-      (ep.loc.locType == ENDPOINT_LOC_TYPE_DEVICE);
+      (ep.loc.locType == ENDPOINT_LOC_TYPE_DEVICE) && (loopback_ == nullptr);
   is_device_ = (ep.loc.locType == ENDPOINT_LOC_TYPE_DEVICE);
   is_ub_mode_ = ub_device_mode;
   if (ub_device_mode) {
@@ -232,9 +252,8 @@ Status HixlCSClient::ReleaseCompleteHandle(CompleteHandle *queryhandle) {
   HIXL_CHECK_NOTNULL(queryhandle);
   std::lock_guard<std::mutex> lock(indices_mutex_);
   if (top_index_ < kFlagQueueSize) {
-    size_t idx = top_index_ + size_t{1};
-    top_index_ = idx;
-    available_indices_[idx] = queryhandle->flag_index; // 回收索引
+    available_indices_[top_index_] = queryhandle->flag_index; // 回收索引
+    top_index_ += size_t{1};
     live_handles_[queryhandle->flag_index] = nullptr;
   }
   delete queryhandle;
@@ -296,6 +315,55 @@ Status HixlCSClient::BatchTransferRoce(bool is_get, const CommunicateMem& commun
   return SUCCESS;
 }
 
+Status HixlCSClient::BatchTransferLoopback(bool is_get, const CommunicateMem &communicate_mem_param,
+                                           void **queryhandle) {
+  if (flag_queue_ == nullptr) {
+    HIXL_LOGE(RESOURCE_EXHAUSTED, "[HixlClient] Client not initialized: flag queue is null.");
+    return RESOURCE_EXHAUSTED;
+  }
+  EndpointDesc endpoint = src_endpoint_->GetEndpoint();
+  const char *trans_flag_name =
+      (endpoint.loc.locType == ENDPOINT_LOC_TYPE_HOST) ? kTransFlagNameHost : kTransFlagNameDevice;
+  const auto flag_it = tag_mem_descs_.find(trans_flag_name);
+  HIXL_CHK_BOOL_RET_STATUS(flag_it != tag_mem_descs_.end(), PARAM_INVALID,
+                           "[HixlClient] Remote trans flag not found, please get remote mem first. tag:%s",
+                           trans_flag_name);
+  // get时远端为源地址, put时远端为目的地址
+  std::vector<LoopbackOp> ops;
+  ops.reserve(communicate_mem_param.list_num);
+  for (uint32_t i = 0U; i < communicate_mem_param.list_num; i++) {
+    void *local = is_get ? communicate_mem_param.dst_buf_list[i]
+                         : const_cast<void *>(communicate_mem_param.src_buf_list[i]);
+    const void *remote = is_get ? communicate_mem_param.src_buf_list[i]
+                                : static_cast<const void *>(communicate_mem_param.dst_buf_list[i]);
+    ops.emplace_back(LoopbackOp{local, PtrToU64(remote), communicate_mem_param.len_list[i]});
+  }
+  CompleteHandle *query_mem_handle = new (std::nothrow) CompleteHandle();
+  if (query_mem_handle == nullptr) {
+    HIXL_LOGE(PARAM_INVALID, "[HixlClient] Memory allocation failed; unable to generate query handle.");
+    return PARAM_INVALID;
+  }
+  int32_t flag_index = AcquireFlagIndex();
+  if (flag_index == -1) {
+    delete query_mem_handle;
+    HIXL_LOGE(PARAM_INVALID, "[HixlClient] There are a large number of transfer tasks with no query results, making it impossible to create new transfer tasks.");
+    return PARAM_INVALID;
+  }
+  query_mem_handle->magic = kRoceCompleteMagic;
+  query_mem_handle->flag_index = flag_index;
+  query_mem_handle->flag_address = &flag_queue_[flag_index];
+  live_handles_[flag_index] = query_mem_handle;
+  Status ret = loopback_->Submit(is_get, std::move(ops), PtrToU64(flag_it->second.addr),
+                                 query_mem_handle->flag_address);
+  if (ret != SUCCESS) {
+    (void)ReleaseCompleteHandle(query_mem_handle);
+    HIXL_LOGE(ret, "[HixlClient] Submit loopback transfer failed. list_num:%u", communicate_mem_param.list_num);
+    return ret;
+  }
+  *queryhandle = query_mem_handle;
+  return SUCCESS;
+}
+
 Status HixlCSClient::EnsureUbRemoteFlagInitedLocked() {
   if (ub_remote_flag_inited_) {
     return SUCCESS;
@@ -537,6 +605,7 @@ Status HixlCSClient::SetAclContext(aclrtContext new_ctx) const {
 }
 
 Status HixlCSClient::LaunchUbAndStageD2H(bool is_get, UbCompleteHandle *handle, void *remote_flag) {
+  HIXL_TRACE_SPAN("HixlCSClient::LaunchUbAndStageD2H");
   HIXL_CHECK_NOTNULL(handle);
   HIXL_CHECK_NOTNULL(remote_flag);
   aclrtContext old_ctx = nullptr;
@@ -751,6 +820,10 @@ Status HixlCSClient::BatchTransfer(bool is_get, const CommunicateMem &communicat
   HIXL_CHECK_NOTNULL(src_endpoint_);
   const EndpointDesc ep = src_endpoint_->GetEndpoint();
 
+  if (loopback_ != nullptr) {
+    return BatchTransferLoopback(is_get, communicate_mem_param, queryhandle);
+  }
+
   if (ep.protocol == COMM_PROTOCOL_ROCE) {
     return BatchTransferRoce(is_get, communicate_mem_param, queryhandle);
   }
@@ -781,8 +854,13 @@ Status HixlCSClient::CheckStatusHost(CompleteHandle *queryhandle, int32_t *statu
   // 通过读取queryhandle中地址的值，来判断任务的完成状态
   uint64_t* atomic_flag = queryhandle->flag_address;
   HIXL_CHECK_NOTNULL(atomic_flag);
+  if ((loopback_ != nullptr) && loopback_->TakeFailure(atomic_flag)) {
+    HIXL_LOGE(FAILED, "The loopback transmission task failed, flag_index:%d", queryhandle->flag_index);
+    (void)ReleaseCompleteHandle(queryhandle);
+    return FAILED;
+  }
   // 查到flag变成1之后，就把其重置为0，之后告知用户读写任务已经完成。
-  if (*atomic_flag == kFlagDoneValue) {
+  if (__atomic_load_n(atomic_flag, __ATOMIC_ACQUIRE) == kFlagDoneValue) {
     *atomic_flag = kFlagResetValue;
     *status = BatchTransferStatus::COMPLETED;
     HIXL_LOGI("The current transmission task has been completed.");
@@ -946,15 +1024,16 @@ Status HixlCSClient::GetRemoteMem(HcommMem **remote_mem_list, char ***mem_tag_li
   *mem_tag_list = nullptr;
   std::lock_guard<std::mutex> lock(mutex_);
   HIXL_CHECK_NOTNULL(src_endpoint_);
-  Status ret = MemMsgHandler::SendGetRemoteMemRequest(socket_, dst_endpoint_handle_, timeout_ms);
-  HIXL_CHK_STATUS_RET(ret, "[HixlClient] SendGetRemoteMemRequest failed. fd=%d, remote_ep_handle=%" PRIu64, socket_,
-                      dst_endpoint_handle_);
   std::vector<HixlMemDesc> mem_descs;
-  ret = MemMsgHandler::RecvGetRemoteMemResponse(socket_, mem_descs, timeout_ms);
-  HIXL_CHK_STATUS_RET(ret, "[HixlClient] RecvGetRemoteMemResponse failed. fd=%d, timeout=%u ms", socket_, timeout_ms);
+  Status ret = MemMsgHandler::GetRemoteMem(socket_, dst_endpoint_handle_, mem_descs, timeout_ms);
+  HIXL_CHK_STATUS_RET(ret, "[HixlClient] Get remote mem descs failed. fd=%d, remote_ep_handle=%" PRIu64
+                      ", timeout=%u ms", socket_, dst_endpoint_handle_, timeout_ms);
   HIXL_LOGD("[HixlClient] Recv remote mem descs success. Count=%zu", mem_descs.size());
   ret = ImportRemoteMem(mem_descs, remote_mem_list, mem_tag_list, list_num);
   HIXL_CHK_STATUS_RET(ret, "[HixlClient] ImportRemoteMem failed. desc_count=%zu", mem_descs.size());
+  if (loopback_ != nullptr) {
+    loopback_->SetPeer(src_endpoint_->GetLoopbackPeerPid());
+  }
   HIXL_EVENT("[HixlClient] GetRemoteMem success. fd=%d, remote_ep_handle=%" PRIu64 ", imported=%u", socket_,
              dst_endpoint_handle_, *list_num);
   return SUCCESS;
@@ -1128,7 +1207,8 @@ Status HixlCSClient::ImportRemoteMem(std::vector<HixlMemDesc> &desc_list,
   ret = ImportAllDescs(ctx, desc_list);
   if (ret != SUCCESS) {
     HIXL_LOGW("[HixlClient] RollbackImport triggered. Cleaning up %zu imported bufs.", desc_list.size());
-    CloseImportedBufs(ctx.ep_handle, desc_list);
+    // 回环模式的导入没有hcomm资源
+    CloseImportedBufs((loopback_ != nullptr) ? nullptr : ctx.ep_handle, desc_list);
     return ret;
   }
   desc_list_ = desc_list;
@@ -1144,7 +1224,9 @@ Status HixlCSClient::ClearRemoteMemInfo() {
     HIXL_LOGI("[HixlClient] Cleaning up remote mem info. Bufs=%zu, Addrs=%zu", buf_cnt, addr_cnt);
   }
   if (!desc_list_.empty()) {
-    if (ep_handle != nullptr) {
+    if (loopback_ != nullptr) {
+      desc_list_.clear();
+    } else if (ep_handle != nullptr) {
       CloseImportedBufs(ep_handle, desc_list_);
     } else {
       HIXL_LOGW("[HixlClient] ClearRemoteMemInfo: endpoint handle null, skip MemClose for %zu bufs",
@@ -1174,6 +1256,10 @@ Status HixlCSClient::Destroy() {
 
   std::lock_guard<std::mutex> lock(mutex_);
   Status first_error = SUCCESS;
+  if (loopback_ != nullptr) {
+    // 执行完已提交的任务, 之后才能强制回收queryhandle
+    loopback_->Finalize();
+  }
 
   {
     std::lock_guard<std::mutex> lk(indices_mutex_);
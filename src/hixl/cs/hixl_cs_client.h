@@ -25,6 +25,7 @@
 #include "channel.h"
 #include "hixl_mem_store.h"
 #include "complete_pool.h"
+#include "loopback_transport.h"
 
 namespace hixl {
 namespace {
@@ -140,6 +141,7 @@ class HixlCSClient {
   Status CheckStatusDevice(UbCompleteHandle *queryhandle, int32_t *status);
   Status BatchTransferRoce(bool is_get, const CommunicateMem& p, void** queryhandle);
   Status BatchTransferUB(bool is_get, const CommunicateMem& p, void** queryhandle);
+  Status BatchTransferLoopback(bool is_get, const CommunicateMem& p, void** queryhandle);
   Status EnsureUbRemoteFlagInitedLocked();
   Status EnsureUbKernelLoadedLocked();
   void *UbGetKernelStubFunc(bool is_get);
@@ -212,6 +214,8 @@ class HixlCSClient {
   void *ub_stub_get_ {nullptr};
   void *ub_stub_put_ {nullptr};
   void *ub_dev_const_one_{nullptr};
+  // 回环模式下承载数据面, 为空时走hcomm
+  std::unique_ptr<LoopbackTransport> loopback_;
 
 };
 }  // namespace hixl
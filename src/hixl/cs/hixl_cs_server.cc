@@ -10,18 +10,12 @@
 
 #include "hixl_cs_server.h"
 #include <sys/epoll.h>
-#include "nlohmann/json.hpp"
+#include <securec.h>
 #include "common/hixl_checker.h"
 #include "common/ctrl_msg.h"
 #include "common/scope_guard.h"
 #include "common/ctrl_msg_plugin.h"
-
-static inline void to_json(nlohmann::json &j, const HcommMem &m) {
-  j = nlohmann::json{};
-  j["type"] = m.type;
-  j["addr"] = static_cast<uint64_t>(reinterpret_cast<intptr_t>(m.addr));
-  j["size"] = m.size;
-}
+#include "mem_msg_handler.h"
 
 namespace hixl {
 namespace {
@@ -254,64 +248,28 @@ Status HixlCSServer::DestroyChannel(int32_t fd, const char *msg, uint64_t msg_le
   return SUCCESS;
 }
 
-static inline void to_json(nlohmann::json &j, const HixlMemDesc &m) {
-  j = nlohmann::json{};
-  j["mem"] = m.mem;
-  j["tag"] = m.tag;
-  j["export_desc"] = nlohmann::json::array();
-  if (m.export_desc != nullptr && m.export_len > 0) {
-    const uint8_t* data_ptr = static_cast<const uint8_t*>(m.export_desc);
-    for (size_t i = 0; i < m.export_len; ++i) {
-      j["export_desc"].push_back(static_cast<int>(data_ptr[i]));
-    }
-  }
-}
-
-static inline void to_json(nlohmann::json &j, const GetRemoteMemResp &r) {
-  j = nlohmann::json{};
-  j["result"] = r.result;
-  j["mem_descs"] = r.mem_descs;
-}
-
-template <typename T>
-Status HixlCSServer::Serialize(const T &msg, std::string &msg_str) {
-  try {
-    nlohmann::json j = msg;
-    msg_str = j.dump();
-  } catch (const nlohmann::json::exception &e) {
-    HIXL_LOGE(PARAM_INVALID, "Failed to dump msg to str, exception:%s", e.what());
-    return PARAM_INVALID;
-  }
-  return SUCCESS;
-}
-
 Status HixlCSServer::SendRemoteMemResp(int32_t fd,
-                                       const GetRemoteMemResp &resp) {
-  CtrlMsgHeader header{};
-  header.magic = kMagicNumber;
-  std::string msg_str;
-  HIXL_CHK_STATUS_RET(Serialize(resp, msg_str), "Failed to serialize msg");
-  HIXL_LOGI("remote mem serialize success, str:%s", msg_str.c_str());
-  header.body_size = static_cast<uint64_t>(
-      sizeof(CtrlMsgType) + msg_str.size());
-  CtrlMsgType msg_type = CtrlMsgType::kGetRemoteMemResp;
-  HIXL_CHK_STATUS_RET(CtrlMsgPlugin::Send(fd, &header, static_cast<uint64_t>(sizeof(header))));
-  HIXL_CHK_STATUS_RET(CtrlMsgPlugin::Send(fd, &msg_type, static_cast<uint64_t>(sizeof(msg_type))));
-  HIXL_CHK_STATUS_RET(CtrlMsgPlugin::Send(fd, msg_str.c_str(), static_cast<uint64_t>(msg_str.size())));
+                                       const GetRemoteMemResp &resp, bool binary) {
+  HIXL_CHK_STATUS_RET(MemMsgHandler::SendGetRemoteMemResponse(fd, resp, binary), "Failed to send remote mem resp");
   return SUCCESS;
 }
 
 Status HixlCSServer::GetRemoteMem(int32_t fd, const char *msg, uint64_t msg_len) {
-  HIXL_DISMISSABLE_GUARD(failed, ([fd, this]() {
+  // 解析请求之前按旧版本client能解析的json格式回复
+  bool binary = false;
+  HIXL_DISMISSABLE_GUARD(failed, ([fd, this, &binary]() {
     GetRemoteMemResp resp{};
     resp.result = FAILED;
-    HIXL_CHK_STATUS(SendRemoteMemResp(fd, resp));
+    HIXL_CHK_STATUS(SendRemoteMemResp(fd, resp, binary));
   }));
   HIXL_CHECK_NOTNULL(msg);
-  HIXL_CHK_BOOL_RET_STATUS(msg_len == sizeof(GetRemoteMemReq), PARAM_INVALID, "invalid msg len:%lu of get remote mem",
-                           msg_len);
-  const auto req = reinterpret_cast<const GetRemoteMemReq *>(msg);
-  EndPointHandle handle = reinterpret_cast<EndPointHandle>(static_cast<intptr_t>(req->dst_ep_handle));
+  HIXL_CHK_BOOL_RET_STATUS((msg_len == sizeof(GetRemoteMemReq)) || (msg_len == kLegacyGetRemoteMemReqSize),
+                           PARAM_INVALID, "invalid msg len:%lu of get remote mem", msg_len);
+  GetRemoteMemReq req{};
+  HIXL_CHK_BOOL_RET_STATUS(memcpy_s(&req, sizeof(req), msg, static_cast<size_t>(msg_len)) == EOK, FAILED,
+                           "Failed to copy get remote mem req");
+  binary = ((req.flags & kGetRemoteMemFlagBinaryResp) != 0U);
+  EndPointHandle handle = reinterpret_cast<EndPointHandle>(static_cast<intptr_t>(req.dst_ep_handle));
   HIXL_CHECK_NOTNULL(handle);
   auto ep = endpoint_store_.GetEndpoint(handle);
   HIXL_CHECK_NOTNULL(ep);
@@ -319,7 +277,7 @@ Status HixlCSServer::GetRemoteMem(int32_t fd, const char *msg, uint64_t msg_len)
   HIXL_CHK_STATUS_RET(ep->ExportMem(resp.mem_descs), "Failed to export mem");
   resp.result = SUCCESS;
   HIXL_DISMISS_GUARD(failed);
-  HIXL_CHK_STATUS_RET(SendRemoteMemResp(fd, resp), "Failed to send remote mem resp.");
+  HIXL_CHK_STATUS_RET(SendRemoteMemResp(fd, resp, binary), "Failed to send remote mem resp.");
   return SUCCESS;
 }
 
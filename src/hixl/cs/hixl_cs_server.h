@@ -45,8 +45,6 @@ class HixlCSServer {
   Status RegProc(CtrlMsgType msg_type, MsgProcessor proc);
 
  private:
-  template <typename T>
-  static Status Serialize(const T &msg, std::string &msg_str);
   Status CreateChannel(int32_t fd, const char *msg, uint64_t msg_len);
   Status DestroyChannel(int32_t fd, const char *msg, uint64_t msg_len);
   Status GetRemoteMem(int32_t fd, const char *msg, uint64_t msg_len);
@@ -56,7 +54,7 @@ class HixlCSServer {
   static Status SendCreateChannelResp(int32_t fd,
                                       const CreateChannelResp &resp);
   Status SendRemoteMemResp(int32_t fd,
-                           const GetRemoteMemResp &resp);
+                           const GetRemoteMemResp &resp, bool binary);
 
   std::string ip_;
   uint32_t port_ = 0U;
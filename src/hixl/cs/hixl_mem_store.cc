@@ -11,6 +11,7 @@
 #include <cstdint>
 #include "hixl/hixl_types.h"
 #include "common/hixl_checker.h"
+#include "common/trace_recorder.h"
 #include "hixl_mem_store.h"
 namespace hixl {
 Status HixlMemStore::RecordMemory(bool is_server, const void *addr, size_t size) {
@@ -132,6 +133,7 @@ bool HixlMemStore::CheckRegionNull(bool is_server) {
 }
 
 Status HixlMemStore::ValidateMemoryAccess(const void *server_addr, size_t mem_size, const void *client_addr) {
+  HIXL_TRACE_SPAN("HixlMemStore::ValidateMemoryAccess");
   std::lock_guard<std::mutex> lock(mutex_);
   if (server_addr == nullptr || client_addr == nullptr || mem_size == size_t{0}) {
     return PARAM_INVALID;
@@ -0,0 +1,252 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "loopback_transport.h"
+#include <sys/prctl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <securec.h>
+#include "common/hixl_checker.h"
+#include "common/hixl_log.h"
+#include "common/hixl_utils.h"
+
+namespace hixl {
+namespace {
+constexpr uint32_t kLoopbackMemMagic = 0x4C4F4F50U;
+constexpr uint64_t kBytesPerMb = 1024UL * 1024UL;
+constexpr double kNsPerSecond = 1000000000.0;
+constexpr const char *kEnvLoopback = "HIXL_CS_LOOPBACK";
+constexpr const char *kEnvLoopbackLatency = "HIXL_CS_LOOPBACK_LATENCY_US";
+constexpr const char *kEnvLoopbackBandwidth = "HIXL_CS_LOOPBACK_BANDWIDTH_MBPS";
+
+std::mutex g_config_mutex;
+bool g_config_loaded = false;
+LoopbackConfig g_config;
+
+Status LoadUint64FromEnv(const char *name, uint64_t &value) {
+  const char *env = std::getenv(name);
+  if (env != nullptr) {
+    HIXL_CHK_STATUS_RET(ToNumber(std::string(env), value), "Invalid %s:[%s]", name, env);
+  }
+  return SUCCESS;
+}
+}  // namespace
+
+Status LoadLoopbackConfigFromEnv(LoopbackConfig &config) {
+  const char *enable = std::getenv(kEnvLoopback);
+#ifdef HIXL_CS_LOOPBACK_ENABLED
+  config.enable = (enable != nullptr) && (std::string(enable) == "1");
+  HIXL_CHK_STATUS_RET(LoadUint64FromEnv(kEnvLoopbackLatency, config.latency_us));
+  HIXL_CHK_STATUS_RET(LoadUint64FromEnv(kEnvLoopbackBandwidth, config.bandwidth_mbps));
+  HIXL_LOGI("Loopback transport enable:%d, latency:%lu us, bandwidth:%lu MB/s", static_cast<int32_t>(config.enable),
+            config.latency_us, config.bandwidth_mbps);
+#else
+  // 回环模式跳过hcomm, 正式版本不允许通过环境变量打开
+  config = LoopbackConfig{};
+  if (enable != nullptr) {
+    HIXL_LOGW("%s is ignored, loopback transport is only available when built with ENABLE_CS_LOOPBACK", kEnvLoopback);
+  }
+#endif
+  return SUCCESS;
+}
+
+LoopbackConfig GetLoopbackConfig() {
+  std::lock_guard<std::mutex> lock(g_config_mutex);
+  if (!g_config_loaded) {
+    LoopbackConfig config{};
+    if (LoadLoopbackConfigFromEnv(config) == SUCCESS) {
+      g_config = config;
+    }
+    g_config_loaded = true;
+  }
+  return g_config;
+}
+
+void SetLoopbackConfig(const LoopbackConfig &config) {
+  std::lock_guard<std::mutex> lock(g_config_mutex);
+  g_config = config;
+  g_config_loaded = true;
+}
+
+Status BuildLoopbackMemDesc(const HcommMem &mem, void *&desc, uint32_t &desc_len) {
+  HIXL_CHK_BOOL_RET_STATUS(mem.type == HCCL_MEM_TYPE_HOST, PARAM_INVALID,
+                           "Loopback transport only supports host memory, addr:%p, type:%d", mem.addr,
+                           static_cast<int32_t>(mem.type));
+  auto *mem_desc = static_cast<LoopbackMemDesc *>(std::malloc(sizeof(LoopbackMemDesc)));
+  HIXL_CHECK_NOTNULL(mem_desc);
+  mem_desc->magic = kLoopbackMemMagic;
+  mem_desc->pid = static_cast<int32_t>(getpid());
+  mem_desc->type = static_cast<uint32_t>(mem.type);
+  mem_desc->reserved = 0U;
+  mem_desc->addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(mem.addr));
+  mem_desc->size = mem.size;
+  desc = mem_desc;
+  desc_len = static_cast<uint32_t>(sizeof(LoopbackMemDesc));
+  return SUCCESS;
+}
+
+Status ParseLoopbackMemDesc(const void *desc, uint32_t desc_len, LoopbackMemDesc &mem_desc) {
+  HIXL_CHECK_NOTNULL(desc);
+  HIXL_CHK_BOOL_RET_STATUS(desc_len == sizeof(LoopbackMemDesc), PARAM_INVALID,
+                           "Invalid loopback mem desc len:%u, expect:%zu, the server may not use loopback transport",
+                           desc_len, sizeof(LoopbackMemDesc));
+  auto ret = memcpy_s(&mem_desc, sizeof(mem_desc), desc, sizeof(LoopbackMemDesc));
+  HIXL_CHK_BOOL_RET_STATUS(ret == EOK, FAILED, "Call api:memcpy_s failed, ret:%d", static_cast<int32_t>(ret));
+  HIXL_CHK_BOOL_RET_STATUS(mem_desc.magic == kLoopbackMemMagic, PARAM_INVALID, "Invalid loopback mem desc magic:%u",
+                           mem_desc.magic);
+  return SUCCESS;
+}
+
+Status AllowLoopbackPeerAccess(int32_t peer_pid) {
+  HIXL_CHK_BOOL_RET_STATUS(peer_pid > 0, PARAM_INVALID, "Invalid loopback peer pid:%d", peer_pid);
+  if (prctl(PR_SET_PTRACER, static_cast<unsigned long>(peer_pid), 0, 0, 0) != 0) {
+    // 未启用yama时不需要
+    HIXL_LOGI("prctl PR_SET_PTRACER not applied, peer pid:%d, errno:%d", peer_pid, errno);
+  }
+  return SUCCESS;
+}
+
+LoopbackTransport::~LoopbackTransport() {
+  Finalize();
+}
+
+Status LoopbackTransport::Initialize() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_) {
+    return SUCCESS;
+  }
+  running_ = true;
+  link_free_time_ = std::chrono::steady_clock::now();
+  worker_ = std::thread([this]() { WorkLoop(); });
+  HIXL_LOGI("Loopback transport initialized, latency:%lu us, bandwidth:%lu MB/s", config_.latency_us,
+            config_.bandwidth_mbps);
+  return SUCCESS;
+}
+
+void LoopbackTransport::Finalize() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+void LoopbackTransport::SetPeer(int32_t pid) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  peer_pid_ = pid;
+}
+
+Status LoopbackTransport::Submit(bool is_get, std::vector<LoopbackOp> ops, uint64_t remote_flag,
+                                 uint64_t *local_flag) {
+  HIXL_CHECK_NOTNULL(local_flag);
+  Batch batch;
+  batch.is_get = is_get;
+  batch.remote_flag = remote_flag;
+  batch.local_flag = local_flag;
+  batch.submit_time = std::chrono::steady_clock::now();
+  for (const auto &op : ops) {
+    batch.bytes += op.len;
+  }
+  batch.ops = std::move(ops);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HIXL_CHK_BOOL_RET_STATUS(running_, FAILED, "Loopback transport is not running");
+    HIXL_CHK_BOOL_RET_STATUS(peer_pid_ > 0, FAILED, "Loopback transport has no peer, please get remote mem first");
+    batch.pid = peer_pid_;
+    batches_.emplace_back(std::move(batch));
+  }
+  cv_.notify_one();
+  return SUCCESS;
+}
+
+bool LoopbackTransport::TakeFailure(const uint64_t *local_flag) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return failed_flags_.erase(local_flag) > 0U;
+}
+
+void LoopbackTransport::WorkLoop() {
+  while (true) {
+    Batch batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return (!running_) || (!batches_.empty()); });
+      // 退出前执行完已提交的batch, 调用方之后可以直接释放内存
+      if (batches_.empty()) {
+        return;
+      }
+      batch = std::move(batches_.front());
+      batches_.pop_front();
+    }
+    if (Execute(batch) != SUCCESS) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      (void)failed_flags_.insert(batch.local_flag);
+    }
+  }
+}
+
+Status LoopbackTransport::Execute(const Batch &batch) {
+  std::this_thread::sleep_until(batch.submit_time + std::chrono::microseconds(config_.latency_us));
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto &op : batch.ops) {
+    HIXL_CHK_STATUS_RET(Copy(batch.is_get, batch.pid, op.local, op.remote, op.len),
+                        "Loopback transfer failed, peer pid:%d, local:%p, remote:0x%lx, len:%lu", batch.pid, op.local,
+                        op.remote, op.len);
+  }
+  if (config_.bandwidth_mbps > 0UL) {
+    // 链路按带宽串行占用, 拷贝比模拟带宽更快时等待到链路空闲
+    const auto transfer_ns = static_cast<uint64_t>(static_cast<double>(batch.bytes) * kNsPerSecond /
+                                                   static_cast<double>(config_.bandwidth_mbps * kBytesPerMb));
+    link_free_time_ = std::max(link_free_time_, start) + std::chrono::nanoseconds(transfer_ns);
+    std::this_thread::sleep_until(link_free_time_);
+  }
+  uint64_t flag = 0UL;
+  HIXL_CHK_STATUS_RET(Copy(true, batch.pid, &flag, batch.remote_flag, sizeof(flag)),
+                      "Loopback read complete flag failed, peer pid:%d, remote:0x%lx", batch.pid, batch.remote_flag);
+  // 与CheckStatus中的acquire读配对, 保证调用方看到完成标志时数据已写完
+  __atomic_store_n(batch.local_flag, flag, __ATOMIC_RELEASE);
+  return SUCCESS;
+}
+
+Status LoopbackTransport::Copy(bool is_get, int32_t pid, void *local, uint64_t remote, uint64_t len) {
+  if (len == 0UL) {
+    return SUCCESS;
+  }
+  if (pid == static_cast<int32_t>(getpid())) {
+    void *remote_ptr = reinterpret_cast<void *>(static_cast<uintptr_t>(remote));
+    void *dst = is_get ? local : remote_ptr;
+    const void *src = is_get ? remote_ptr : local;
+    auto ret = memcpy_s(dst, len, src, len);
+    HIXL_CHK_BOOL_RET_STATUS(ret == EOK, FAILED, "Call api:memcpy_s failed, ret:%d", static_cast<int32_t>(ret));
+    return SUCCESS;
+  }
+  uint64_t done = 0UL;
+  while (done < len) {
+    struct iovec local_iov {static_cast<uint8_t *>(local) + done, len - done};
+    struct iovec remote_iov {reinterpret_cast<void *>(static_cast<uintptr_t>(remote + done)), len - done};
+    const ssize_t n = is_get ? process_vm_readv(pid, &local_iov, 1UL, &remote_iov, 1UL, 0UL)
+                             : process_vm_writev(pid, &local_iov, 1UL, &remote_iov, 1UL, 0UL);
+    if ((n < 0) && (errno == EINTR)) {
+      continue;
+    }
+    HIXL_CHK_BOOL_RET_STATUS(n > 0, FAILED, "process_vm_%s failed, pid:%d, len:%lu, errno:%s",
+                             is_get ? "readv" : "writev", pid, len - done, strerror(errno));
+    done += static_cast<uint64_t>(n);
+  }
+  return SUCCESS;
+}
+}  // namespace hixl
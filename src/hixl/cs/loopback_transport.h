@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_HIXL_SRC_HIXL_CS_LOOPBACK_TRANSPORT_H_
+#define CANN_HIXL_SRC_HIXL_CS_LOOPBACK_TRANSPORT_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include "common/hixl_cs.h"
+#include "hixl/hixl_types.h"
+
+namespace hixl {
+/**
+ * HixlCS的host内存回环传输, 用于在没有昇腾硬件的环境中测量host侧开销。
+ * 使能后Endpoint不再调用hcomm接口: 注册的内存以[pid, addr, size]导出, client在后台线程中按提交顺序执行
+ * 批量读写, 同进程直接memcpy, 跨进程通过process_vm_readv/process_vm_writev访问server内存,
+ * 最后读取server的完成标志, 因此QueryCompleteStatus的流程与硬件路径一致。
+ * 只支持host内存, 跨进程时两端需为同一用户。
+ * 仅用于测试和基准测试: 测试通过SetLoopbackConfig使能; 编译时打开ENABLE_CS_LOOPBACK后, 也可通过环境变量使能。
+ */
+struct LoopbackConfig {
+  bool enable = false;
+  uint64_t latency_us = 0UL;      // 模拟的链路时延, 每个batch生效一次
+  uint64_t bandwidth_mbps = 0UL;  // 模拟的链路带宽(MB/s), 0表示不限速
+};
+
+// HIXL_CS_LOOPBACK=1使能, HIXL_CS_LOOPBACK_LATENCY_US和HIXL_CS_LOOPBACK_BANDWIDTH_MBPS设置链路参数,
+// 未打开ENABLE_CS_LOOPBACK编译时忽略环境变量
+Status LoadLoopbackConfigFromEnv(LoopbackConfig &config);
+// 首次调用时从环境变量加载
+LoopbackConfig GetLoopbackConfig();
+void SetLoopbackConfig(const LoopbackConfig &config);
+
+// 回环模式下export_desc的内容
+struct LoopbackMemDesc {
+  uint32_t magic;
+  int32_t pid;
+  uint32_t type;
+  uint32_t reserved;
+  uint64_t addr;
+  uint64_t size;
+};
+
+// desc由malloc申请, 由调用方释放
+Status BuildLoopbackMemDesc(const HcommMem &mem, void *&desc, uint32_t &desc_len);
+Status ParseLoopbackMemDesc(const void *desc, uint32_t desc_len, LoopbackMemDesc &mem_desc);
+// 仅供测试使用: 允许peer_pid进程读写本进程内存, yama ptrace_scope为1时跨进程访问需要
+Status AllowLoopbackPeerAccess(int32_t peer_pid);
+
+struct LoopbackOp {
+  void *local;
+  uint64_t remote;
+  uint64_t len;
+};
+
+class LoopbackTransport {
+ public:
+  explicit LoopbackTransport(const LoopbackConfig &config) : config_(config) {}
+  ~LoopbackTransport();
+  LoopbackTransport(const LoopbackTransport &) = delete;
+  LoopbackTransport &operator=(const LoopbackTransport &) = delete;
+
+  Status Initialize();
+  // 等待已提交的batch执行完后退出后台线程
+  void Finalize();
+  void SetPeer(int32_t pid);
+  // 后台线程依次执行ops, 再把remote_flag的值写入local_flag; 失败时local_flag不变, 通过TakeFailure查询
+  Status Submit(bool is_get, std::vector<LoopbackOp> ops, uint64_t remote_flag, uint64_t *local_flag);
+  bool TakeFailure(const uint64_t *local_flag);
+
+ private:
+  struct Batch {
+    bool is_get = false;
+    int32_t pid = -1;
+    std::vector<LoopbackOp> ops;
+    uint64_t remote_flag = 0UL;
+    uint64_t *local_flag = nullptr;
+    uint64_t bytes = 0UL;
+    std::chrono::steady_clock::time_point submit_time;
+  };
+
+  void WorkLoop();
+  Status Execute(const Batch &batch);
+  static Status Copy(bool is_get, int32_t pid, void *local, uint64_t remote, uint64_t len);
+
+  LoopbackConfig config_;
+  int32_t peer_pid_ = -1;
+  std::chrono::steady_clock::time_point link_free_time_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Batch> batches_;
+  std::set<const uint64_t *> failed_flags_;
+  bool running_ = false;
+  std::thread worker_;
+};
+}  // namespace hixl
+
+#endif  // CANN_HIXL_SRC_HIXL_CS_LOOPBACK_TRANSPORT_H_
@@ -15,32 +15,87 @@
 #include <algorithm>
 #include "nlohmann/json.hpp"
 #include "common/ctrl_msg_plugin.h"
+#include "common/scope_guard.h"
 
 #include <securec.h>
 
 namespace {
-constexpr uint64_t kMaxGetRemoteMemBodySize = static_cast<uint64_t>(4ULL * 1024ULL * 1024ULL);  // 4MB 示例上限
-constexpr uint32_t kMaxGetRemoteMemNum = 4096U;                                                 // 最多 4096 段远端内存
+constexpr uint64_t kMaxGetRemoteMemBodySize = static_cast<uint64_t>(16ULL * 1024ULL * 1024ULL);  // 16MB 上限
+constexpr uint32_t kMaxGetRemoteMemNum = 16384U;                                                // 最多 16384 段远端内存
+constexpr size_t kMaxRetainedBodySize = 1024U * 1024U;  // 复用的接收缓冲区最多保留 1MB
+
+// 顺序写入预先分配好的消息缓冲区
+class BufferWriter {
+ public:
+  BufferWriter(uint8_t *data, size_t size) : pos_(data), end_(data + size) {}
+  hixl::Status Write(const void *src, size_t len) {
+    if (len == 0U) {
+      return hixl::SUCCESS;
+    }
+    const size_t left = static_cast<size_t>(end_ - pos_);
+    errno_t rc = memcpy_s(pos_, left, src, len);
+    HIXL_CHK_BOOL_RET_STATUS(rc == EOK, hixl::FAILED, "memcpy_s failed, rc=%d, left=%zu, len=%zu",
+                             static_cast<int32_t>(rc), left, len);
+    pos_ += len;
+    return hixl::SUCCESS;
+  }
+
+ private:
+  uint8_t *pos_;
+  uint8_t *end_;
+};
+
+// 在接收缓冲区上原地解析, 不做额外拷贝
+class BufferReader {
+ public:
+  BufferReader(const uint8_t *data, size_t size) : pos_(data), end_(data + size) {}
+  hixl::Status Read(void *dst, size_t len) {
+    const uint8_t *src = nullptr;
+    HIXL_CHK_STATUS_RET(Consume(len, src));
+    errno_t rc = memcpy_s(dst, len, src, len);
+    HIXL_CHK_BOOL_RET_STATUS(rc == EOK, hixl::FAILED, "memcpy_s failed, rc=%d, len=%zu", static_cast<int32_t>(rc),
+                             len);
+    return hixl::SUCCESS;
+  }
+  hixl::Status Consume(size_t len, const uint8_t *&ptr) {
+    HIXL_CHK_BOOL_RET_STATUS(len <= Left(), hixl::PARAM_INVALID,
+                             "[HixlClient] GetRemoteMemResp truncated, need:%zu, left:%zu", len, Left());
+    ptr = pos_;
+    pos_ += len;
+    return hixl::SUCCESS;
+  }
+  size_t Left() const {
+    return static_cast<size_t>(end_ - pos_);
+  }
+
+ private:
+  const uint8_t *pos_;
+  const uint8_t *end_;
+};
 }  // namespace
 
 namespace hixl {
 
-Status MemMsgHandler::SendGetRemoteMemRequest(int32_t socket, uint64_t endpoint_handle, uint32_t timeout_ms) {
-  HIXL_EVENT("[HixlClient] SendGetRemoteMemRequest start. socket: %d, endpoint_handle: %lu",
-             socket, endpoint_handle);
+Status MemMsgHandler::SendGetRemoteMemRequest(int32_t socket, uint64_t endpoint_handle, uint32_t timeout_ms,
+                                              bool binary_resp) {
+  HIXL_EVENT("[HixlClient] SendGetRemoteMemRequest start. socket: %d, endpoint_handle: %lu, binary_resp: %d",
+             socket, endpoint_handle, static_cast<int32_t>(binary_resp));
   (void)timeout_ms;
+  // 旧版本server只接受kLegacyGetRemoteMemReqSize长度的请求
+  const uint64_t req_size = binary_resp ? sizeof(GetRemoteMemReq) : kLegacyGetRemoteMemReqSize;
   CtrlMsgHeader header{};
   header.magic = kMagicNumber;
-  header.body_size = static_cast<uint64_t>(sizeof(CtrlMsgType) + sizeof(GetRemoteMemReq));
+  header.body_size = static_cast<uint64_t>(sizeof(CtrlMsgType)) + req_size;
 
   CtrlMsgType msg_type = CtrlMsgType::kGetRemoteMemReq;
 
   GetRemoteMemReq body{};
   body.dst_ep_handle = endpoint_handle;
+  body.flags = binary_resp ? kGetRemoteMemFlagBinaryResp : 0U;
 
   HIXL_CHK_STATUS_RET(CtrlMsgPlugin::Send(socket, &header, static_cast<uint64_t>(sizeof(header))));
   HIXL_CHK_STATUS_RET(CtrlMsgPlugin::Send(socket, &msg_type, static_cast<uint64_t>(sizeof(msg_type))));
-  HIXL_CHK_STATUS_RET(CtrlMsgPlugin::Send(socket, &body, static_cast<uint64_t>(sizeof(body))));
+  HIXL_CHK_STATUS_RET(CtrlMsgPlugin::Send(socket, &body, req_size));
   HIXL_EVENT("[HixlClient] SendGetRemoteMemRequest success. fd=%d", socket);
   return SUCCESS;
 }
@@ -78,13 +133,13 @@ Status RecvBody(int32_t socket, uint64_t body_size, std::vector<uint8_t> &body,
   HIXL_LOGI("[HixlClient] RecvBody start. body_size: %lu", body_size);
   body.resize(static_cast<size_t>(body_size));
   HIXL_EVENT("[HixlClient] RecvGetRemoteMemResp body begin. fd=%d, body_size=%" PRIu64, socket, body_size);
-  HIXL_CHK_STATUS_RET(CtrlMsgPlugin::Recv(socket, body.data(), static_cast<uint32_t>(body_size), timeout_ms));
+  HIXL_CHK_STATUS_RET(CtrlMsgPlugin::Recv(socket, body.data(), static_cast<size_t>(body_size), timeout_ms));
   HIXL_EVENT("[HixlClient] RecvGetRemoteMemResp body ok. fd=%d, body_size=%" PRIu64, socket, body_size);
   return SUCCESS;
 }
 
-Status ExtractTypeAndJsonPtr(const std::vector<uint8_t> &body, CtrlMsgType &msg_type, const char *&json_ptr,
-                             size_t &json_len) {
+Status ExtractTypeAndPayload(const std::vector<uint8_t> &body, CtrlMsgType &msg_type, const uint8_t *&payload,
+                             size_t &payload_len) {
   const uint64_t body_size = static_cast<uint64_t>(body.size());
   const void *src = static_cast<const void *>(body.data());
 
@@ -96,10 +151,10 @@ Status ExtractTypeAndJsonPtr(const std::vector<uint8_t> &body, CtrlMsgType &msg_
                            "[HixlClient] Unexpected msg_type=%d, expect=%d", static_cast<int32_t>(msg_type),
                            static_cast<int32_t>(CtrlMsgType::kGetRemoteMemResp));
 
-  json_len = static_cast<size_t>(body_size - sizeof(CtrlMsgType));
-  json_ptr = reinterpret_cast<const char *>(body.data() + sizeof(CtrlMsgType));
+  payload_len = static_cast<size_t>(body_size - sizeof(CtrlMsgType));
+  payload = body.data() + sizeof(CtrlMsgType);
 
-  HIXL_LOGD("[HixlClient] Extracted JSON length: %zu", json_len);
+  HIXL_LOGD("[HixlClient] Extracted payload length: %zu", payload_len);
   return SUCCESS;
 }
 
@@ -252,18 +307,192 @@ Status ParseGetRemoteMemJson(const char* json_ptr, size_t json_len, std::vector<
   return ParseMemDescsArray(*arr, mem_descs);
 }
 
-Status MemMsgHandler::RecvGetRemoteMemResponse(int32_t socket, std::vector<HixlMemDesc> &mem_descs,
-                                               uint32_t timeout_ms) {
+Status ParseOneBinaryMemDesc(BufferReader &reader, uint32_t idx, hixl::HixlMemDesc &desc) {
+  MemDescEntryHead entry{};
+  HIXL_CHK_STATUS_RET(reader.Read(&entry, sizeof(entry)), "[HixlClient] Failed to read mem_descs[%u]", idx);
+  const uint8_t *tag = nullptr;
+  const uint8_t *export_desc = nullptr;
+  HIXL_CHK_STATUS_RET(reader.Consume(entry.tag_len, tag), "[HixlClient] Failed to read tag of mem_descs[%u]", idx);
+  HIXL_CHK_STATUS_RET(reader.Consume(entry.export_len, export_desc),
+                      "[HixlClient] Failed to read export_desc of mem_descs[%u]", idx);
+  desc.mem.type = static_cast<HcclMemType>(entry.type);
+  desc.mem.addr = reinterpret_cast<void *>(static_cast<uintptr_t>(entry.addr));
+  desc.mem.size = entry.size;
+  desc.tag.assign(reinterpret_cast<const char *>(tag), entry.tag_len);
+  desc.export_desc = nullptr;
+  desc.export_len = 0U;
+  if (entry.export_len == 0U) {
+    return SUCCESS;
+  }
+  // export_desc的所有权交给调用方, 与json格式一致用malloc申请
+  void *buf = std::malloc(entry.export_len);
+  HIXL_CHK_BOOL_RET_STATUS(buf != nullptr, FAILED, "[HixlClient] malloc export_desc buffer failed, len=%u",
+                           entry.export_len);
+  errno_t rc = memcpy_s(buf, entry.export_len, export_desc, entry.export_len);
+  if (rc != EOK) {
+    std::free(buf);
+    HIXL_LOGE(FAILED, "[HixlClient] memcpy_s export_desc failed, rc=%d", static_cast<int32_t>(rc));
+    return FAILED;
+  }
+  desc.export_desc = buf;
+  desc.export_len = entry.export_len;
+  return SUCCESS;
+}
+
+Status ParseGetRemoteMemBinary(const uint8_t *payload, size_t payload_len, std::vector<hixl::HixlMemDesc> &mem_descs) {
+  BufferReader reader(payload, payload_len);
+  MemDescListHead head{};
+  HIXL_CHK_STATUS_RET(reader.Read(&head, sizeof(head)), "[HixlClient] Failed to read GetRemoteMemResp head");
+  const Status result = static_cast<Status>(head.result);
+  if (result != SUCCESS) {
+    HIXL_LOGE(result, "[HixlClient] GetRemoteMemResp result not SUCCESS, result=%u", head.result);
+    return result;
+  }
+  HIXL_CHK_BOOL_RET_STATUS(head.desc_num <= kMaxGetRemoteMemNum, PARAM_INVALID,
+                           "[HixlClient] mem_num too large in GetRemoteMemResp, mem_num=%u, max=%u", head.desc_num,
+                           kMaxGetRemoteMemNum);
+  HIXL_CHK_BOOL_RET_STATUS(static_cast<uint64_t>(head.desc_num) * sizeof(MemDescEntryHead) <= reader.Left(),
+                           PARAM_INVALID, "[HixlClient] GetRemoteMemResp truncated, mem_num=%u, left=%zu",
+                           head.desc_num, reader.Left());
+  mem_descs.clear();
+  mem_descs.reserve(head.desc_num);
+  HIXL_DISMISSABLE_GUARD(free_descs, ([&mem_descs]() { FreeExportDesc(mem_descs); }));
+  for (uint32_t i = 0U; i < head.desc_num; ++i) {
+    hixl::HixlMemDesc desc{};
+    HIXL_CHK_STATUS_RET(ParseOneBinaryMemDesc(reader, i, desc));
+    mem_descs.emplace_back(std::move(desc));
+  }
+  HIXL_CHK_BOOL_RET_STATUS(reader.Left() == 0U, PARAM_INVALID,
+                           "[HixlClient] GetRemoteMemResp has %zu trailing bytes", reader.Left());
+  HIXL_DISMISS_GUARD(free_descs);
+  return SUCCESS;
+}
+
+bool IsBinaryResp(const uint8_t *payload, size_t payload_len) {
+  uint32_t magic = 0U;
+  if (payload_len >= sizeof(magic)) {
+    (void)memcpy_s(&magic, sizeof(magic), payload, sizeof(magic));
+  }
+  return magic == kMemDescListMagic;
+}
+
+Status MemMsgHandler::ParseGetRemoteMemResp(const uint8_t *payload, size_t payload_len,
+                                            std::vector<HixlMemDesc> &mem_descs) {
+  HIXL_CHECK_NOTNULL(payload);
+  if (IsBinaryResp(payload, payload_len)) {
+    return ParseGetRemoteMemBinary(payload, payload_len, mem_descs);
+  }
+  // 兼容旧版本server的json格式
+  return ParseGetRemoteMemJson(reinterpret_cast<const char *>(payload), payload_len, mem_descs);
+}
+
+// 旧版本client只能解析的json格式, 与旧版本server的序列化结果一致
+Status SerializeGetRemoteMemJson(const GetRemoteMemResp &resp, std::string &json_str) {
+  try {
+    nlohmann::json j;
+    j["result"] = resp.result;
+    j["mem_descs"] = nlohmann::json::array();
+    for (const auto &desc : resp.mem_descs) {
+      nlohmann::json item;
+      item["mem"] = {{"type", desc.mem.type},
+                     {"addr", static_cast<uint64_t>(reinterpret_cast<uintptr_t>(desc.mem.addr))},
+                     {"size", desc.mem.size}};
+      item["tag"] = desc.tag;
+      item["export_desc"] = nlohmann::json::array();
+      if (desc.export_desc != nullptr) {
+        const uint8_t *data = static_cast<const uint8_t *>(desc.export_desc);
+        for (uint32_t i = 0U; i < desc.export_len; ++i) {
+          item["export_desc"].push_back(static_cast<int32_t>(data[i]));
+        }
+      }
+      j["mem_descs"].push_back(std::move(item));
+    }
+    json_str = j.dump();
+  } catch (const nlohmann::json::exception &e) {
+    HIXL_LOGE(PARAM_INVALID, "Failed to dump GetRemoteMemResp to json, exception:%s", e.what());
+    return PARAM_INVALID;
+  }
+  return SUCCESS;
+}
+
+Status MemMsgHandler::SerializeGetRemoteMemResp(const GetRemoteMemResp &resp, bool binary, std::vector<uint8_t> &msg) {
+  HIXL_CHK_BOOL_RET_STATUS(resp.mem_descs.size() <= kMaxGetRemoteMemNum, PARAM_INVALID,
+                           "mem num:%zu exceeds max:%u", resp.mem_descs.size(), kMaxGetRemoteMemNum);
+  std::string json_str;
+  size_t payload_size = sizeof(MemDescListHead);
+  if (binary) {
+    for (const auto &desc : resp.mem_descs) {
+      const size_t export_len = (desc.export_desc != nullptr) ? desc.export_len : 0U;
+      payload_size += sizeof(MemDescEntryHead) + desc.tag.size() + export_len;
+    }
+  } else {
+    HIXL_CHK_STATUS_RET(SerializeGetRemoteMemJson(resp, json_str), "Failed to serialize GetRemoteMemResp to json");
+    payload_size = json_str.size();
+  }
+  CtrlMsgHeader header{};
+  header.magic = kMagicNumber;
+  header.body_size = static_cast<uint64_t>(sizeof(CtrlMsgType) + payload_size);
+  HIXL_CHK_BOOL_RET_STATUS(header.body_size <= kMaxGetRemoteMemBodySize, PARAM_INVALID,
+                           "GetRemoteMemResp body size:%" PRIu64 " exceeds max:%" PRIu64, header.body_size,
+                           kMaxGetRemoteMemBodySize);
+  // header、消息类型和消息体写在同一块缓冲区, 一次Send发出
+  msg.resize(sizeof(CtrlMsgHeader) + static_cast<size_t>(header.body_size));
+  BufferWriter writer(msg.data(), msg.size());
+  const CtrlMsgType msg_type = CtrlMsgType::kGetRemoteMemResp;
+  HIXL_CHK_STATUS_RET(writer.Write(&header, sizeof(header)));
+  HIXL_CHK_STATUS_RET(writer.Write(&msg_type, sizeof(msg_type)));
+  if (!binary) {
+    HIXL_CHK_STATUS_RET(writer.Write(json_str.data(), json_str.size()));
+    return SUCCESS;
+  }
+  MemDescListHead head{};
+  head.magic = kMemDescListMagic;
+  head.result = static_cast<uint32_t>(resp.result);
+  head.desc_num = static_cast<uint32_t>(resp.mem_descs.size());
+  HIXL_CHK_STATUS_RET(writer.Write(&head, sizeof(head)));
+  for (const auto &desc : resp.mem_descs) {
+    MemDescEntryHead entry{};
+    entry.type = static_cast<uint32_t>(desc.mem.type);
+    entry.tag_len = static_cast<uint32_t>(desc.tag.size());
+    entry.export_len = (desc.export_desc != nullptr) ? desc.export_len : 0U;
+    entry.addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(desc.mem.addr));
+    entry.size = desc.mem.size;
+    HIXL_CHK_STATUS_RET(writer.Write(&entry, sizeof(entry)));
+    HIXL_CHK_STATUS_RET(writer.Write(desc.tag.data(), desc.tag.size()));
+    HIXL_CHK_STATUS_RET(writer.Write(desc.export_desc, entry.export_len));
+  }
+  return SUCCESS;
+}
+
+Status MemMsgHandler::SendGetRemoteMemResponse(int32_t socket, const GetRemoteMemResp &resp, bool binary) {
+  std::vector<uint8_t> msg;
+  HIXL_CHK_STATUS_RET(SerializeGetRemoteMemResp(resp, binary, msg), "Failed to serialize GetRemoteMemResp");
+  HIXL_LOGI("[HixlServer] Send GetRemoteMemResp, fd:%d, result:%u, mem num:%zu, binary:%d, msg size:%zu", socket,
+            static_cast<uint32_t>(resp.result), resp.mem_descs.size(), static_cast<int32_t>(binary), msg.size());
+  HIXL_CHK_STATUS_RET(CtrlMsgPlugin::Send(socket, msg.data(), msg.size()));
+  return SUCCESS;
+}
+
+Status RecvGetRemoteMemResp(int32_t socket, std::vector<HixlMemDesc> &mem_descs, uint32_t timeout_ms,
+                            bool &binary_resp) {
   HIXL_EVENT("[HixlClient] RecvGetRemoteMemResponse start. socket: %d, timeout_ms: %u", socket, timeout_ms);
+  binary_resp = false;
   uint64_t body_size = 0;
   HIXL_CHK_STATUS_RET(RecvAndCheckHeader(socket, body_size, timeout_ms));
-  std::vector<uint8_t> body;
+  // 接收缓冲区按线程复用, 反复Connect时不再重新申请; 大消息之后释放, 每个线程最多保留kMaxRetainedBodySize
+  thread_local std::vector<uint8_t> body;
+  HIXL_MAKE_GUARD(release_body, []() {
+    if (body.capacity() > kMaxRetainedBodySize) {
+      std::vector<uint8_t>().swap(body);
+    }
+  });
   HIXL_CHK_STATUS_RET(RecvBody(socket, body_size, body, timeout_ms));
   CtrlMsgType msg_type{};
-  const char* json_ptr = nullptr;
-  size_t json_len = 0;
-  HIXL_CHK_STATUS_RET(ExtractTypeAndJsonPtr(body, msg_type, json_ptr, json_len));
-  Status ret = ParseGetRemoteMemJson(json_ptr, json_len, mem_descs);
+  const uint8_t *payload = nullptr;
+  size_t payload_len = 0;
+  HIXL_CHK_STATUS_RET(ExtractTypeAndPayload(body, msg_type, payload, payload_len));
+  binary_resp = IsBinaryResp(payload, payload_len);
+  Status ret = MemMsgHandler::ParseGetRemoteMemResp(payload, payload_len, mem_descs);
   if (ret == SUCCESS) {
     HIXL_EVENT("[HixlClient] RecvGetRemoteMemResponse success. Parsed %zu mem descriptors.", mem_descs.size());
   } else {
@@ -271,4 +500,27 @@ Status MemMsgHandler::RecvGetRemoteMemResponse(int32_t socket, std::vector<HixlM
   }
   return ret;
 }
+
+Status MemMsgHandler::RecvGetRemoteMemResponse(int32_t socket, std::vector<HixlMemDesc> &mem_descs,
+                                               uint32_t timeout_ms) {
+  bool binary_resp = false;
+  return RecvGetRemoteMemResp(socket, mem_descs, timeout_ms, binary_resp);
+}
+
+Status MemMsgHandler::GetRemoteMem(int32_t socket, uint64_t endpoint_handle, std::vector<HixlMemDesc> &mem_descs,
+                                   uint32_t timeout_ms) {
+  HIXL_CHK_STATUS_RET(SendGetRemoteMemRequest(socket, endpoint_handle, timeout_ms, true),
+                      "[HixlClient] SendGetRemoteMemRequest failed. fd=%d", socket);
+  bool binary_resp = false;
+  const Status ret = RecvGetRemoteMemResp(socket, mem_descs, timeout_ms, binary_resp);
+  if ((ret == SUCCESS) || binary_resp) {
+    return ret;
+  }
+  // 旧版本server按长度拒绝带flags的请求并回复json格式的失败, 改用旧格式的请求重试一次
+  HIXL_LOGW("[HixlClient] GetRemoteMem got json reply with ret:%u, retry with legacy request. fd=%d",
+            static_cast<uint32_t>(ret), socket);
+  HIXL_CHK_STATUS_RET(SendGetRemoteMemRequest(socket, endpoint_handle, timeout_ms, false),
+                      "[HixlClient] SendGetRemoteMemRequest failed. fd=%d", socket);
+  return RecvGetRemoteMemResp(socket, mem_descs, timeout_ms, binary_resp);
+}
 }  // namespace hixl
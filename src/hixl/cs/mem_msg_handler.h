@@ -26,7 +26,7 @@
 namespace hixl {
 
 /**
- * GetRemoteMem 消息编解码（client 侧）
+ * GetRemoteMem 消息编解码
  *
  * 协议约定（**header.body_size 一定包含 CtrlMsgType 在内**）：
  *
@@ -34,35 +34,33 @@ namespace hixl {
  *    header.magic     = kMagicNumber
  *    header.body_size = sizeof(CtrlMsgType) + sizeof(GetRemoteMemReq)
  *    body             = [CtrlMsgType::kGetRemoteMemReq][GetRemoteMemReq]
+ *    GetRemoteMemReq.flags 携带 kGetRemoteMemFlagBinaryResp 时 server 回复二进制格式，
+ *    旧版本 client 的请求只有 dst_ep_handle，server 回复 json 格式。
+ *    旧版本 server 只接受 kLegacyGetRemoteMemReqSize 长度的请求，对带 flags 的请求回复 json 格式的失败，
+ *    client 收到 json 格式的失败后用旧格式的请求重试一次
  *
  *  GetRemoteMemResp（server -> client）:
  *    header.magic     = kMagicNumber
- *    header.body_size = sizeof(CtrlMsgType) + json_len
- *    body             = [CtrlMsgType::kGetRemoteMemResp][json_bytes...]
+ *    header.body_size = sizeof(CtrlMsgType) + payload_len
+ *    body             = [CtrlMsgType::kGetRemoteMemResp][payload...]
  *
- *  json 结构（与 server 侧 Serialize 对应）：
+ *  二进制格式的 payload（见 ctrl_msg.h）：
+ *
+ *    [MemDescListHead]                  // magic = kMemDescListMagic, result, desc_num
+ *    [MemDescEntryHead][tag][export_desc] * desc_num
+ *                                       // type/addr/size 为 server 侧 HcclMem 信息，
+ *                                       // tag、export_desc 长度由 tag_len、export_len 给出
+ *
+ *  client 侧在接收缓冲区上原地解析，export_desc 不再经过 json 数组中转。
+ *  payload 不以 kMemDescListMagic 开头时按 json 格式解析，旧版本 server 只回复 json 格式：
  *
  *  {
- *    "result": <Status>,                // uint32，对应 Status 枚举
- *    "mem_descs": [
- *      {
- *        "tag": "xxx",                  // 内存标识字符串
- *        "export_desc": "<memDesc 原始二进制转成的 string>",
- *        "mem": {                       // server 端 HcclMem 描述
- *          "type": <uint32>,            // HixlMemType
- *          "addr": <uint64>,            // server 侧虚拟地址，作为范围校验用
- *          "size": <uint64>             // server 侧内存大小
- *        }
- *      },
- *      ...
- *    ]
+ *    "result": <Status>,
+ *    "mem_descs": [{"tag": "xxx", "export_desc": [<uint8>...], "mem": {"type": .., "addr": .., "size": ..}}, ...]
  *  }
  *
- *  其中：
- *    - client 侧 RecvGetRemoteMemResponse 负责解析上述 JSON，构造出 std::vector<HixlMemDesc>：
- *        - HixlMemDesc::tag        <- "tag"
- *        - HixlMemDesc::export_desc/export_len <- "export_desc"
- *        - HixlMemDesc::mem        <- "mem"（server 侧 HcclMem 信息）
+ *  解析结果为 std::vector<HixlMemDesc>：
+ *    - HixlMemDesc::export_desc 由 malloc 申请，所有权交给调用方
  *    - 后续 HixlCsClient::ImportRemoteMem 使用 export_desc 调用 Endpoint::MemImport，
  *      得到本端可访问的 addr/len，填充给上层使用的 HixlMem，并调用 HixlMemStore::RecordMemory(true, ...)
  *      记录 server 侧内存区域。
@@ -70,10 +68,26 @@ namespace hixl {
 
 class MemMsgHandler {
  public:
-  static Status SendGetRemoteMemRequest(int32_t socket, uint64_t endpoint_handle, uint32_t timeout_ms = 0U);
+  // binary_resp 为 false 时发送旧格式的请求
+  static Status SendGetRemoteMemRequest(int32_t socket, uint64_t endpoint_handle, uint32_t timeout_ms = 0U,
+                                        bool binary_resp = true);
+
+  // 发送请求并接收回复，兼容旧版本 server
+  static Status GetRemoteMem(int32_t socket, uint64_t endpoint_handle, std::vector<HixlMemDesc> &mem_descs,
+                             uint32_t timeout_ms = 0U);
 
   static Status RecvGetRemoteMemResponse(int32_t socket, std::vector<HixlMemDesc> &mem_descs,
                                          uint32_t timeout_ms = 0U);
+
+  // binary 为 false 时回复旧版本 client 能解析的 json 格式
+  static Status SendGetRemoteMemResponse(int32_t socket, const GetRemoteMemResp &resp, bool binary);
+
+  // msg 为完整的消息: [CtrlMsgHeader][CtrlMsgType][payload]
+  static Status SerializeGetRemoteMemResp(const GetRemoteMemResp &resp, bool binary, std::vector<uint8_t> &msg);
+
+  // payload 为 CtrlMsgType 之后的部分
+  static Status ParseGetRemoteMemResp(const uint8_t *payload, size_t payload_len,
+                                      std::vector<HixlMemDesc> &mem_descs);
 };
 
 }  // namespace hixl
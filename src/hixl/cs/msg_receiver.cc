@@ -9,36 +9,52 @@
  */
 
 #include <securec.h>
+#include <sys/uio.h>
+#include <algorithm>
 #include "hixl_cs_server.h"
 #include "common/hixl_checker.h"
 
 namespace hixl {
 namespace {
 const size_t kRecvChunkSizeInBytes = 4096U;  // 异步recv的默认buffer size
+const size_t kRecvExtraSizeInBytes = 64U * 1024U;  // readv的栈上溢出区大小
+const size_t kMaxIdleBufferSizeInBytes = 1024U * 1024U;  // 空闲时保留的最大buffer size
 const size_t kMaxBodySizeInBytes = 4U * 1024U * 1024U;  // 消息体的最大长度
 }
 
 Status MsgReceiver::RecvHeader() {
-  CtrlMsgHeader *header = nullptr;
-  header = reinterpret_cast<CtrlMsgHeader *>(recv_buffer_.data());
-  HIXL_CHK_BOOL_RET_STATUS(header->magic == kMagicNumber, PARAM_INVALID, "Invalid magic number:%u received.",
-                            header->magic);
-  HIXL_CHK_BOOL_RET_STATUS(header->body_size >= sizeof(CtrlMsgType), PARAM_INVALID,
-                            "Invalid body size:%lu received, must >= %zu.", header->body_size, sizeof(CtrlMsgType));
-  expected_size_ = header->body_size;
+  CtrlMsgHeader header{};
+  auto ret = memcpy_s(&header, sizeof(header), recv_buffer_.data() + read_pos_, sizeof(header));
+  HIXL_CHK_BOOL_RET_STATUS(ret == EOK, FAILED, "Call api:memcpy_s failed, ret:%d", static_cast<int32_t>(ret));
+  HIXL_CHK_BOOL_RET_STATUS(header.magic == kMagicNumber, PARAM_INVALID, "Invalid magic number:%u received.",
+                            header.magic);
+  HIXL_CHK_BOOL_RET_STATUS(header.body_size >= sizeof(CtrlMsgType), PARAM_INVALID,
+                            "Invalid body size:%lu received, must >= %zu.", header.body_size, sizeof(CtrlMsgType));
+  expected_size_ = header.body_size;
   HIXL_CHK_BOOL_RET_STATUS(expected_size_ <= kMaxBodySizeInBytes, PARAM_INVALID,
                            "Invalid body size:%zu received, must <= %zu.", expected_size_, kMaxBodySizeInBytes);
   recv_state_ = RecvState::WAITING_FOR_BODY;
-  if (received_size_ > sizeof(CtrlMsgHeader)) {
-    size_t remaining = received_size_ - sizeof(CtrlMsgHeader);
-    auto ret = memmove_s(recv_buffer_.data(), remaining, recv_buffer_.data() + sizeof(CtrlMsgHeader), remaining);
+  read_pos_ += sizeof(CtrlMsgHeader);
+  return SUCCESS;
+}
+
+Status MsgReceiver::ReserveRecvSpace(size_t size) {
+  if (recv_buffer_.size() - received_size_ >= size) {
+    return SUCCESS;
+  }
+  // 未解析的数据搬到buffer头部, 每次recv最多搬移一次
+  const size_t remaining = received_size_ - read_pos_;
+  if ((read_pos_ > 0U) && (remaining > 0U)) {
+    auto ret = memmove_s(recv_buffer_.data(), recv_buffer_.size(), recv_buffer_.data() + read_pos_, remaining);
     HIXL_CHK_BOOL_RET_STATUS(ret == EOK, FAILED,
                              "Call api:memmove_s failed, ret:%d, dst_addr:%p, dst_max:%zu, src_addr:%p, count:%zu",
-                             static_cast<int32_t>(ret), recv_buffer_.data(), remaining,
-                             recv_buffer_.data() + sizeof(CtrlMsgHeader), remaining);
-    received_size_ = remaining;
-  } else {
-    received_size_ = 0U;
+                             static_cast<int32_t>(ret), recv_buffer_.data(), recv_buffer_.size(),
+                             recv_buffer_.data() + read_pos_, remaining);
+  }
+  read_pos_ = 0U;
+  received_size_ = remaining;
+  if (recv_buffer_.size() < received_size_ + size) {
+    recv_buffer_.resize(received_size_ + size);
   }
   return SUCCESS;
 }
@@ -59,12 +75,20 @@ bool MsgReceiver::CheckDisconnect(ssize_t recv_size) const {
 }
 
 Status MsgReceiver::IRecv(std::vector<CtrlMsgPtr> &msgs) {
-  if (recv_buffer_.size() < received_size_ + kRecvChunkSizeInBytes) {
-    recv_buffer_.resize(received_size_ + kRecvChunkSizeInBytes);
+  size_t wanted_size = kRecvChunkSizeInBytes;
+  if (recv_state_ == RecvState::WAITING_FOR_BODY) {
+    // 已知消息体长度时一次预留出整个消息体, 大消息不再按4K分片接收
+    wanted_size = std::max(wanted_size, expected_size_ - std::min(expected_size_, received_size_ - read_pos_));
   }
-  auto buffer = recv_buffer_.data() + received_size_;
-  auto buffer_size = recv_buffer_.size() - received_size_;
-  ssize_t n = recv(fd_, buffer, buffer_size, 0);
+  HIXL_CHK_STATUS_RET(ReserveRecvSpace(wanted_size), "Failed to reserve recv buffer, fd:%d", fd_);
+  // buffer剩余空间不足以读完socket中已到达的数据时, 多余部分落到栈上的溢出区, 一次系统调用读完
+  char extra_buffer[kRecvExtraSizeInBytes];
+  struct iovec iov[2];
+  iov[0].iov_base = recv_buffer_.data() + received_size_;
+  iov[0].iov_len = recv_buffer_.size() - received_size_;
+  iov[1].iov_base = extra_buffer;
+  iov[1].iov_len = sizeof(extra_buffer);
+  ssize_t n = readv(fd_, iov, 2);
   if (CheckDisconnect(n)) {
     auto msg = MakeShared<CtrlMsg>();
     HIXL_CHECK_NOTNULL(msg);
@@ -72,40 +96,50 @@ Status MsgReceiver::IRecv(std::vector<CtrlMsgPtr> &msgs) {
     msgs.emplace_back(msg);
     return SUCCESS;
   }
+  if (n < 0) {
+    return SUCCESS;
+  }
+  const auto recv_size = static_cast<size_t>(n);
+  if (recv_size <= iov[0].iov_len) {
+    received_size_ += recv_size;
+  } else {
+    (void)recv_buffer_.insert(recv_buffer_.end(), extra_buffer, extra_buffer + (recv_size - iov[0].iov_len));
+    received_size_ = recv_buffer_.size();
+  }
+  return ParseMsgs(msgs);
+}
 
-  received_size_ += static_cast<size_t>(n);
+Status MsgReceiver::ParseMsgs(std::vector<CtrlMsgPtr> &msgs) {
   while (true) {
+    const size_t remaining = received_size_ - read_pos_;
     if (recv_state_ == RecvState::WAITING_FOR_HEADER) {
-      if (received_size_ < sizeof(CtrlMsgHeader)) {
+      if (remaining < sizeof(CtrlMsgHeader)) {
         break;
       }
       HIXL_CHK_STATUS_RET(RecvHeader(), "Failed to recv header");
+      continue;
     }
-    if (recv_state_ == RecvState::WAITING_FOR_BODY) {
-      if (received_size_ < expected_size_) {
-        break;
-      }
-      auto ctrl_msg = MakeShared<CtrlMsg>();
-      HIXL_CHECK_NOTNULL(ctrl_msg);
-      ctrl_msg->msg_type = *reinterpret_cast<CtrlMsgType *>(recv_buffer_.data());
-      ctrl_msg->msg = std::string(recv_buffer_.data() + sizeof(CtrlMsgType), expected_size_ - sizeof(CtrlMsgType));
-      msgs.emplace_back(ctrl_msg);
-      HIXL_LOGI("[HixlServer] recv ctrl msg, msg type:%d, msg body size:%zu",
-                static_cast<int32_t>(ctrl_msg->msg_type), ctrl_msg->msg.size());
-      if (received_size_ > expected_size_) {
-        size_t remaining = received_size_ - expected_size_;
-        auto ret = memmove_s(recv_buffer_.data(), remaining, recv_buffer_.data() + expected_size_, remaining);
-        HIXL_CHK_BOOL_RET_STATUS(ret == EOK, FAILED,
-                                 "Call api:memmove_s failed, ret:%d, dst_addr:%p, dst_max:%zu, src_addr:%p, count:%zu",
-                                 static_cast<int32_t>(ret), recv_buffer_.data(), remaining,
-                                 recv_buffer_.data() + expected_size_, remaining);
-        received_size_ = remaining;
-        recv_state_ = RecvState::WAITING_FOR_HEADER;
-      } else {
-        received_size_ = 0U;
-        recv_state_ = RecvState::WAITING_FOR_HEADER;
-        break;
-      }
+    if (remaining < expected_size_) {
+      break;
+    }
+    const char *body = recv_buffer_.data() + read_pos_;
+    auto ctrl_msg = MakeShared<CtrlMsg>();
+    HIXL_CHECK_NOTNULL(ctrl_msg);
+    auto ret = memcpy_s(&ctrl_msg->msg_type, sizeof(CtrlMsgType), body, sizeof(CtrlMsgType));
+    HIXL_CHK_BOOL_RET_STATUS(ret == EOK, FAILED, "Call api:memcpy_s failed, ret:%d", static_cast<int32_t>(ret));
+    ctrl_msg->msg.assign(body + sizeof(CtrlMsgType), expected_size_ - sizeof(CtrlMsgType));
+    msgs.emplace_back(ctrl_msg);
+    HIXL_LOGI("[HixlServer] recv ctrl msg, msg type:%d, msg body size:%zu",
+              static_cast<int32_t>(ctrl_msg->msg_type), ctrl_msg->msg.size());
+    read_pos_ += expected_size_;
+    recv_state_ = RecvState::WAITING_FOR_HEADER;
+  }
+  if (read_pos_ == received_size_) {
+    read_pos_ = 0U;
+    received_size_ = 0U;
+    // 收过大消息后不长期占用内存
+    if (recv_buffer_.size() > kMaxIdleBufferSizeInBytes) {
+      std::vector<char>().swap(recv_buffer_);
     }
   }
   return SUCCESS;
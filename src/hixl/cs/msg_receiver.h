@@ -29,11 +29,15 @@ class MsgReceiver {
 
  private:
   Status RecvHeader();
+  Status ParseMsgs(std::vector<CtrlMsgPtr> &msgs);
+  Status ReserveRecvSpace(size_t size);
   bool CheckDisconnect(ssize_t recv_size) const;
 
   int32_t fd_ = -1;
   RecvState recv_state_ = RecvState::WAITING_FOR_HEADER;
+  // [read_pos_, received_size_)为已接收未解析的数据, 缓冲区在连接生命周期内复用
   std::vector<char> recv_buffer_;
+  size_t read_pos_ = 0U;
   size_t received_size_ = 0U;
   size_t expected_size_ = 0U;
 };
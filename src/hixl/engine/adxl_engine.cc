@@ -42,20 +42,24 @@ Status AdxlEngine::Disconnect(const AscendString &remote_engine, int32_t timeout
 }
 
 Status AdxlEngine::TransferSync(const AscendString &remote_engine, TransferOp operation,
-                                const std::vector<TransferOpDesc> &op_descs, int32_t timeout_in_millis) {
+                                const std::vector<TransferOpDesc> &op_descs, const TransferArgs &optional_args,
+                                int32_t timeout_in_millis) {
   adxl::TransferOp adxl_operation = static_cast<adxl::TransferOp>(operation);
   std::vector<adxl::TransferOpDesc> adxl_op_descs;
   for (const auto &op_desc : op_descs) {
     adxl::TransferOpDesc temp{op_desc.local_addr, op_desc.remote_addr, op_desc.len};
     adxl_op_descs.push_back(temp);
   }
-  return adxl_inner_engine_.TransferSync(remote_engine, adxl_operation, adxl_op_descs, timeout_in_millis);
+  adxl::TransferArgs adxl_optional_args;
+  adxl_optional_args.priority = static_cast<adxl::TransferPriority>(optional_args.priority);
+  adxl_optional_args.allow_lossy_compression = optional_args.allow_lossy_compression;
+  return adxl_inner_engine_.TransferSync(remote_engine, adxl_operation, adxl_op_descs, adxl_optional_args,
+                                         timeout_in_millis);
 }
 
 Status AdxlEngine::TransferAsync(const AscendString &remote_engine, TransferOp operation,
                                  const std::vector<TransferOpDesc> &op_descs, const TransferArgs &optional_args,
                                  TransferReq &req) {
-  (void)optional_args;
   adxl::TransferOp adxl_operation = static_cast<adxl::TransferOp>(operation);
   std::vector<adxl::TransferOpDesc> adxl_op_descs;
   for (const auto &op_desc : op_descs) {
@@ -63,6 +67,8 @@ Status AdxlEngine::TransferAsync(const AscendString &remote_engine, TransferOp o
     adxl_op_descs.push_back(temp);
   }
   adxl::TransferArgs adxl_optional_args;
+  adxl_optional_args.priority = static_cast<adxl::TransferPriority>(optional_args.priority);
+  adxl_optional_args.allow_lossy_compression = optional_args.allow_lossy_compression;
   return adxl_inner_engine_.TransferAsync(remote_engine, adxl_operation, adxl_op_descs, adxl_optional_args, req);
 }
 
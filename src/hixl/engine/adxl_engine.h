@@ -38,7 +38,8 @@ class AdxlEngine : public Engine {
   Status Disconnect(const AscendString &remote_engine, int32_t timeout_in_millis) override;
 
   Status TransferSync(const AscendString &remote_engine, TransferOp operation,
-                      const std::vector<TransferOpDesc> &op_descs, int32_t timeout_in_millis) override;
+                      const std::vector<TransferOpDesc> &op_descs, const TransferArgs &optional_args,
+                      int32_t timeout_in_millis) override;
 
   Status TransferAsync(const AscendString &remote_engine, TransferOp operation,
                        const std::vector<TransferOpDesc> &op_descs, const TransferArgs &optional_args,
@@ -35,7 +35,8 @@ class Engine {
   virtual Status Disconnect(const AscendString &remote_engine, int32_t timeout_in_millis) = 0;
 
   virtual Status TransferSync(const AscendString &remote_engine, TransferOp operation,
-                              const std::vector<TransferOpDesc> &op_descs, int32_t timeout_in_millis) = 0;
+                              const std::vector<TransferOpDesc> &op_descs, const TransferArgs &optional_args,
+                              int32_t timeout_in_millis) = 0;
 
   virtual Status TransferAsync(const AscendString &remote_engine, TransferOp operation,
                                const std::vector<TransferOpDesc> &op_descs, const TransferArgs &optional_args,
@@ -23,11 +23,15 @@
 #include "common/ctrl_msg_plugin.h"
 #include "common/scope_guard.h"
 #include "common/thread_pool.h"
+#include "common/trace_recorder.h"
 
 namespace hixl {
 namespace {
 constexpr uint64_t kMaxRecvRespBodySize = static_cast<uint64_t>(4ULL * 1024ULL * 1024ULL);  // 4MB 示例上限
 constexpr uint32_t kCtrlMsgPluginTimeoutMs = 10000U;
+constexpr uint32_t kPostedBatchWaitTimeoutMs = 10000U;
+// a rail sample is dropped when the polls around its completion are further apart than this share of its cost
+constexpr int64_t kMaxPollWindowShare = 4;
 constexpr uint32_t kMaxUbCsClientNum = 4U;
 constexpr const char *kProtocolRoce = "roce";
 constexpr const char *kProtocolUbCtp = "ub_ctp";
@@ -49,6 +53,8 @@ const char *CommTypeToString(CommType type) {
       return "ROCE";
     case COMM_TYPE_HCCS:
       return "HCCS";
+    case COMM_TYPE_SHM:
+      return "SHM";
     default:
       return "UNKNOWN";
   }
@@ -66,9 +72,13 @@ std::map<MatchKey, EndPointConfig>::const_iterator FindMatchingKey(const std::ma
 }
 }  // namespace
 
+std::atomic<uint64_t> HixlClient::next_req_id_{1U};
+
 Status HixlClient::Initialize(const std::vector<EndPointConfig> &local_endpoint_list) {
   // 创建socket，与server建链，发送请求，获取remote_endpoint_list
   std::vector<EndPointConfig> remote_endpoint_list;
+  HIXL_CHK_STATUS_RET(RailStriper::LoadConfigFromEnv(stripe_config_), "HixlClient load multi rail config failed");
+  HIXL_CHK_STATUS_RET(LoadShmTransportConfigFromEnv(shm_config_), "HixlClient load shm transport config failed");
   CtrlMsgPlugin::Initialize();
   {
     int32_t socket = -1;
@@ -85,15 +95,30 @@ Status HixlClient::Initialize(const std::vector<EndPointConfig> &local_endpoint_
                         "HixlClient SendEndPointInfoReq failed");
     HIXL_CHK_STATUS_RET(RecvEndPointInfoResp(socket, remote_endpoint_list), "HixlClient RecvEndPointInfoResp failed");
   }
+  ExtractShmEndPoint(remote_endpoint_list);
   if (remote_endpoint_list.empty()) {
     HIXL_LOGE(FAILED, "HixlClient received empty remote_endpoint_list");
     return FAILED;
   }
   HIXL_CHK_STATUS_RET(FindMatchedEndPoints(local_endpoint_list, remote_endpoint_list),
                       "HixlClient FindMatchedEndPoints failed");
+  SetupRailStripers();
   return SUCCESS;
 }
 
+void HixlClient::ExtractShmEndPoint(std::vector<EndPointConfig> &remote_endpoint_list) {
+  auto it = std::find_if(remote_endpoint_list.begin(), remote_endpoint_list.end(),
+                         [](const EndPointConfig &endpoint) { return endpoint.protocol == kProtocolShm; });
+  if (it == remote_endpoint_list.end()) {
+    return;
+  }
+  if (shm_config_.enable && ShmImporter::IsLocalPeer(*it)) {
+    shm_endpoint_ = MakeUnique<EndPointConfig>(*it);
+    HIXL_LOGI("HixlClient found same host server, shm endpoint:%s", it->comm_id.c_str());
+  }
+  remote_endpoint_list.erase(it);
+}
+
 Status HixlClient::SendEndPointInfoReq(int32_t fd, CtrlMsgType msg_type) {
   CtrlMsgHeader header{};
   header.magic = kMagicNumber;
@@ -189,7 +214,9 @@ Status HixlClient::FindMatchedEndPoints(const std::vector<EndPointConfig> &local
                                         const std::vector<EndPointConfig> &remote_endpoint_list) {
   // 如果必须使用ROCE，直接匹配并创建ROCE链路
   if (MustUseRoce(local_endpoint_list, remote_endpoint_list)) {
-    return TryMatchRoceEndpoints(local_endpoint_list, remote_endpoint_list);
+    HIXL_CHK_STATUS_RET(TryMatchRoceEndpoints(local_endpoint_list, remote_endpoint_list),
+                        "HixlClient TryMatchRoceEndpoints failed");
+    return stripe_config_.enable ? TryMatchExtraRoceRails(local_endpoint_list, remote_endpoint_list) : SUCCESS;
   }
   // 匹配创建UB链路
   std::map<CommType, bool> expected_pairs = {
@@ -201,11 +228,16 @@ Status HixlClient::FindMatchedEndPoints(const std::vector<EndPointConfig> &local
     HIXL_LOGI("local_endpoint:%s", local_endpoint.ToString().c_str());
     HIXL_CHK_STATUS_RET(TryMatchUbEndpoints(local_endpoint, peer_match_endpoints, expected_pairs, count),
                         "HixlClient TryMatchUbEndpoints failed");
-    if (count == kMaxUbCsClientNum) {
+    // 条带化时继续遍历，剩余端点可作为 D2D 的额外链路
+    if ((count == kMaxUbCsClientNum) && (!stripe_config_.enable)) {
       HIXL_LOGI("Created all %u expected UB CS clients", count);
       return SUCCESS;
     }
   }
+  if (count == kMaxUbCsClientNum) {
+    HIXL_LOGI("Created all %u expected UB CS clients", count);
+    return SUCCESS;
+  }
   if (count > 0) {
     HIXL_LOGW("Found only %u/%u expected ub endpoint pairs", count, kMaxUbCsClientNum);
     return SUCCESS;
@@ -245,6 +277,59 @@ Status HixlClient::TryMatchRoceEndpoints(const std::vector<EndPointConfig> &loca
   }
 }
 
+// 开启条带化时，第 i 个本端 ROCE 端点与第 i 个远端 ROCE 端点组成一条额外链路，第 0 对为主链路
+Status HixlClient::TryMatchExtraRoceRails(const std::vector<EndPointConfig> &local_endpoint_list,
+                                          const std::vector<EndPointConfig> &remote_endpoint_list) {
+  std::vector<const EndPointConfig *> local_roce;
+  std::vector<const EndPointConfig *> remote_roce;
+  for (const auto &endpoint : local_endpoint_list) {
+    if (endpoint.protocol == kProtocolRoce) {
+      local_roce.emplace_back(&endpoint);
+    }
+  }
+  for (const auto &endpoint : remote_endpoint_list) {
+    if (endpoint.protocol == kProtocolRoce) {
+      remote_roce.emplace_back(&endpoint);
+    }
+  }
+  const size_t rail_num = std::min(local_roce.size(), remote_roce.size());
+  for (size_t i = 1U; i < rail_num; ++i) {
+    HIXL_CHK_STATUS_RET(CreateCsClients(*local_roce[i], *remote_roce[i], COMM_TYPE_ROCE),
+                        "HixlClient create extra rail failed for type %s", CommTypeToString(COMM_TYPE_ROCE));
+  }
+  return SUCCESS;
+}
+
+void HixlClient::SetupRailStripers() {
+  std::lock_guard<std::mutex> lock(client_handles_mutex_);
+  rail_stripers_.clear();
+  for (const auto &type_with_rails : extra_rail_handles_) {
+    auto striper = MakeUnique<RailStriper>();
+    if (striper == nullptr) {
+      HIXL_LOGW("Failed to create rail striper for type %s, use single rail", CommTypeToString(type_with_rails.first));
+      continue;
+    }
+    striper->Init(type_with_rails.second.size() + 1U, stripe_config_);
+    HIXL_LOGI("HixlClient stripes %s transfers over %zu rails", CommTypeToString(type_with_rails.first),
+              striper->GetRailNum());
+    rail_stripers_[type_with_rails.first] = std::move(striper);
+  }
+}
+
+std::vector<HixlClientHandle> HixlClient::GetRailHandles(CommType type) const {
+  std::vector<HixlClientHandle> handles;
+  auto it = client_handles_.find(type);
+  if (it == client_handles_.end()) {
+    return handles;
+  }
+  handles.emplace_back(it->second);
+  auto extra_it = extra_rail_handles_.find(type);
+  if (extra_it != extra_rail_handles_.end()) {
+    handles.insert(handles.end(), extra_it->second.begin(), extra_it->second.end());
+  }
+  return handles;
+}
+
 void HixlClient::BuildEndpointsMatchMap(const std::vector<EndPointConfig> &endpoint_list,
                                         std::map<MatchKey, EndPointConfig> &peer_match_endpoints) const {
   for (const auto &endpoint : endpoint_list) {
@@ -274,6 +359,10 @@ Status HixlClient::TryMatchUbEndpoints(const EndPointConfig &local_endpoint,
         expected_pairs[type] = true;
         count++;
         HIXL_LOGI("HixlClient CreateCsClients success for type %s", CommTypeToString(type));
+      } else if (stripe_config_.enable && (type == COMM_TYPE_UB_D2D)) {
+        HIXL_CHK_STATUS_RET(CreateCsClients(local_endpoint, it->second, type),
+                            "HixlClient create extra rail failed for type %s", CommTypeToString(type));
+        HIXL_LOGI("HixlClient create extra rail success for type %s", CommTypeToString(type));
       }
     }
   }
@@ -312,7 +401,11 @@ Status HixlClient::CreateCsClients(const EndPointConfig &local_endpoint_config,
   HIXL_CHK_STATUS_RET(HixlCSClientCreate(server_ip_.c_str(), server_port_, &local_endpoint, &remote_endpoint, &handle),
                       "HixlClient create cs client failed for type %s", CommTypeToString(type));
   std::lock_guard<std::mutex> lock(client_handles_mutex_);
-  client_handles_[type] = handle;
+  if (client_handles_.find(type) == client_handles_.end()) {
+    client_handles_[type] = handle;
+  } else {
+    extra_rail_handles_[type].emplace_back(handle);
+  }
   HIXL_LOGI("HixlClient create cs client success for type %s", CommTypeToString(type));
   return SUCCESS;
 }
@@ -370,17 +463,15 @@ Status HixlClient::RegisterMemToCsClient(const MemDesc &mem, const MemType type)
   // 注册内存到对应的cs client
   std::lock_guard<std::mutex> lock(client_handles_mutex_);
   for (const auto &comm_type : comm_types_to_register) {
-    auto handle_it = client_handles_.find(comm_type);
-    if (handle_it == client_handles_.end()) {
-      continue;
-    }
-    MemHandle mem_handle = nullptr;
-    HIXL_CHK_STATUS_RET(HixlCSClientRegMem(handle_it->second, nullptr, &hccl_mem, &mem_handle),
-                        "HixlClient RegMem failed, addr: 0x%lx, size: %lu, type: %s", mem.addr, mem.len,
-                        (type == MemType::MEM_DEVICE) ? "DEVICE" : "HOST");
-    {
-      std::lock_guard<std::mutex> lock(mem_handles_mutex_);
-      client_mem_handles_[comm_type].push_back(mem_handle);
+    for (const auto handle : GetRailHandles(comm_type)) {
+      MemHandle mem_handle = nullptr;
+      HIXL_CHK_STATUS_RET(HixlCSClientRegMem(handle, nullptr, &hccl_mem, &mem_handle),
+                          "HixlClient RegMem failed, addr: 0x%lx, size: %lu, type: %s", mem.addr, mem.len,
+                          (type == MemType::MEM_DEVICE) ? "DEVICE" : "HOST");
+      {
+        std::lock_guard<std::mutex> lock(mem_handles_mutex_);
+        client_mem_handles_[handle].push_back(mem_handle);
+      }
     }
   }
   HIXL_LOGI("HixlClient RegMem success, addr: 0x%lx, size: %lu, type: %s", mem.addr, mem.len,
@@ -395,12 +486,18 @@ Status HixlClient::Connect(uint32_t timeout_ms) {
     return FAILED;
   }
 
-  ThreadPool thread_pool("hixl_client_connect", client_handles_.size());
+  std::vector<std::pair<CommType, HixlClientHandle>> rails;
+  for (const auto &pair : client_handles_) {
+    for (const auto handle : GetRailHandles(pair.first)) {
+      rails.emplace_back(pair.first, handle);
+    }
+  }
+  ThreadPool thread_pool("hixl_client_connect", static_cast<uint32_t>(rails.size()));
   std::vector<std::future<Status>> connect_futures;
   aclrtContext context = nullptr;
   HIXL_CHK_ACL_RET(aclrtGetCurrentContext(&context));
   HIXL_LOGI("[XMX] aclrtGetCurrentContext, context: %p", context);
-  for (const auto &pair : client_handles_) {
+  for (const auto &pair : rails) {
     auto type = pair.first;
     auto handle = pair.second;
     auto future = thread_pool.commit([handle, timeout_ms, type, context]() -> Status {
@@ -442,6 +539,16 @@ Status HixlClient::Connect(uint32_t timeout_ms) {
   // }
   HIXL_LOGI("HixlClient Connect success");
   HIXL_CHK_STATUS_RET(ProcessRemoteMem(timeout_ms), "HixlClient ProcessRemoteMem failed");
+  // 同机 server 的 host 内存直接导入，失败时 H2H 仍走数据链路
+  if ((shm_endpoint_ != nullptr) && (shm_importer_ == nullptr)) {
+    auto shm_importer = MakeUnique<ShmImporter>(shm_config_);
+    if ((shm_importer != nullptr) && (shm_importer->Connect(*shm_endpoint_, timeout_ms) == SUCCESS)) {
+      shm_importer_ = std::move(shm_importer);
+    } else {
+      HIXL_LOGW("HixlClient import shm endpoint %s failed, H2H transfers use the data endpoints",
+                shm_endpoint_->comm_id.c_str());
+    }
+  }
   std::lock_guard<std::mutex> status_lock(status_mutex_);
   is_connected_ = true;
   return SUCCESS;
@@ -475,6 +582,16 @@ Status HixlClient::ProcessRemoteMem(uint32_t timeout_ms) {
       }
     }
   }
+  // 额外链路也需导入远端内存，地址范围与主链路相同，不再重复记录
+  for (const auto &type_with_rails : extra_rail_handles_) {
+    for (const auto handle : type_with_rails.second) {
+      HcommMem *remote_mem_list = nullptr;
+      char **mem_tag_list = nullptr;
+      uint32_t list_num = 0;
+      HIXL_CHK_STATUS_RET(HixlCSClientGetRemoteMem(handle, &remote_mem_list, &mem_tag_list, &list_num, timeout_ms),
+                          "HixlClient get remote memories failed on extra rail, timeout:%u ms", timeout_ms);
+    }
+  }
   return SUCCESS;
 }
 
@@ -490,9 +607,9 @@ Status HixlClient::Finalize() {
   {
     std::lock_guard<std::mutex> lock(mem_handles_mutex_);
     for (const auto &pair : client_mem_handles_) {
-      auto &type = pair.first;
+      auto handle = pair.first;
       auto &mem_handles = pair.second;
-      ret = UnregisterMemToCsClient(type, mem_handles);
+      ret = UnregisterMemToCsClient(handle, mem_handles);
     }
     client_mem_handles_.clear();
   }
@@ -502,16 +619,23 @@ Status HixlClient::Finalize() {
     std::lock_guard<std::mutex> lock(client_handles_mutex_);
     for (const auto &pair : client_handles_) {
       auto &type = pair.first;
-      auto handle = pair.second;
-      if (handle != nullptr) {
-        auto status = HixlCSClientDestroy(handle);
-        if (status != SUCCESS) {
-          HIXL_LOGE(FAILED, "HixlClient Destroy Cs Client failed for type %s", CommTypeToString(type));
-          ret = status;
+      for (const auto handle : GetRailHandles(type)) {
+        if (handle != nullptr) {
+          auto status = HixlCSClientDestroy(handle);
+          if (status != SUCCESS) {
+            HIXL_LOGE(FAILED, "HixlClient Destroy Cs Client failed for type %s", CommTypeToString(type));
+            ret = status;
+          }
         }
       }
     }
     client_handles_.clear();
+    extra_rail_handles_.clear();
+    rail_stripers_.clear();
+    if (shm_importer_ != nullptr) {
+      shm_importer_->Finalize();
+      shm_importer_.reset();
+    }
   }
 
   // 清理其他共享资源
@@ -535,24 +659,17 @@ Status HixlClient::Finalize() {
   return ret;
 }
 
-Status HixlClient::UnregisterMemToCsClient(CommType type, const std::vector<MemHandle> &mem_handles) {
-  std::lock_guard<std::mutex> lock(client_handles_mutex_);
-  auto handle_it = client_handles_.find(type);
-  if (handle_it == client_handles_.end()) {
-    HIXL_LOGE(FAILED, "No cs client handle found for type %s, skip mem unregistration", CommTypeToString(type));
-    return FAILED;
-  }
-  auto handle = handle_it->second;
+Status HixlClient::UnregisterMemToCsClient(HixlClientHandle handle, const std::vector<MemHandle> &mem_handles) {
   if (handle == nullptr) {
-    HIXL_LOGE(FAILED, "Client handle is nullptr for type %s, skip mem unregistration", CommTypeToString(type));
+    HIXL_LOGE(FAILED, "Client handle is nullptr, skip mem unregistration");
     return FAILED;
   }
   Status ret = SUCCESS;
   for (auto &mem_handle : mem_handles) {
     if (mem_handle != nullptr) {
-      auto status = HixlCSClientUnregMem(handle_it->second, mem_handle);
+      auto status = HixlCSClientUnregMem(handle, mem_handle);
       if (status != SUCCESS) {
-        HIXL_LOGE(status, "HixlClient UnregMem failed for type %s", CommTypeToString(type));
+        HIXL_LOGE(status, "HixlClient UnregMem failed for cs client %p", handle);
         ret = status;
       }
     }
@@ -572,6 +689,7 @@ Status HixlClient::GetMemType(const std::vector<SegmentPtr> &segments, uintptr_t
 
 Status HixlClient::ClassifyTransfers(const std::vector<TransferOpDesc> &op_descs,
                                      std::map<CommType, std::vector<TransferOpDesc>> &op_descs_table) {
+  HIXL_TRACE_SPAN("HixlClient::ClassifyTransfers");
   for (const auto &op_desc : op_descs) {
     // 判断内存类型
     MemType local_mem_type;
@@ -593,9 +711,14 @@ Status HixlClient::ClassifyTransfers(const std::vector<TransferOpDesc> &op_descs
       }
     }
 
-    // 如果是roce，直接将op_desc保存在op_descs_table中
+    // 同机 H2H 且远端内存已导入时直接拷贝；如果是roce，直接将op_desc保存在op_descs_table中
     {
       std::lock_guard<std::mutex> lock(client_handles_mutex_);
+      if ((local_mem_type == MEM_HOST) && (remote_mem_type == MEM_HOST) && (shm_importer_ != nullptr) &&
+          shm_importer_->Contains(op_desc.remote_addr, op_desc.len)) {
+        op_descs_table[COMM_TYPE_SHM].push_back(op_desc);
+        continue;
+      }
       if (client_handles_.find(COMM_TYPE_ROCE) != client_handles_.end()) {
         op_descs_table[COMM_TYPE_ROCE].push_back(op_desc);
         HIXL_LOGI("Cur comm type:%s.", CommTypeToString(COMM_TYPE_ROCE));
@@ -619,7 +742,8 @@ Status HixlClient::ClassifyTransfers(const std::vector<TransferOpDesc> &op_descs
 }
 
 Status HixlClient::BatchTransfer(const std::vector<TransferOpDesc> &op_descs, TransferOp operation,
-                                 std::vector<TransferCompleteInfo> &complete_handle_list) {
+                                 TransferPriority priority, std::vector<TransferCompleteInfo> &complete_handle_list) {
+  HIXL_TRACE_SPAN("HixlClient::BatchTransfer");
   {
     std::lock_guard<std::mutex> lock(status_mutex_);
     if (!is_connected_) {
@@ -631,56 +755,162 @@ Status HixlClient::BatchTransfer(const std::vector<TransferOpDesc> &op_descs, Tr
   std::map<CommType, std::vector<TransferOpDesc>> op_descs_table;
   HIXL_CHK_STATUS_RET(ClassifyTransfers(op_descs, op_descs_table), "HixlClient failed to classify transfer op_descs");
 
-  // 执行批量传输操作
+  // 执行批量传输操作，排队时 HIGH 请求先于 NORMAL 请求下发
+  PriorityLockGuard submit_lock(submit_mutex_, priority == TransferPriority::HIGH);
   std::lock_guard<std::mutex> lock(client_handles_mutex_);
   for (const auto &type_with_op_descs : op_descs_table) {
     auto type = type_with_op_descs.first;
     const auto &op_descs = type_with_op_descs.second;
     HIXL_LOGI("HixlClient BatchTransfer start, type:%s, op_descs size:%zu", CommTypeToString(type), op_descs.size());
-    HixlClientHandle handle = nullptr;
-    auto it = client_handles_.find(type);
-    if (it == client_handles_.end()) {
+    if (type == COMM_TYPE_SHM) {
+      void *complete_handle = nullptr;
+      const auto ret =
+          shm_importer_->TransferAsync(op_descs, operation, priority == TransferPriority::HIGH, complete_handle);
+      if (ret != SUCCESS) {
+        HIXL_LOGE(ret, "HixlClient shm transfer failed");
+        WaitPostedBatches(complete_handle_list);
+        complete_handle_list.clear();
+        return ret;
+      }
+      const auto now = std::chrono::steady_clock::now();
+      TransferCompleteInfo complete_info{type, complete_handle, nullptr, 0U, 0U, now, now};
+      complete_handle_list.push_back(complete_info);
+      continue;
+    }
+    const auto rails = GetRailHandles(type);
+    if (rails.empty()) {
       HIXL_LOGE(FAILED, "HixlClient not found client handle for type:%s", CommTypeToString(type));
+      WaitPostedBatches(complete_handle_list);
+      complete_handle_list.clear();
       return FAILED;
+    }
+    // 大批量按链路带宽切分到多条链路，小批量仍走主链路
+    std::vector<std::vector<TransferOpDesc>> rail_op_descs;
+    auto striper_it = rail_stripers_.find(type);
+    if (striper_it != rail_stripers_.end()) {
+      striper_it->second->Split(op_descs, rail_op_descs);
     } else {
-      handle = it->second;
-    }
-    uint32_t list_num = op_descs.size();
-    std::vector<void *> remote_buff_list(list_num);
-    std::vector<void *> local_buff_list(list_num);
-    std::vector<uint64_t> len_list(list_num);
-    for (size_t i = 0; i < op_descs.size(); i++) {
-      remote_buff_list[i] = reinterpret_cast<void *>(op_descs[i].remote_addr);
-      local_buff_list[i] = reinterpret_cast<void *>(op_descs[i].local_addr);
-      len_list[i] = op_descs[i].len;
-    }
-    void *complete_handle = nullptr;
-    if (operation == WRITE) {
-      HIXL_CHK_STATUS_RET(
-          HixlCSClientBatchPut(handle, list_num, remote_buff_list.data(),
-                               const_cast<const void **>(local_buff_list.data()), len_list.data(), &complete_handle),
-          "HixlClient BatchPut failed");
-    } else {
-      HIXL_CHK_STATUS_RET(
-          HixlCSClientBatchGet(handle, list_num, local_buff_list.data(),
-                               const_cast<const void **>(remote_buff_list.data()), len_list.data(), &complete_handle),
-          "HixlClient BatchGet failed");
+      rail_op_descs.emplace_back(op_descs);
+    }
+    for (size_t rail = 0U; rail < rail_op_descs.size(); ++rail) {
+      if (rail_op_descs[rail].empty()) {
+        continue;
+      }
+      const auto start_time = std::chrono::steady_clock::now();
+      void *complete_handle = nullptr;
+      const auto ret = PostBatch(rails[rail], rail_op_descs[rail], operation, complete_handle);
+      if (ret != SUCCESS) {
+        HIXL_LOGE(ret, "HixlClient post batch failed, type:%s, rail:%zu", CommTypeToString(type), rail);
+        WaitPostedBatches(complete_handle_list);
+        complete_handle_list.clear();
+        return ret;
+      }
+      uint64_t bytes = 0U;
+      for (const auto &op_desc : rail_op_descs[rail]) {
+        bytes += op_desc.len;
+      }
+      TransferCompleteInfo complete_info{type, complete_handle, rails[rail], rail, bytes, start_time, start_time};
+      complete_handle_list.push_back(complete_info);
     }
-    TransferCompleteInfo complete_info{type, complete_handle};
-    complete_handle_list.push_back(complete_info);
   }
   return SUCCESS;
 }
 
-Status HixlClient::TransferAsync(const std::vector<TransferOpDesc> &op_descs, TransferOp operation, TransferReq &req) {
+// 调用者需持有 client_handles_mutex_
+// 部分链路下发失败时，已下发的批次仍在读写用户内存，等它们结束后再返回错误
+void HixlClient::WaitPostedBatches(const std::vector<TransferCompleteInfo> &posted) {
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto &complete_info : posted) {
+    int32_t query_status = BatchTransferStatus::WAITING;
+    while (query_status == BatchTransferStatus::WAITING) {
+      if (QueryCompleteStatus(complete_info, query_status) != SUCCESS) {
+        HIXL_LOGW("HixlClient query posted batch failed, type:%s, rail:%zu", CommTypeToString(complete_info.type),
+                  complete_info.rail);
+        break;
+      }
+      const auto cost =
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+      if ((query_status == BatchTransferStatus::WAITING) && (cost >= kPostedBatchWaitTimeoutMs)) {
+        HIXL_LOGW("HixlClient wait posted batch timeout, type:%s, rail:%zu", CommTypeToString(complete_info.type),
+                  complete_info.rail);
+        return;
+      }
+      if (query_status == BatchTransferStatus::WAITING) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+}
+
+Status HixlClient::PostBatch(HixlClientHandle handle, const std::vector<TransferOpDesc> &op_descs,
+                             TransferOp operation, void *&complete_handle) const {
+  uint32_t list_num = op_descs.size();
+  std::vector<void *> remote_buff_list(list_num);
+  std::vector<void *> local_buff_list(list_num);
+  std::vector<uint64_t> len_list(list_num);
+  for (size_t i = 0; i < op_descs.size(); i++) {
+    remote_buff_list[i] = reinterpret_cast<void *>(op_descs[i].remote_addr);
+    local_buff_list[i] = reinterpret_cast<void *>(op_descs[i].local_addr);
+    len_list[i] = op_descs[i].len;
+  }
+  if (operation == WRITE) {
+    HIXL_CHK_STATUS_RET(
+        HixlCSClientBatchPut(handle, list_num, remote_buff_list.data(),
+                             const_cast<const void **>(local_buff_list.data()), len_list.data(), &complete_handle),
+        "HixlClient BatchPut failed");
+  } else {
+    HIXL_CHK_STATUS_RET(
+        HixlCSClientBatchGet(handle, list_num, local_buff_list.data(),
+                             const_cast<const void **>(remote_buff_list.data()), len_list.data(), &complete_handle),
+        "HixlClient BatchGet failed");
+  }
+  return SUCCESS;
+}
+
+// 调用者需持有 client_handles_mutex_
+Status HixlClient::QueryCompleteStatus(const TransferCompleteInfo &complete_info, int32_t &query_status) {
+  if (complete_info.type != COMM_TYPE_SHM) {
+    return HixlCSClientQueryCompleteStatus(complete_info.client_handle, complete_info.complete_handle, &query_status);
+  }
+  HIXL_CHK_BOOL_RET_STATUS(shm_importer_ != nullptr, FAILED, "HixlClient shm importer is released");
+  bool completed = false;
+  HIXL_CHK_STATUS_RET(shm_importer_->QueryCompleteStatus(complete_info.complete_handle, completed),
+                      "HixlClient query shm transfer failed");
+  query_status = completed ? BatchTransferStatus::COMPLETED : BatchTransferStatus::WAITING;
+  return SUCCESS;
+}
+
+// 调用者需持有 client_handles_mutex_
+// 完成时间只能通过轮询得知，取最后一次等待与本次完成两次轮询的中点，两次轮询间隔相对耗时过大时不采样
+void HixlClient::RecordRailTransfer(const TransferCompleteInfo &complete_info,
+                                    std::chrono::steady_clock::time_point poll_time) {
+  auto striper_it = rail_stripers_.find(complete_info.type);
+  if (striper_it == rail_stripers_.end()) {
+    return;
+  }
+  const auto window = poll_time - complete_info.last_poll_time;
+  const auto cost = std::chrono::duration_cast<std::chrono::microseconds>(
+      complete_info.last_poll_time - complete_info.start_time + window / 2).count();
+  const auto window_us = std::chrono::duration_cast<std::chrono::microseconds>(window).count();
+  if ((cost <= 0) || (window_us * kMaxPollWindowShare > cost)) {
+    return;
+  }
+  striper_it->second->RecordTransfer(complete_info.rail, complete_info.bytes, static_cast<uint64_t>(cost));
+}
+
+Status HixlClient::TransferAsync(const std::vector<TransferOpDesc> &op_descs, TransferOp operation, TransferReq &req,
+                                 TransferPriority priority) {
   if (op_descs.empty()) {
     HIXL_LOGE(PARAM_INVALID, "HixlClient TransferAsync failed, op_descs is empty");
     return PARAM_INVALID;
   }
+  HIXL_TRACE_REQUEST("HixlClient::TransferAsync", TraceRecorder::GetInstance().NewRequestId());
   // 启动传输
   std::vector<TransferCompleteInfo> complete_handle_list;
-  HIXL_CHK_STATUS_RET(BatchTransfer(op_descs, operation, complete_handle_list), "HixlClient TransferAsync failed");
-  req = complete_handle_list[0].complete_handle;
+  HIXL_CHK_STATUS_RET(BatchTransfer(op_descs, operation, priority, complete_handle_list),
+                      "HixlClient TransferAsync failed");
+  // 条带化时各链路的完成句柄完成即释放，地址可能被复用，不能作为请求标识
+  req = reinterpret_cast<TransferReq>(static_cast<uintptr_t>(next_req_id_.fetch_add(1U)));
   std::lock_guard<std::mutex> lock(complete_handles_mutex_);
   complete_handles_[req] = complete_handle_list;
   return SUCCESS;
@@ -703,16 +933,20 @@ Status HixlClient::GetTransferStatus(const TransferReq &req, TransferStatus &sta
   }
   std::vector<TransferCompleteInfo> complete_handle_list = it->second;
 
-  // 查询状态
+  // 查询状态，已完成的handle不再重复查询
   bool all_complete = true;
-  for (const auto &type_with_complete_handle : complete_handle_list) {
-    auto type = type_with_complete_handle.type;
-    auto complete_handle = type_with_complete_handle.complete_handle;
+  std::vector<TransferCompleteInfo> remaining_handles;
+  for (auto &type_with_complete_handle : complete_handle_list) {
     int32_t query_status = -1;
     Status ret = SUCCESS;
     {
       std::lock_guard<std::mutex> client_lock(client_handles_mutex_);
-      ret = HixlCSClientQueryCompleteStatus(client_handles_[type], complete_handle, &query_status);
+      ret = QueryCompleteStatus(type_with_complete_handle, query_status);
+      const auto poll_time = std::chrono::steady_clock::now();
+      if ((ret == SUCCESS) && (query_status == BatchTransferStatus::COMPLETED)) {
+        RecordRailTransfer(type_with_complete_handle, poll_time);
+      }
+      type_with_complete_handle.last_poll_time = poll_time;
     }
     if (ret != SUCCESS) {
       HIXL_LOGE(ret, "HixlClient QueryCompleteStatus failed");
@@ -723,6 +957,7 @@ Status HixlClient::GetTransferStatus(const TransferReq &req, TransferStatus &sta
     if (query_status == BatchTransferStatus::COMPLETED) {
       continue;
     } else if (query_status == BatchTransferStatus::WAITING) {
+      remaining_handles.push_back(type_with_complete_handle);
       all_complete = false;
     }
   }
@@ -733,22 +968,25 @@ Status HixlClient::GetTransferStatus(const TransferReq &req, TransferStatus &sta
     return SUCCESS;
   } else {
     HIXL_LOGI("Transfer async request not completed");
+    it->second = std::move(remaining_handles);
     status = TransferStatus::WAITING;
     return SUCCESS;
   }
 }
 
 Status HixlClient::TransferSync(const std::vector<TransferOpDesc> &op_descs, TransferOp operation,
-                                uint32_t timeout_ms) {
+                                uint32_t timeout_ms, TransferPriority priority) {
   if (op_descs.empty()) {
     HIXL_LOGE(PARAM_INVALID, "HixlClient TransferSync failed, op_descs is empty");
     return PARAM_INVALID;
   }
+  HIXL_TRACE_REQUEST("HixlClient::TransferSync", TraceRecorder::GetInstance().NewRequestId());
   const auto start = std::chrono::steady_clock::now();
 
   // 启动传输
   std::vector<TransferCompleteInfo> complete_handle_list;
-  HIXL_CHK_STATUS_RET(BatchTransfer(op_descs, operation, complete_handle_list), "HixlClient TransferSync failed");
+  HIXL_CHK_STATUS_RET(BatchTransfer(op_descs, operation, priority, complete_handle_list),
+                      "HixlClient TransferSync failed");
 
   // 在超时时间内等待传输完成
   while (true) {
@@ -767,14 +1005,17 @@ Status HixlClient::TransferSync(const std::vector<TransferOpDesc> &op_descs, Tra
     // 保存未完成的handle，已完成的将被移除
     std::vector<TransferCompleteInfo> remaining_handles;
     bool all_complete = true;
-    for (const auto &type_with_complete_handle : complete_handle_list) {
-      auto type = type_with_complete_handle.type;
-      auto complete_handle = type_with_complete_handle.complete_handle;
+    for (auto &type_with_complete_handle : complete_handle_list) {
       int32_t query_status = -1;
       {
         std::lock_guard<std::mutex> lock(client_handles_mutex_);
-        HIXL_CHK_STATUS_RET(HixlCSClientQueryCompleteStatus(client_handles_[type], complete_handle, &query_status),
+        HIXL_CHK_STATUS_RET(QueryCompleteStatus(type_with_complete_handle, query_status),
                             "HixlClient QueryCompleteStatus failed");
+        const auto poll_time = std::chrono::steady_clock::now();
+        if (query_status == BatchTransferStatus::COMPLETED) {
+          RecordRailTransfer(type_with_complete_handle, poll_time);
+        }
+        type_with_complete_handle.last_poll_time = poll_time;
       }
       if (query_status == BatchTransferStatus::WAITING) {
         // 传输未完成，保存到剩余列表
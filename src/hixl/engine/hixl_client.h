@@ -11,7 +11,10 @@
 #ifndef CANN_HIXL_SRC_HIXL_ENGINE_HIXL_CLIENT_H_
 #define CANN_HIXL_SRC_HIXL_ENGINE_HIXL_CLIENT_H_
 
+#include <chrono>
 #include <cstdint>
+#include <memory>
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -20,6 +23,9 @@
 #include "common/hixl_inner_types.h"
 #include "common/segment.h"
 #include "common/ctrl_msg.h"
+#include "common/priority_mutex.h"
+#include "common/rail_striper.h"
+#include "common/shm_transport.h"
 #include "nlohmann/json.hpp"
 
 namespace hixl {
@@ -30,7 +36,8 @@ enum CommType {
   COMM_TYPE_UB_D2H,
   COMM_TYPE_UB_H2H,
   COMM_TYPE_ROCE,
-  COMM_TYPE_HCCS
+  COMM_TYPE_HCCS,
+  COMM_TYPE_SHM  // 同机 host 到 host 直接拷贝，排在最后使异步请求优先以 cs 完成句柄作为 req
 };
 
 struct MatchKey {
@@ -85,6 +92,12 @@ struct MatchKey {
 struct TransferCompleteInfo {
   CommType type;
   void *complete_handle;
+  HixlClientHandle client_handle = nullptr;  // cs client the batch was posted to
+  size_t rail = 0U;                          // index of that client among the rails of type
+  uint64_t bytes = 0U;
+  std::chrono::steady_clock::time_point start_time{};
+  // last poll that still saw the batch waiting, completion happened between it and the poll that saw it done
+  std::chrono::steady_clock::time_point last_poll_time{};
 };
 
 class HixlClient {
@@ -130,18 +143,22 @@ class HixlClient {
    * @param [in] op_descs         批量操作的本地以及远端地址以及读取内存大小，批量操作的个数
    * @param [in] operation        读操作/写操作
    * @param [in] timeout_ms       超时时间
+   * @param [in] priority         传输优先级，HIGH 优先于排队中的 NORMAL 请求下发
    * @return 操作结果状态码
    */
-  Status TransferSync(const std::vector<TransferOpDesc> &op_descs, TransferOp operation, uint32_t timeout_ms);
+  Status TransferSync(const std::vector<TransferOpDesc> &op_descs, TransferOp operation, uint32_t timeout_ms,
+                      TransferPriority priority = TransferPriority::NORMAL);
 
   /**
    * @brief 异步传输
    * @param [in] op_descs         批量操作的本地以及远端地址以及写入内存大小，批量操作的个数
    * @param [in] operation        读操作/写操作
    * @param [out] req             请求的handle，用于查询请求状态
+   * @param [in] priority         传输优先级，HIGH 优先于排队中的 NORMAL 请求下发
    * @return 操作结果状态码
    */
-  Status TransferAsync(const std::vector<TransferOpDesc> &op_descs, TransferOp operation, TransferReq &req);
+  Status TransferAsync(const std::vector<TransferOpDesc> &op_descs, TransferOp operation, TransferReq &req,
+                       TransferPriority priority = TransferPriority::NORMAL);
 
   /**
    * @brief 查询异步传输状态
@@ -190,27 +207,57 @@ class HixlClient {
   Status ClassifyTransfers(const std::vector<TransferOpDesc> &op_descs,
                            std::map<CommType, std::vector<TransferOpDesc>> &op_descs_table);
 
-  Status BatchTransfer(const std::vector<TransferOpDesc> &op_descs, TransferOp operation,
+  Status BatchTransfer(const std::vector<TransferOpDesc> &op_descs, TransferOp operation, TransferPriority priority,
                        std::vector<TransferCompleteInfo> &complete_handle_list);
 
   Status ProcessRemoteMem(uint32_t timeout_ms);
 
   Status RegisterMemToCsClient(const MemDesc &mem, const MemType type);
 
-  Status UnregisterMemToCsClient(CommType type, const std::vector<MemHandle> &mem_handles);
+  Status UnregisterMemToCsClient(HixlClientHandle handle, const std::vector<MemHandle> &mem_handles);
+
+  // 多链路条带化：额外匹配同类型的端点对，大批量传输按链路带宽切分
+  Status TryMatchExtraRoceRails(const std::vector<EndPointConfig> &local_endpoint_list,
+                                const std::vector<EndPointConfig> &remote_endpoint_list);
+
+  void SetupRailStripers();
+
+  // 调用者需持有 client_handles_mutex_，第一个元素为 client_handles_ 中的主链路
+  std::vector<HixlClientHandle> GetRailHandles(CommType type) const;
+
+  Status PostBatch(HixlClientHandle handle, const std::vector<TransferOpDesc> &op_descs, TransferOp operation,
+                   void *&complete_handle) const;
+
+  void RecordRailTransfer(const TransferCompleteInfo &complete_info, std::chrono::steady_clock::time_point poll_time);
+  void WaitPostedBatches(const std::vector<TransferCompleteInfo> &posted);
+
+  // 调用者需持有 client_handles_mutex_
+  Status QueryCompleteStatus(const TransferCompleteInfo &complete_info, int32_t &query_status);
+
+  // 取出远端 shm 端点，同机且双方开启时记录下来，在 Connect 时导入远端 host 内存
+  void ExtractShmEndPoint(std::vector<EndPointConfig> &remote_endpoint_list);
 
   std::string server_ip_;
   uint32_t server_port_;
   bool is_connected_{false};  // true为已建链；false未建链
   bool is_finalized_{false};
   std::map<CommType, HixlClientHandle> client_handles_;  // ub链路时会创建4个 cs_client，roce链路会创建1个 cs_client
+  std::map<CommType, std::vector<HixlClientHandle>> extra_rail_handles_;  // 开启条带化时每种类型除主链路外的链路
+  std::map<CommType, std::unique_ptr<RailStriper>> rail_stripers_;         // 有多条链路的类型的切分器
+  RailStripeConfig stripe_config_;
+  ShmTransportConfig shm_config_;
+  std::unique_ptr<EndPointConfig> shm_endpoint_;  // 同机 server 的 shm 端点
+  std::unique_ptr<ShmImporter> shm_importer_;     // 建链成功后用于同机 H2H 传输
   std::map<TransferReq, std::vector<TransferCompleteInfo>> complete_handles_;  // 保存异步传输的完成句柄
-  std::map<CommType, std::vector<MemHandle>> client_mem_handles_;              // 每种类型 cs client 注册的内存句柄
+  // 异步请求编号，从1开始递增，各 client 共用以保证 HixlEngine 按 req 区分 client
+  static std::atomic<uint64_t> next_req_id_;
+  std::map<HixlClientHandle, std::vector<MemHandle>> client_mem_handles_;      // 每个 cs client 注册的内存句柄
   std::vector<SegmentPtr> local_segments_;  // 内存段数组，包含 MEM_DEVICE and MEM_HOST 两种 std::shared_ptr<Segment>
   std::vector<SegmentPtr> remote_segments_;
 
   std::mutex status_mutex_;            // 保护is_connected_和is_finalized_
   std::mutex client_handles_mutex_;    // 保护client_handles_
+  PriorityMutex submit_mutex_;         // 串行化批量下发，HIGH 请求越过排队中的 NORMAL 请求
   std::mutex complete_handles_mutex_;  // 保护complete_handles_
   std::mutex mem_handles_mutex_;       // 保护client_mem_handles_
   std::mutex local_segments_mutex_;    // 保护local_segments_
@@ -92,11 +92,12 @@ Status HixlEngine::Disconnect(const AscendString &remote_engine, int32_t timeout
 }
 
 Status HixlEngine::TransferSync(const AscendString &remote_engine, TransferOp operation,
-                                const std::vector<TransferOpDesc> &op_descs, int32_t timeout_in_millis) {
+                                const std::vector<TransferOpDesc> &op_descs, const TransferArgs &optional_args,
+                                int32_t timeout_in_millis) {
   ClientPtr client_ptr_ = client_manager_.GetClient(remote_engine.GetString());
   HIXL_CHECK_NOTNULL(client_ptr_, "Failed to get client through remote engine, remote_engine:%s",
                      remote_engine.GetString());
-  HIXL_CHK_STATUS_RET(client_ptr_->TransferSync(op_descs, operation, timeout_in_millis),
+  HIXL_CHK_STATUS_RET(client_ptr_->TransferSync(op_descs, operation, timeout_in_millis, optional_args.priority),
                       "Failed to TransferSync, remote_engine:%s, timeout:%d ms", remote_engine.GetString(),
                       timeout_in_millis);
   return SUCCESS;
@@ -105,12 +106,11 @@ Status HixlEngine::TransferSync(const AscendString &remote_engine, TransferOp op
 Status HixlEngine::TransferAsync(const AscendString &remote_engine, TransferOp operation,
                                  const std::vector<TransferOpDesc> &op_descs, const TransferArgs &optional_args,
                                  TransferReq &req) {
-  (void)optional_args;
   ClientPtr client_ptr_ = client_manager_.GetClient(remote_engine.GetString());
   HIXL_CHECK_NOTNULL(client_ptr_, "Failed to get client through remote engine, remote_engine:%s",
                      remote_engine.GetString());
-  HIXL_CHK_STATUS_RET(client_ptr_->TransferAsync(op_descs, operation, req), "Failed to TransferSync, remote_engine:%s",
-                      remote_engine.GetString());
+  HIXL_CHK_STATUS_RET(client_ptr_->TransferAsync(op_descs, operation, req, optional_args.priority),
+                      "Failed to TransferSync, remote_engine:%s", remote_engine.GetString());
   auto id = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(req));
   std::lock_guard<std::mutex> lock(mutex_);
   req2client_.emplace(id, remote_engine);
@@ -86,18 +86,20 @@ class HixlEngine : public hixl::Engine {
    * @param [in] remote_engine 远端HixlEngine的唯一标识
    * @param [in] operation 将远端内存读到本地或者将本地内存写到远端
    * @param [in] op_descs 批量操作的本地以及远端地址
+   * @param [in] optional_args 可选参数，priority为HIGH时优先下发
    * @param [in] timeout_in_millis 断链的超时时间，单位ms
    * @return 成功:SUCCESS, 失败:其它.
    */
   Status TransferSync(const AscendString &remote_engine, TransferOp operation,
-                      const std::vector<TransferOpDesc> &op_descs, int32_t timeout_in_millis) override;
+                      const std::vector<TransferOpDesc> &op_descs, const TransferArgs &optional_args,
+                      int32_t timeout_in_millis) override;
 
   /**
    * @brief 批量异步传输，下发传输请求
    * @param [in] remote_engine 远端Hixl的唯一标识
    * @param [in] operation 将远端内存读到本地或者将本地内存写到远端
    * @param [in] op_descs 批量操作的本地以及远端地址
-   * @param [in] optional_args 可选参数，预留
+   * @param [in] optional_args 可选参数，priority为HIGH时优先下发
    * @param [out] req 请求的handle，用于查询请求状态
    * @return 成功:SUCCESS, 失败:其它.
    */
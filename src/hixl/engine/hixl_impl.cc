@@ -12,6 +12,7 @@
 #include "hixl/hixl.h"
 #include "common/hixl_checker.h"
 #include "common/hixl_utils.h"
+#include "common/shm_transport.h"
 #include "adxl_engine.h"
 #include "base/err_msg.h"
 #include "engine.h"
@@ -52,6 +53,7 @@ class Hixl::HixlImpl {
   Status TransferSync(const AscendString &remote_engine,
                       TransferOp operation,
                       const std::vector<TransferOpDesc> &op_descs,
+                      const TransferArgs &optional_args,
                       int32_t timeout_in_millis = 1000);
 
   Status TransferAsync(const AscendString &remote_engine,
@@ -117,11 +119,12 @@ Status Hixl::HixlImpl::Disconnect(const AscendString &remote_engine, int32_t tim
 Status Hixl::HixlImpl::TransferSync(const AscendString &remote_engine,
                                     TransferOp operation,
                                     const std::vector<TransferOpDesc> &op_descs,
+                                    const TransferArgs &optional_args,
                                     int32_t timeout_in_millis) {
   HIXL_CHK_BOOL_RET_STATUS(engine_->IsInitialized(), FAILED, "Hixl is not initialized");
   HIXL_CHK_STATUS_RET(CheckTransferOpDescs(op_descs), "Failed to check transfer op descs");
   HIXL_CHK_STATUS_RET(engine_->TransferSync(remote_engine, operation,
-                                            op_descs, timeout_in_millis),
+                                            op_descs, optional_args, timeout_in_millis),
                                             "Failed to transfer sync.");
   return SUCCESS;
 }
@@ -213,6 +216,24 @@ Status Hixl::DeregisterMem(MemHandle mem_handle) {
   return SUCCESS;
 }
 
+Status Hixl::MallocHostMem(size_t size, void *&ptr) {
+  HIXL_LOGI("MallocHostMem start, size:%zu", size);
+  // 不依赖引擎, 可在Initialize前申请
+  const auto ret = ShmHostMemory::Alloc(size, ptr);
+  HIXL_CHK_BOOL_RET_STATUS(ret == SUCCESS, ret, "Failed to malloc host mem, size:%zu", size);
+  HIXL_LOGI("MallocHostMem success, addr:%p, size:%zu", ptr, size);
+  return SUCCESS;
+}
+
+Status Hixl::FreeHostMem(void *ptr) {
+  HIXL_LOGI("FreeHostMem start, addr:%p", ptr);
+  HIXL_CHK_BOOL_RET_STATUS(ptr != nullptr, PARAM_INVALID, "ptr can not be null");
+  const auto ret = ShmHostMemory::Free(ptr);
+  HIXL_CHK_BOOL_RET_STATUS(ret == SUCCESS, ret, "Failed to free host mem, addr:%p", ptr);
+  HIXL_LOGI("FreeHostMem success, addr:%p", ptr);
+  return SUCCESS;
+}
+
 Status Hixl::Connect(const AscendString &remote_engine, int32_t timeout_in_millis) {
   HIXL_LOGI("Connect start, remote engine:%s, timeout:%d ms", remote_engine.GetString(), timeout_in_millis);
   HIXL_CHK_BOOL_RET_STATUS(impl_ != nullptr, FAILED, "impl is nullptr, check Hixl init");
@@ -241,11 +262,20 @@ Status Hixl::TransferSync(const AscendString &remote_engine,
                                 TransferOp operation,
                                 const std::vector<TransferOpDesc> &op_descs,
                                 int32_t timeout_in_millis) {
-  HIXL_LOGI("TransferSync start, remote_engine:%s, operation:%d, op_descs size:%zu, timeout:%d ms",
-         remote_engine.GetString(), static_cast<int32_t>(operation), op_descs.size(), timeout_in_millis);
+  return TransferSync(remote_engine, operation, op_descs, TransferArgs{}, timeout_in_millis);
+}
+
+Status Hixl::TransferSync(const AscendString &remote_engine,
+                          TransferOp operation,
+                          const std::vector<TransferOpDesc> &op_descs,
+                          const TransferArgs &optional_args,
+                          int32_t timeout_in_millis) {
+  HIXL_LOGI("TransferSync start, remote_engine:%s, operation:%d, op_descs size:%zu, timeout:%d ms, priority:%d",
+         remote_engine.GetString(), static_cast<int32_t>(operation), op_descs.size(), timeout_in_millis,
+         static_cast<int32_t>(optional_args.priority));
   HIXL_CHK_BOOL_RET_STATUS(impl_ != nullptr, FAILED, "impl is nullptr, check Hixl init");
   HIXL_CHK_BOOL_RET_STATUS(timeout_in_millis > 0, PARAM_INVALID, "timeout_in_millis:%d must > 0", timeout_in_millis);
-  const auto ret = impl_->TransferSync(remote_engine, operation, op_descs, timeout_in_millis);
+  const auto ret = impl_->TransferSync(remote_engine, operation, op_descs, optional_args, timeout_in_millis);
   HIXL_CHK_BOOL_RET_STATUS(ret == SUCCESS, ret,
                            "Failed to TransferSync, remote_engine:%s, operation:%d, op_descs size:%zu, timeout:%d ms",
                            remote_engine.GetString(), static_cast<int32_t>(operation),
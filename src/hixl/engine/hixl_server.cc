@@ -40,12 +40,22 @@ Status HixlServer::Initialize(const std::string &ip, int32_t port,
                       &config, &server_handle_));
   //port > 0 初始化hixl server，否则作为hixl client注册内存用
   if (port > 0) {
+    ShmTransportConfig shm_config{};
+    HIXL_CHK_STATUS_RET(LoadShmTransportConfigFromEnv(shm_config), "Failed to load shm transport config.");
+    if (shm_config.enable && (shm_exporter_.Initialize() != SUCCESS)) {
+      HIXL_LOGW("Failed to initialize shm exporter, same host clients use the data endpoints.");
+    }
     //注册回调函数且监听端口
     MsgProcessor send_endpoint_cb = [this](int32_t fd, const char *msg, uint64_t msg_len) -> Status {
       (void)msg;
       (void)msg_len;
+      // shm 端点放在列表末尾，不识别该协议的 client 会跳过
+      std::vector<EndPointConfig> endpoint_list = data_endpoint_config_list_;
+      if (shm_exporter_.IsInitialized()) {
+        endpoint_list.emplace_back(shm_exporter_.GetEndPointConfig());
+      }
       std::string msg_str;
-      HIXL_CHK_STATUS_RET(SerializeEndPointConfigList(data_endpoint_config_list_, msg_str),
+      HIXL_CHK_STATUS_RET(SerializeEndPointConfigList(endpoint_list, msg_str),
                           "Failed to serialize endpoint config.");
       CtrlMsgHeader header{};
       header.magic = kMagicNumber;
@@ -96,6 +106,9 @@ Status HixlServer::RegisterMem(const MemDesc &mem, MemType type, MemHandle &mem_
                       "Failed to register mem, addr:0x%lx, size:%lu, type:%d.",
                       mem.addr, mem.len, static_cast<int32_t>(type));
   handle_to_addr_[mem_handle] = cur_info;
+  if ((type == MemType::MEM_HOST) && shm_exporter_.IsInitialized()) {
+    shm_exporter_.AddRegion(mem.addr, mem.len);
+  }
   return SUCCESS;
 }
 
@@ -108,6 +121,10 @@ Status HixlServer::DeregisterMem(MemHandle &mem_handle) {
     HIXL_LOGW("mem_handle:%p is not registered.", mem_handle);
     return SUCCESS;
   }
+  // 先撤销 shm 导出，同机 client 不再对该内存发起新的拷贝
+  if (it->second.mem_type == MemType::MEM_HOST) {
+    shm_exporter_.RemoveRegion(it->second.start_addr);
+  }
   HIXL_CHK_STATUS_RET(HixlCSServerUnregMem(server_handle_, mem_handle), "Failed to deregister mem, handle:%p.",
                       mem_handle);
   handle_to_addr_.erase(it);
@@ -129,6 +146,7 @@ Status HixlServer::Finalize() {
     }
   }
   handle_to_addr_.clear();
+  shm_exporter_.Finalize();
   HIXL_CHK_STATUS_RET(HixlCSServerDestroy(server_handle_), "Failed to destroy hixl server.");
   server_handle_ = nullptr;
   return SUCCESS;
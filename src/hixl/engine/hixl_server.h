@@ -16,6 +16,7 @@
 #include <map>
 #include "hixl/hixl_types.h"
 #include "common/hixl_inner_types.h"
+#include "common/shm_transport.h"
 
 namespace hixl {
 
@@ -64,6 +65,7 @@ class HixlServer {
     std::vector<EndPointConfig> data_endpoint_config_list_;
     std::mutex mtx_;
     std::map<MemHandle, AddrInfo> handle_to_addr_;
+    ShmExporter shm_exporter_;  // 开启同机共享内存传输时向同机 client 导出 host 内存
 };
 }// namespace hixl
 
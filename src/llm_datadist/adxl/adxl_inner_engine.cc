@@ -135,6 +135,7 @@ Status AdxlInnerEngine::Initialize(const std::map<AscendString, AscendString> &o
     aclrt_context_ = nullptr;
   }));
   ADXL_CHK_STATUS_RET(ParseEnableFabricMem(options), "Failed to parse option.");
+  ADXL_CHK_STATUS_RET(ParseBufferCompression(options, buffer_codec_), "Failed to parse buffer compression.");
   if (enable_use_fabric_mem_) {
     ADXL_CHK_STATUS_RET(VirtualMemoryManager::GetInstance().Initialize(), "Failed to initialize virtual memory manager.");
     fabric_mem_transfer_service_ = llm::MakeUnique<FabricMemTransferService>();
@@ -201,6 +202,21 @@ void AdxlInnerEngine::ParseBufferPool(const std::map<AscendString, AscendString>
   }
 }
 
+Status AdxlInnerEngine::ParseBufferCompression(const std::map<AscendString, AscendString> &options,
+                                               KvCodecType &codec) {
+  auto it = options.find(hixl::OPTION_BUFFER_COMPRESSION);
+  if (it == options.cend()) {
+    it = options.find(adxl::OPTION_BUFFER_COMPRESSION);
+  }
+  if (it != options.cend()) {
+    ADXL_CHK_STATUS_RET(KvCodec::ParseType(it->second.GetString(), codec), "Option %s is invalid.",
+                        hixl::OPTION_BUFFER_COMPRESSION);
+    LLMEVENT("Buffer compression is %s%s.", KvCodec::TypeToString(codec),
+             KvCodec::IsLossy(codec) ? ", only for transfers that allow lossy compression" : "");
+  }
+  return SUCCESS;
+}
+
 Status AdxlInnerEngine::ParseBufferPoolParams(const std::map<AscendString, AscendString> &options,
                                               uint64_t &buffer_size, uint64_t &npu_pool_size) {
   std::string pool_config;
@@ -285,7 +301,8 @@ Status AdxlInnerEngine::InitBufferTransferService(const std::map<ge::AscendStrin
   for (auto &mem_pool : npu_mem_pools_) {
     mem_pools.emplace_back(mem_pool.get());
   }
-  buffer_transfer_service_ = llm::MakeUnique<BufferTransferService>(mem_pools, buffer_size * kBaseBufferSize);
+  buffer_transfer_service_ =
+      llm::MakeUnique<BufferTransferService>(mem_pools, buffer_size * kBaseBufferSize, buffer_codec_);
   ADXL_CHK_STATUS_RET(buffer_transfer_service_->Initialize(), "Failed to initialize buffer transfer service.");
   LLM_DISMISS_GUARD(failed_guard);
   LLMLOGI("Init buffer transfer service suc.");
@@ -376,13 +393,14 @@ Status AdxlInnerEngine::GetTransferType(const ChannelPtr &channel, TransferOp op
   ADXL_CHK_BOOL_RET_STATUS(segment_table_ != nullptr, FAILED, "Segment table is null.");
   for (size_t i = 0; i < op_descs.size(); i++) {
     auto &op_desc = op_descs[i];
-    auto local_segment =
-        segment_table_->FindSegment(local_engine_, op_desc.local_addr, op_desc.local_addr + op_desc.len);
-    MemType local_mem_type = local_segment != nullptr ? local_segment->GetMemType() : MemType::MEM_HOST;
-    auto remote_segment =
-        segment_table_->FindSegment(channel->GetChannelId(), op_desc.remote_addr, op_desc.remote_addr + op_desc.len);
-    MemType remote_mem_type = remote_segment != nullptr ? remote_segment->GetMemType() : MemType::MEM_HOST;
-    need_buffer = need_buffer || ((local_segment == nullptr) || (remote_segment == nullptr));
+    MemType local_mem_type = MemType::MEM_HOST;
+    const bool local_found =
+        segment_table_->FindMemType(local_engine_, op_desc.local_addr, op_desc.local_addr + op_desc.len,
+                                    local_mem_type);
+    MemType remote_mem_type = MemType::MEM_HOST;
+    const bool remote_found = segment_table_->FindMemType(channel->GetChannelId(), op_desc.remote_addr,
+                                                          op_desc.remote_addr + op_desc.len, remote_mem_type);
+    need_buffer = need_buffer || (!local_found || !remote_found);
 
     TransferType cur_type;
     if (operation == TransferOp::READ) {
@@ -454,6 +472,7 @@ Status AdxlInnerEngine::ConnectWhenTransfer(const AscendString &remote_engine, i
 Status AdxlInnerEngine::TransferSync(const AscendString &remote_engine,
                                      TransferOp operation,
                                      const std::vector<TransferOpDesc> &op_descs,
+                                     const TransferArgs &optional_args,
                                      int32_t timeout_in_millis) {
   llm::TemporaryRtContext with_context(aclrt_context_);
   if (user_config_channel_pool_) {
@@ -471,8 +490,9 @@ Status AdxlInnerEngine::TransferSync(const AscendString &remote_engine,
       channel->DecrementTransferCount();
     }
   }));
+  const bool high_priority = (optional_args.priority == TransferPriority::HIGH);
   if (fabric_mem_transfer_service_ != nullptr) {
-    std::lock_guard<std::mutex> transfer_lock(channel->GetTransferMutex());
+    hixl::PriorityLockGuard transfer_lock(channel->GetTransferMutex(), high_priority);
     auto ret = fabric_mem_transfer_service_->Transfer(channel, operation, op_descs, timeout_in_millis);
     ADXL_CHK_BOOL_RET_STATUS(ret != ACL_ERROR_RT_SUSPECT_REMOTE_ERROR, ACL_ERROR_RT_SUSPECT_REMOTE_ERROR,
                              "Probably caused by temporary sdma error, please try again.");
@@ -489,11 +509,12 @@ Status AdxlInnerEngine::TransferSync(const AscendString &remote_engine,
     if (need_buffer) {
       ADXL_CHK_BOOL_RET_STATUS(type != TransferType::kEnd, PARAM_INVALID, "Transfer type is invalid.");
       // do not need lock, add lock inner
-      return buffer_transfer_service_->Transfer(channel, type, op_descs, timeout_in_millis);
+      return buffer_transfer_service_->Transfer(channel, type, op_descs, timeout_in_millis,
+                                                optional_args.allow_lossy_compression);
     }
   }
-  std::lock_guard<std::mutex> transfer_lock(channel->GetTransferMutex());
-  ADXL_CHK_STATUS_RET(channel->TransferSync(operation, op_descs, timeout_in_millis),
+  hixl::PriorityLockGuard transfer_lock(channel->GetTransferMutex(), high_priority);
+  ADXL_CHK_STATUS_RET(channel->TransferSync(operation, op_descs, timeout_in_millis, optional_args.priority),
                       "Failed to transfer sync, remote_engine:%s", remote_engine.GetString());
   return SUCCESS;
 }
@@ -512,7 +533,8 @@ Status AdxlInnerEngine::TransferAsync(const AscendString &remote_engine,
                            "Failed to get channel, remote_engine:%s", remote_engine.GetString());
   auto id = next_req_id_.fetch_add(1);
   req = reinterpret_cast<void *>(static_cast<uintptr_t>(id));
-  std::lock_guard<std::mutex> transfer_lock(channel->GetTransferMutex());
+  hixl::PriorityLockGuard transfer_lock(channel->GetTransferMutex(),
+                                        optional_args.priority == TransferPriority::HIGH);
   if (user_config_channel_pool_) {
     channel->SetHasTransferred(true);
     channel->IncrementTransferCount();
@@ -47,6 +47,7 @@ class AdxlInnerEngine {
   Status TransferSync(const AscendString &remote_engine,
                       TransferOp operation,
                       const std::vector<TransferOpDesc> &op_descs,
+                      const TransferArgs &optional_args,
                       int32_t timeout_in_millis);
 
   Status TransferAsync(const AscendString &remote_engine,
@@ -75,6 +76,7 @@ class AdxlInnerEngine {
   Status ConnectWhenTransfer(const AscendString &remote_engine, int32_t timeout_in_millis = 3000);
   Status ParseBufferPoolParams(const std::map<AscendString, AscendString> &options, uint64_t &buffer_size,
                                uint64_t &npu_pool_size);
+  static Status ParseBufferCompression(const std::map<AscendString, AscendString> &options, KvCodecType &codec);
   Status ParseEnableFabricMem(const std::map<AscendString, AscendString> &options);
 
   std::string local_engine_;
@@ -86,6 +88,7 @@ class AdxlInnerEngine {
   std::vector<void *> npu_pool_memorys_{};
   std::vector<MemHandle> pool_mem_handles_{};
   std::unique_ptr<BufferTransferService> buffer_transfer_service_ = nullptr;
+  KvCodecType buffer_codec_ = KvCodecType::kNone;
   std::unique_ptr<SegmentTable> segment_table_ = nullptr;
   std::unique_ptr<StreamPool> stream_pool_ = nullptr;
   bool user_config_buffer_pool_{false};
@@ -17,9 +17,11 @@
 #include <atomic>
 #include "adxl/adxl_checker.h"
 #include "adxl/adxl_types.h"
+#include "securec.h"
 #include "common/def_types.h"
 #include "base/err_msg.h"
 #include "common/llm_scope_guard.h"
+#include "common/trace_recorder.h"
 #include "statistic_manager.h"
 
 namespace adxl {
@@ -30,15 +32,43 @@ constexpr uint64_t kBlockSize = 512 * 1024U;
 constexpr size_t kServerPoolIndex = 1U;
 constexpr size_t kMemcpyBatchLimit = 4096;
 constexpr size_t kMemcpyBatchMinTime = 100000;
+// one worker per stage, a stage blocked on buffers can not hold back the stages that free them
+constexpr uint32_t kStageWorkerNum = 4U;
+constexpr size_t kPlainScratch = 0U;
+constexpr size_t kEncodedScratch = 1U;
+constexpr size_t kCodecScratchNum = 2U;
+
+// host staging memory of the codec, client threads and stage workers each keep their own
+std::vector<uint8_t> &CodecScratch(size_t index) {
+  thread_local std::vector<uint8_t> scratch[kCodecScratchNum];
+  return scratch[index];
+}
 }  // namespace
 
 Status BufferTransferService::Initialize() {
   ADXL_CHK_ACL_RET(aclrtGetCurrentContext(&aclrt_context_));
   ADXL_CHK_ACL_RET(aclrtGetDevice(&device_id_));
-  buffer_req_processor_ = std::thread([this]() { ProcessBufferReqFirstStep(); });
-  buffer_resp_processor_ = std::thread([this]() { ProcessBufferResp(); });
-  buffer_second_step_processor_ = std::thread([this]() { ProcessBufferReqSecondStep(); });
-  ctrl_msg_processor_ = std::thread([this]() { ProcessCtrlMsg(); });
+  stage_executor_ = llm::MakeUnique<hixl::WorkStealingExecutor>(
+      "adxl_buffer", kStageWorkerNum, [this]() { (void)aclrtSetCurrentContext(aclrt_context_); });
+  ADXL_CHECK_NOTNULL(stage_executor_);
+  auto &executor = *stage_executor_;
+  // responses and control messages release buffers that pending requests wait for, they go first
+  buffer_req_queue_ = llm::MakeUnique<BufferReqQueue>(
+      executor, hixl::TaskPriority::kNormal,
+      [this](std::pair<ChannelPtr, BufferReq> &req) { ProcessBufferReqFirstStep(req); });
+  buffer_resp_queue_ = llm::MakeUnique<BufferRespQueue>(
+      executor, hixl::TaskPriority::kHigh,
+      [this](std::pair<ChannelPtr, BufferResp> &resp) { ProcessBufferResp(resp); });
+  buffer_second_step_queue_ = llm::MakeUnique<BufferReqQueue>(
+      executor, hixl::TaskPriority::kNormal,
+      [this](std::pair<ChannelPtr, BufferReq> &req) { ProcessBufferReqSecondStep(req); });
+  buffer_ctrl_msg_queue_ = llm::MakeUnique<BufferReqQueue>(
+      executor, hixl::TaskPriority::kHigh,
+      [this](std::pair<ChannelPtr, BufferReq> &req) { ProcessCtrlMsg(req); });
+  ADXL_CHECK_NOTNULL(buffer_req_queue_);
+  ADXL_CHECK_NOTNULL(buffer_resp_queue_);
+  ADXL_CHECK_NOTNULL(buffer_second_step_queue_);
+  ADXL_CHECK_NOTNULL(buffer_ctrl_msg_queue_);
   buff_addr_idles_.resize(npu_mem_pools_.size());
   for (size_t i = 0; i < npu_mem_pools_.size(); ++i) {
     auto &npu_mem_pool = npu_mem_pools_[i];
@@ -55,22 +85,8 @@ Status BufferTransferService::Initialize() {
 }
 
 void BufferTransferService::Finalize() {
-  stop_signal_.store(true);
-  buffer_req_cv_.notify_all();
-  if (buffer_req_processor_.joinable()) {
-    buffer_req_processor_.join();
-  }
-  buffer_resp_cv_.notify_all();
-  if (buffer_resp_processor_.joinable()) {
-    buffer_resp_processor_.join();
-  }
-  buffer_second_step_cv_.notify_all();
-  if (buffer_second_step_processor_.joinable()) {
-    buffer_second_step_processor_.join();
-  }
-  ctrl_msg_cv_.notify_all();
-  if (ctrl_msg_processor_.joinable()) {
-    ctrl_msg_processor_.join();
+  if (stage_executor_ != nullptr) {
+    stage_executor_->Stop();
   }
   for (size_t i = 0; i < npu_mem_pools_.size(); ++i) {
     auto &npu_mem_pool = npu_mem_pools_[i];
@@ -81,10 +97,12 @@ void BufferTransferService::Finalize() {
 }
 
 Status BufferTransferService::Transfer(const ChannelPtr &channel, TransferType type,
-                                       const std::vector<TransferOpDesc> &op_descs, int32_t timeout_in_millis) {
+                                       const std::vector<TransferOpDesc> &op_descs, int32_t timeout_in_millis,
+                                       bool allow_lossy_compression) {
   uint64_t timeout = timeout_in_millis * kMillisToMicros;
   const auto start = std::chrono::steady_clock::now();
   auto req_id = next_req_id_.fetch_add(1);
+  HIXL_TRACE_REQUEST("BufferTransferService::Transfer", req_id);
   {
     std::lock_guard<std::mutex> lock(req_id_mutex_);
     req_id_buffers_.emplace(req_id, std::set<void *>());
@@ -100,7 +118,8 @@ Status BufferTransferService::Transfer(const ChannelPtr &channel, TransferType t
       std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
   ADXL_CHK_BOOL_RET_STATUS(time_cost < timeout, TIMEOUT, "Transfer timeout.");
   auto left_timeout = timeout - time_cost;
-  auto ret = DoTransferTask(channel, op_descs, left_timeout, type, req_id);
+  auto ret = DoTransferTask(channel, op_descs, left_timeout, type, req_id,
+                            SelectCodec(channel, type, allow_lossy_compression));
   LLMLOGI("DoTransferTask ret:%d.", ret);
   // wait until timeout to clear task in server
   time_cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
@@ -114,7 +133,7 @@ Status BufferTransferService::Transfer(const ChannelPtr &channel, TransferType t
 }
 
 Status BufferTransferService::DoTransferTask(const ChannelPtr &channel, const std::vector<TransferOpDesc> &op_descs,
-                                             uint64_t timeout, TransferType type, uint64_t req_id) {
+                                             uint64_t timeout, TransferType type, uint64_t req_id, KvCodecType codec) {
   const auto start = std::chrono::steady_clock::now();
   std::vector<TransferOpDesc> current_batch;
   size_t current_batch_size = 0;
@@ -124,13 +143,14 @@ Status BufferTransferService::DoTransferTask(const ChannelPtr &channel, const st
     ADXL_CHK_BOOL_RET_STATUS(time_cost < timeout, TIMEOUT, "Transfer timeout.");
     auto left_timeout = timeout - time_cost;
     if (op_desc.len >= buffer_size_) {
-      ADXL_CHK_STATUS_RET(TransferLargeData(channel, op_desc, left_timeout, req_id, type),
+      ADXL_CHK_STATUS_RET(TransferLargeData(channel, op_desc, left_timeout, req_id, type, codec),
                           "Transfer large data failed");
       continue;
     }
     // small data, add to batch until buffer is full
     if (current_batch_size + op_desc.len > buffer_size_) {
-      ADXL_CHK_STATUS_RET(FlushBatch(channel, current_batch, left_timeout, req_id, type), "Flush batch failed.");
+      ADXL_CHK_STATUS_RET(FlushBatch(channel, current_batch, left_timeout, req_id, type, codec),
+                          "Flush batch failed.");
       current_batch.clear();
       current_batch_size = 0;
     }
@@ -142,7 +162,8 @@ Status BufferTransferService::DoTransferTask(const ChannelPtr &channel, const st
         std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
     ADXL_CHK_BOOL_RET_STATUS(time_cost < timeout, TIMEOUT, "Transfer timeout.");
     auto left_timeout = timeout - time_cost;
-    ADXL_CHK_STATUS_RET(FlushBatch(channel, current_batch, left_timeout, req_id, type), "Flush batch failed.");
+    ADXL_CHK_STATUS_RET(FlushBatch(channel, current_batch, left_timeout, req_id, type, codec),
+                        "Flush batch failed.");
   }
   return SUCCESS;
 }
@@ -164,7 +185,8 @@ Status BufferTransferService::CheckReqFinishStatus(uint64_t timeout, uint64_t re
 }
 
 Status BufferTransferService::FlushBatch(const ChannelPtr &channel, const std::vector<TransferOpDesc> &op_descs,
-                                         uint64_t timeout, uint64_t req_id, TransferType type) {
+                                         uint64_t timeout, uint64_t req_id, TransferType type, KvCodecType codec) {
+  HIXL_TRACE_SPAN_WITH_ID("BufferTransferService::FlushBatch", req_id);
   auto start = std::chrono::steady_clock::now();
   void *dev_buffer;
   ADXL_CHK_STATUS_RET(TryGetBuffer(dev_buffer, timeout), "Failed to get buffer.");
@@ -201,12 +223,22 @@ Status BufferTransferService::FlushBatch(const ChannelPtr &channel, const std::v
   if (type == TransferType::kReadRH2H || type == TransferType::kReadRD2H || type == TransferType::kReadRH2D ||
       type == TransferType::kReadRD2D) {
     buffer_req.src_addrs = std::move(src_addrs);
+    // the peer encodes its host data before staging, see HandleBufferCopy
+    buffer_req.codec = codec;
   } else {
-    auto kind = (type == TransferType::kWriteD2RH || type == TransferType::kWriteD2RD) ? ACL_MEMCPY_DEVICE_TO_DEVICE
-                                                                                       : ACL_MEMCPY_HOST_TO_DEVICE;
-    ADXL_CHK_STATUS_RET(
-        ProcessCopy(channel, src_addrs, buffer_addrs, buffer_req.buffer_lens, std::make_pair(kind, left_timeout)),
-        "Copy failed");
+    if (codec != KvCodecType::kNone) {
+      buffer_req.codec = codec;
+      ADXL_CHK_STATUS_RET(EncodeToBuffer(channel, src_addrs, buffer_req.buffer_lens, buffer_req.buffer_addr,
+                                         left_timeout, buffer_req.codec, buffer_req.encoded_len),
+                          "Encode failed.");
+    }
+    if (buffer_req.codec == KvCodecType::kNone) {
+      auto kind = (type == TransferType::kWriteD2RH || type == TransferType::kWriteD2RD) ? ACL_MEMCPY_DEVICE_TO_DEVICE
+                                                                                         : ACL_MEMCPY_HOST_TO_DEVICE;
+      ADXL_CHK_STATUS_RET(
+          ProcessCopy(channel, src_addrs, buffer_addrs, buffer_req.buffer_lens, std::make_pair(kind, left_timeout)),
+          "Copy failed");
+    }
     time_cost =
         std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
     StatisticManager::GetInstance().UpdateClientCopyCost(channel->GetChannelId(), time_cost);
@@ -216,7 +248,9 @@ Status BufferTransferService::FlushBatch(const ChannelPtr &channel, const std::v
 }
 
 Status BufferTransferService::TransferLargeData(const ChannelPtr &channel, const TransferOpDesc &op_desc,
-                                                uint64_t timeout, uint64_t req_id, TransferType type) {
+                                                uint64_t timeout, uint64_t req_id, TransferType type,
+                                                KvCodecType codec) {
+  HIXL_TRACE_SPAN_WITH_ID("BufferTransferService::TransferLargeData", req_id);
   auto start = std::chrono::steady_clock::now();
   auto left_size = op_desc.len;
   auto addr = op_desc.local_addr;
@@ -240,15 +274,26 @@ Status BufferTransferService::TransferLargeData(const ChannelPtr &channel, const
     left_timeout = timeout - time_cost;
     if (type == TransferType::kWriteH2RH || type == TransferType::kWriteH2RD || type == TransferType::kWriteD2RH ||
         type == TransferType::kWriteD2RD) {
-      auto kind = (type == TransferType::kWriteD2RH || type == TransferType::kWriteD2RD) ? ACL_MEMCPY_DEVICE_TO_DEVICE
-                                                                                         : ACL_MEMCPY_HOST_TO_DEVICE;
-      ADXL_CHK_STATUS_RET(ProcessCopy(channel, buffer_req.src_addrs, buffer_addrs, buffer_req.buffer_lens,
-                                      std::make_pair(kind, left_timeout)),
-                          "Copy failed");
+      if (codec != KvCodecType::kNone) {
+        buffer_req.codec = codec;
+        ADXL_CHK_STATUS_RET(EncodeToBuffer(channel, buffer_req.src_addrs, buffer_req.buffer_lens, dev_buffer_addr,
+                                           left_timeout, buffer_req.codec, buffer_req.encoded_len),
+                            "Encode failed.");
+      }
+      if (buffer_req.codec == KvCodecType::kNone) {
+        auto kind = (type == TransferType::kWriteD2RH || type == TransferType::kWriteD2RD)
+                        ? ACL_MEMCPY_DEVICE_TO_DEVICE
+                        : ACL_MEMCPY_HOST_TO_DEVICE;
+        ADXL_CHK_STATUS_RET(ProcessCopy(channel, buffer_req.src_addrs, buffer_addrs, buffer_req.buffer_lens,
+                                        std::make_pair(kind, left_timeout)),
+                            "Copy failed");
+      }
       time_cost =
           std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
       StatisticManager::GetInstance().UpdateClientCopyCost(channel->GetChannelId(), time_cost);
       buffer_req.src_addrs = {};
+    } else {
+      buffer_req.codec = codec;
     }
     ADXL_CHK_STATUS_RET(SendBufferReq(channel, buffer_req, timeout, start), "Send req failed.");
     left_size -= count;
@@ -285,55 +330,30 @@ std::vector<uintptr_t> BufferTransferService::GenerateBufferReq(BufferReq &buffe
   return buffer_addrs;
 }
 
-void BufferTransferService::ProcessBufferReqFirstStep() {
-  aclrtSetCurrentContext(aclrt_context_);
-  while (!stop_signal_.load()) {
-    std::pair<ChannelPtr, BufferReq> req;
-    {
-      std::unique_lock<std::mutex> lock(buffer_req_mutex_);
-      buffer_req_cv_.wait(lock, [this] { return !buffer_req_queue_.empty() || stop_signal_.load(); });
-      if (stop_signal_.load()) {
-        break;
-      }
-      req = std::move(buffer_req_queue_.front());
-      buffer_req_queue_.pop();
-    }
-    auto &buffer_req = req.second;
-    if (!CheckTimeout(buffer_req)) {
-      auto type = buffer_req.transfer_type;
-      (type == TransferType::kReadRH2H || type == TransferType::kReadRD2H || type == TransferType::kReadRH2D ||
-       type == TransferType::kReadRD2D)
-          ? HandleBufferCopy(req.first, req.second)
-          : HandleBufferD2D(req.first, req.second);
-    }
+void BufferTransferService::ProcessBufferReqFirstStep(std::pair<ChannelPtr, BufferReq> &req) {
+  auto &buffer_req = req.second;
+  if (!CheckTimeout(buffer_req)) {
+    auto type = buffer_req.transfer_type;
+    (type == TransferType::kReadRH2H || type == TransferType::kReadRD2H || type == TransferType::kReadRH2D ||
+     type == TransferType::kReadRD2D)
+        ? HandleBufferCopy(req.first, req.second)
+        : HandleBufferD2D(req.first, req.second);
   }
 }
 
-void BufferTransferService::ProcessBufferReqSecondStep() {
-  aclrtSetCurrentContext(aclrt_context_);
-  while (!stop_signal_.load()) {
-    std::pair<ChannelPtr, BufferReq> req;
-    {
-      std::unique_lock<std::mutex> lock(buffer_second_step_mutex_);
-      buffer_second_step_cv_.wait(lock, [this] { return !buffer_second_step_queue_.empty() || stop_signal_.load(); });
-      if (stop_signal_.load()) {
-        break;
-      }
-      req = std::move(buffer_second_step_queue_.front());
-      buffer_second_step_queue_.pop();
-    }
-    auto &buffer_req = req.second;
-    if (!CheckTimeout(buffer_req)) {
-      auto type = buffer_req.transfer_type;
-      (type == TransferType::kReadRH2H || type == TransferType::kReadRD2H || type == TransferType::kReadRH2D ||
-       type == TransferType::kReadRD2D)
-          ? HandleBufferD2D(req.first, req.second)
-          : HandleBufferCopy(req.first, req.second);
-    }
+void BufferTransferService::ProcessBufferReqSecondStep(std::pair<ChannelPtr, BufferReq> &req) {
+  auto &buffer_req = req.second;
+  if (!CheckTimeout(buffer_req)) {
+    auto type = buffer_req.transfer_type;
+    (type == TransferType::kReadRH2H || type == TransferType::kReadRD2H || type == TransferType::kReadRH2D ||
+     type == TransferType::kReadRD2D)
+        ? HandleBufferD2D(req.first, req.second)
+        : HandleBufferCopy(req.first, req.second);
   }
 }
 
 Status BufferTransferService::HandleBufferD2D(const ChannelPtr &channel, BufferReq &buffer_req) {
+  HIXL_TRACE_SPAN_WITH_ID("BufferTransferService::HandleBufferD2D", buffer_req.req_id);
   LLMLOGI("Processing BufferReq for channel:%s, type:%d", channel->GetChannelId().c_str(), buffer_req.transfer_type);
   ADXL_CHK_BOOL_RET_STATUS(buffer_req.total_buffer_len <= buffer_size_, PARAM_INVALID,
                            "Total buffer length:%lu is bigger than buffer size:%lu.", buffer_req.total_buffer_len,
@@ -357,8 +377,12 @@ Status BufferTransferService::HandleBufferD2D(const ChannelPtr &channel, BufferR
       std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
   ADXL_CHK_BOOL_RET_STATUS(time_cost < timeout, TIMEOUT, "Transfer timeout.");
   auto left_time = timeout - time_cost;
-  std::vector<TransferOpDesc> op_descs{
-      TransferOpDesc{buffer_req.local_buffer_addr, buffer_req.buffer_addr, buffer_req.total_buffer_len}};
+  // encoded buffers only move their encoded bytes
+  const uint64_t move_len =
+      (buffer_req.codec != KvCodecType::kNone) ? buffer_req.encoded_len : buffer_req.total_buffer_len;
+  ADXL_CHK_BOOL_RET_STATUS(move_len <= buffer_size_, PARAM_INVALID, "Move length:%lu is bigger than buffer size:%lu.",
+                           move_len, buffer_size_);
+  std::vector<TransferOpDesc> op_descs{TransferOpDesc{buffer_req.local_buffer_addr, buffer_req.buffer_addr, move_len}};
   ADXL_CHK_STATUS_RET(D2DTransfer(channel, op, op_descs, left_time, start), "D2D transfer failed.");
   time_cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
   LLMLOGI("D2D time cost:%lu us, data num:%zu.", time_cost, op_descs.size());
@@ -378,7 +402,7 @@ Status BufferTransferService::HandleBufferD2D(const ChannelPtr &channel, BufferR
 Status BufferTransferService::D2DTransfer(const ChannelPtr &channel, TransferOp transfer_op,
                                           const std::vector<TransferOpDesc> &op_descs, uint64_t timeout,
                                           const std::chrono::steady_clock::time_point &start) {
-  std::lock_guard<std::mutex> lock(channel->GetTransferMutex());
+  std::lock_guard<hixl::PriorityMutex> lock(channel->GetTransferMutex());
   StreamPool *stream_pool = channel->GetStreamPool();
   ADXL_CHK_BOOL_RET_STATUS(stream_pool != nullptr, FAILED, "Stream pool is null.");
   aclrtStream stream = nullptr;
@@ -402,6 +426,7 @@ Status BufferTransferService::D2DTransfer(const ChannelPtr &channel, TransferOp
 }
 
 Status BufferTransferService::HandleBufferCopy(const ChannelPtr &channel, BufferReq &buffer_req) {
+  HIXL_TRACE_SPAN_WITH_ID("BufferTransferService::HandleBufferCopy", buffer_req.req_id);
   ADXL_CHK_BOOL_RET_STATUS(buffer_req.total_buffer_len <= buffer_size_, PARAM_INVALID,
                            "Total buffer length:%lu is bigger than buffer size:%lu.", buffer_req.total_buffer_len,
                            buffer_size_);
@@ -430,11 +455,29 @@ Status BufferTransferService::HandleBufferCopy(const ChannelPtr &channel, Buffer
     dev_buffer_addr += buffer_req.buffer_lens[i];
   }
   if (is_read) {
-    auto kind = (type == TransferType::kReadRD2H || type == TransferType::kReadRD2D) ? ACL_MEMCPY_DEVICE_TO_DEVICE
-                                                                                     : ACL_MEMCPY_HOST_TO_DEVICE;
-    ADXL_CHK_STATUS_RET(ProcessCopy(channel, buffer_req.dst_addrs, copy_buff_addrs, buffer_req.buffer_lens,
-                                    std::make_pair(kind, left_timeout)),
-                        "Copy failed.");
+    // the requester asks for compression, only host sources are encoded here
+    if ((buffer_req.codec != KvCodecType::kNone) &&
+        ((type == TransferType::kReadRH2H) || (type == TransferType::kReadRH2D))) {
+      ADXL_CHK_STATUS_RET(EncodeToBuffer(channel, buffer_req.dst_addrs, buffer_req.buffer_lens,
+                                         buffer_req.local_buffer_addr, left_timeout, buffer_req.codec,
+                                         buffer_req.encoded_len),
+                          "Encode failed.");
+    } else {
+      buffer_req.codec = KvCodecType::kNone;
+    }
+    if (buffer_req.codec == KvCodecType::kNone) {
+      auto kind = (type == TransferType::kReadRD2H || type == TransferType::kReadRD2D) ? ACL_MEMCPY_DEVICE_TO_DEVICE
+                                                                                       : ACL_MEMCPY_HOST_TO_DEVICE;
+      ADXL_CHK_STATUS_RET(ProcessCopy(channel, buffer_req.dst_addrs, copy_buff_addrs, buffer_req.buffer_lens,
+                                      std::make_pair(kind, left_timeout)),
+                          "Copy failed.");
+    }
+  } else if (buffer_req.codec != KvCodecType::kNone) {
+    ADXL_CHK_STATUS_RET(DecodeFromBuffer(channel, buffer_req.local_buffer_addr, buffer_req.encoded_len,
+                                         buffer_req.dst_addrs, buffer_req.buffer_lens,
+                                         (type == TransferType::kWriteH2RD) || (type == TransferType::kWriteD2RD),
+                                         left_timeout),
+                        "Decode failed.");
   } else {
     auto kind = (type == TransferType::kWriteH2RD || type == TransferType::kWriteD2RD) ? ACL_MEMCPY_DEVICE_TO_DEVICE
                                                                                        : ACL_MEMCPY_DEVICE_TO_HOST;
@@ -524,7 +567,7 @@ Status BufferTransferService::ProcessCopyWithBatch(const SliceInfo &slice_info,
 Status BufferTransferService::ProcessCopyWithAsync(const ChannelPtr &channel, const std::vector<uintptr_t> &src_addrs,
                                                    const std::vector<uintptr_t> &dst_addrs, std::vector<size_t> &sizes,
                                                    CopyExtraInfo extra_info) {
-  std::lock_guard<std::mutex> lock(channel->GetTransferMutex());
+  std::lock_guard<hixl::PriorityMutex> lock(channel->GetTransferMutex());
   auto &timeout = extra_info.second;
   StreamPool *stream_pool = channel->GetStreamPool();
   aclrtStream stream = nullptr;
@@ -554,20 +597,8 @@ Status BufferTransferService::ProcessCopyWithAsync(const ChannelPtr &channel, co
   return SUCCESS;
 }
 
-void BufferTransferService::ProcessCtrlMsg() {
-  while (!stop_signal_.load()) {
-    std::pair<ChannelPtr, BufferReq> buffer_req;
-    {
-      std::unique_lock<std::mutex> lock(buffer_ctrl_msg_mutex_);
-      ctrl_msg_cv_.wait(lock, [this] { return !buffer_ctrl_msg_queue_.empty() || stop_signal_.load(); });
-      if (stop_signal_.load()) {
-        break;
-      }
-      buffer_req = std::move(buffer_ctrl_msg_queue_.front());
-      buffer_ctrl_msg_queue_.pop();
-    }
-    HandleCtrlMsg(buffer_req.first, buffer_req.second);
-  }
+void BufferTransferService::ProcessCtrlMsg(std::pair<ChannelPtr, BufferReq> &buffer_req) {
+  HandleCtrlMsg(buffer_req.first, buffer_req.second);
 }
 
 Status BufferTransferService::HandleCtrlMsg(const ChannelPtr &channel, const BufferReq &buffer_req) {
@@ -581,6 +612,8 @@ Status BufferTransferService::HandleCtrlMsg(const ChannelPtr &channel, const Buf
   buffer_resp.src_addrs = std::move(buffer_req.src_addrs);
   buffer_resp.buffer_lens = std::move(buffer_req.buffer_lens);
   buffer_resp.timeout = buffer_req.timeout;
+  buffer_resp.codec = buffer_req.codec;
+  buffer_resp.encoded_len = buffer_req.encoded_len;
   auto func = [&buffer_resp, &buffer_req, &start](int32_t fd) {
     uint64_t time_cost =
         std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
@@ -591,21 +624,8 @@ Status BufferTransferService::HandleCtrlMsg(const ChannelPtr &channel, const Buf
   return SUCCESS;
 }
 
-void BufferTransferService::ProcessBufferResp() {
-  aclrtSetCurrentContext(aclrt_context_);
-  while (!stop_signal_.load()) {
-    std::pair<ChannelPtr, BufferResp> resp;
-    {
-      std::unique_lock<std::mutex> lock(buffer_resp_mutex_);
-      buffer_resp_cv_.wait(lock, [this] { return !buffer_resp_queue_.empty() || stop_signal_.load(); });
-      if (stop_signal_.load()) {
-        break;
-      }
-      resp = std::move(buffer_resp_queue_.front());
-      buffer_resp_queue_.pop();
-    }
-    HandleBufferResp(resp.first, resp.second);
-  }
+void BufferTransferService::ProcessBufferResp(std::pair<ChannelPtr, BufferResp> &resp) {
+  HandleBufferResp(resp.first, resp.second);
 }
 
 Status BufferTransferService::HandleBufferResp(const ChannelPtr &channel, BufferResp &buffer_resp) {
@@ -618,18 +638,26 @@ Status BufferTransferService::HandleBufferResp(const ChannelPtr &channel, Buffer
       auto start = std::chrono::steady_clock::now();
       ADXL_CHK_BOOL_RET_STATUS(buffer_resp.src_addrs.size() == buffer_resp.buffer_lens.size(), FAILED,
                                "Addr not valid.");
-      std::vector<uintptr_t> buffer_addrs;
-      buffer_addrs.reserve(buffer_resp.src_addrs.size());
-      auto buffer_addr = buffer_resp.buffer_addr;
-      for (size_t i = 0; i < buffer_resp.src_addrs.size(); ++i) {
-        buffer_addrs.emplace_back(buffer_addr);
-        buffer_addr += buffer_resp.buffer_lens[i];
+      if (buffer_resp.codec != KvCodecType::kNone) {
+        ADXL_CHK_STATUS_RET(DecodeFromBuffer(channel, buffer_resp.buffer_addr, buffer_resp.encoded_len,
+                                             buffer_resp.src_addrs, buffer_resp.buffer_lens,
+                                             (type == TransferType::kReadRH2D) || (type == TransferType::kReadRD2D),
+                                             buffer_resp.timeout),
+                            "Decode failed.");
+      } else {
+        std::vector<uintptr_t> buffer_addrs;
+        buffer_addrs.reserve(buffer_resp.src_addrs.size());
+        auto buffer_addr = buffer_resp.buffer_addr;
+        for (size_t i = 0; i < buffer_resp.src_addrs.size(); ++i) {
+          buffer_addrs.emplace_back(buffer_addr);
+          buffer_addr += buffer_resp.buffer_lens[i];
+        }
+        auto kind = (type == TransferType::kReadRH2D || type == TransferType::kReadRD2D) ? ACL_MEMCPY_DEVICE_TO_DEVICE
+                                                                                         : ACL_MEMCPY_DEVICE_TO_HOST;
+        ADXL_CHK_STATUS_RET(ProcessCopy(channel, buffer_addrs, buffer_resp.src_addrs, buffer_resp.buffer_lens,
+                                        std::make_pair(kind, buffer_resp.timeout)),
+                            "Copy failed.");
       }
-      auto kind = (type == TransferType::kReadRH2D || type == TransferType::kReadRD2D) ? ACL_MEMCPY_DEVICE_TO_DEVICE
-                                                                                       : ACL_MEMCPY_DEVICE_TO_HOST;
-      ADXL_CHK_STATUS_RET(ProcessCopy(channel, buffer_addrs, buffer_resp.src_addrs, buffer_resp.buffer_lens,
-                                      std::make_pair(kind, buffer_resp.timeout)),
-                          "Copy failed.");
       uint64_t time_cost =
           std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
       StatisticManager::GetInstance().UpdateClientCopyCost(channel->GetChannelId(), time_cost);
@@ -644,44 +672,36 @@ Status BufferTransferService::HandleBufferResp(const ChannelPtr &channel, Buffer
 
 Status BufferTransferService::PushBufferReq(const ChannelPtr &channel, BufferReq &buffer_req) {
   ADXL_CHK_BOOL_RET_STATUS(buffer_req.timeout > kTimeoutLoss, TIMEOUT, "Time is not enough to push req.");
-  {
-    std::lock_guard<std::mutex> lock(buffer_req_mutex_);
-    buffer_req.recv_start_time = std::chrono::steady_clock::now();
-    buffer_req.timeout = buffer_req.timeout - kTimeoutLoss;
-    buffer_req_queue_.emplace(channel, buffer_req);
-  }
-  buffer_req_cv_.notify_one();
+  ADXL_CHECK_NOTNULL(buffer_req_queue_);
+  buffer_req.recv_start_time = std::chrono::steady_clock::now();
+  buffer_req.timeout = buffer_req.timeout - kTimeoutLoss;
+  ADXL_CHK_BOOL_RET_STATUS(buffer_req_queue_->Push(std::make_pair(channel, buffer_req)), FAILED,
+                           "Buffer transfer service is stopped.");
   return SUCCESS;
 }
 
 Status BufferTransferService::PushSecondStepReq(const ChannelPtr &channel, BufferReq &buffer_req) {
   ADXL_CHK_BOOL_RET_STATUS(buffer_req.timeout > kTimeoutLoss, TIMEOUT, "Time is not enough to push req.");
-  {
-    std::lock_guard<std::mutex> lock(buffer_second_step_mutex_);
-    buffer_req.recv_start_time = std::chrono::steady_clock::now();
-    buffer_req.timeout = buffer_req.timeout - kTimeoutLoss;
-    buffer_second_step_queue_.emplace(channel, buffer_req);
-  }
-  buffer_second_step_cv_.notify_one();
+  ADXL_CHECK_NOTNULL(buffer_second_step_queue_);
+  buffer_req.recv_start_time = std::chrono::steady_clock::now();
+  buffer_req.timeout = buffer_req.timeout - kTimeoutLoss;
+  ADXL_CHK_BOOL_RET_STATUS(buffer_second_step_queue_->Push(std::make_pair(channel, buffer_req)), FAILED,
+                           "Buffer transfer service is stopped.");
   return SUCCESS;
 }
 
 void BufferTransferService::PushCtrlMsg(const ChannelPtr &channel, BufferReq &buffer_req) {
-  {
-    std::lock_guard<std::mutex> lock(buffer_ctrl_msg_mutex_);
-    buffer_ctrl_msg_queue_.emplace(channel, buffer_req);
+  if ((buffer_ctrl_msg_queue_ == nullptr) || (!buffer_ctrl_msg_queue_->Push(std::make_pair(channel, buffer_req)))) {
+    LLMLOGW("Buffer transfer service is stopped, drop ctrl msg of req id:%lu.", buffer_req.req_id);
   }
-  ctrl_msg_cv_.notify_one();
 }
 
 Status BufferTransferService::PushBufferResp(const ChannelPtr &channel, BufferResp &buffer_resp) {
   ADXL_CHK_BOOL_RET_STATUS(buffer_resp.timeout > kTimeoutLoss, TIMEOUT, "Time is not enough to push req.");
-  {
-    std::lock_guard<std::mutex> lock(buffer_resp_mutex_);
-    buffer_resp.timeout = buffer_resp.timeout - kTimeoutLoss;
-    buffer_resp_queue_.emplace(channel, buffer_resp);
-  }
-  buffer_resp_cv_.notify_one();
+  ADXL_CHECK_NOTNULL(buffer_resp_queue_);
+  buffer_resp.timeout = buffer_resp.timeout - kTimeoutLoss;
+  ADXL_CHK_BOOL_RET_STATUS(buffer_resp_queue_->Push(std::make_pair(channel, buffer_resp)), FAILED,
+                           "Buffer transfer service is stopped.");
   return SUCCESS;
 }
 
@@ -746,4 +766,115 @@ bool BufferTransferService::CheckTimeout(const BufferReq &req) {
           .count();
   return time_cost >= req.timeout;
 }
+
+KvCodecType BufferTransferService::SelectCodec(const ChannelPtr &channel, TransferType type,
+                                               bool allow_lossy_compression) const {
+  const bool host_sourced = (type == TransferType::kWriteH2RH) || (type == TransferType::kWriteH2RD) ||
+                            (type == TransferType::kReadRH2H) || (type == TransferType::kReadRH2D);
+  if ((codec_ == KvCodecType::kNone) || (!host_sourced)) {
+    return KvCodecType::kNone;
+  }
+  // quantizing is only right for fp16 kv data, the caller says so per transfer
+  if (KvCodec::IsLossy(codec_) && (!allow_lossy_compression)) {
+    return KvCodecType::kNone;
+  }
+  if (!channel->PeerDecodes(codec_)) {
+    LLMLOGI("Peer of channel:%s does not decode %s, send raw data.", channel->GetChannelId().c_str(),
+            KvCodec::TypeToString(codec_));
+    return KvCodecType::kNone;
+  }
+  return codec_;
+}
+
+Status BufferTransferService::EncodeToBuffer(const ChannelPtr &channel, const std::vector<uintptr_t> &host_addrs,
+                                             const std::vector<size_t> &lens, uintptr_t dev_buffer_addr,
+                                             uint64_t timeout, KvCodecType &codec, uint64_t &encoded_len) {
+  ADXL_CHK_BOOL_RET_STATUS(host_addrs.size() == lens.size(), PARAM_INVALID, "Addr num:%zu, len num:%zu.",
+                           host_addrs.size(), lens.size());
+  size_t total_len = 0U;
+  bool contiguous = true;
+  for (size_t i = 0U; i < host_addrs.size(); ++i) {
+    contiguous = contiguous && ((i == 0U) || (host_addrs[i] == host_addrs[i - 1U] + lens[i - 1U]));
+    total_len += lens[i];
+  }
+  const uint8_t *plain = nullptr;
+  if (contiguous && !host_addrs.empty()) {
+    plain = static_cast<const uint8_t *>(llm::ValueToPtr(host_addrs[0]));
+  } else {
+    auto &gathered = CodecScratch(kPlainScratch);
+    gathered.resize(total_len);
+    size_t offset = 0U;
+    for (size_t i = 0U; i < host_addrs.size(); ++i) {
+      ADXL_CHK_BOOL_RET_STATUS(memcpy_s(gathered.data() + offset, total_len - offset, llm::ValueToPtr(host_addrs[i]),
+                                        lens[i]) == EOK,
+                               FAILED, "Failed to gather %zu bytes.", lens[i]);
+      offset += lens[i];
+    }
+    plain = gathered.data();
+  }
+  auto &encoded = CodecScratch(kEncodedScratch);
+  encoded.resize(KvCodec::MaxEncodedSize(codec, total_len));
+  size_t encoded_size = 0U;
+  if ((KvCodec::Encode(codec, plain, total_len, encoded.data(), encoded.size(), encoded_size) != SUCCESS) ||
+      (encoded_size >= total_len)) {
+    LLMLOGI("Keep %zu bytes uncompressed, codec:%s.", total_len, KvCodec::TypeToString(codec));
+    codec = KvCodecType::kNone;
+    return SUCCESS;
+  }
+  std::vector<uintptr_t> src_addrs{llm::PtrToValue(encoded.data())};
+  std::vector<uintptr_t> dst_addrs{dev_buffer_addr};
+  std::vector<size_t> sizes{encoded_size};
+  ADXL_CHK_STATUS_RET(
+      ProcessCopy(channel, src_addrs, dst_addrs, sizes, std::make_pair(ACL_MEMCPY_HOST_TO_DEVICE, timeout)),
+      "Copy encoded data failed.");
+  encoded_len = encoded_size;
+  LLMLOGI("Encoded %zu bytes to %zu bytes, codec:%s.", total_len, encoded_size, KvCodec::TypeToString(codec));
+  return SUCCESS;
+}
+
+Status BufferTransferService::DecodeFromBuffer(const ChannelPtr &channel, uintptr_t dev_buffer_addr,
+                                               uint64_t encoded_len, const std::vector<uintptr_t> &dst_addrs,
+                                               const std::vector<size_t> &lens, bool dst_on_device, uint64_t timeout) {
+  ADXL_CHK_BOOL_RET_STATUS(encoded_len <= buffer_size_, PARAM_INVALID,
+                           "Encoded length:%lu is bigger than buffer size:%lu.", encoded_len, buffer_size_);
+  ADXL_CHK_BOOL_RET_STATUS(dst_addrs.size() == lens.size(), PARAM_INVALID, "Addr num:%zu, len num:%zu.",
+                           dst_addrs.size(), lens.size());
+  auto &encoded = CodecScratch(kEncodedScratch);
+  encoded.resize(encoded_len);
+  std::vector<uintptr_t> buffer_addrs{dev_buffer_addr};
+  std::vector<uintptr_t> encoded_addrs{llm::PtrToValue(encoded.data())};
+  std::vector<size_t> encoded_sizes{encoded_len};
+  ADXL_CHK_STATUS_RET(ProcessCopy(channel, buffer_addrs, encoded_addrs, encoded_sizes,
+                                  std::make_pair(ACL_MEMCPY_DEVICE_TO_HOST, timeout)),
+                      "Copy encoded data failed.");
+  size_t total_len = 0U;
+  for (const auto len : lens) {
+    total_len += len;
+  }
+  auto &plain = CodecScratch(kPlainScratch);
+  plain.resize(total_len);
+  size_t decoded_len = 0U;
+  ADXL_CHK_STATUS_RET(KvCodec::Decode(encoded.data(), encoded_len, plain.data(), plain.size(), decoded_len),
+                      "Failed to decode %lu bytes.", encoded_len);
+  ADXL_CHK_BOOL_RET_STATUS(decoded_len == total_len, PARAM_INVALID, "Decoded len:%zu, expect:%zu.", decoded_len,
+                           total_len);
+  std::vector<uintptr_t> plain_addrs;
+  plain_addrs.reserve(dst_addrs.size());
+  size_t offset = 0U;
+  for (size_t i = 0U; i < dst_addrs.size(); ++i) {
+    if (!dst_on_device) {
+      ADXL_CHK_BOOL_RET_STATUS(memcpy_s(llm::ValueToPtr(dst_addrs[i]), lens[i], plain.data() + offset, lens[i]) == EOK,
+                               FAILED, "Failed to scatter %zu bytes.", lens[i]);
+    }
+    plain_addrs.emplace_back(llm::PtrToValue(plain.data() + offset));
+    offset += lens[i];
+  }
+  if (dst_on_device) {
+    auto sizes = lens;
+    ADXL_CHK_STATUS_RET(
+        ProcessCopy(channel, plain_addrs, dst_addrs, sizes, std::make_pair(ACL_MEMCPY_HOST_TO_DEVICE, timeout)),
+        "Copy decoded data failed.");
+  }
+  return SUCCESS;
+}
 }  // namespace adxl
\ No newline at end of file
@@ -16,8 +16,10 @@
 #include "adxl/adxl_types.h"
 #include "common/llm_mem_pool.h"
 #include "common/llm_thread_pool.h"
+#include "common/work_stealing_executor.h"
 #include "channel.h"
 #include "control_msg_handler.h"
+#include "kv_codec.h"
 
 namespace adxl {
 using CopyExtraInfo = std::pair<aclrtMemcpyKind, uint64_t>;
@@ -28,15 +30,18 @@ struct SliceInfo {
 };
 class BufferTransferService {
  public:
-  BufferTransferService(std::vector<llm::LlmMemPool *> npu_mem_pools, uint64_t buffer_size)
-      : npu_mem_pools_(std::move(npu_mem_pools)), buffer_size_(buffer_size) {}
+  // codec compresses host sourced data staged by this side when the peer decodes it, lossy codecs only apply to
+  // transfers that allow them, received data is decoded whatever the option is
+  BufferTransferService(std::vector<llm::LlmMemPool *> npu_mem_pools, uint64_t buffer_size,
+                        KvCodecType codec = KvCodecType::kNone)
+      : npu_mem_pools_(std::move(npu_mem_pools)), buffer_size_(buffer_size), codec_(codec) {}
 
   Status Initialize();
 
   void Finalize();
 
   Status Transfer(const ChannelPtr &channel, TransferType type, const std::vector<TransferOpDesc> &op_descs,
-                  int32_t timeout_in_millis);
+                  int32_t timeout_in_millis, bool allow_lossy_compression = false);
 
   Status PushBufferReq(const ChannelPtr &channel, BufferReq &buffer_req);
 
@@ -49,26 +54,26 @@ class BufferTransferService {
   Status TryGetServerBuffer(void *&buffer_addr, uint64_t timeout);
   void ReleaseServerBuffer(void *buffer_addr);
 
-  void ProcessBufferReqFirstStep();
+  void ProcessBufferReqFirstStep(std::pair<ChannelPtr, BufferReq> &req);
   Status HandleBufferD2D(const ChannelPtr &channel, BufferReq &buffer_req);
 
-  void ProcessBufferResp();
+  void ProcessBufferResp(std::pair<ChannelPtr, BufferResp> &resp);
   Status HandleBufferResp(const ChannelPtr &channel, BufferResp &buffer_resp);
 
-  void ProcessBufferReqSecondStep();
+  void ProcessBufferReqSecondStep(std::pair<ChannelPtr, BufferReq> &req);
   Status HandleBufferCopy(const ChannelPtr &channel, BufferReq &buffer_req);
 
-  void ProcessCtrlMsg();
+  void ProcessCtrlMsg(std::pair<ChannelPtr, BufferReq> &buffer_req);
   Status HandleCtrlMsg(const ChannelPtr &channel, const BufferReq &buffer_req);
 
   Status DoTransferTask(const ChannelPtr &channel, const std::vector<TransferOpDesc> &op_descs, uint64_t timeout,
-                        TransferType type, uint64_t req_id);
+                        TransferType type, uint64_t req_id, KvCodecType codec);
   Status FlushBatch(const ChannelPtr &channel, const std::vector<TransferOpDesc> &op_descs, uint64_t timeout,
-                    uint64_t req_id, TransferType type);
+                    uint64_t req_id, TransferType type, KvCodecType codec);
   static Status SendBufferReq(const ChannelPtr &channel, BufferReq &buffer_req, uint64_t timeout,
                               std::chrono::steady_clock::time_point start);
   Status TransferLargeData(const ChannelPtr &channel, const TransferOpDesc &op_desc, uint64_t timeout, uint64_t req_id,
-                           TransferType type);
+                           TransferType type, KvCodecType codec);
   static std::vector<uintptr_t> GenerateBufferReq(BufferReq &buffer_req, uintptr_t addr, uintptr_t remote_addr,
                                                   uintptr_t dev_buffer_addr, uint64_t count);
   Status CheckReqFinishStatus(uint64_t timeout, uint64_t req_id);
@@ -93,34 +98,34 @@ class BufferTransferService {
 
   static bool CheckTimeout(const BufferReq &req);
 
+  // codec of one transfer, kNone when the data is not host sourced, the peer does not decode codec_ or
+  // codec_ is lossy and the transfer does not allow it
+  KvCodecType SelectCodec(const ChannelPtr &channel, TransferType type, bool allow_lossy_compression) const;
+  // encodes host data into the device buffer, codec turns to kNone when encoding does not shrink the data
+  Status EncodeToBuffer(const ChannelPtr &channel, const std::vector<uintptr_t> &host_addrs,
+                        const std::vector<size_t> &lens, uintptr_t dev_buffer_addr, uint64_t timeout,
+                        KvCodecType &codec, uint64_t &encoded_len);
+  Status DecodeFromBuffer(const ChannelPtr &channel, uintptr_t dev_buffer_addr, uint64_t encoded_len,
+                          const std::vector<uintptr_t> &dst_addrs, const std::vector<size_t> &lens, bool dst_on_device,
+                          uint64_t timeout);
+
   std::vector<llm::LlmMemPool*> npu_mem_pools_;
   uint64_t buffer_size_;
+  KvCodecType codec_;
 
   aclrtContext aclrt_context_{nullptr};
   int32_t device_id_{-1};
   bool support_batch_copy_batch_ = true;
 
-  std::thread buffer_req_processor_;
-  std::thread buffer_resp_processor_;
-  std::thread buffer_second_step_processor_;
-  std::thread ctrl_msg_processor_;
-  std::atomic<bool> stop_signal_{false};
-
-  std::mutex buffer_req_mutex_;
-  std::queue<std::pair<ChannelPtr, BufferReq>> buffer_req_queue_;
-  std::condition_variable buffer_req_cv_;
-
-  std::mutex buffer_resp_mutex_;
-  std::queue<std::pair<ChannelPtr, BufferResp>> buffer_resp_queue_;
-  std::condition_variable buffer_resp_cv_;
-
-  std::mutex buffer_second_step_mutex_;
-  std::queue<std::pair<ChannelPtr, BufferReq>> buffer_second_step_queue_;
-  std::condition_variable buffer_second_step_cv_;
-
-  std::mutex buffer_ctrl_msg_mutex_;
-  std::queue<std::pair<ChannelPtr, BufferReq>> buffer_ctrl_msg_queue_;
-  std::condition_variable ctrl_msg_cv_;
+  using BufferReqQueue = hixl::SerialTaskQueue<std::pair<ChannelPtr, BufferReq>>;
+  using BufferRespQueue = hixl::SerialTaskQueue<std::pair<ChannelPtr, BufferResp>>;
+  // stages share the workers, each stage still handles its messages one by one in arrival order
+  std::unique_ptr<BufferReqQueue> buffer_req_queue_;
+  std::unique_ptr<BufferRespQueue> buffer_resp_queue_;
+  std::unique_ptr<BufferReqQueue> buffer_second_step_queue_;
+  std::unique_ptr<BufferReqQueue> buffer_ctrl_msg_queue_;
+  // declared after the queues so that it stops before they are destroyed
+  std::unique_ptr<hixl::WorkStealingExecutor> stage_executor_;
 
   std::mutex req_id_mutex_;
   std::map<uint64_t, std::set<void *>> req_id_buffers_;
@@ -18,6 +18,7 @@
 #include "common/llm_scope_guard.h"
 #include "common/def_types.h"
 #include "common/llm_log.h"
+#include "common/trace_recorder.h"
 #include "virtual_memory_manager.h"
 
 #include <base/err_msg.h>
@@ -39,34 +40,49 @@ Status Channel::Initialize(bool enable_use_fabric_mem) {
     enable_use_fabric_mem_ = enable_use_fabric_mem;
     return SUCCESS;
   }
-  LLMLOGI("HcclCommInitClusterInfoMemConfig begin, comm_name=%s, local rank_id=%u, rank_table=%s",
-         channel_info_.comm_config.hcclCommName, channel_info_.local_rank_id, channel_info_.rank_table.c_str());
+  ADXL_CHK_STATUS_RET(InitComm(channel_info_.comm_config, channel_info_.comm), "Failed to init comm, channel_id:%s",
+                      channel_info_.channel_id.c_str());
+  if (channel_info_.with_high_priority_comm) {
+    // both ends create the comms in the same order, so that HcclCommPrepare of the two comms pair up
+    LLM_DISMISSABLE_GUARD(fail_guard, ([this]() { (void)ClearComm(channel_info_.comm); }));
+    ADXL_CHK_STATUS_RET(InitComm(channel_info_.high_priority_comm_config, channel_info_.high_priority_comm),
+                        "Failed to init high priority comm, channel_id:%s", channel_info_.channel_id.c_str());
+    LLM_DISMISS_GUARD(fail_guard);
+  }
+  return SUCCESS;
+}
+
+Status Channel::InitComm(HcclCommConfig &comm_config, HcclComm &comm) {
+  LLMLOGI("HcclCommInitClusterInfoMemConfig begin, comm_name=%s, local rank_id=%u, rank_table size=%zu",
+         comm_config.hcclCommName, channel_info_.local_rank_id, channel_info_.rank_table.size());
+  LLMLOGD("rank_table=%s", channel_info_.rank_table.c_str());
   {
     std::lock_guard<std::mutex> lock(g_mutex_);
     const auto start = std::chrono::steady_clock::now();
     ADXL_CHK_HCCL_RET(llm::HcclAdapter::GetInstance().HcclCommInitClusterInfoMemConfig(
         channel_info_.rank_table.c_str(),
         channel_info_.local_rank_id,
-        &channel_info_.comm_config,
-        &channel_info_.comm));
+        &comm_config,
+        &comm));
     const auto end = std::chrono::steady_clock::now();
     const auto cost = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    LLMEVENT("HcclCommInitClusterInfoMemConfig success, channel_id:%s, time cost:%lu us.",
-             channel_info_.channel_id.c_str(), cost);
+    LLMEVENT("HcclCommInitClusterInfoMemConfig success, channel_id:%s, comm_name:%s, time cost:%lu us.",
+             channel_info_.channel_id.c_str(), comm_config.hcclCommName, cost);
   }
 
   std::vector<void *> bind_handles;
-  LLM_DISMISSABLE_GUARD(fail_guard, ([this, &bind_handles]() {
+  LLM_DISMISSABLE_GUARD(fail_guard, ([&comm, &bind_handles]() {
     for (auto bind_handle : bind_handles) {
-      (void) llm::HcclAdapter::GetInstance().HcclCommUnbindMem(channel_info_.comm, bind_handle);
+      (void) llm::HcclAdapter::GetInstance().HcclCommUnbindMem(comm, bind_handle);
     }
-    (void) llm::HcclAdapter::GetInstance().HcclCommDestroy(channel_info_.comm);
+    (void) llm::HcclAdapter::GetInstance().HcclCommDestroy(comm);
+    comm = nullptr;
   }));
 
   auto start = std::chrono::steady_clock::now();
   for (const auto &reg_handle_it : channel_info_.registered_mems) {
     auto reg_handle = reg_handle_it.first;
-    ADXL_CHK_HCCL_RET(llm::HcclAdapter::GetInstance().HcclCommBindMem(channel_info_.comm, reg_handle));
+    ADXL_CHK_HCCL_RET(llm::HcclAdapter::GetInstance().HcclCommBindMem(comm, reg_handle));
     bind_handles.emplace_back(reg_handle);
   }
   auto end = std::chrono::steady_clock::now();
@@ -75,7 +91,7 @@ Status Channel::Initialize(bool enable_use_fabric_mem) {
 
   start = std::chrono::steady_clock::now();
   HcclPrepareConfig prepareConfig{};
-  ADXL_CHK_HCCL_RET(llm::HcclAdapter::GetInstance().HcclCommPrepare(channel_info_.comm, &prepareConfig,
+  ADXL_CHK_HCCL_RET(llm::HcclAdapter::GetInstance().HcclCommPrepare(comm, &prepareConfig,
                                                                     channel_info_.timeout_sec));
   end = std::chrono::steady_clock::now();
   cost = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
@@ -84,10 +100,21 @@ Status Channel::Initialize(bool enable_use_fabric_mem) {
   return SUCCESS;
 }
 
+HcclComm Channel::GetComm(TransferPriority priority) const {
+  if ((priority == TransferPriority::HIGH) && (channel_info_.high_priority_comm != nullptr)) {
+    return channel_info_.high_priority_comm;
+  }
+  return channel_info_.comm;
+}
+
 std::string Channel::GetChannelId() const {
   return channel_info_.channel_id;
 }
 
+bool Channel::PeerDecodes(KvCodecType codec) const {
+  return channel_info_.peer_buffer_codecs.count(codec) > 0U;
+}
+
 void Channel::ClearNotifyMessages() {
   {
     std::lock_guard<std::mutex> notify_lock(notify_message_mutex_);
@@ -117,19 +144,28 @@ Status Channel::Finalize() {
   return ret;
 }
 
-Status Channel::ClearResources() {
-  std::lock_guard<std::mutex> lock(transfer_mutex_);
+Status Channel::ClearComm(HcclComm comm) {
   auto ret = SUCCESS;
   for (const auto &reg_handle_it : channel_info_.registered_mems) {
     auto reg_handle = reg_handle_it.first;
-    auto hccl_ret = llm::HcclAdapter::GetInstance().HcclCommUnbindMem(channel_info_.comm, reg_handle);
+    auto hccl_ret = llm::HcclAdapter::GetInstance().HcclCommUnbindMem(comm, reg_handle);
     ret = hccl_ret != HcclResult::HCCL_SUCCESS ? FAILED : ret;
   }
 
-  if (channel_info_.comm != nullptr) {
-    auto hccl_ret = llm::HcclAdapter::GetInstance().HcclCommDestroy(channel_info_.comm);
+  if (comm != nullptr) {
+    auto hccl_ret = llm::HcclAdapter::GetInstance().HcclCommDestroy(comm);
     ret = hccl_ret != HcclResult::HCCL_SUCCESS ? FAILED : ret;
   }
+  return ret;
+}
+
+Status Channel::ClearResources() {
+  std::lock_guard<hixl::PriorityMutex> lock(transfer_mutex_);
+  auto ret = ClearComm(channel_info_.comm);
+  if (channel_info_.high_priority_comm != nullptr) {
+    ret = (ClearComm(channel_info_.high_priority_comm) != SUCCESS) ? FAILED : ret;
+    channel_info_.high_priority_comm = nullptr;
+  }
 
   std::lock_guard<std::mutex> transfer_reqs_lock(transfer_reqs_mutex_);
   for (const auto &transfer_req : req_2_async_record_) {
@@ -213,7 +249,6 @@ Status Channel::TransferAsync(TransferOp operation,
                               const std::vector<TransferOpDesc> &op_descs,
                               const TransferArgs &optional_args,
                               TransferReq &req) {
-  (void)optional_args;
   aclrtStream stream = nullptr;
   ADXL_CHK_STATUS_RET(stream_pool_->TryAllocStream(stream), "Stream pool get stream failed.");
   auto id = reinterpret_cast<uint64_t>(req);
@@ -227,7 +262,8 @@ Status Channel::TransferAsync(TransferOp operation,
     }
   }));
   const auto transfer_start = std::chrono::steady_clock::now();
-  ADXL_CHK_STATUS_RET(TransferAsync(operation, op_descs, stream), "Channel transfer async failed.");
+  ADXL_CHK_STATUS_RET(TransferAsync(operation, op_descs, stream, optional_args.priority),
+                      "Channel transfer async failed.");
   LLM_CHK_ACL_RET(aclrtCreateEvent(&event));
   LLM_CHK_ACL_RET(aclrtRecordEvent(event, stream));
   std::lock_guard<std::mutex> lock(transfer_reqs_mutex_);
@@ -288,14 +324,15 @@ Status Channel::GetTransferStatus(const TransferReq &req, TransferStatus &status
 }
 
 Status Channel::TransferAsync(TransferOp operation, const std::vector<TransferOpDesc> &op_descs,
-                              aclrtStream stream) {
-  auto trans_func = [this, operation, &stream](HcclOneSideOpDesc *descs, uint32_t desc_num) -> Status {
+                              aclrtStream stream, TransferPriority priority) {
+  HcclComm comm = GetComm(priority);
+  auto trans_func = [this, operation, comm, &stream](HcclOneSideOpDesc *descs, uint32_t desc_num) -> Status {
     HcclResult ret = HCCL_SUCCESS;
     if (operation == READ) {
-      ret = llm::HcclAdapter::GetInstance().HcclBatchGet(channel_info_.comm, channel_info_.peer_rank_id,
+      ret = llm::HcclAdapter::GetInstance().HcclBatchGet(comm, channel_info_.peer_rank_id,
                                                          descs, desc_num, stream);
     } else {
-      ret = llm::HcclAdapter::GetInstance().HcclBatchPut(channel_info_.comm, channel_info_.peer_rank_id,
+      ret = llm::HcclAdapter::GetInstance().HcclBatchPut(comm, channel_info_.peer_rank_id,
                                                          descs, desc_num, stream);
     }
     ADXL_CHK_BOOL_RET_STATUS(ret == HCCL_SUCCESS,
@@ -344,7 +381,9 @@ Status Channel::TransferAsyncWithTimeout(TransferOp operation, const std::vector
 
 Status Channel::TransferSync(TransferOp operation,
                              const std::vector<TransferOpDesc> &op_descs,
-                             int32_t timeout_in_millis) {
+                             int32_t timeout_in_millis,
+                             TransferPriority priority) {
+  HIXL_TRACE_SPAN("Channel::TransferSync");
   const auto start = std::chrono::steady_clock::now();
   aclrtStream stream = nullptr;
   ADXL_CHK_STATUS_RET(stream_pool_->TryAllocStream(stream), "Stream pool get stream failed.");
@@ -353,9 +392,12 @@ Status Channel::TransferSync(TransferOp operation,
       this->stream_pool_->DestroyStream(stream);
     }
   }));
-  ADXL_CHK_STATUS_RET(TransferAsync(operation, op_descs, stream), "Transfer failed.");
+  ADXL_CHK_STATUS_RET(TransferAsync(operation, op_descs, stream, priority), "Transfer failed.");
 
-  ADXL_CHK_ACL_RET(aclrtSynchronizeStreamWithTimeout(stream, timeout_in_millis));
+  {
+    HIXL_TRACE_SPAN("Channel::TransferSync::Wait");
+    ADXL_CHK_ACL_RET(aclrtSynchronizeStreamWithTimeout(stream, timeout_in_millis));
+  }
   const auto end = std::chrono::steady_clock::now();
   const auto cost = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
   LLMLOGI("TransferSync success, operation:%s, num = %zu, channel_id:%s, time cost:%lu us.",
@@ -428,7 +470,7 @@ StreamPool* Channel::GetStreamPool() {
   return stream_pool_;
 }
 
-std::mutex &Channel::GetTransferMutex() {
+hixl::PriorityMutex &Channel::GetTransferMutex() {
   return transfer_mutex_;
 }
 
@@ -12,6 +12,7 @@
 #define CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_CHANNEL_H_
 
 #include <mutex>
+#include <set>
 #include <atomic>
 #include <utility>
 #include <chrono>
@@ -21,6 +22,7 @@
 #include "hccl/hccl_adapter.h"
 #include "control_msg_handler.h"
 #include "adxl/stream_pool.h"
+#include "common/priority_mutex.h"
 
 namespace adxl {
 
@@ -45,6 +47,12 @@ struct ChannelInfo {
   std::map<MemHandle, void *> registered_mems;
   HcclComm comm;
   int32_t timeout_sec;
+  // second comm on the high priority traffic class, only when both ends configured one
+  bool with_high_priority_comm = false;
+  HcclCommConfig high_priority_comm_config;
+  HcclComm high_priority_comm = nullptr;
+  // codecs the peer advertised when connecting, staged data in other codecs is sent raw
+  std::set<KvCodecType> peer_buffer_codecs;
 };
 
 using AsyncResource = std::pair<aclrtStream, aclrtEvent>;
@@ -77,11 +85,13 @@ class Channel {
   Status Initialize(bool enable_use_fabric_mem = false);
   Status Finalize();
   std::string GetChannelId() const;
+  bool PeerDecodes(KvCodecType codec) const;
   Status TransferSync(TransferOp operation,
                       const std::vector<TransferOpDesc> &op_descs,
-                      int32_t timeout_in_millis);
+                      int32_t timeout_in_millis,
+                      TransferPriority priority = TransferPriority::NORMAL);
   Status TransferAsync(TransferOp operation, const std::vector<TransferOpDesc> &op_descs,
-                       aclrtStream stream);
+                       aclrtStream stream, TransferPriority priority = TransferPriority::NORMAL);
   Status TransferAsync(TransferOp operation,
                        const std::vector<TransferOpDesc> &op_descs,
                        const TransferArgs &optional_args,
@@ -99,7 +109,8 @@ class Channel {
   void SetStreamPool(StreamPool *stream_pool);
   StreamPool* GetStreamPool();
 
-  std::mutex &GetTransferMutex();
+  // high priority submissions take it before queued normal ones
+  hixl::PriorityMutex &GetTransferMutex();
   
   void GetNotifyMessages(std::vector<NotifyDesc> &notifies);
 
@@ -131,7 +142,10 @@ class Channel {
                                   aclrtStream stream, uint64_t timeout);
 
  private:
+  Status InitComm(HcclCommConfig &comm_config, HcclComm &comm);
+  Status ClearComm(HcclComm comm);
   Status ClearResources();
+  HcclComm GetComm(TransferPriority priority) const;
   void ClearNotifyMessages();
   void ClearImportedMem();
   ChannelInfo channel_info_;
@@ -142,7 +156,7 @@ class Channel {
   static int64_t timeout_in_millis_;
 
   // mutex for disconnect and transfer synchronize
-  std::mutex transfer_mutex_;
+  hixl::PriorityMutex transfer_mutex_;
 
   std::atomic<int32_t> transfer_count_{0};
   std::atomic<bool> disconnect_flag_{false};
@@ -10,6 +10,7 @@
 
 #include "channel_msg_handler.h"
 #include <algorithm>
+#include <iomanip>
 #include <sstream>
 #include "nlohmann/json.hpp"
 #include "adxl/adxl_types.h"
@@ -29,6 +30,10 @@ namespace adxl {
 namespace {
 constexpr int32_t kWaitRespTime = 20;
 constexpr int32_t kCheckDisconnetPeriod = 10;
+constexpr const char *kHighPriorityCommSuffix = "_hp";
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037UL;
+constexpr uint64_t kFnvPrime = 1099511628211UL;
+constexpr int32_t kHashHexWidth = 16;
 std::string GetDebugStr(aclrtMemFabricHandle share_handle) {
   std::stringstream ss;
   for (auto &i : share_handle.data) {
@@ -36,6 +41,23 @@ std::string GetDebugStr(aclrtMemFabricHandle share_handle) {
   }
   return ss.str();
 }
+
+std::string GetOptionValue(const std::map<AscendString, AscendString> &options, const char *hixl_option,
+                           const char *adxl_option) {
+  auto it = options.find(hixl_option);
+  if (it == options.cend()) {
+    it = options.find(adxl_option);
+  }
+  return (it != options.cend()) ? it->second.GetString() : "";
+}
+
+std::vector<int32_t> GetBufferCodecs() {
+  std::vector<int32_t> codecs;
+  for (const auto codec : KvCodec::DecodableTypes()) {
+    codecs.emplace_back(static_cast<int32_t>(codec));
+  }
+  return codecs;
+}
 }  // namespace
 static inline void from_json(const nlohmann::json &j, AddrInfo &op_desc) {
   j.at("mem_type").get_to(op_desc.mem_type);
@@ -74,6 +96,13 @@ static void from_json(const nlohmann::json &j, ChannelConnectInfo &c) {
   j.at("timeout").get_to(c.timeout);
   j.at("addrs").get_to(c.addrs);
   j.at("share_handles").get_to(c.share_handles);
+  // absent when the peer does not support priority comms
+  if (j.contains("high_priority_comm")) {
+    j.at("high_priority_comm").get_to(c.high_priority_comm);
+  }
+  if (j.contains("buffer_codecs")) {
+    j.at("buffer_codecs").get_to(c.buffer_codecs);
+  }
 }
 
 static void to_json(nlohmann::json &j, const ChannelConnectInfo &c) {
@@ -83,6 +112,8 @@ static void to_json(nlohmann::json &j, const ChannelConnectInfo &c) {
   j["timeout"] = c.timeout;
   j["addrs"] = c.addrs;
   j["share_handles"] = c.share_handles;
+  j["high_priority_comm"] = c.high_priority_comm;
+  j["buffer_codecs"] = c.buffer_codecs;
 }
 
 static void from_json(const nlohmann::json &j, ChannelStatus &c) {
@@ -129,6 +160,10 @@ Status ChannelMsgHandler::Deserialize(const std::vector<char> &msg_str, T &msg)
   return SUCCESS;
 }
 
+// connect info is the largest message, instantiated here so it can be measured outside this file
+template Status ChannelMsgHandler::Serialize(const ChannelConnectInfo &msg, std::string &msg_str);
+template Status ChannelMsgHandler::Deserialize(const std::vector<char> &msg_str, ChannelConnectInfo &msg);
+
 template<typename T>
 Status ChannelMsgHandler::SendMsg(int32_t fd, ChannelMsgType msg_type, const T &msg) {
   std::string msg_str;
@@ -197,6 +232,34 @@ Status ChannelMsgHandler::ParseServiceLevel(const std::map<AscendString, AscendS
   return SUCCESS;
 }
 
+Status ChannelMsgHandler::ParseHighPriorityTrafficClass(const std::map<AscendString, AscendString> &options) {
+  std::string traffic_class_str = GetOptionValue(options, hixl::OPTION_RDMA_HIGH_PRIORITY_TRAFFIC_CLASS,
+                                                 adxl::OPTION_RDMA_HIGH_PRIORITY_TRAFFIC_CLASS);
+  if (traffic_class_str.empty()) {
+    return SUCCESS;
+  }
+  // same settings as the normal comm except the traffic class and service level
+  high_priority_comm_config_ = comm_config_;
+  uint32_t traffic_class = 0U;
+  ADXL_CHK_LLM_RET(llm::LLMUtils::ToNumber(traffic_class_str, traffic_class),
+                   "%s is invalid, value = %s",
+                   hixl::OPTION_RDMA_HIGH_PRIORITY_TRAFFIC_CLASS, traffic_class_str.c_str());
+  high_priority_comm_config_.hcclRdmaTrafficClass = traffic_class;
+  std::string service_level_str = GetOptionValue(options, hixl::OPTION_RDMA_HIGH_PRIORITY_SERVICE_LEVEL,
+                                                 adxl::OPTION_RDMA_HIGH_PRIORITY_SERVICE_LEVEL);
+  if (!service_level_str.empty()) {
+    uint32_t service_level = 0U;
+    ADXL_CHK_LLM_RET(llm::LLMUtils::ToNumber(service_level_str, service_level),
+                     "%s is invalid, value = %s",
+                     hixl::OPTION_RDMA_HIGH_PRIORITY_SERVICE_LEVEL, service_level_str.c_str());
+    high_priority_comm_config_.hcclRdmaServiceLevel = service_level;
+  }
+  enable_high_priority_comm_ = true;
+  LLMLOGI("set high priority rdma traffic class to %u, service level to %u.", traffic_class,
+          high_priority_comm_config_.hcclRdmaServiceLevel);
+  return SUCCESS;
+}
+
 Status ChannelMsgHandler::Initialize(const std::map<AscendString, AscendString> &options, SegmentTable *segment_table,
                                      FabricMemTransferService *fabric_mem_transfer_service) {
   ADXL_CHECK_NOTNULL(channel_manager_);
@@ -209,6 +272,7 @@ Status ChannelMsgHandler::Initialize(const std::map<AscendString, AscendString>
   llm::HcclAdapter::GetInstance().HcclCommConfigInit(&comm_config_);
   ADXL_CHK_STATUS_RET(ParseTrafficClass(options), "Failed to parse traffic class");
   ADXL_CHK_STATUS_RET(ParseServiceLevel(options), "Failed to parse service level");
+  ADXL_CHK_STATUS_RET(ParseHighPriorityTrafficClass(options), "Failed to parse high priority traffic class");
   handler_plugin_.Initialize();
   if (listen_port_ > 0) {
     ADXL_CHK_STATUS_RET(StartDaemon(local_ip_, listen_port_), "Failed to start listen deamon, ip:%s, port:%u",
@@ -327,18 +391,37 @@ Status ChannelMsgHandler::CreateChannel(const ChannelInfo &channel_info, bool is
 
 Status ChannelMsgHandler::ParseRankTable(const ChannelConnectInfo &peer_channel_info, std::string &rank_table,
                                          int32_t &local_rank_id, int32_t &peer_rank_id) {
-  auto rank_table_generator = llm::RankTableGeneratorFactory::Create(local_comm_res_, peer_channel_info.comm_res);
-  ADXL_CHK_BOOL_RET_STATUS(rank_table_generator != nullptr, PARAM_INVALID, "Failed to create rank table generator.");
-  ADXL_CHK_STATUS_RET(rank_table_generator->Generate(device_id_, rank_table), "Failed to generate rank table");
-  local_rank_id = rank_table_generator->GetLocalRankId();
+  llm::CachedRankTable cached_rank_table{};
+  ADXL_CHK_STATUS_RET(rank_table_cache_.Get(device_id_, local_comm_res_, peer_channel_info.comm_res, cached_rank_table),
+                      "Failed to generate rank table");
+  rank_table = std::move(cached_rank_table.rank_table);
+  local_rank_id = cached_rank_table.local_rank_id;
   ADXL_CHK_BOOL_RET_STATUS(local_rank_id >= 0, PARAM_INVALID, "Failed to get local rank id, please check rank table.");
-  peer_rank_id = rank_table_generator->GetPeerRankId();
+  peer_rank_id = cached_rank_table.peer_rank_id;
   ADXL_CHK_BOOL_RET_STATUS(peer_rank_id >= 0, PARAM_INVALID,
                            "Failed to get peer rank id, please check rank table, "
                            "not support connect with self device.");
   return SUCCESS;
 }
 
+std::string ChannelMsgHandler::GetHighPriorityCommName(const std::string &comm_name) {
+  std::string high_priority_comm_name = comm_name + kHighPriorityCommSuffix;
+  if (high_priority_comm_name.size() < COMM_NAME_MAX_LENGTH) {
+    return high_priority_comm_name;
+  }
+  // fnv-1a of the whole name replaces the tail, both ends derive the same name and channels sharing a prefix differ
+  uint64_t hash = kFnvOffsetBasis;
+  for (const char c : comm_name) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * kFnvPrime;
+  }
+  std::stringstream ss;
+  ss << "_" << std::hex << std::setw(kHashHexWidth) << std::setfill('0') << hash << kHighPriorityCommSuffix;
+  const std::string tail = ss.str();
+  high_priority_comm_name = comm_name.substr(0U, COMM_NAME_MAX_LENGTH - 1U - tail.size()) + tail;
+  LLMLOGI("high priority comm name of %s is truncated to %s", comm_name.c_str(), high_priority_comm_name.c_str());
+  return high_priority_comm_name;
+}
+
 Status ChannelMsgHandler::ConnectInfoProcess(const ChannelConnectInfo &peer_channel_info,
                                              int32_t timeout, bool is_client) {
   if (user_config_channel_pool_) {
@@ -371,6 +454,20 @@ Status ChannelMsgHandler::ConnectInfoProcess(const ChannelConnectInfo &peer_chan
   auto ret = strcpy_s(channel_info.comm_config.hcclCommName, COMM_NAME_MAX_LENGTH,
                       peer_channel_info.comm_name.c_str());
   ADXL_CHK_BOOL_RET_STATUS(ret == EOK, FAILED, "Failed to copy comm name.");
+  // only when both ends configured a high priority traffic class, otherwise one end would wait for the other
+  channel_info.with_high_priority_comm = enable_high_priority_comm_ && peer_channel_info.high_priority_comm &&
+                                         (!enable_use_fabric_mem_);
+  if (channel_info.with_high_priority_comm) {
+    channel_info.high_priority_comm_config = high_priority_comm_config_;
+    const std::string high_priority_comm_name = GetHighPriorityCommName(peer_channel_info.comm_name);
+    ret = strcpy_s(channel_info.high_priority_comm_config.hcclCommName, COMM_NAME_MAX_LENGTH,
+                   high_priority_comm_name.c_str());
+    ADXL_CHK_BOOL_RET_STATUS(ret == EOK, FAILED, "Failed to copy high priority comm name.");
+  }
+  // staged data is only encoded with codecs the peer said it decodes
+  for (const auto codec : peer_channel_info.buffer_codecs) {
+    channel_info.peer_buffer_codecs.emplace(static_cast<KvCodecType>(codec));
+  }
   channel_info.rank_table = rank_table;
   {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -392,6 +489,8 @@ Status ChannelMsgHandler::ProcessConnectRequest(int32_t fd, const std::vector<ch
   ChannelConnectInfo channel_connect_info = {};
   channel_connect_info.channel_id = listen_info_;
   channel_connect_info.comm_res = local_comm_res_;
+  channel_connect_info.high_priority_comm = enable_high_priority_comm_;
+  channel_connect_info.buffer_codecs = GetBufferCodecs();
   {
     std::lock_guard<std::mutex> lock(mutex_);
     for (const auto &addr_info : handle_to_addr_) {
@@ -519,6 +618,8 @@ Status ChannelMsgHandler::DoConnect(const std::string &remote_engine, int32_t ti
   connect_info.channel_id = listen_info_;
   connect_info.comm_res = local_comm_res_;
   connect_info.timeout = timeout_in_millis;
+  connect_info.high_priority_comm = enable_high_priority_comm_;
+  connect_info.buffer_codecs = GetBufferCodecs();
   ADXL_CHK_STATUS_RET(SendMsg(conn_fd, ChannelMsgType::kConnect, connect_info), "Failed to send connect msg");
   ChannelConnectInfo peer_connect_info = {};
   ADXL_CHK_STATUS_RET(RecvMsg(conn_fd, ChannelMsgType::kConnect, peer_connect_info), "Failed to recv connect msg");
@@ -25,6 +25,7 @@
 #include "fabric_mem_transfer_service.h"
 #include "adxl_utils.h"
 #include "common/hixl_utils.h"
+#include "common/rank_table_cache.h"
 
 namespace adxl {
 enum class ChannelMsgType : int32_t {
@@ -47,6 +48,9 @@ struct ChannelConnectInfo {
   int32_t timeout;
   std::vector<AddrInfo> addrs;
   std::vector<ShareHandleInfo> share_handles;
+  bool high_priority_comm{false};
+  // staged buffer codecs this side decodes, empty for peers without compression support
+  std::vector<int32_t> buffer_codecs;
 };
 
 struct ChannelStatus {
@@ -132,6 +136,9 @@ class ChannelMsgHandler {
   static Status Deserialize(const std::vector<char> &msg_str, T &msg);
   Status ParseTrafficClass(const std::map<AscendString, AscendString> &options);
   Status ParseServiceLevel(const std::map<AscendString, AscendString> &options);
+  Status ParseHighPriorityTrafficClass(const std::map<AscendString, AscendString> &options);
+  // "<comm_name>_hp" kept within COMM_NAME_MAX_LENGTH
+  static std::string GetHighPriorityCommName(const std::string &comm_name);
   Status DoConnect(const std::string &remote_engine, int32_t timeout_in_millis);
   Status InitChannelPool();
 
@@ -175,7 +182,11 @@ class ChannelMsgHandler {
 
   std::string local_comm_name_;
   std::string local_comm_res_;
+  llm::RankTableCache rank_table_cache_;
   HcclCommConfig comm_config_;
+  // set when a high priority traffic class is configured, used for a second comm per channel
+  bool enable_high_priority_comm_ = false;
+  HcclCommConfig high_priority_comm_config_{};
 
   SegmentTable *segment_table_ = nullptr;
   bool enable_use_fabric_mem_ = false;
@@ -15,6 +15,7 @@
 #include "acl/acl.h"
 #include "adxl/adxl_types.h"
 #include "adxl_checker.h"
+#include "kv_codec.h"
 #include "common/llm_log.h"
 
 namespace adxl {
@@ -81,6 +82,9 @@ struct BufferReq {
   // just use for local process
   uintptr_t local_buffer_addr{0};
   std::chrono::steady_clock::time_point recv_start_time{};
+  // staged bytes are encoded with codec, encoded_len of them are moved between the buffers
+  KvCodecType codec{KvCodecType::kNone};
+  uint64_t encoded_len{0};
 };
 
 struct BufferResp {
@@ -90,6 +94,8 @@ struct BufferResp {
   std::vector<uintptr_t> src_addrs{};
   uintptr_t buffer_addr{0};
   std::vector<size_t> buffer_lens{};
+  KvCodecType codec{KvCodecType::kNone};
+  uint64_t encoded_len{0};
 };
 
 inline void from_json(const nlohmann::json &j, BufferReq &req) {
@@ -101,6 +107,10 @@ inline void from_json(const nlohmann::json &j, BufferReq &req) {
   j.at("dst_addrs").get_to(req.dst_addrs);
   j.at("buffer_lens").get_to(req.buffer_lens);
   j.at("total_buffer_len").get_to(req.total_buffer_len);
+  if (j.contains("codec")) {
+    req.codec = static_cast<KvCodecType>(j.at("codec").get<int32_t>());
+    j.at("encoded_len").get_to(req.encoded_len);
+  }
 }
 
 inline void to_json(nlohmann::json &j, const BufferReq &req) {
@@ -112,6 +122,10 @@ inline void to_json(nlohmann::json &j, const BufferReq &req) {
                      {"dst_addrs", req.dst_addrs},
                      {"buffer_lens", req.buffer_lens},
                      {"total_buffer_len", req.total_buffer_len}};
+  if (req.codec != KvCodecType::kNone) {
+    j["codec"] = static_cast<int32_t>(req.codec);
+    j["encoded_len"] = req.encoded_len;
+  }
 }
 
 inline void to_json(nlohmann::json &j, const BufferResp &resp) {
@@ -123,6 +137,10 @@ inline void to_json(nlohmann::json &j, const BufferResp &resp) {
       {"buffer_addr", resp.buffer_addr},
       {"buffer_lens", resp.buffer_lens},
   };
+  if (resp.codec != KvCodecType::kNone) {
+    j["codec"] = static_cast<int32_t>(resp.codec);
+    j["encoded_len"] = resp.encoded_len;
+  }
 }
 
 inline void from_json(const nlohmann::json &j, BufferResp &resp) {
@@ -132,6 +150,10 @@ inline void from_json(const nlohmann::json &j, BufferResp &resp) {
   j.at("src_addrs").get_to(resp.src_addrs);
   j.at("buffer_addr").get_to(resp.buffer_addr);
   j.at("buffer_lens").get_to(resp.buffer_lens);
+  if (j.contains("codec")) {
+    resp.codec = static_cast<KvCodecType>(j.at("codec").get<int32_t>());
+    j.at("encoded_len").get_to(resp.encoded_len);
+  }
 }
 
 inline void to_json(nlohmann::json &j, const HeartbeatMsg &msg) {
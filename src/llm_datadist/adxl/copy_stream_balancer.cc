@@ -0,0 +1,100 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "copy_stream_balancer.h"
+#include <algorithm>
+
+namespace adxl {
+namespace {
+bool IsContiguous(const TransferOpDesc &front, const TransferOpDesc &back) {
+  return (front.local_addr + front.len == back.local_addr) && (front.remote_addr + front.len == back.remote_addr);
+}
+}  // namespace
+
+void CopyStreamBalancer::Balance(const std::vector<TransferOpDesc> &op_descs, size_t stream_num,
+                                 std::vector<std::vector<TransferOpDesc>> &stream_copies) {
+  stream_copies.assign(stream_num, std::vector<TransferOpDesc>());
+  if ((stream_num == 0U) || op_descs.empty()) {
+    return;
+  }
+  uint64_t total_bytes = 0UL;
+  for (const auto &op_desc : op_descs) {
+    total_bytes += op_desc.len;
+  }
+  const uint64_t chunk_size =
+      std::max(static_cast<uint64_t>(kMinSplitSize), (total_bytes + stream_num - 1U) / stream_num);
+
+  // kv blocks of one cache are usually laid out back to back on both sides, one copy moves a run of them
+  std::vector<TransferOpDesc> sorted_descs(op_descs);
+  std::stable_sort(sorted_descs.begin(), sorted_descs.end(), [](const TransferOpDesc &lhs, const TransferOpDesc &rhs) {
+    return lhs.local_addr < rhs.local_addr;
+  });
+  std::vector<TransferOpDesc> merged_descs;
+  merged_descs.reserve(sorted_descs.size());
+  for (const auto &op_desc : sorted_descs) {
+    if (!merged_descs.empty()) {
+      auto &last = merged_descs.back();
+      if (IsContiguous(last, op_desc) && (last.len + op_desc.len <= chunk_size)) {
+        last.len += op_desc.len;
+        continue;
+      }
+    }
+    merged_descs.emplace_back(op_desc);
+  }
+
+  // equal pieces, no small tail left behind
+  std::vector<TransferOpDesc> pieces;
+  pieces.reserve(merged_descs.size() + stream_num);
+  for (const auto &op_desc : merged_descs) {
+    if (op_desc.len <= chunk_size) {
+      pieces.emplace_back(op_desc);
+      continue;
+    }
+    const uint64_t piece_num = (op_desc.len + chunk_size - 1U) / chunk_size;
+    const uint64_t piece_size = (op_desc.len + piece_num - 1U) / piece_num;
+    for (uint64_t offset = 0UL; offset < op_desc.len; offset += piece_size) {
+      TransferOpDesc piece = op_desc;
+      piece.local_addr += offset;
+      piece.remote_addr += offset;
+      piece.len = std::min(piece_size, op_desc.len - offset);
+      pieces.emplace_back(piece);
+    }
+  }
+
+  // longest processing time first
+  std::stable_sort(pieces.begin(), pieces.end(),
+                   [](const TransferOpDesc &lhs, const TransferOpDesc &rhs) { return lhs.len > rhs.len; });
+  std::vector<uint64_t> stream_bytes(stream_num, 0UL);
+  for (const auto &piece : pieces) {
+    const auto min_it = std::min_element(stream_bytes.begin(), stream_bytes.end());
+    const auto stream_index = static_cast<size_t>(min_it - stream_bytes.begin());
+    *min_it += piece.len;
+    stream_copies[stream_index].emplace_back(piece);
+  }
+}
+
+double CopyStreamBalancer::Imbalance(const std::vector<std::vector<TransferOpDesc>> &stream_copies) {
+  uint64_t total_bytes = 0UL;
+  uint64_t max_bytes = 0UL;
+  for (const auto &copies : stream_copies) {
+    uint64_t stream_bytes = 0UL;
+    for (const auto &copy : copies) {
+      stream_bytes += copy.len;
+    }
+    total_bytes += stream_bytes;
+    max_bytes = std::max(max_bytes, stream_bytes);
+  }
+  if (total_bytes == 0UL) {
+    return 1.0;
+  }
+  return static_cast<double>(max_bytes) * static_cast<double>(stream_copies.size()) /
+         static_cast<double>(total_bytes);
+}
+}  // namespace adxl
@@ -0,0 +1,36 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_GRAPH_ENGINE_RUNTIME_ADXL_COPY_STREAM_BALANCER_H_
+#define CANN_GRAPH_ENGINE_RUNTIME_ADXL_COPY_STREAM_BALANCER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "adxl/adxl_types.h"
+
+namespace adxl {
+// Spreads the copies of one transfer over streams so that every stream moves about the same number of bytes.
+// Descriptors contiguous on both sides are merged into one copy, descriptors larger than the share of one
+// stream are split, then the pieces go largest first to the stream with the fewest bytes so far.
+class CopyStreamBalancer {
+ public:
+  // copies up to this size are never split, the extra launch would cost more than the bytes it moves
+  static constexpr size_t kMinSplitSize = 1UL << 20U;
+
+  // stream_copies[i] holds the copies of stream i in issue order
+  static void Balance(const std::vector<TransferOpDesc> &op_descs, size_t stream_num,
+                      std::vector<std::vector<TransferOpDesc>> &stream_copies);
+  // bytes of the busiest stream over the average bytes per stream, 1.0 means perfectly balanced
+  static double Imbalance(const std::vector<std::vector<TransferOpDesc>> &stream_copies);
+};
+}  // namespace adxl
+
+#endif  // CANN_GRAPH_ENGINE_RUNTIME_ADXL_COPY_STREAM_BALANCER_H_
@@ -9,6 +9,7 @@
  */
 
 #include "fabric_mem_transfer_service.h"
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <map>
@@ -18,6 +19,7 @@
 #include "common/def_types.h"
 #include "common/llm_scope_guard.h"
 #include "common/llm_log.h"
+#include "copy_stream_balancer.h"
 #include "statistic_manager.h"
 #include "virtual_memory_manager.h"
 
@@ -495,16 +497,31 @@ Status FabricMemTransferService::TransOpAddr(uintptr_t old_addr, size_t len,
 
 Status FabricMemTransferService::ProcessCopyWithAsync(const std::vector<aclrtStream> &streams, TransferOp operation,
                                                       const std::vector<TransferOpDesc> &op_descs) {
-  for (size_t i = 0; i < op_descs.size(); ++i) {
-    const auto &op = op_descs[i];
-    auto kind = ACL_MEMCPY_DEVICE_TO_DEVICE;
-    auto &stream = streams[i % (streams.size())];
-    if (operation == TransferOp::WRITE) {
-      ADXL_CHK_ACL_RET(
-          aclrtMemcpyAsync(llm::ValueToPtr(op.remote_addr), op.len, llm::ValueToPtr(op.local_addr), op.len, kind, stream));
-    } else if (operation == TransferOp::READ) {
-      ADXL_CHK_ACL_RET(
-          aclrtMemcpyAsync(llm::ValueToPtr(op.local_addr), op.len, llm::ValueToPtr(op.remote_addr), op.len, kind, stream));
+  std::vector<std::vector<TransferOpDesc>> stream_copies;
+  CopyStreamBalancer::Balance(op_descs, streams.size(), stream_copies);
+  size_t max_copy_num = 0U;
+  size_t copy_num = 0U;
+  for (const auto &copies : stream_copies) {
+    max_copy_num = std::max(max_copy_num, copies.size());
+    copy_num += copies.size();
+  }
+  LLMLOGD("Copy %zu descs with %zu copies on %zu streams.", op_descs.size(), copy_num, streams.size());
+  // launch in rounds over the streams, so no stream waits for the launches of another one to start
+  for (size_t i = 0; i < max_copy_num; ++i) {
+    for (size_t stream_index = 0; stream_index < stream_copies.size(); ++stream_index) {
+      if (i >= stream_copies[stream_index].size()) {
+        continue;
+      }
+      const auto &op = stream_copies[stream_index][i];
+      auto kind = ACL_MEMCPY_DEVICE_TO_DEVICE;
+      auto &stream = streams[stream_index];
+      if (operation == TransferOp::WRITE) {
+        ADXL_CHK_ACL_RET(aclrtMemcpyAsync(llm::ValueToPtr(op.remote_addr), op.len, llm::ValueToPtr(op.local_addr),
+                                          op.len, kind, stream));
+      } else if (operation == TransferOp::READ) {
+        ADXL_CHK_ACL_RET(aclrtMemcpyAsync(llm::ValueToPtr(op.local_addr), op.len, llm::ValueToPtr(op.remote_addr),
+                                          op.len, kind, stream));
+      }
     }
   }
   return SUCCESS;
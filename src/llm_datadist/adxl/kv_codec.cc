@@ -0,0 +1,691 @@
+/**
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "kv_codec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <vector>
+#include "adxl/adxl_checker.h"
+
+namespace adxl {
+namespace {
+constexpr uint32_t kCodecMagic = 0x3143564BU;  // "KVC1"
+constexpr size_t kHeaderSize = 16U;
+constexpr size_t kTypeOffset = 4U;
+constexpr size_t kLenOffset = 8U;
+constexpr size_t kPlaneNum = 2U;
+constexpr size_t kPlaneHeaderSize = 9U;  // mode and payload length
+constexpr uint8_t kPlaneRaw = 0U;
+constexpr uint8_t kPlaneLz = 1U;
+constexpr uint8_t kPlaneHuffman = 2U;
+constexpr size_t kMinMatch = 4U;
+constexpr size_t kLastLiterals = 5U;
+constexpr size_t kMaxOffset = 65535U;
+constexpr uint32_t kHashBits = 14U;
+constexpr uint32_t kHashPrime = 2654435761U;
+constexpr uint32_t kSkipTrigger = 6U;
+constexpr size_t kRunMask = 15U;
+constexpr size_t kLenByteMax = 255U;
+constexpr uint32_t kSymbolNum = 256U;
+constexpr uint32_t kMaxCodeLen = 12U;
+constexpr uint32_t kDecodeTableSize = 1U << kMaxCodeLen;
+constexpr size_t kCodeLenTableSize = kSymbolNum / 2U;  // two 4 bit code lengths per byte
+constexpr uint32_t kByteBits = 8U;
+constexpr uint32_t kRefillBits = 56U;
+constexpr float kFp8Max = 448.0F;
+constexpr float kInt8Max = 127.0F;
+constexpr uint8_t kFp8MaxCode = 0x7EU;
+constexpr int32_t kFp8Bias = 7;
+constexpr int32_t kFp8MantBits = 3;
+constexpr uint32_t kFloatMantBits = 23U;
+constexpr int32_t kFloatBias = 127;
+constexpr uint32_t kFp8DropBits = kFloatMantBits - kFp8MantBits;
+constexpr uint32_t kFp8RoundBias = (1U << (kFp8DropBits - 1U)) - 1U;
+constexpr float kFp8MinNormal = 0.015625F;  // 2^-6
+constexpr float kFp8SubnormalScale = 512.0F;  // 2^9
+constexpr float kHalfSubnormalScale = 16777216.0F;  // 2^24
+
+template <typename T>
+T Load(const uint8_t *src) {
+  T value;
+  (void)memcpy(&value, src, sizeof(T));
+  return value;
+}
+
+template <typename T>
+void Store(uint8_t *dst, T value) {
+  (void)memcpy(dst, &value, sizeof(T));
+}
+
+uint32_t FloatBits(float value) {
+  uint32_t bits;
+  (void)memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float BitsToFloat(uint32_t bits) {
+  float value;
+  (void)memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+bool WriteExtraLength(size_t len, uint8_t *&op, const uint8_t *op_end) {
+  while (len >= kLenByteMax) {
+    if (op >= op_end) {
+      return false;
+    }
+    *op++ = static_cast<uint8_t>(kLenByteMax);
+    len -= kLenByteMax;
+  }
+  if (op >= op_end) {
+    return false;
+  }
+  *op++ = static_cast<uint8_t>(len);
+  return true;
+}
+
+bool ReadExtraLength(const uint8_t *&ip, const uint8_t *ip_end, size_t &len) {
+  uint8_t byte = 0U;
+  do {
+    if (ip >= ip_end) {
+      return false;
+    }
+    byte = *ip++;
+    len += byte;
+  } while (byte == kLenByteMax);
+  return true;
+}
+
+// match_len 0 marks the last sequence, which only carries literals
+bool EmitSequence(const uint8_t *literals, size_t literal_len, size_t offset, size_t match_len, uint8_t *&op,
+                  const uint8_t *op_end) {
+  if (op >= op_end) {
+    return false;
+  }
+  uint8_t *token = op++;
+  const size_t match_code = (match_len == 0U) ? 0U : (match_len - kMinMatch);
+  *token = static_cast<uint8_t>((std::min(literal_len, kRunMask) << 4U) | std::min(match_code, kRunMask));
+  if ((literal_len >= kRunMask) && !WriteExtraLength(literal_len - kRunMask, op, op_end)) {
+    return false;
+  }
+  if (static_cast<size_t>(op_end - op) < literal_len) {
+    return false;
+  }
+  (void)memcpy(op, literals, literal_len);
+  op += literal_len;
+  if (match_len == 0U) {
+    return true;
+  }
+  if (op_end - op < static_cast<std::ptrdiff_t>(sizeof(uint16_t))) {
+    return false;
+  }
+  Store<uint16_t>(op, static_cast<uint16_t>(offset));
+  op += sizeof(uint16_t);
+  return (match_code < kRunMask) || WriteExtraLength(match_code - kRunMask, op, op_end);
+}
+
+// greedy lz77 with a single probe hash table, the output follows the lz4 sequence layout
+bool LzCompress(const uint8_t *src, size_t len, uint8_t *dst, size_t capacity, size_t &out_len) {
+  thread_local std::vector<uint32_t> table;
+  table.assign(static_cast<size_t>(1U) << kHashBits, 0U);
+  uint8_t *op = dst;
+  const uint8_t *op_end = dst + capacity;
+  const size_t match_limit = (len > kLastLiterals) ? (len - kLastLiterals) : 0U;
+  size_t anchor = 0U;
+  size_t ip = 0U;
+  uint32_t misses = 0U;
+  while (ip + kMinMatch <= match_limit) {
+    const uint32_t seq = Load<uint32_t>(src + ip);
+    const uint32_t hash = (seq * kHashPrime) >> (32U - kHashBits);
+    const size_t ref = table[hash];
+    table[hash] = static_cast<uint32_t>(ip);
+    if ((ref < ip) && (ip - ref <= kMaxOffset) && (Load<uint32_t>(src + ref) == seq)) {
+      size_t match_len = kMinMatch;
+      while ((ip + match_len < match_limit) && (src[ref + match_len] == src[ip + match_len])) {
+        ++match_len;
+      }
+      if (!EmitSequence(src + anchor, ip - anchor, ip - ref, match_len, op, op_end)) {
+        return false;
+      }
+      ip += match_len;
+      anchor = ip;
+      misses = 0U;
+    } else {
+      // incompressible regions are skipped faster and faster
+      ++misses;
+      ip += 1U + (misses >> kSkipTrigger);
+    }
+  }
+  if (!EmitSequence(src + anchor, len - anchor, 0U, 0U, op, op_end)) {
+    return false;
+  }
+  out_len = static_cast<size_t>(op - dst);
+  return true;
+}
+
+bool LzDecompress(const uint8_t *src, size_t len, uint8_t *dst, size_t capacity, size_t &out_len) {
+  const uint8_t *ip = src;
+  const uint8_t *ip_end = src + len;
+  size_t op = 0U;
+  while (ip < ip_end) {
+    const uint8_t token = *ip++;
+    size_t literal_len = token >> 4U;
+    if ((literal_len == kRunMask) && !ReadExtraLength(ip, ip_end, literal_len)) {
+      return false;
+    }
+    if ((static_cast<size_t>(ip_end - ip) < literal_len) || (capacity - op < literal_len)) {
+      return false;
+    }
+    (void)memcpy(dst + op, ip, literal_len);
+    ip += literal_len;
+    op += literal_len;
+    if (ip == ip_end) {
+      break;
+    }
+    if (ip_end - ip < static_cast<std::ptrdiff_t>(sizeof(uint16_t))) {
+      return false;
+    }
+    const size_t offset = Load<uint16_t>(ip);
+    ip += sizeof(uint16_t);
+    size_t match_len = token & kRunMask;
+    if ((match_len == kRunMask) && !ReadExtraLength(ip, ip_end, match_len)) {
+      return false;
+    }
+    match_len += kMinMatch;
+    if ((offset == 0U) || (offset > op) || (capacity - op < match_len)) {
+      return false;
+    }
+    if (offset >= match_len) {
+      (void)memcpy(dst + op, dst + op - offset, match_len);
+    } else {
+      // the match overlaps its own output, e.g. a run of one repeated byte
+      for (size_t i = 0U; i < match_len; ++i) {
+        dst[op + i] = dst[op + i - offset];
+      }
+    }
+    op += match_len;
+  }
+  out_len = op;
+  return true;
+}
+
+// code lengths of a huffman tree no deeper than kMaxCodeLen, frequencies are halved until the tree fits
+void BuildCodeLengths(const uint64_t *freqs, uint8_t *lengths) {
+  std::vector<uint64_t> weights(freqs, freqs + kSymbolNum);
+  using Node = std::pair<uint64_t, uint32_t>;
+  while (true) {
+    (void)memset(lengths, 0, kSymbolNum);
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> heap;
+    for (uint32_t sym = 0U; sym < kSymbolNum; ++sym) {
+      if (weights[sym] != 0U) {
+        heap.emplace(weights[sym], sym);
+      }
+    }
+    if (heap.size() <= 1U) {
+      if (!heap.empty()) {
+        lengths[heap.top().second] = 1U;
+      }
+      return;
+    }
+    // leaves take ids below kSymbolNum, internal nodes are numbered in creation order so parents follow children
+    std::vector<uint32_t> parent(kSymbolNum * 2U, 0U);
+    uint32_t next = kSymbolNum;
+    while (heap.size() > 1U) {
+      const Node first = heap.top();
+      heap.pop();
+      const Node second = heap.top();
+      heap.pop();
+      parent[first.second] = next;
+      parent[second.second] = next;
+      heap.emplace(first.first + second.first, next++);
+    }
+    std::vector<uint32_t> depth(next, 0U);
+    uint32_t max_len = 0U;
+    for (uint32_t node = next - 1U; node-- > 0U;) {
+      if ((node >= kSymbolNum) || (weights[node] != 0U)) {
+        depth[node] = depth[parent[node]] + 1U;
+        max_len = (node < kSymbolNum) ? std::max(max_len, depth[node]) : max_len;
+      }
+    }
+    if (max_len <= kMaxCodeLen) {
+      for (uint32_t sym = 0U; sym < kSymbolNum; ++sym) {
+        lengths[sym] = static_cast<uint8_t>((weights[sym] != 0U) ? depth[sym] : 0U);
+      }
+      return;
+    }
+    for (auto &weight : weights) {
+      weight = (weight == 0U) ? 0U : std::max<uint64_t>(1U, weight >> 1U);
+    }
+  }
+}
+
+// canonical codes, returns false if the lengths over subscribe the code space
+bool AssignCodes(const uint8_t *lengths, uint16_t *codes) {
+  uint32_t count[kMaxCodeLen + 1U] = {};
+  for (uint32_t sym = 0U; sym < kSymbolNum; ++sym) {
+    if (lengths[sym] > kMaxCodeLen) {
+      return false;
+    }
+    ++count[lengths[sym]];
+  }
+  count[0] = 0U;
+  uint32_t next_code[kMaxCodeLen + 1U] = {};
+  uint32_t code = 0U;
+  for (uint32_t len = 1U; len <= kMaxCodeLen; ++len) {
+    code = (code + count[len - 1U]) << 1U;
+    next_code[len] = code;
+    if (code + count[len] > (1U << len)) {
+      return false;
+    }
+  }
+  for (uint32_t sym = 0U; sym < kSymbolNum; ++sym) {
+    if (lengths[sym] != 0U) {
+      codes[sym] = static_cast<uint16_t>(next_code[lengths[sym]]++);
+    }
+  }
+  return true;
+}
+
+bool HuffmanCompress(const uint8_t *src, size_t len, uint8_t *dst, size_t capacity, size_t &out_len) {
+  uint64_t freqs[kSymbolNum] = {};
+  for (size_t i = 0U; i < len; ++i) {
+    ++freqs[src[i]];
+  }
+  uint8_t lengths[kSymbolNum];
+  BuildCodeLengths(freqs, lengths);
+  uint64_t total_bits = 0U;
+  for (uint32_t sym = 0U; sym < kSymbolNum; ++sym) {
+    total_bits += freqs[sym] * lengths[sym];
+  }
+  if (kCodeLenTableSize + (total_bits + kByteBits - 1U) / kByteBits > capacity) {
+    return false;
+  }
+  uint16_t codes[kSymbolNum] = {};
+  (void)AssignCodes(lengths, codes);
+  for (size_t i = 0U; i < kCodeLenTableSize; ++i) {
+    dst[i] = static_cast<uint8_t>(lengths[i * 2U] | (lengths[i * 2U + 1U] << 4U));
+  }
+  uint8_t *op = dst + kCodeLenTableSize;
+  uint64_t bit_buf = 0U;
+  uint32_t bit_cnt = 0U;
+  for (size_t i = 0U; i < len; ++i) {
+    bit_buf = (bit_buf << lengths[src[i]]) | codes[src[i]];
+    bit_cnt += lengths[src[i]];
+    while (bit_cnt >= kByteBits) {
+      bit_cnt -= kByteBits;
+      *op++ = static_cast<uint8_t>(bit_buf >> bit_cnt);
+    }
+  }
+  if (bit_cnt != 0U) {
+    *op++ = static_cast<uint8_t>(bit_buf << (kByteBits - bit_cnt));
+  }
+  out_len = static_cast<size_t>(op - dst);
+  return true;
+}
+
+// decodes exactly out_len symbols
+bool HuffmanDecompress(const uint8_t *src, size_t len, uint8_t *dst, size_t out_len) {
+  if (len < kCodeLenTableSize) {
+    return false;
+  }
+  uint8_t lengths[kSymbolNum];
+  for (size_t i = 0U; i < kCodeLenTableSize; ++i) {
+    lengths[i * 2U] = src[i] & 0xFU;
+    lengths[i * 2U + 1U] = static_cast<uint8_t>(src[i] >> 4U);
+  }
+  uint16_t codes[kSymbolNum] = {};
+  if (!AssignCodes(lengths, codes)) {
+    return false;
+  }
+  // indexed by the next kMaxCodeLen bits, holds the symbol and its code length, length 0 marks an unused code
+  thread_local std::vector<std::pair<uint8_t, uint8_t>> table;
+  table.assign(kDecodeTableSize, {0U, 0U});
+  for (uint32_t sym = 0U; sym < kSymbolNum; ++sym) {
+    if (lengths[sym] != 0U) {
+      const uint32_t first = static_cast<uint32_t>(codes[sym]) << (kMaxCodeLen - lengths[sym]);
+      std::fill(table.begin() + first, table.begin() + first + (1U << (kMaxCodeLen - lengths[sym])),
+                std::make_pair(static_cast<uint8_t>(sym), lengths[sym]));
+    }
+  }
+  const uint8_t *ip = src + kCodeLenTableSize;
+  const size_t payload_len = len - kCodeLenTableSize;
+  size_t pos = 0U;
+  uint64_t bit_buf = 0U;
+  uint32_t bit_cnt = 0U;
+  uint64_t consumed_bits = 0U;
+  for (size_t i = 0U; i < out_len; ++i) {
+    while (bit_cnt <= kRefillBits) {
+      // reading past the payload feeds zero bits, the consumed bit count catches truncated input
+      bit_buf = (bit_buf << kByteBits) | ((pos < payload_len) ? ip[pos] : 0U);
+      ++pos;
+      bit_cnt += kByteBits;
+    }
+    const auto &entry = table[(bit_buf >> (bit_cnt - kMaxCodeLen)) & (kDecodeTableSize - 1U)];
+    if (entry.second == 0U) {
+      return false;
+    }
+    dst[i] = entry.first;
+    bit_cnt -= entry.second;
+    consumed_bits += entry.second;
+  }
+  return (consumed_bits + kByteBits - 1U) / kByteBits == payload_len;
+}
+
+void WriteHeader(uint8_t *dst, KvCodecType type, size_t len) {
+  (void)memset(dst, 0, kHeaderSize);
+  Store<uint32_t>(dst, kCodecMagic);
+  dst[kTypeOffset] = static_cast<uint8_t>(type);
+  Store<uint64_t>(dst + kLenOffset, static_cast<uint64_t>(len));
+}
+
+size_t GroupNum(size_t elem_num) {
+  return (elem_num + KvCodec::kScaleGroupSize - 1U) / KvCodec::kScaleGroupSize;
+}
+
+size_t EncodeLossless(const uint8_t *src, size_t len, uint8_t *dst) {
+  const size_t elem_num = len / sizeof(uint16_t);
+  thread_local std::vector<uint8_t> plane;
+  thread_local std::vector<uint8_t> coded;
+  plane.resize(elem_num);
+  coded.resize(elem_num);
+  uint8_t *op = dst + kHeaderSize;
+  for (size_t p = 0U; p < kPlaneNum; ++p) {
+    // byte planes separate the sign and exponent bytes, which repeat a lot, from the noisy mantissa bytes
+    for (size_t i = 0U; i < elem_num; ++i) {
+      plane[i] = src[i * kPlaneNum + p];
+    }
+    // lz catches runs such as the empty slots of paged blocks, huffman the skewed exponent bytes
+    uint8_t *payload = op + kPlaneHeaderSize;
+    size_t payload_len = elem_num;
+    *op = kPlaneRaw;
+    size_t lz_len = 0U;
+    if (LzCompress(plane.data(), elem_num, payload, elem_num, lz_len) && (lz_len < payload_len)) {
+      *op = kPlaneLz;
+      payload_len = lz_len;
+    }
+    size_t huffman_len = 0U;
+    if (HuffmanCompress(plane.data(), elem_num, coded.data(), elem_num, huffman_len) && (huffman_len < payload_len)) {
+      *op = kPlaneHuffman;
+      payload_len = huffman_len;
+      (void)memcpy(payload, coded.data(), huffman_len);
+    }
+    if (*op == kPlaneRaw) {
+      (void)memcpy(payload, plane.data(), elem_num);
+    }
+    Store<uint64_t>(op + 1U, static_cast<uint64_t>(payload_len));
+    op = payload + payload_len;
+  }
+  if ((len % sizeof(uint16_t)) != 0U) {
+    *op++ = src[len - 1U];
+  }
+  return static_cast<size_t>(op - dst);
+}
+
+Status DecodeLossless(const uint8_t *src, size_t len, uint8_t *dst, size_t original_len) {
+  const size_t elem_num = original_len / sizeof(uint16_t);
+  thread_local std::vector<uint8_t> plane;
+  plane.resize(elem_num);
+  const uint8_t *ip = src + kHeaderSize;
+  const uint8_t *ip_end = src + len;
+  for (size_t p = 0U; p < kPlaneNum; ++p) {
+    ADXL_CHK_BOOL_RET_STATUS(ip_end - ip >= static_cast<std::ptrdiff_t>(kPlaneHeaderSize), PARAM_INVALID,
+                             "Encoded kv buffer is truncated at plane %zu.", p);
+    const uint8_t mode = *ip;
+    const uint64_t payload_len = Load<uint64_t>(ip + 1U);
+    ip += kPlaneHeaderSize;
+    ADXL_CHK_BOOL_RET_STATUS(payload_len <= static_cast<uint64_t>(ip_end - ip), PARAM_INVALID,
+                             "Plane %zu payload len:%lu exceeds encoded buffer.", p, payload_len);
+    size_t plane_len = 0U;
+    if (mode == kPlaneLz) {
+      ADXL_CHK_BOOL_RET_STATUS(LzDecompress(ip, payload_len, plane.data(), elem_num, plane_len), PARAM_INVALID,
+                               "Plane %zu is corrupted.", p);
+    } else if (mode == kPlaneHuffman) {
+      ADXL_CHK_BOOL_RET_STATUS(HuffmanDecompress(ip, payload_len, plane.data(), elem_num), PARAM_INVALID,
+                               "Plane %zu is corrupted.", p);
+      plane_len = elem_num;
+    } else {
+      ADXL_CHK_BOOL_RET_STATUS(mode == kPlaneRaw, PARAM_INVALID, "Plane %zu mode:%u is invalid.", p,
+                               static_cast<uint32_t>(mode));
+      plane_len = payload_len;
+      if (plane_len == elem_num) {
+        (void)memcpy(plane.data(), ip, plane_len);
+      }
+    }
+    ADXL_CHK_BOOL_RET_STATUS(plane_len == elem_num, PARAM_INVALID, "Plane %zu len:%zu, expect:%zu.", p, plane_len,
+                             elem_num);
+    for (size_t i = 0U; i < elem_num; ++i) {
+      dst[i * kPlaneNum + p] = plane[i];
+    }
+    ip += payload_len;
+  }
+  const size_t tail_len = original_len % sizeof(uint16_t);
+  ADXL_CHK_BOOL_RET_STATUS(static_cast<size_t>(ip_end - ip) == tail_len, PARAM_INVALID,
+                           "Encoded kv buffer has %zu trailing bytes, expect:%zu.", static_cast<size_t>(ip_end - ip),
+                           tail_len);
+  if (tail_len != 0U) {
+    dst[original_len - 1U] = *ip;
+  }
+  return SUCCESS;
+}
+
+Status EncodeScaled(KvCodecType type, const uint8_t *src, size_t len, uint8_t *dst, size_t &encoded_len) {
+  const size_t elem_num = len / sizeof(uint16_t);
+  const float max_code = (type == KvCodecType::kFp8) ? kFp8Max : kInt8Max;
+  uint8_t *op = dst + kHeaderSize;
+  float values[KvCodec::kScaleGroupSize];
+  for (size_t start = 0U; start < elem_num; start += KvCodec::kScaleGroupSize) {
+    const size_t count = std::min(KvCodec::kScaleGroupSize, elem_num - start);
+    float abs_max = 0.0F;
+    for (size_t i = 0U; i < count; ++i) {
+      values[i] = KvCodec::HalfToFloat(Load<uint16_t>(src + (start + i) * sizeof(uint16_t)));
+      ADXL_CHK_BOOL_RET_SPECIAL_STATUS(!std::isfinite(values[i]), PARAM_INVALID,
+                                       "Element %zu is not finite, skip lossy encoding.", start + i);
+      abs_max = std::max(abs_max, std::fabs(values[i]));
+    }
+    const float scale = abs_max / max_code;
+    const float inv_scale = (scale > 0.0F) ? (1.0F / scale) : 0.0F;
+    Store<float>(op, scale);
+    op += sizeof(float);
+    for (size_t i = 0U; i < count; ++i) {
+      const float scaled = values[i] * inv_scale;
+      if (type == KvCodecType::kFp8) {
+        *op++ = KvCodec::FloatToFp8(scaled);
+      } else {
+        const long code = std::min(std::max(std::lrint(scaled), -127L), 127L);
+        *op++ = static_cast<uint8_t>(static_cast<int8_t>(code));
+      }
+    }
+  }
+  encoded_len = static_cast<size_t>(op - dst);
+  return SUCCESS;
+}
+
+Status DecodeScaled(KvCodecType type, const uint8_t *src, size_t len, uint8_t *dst, size_t original_len) {
+  const size_t elem_num = original_len / sizeof(uint16_t);
+  ADXL_CHK_BOOL_RET_STATUS((original_len % sizeof(uint16_t)) == 0U, PARAM_INVALID,
+                           "Lossy encoded len:%zu is not fp16 aligned.", original_len);
+  const size_t expect_len = kHeaderSize + elem_num + GroupNum(elem_num) * sizeof(float);
+  ADXL_CHK_BOOL_RET_STATUS(len == expect_len, PARAM_INVALID, "Lossy encoded len:%zu, expect:%zu.", len, expect_len);
+  const uint8_t *ip = src + kHeaderSize;
+  for (size_t start = 0U; start < elem_num; start += KvCodec::kScaleGroupSize) {
+    const size_t count = std::min(KvCodec::kScaleGroupSize, elem_num - start);
+    const float scale = Load<float>(ip);
+    ip += sizeof(float);
+    for (size_t i = 0U; i < count; ++i) {
+      const float code = (type == KvCodecType::kFp8) ? KvCodec::Fp8ToFloat(*ip)
+                                                     : static_cast<float>(static_cast<int8_t>(*ip));
+      ++ip;
+      Store<uint16_t>(dst + (start + i) * sizeof(uint16_t), KvCodec::FloatToHalf(code * scale));
+    }
+  }
+  return SUCCESS;
+}
+}  // namespace
+
+Status KvCodec::ParseType(const std::string &name, KvCodecType &type) {
+  static const std::pair<const char *, KvCodecType> kTypes[] = {{"none", KvCodecType::kNone},
+                                                                {"lossless", KvCodecType::kLossless},
+                                                                {"fp8", KvCodecType::kFp8},
+                                                                {"int8", KvCodecType::kInt8}};
+  for (const auto &item : kTypes) {
+    if (name == item.first) {
+      type = item.second;
+      return SUCCESS;
+    }
+  }
+  LLMLOGE(PARAM_INVALID, "Kv codec:%s is invalid, valid values are none, lossless, fp8 and int8.", name.c_str());
+  return PARAM_INVALID;
+}
+
+const char *KvCodec::TypeToString(KvCodecType type) {
+  switch (type) {
+    case KvCodecType::kLossless:
+      return "lossless";
+    case KvCodecType::kFp8:
+      return "fp8";
+    case KvCodecType::kInt8:
+      return "int8";
+    default:
+      return "none";
+  }
+}
+
+bool KvCodec::IsLossy(KvCodecType type) {
+  return (type == KvCodecType::kFp8) || (type == KvCodecType::kInt8);
+}
+
+std::vector<KvCodecType> KvCodec::DecodableTypes() {
+  return {KvCodecType::kLossless, KvCodecType::kFp8, KvCodecType::kInt8};
+}
+
+size_t KvCodec::MaxEncodedSize(KvCodecType type, size_t len) {
+  const size_t elem_num = len / sizeof(uint16_t);
+  if (type == KvCodecType::kLossless) {
+    // a plane falls back to raw bytes when lz does not help
+    return kHeaderSize + kPlaneNum * (kPlaneHeaderSize + elem_num) + (len % sizeof(uint16_t));
+  }
+  if ((type == KvCodecType::kFp8) || (type == KvCodecType::kInt8)) {
+    return kHeaderSize + elem_num + GroupNum(elem_num) * sizeof(float);
+  }
+  return len;
+}
+
+Status KvCodec::Encode(KvCodecType type, const uint8_t *src, size_t len, uint8_t *dst, size_t capacity,
+                       size_t &encoded_len) {
+  ADXL_CHK_BOOL_RET_STATUS(((src != nullptr) || (len == 0U)) && (dst != nullptr), PARAM_INVALID,
+                           "Kv codec buffer is nullptr.");
+  ADXL_CHK_BOOL_RET_STATUS((type == KvCodecType::kLossless) || (type == KvCodecType::kFp8) ||
+                               (type == KvCodecType::kInt8),
+                           PARAM_INVALID, "Kv codec type:%d can not encode.", static_cast<int32_t>(type));
+  ADXL_CHK_BOOL_RET_STATUS(capacity >= MaxEncodedSize(type, len), PARAM_INVALID,
+                           "Kv codec capacity:%zu is less than %zu.", capacity, MaxEncodedSize(type, len));
+  WriteHeader(dst, type, len);
+  if (type == KvCodecType::kLossless) {
+    encoded_len = EncodeLossless(src, len, dst);
+    return SUCCESS;
+  }
+  ADXL_CHK_BOOL_RET_STATUS((len % sizeof(uint16_t)) == 0U, PARAM_INVALID,
+                           "Lossy kv codec needs fp16 data, len:%zu is odd.", len);
+  return EncodeScaled(type, src, len, dst, encoded_len);
+}
+
+Status KvCodec::Decode(const uint8_t *src, size_t len, uint8_t *dst, size_t capacity, size_t &decoded_len) {
+  ADXL_CHK_BOOL_RET_STATUS((src != nullptr) && ((dst != nullptr) || (capacity == 0U)), PARAM_INVALID,
+                           "Kv codec buffer is nullptr.");
+  ADXL_CHK_BOOL_RET_STATUS((len >= kHeaderSize) && (Load<uint32_t>(src) == kCodecMagic), PARAM_INVALID,
+                           "Encoded kv buffer header is invalid, len:%zu.", len);
+  const auto type = static_cast<KvCodecType>(src[kTypeOffset]);
+  const uint64_t original_len = Load<uint64_t>(src + kLenOffset);
+  ADXL_CHK_BOOL_RET_STATUS(original_len <= capacity, PARAM_INVALID, "Decoded len:%lu exceeds capacity:%zu.",
+                           original_len, capacity);
+  if (type == KvCodecType::kLossless) {
+    ADXL_CHK_STATUS_RET(DecodeLossless(src, len, dst, original_len), "Failed to decode lossless kv buffer.");
+  } else {
+    ADXL_CHK_BOOL_RET_STATUS((type == KvCodecType::kFp8) || (type == KvCodecType::kInt8), PARAM_INVALID,
+                             "Encoded kv codec type:%d is invalid.", static_cast<int32_t>(type));
+    ADXL_CHK_STATUS_RET(DecodeScaled(type, src, len, dst, original_len), "Failed to decode %s kv buffer.",
+                        TypeToString(type));
+  }
+  decoded_len = original_len;
+  return SUCCESS;
+}
+
+float KvCodec::HalfToFloat(uint16_t value) {
+  const uint32_t sign = static_cast<uint32_t>(value & 0x8000U) << 16U;
+  const uint32_t exponent = (value >> 10U) & 0x1FU;
+  const uint32_t mantissa = value & 0x3FFU;
+  if (exponent == 0U) {
+    const float magnitude = static_cast<float>(mantissa) / kHalfSubnormalScale;
+    return (sign != 0U) ? -magnitude : magnitude;
+  }
+  if (exponent == 0x1FU) {
+    return BitsToFloat(sign | 0x7F800000U | (mantissa << 13U));
+  }
+  return BitsToFloat(sign | ((exponent + 112U) << 23U) | (mantissa << 13U));
+}
+
+uint16_t KvCodec::FloatToHalf(float value) {
+  uint32_t bits = FloatBits(value);
+  const auto sign = static_cast<uint16_t>((bits >> 16U) & 0x8000U);
+  bits &= 0x7FFFFFFFU;
+  if (bits >= 0x7F800000U) {
+    return static_cast<uint16_t>(sign | 0x7C00U | ((bits > 0x7F800000U) ? 0x200U : 0U));
+  }
+  if (bits >= 0x477FF000U) {
+    // 65520 and above round to infinity
+    return static_cast<uint16_t>(sign | 0x7C00U);
+  }
+  if (bits < 0x38800000U) {
+    // below 2^-14 the result is subnormal, the rounding carry may produce the smallest normal
+    return static_cast<uint16_t>(sign | static_cast<uint16_t>(std::lrint(BitsToFloat(bits) * kHalfSubnormalScale)));
+  }
+  // rebias the exponent and round the dropped 13 bits to nearest even
+  bits = bits - (112U << 23U) + 0xFFFU + ((bits >> 13U) & 1U);
+  return static_cast<uint16_t>(sign | (bits >> 13U));
+}
+
+uint8_t KvCodec::FloatToFp8(float value) {
+  const uint8_t sign = std::signbit(value) ? 0x80U : 0U;
+  const float magnitude = std::fabs(value);
+  if (!(magnitude < kFp8Max)) {
+    // e4m3 has no infinity, values saturate to the largest finite code
+    return static_cast<uint8_t>(sign | kFp8MaxCode);
+  }
+  if (magnitude < kFp8MinNormal) {
+    return static_cast<uint8_t>(sign | static_cast<uint8_t>(std::lrint(magnitude * kFp8SubnormalScale)));
+  }
+  // round the float mantissa to 3 bits, ties to even, a carry moves into the exponent
+  uint32_t bits = FloatBits(magnitude);
+  bits += kFp8RoundBias + ((bits >> kFp8DropBits) & 1U);
+  const int32_t biased = static_cast<int32_t>(bits >> kFloatMantBits) - kFloatBias + kFp8Bias;
+  const auto mantissa = static_cast<int32_t>((bits >> kFp8DropBits) & 0x7U);
+  const auto code = static_cast<uint8_t>((biased << kFp8MantBits) | mantissa);
+  return static_cast<uint8_t>(sign | std::min(code, kFp8MaxCode));
+}
+
+float KvCodec::Fp8ToFloat(uint8_t value) {
+  static const std::vector<float> kTable = []() {
+    std::vector<float> table(kSymbolNum);
+    for (uint32_t code = 0U; code < kSymbolNum; ++code) {
+      const int32_t exponent = static_cast<int32_t>(code >> kFp8MantBits) & 0xF;
+      const int32_t mantissa = static_cast<int32_t>(code) & 0x7;
+      const float magnitude =
+          (exponent == 0) ? static_cast<float>(mantissa) / kFp8SubnormalScale
+                          : std::ldexp(1.0F + static_cast<float>(mantissa) / (1 << kFp8MantBits), exponent - kFp8Bias);
+      table[code] = ((code & 0x80U) != 0U) ? -magnitude : magnitude;
+    }
+    return table;
+  }();
+  return kTable[value];
+}
+}  // namespace adxl
@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_GRAPH_ENGINE_KV_CODEC_H
+#define CANN_GRAPH_ENGINE_KV_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "adxl/adxl_types.h"
+
+namespace adxl {
+enum class KvCodecType : int32_t {
+  kNone = 0,
+  // fp16 split into byte planes, each plane compressed with an lz77 coder in the lz4 sequence format
+  kLossless = 1,
+  // fp16 scaled per group to fp8 e4m3, relative error of a normal value is at most 1/16
+  kFp8 = 2,
+  // fp16 scaled per group to int8, absolute error is at most half of the group scale
+  kInt8 = 3,
+};
+
+// Host reference codec of staged kv buffers. The encoded stream is self describing, the receiver needs no option.
+class KvCodec {
+ public:
+  // elements sharing one scale in lossy types
+  static constexpr size_t kScaleGroupSize = 128U;
+
+  // "none", "lossless", "fp8" or "int8"
+  static Status ParseType(const std::string &name, KvCodecType &type);
+  static const char *TypeToString(KvCodecType type);
+  static bool IsLossy(KvCodecType type);
+  // types Decode understands, advertised to the peer when connecting
+  static std::vector<KvCodecType> DecodableTypes();
+  static size_t MaxEncodedSize(KvCodecType type, size_t len);
+  // lossy types treat the data as fp16 and need an even length, non finite values are rejected
+  static Status Encode(KvCodecType type, const uint8_t *src, size_t len, uint8_t *dst, size_t capacity,
+                       size_t &encoded_len);
+  static Status Decode(const uint8_t *src, size_t len, uint8_t *dst, size_t capacity, size_t &decoded_len);
+
+  static float HalfToFloat(uint16_t value);
+  static uint16_t FloatToHalf(float value);
+  static uint8_t FloatToFp8(float value);
+  static float Fp8ToFloat(uint8_t value);
+};
+}  // namespace adxl
+
+#endif  // CANN_GRAPH_ENGINE_KV_CODEC_H
@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "latency_histogram.h"
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace adxl {
+namespace {
+constexpr uint64_t kSubBucketMask = LatencyHistogram::kSubBucketNum - 1UL;
+constexpr uint64_t kMaxTrackableValue = (1UL << LatencyHistogram::kMaxValueBits) - 1UL;
+constexpr uint64_t kPercentileBase = 1000UL;
+
+uint64_t GetValueAtPercentile(const std::vector<uint64_t> &counts, uint64_t total_count, uint64_t per_mille,
+                              const LatencySnapshot &snapshot) {
+  // rank of the sample at the percentile, rounded up
+  const uint64_t rank = (total_count * per_mille + kPercentileBase - 1UL) / kPercentileBase;
+  uint64_t accumulated = 0UL;
+  for (size_t i = 0U; i < counts.size(); ++i) {
+    accumulated += counts[i];
+    if ((accumulated >= rank) && (accumulated > 0UL)) {
+      const uint64_t value = LatencyHistogram::GetBucketUpperBound(i);
+      return std::max(std::min(value, snapshot.max), snapshot.min);
+    }
+  }
+  return snapshot.max;
+}
+
+// shard index owned by a thread until it exits, so an index is written by one live thread at a time
+class ShardIndexHolder {
+ public:
+  ShardIndexHolder() {
+    std::lock_guard<std::mutex> lock(GetMutex());
+    auto &free_indexes = GetFreeIndexes();
+    if (free_indexes.empty()) {
+      index_ = LatencyHistogram::kMaxShardNum;
+    } else {
+      index_ = free_indexes.back();
+      free_indexes.pop_back();
+    }
+  }
+
+  ~ShardIndexHolder() {
+    if (index_ < LatencyHistogram::kMaxShardNum) {
+      std::lock_guard<std::mutex> lock(GetMutex());
+      GetFreeIndexes().emplace_back(index_);
+    }
+  }
+
+  size_t GetIndex() const {
+    return index_;
+  }
+
+ private:
+  static std::mutex &GetMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::vector<size_t> &GetFreeIndexes() {
+    static std::vector<size_t> free_indexes = []() {
+      std::vector<size_t> indexes;
+      for (size_t i = LatencyHistogram::kMaxShardNum; i > 0U; --i) {
+        indexes.emplace_back(i - 1U);
+      }
+      return indexes;
+    }();
+    return free_indexes;
+  }
+
+  size_t index_ = LatencyHistogram::kMaxShardNum;
+};
+
+void AddOwned(std::atomic<uint64_t> &counter, uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+}  // namespace
+
+LatencyHistogram::Shard::Shard() {
+  Reset();
+}
+
+void LatencyHistogram::Shard::Reset() {
+  for (auto &bucket : buckets) {
+    bucket.store(0UL, std::memory_order_relaxed);
+  }
+  total.store(0UL, std::memory_order_relaxed);
+  min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+  max.store(0UL, std::memory_order_relaxed);
+}
+
+LatencyHistogram::~LatencyHistogram() {
+  for (auto &shard : shards_) {
+    delete shard.load(std::memory_order_acquire);
+  }
+}
+
+size_t LatencyHistogram::GetBucketIndex(uint64_t value) {
+  if (value < kSubBucketNum) {
+    return static_cast<size_t>(value);
+  }
+  value = std::min(value, kMaxTrackableValue);
+  const size_t magnitude = 63U - static_cast<size_t>(__builtin_clzll(value));
+  const size_t group = magnitude - kSubBucketBits + 1U;
+  const uint64_t sub_bucket = (value >> (magnitude - kSubBucketBits)) & kSubBucketMask;
+  return (group << kSubBucketBits) + static_cast<size_t>(sub_bucket);
+}
+
+uint64_t LatencyHistogram::GetBucketLowerBound(size_t index) {
+  if (index < kSubBucketNum) {
+    return index;
+  }
+  const size_t shift = (index >> kSubBucketBits) - 1U;
+  return (kSubBucketNum + (index & kSubBucketMask)) << shift;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(size_t index) {
+  if (index < kSubBucketNum) {
+    return index;
+  }
+  const size_t shift = (index >> kSubBucketBits) - 1U;
+  return GetBucketLowerBound(index) + (1UL << shift) - 1UL;
+}
+
+size_t LatencyHistogram::GetLocalShardIndex() {
+  thread_local const ShardIndexHolder holder;
+  return holder.GetIndex();
+}
+
+LatencyHistogram::Shard *LatencyHistogram::GetShard(size_t shard_index) {
+  auto &slot = shards_[shard_index];
+  Shard *shard = slot.load(std::memory_order_acquire);
+  if (shard != nullptr) {
+    return shard;
+  }
+  auto new_shard = new (std::nothrow) Shard();
+  if (new_shard == nullptr) {
+    return nullptr;
+  }
+  if (slot.compare_exchange_strong(shard, new_shard, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    return new_shard;
+  }
+  delete new_shard;
+  return shard;
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+  const size_t shard_index = GetLocalShardIndex();
+  Shard *shard = GetShard(shard_index);
+  if (shard == nullptr) {
+    return;
+  }
+  auto &bucket = shard->buckets[GetBucketIndex(value)];
+  if (shard_index < kMaxShardNum) {
+    AddOwned(bucket, 1UL);
+    AddOwned(shard->total, value);
+    if (shard->max.load(std::memory_order_relaxed) < value) {
+      shard->max.store(value, std::memory_order_relaxed);
+    }
+    if (shard->min.load(std::memory_order_relaxed) > value) {
+      shard->min.store(value, std::memory_order_relaxed);
+    }
+    return;
+  }
+  (void)bucket.fetch_add(1UL, std::memory_order_relaxed);
+  (void)shard->total.fetch_add(value, std::memory_order_relaxed);
+  uint64_t current = shard->max.load(std::memory_order_relaxed);
+  while ((current < value) &&
+         !shard->max.compare_exchange_weak(current, value, std::memory_order_relaxed, std::memory_order_relaxed)) {
+  }
+  current = shard->min.load(std::memory_order_relaxed);
+  while ((current > value) &&
+         !shard->min.compare_exchange_weak(current, value, std::memory_order_relaxed, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Reset() {
+  for (auto &slot : shards_) {
+    Shard *shard = slot.load(std::memory_order_acquire);
+    if (shard != nullptr) {
+      shard->Reset();
+    }
+  }
+}
+
+LatencySnapshot LatencyHistogram::Snapshot() const {
+  LatencySnapshot snapshot;
+  std::vector<uint64_t> counts(kBucketNum, 0UL);
+  uint64_t min = std::numeric_limits<uint64_t>::max();
+  for (const auto &slot : shards_) {
+    const Shard *shard = slot.load(std::memory_order_acquire);
+    if (shard == nullptr) {
+      continue;
+    }
+    for (size_t i = 0U; i < kBucketNum; ++i) {
+      const uint64_t count = shard->buckets[i].load(std::memory_order_relaxed);
+      counts[i] += count;
+      snapshot.count += count;
+    }
+    snapshot.total += shard->total.load(std::memory_order_relaxed);
+    min = std::min(min, shard->min.load(std::memory_order_relaxed));
+    snapshot.max = std::max(snapshot.max, shard->max.load(std::memory_order_relaxed));
+  }
+  if (snapshot.count == 0UL) {
+    return LatencySnapshot{};
+  }
+  snapshot.min = std::min(min, snapshot.max);
+  snapshot.p50 = GetValueAtPercentile(counts, snapshot.count, 500UL, snapshot);
+  snapshot.p90 = GetValueAtPercentile(counts, snapshot.count, 900UL, snapshot);
+  snapshot.p99 = GetValueAtPercentile(counts, snapshot.count, 990UL, snapshot);
+  snapshot.p999 = GetValueAtPercentile(counts, snapshot.count, 999UL, snapshot);
+  return snapshot;
+}
+}  // namespace adxl
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef HIXL_ADXL_LATENCY_HISTOGRAM_H_
+#define HIXL_ADXL_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace adxl {
+struct LatencySnapshot {
+  uint64_t count = 0UL;
+  uint64_t total = 0UL;
+  uint64_t min = 0UL;
+  uint64_t max = 0UL;
+  uint64_t p50 = 0UL;
+  uint64_t p90 = 0UL;
+  uint64_t p99 = 0UL;
+  uint64_t p999 = 0UL;
+
+  uint64_t GetAvg() const {
+    return count == 0UL ? 0UL : total / count;
+  }
+};
+
+// Log-linear histogram in the HDR style: values below kSubBucketNum get their own bucket, every power of two
+// above is split into kSubBucketNum linear buckets, so the relative error of a percentile is at most 1/32.
+// Each recording thread owns a shard and updates it with relaxed loads and stores, no read-modify-write, threads
+// beyond kMaxShardNum share one extra shard with fetch_add. Shards are merged when taking a snapshot.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kSubBucketBits = 5U;
+  static constexpr size_t kSubBucketNum = 1UL << kSubBucketBits;
+  static constexpr size_t kMaxValueBits = 32U;  // larger values are counted in the last bucket
+  static constexpr size_t kBucketNum = (kMaxValueBits - kSubBucketBits + 1U) << kSubBucketBits;
+  static constexpr size_t kMaxShardNum = 32U;
+
+  LatencyHistogram() = default;
+  ~LatencyHistogram();
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+  void Record(uint64_t value);
+  // concurrent records may survive a reset
+  void Reset();
+  LatencySnapshot Snapshot() const;
+
+  static size_t GetBucketIndex(uint64_t value);
+  static uint64_t GetBucketLowerBound(size_t index);
+  static uint64_t GetBucketUpperBound(size_t index);
+
+ private:
+  struct alignas(64) Shard {
+    Shard();
+    void Reset();
+    std::array<std::atomic<uint64_t>, kBucketNum> buckets;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
+  };
+
+  Shard *GetShard(size_t shard_index);
+  static size_t GetLocalShardIndex();
+
+  // the last one is shared by threads without an own shard
+  std::array<std::atomic<Shard *>, kMaxShardNum + 1U> shards_{};
+};
+}  // namespace adxl
+
+#endif  // HIXL_ADXL_LATENCY_HISTOGRAM_H_
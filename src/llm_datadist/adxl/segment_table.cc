@@ -13,50 +13,97 @@
 #include "common/llm_inner_types.h"
 
 namespace adxl {
-void SegmentTable::RemoveChannel(const std::string &channel_id) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto it = channel_2_segment_.find(channel_id);
-  if (it != channel_2_segment_.end()) {
-    channel_2_segment_.erase(it);
+namespace {
+// versions are unique over all tables, so a snapshot cached by a thread is never mistaken for another table's
+std::atomic<uint64_t> g_next_version{1UL};
+
+uint64_t NextVersion() {
+  return g_next_version.fetch_add(1UL, std::memory_order_relaxed);
+}
+}  // namespace
+
+SegmentTable::SegmentTable() {
+  Publish({}, NextVersion());
+}
+
+const SegmentTable::Snapshot *SegmentTable::GetSnapshot() const {
+  thread_local uint64_t cached_version = 0UL;
+  thread_local SnapshotPtr cached_snapshot;
+  // one atomic load when nothing changed since the last lookup of this thread
+  if ((cached_snapshot == nullptr) || (cached_version != version_.load(std::memory_order_acquire))) {
+    cached_snapshot = std::atomic_load(&snapshot_);
+    cached_version = cached_snapshot->version;
   }
+  return cached_snapshot.get();
 }
 
-void SegmentTable::AddRange(const std::string &channel_id, uint64_t start, uint64_t end, MemType type) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto &segments = channel_2_segment_[channel_id];
-  auto it = std::find_if(segments.begin(), segments.end(),
-                         [type](const SegmentPtr &seg) { return seg->GetMemType() == type; });
-  if (it != segments.end()) {
-    (*it)->AddRange(start, end);
-  } else {
+void SegmentTable::Publish(std::unordered_map<std::string, ChannelSegmentsPtr> channel_2_segments,
+                           uint64_t version) {
+  auto snapshot = std::make_shared<Snapshot>();
+  snapshot->version = version;
+  snapshot->channel_2_segments = std::move(channel_2_segments);
+  std::atomic_store(&snapshot_, SnapshotPtr(std::move(snapshot)));
+  version_.store(version, std::memory_order_release);
+}
+
+void SegmentTable::UpdateSegment(const std::string &channel_id, MemType type, bool create,
+                                 const std::function<void(Segment &)> &update) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  auto channel_2_segments = snapshot_->channel_2_segments;
+  auto channel_it = channel_2_segments.find(channel_id);
+  if ((channel_it == channel_2_segments.end()) && !create) {
+    return;
+  }
+  auto channel = std::make_shared<ChannelSegments>();
+  if (channel_it != channel_2_segments.end()) {
+    *channel = *channel_it->second;
+  }
+  auto it = std::find_if(channel->segments.begin(), channel->segments.end(),
+                         [type](const ConstSegmentPtr &seg) { return seg->GetMemType() == type; });
+  if (it != channel->segments.end()) {
+    // published segments are shared with readers, change a copy
+    auto new_segment = std::make_shared<Segment>(**it);
+    update(*new_segment);
+    *it = new_segment;
+  } else if (create) {
     auto new_segment = std::make_shared<Segment>(type);
-    new_segment->AddRange(start, end);
-    segments.push_back(new_segment);
+    update(*new_segment);
+    channel->segments.push_back(new_segment);
+  } else {
+    return;
   }
+  const uint64_t version = NextVersion();
+  channel->version = version;
+  channel_2_segments[channel_id] = channel;
+  Publish(std::move(channel_2_segments), version);
 }
 
-void SegmentTable::RemoveRange(const std::string &channel_id, uint64_t start, uint64_t end, MemType type) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto channel_it = channel_2_segment_.find(channel_id);
-  if (channel_it == channel_2_segment_.end()) {
+void SegmentTable::RemoveChannel(const std::string &channel_id) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  if (snapshot_->channel_2_segments.count(channel_id) == 0U) {
     return;
   }
-  auto &segments = channel_it->second;
-  auto it = std::find_if(segments.begin(), segments.end(),
-                         [type](const SegmentPtr &seg) { return seg->GetMemType() == type; });
-  if (it != segments.end()) {
-    (*it)->RemoveRange(start, end);
-  }
+  auto channel_2_segments = snapshot_->channel_2_segments;
+  (void)channel_2_segments.erase(channel_id);
+  Publish(std::move(channel_2_segments), NextVersion());
+}
+
+void SegmentTable::AddRange(const std::string &channel_id, uint64_t start, uint64_t end, MemType type) {
+  UpdateSegment(channel_id, type, true, [start, end](Segment &segment) { segment.AddRange(start, end); });
+}
+
+void SegmentTable::RemoveRange(const std::string &channel_id, uint64_t start, uint64_t end, MemType type) {
+  UpdateSegment(channel_id, type, false, [start, end](Segment &segment) { segment.RemoveRange(start, end); });
 }
 
-SegmentPtr SegmentTable::FindSegment(const std::string &channel_id, uint64_t start, uint64_t end) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto channel_it = channel_2_segment_.find(channel_id);
-  if (channel_it == channel_2_segment_.end()) {
+ConstSegmentPtr SegmentTable::FindSegment(const std::string &channel_id, uint64_t start, uint64_t end) const {
+  const Snapshot *snapshot = GetSnapshot();
+  auto channel_it = snapshot->channel_2_segments.find(channel_id);
+  if (channel_it == snapshot->channel_2_segments.end()) {
     return nullptr;
   }
   // only two segments: MEM_DEVICE and MEM_HOST
-  for (const auto &segment : channel_it->second) {
+  for (const auto &segment : channel_it->second->segments) {
     if (segment->Contains(start, end)) {
       return segment;
     }
@@ -64,12 +111,28 @@ SegmentPtr SegmentTable::FindSegment(const std::string &channel_id, uint64_t sta
   return nullptr;
 }
 
+bool SegmentTable::FindMemType(const std::string &channel_id, uint64_t start, uint64_t end, MemType &type) const {
+  const Snapshot *snapshot = GetSnapshot();
+  auto channel_it = snapshot->channel_2_segments.find(channel_id);
+  if (channel_it == snapshot->channel_2_segments.end()) {
+    return false;
+  }
+  for (const auto &segment : channel_it->second->segments) {
+    if (segment->Contains(start, end)) {
+      type = segment->GetMemType();
+      return true;
+    }
+  }
+  return false;
+}
+
 void Segment::AddRange(uint64_t start, uint64_t end) {
   auto it = std::upper_bound(ranges_.begin(), ranges_.end(), start,
                              [](uint64_t val, const std::pair<uint64_t, uint64_t> &range) {
                                return val < range.first;
                              });
   ranges_.insert(it, {start, end});
+  cover_index_.Build(ranges_);
 }
 
 void Segment::RemoveRange(uint64_t start, uint64_t end) {
@@ -80,6 +143,7 @@ void Segment::RemoveRange(uint64_t start, uint64_t end) {
   for (; it != ranges_.end() && it->first == start; ++it) {
     if (it->second == end) {
       ranges_.erase(it);
+      cover_index_.Build(ranges_);
       LLMLOGI("Remove range %lu-%lu, left ranges size:%zu", start, end, ranges_.size());
       return;
     }
@@ -87,45 +151,7 @@ void Segment::RemoveRange(uint64_t start, uint64_t end) {
 }
 
 bool Segment::Contains(uint64_t start, uint64_t end) const {
-  if (start > end) {
-    return false;
-  }
-  auto it = std::upper_bound(ranges_.begin(), ranges_.end(), start,
-                             [](uint64_t val, const std::pair<uint64_t, uint64_t> &range) {
-                               return val < range.first;
-                             });
-
-  uint64_t max_reached = start;
-  bool covered_start = false;
-  // left range make sure range.start <= start
-  for (auto r_it = std::make_reverse_iterator(it); r_it != ranges_.rend(); ++r_it) {
-    if (r_it->second > start) {
-      if (r_it->second > max_reached) {
-        max_reached = r_it->second;
-      }
-      covered_start = true;
-      if (max_reached >= end) {
-        return true;
-      }
-    }
-  }
-
-  if (!covered_start) {
-    return false;
-  }
-
-  for (; it != ranges_.end(); ++it) {
-    if (it->first > (max_reached + 1)) {
-      break;
-    }
-    if (it->second > max_reached) {
-      max_reached = it->second;
-      if (max_reached >= end) {
-        return true;
-      }
-    }
-  }
-  return max_reached >= end;
+  return cover_index_.Contains(start, end);
 }
 
 MemType Segment::GetMemType() const {
@@ -11,10 +11,15 @@
 #ifndef CANN_GRAPH_ENGINE_RUNTIME_ADXL_SEGMENT_TABLE_H_
 #define CANN_GRAPH_ENGINE_RUNTIME_ADXL_SEGMENT_TABLE_H_
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <mutex>
 #include "adxl/adxl_types.h"
+#include "common/range_cover_index.h"
 
 namespace adxl {
 class Segment {
@@ -27,23 +32,48 @@ class Segment {
 
  private:
   std::vector<std::pair<uint64_t, uint64_t>> ranges_;
+  hixl::RangeCoverIndex cover_index_;  // rebuilt on every range change
   MemType mem_type_;
 };
 
 using SegmentPtr = std::shared_ptr<Segment>;
+using ConstSegmentPtr = std::shared_ptr<const Segment>;
+
+// Readers look up an immutable snapshot without locking, writers copy the segments of the changed channel,
+// modify the copy and publish a new snapshot. A segment returned by FindSegment is never modified afterwards.
 class SegmentTable {
  public:
-  SegmentTable() = default;
+  SegmentTable();
 
   void AddRange(const std::string &channel_id, uint64_t start, uint64_t end, MemType type);
   void RemoveRange(const std::string &channel_id, uint64_t start, uint64_t end, MemType type);
-  SegmentPtr FindSegment(const std::string &channel_id, uint64_t start, uint64_t end);
+  ConstSegmentPtr FindSegment(const std::string &channel_id, uint64_t start, uint64_t end) const;
+  // same lookup as FindSegment without touching the reference count of the segment
+  bool FindMemType(const std::string &channel_id, uint64_t start, uint64_t end, MemType &type) const;
   void RemoveChannel(const std::string &channel_id);
 
  private:
-  // mutex for channel_2_segment_
-  std::mutex map_mutex_;
-  std::unordered_map<std::string, std::vector<SegmentPtr>> channel_2_segment_;
+  struct ChannelSegments {
+    uint64_t version = 0UL;
+    std::vector<ConstSegmentPtr> segments;
+  };
+  using ChannelSegmentsPtr = std::shared_ptr<const ChannelSegments>;
+  struct Snapshot {
+    uint64_t version = 0UL;
+    std::unordered_map<std::string, ChannelSegmentsPtr> channel_2_segments;
+  };
+  using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+  const Snapshot *GetSnapshot() const;
+  void Publish(std::unordered_map<std::string, ChannelSegmentsPtr> channel_2_segments, uint64_t version);
+  void UpdateSegment(const std::string &channel_id, MemType type, bool create,
+                     const std::function<void(Segment &)> &update);
+
+  // serializes writers, readers never take it
+  std::mutex write_mutex_;
+  SnapshotPtr snapshot_;
+  // version of snapshot_, readers only reload snapshot_ when it changes
+  std::atomic<uint64_t> version_{0UL};
 };
 }  // namespace adxl
 
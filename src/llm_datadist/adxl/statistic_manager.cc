@@ -8,13 +8,24 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 
-#include "common/llm_log.h"
 #include "statistic_manager.h"
+#include <sstream>
+#include "common/llm_log.h"
+
 namespace adxl {
 namespace {
 constexpr uint64_t kResetTimes = 100000UL;
 constexpr uint64_t kFabricMemResetTimes = 10000UL;
+
+std::string ToString(const char *name, const LatencySnapshot &snapshot) {
+  std::stringstream ss;
+  ss << name << " times:" << snapshot.count << ", max cost:" << snapshot.max << " us, avg cost:" << snapshot.GetAvg()
+     << " us, p50:" << snapshot.p50 << " us, p90:" << snapshot.p90 << " us, p99:" << snapshot.p99
+     << " us, p999:" << snapshot.p999 << " us";
+  return ss.str();
+}
 }  // namespace
+
 StatisticManager &StatisticManager::GetInstance() {
   static StatisticManager instance;
   return instance;
@@ -25,77 +36,76 @@ void StatisticManager::SetEnableUseFabricMem(bool enable_use_frabric_mem) {
 }
 
 void StatisticManager::RemoveChannel(const std::string &channel_id) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
+  std::lock_guard<std::shared_mutex> lock(map_mutex_);
   auto it = transfer_statistic_info_.find(channel_id);
   if (it != transfer_statistic_info_.end()) {
     transfer_statistic_info_.erase(it);
   }
 }
 
-void StatisticManager::UpdateCost(const uint64_t cost, std::atomic<uint64_t> &total_times,
-                                  std::atomic<uint64_t> &max_cost, std::atomic<uint64_t> &total_cost) {
-  (void)total_times.fetch_add(1U, std::memory_order_relaxed);
-  (void)total_cost.fetch_add(cost, std::memory_order_relaxed);
-  if (max_cost.load() < cost) {
-    max_cost.store(cost, std::memory_order_relaxed);
+LatencyHistogram &StatisticManager::GetHistogram(StatisticInfo &info, StatisticCostType type) {
+  switch (type) {
+    case StatisticCostType::kBufferTransfer:
+      return info.buffer_transfer_statistic_info.transfer_cost;
+    case StatisticCostType::kClientCopy:
+      return info.buffer_transfer_statistic_info.client_copy_cost;
+    case StatisticCostType::kServerD2D:
+      return info.buffer_transfer_statistic_info.server_d2d_cost;
+    case StatisticCostType::kServerCopy:
+      return info.buffer_transfer_statistic_info.server_copy_cost;
+    case StatisticCostType::kFabricMemTransfer:
+      return info.fabric_mem_transfer_statistic_info.transfer_cost;
+    default:
+      return info.fabric_mem_transfer_statistic_info.real_copy_cost;
   }
 }
 
-void StatisticManager::UpdateBufferTransferCost(const std::string &channel_id, uint64_t cost) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto &info = transfer_statistic_info_[channel_id];
-  UpdateCost(cost, info.buffer_transfer_statistic_info.transfer_times,
-             info.buffer_transfer_statistic_info.transfer_max_cost,
-             info.buffer_transfer_statistic_info.transfer_total_cost);
-  if (info.buffer_transfer_statistic_info.transfer_times.load(std::memory_order_relaxed) > kResetTimes) {
-    info.buffer_transfer_statistic_info.Reset();
+void StatisticManager::RecordCost(const std::string &channel_id, StatisticCostType type, uint64_t cost) {
+  {
+    std::shared_lock<std::shared_mutex> lock(map_mutex_);
+    const auto it = transfer_statistic_info_.find(channel_id);
+    if (it != transfer_statistic_info_.end()) {
+      GetHistogram(it->second, type).Record(cost);
+      return;
+    }
   }
+  std::lock_guard<std::shared_mutex> lock(map_mutex_);
+  GetHistogram(transfer_statistic_info_[channel_id], type).Record(cost);
+}
+
+void StatisticManager::UpdateBufferTransferCost(const std::string &channel_id, uint64_t cost) {
+  RecordCost(channel_id, StatisticCostType::kBufferTransfer, cost);
 }
 
 void StatisticManager::UpdateClientCopyCost(const std::string &channel_id, uint64_t cost) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto &info = transfer_statistic_info_[channel_id];
-  UpdateCost(cost, info.buffer_transfer_statistic_info.client_copy_times,
-             info.buffer_transfer_statistic_info.client_copy_max_cost,
-             info.buffer_transfer_statistic_info.client_copy_total_cost);
+  RecordCost(channel_id, StatisticCostType::kClientCopy, cost);
 }
 
 void StatisticManager::UpdateServerD2DCost(const std::string &channel_id, uint64_t cost) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto &info = transfer_statistic_info_[channel_id];
-  UpdateCost(cost, info.buffer_transfer_statistic_info.server_d2d_times,
-             info.buffer_transfer_statistic_info.server_d2d_max_cost,
-             info.buffer_transfer_statistic_info.server_d2d_total_cost);
+  RecordCost(channel_id, StatisticCostType::kServerD2D, cost);
 }
 
 void StatisticManager::UpdateServerCopyCost(const std::string &channel_id, uint64_t cost) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto &info = transfer_statistic_info_[channel_id];
-  UpdateCost(cost, info.buffer_transfer_statistic_info.server_copy_times,
-             info.buffer_transfer_statistic_info.server_copy_max_cost,
-             info.buffer_transfer_statistic_info.server_copy_total_cost);
-  if (info.buffer_transfer_statistic_info.server_copy_times.load(std::memory_order_relaxed) > kResetTimes) {
-    info.buffer_transfer_statistic_info.Reset();
-  }
+  RecordCost(channel_id, StatisticCostType::kServerCopy, cost);
 }
 
 void StatisticManager::UpdateFabricMemTransferCost(const std::string &channel_id, uint64_t cost) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto &info = transfer_statistic_info_[channel_id];
-  UpdateCost(cost, info.fabric_mem_transfer_statistic_info.transfer_times,
-             info.fabric_mem_transfer_statistic_info.transfer_max_cost,
-             info.fabric_mem_transfer_statistic_info.transfer_total_cost);
-  if (info.fabric_mem_transfer_statistic_info.transfer_times.load(std::memory_order_relaxed) > kFabricMemResetTimes) {
-    info.fabric_mem_transfer_statistic_info.Reset();
-  }
+  RecordCost(channel_id, StatisticCostType::kFabricMemTransfer, cost);
 }
 
 void StatisticManager::UpdateFabricMemRealCopyCost(const std::string &channel_id, uint64_t cost) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto &info = transfer_statistic_info_[channel_id];
-  UpdateCost(cost, info.fabric_mem_transfer_statistic_info.real_copy_times,
-             info.fabric_mem_transfer_statistic_info.real_copy_max_cost,
-             info.fabric_mem_transfer_statistic_info.real_copy_total_cost);
+  RecordCost(channel_id, StatisticCostType::kFabricMemRealCopy, cost);
+}
+
+bool StatisticManager::GetCostSnapshot(const std::string &channel_id, StatisticCostType type,
+                                       LatencySnapshot &snapshot) {
+  std::shared_lock<std::shared_mutex> lock(map_mutex_);
+  const auto it = transfer_statistic_info_.find(channel_id);
+  if (it == transfer_statistic_info_.end()) {
+    return false;
+  }
+  snapshot = GetHistogram(it->second, type).Snapshot();
+  return true;
 }
 
 void StatisticManager::Dump() {
@@ -107,84 +117,39 @@ void StatisticManager::Dump() {
 }
 
 void StatisticManager::DumpBufferTransferStatisticInfo() {
-  std::lock_guard<std::mutex> lock(map_mutex_);
+  std::shared_lock<std::shared_mutex> lock(map_mutex_);
   for (auto &item : transfer_statistic_info_) {
-    auto &stat_info = item.second;
-    // cal avg time
-    auto transfer_times = stat_info.buffer_transfer_statistic_info.transfer_times.load(std::memory_order_relaxed);
-    const uint64_t buffer_transfer_avg_cost =
-        transfer_times == 0U
-            ? 0U
-            : stat_info.buffer_transfer_statistic_info.transfer_total_cost.load(std::memory_order_relaxed) /
-                  transfer_times;
-    // cal client copy avg time
-    auto client_copy_times = stat_info.buffer_transfer_statistic_info.client_copy_times.load(std::memory_order_relaxed);
-    const uint64_t client_copy_avg_cost =
-        client_copy_times == 0U
-            ? 0U
-            : stat_info.buffer_transfer_statistic_info.client_copy_total_cost.load(std::memory_order_relaxed) /
-                  client_copy_times;
-    // cal server d2d avg time
-    auto server_d2d_times = stat_info.buffer_transfer_statistic_info.server_d2d_times.load(std::memory_order_relaxed);
-    const uint64_t server_d2d_avg_cost =
-        server_d2d_times == 0U
-            ? 0U
-            : stat_info.buffer_transfer_statistic_info.server_d2d_total_cost.load(std::memory_order_relaxed) /
-                  server_d2d_times;
-    // cal server copy avg time
-    auto server_copy_times = stat_info.buffer_transfer_statistic_info.server_copy_times.load(std::memory_order_relaxed);
-    const uint64_t server_copy_avg_cost =
-        server_copy_times == 0U
-            ? 0U
-            : stat_info.buffer_transfer_statistic_info.server_copy_total_cost.load() / server_copy_times;
-    LLMEVENT(
-        "Buffer transfer statistic info[channel:%s, transfer times:%lu, max cost:%lu us, avg cost:%lu us, client copy "
-        "times:%lu, "
-        "max cost:%lu us, avg cost:%lu us, server comm times:%lu, max cost:%lu us, avg cost:%lu us, server "
-        "copy times:%lu, max cost:%lu us, avg cost:%lu us].",
-        item.first.c_str(), transfer_times,
-        stat_info.buffer_transfer_statistic_info.transfer_max_cost.load(std::memory_order_relaxed),
-        buffer_transfer_avg_cost, client_copy_times,
-        stat_info.buffer_transfer_statistic_info.client_copy_max_cost.load(std::memory_order_relaxed),
-        client_copy_avg_cost, server_d2d_times,
-        stat_info.buffer_transfer_statistic_info.server_d2d_max_cost.load(std::memory_order_relaxed),
-        server_d2d_avg_cost, server_copy_times,
-        stat_info.buffer_transfer_statistic_info.server_copy_max_cost.load(std::memory_order_relaxed),
-        server_copy_avg_cost);
+    auto &stat_info = item.second.buffer_transfer_statistic_info;
+    const auto transfer = stat_info.transfer_cost.Snapshot();
+    const auto client_copy = stat_info.client_copy_cost.Snapshot();
+    const auto server_d2d = stat_info.server_d2d_cost.Snapshot();
+    const auto server_copy = stat_info.server_copy_cost.Snapshot();
+    LLMEVENT("Buffer transfer statistic info[channel:%s, %s, %s, %s, %s].", item.first.c_str(),
+             ToString("transfer", transfer).c_str(), ToString("client copy", client_copy).c_str(),
+             ToString("server comm", server_d2d).c_str(), ToString("server copy", server_copy).c_str());
+    // start a new window once enough samples are dumped, so percentiles follow recent traffic
+    if ((transfer.count > kResetTimes) || (server_copy.count > kResetTimes)) {
+      stat_info.Reset();
+    }
   }
 }
 
 void StatisticManager::DumpFabricMemTransferStatisticInfo() {
-  std::lock_guard<std::mutex> lock(map_mutex_);
+  std::shared_lock<std::shared_mutex> lock(map_mutex_);
   for (auto &item : transfer_statistic_info_) {
-    auto &stat_info = item.second;
-    // cal avg time
-    auto transfer_times = stat_info.fabric_mem_transfer_statistic_info.transfer_times.load(std::memory_order_relaxed);
-    const uint64_t fabric_mem_transfer_avg_cost =
-        transfer_times == 0U
-            ? 0U
-            : stat_info.fabric_mem_transfer_statistic_info.transfer_total_cost.load(std::memory_order_relaxed) /
-                  transfer_times;
-    // cal real copy avg time
-    auto real_copy_times = stat_info.fabric_mem_transfer_statistic_info.real_copy_times.load(std::memory_order_relaxed);
-    const uint64_t real_copy_avg_cost =
-        real_copy_times == 0U
-            ? 0U
-            : stat_info.fabric_mem_transfer_statistic_info.real_copy_total_cost.load(std::memory_order_relaxed) /
-                  real_copy_times;
-    LLMEVENT(
-        "Fabric mem transfer statistic info[channel:%s, transfer times:%lu, max cost:%lu us, avg cost:%lu us, real "
-        "copy times:%lu, max cost:%lu us, avg cost:%lu us].",
-        item.first.c_str(), transfer_times,
-        stat_info.fabric_mem_transfer_statistic_info.transfer_max_cost.load(std::memory_order_relaxed),
-        fabric_mem_transfer_avg_cost, real_copy_times,
-        stat_info.fabric_mem_transfer_statistic_info.real_copy_max_cost.load(std::memory_order_relaxed),
-        real_copy_avg_cost);
+    auto &stat_info = item.second.fabric_mem_transfer_statistic_info;
+    const auto transfer = stat_info.transfer_cost.Snapshot();
+    const auto real_copy = stat_info.real_copy_cost.Snapshot();
+    LLMEVENT("Fabric mem transfer statistic info[channel:%s, %s, %s].", item.first.c_str(),
+             ToString("transfer", transfer).c_str(), ToString("real copy", real_copy).c_str());
+    if (transfer.count > kFabricMemResetTimes) {
+      stat_info.Reset();
+    }
   }
 }
 
 void StatisticManager::Reset() {
-  std::lock_guard<std::mutex> lock(map_mutex_);
+  std::shared_lock<std::shared_mutex> lock(map_mutex_);
   for (auto &item : transfer_statistic_info_) {
     auto &stat_info = item.second;
     stat_info.buffer_transfer_statistic_info.Reset();
@@ -10,54 +10,43 @@
 #ifndef HIXL_ADXL_STATISTIC_MANAGER_H_
 #define HIXL_ADXL_STATISTIC_MANAGER_H_
 
-#include <atomic>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "latency_histogram.h"
+
 namespace adxl {
+enum class StatisticCostType : uint32_t {
+  kBufferTransfer = 0U,
+  kClientCopy,
+  kServerD2D,
+  kServerCopy,
+  kFabricMemTransfer,
+  kFabricMemRealCopy
+};
+
 struct BufferTransferStatisticInfo {
-  std::atomic<uint64_t> transfer_times = 0UL;
-  std::atomic<uint64_t> transfer_max_cost = 0UL;
-  std::atomic<uint64_t> transfer_total_cost = 0UL;
-  std::atomic<uint64_t> client_copy_max_cost = 0UL;
-  std::atomic<uint64_t> client_copy_total_cost = 0UL;
-  std::atomic<uint64_t> client_copy_times = 0UL;
-  std::atomic<uint64_t> server_d2d_max_cost = 0UL;
-  std::atomic<uint64_t> server_d2d_total_cost = 0UL;
-  std::atomic<uint64_t> server_d2d_times = 0UL;
-  std::atomic<uint64_t> server_copy_max_cost = 0UL;
-  std::atomic<uint64_t> server_copy_total_cost = 0UL;
-  std::atomic<uint64_t> server_copy_times = 0UL;
+  LatencyHistogram transfer_cost;
+  LatencyHistogram client_copy_cost;
+  LatencyHistogram server_d2d_cost;
+  LatencyHistogram server_copy_cost;
 
   void Reset() {
-    transfer_times.store(0UL);
-    transfer_max_cost.store(0UL);
-    transfer_total_cost.store(0UL);
-    client_copy_max_cost.store(0UL);
-    client_copy_total_cost.store(0UL);
-    client_copy_times.store(0UL);
-    server_d2d_max_cost.store(0UL);
-    server_d2d_total_cost.store(0UL);
-    server_d2d_times.store(0UL);
-    server_copy_max_cost.store(0UL);
-    server_copy_total_cost.store(0UL);
-    server_copy_times.store(0UL);
+    transfer_cost.Reset();
+    client_copy_cost.Reset();
+    server_d2d_cost.Reset();
+    server_copy_cost.Reset();
   }
 };
 
 struct FabricMemTransferStatisticInfo {
-  std::atomic<uint64_t> transfer_times = 0UL;
-  std::atomic<uint64_t> transfer_max_cost = 0UL;
-  std::atomic<uint64_t> transfer_total_cost = 0UL;
-  std::atomic<uint64_t> real_copy_max_cost = 0UL;
-  std::atomic<uint64_t> real_copy_total_cost = 0UL;
-  std::atomic<uint64_t> real_copy_times = 0UL;
+  LatencyHistogram transfer_cost;
+  LatencyHistogram real_copy_cost;
 
   void Reset() {
-    transfer_times.store(0UL);
-    transfer_max_cost.store(0UL);
-    transfer_total_cost.store(0UL);
-    real_copy_max_cost.store(0UL);
-    real_copy_total_cost.store(0UL);
-    real_copy_times.store(0UL);
+    transfer_cost.Reset();
+    real_copy_cost.Reset();
   }
 };
 
@@ -87,16 +76,18 @@ class StatisticManager {
 
   void SetEnableUseFabricMem(bool enable_use_frabric_mem);
   void RemoveChannel(const std::string &channel_id);
+  // merged view of the per-thread histograms, false if the channel has no statistic
+  bool GetCostSnapshot(const std::string &channel_id, StatisticCostType type, LatencySnapshot &snapshot);
 
  private:
   StatisticManager() = default;
-  static void UpdateCost(uint64_t cost, std::atomic<uint64_t> &total_times, std::atomic<uint64_t> &max_cost,
-                         std::atomic<uint64_t> &total_cost);
+  void RecordCost(const std::string &channel_id, StatisticCostType type, uint64_t cost);
+  static LatencyHistogram &GetHistogram(StatisticInfo &info, StatisticCostType type);
   void DumpBufferTransferStatisticInfo();
   void DumpFabricMemTransferStatisticInfo();
 
   bool enable_use_frabric_mem_ = false;
-  std::mutex map_mutex_;
+  std::shared_mutex map_mutex_;
   std::unordered_map<std::string, StatisticInfo> transfer_statistic_info_;
 };
 }  // namespace adxl
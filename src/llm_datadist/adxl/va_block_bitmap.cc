@@ -0,0 +1,253 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. See LICENSE in the root of
+ * the software repository for the full text of the License.
+ */
+
+#include "va_block_bitmap.h"
+#include <algorithm>
+
+namespace adxl {
+namespace {
+constexpr size_t kWordBits = 64U;
+constexpr size_t kWordShift = 6U;
+constexpr size_t kBitMask = kWordBits - 1U;
+constexpr uint64_t kFullWord = ~uint64_t{0U};
+
+// bits [offset, offset + count) of a word, count is at most kWordBits - offset
+uint64_t MakeMask(size_t offset, size_t count) {
+  const uint64_t bits = (count >= kWordBits) ? kFullWord : ((uint64_t{1U} << count) - 1U);
+  return bits << offset;
+}
+}  // namespace
+
+void VaBlockBitmap::Init(size_t block_num) {
+  block_num_ = block_num;
+  levels_.clear();
+  size_t bit_num = block_num;
+  while (bit_num > 0U) {
+    const size_t word_num = (bit_num + kBitMask) >> kWordShift;
+    levels_.emplace_back(word_num);
+    auto &level = levels_.back();
+    const bool is_leaf = (levels_.size() == 1U);
+    for (size_t i = 0U; i < word_num; ++i) {
+      const size_t valid_num = std::min(kWordBits, bit_num - (i << kWordShift));
+      // blocks beyond block_num are marked used so they are never found
+      const Word word = is_leaf ? ~MakeMask(0U, valid_num) : MakeMask(0U, valid_num);
+      level[i].store(word, std::memory_order_relaxed);
+    }
+    bit_num = (word_num > 1U) ? word_num : 0U;
+  }
+  free_blocks_.store(block_num, std::memory_order_relaxed);
+  rollback_count_.store(0UL, std::memory_order_relaxed);
+}
+
+VaBlockBitmap::Word VaBlockBitmap::GetFreeBits(size_t level, size_t word_index) const {
+  const Word word = levels_[level][word_index].load();
+  return (level == 0U) ? ~word : word;
+}
+
+bool VaBlockBitmap::IsUsed(size_t block) const {
+  return (block >= block_num_) || ((GetFreeBits(0U, block >> kWordShift) & (Word{1U} << (block & kBitMask))) == 0U);
+}
+
+size_t VaBlockBitmap::FindFree(size_t from) const {
+  while (from < block_num_) {
+    size_t index = from;
+    size_t level = 0U;
+    bool found = false;
+    for (; level < levels_.size(); ++level) {
+      const size_t word_index = index >> kWordShift;
+      if (word_index >= levels_[level].size()) {
+        return kNotFound;
+      }
+      const Word bits = GetFreeBits(level, word_index) & (kFullWord << (index & kBitMask));
+      if (bits != 0U) {
+        index = (word_index << kWordShift) + static_cast<size_t>(__builtin_ctzll(bits));
+        found = true;
+        break;
+      }
+      index = word_index + 1U;
+    }
+    if (!found) {
+      return kNotFound;
+    }
+    bool stale = false;
+    while (level > 0U) {
+      --level;
+      const Word bits = GetFreeBits(level, index);
+      if (bits == 0U) {
+        stale = true;
+        break;
+      }
+      index = (index << kWordShift) + static_cast<size_t>(__builtin_ctzll(bits));
+    }
+    if (!stale) {
+      return index;
+    }
+    // the hint was stale, word index of this level is used up, skip the blocks it covers
+    from = (index + 1U) << (kWordShift * (level + 1U));
+  }
+  return kNotFound;
+}
+
+size_t VaBlockBitmap::GetFreeRun(size_t start, size_t max_count) const {
+  size_t run = 0U;
+  size_t pos = start;
+  while ((run < max_count) && (pos < block_num_)) {
+    const size_t offset = pos & kBitMask;
+    const Word used = levels_[0U][pos >> kWordShift].load() >> offset;
+    const size_t avail = kWordBits - offset;
+    const size_t free_num = (used == 0U) ? avail : std::min(avail, static_cast<size_t>(__builtin_ctzll(used)));
+    run += free_num;
+    pos += free_num;
+    if (free_num < avail) {
+      break;
+    }
+  }
+  return run;
+}
+
+bool VaBlockBitmap::TryClaim(size_t start, size_t count) {
+  const size_t end = start + count;
+  size_t pos = start;
+  while (pos < end) {
+    const size_t word_index = pos >> kWordShift;
+    const size_t offset = pos & kBitMask;
+    const size_t num = std::min(kWordBits - offset, end - pos);
+    const Word mask = MakeMask(offset, num);
+    auto &word = levels_[0U][word_index];
+    Word expected = word.load();
+    bool claimed = false;
+    while ((expected & mask) == 0U) {
+      if (word.compare_exchange_weak(expected, expected | mask)) {
+        claimed = true;
+        break;
+      }
+    }
+    if (!claimed) {
+      ReleaseBits(start, pos - start);
+      (void)rollback_count_.fetch_add(1UL);
+      return false;
+    }
+    if ((expected | mask) == kFullWord) {
+      OnWordFull(0U, word_index);
+    }
+    pos += num;
+  }
+  return true;
+}
+
+void VaBlockBitmap::ReleaseBits(size_t start, size_t count) {
+  const size_t end = start + count;
+  size_t pos = start;
+  while (pos < end) {
+    const size_t word_index = pos >> kWordShift;
+    const size_t offset = pos & kBitMask;
+    const size_t num = std::min(kWordBits - offset, end - pos);
+    const Word old = levels_[0U][word_index].fetch_and(~MakeMask(offset, num));
+    if (old == kFullWord) {
+      OnWordHasFree(0U, word_index);
+    }
+    pos += num;
+  }
+}
+
+void VaBlockBitmap::OnWordFull(size_t level, size_t word_index) {
+  while (level + 1U < levels_.size()) {
+    const Word bit = Word{1U} << (word_index & kBitMask);
+    auto &parent = levels_[level + 1U][word_index >> kWordShift];
+    const Word old = parent.fetch_and(~bit);
+    // a release may have freed the word meanwhile and found the hint still set, restore the hint for it
+    if (GetFreeBits(level, word_index) != 0U) {
+      OnWordHasFree(level, word_index);
+      return;
+    }
+    if ((old & ~bit) != 0U) {
+      return;
+    }
+    ++level;
+    word_index >>= kWordShift;
+  }
+}
+
+void VaBlockBitmap::OnWordHasFree(size_t level, size_t word_index) {
+  while (level + 1U < levels_.size()) {
+    const Word bit = Word{1U} << (word_index & kBitMask);
+    const Word old = levels_[level + 1U][word_index >> kWordShift].fetch_or(bit);
+    // the parent was already marked, or whoever is clearing it rechecks after us
+    if (old != 0U) {
+      return;
+    }
+    ++level;
+    word_index >>= kWordShift;
+  }
+}
+
+bool VaBlockBitmap::Reserve(size_t count, size_t &start_block) {
+  if ((count == 0U) || (count > block_num_)) {
+    return false;
+  }
+  while (true) {
+    const uint64_t rollback_count = rollback_count_.load();
+    if (free_blocks_.load(std::memory_order_relaxed) < count) {
+      return false;
+    }
+    size_t start = FindFree(0U);
+    while ((start != kNotFound) && (block_num_ - start >= count)) {
+      const size_t run = GetFreeRun(start, count);
+      if (run < count) {
+        start = FindFree(start + run + 1U);
+        continue;
+      }
+      if (TryClaim(start, count)) {
+        (void)free_blocks_.fetch_sub(count, std::memory_order_relaxed);
+        start_block = start;
+        return true;
+      }
+      start = FindFree(start);
+    }
+    // a concurrent claim that was rolled back may have hidden the free range
+    if (rollback_count_.load() == rollback_count) {
+      return false;
+    }
+  }
+}
+
+void VaBlockBitmap::Release(size_t start_block, size_t count) {
+  if ((count == 0U) || (start_block >= block_num_) || (count > block_num_ - start_block)) {
+    return;
+  }
+  // count first so that the counter never drops below the real number of free blocks
+  (void)free_blocks_.fetch_add(count, std::memory_order_relaxed);
+  ReleaseBits(start_block, count);
+}
+
+VaBitmapStats VaBlockBitmap::GetStats() const {
+  VaBitmapStats stats;
+  stats.total_blocks = block_num_;
+  size_t run = 0U;
+  for (size_t block = 0U; block < block_num_; ++block) {
+    if (!IsUsed(block)) {
+      ++run;
+      continue;
+    }
+    if (run > 0U) {
+      stats.free_blocks += run;
+      stats.largest_free_run = std::max(stats.largest_free_run, run);
+      ++stats.free_fragments;
+      run = 0U;
+    }
+  }
+  if (run > 0U) {
+    stats.free_blocks += run;
+    stats.largest_free_run = std::max(stats.largest_free_run, run);
+    ++stats.free_fragments;
+  }
+  return stats;
+}
+}  // namespace adxl
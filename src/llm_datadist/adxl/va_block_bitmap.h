@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. See LICENSE in the root of
+ * the software repository for the full text of the License.
+ */
+
+#ifndef HIXL_ADXL_VA_BLOCK_BITMAP_H_
+#define HIXL_ADXL_VA_BLOCK_BITMAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace adxl {
+struct VaBitmapStats {
+  size_t total_blocks = 0U;
+  size_t free_blocks = 0U;
+  size_t largest_free_run = 0U;
+  size_t free_fragments = 0U;
+
+  // 0 when all free blocks are contiguous, close to 1 when they are scattered
+  double GetFragmentation() const {
+    return free_blocks == 0U ? 0.0 : 1.0 - static_cast<double>(largest_free_run) / static_cast<double>(free_blocks);
+  }
+};
+
+// Lock-free first-fit allocator of contiguous blocks. Bit i of levels_[0] is set when block i is used, bit j of
+// levels_[k + 1] is set when word j of levels_[k] still has a free block, the top level is a single word.
+// Summary bits are hints that may be stale for a moment, they are never left cleared for a word with free blocks,
+// so finding a free block is one find-first-set per level. A range spanning several words is claimed word by word
+// and rolled back on conflict.
+class VaBlockBitmap {
+ public:
+  static constexpr size_t kNotFound = SIZE_MAX;
+
+  VaBlockBitmap() = default;
+  ~VaBlockBitmap() = default;
+  VaBlockBitmap(const VaBlockBitmap &) = delete;
+  VaBlockBitmap &operator=(const VaBlockBitmap &) = delete;
+
+  // not thread safe, all blocks become free
+  void Init(size_t block_num);
+  bool Reserve(size_t count, size_t &start_block);
+  // the range must have been returned by Reserve
+  void Release(size_t start_block, size_t count);
+  bool IsUsed(size_t block) const;
+  size_t GetBlockNum() const {
+    return block_num_;
+  }
+  VaBitmapStats GetStats() const;
+
+ private:
+  using Word = uint64_t;
+  using Level = std::vector<std::atomic<Word>>;
+
+  Word GetFreeBits(size_t level, size_t word_index) const;
+  size_t FindFree(size_t from) const;
+  size_t GetFreeRun(size_t start, size_t max_count) const;
+  bool TryClaim(size_t start, size_t count);
+  void ReleaseBits(size_t start, size_t count);
+  void OnWordFull(size_t level, size_t word_index);
+  void OnWordHasFree(size_t level, size_t word_index);
+
+  size_t block_num_ = 0U;
+  std::vector<Level> levels_;
+  std::atomic<size_t> free_blocks_{0U};
+  // bumped on every rolled back claim, a failed search retries when it changed meanwhile
+  std::atomic<uint64_t> rollback_count_{0UL};
+};
+}  // namespace adxl
+
+#endif  // HIXL_ADXL_VA_BLOCK_BITMAP_H_
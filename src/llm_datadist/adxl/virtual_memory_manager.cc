@@ -11,6 +11,7 @@
 #include "virtual_memory_manager.h"
 #include <cstddef>
 #include <mutex>
+#include <shared_mutex>
 #include <dlfcn.h>
 #include "adxl/adxl_checker.h"
 #include "common/def_types.h"
@@ -36,7 +37,7 @@ void VirtualMemoryManager::SetSoName(const char *so_name) {
 }
 
 void VirtualMemoryManager::SetVirtualMemoryCapacity(size_t capacity_in_tb) {
-  std::lock_guard<std::mutex> lock(global_virtual_memory_mutex_);
+  std::lock_guard<std::shared_mutex> lock(global_virtual_memory_mutex_);
   if (initialized_) {
     LLMLOGE(PARAM_INVALID, "VirtualMemoryManager already initialized, cannot set capacity");
     return;
@@ -50,7 +51,7 @@ void VirtualMemoryManager::SetVirtualMemoryCapacity(size_t capacity_in_tb) {
 }
 
 Status VirtualMemoryManager::Initialize() {
-  std::lock_guard<std::mutex> lock(global_virtual_memory_mutex_);
+  std::lock_guard<std::shared_mutex> lock(global_virtual_memory_mutex_);
   if (initialized_) {
     return SUCCESS;
   }
@@ -85,23 +86,23 @@ Status VirtualMemoryManager::Initialize() {
   }
 
   global_virtual_memory_addr_ = llm::PtrToValue(global_virtual_memory_);
-  // Clear bitmap and allocations map
-  bitmap_.resize(num_blocks_, false);
-  allocations_.clear();
+  // Clear bitmap and allocation metadata
+  bitmap_.Init(num_blocks_);
+  block_counts_ = std::vector<std::atomic<size_t>>(num_blocks_);
   initialized_ = true;
   LLMLOGI("VirtualMemoryManager initialized, reserved base virtual mem address: %lu", global_virtual_memory_addr_);
   return SUCCESS;
 }
 
 void VirtualMemoryManager::Finalize() {
-  std::lock_guard<std::mutex> lock(global_virtual_memory_mutex_);
+  std::lock_guard<std::shared_mutex> lock(global_virtual_memory_mutex_);
   if (!initialized_) {
     return;
   }
 
-  // Clear bitmap and allocations map
-  bitmap_.clear();
-  allocations_.clear();
+  // Clear bitmap and allocation metadata
+  bitmap_.Init(0U);
+  block_counts_.clear();
   initialized_ = false;
 
   if (global_virtual_memory_ != nullptr) {
@@ -112,7 +113,7 @@ void VirtualMemoryManager::Finalize() {
 }
 
 Status VirtualMemoryManager::ReserveMemory(size_t size, uintptr_t &mem_addr) {
-  std::lock_guard<std::mutex> lock(global_virtual_memory_mutex_);
+  std::shared_lock<std::shared_mutex> lock(global_virtual_memory_mutex_);
 
   if (!initialized_) {
     LLMLOGE(PARAM_INVALID, "VirtualMemoryManager not initialized");
@@ -131,40 +132,22 @@ Status VirtualMemoryManager::ReserveMemory(size_t size, uintptr_t &mem_addr) {
     return RESOURCE_EXHAUSTED;
   }
 
-  // First-fit algorithm: find contiguous free blocks
+  // First-fit algorithm: find and claim contiguous free blocks
   size_t start_block = 0;
-  size_t contiguous_free = 0;
-  for (size_t i = 0; i < num_blocks_; ++i) {
-    if (!bitmap_[i]) {
-      if (contiguous_free == 0) {
-        start_block = i;
-      }
-      contiguous_free++;
-      if (contiguous_free >= blocks_needed) {
-        break;
-      }
-    } else {
-      contiguous_free = 0;
-    }
-  }
-
-  if (contiguous_free < blocks_needed) {
-    LLMLOGE(RESOURCE_EXHAUSTED, "Insufficient contiguous virtual memory blocks: needed %zu, found %zu", blocks_needed,
-            contiguous_free);
+  if (!bitmap_.Reserve(blocks_needed, start_block)) {
+    const auto stats = bitmap_.GetStats();
+    LLMLOGE(RESOURCE_EXHAUSTED,
+            "Insufficient contiguous virtual memory blocks: needed %zu, largest free run %zu, free blocks %zu",
+            blocks_needed, stats.largest_free_run, stats.free_blocks);
     return RESOURCE_EXHAUSTED;
   }
 
-  // Mark blocks as allocated
-  for (size_t i = start_block; i < start_block + blocks_needed; ++i) {
-    bitmap_[i] = true;
-  }
-
   // Calculate start address
   uintptr_t start_addr = global_virtual_memory_addr_ + start_block * kBlockSize;
   mem_addr = start_addr;
 
   // Store allocation metadata
-  allocations_[start_addr] = blocks_needed;
+  block_counts_[start_block].store(blocks_needed, std::memory_order_release);
 
   LLMLOGI("Reserved %zu bytes (%zu blocks) at address %lu, start block %zu", size, blocks_needed, start_addr,
           start_block);
@@ -172,7 +155,7 @@ Status VirtualMemoryManager::ReserveMemory(size_t size, uintptr_t &mem_addr) {
 }
 
 Status VirtualMemoryManager::ReleaseMemory(uintptr_t mem_addr) {
-  std::lock_guard<std::mutex> lock(global_virtual_memory_mutex_);
+  std::shared_lock<std::shared_mutex> lock(global_virtual_memory_mutex_);
 
   if (!initialized_) {
     LLMLOGE(PARAM_INVALID, "VirtualMemoryManager not initialized");
@@ -191,25 +174,24 @@ Status VirtualMemoryManager::ReleaseMemory(uintptr_t mem_addr) {
     return PARAM_INVALID;
   }
 
-  // Find the allocation in the metadata map
-  auto it = allocations_.find(mem_addr);
-  if (it == allocations_.end()) {
+  size_t block_index = (mem_addr - global_virtual_memory_addr_) / kBlockSize;
+
+  // Take the allocation out of the metadata, a concurrent release of the same address sees 0
+  size_t blocks = block_counts_[block_index].exchange(0U, std::memory_order_acq_rel);
+  if (blocks == 0U) {
     LLMLOGE(PARAM_INVALID, "Address %lu is not allocated or already released", mem_addr);
     return PARAM_INVALID;
   }
 
-  size_t blocks = it->second;
-  size_t block_index = (mem_addr - global_virtual_memory_addr_) / kBlockSize;
-
   // Clear the bitmap bits for the allocated blocks
-  for (size_t i = block_index; i < block_index + blocks; ++i) {
-    bitmap_[i] = false;
-  }
-
-  // Remove from allocations map
-  allocations_.erase(it);
+  bitmap_.Release(block_index, blocks);
 
   LLMLOGI("Released %zu blocks starting at address %lu, block index %zu", blocks, mem_addr, block_index);
   return SUCCESS;
 }
+
+VaBitmapStats VirtualMemoryManager::GetStats() const {
+  std::shared_lock<std::shared_mutex> lock(global_virtual_memory_mutex_);
+  return bitmap_.GetStats();
+}
 }  // namespace adxl
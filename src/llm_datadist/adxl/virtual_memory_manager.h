@@ -11,15 +11,16 @@
 #ifndef VIRTUAL_MEMORY_MANAGER_H
 #define VIRTUAL_MEMORY_MANAGER_H
 
+#include <atomic>
 #include <cstdint>
 #include <future>
+#include <shared_mutex>
 #include <utility>
 #include <vector>
-#include <bitset>
-#include <unordered_map>
 #include "adxl/adxl_types.h"
 #include "channel.h"
 #include "control_msg_handler.h"
+#include "va_block_bitmap.h"
 #include "acl/acl.h"
 
 namespace adxl {
@@ -43,19 +44,21 @@ class VirtualMemoryManager {
   Status ReleaseMemory(uintptr_t mem_addr);
   void SetSoName(const char *so_name);
   void SetVirtualMemoryCapacity(size_t capacity_in_tb);
+  VaBitmapStats GetStats() const;
 
  private:
   VirtualMemoryManager() = default;
 
-  std::vector<bool> bitmap_;
+  // Reserve and Release take the shared lock only, blocks are claimed in the lock-free bitmap
+  VaBlockBitmap bitmap_;
 
-  // Allocation metadata: start address -> block count
-  std::unordered_map<uintptr_t, size_t> allocations_;
+  // Allocation metadata: start block -> block count, 0 when no allocation starts there
+  std::vector<std::atomic<size_t>> block_counts_;
 
   // Initialization flag
   bool initialized_ = false;
 
-  std::mutex global_virtual_memory_mutex_;
+  mutable std::shared_mutex global_virtual_memory_mutex_;
   void *global_virtual_memory_{};
   uintptr_t global_virtual_memory_addr_{};
   size_t vm_size_ = 0;
@@ -48,6 +48,7 @@ class AdxlEngine::AdxlEngineImpl {
   Status TransferSync(const AscendString &remote_engine,
                       TransferOp operation,
                       const std::vector<TransferOpDesc> &op_descs,
+                      const TransferArgs &optional_args,
                       int32_t timeout_in_millis = 1000);
 
   Status TransferAsync(const AscendString &remote_engine,
@@ -108,10 +109,11 @@ Status AdxlEngine::AdxlEngineImpl::Disconnect(const AscendString &remote_engine,
 Status AdxlEngine::AdxlEngineImpl::TransferSync(const AscendString &remote_engine,
                                                 TransferOp operation,
                                                 const std::vector<TransferOpDesc> &op_descs,
+                                                const TransferArgs &optional_args,
                                                 int32_t timeout_in_millis) {
   ADXL_CHK_BOOL_RET_STATUS(adxl_engine_.IsInitialized(), FAILED, "AdxlEngine is not initialized");
   ADXL_CHK_STATUS_RET(CheckTransferOpDescs(op_descs), "Failed to check transfer op descs");
-  ADXL_CHK_STATUS_RET(adxl_engine_.TransferSync(remote_engine, operation, op_descs, timeout_in_millis),
+  ADXL_CHK_STATUS_RET(adxl_engine_.TransferSync(remote_engine, operation, op_descs, optional_args, timeout_in_millis),
                       "Failed to transfer sync.");
   return SUCCESS;
 }
@@ -243,12 +245,21 @@ Status AdxlEngine::TransferSync(const AscendString &remote_engine,
                                 TransferOp operation,
                                 const std::vector<TransferOpDesc> &op_descs,
                                 int32_t timeout_in_millis) {
+  return TransferSync(remote_engine, operation, op_descs, TransferArgs{}, timeout_in_millis);
+}
+
+Status AdxlEngine::TransferSync(const AscendString &remote_engine,
+                                TransferOp operation,
+                                const std::vector<TransferOpDesc> &op_descs,
+                                const TransferArgs &optional_args,
+                                int32_t timeout_in_millis) {
   auto start = std::chrono::steady_clock::now();
-  LLMLOGI("TransferSync start, remote_engine:%s, operation:%d, op_descs size:%zu, timeout:%d ms",
-          remote_engine.GetString(), static_cast<int32_t>(operation), op_descs.size(), timeout_in_millis);
+  LLMLOGI("TransferSync start, remote_engine:%s, operation:%d, op_descs size:%zu, timeout:%d ms, priority:%d",
+          remote_engine.GetString(), static_cast<int32_t>(operation), op_descs.size(), timeout_in_millis,
+          static_cast<int32_t>(optional_args.priority));
   ADXL_CHK_BOOL_RET_STATUS(impl_ != nullptr, FAILED, "impl is nullptr, check AdxlEngine init");
   ADXL_CHK_BOOL_RET_STATUS(timeout_in_millis > 0, PARAM_INVALID, "timeout_in_millis:%d must > 0", timeout_in_millis);
-  ADXL_CHK_STATUS_RET(impl_->TransferSync(remote_engine, operation, op_descs, timeout_in_millis), 
+  ADXL_CHK_STATUS_RET(impl_->TransferSync(remote_engine, operation, op_descs, optional_args, timeout_in_millis), 
                       "Failed to TransferSync, remote_engine:%s, operation:%d, op_descs size:%zu, timeout:%d ms",
                       remote_engine.GetString(), static_cast<int32_t>(operation),
                       op_descs.size(), timeout_in_millis);  
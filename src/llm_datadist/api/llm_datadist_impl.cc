@@ -27,6 +27,26 @@ namespace llm_datadist {
 namespace {
 constexpr std::pair<int32_t, int32_t> kDefaultLayerRange{-1, -1};
 
+class LayerTransferTaskImpl : public LayerTransferTask {
+ public:
+  explicit LayerTransferTaskImpl(std::shared_ptr<llm::LayerTransferProgress> progress)
+      : progress_(std::move(progress)) {}
+  ~LayerTransferTaskImpl() override = default;
+
+  bool IsLayerReady(uint32_t layer_offset) const override {
+    return progress_->IsLayerReady(layer_offset);
+  }
+  uint32_t GetReadyLayerNum() const override {
+    return static_cast<uint32_t>(progress_->GetReadyLayerNum());
+  }
+  Status Wait() override {
+    return progress_->Wait();
+  }
+
+ private:
+  std::shared_ptr<llm::LayerTransferProgress> progress_;
+};
+
 std::string RoleToString(LlmRole role) {
   static const std::map<LlmRole, std::string> kRoleToStr{
       {LlmRole::kPrompt, llm::kPrompt},
@@ -71,6 +91,10 @@ llm::CacheKey ToCacheKey(const CacheIndex &src_cache_index, bool dst_is_cache) {
   if (dst_is_cache) {
     cache_key.prompt_batch_index = src_cache_index.batch_index;
   }
+  // 0 is what a zero initialized CacheIndex holds, it can not tell whether the blocks changed
+  if (src_cache_index.generation != 0U) {
+    cache_key.prompt_cache_generation = src_cache_index.generation;
+  }
   return cache_key;
 }
 
@@ -176,6 +200,13 @@ class LlmDataDist::LlmDataDistImpl {
                       const std::vector<uint64_t> &dst_blocks,
                       const KvCacheExtParam &ext_param = {});
 
+  Status PushKvCacheByLayers(const Cache &src_cache,
+                             const CacheIndex &dst_cache_index,
+                             uint32_t src_batch_index,
+                             const KvCacheExtParam &ext_param,
+                             std::shared_ptr<LayerTransferTask> &task,
+                             const LayerReadyCallback &callback);
+
   Status RegisterKvCache(const CacheDesc &cache_desc,
                          const std::vector<uint64_t> &addrs,
                          const RegisterCfg &cfg,
@@ -412,6 +443,58 @@ Status LlmDataDist::LlmDataDistImpl::PushKvCache(const Cache &src_cache,
   return PushData(src_cache, ext_param, transfer_cache_config, transfer_block_config);
 }
 
+Status LlmDataDist::LlmDataDistImpl::PushKvCacheByLayers(const Cache &src_cache,
+                                                         const CacheIndex &dst_cache_index,
+                                                         uint32_t src_batch_index,
+                                                         const KvCacheExtParam &ext_param,
+                                                         std::shared_ptr<LayerTransferTask> &task,
+                                                         const LayerReadyCallback &callback) {
+  LLM_CHK_BOOL_RET_STATUS((llm_data_dist_.IsInitialized()),
+                         ge::FAILED, "LlmDataDist is not initialized");
+  LLM_CHK_BOOL_RET_STATUS(src_cache.cache_desc.placement == CachePlacement::kDevice,
+                         LLM_PARAM_INVALID, "Only support push to device cache");
+  LLM_CHK_STATUS_RET(CheckKvCacheExtParam(ext_param, true));
+  LLM_CHK_BOOL_RET_STATUS(((ext_param.src_layer_range.first >= 0) ||
+                        (ext_param.src_layer_range.first == -1 && src_cache.cache_desc.num_tensors > 0)), LLM_PARAM_INVALID,
+                        "Invalid src layer:%d, layer need >= 0 or -1 with valid num_tensors.", ext_param.src_layer_range.first);
+
+  constexpr uint64_t kCacheKeyByIdType = 2UL;
+  llm::TransferCacheConfig transfer_cache_config{};
+  transfer_cache_config.src_cache_id = src_cache.cache_id;
+  transfer_cache_config.batch_index = src_batch_index;
+  transfer_cache_config.cluster_id = dst_cache_index.cluster_id;
+  transfer_cache_config.dst_cache_id = dst_cache_index.cache_id;
+  transfer_cache_config.model_id_or_cache_id = dst_cache_index.cache_id;
+  transfer_cache_config.dst_batch_index = static_cast<uint64_t>(dst_cache_index.batch_index);
+  transfer_cache_config.type = kCacheKeyByIdType;
+  transfer_cache_config.tensor_num_per_layer = ext_param.tensor_num_per_layer;
+  // same layer range as PushData
+  int32_t src_layer_index = ext_param.src_layer_range.first;
+  int32_t dst_layer_index = ext_param.dst_layer_range.first;
+  int32_t cache_max_layer = ext_param.src_layer_range.second;
+  if (src_layer_index < 0) {
+    src_layer_index = 0;
+    dst_layer_index = 0;
+    cache_max_layer = GetCacheMaxLayer(src_cache, ext_param);
+  }
+  transfer_cache_config.layer_index = static_cast<uint64_t>(src_layer_index);
+  transfer_cache_config.dst_layer_index = static_cast<uint64_t>(dst_layer_index);
+  const auto layer_num = static_cast<uint64_t>(cache_max_layer - src_layer_index + 1);
+
+  llm::LayerReadyCallback layer_callback = nullptr;
+  if (callback != nullptr) {
+    layer_callback = [callback](uint64_t layer_index) { callback(static_cast<uint32_t>(layer_index)); };
+  }
+  llm::TransferBlockConfig transfer_block_config{};
+  std::shared_ptr<llm::LayerTransferProgress> progress;
+  LLM_CHK_STATUS_RET(llm_data_dist_.TransferCacheByLayers(0U, transfer_cache_config, transfer_block_config, layer_num,
+                                                         layer_callback, progress),
+                    "[PushKvCacheByLayers] submit failed");
+  task = llm::MakeShared<LayerTransferTaskImpl>(progress);
+  LLM_CHECK_NOTNULL(task);
+  return LLM_SUCCESS;
+}
+
 Status LlmDataDist::LlmDataDistImpl::PushKvBlocks(const Cache &src_cache,
                                                   const CacheIndex &dst_cache_index,
                                                   const std::vector<uint64_t> &src_blocks,
@@ -682,6 +765,26 @@ Status LlmDataDist::PushKvBlocks(const Cache &src_cache,
   return LLM_SUCCESS;
 }
 
+Status LlmDataDist::PushKvCacheByLayers(const Cache &src_cache,
+                                        const CacheIndex &dst_cache_index,
+                                        uint32_t src_batch_index,
+                                        const KvCacheExtParam &ext_param,
+                                        std::shared_ptr<LayerTransferTask> &task,
+                                        const LayerReadyCallback &callback) {
+  LLMLOGI("[PushKvCacheByLayers] start");
+  LLM_CHK_BOOL_RET_STATUS(impl_ != nullptr, LLM_FAILED, "impl is nullptr, check LlmDataDist construct");
+  const auto ret = impl_->PushKvCacheByLayers(src_cache, dst_cache_index, src_batch_index, ext_param, task, callback);
+  LLM_CHK_BOOL_RET_STATUS(ret == LLM_SUCCESS, ret,
+                         "[PushKvCacheByLayers] failed, dst_cluster_id = %lu, dst_cache_id = %ld, "
+                         "dst_batch_index = %u, src_cache_id = %ld",
+                         dst_cache_index.cluster_id, dst_cache_index.cache_id, dst_cache_index.batch_index,
+                         src_cache.cache_id);
+  LLMLOGI("[PushKvCacheByLayers] submitted, dst_cluster_id = %lu, dst_cache_id = %ld, dst_batch_index = %u, "
+         "src_cache_id = %ld", dst_cache_index.cluster_id, dst_cache_index.cache_id, dst_cache_index.batch_index,
+         src_cache.cache_id);
+  return LLM_SUCCESS;
+}
+
 Status LlmDataDist::RegisterKvCache(const CacheDesc &cache_desc,
                                     const std::vector<uint64_t> &addrs,
                                     const RegisterCfg &cfg,
@@ -29,6 +29,9 @@ namespace llm {
 namespace {
 constexpr size_t kMaxDimNum = 32U;
 constexpr size_t kAlignment = 4096U;
+// swap types beside the npu <-> host ones handled by SwapImpl, the memory side of a disk swap is host memory
+constexpr uint32_t kSwapOutToDisk = 2U;
+constexpr uint32_t kSwapInFromDisk = 3U;
 
 ge::Status ParseMemoryPoolConfig(const std::string &mem_pool_config, size_t &pool_size, size_t &page_shift) {
   const std::string &json_str = mem_pool_config;
@@ -52,6 +55,32 @@ ge::Status ParseMemoryPoolConfig(const std::string &mem_pool_config, size_t &poo
   return ge::SUCCESS;
 }
 
+// optional host pool fields: "numa_node" to place pool on, "huge_page" to back pool with huge pages
+ge::Status ParseHostArenaOptions(const std::string &mem_pool_config, hixl::PinnedHostArenaOptions &arena_options) {
+  nlohmann::json json_obj;
+  try {
+    json_obj = nlohmann::json::parse(mem_pool_config);
+    if (json_obj.contains("numa_node")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("numa_node").is_number_integer(), ge::LLM_PARAM_INVALID,
+                             "numa_node is not an integer: config = %s", mem_pool_config.c_str());
+      arena_options.numa_node = json_obj.at("numa_node").get<int32_t>();
+    }
+    arena_options.huge_page = false;
+    if (json_obj.contains("huge_page")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("huge_page").is_boolean(), ge::LLM_PARAM_INVALID,
+                             "huge_page is not a boolean: config = %s", mem_pool_config.c_str());
+      arena_options.huge_page = json_obj.at("huge_page").get<bool>();
+    }
+  } catch (nlohmann::json::exception &e) {
+    LLMLOGE(ge::LLM_PARAM_INVALID, "Failed to parse memory pool config: \"%s\", exception = %s",
+            mem_pool_config.c_str(), e.what());
+    return ge::LLM_PARAM_INVALID;
+  }
+  // pages from aclrtMallocHost can not be huge page backed, use mapping locked by arena instead
+  arena_options.backend = arena_options.huge_page ? hixl::HostArenaBackend::kMmap : hixl::HostArenaBackend::kRuntime;
+  return ge::SUCCESS;
+}
+
 ge::Status CheckTensorIndicesContinuous(const std::vector<uint64_t> &tensor_indices) {
   if (tensor_indices.empty()) {
     return ge::SUCCESS;
@@ -65,6 +94,82 @@ ge::Status CheckTensorIndicesContinuous(const std::vector<uint64_t> &tensor_indi
                          "tensor_indices is not continuous");
   return ge::SUCCESS;
 }
+
+// required fields: "path" of the backing file directory, "capacity" in bytes
+// optional fields: "direct_io", "io_thread_num", "read_ahead_blocks"
+ge::Status ParseDiskTierOptions(const std::string &json_str, DiskTierOptions &disk_options) {
+  nlohmann::json json_obj;
+  try {
+    json_obj = nlohmann::json::parse(json_str);
+    LLM_CHK_BOOL_RET_STATUS(json_obj.at("path").is_string(), ge::LLM_PARAM_INVALID,
+                           "path is not a string: config = %s", json_str.c_str());
+    disk_options.path = json_obj.at("path").get<std::string>();
+    LLM_CHK_BOOL_RET_STATUS(json_obj.at("capacity").is_number_unsigned(), ge::LLM_PARAM_INVALID,
+                           "capacity is not an unsigned integer: config = %s", json_str.c_str());
+    disk_options.capacity = json_obj.at("capacity").get<uint64_t>();
+    if (json_obj.contains("direct_io")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("direct_io").is_boolean(), ge::LLM_PARAM_INVALID,
+                             "direct_io is not a boolean: config = %s", json_str.c_str());
+      disk_options.direct_io = json_obj.at("direct_io").get<bool>();
+    }
+    if (json_obj.contains("io_thread_num")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("io_thread_num").is_number_unsigned() &&
+                             (json_obj.at("io_thread_num").get<uint32_t>() > 0U), ge::LLM_PARAM_INVALID,
+                             "io_thread_num is not a positive integer: config = %s", json_str.c_str());
+      disk_options.io_thread_num = json_obj.at("io_thread_num").get<uint32_t>();
+    }
+    if (json_obj.contains("read_ahead_blocks")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("read_ahead_blocks").is_number_unsigned(), ge::LLM_PARAM_INVALID,
+                             "read_ahead_blocks is not an unsigned integer: config = %s", json_str.c_str());
+      disk_options.read_ahead_blocks = json_obj.at("read_ahead_blocks").get<uint32_t>();
+    }
+  } catch (nlohmann::json::exception &e) {
+    LLMLOGE(ge::LLM_PARAM_INVALID, "Failed to parse disk tier config: \"%s\", exception = %s", json_str.c_str(),
+            e.what());
+    return ge::LLM_PARAM_INVALID;
+  }
+  return ge::SUCCESS;
+}
+
+// required field: "slot_num", blocks held by the prefetch area
+// optional fields: "admission_blocks", "lookahead_blocks", "min_repeat", "max_prefixes"
+ge::Status ParseKvPrefetchOptions(const std::string &json_str, KvPrefetchOptions &prefetch_options) {
+  nlohmann::json json_obj;
+  try {
+    json_obj = nlohmann::json::parse(json_str);
+    LLM_CHK_BOOL_RET_STATUS(json_obj.at("slot_num").is_number_unsigned() &&
+                           (json_obj.at("slot_num").get<uint64_t>() > 0UL), ge::LLM_PARAM_INVALID,
+                           "slot_num is not a positive integer: config = %s", json_str.c_str());
+    prefetch_options.slot_num = json_obj.at("slot_num").get<uint64_t>();
+    if (json_obj.contains("admission_blocks")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("admission_blocks").is_number_unsigned(), ge::LLM_PARAM_INVALID,
+                             "admission_blocks is not an unsigned integer: config = %s", json_str.c_str());
+      prefetch_options.admission_blocks = json_obj.at("admission_blocks").get<uint64_t>();
+    }
+    if (json_obj.contains("lookahead_blocks")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("lookahead_blocks").is_number_unsigned(), ge::LLM_PARAM_INVALID,
+                             "lookahead_blocks is not an unsigned integer: config = %s", json_str.c_str());
+      prefetch_options.lookahead_blocks = json_obj.at("lookahead_blocks").get<uint32_t>();
+    }
+    if (json_obj.contains("min_repeat")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("min_repeat").is_number_unsigned() &&
+                             (json_obj.at("min_repeat").get<uint32_t>() > 0U), ge::LLM_PARAM_INVALID,
+                             "min_repeat is not a positive integer: config = %s", json_str.c_str());
+      prefetch_options.min_repeat = json_obj.at("min_repeat").get<uint32_t>();
+    }
+    if (json_obj.contains("max_prefixes")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("max_prefixes").is_number_unsigned() &&
+                             (json_obj.at("max_prefixes").get<uint32_t>() > 0U), ge::LLM_PARAM_INVALID,
+                             "max_prefixes is not a positive integer: config = %s", json_str.c_str());
+      prefetch_options.max_prefixes = json_obj.at("max_prefixes").get<uint32_t>();
+    }
+  } catch (nlohmann::json::exception &e) {
+    LLMLOGE(ge::LLM_PARAM_INVALID, "Failed to parse kv prefetch config: \"%s\", exception = %s", json_str.c_str(),
+            e.what());
+    return ge::LLM_PARAM_INVALID;
+  }
+  return ge::SUCCESS;
+}
 }  // namespace
 ge::Status DataCacheEngine::Register(const llm::CacheDesc &cache_desc, const std::vector<CacheKey> &cache_keys,
                                      llm::Cache &cache) {
@@ -118,6 +223,14 @@ ge::Status DataCacheEngine::PullCache(int64_t cache_id, const CacheKey &cache_ke
                          "cache id:%ld not found", cache_id);
   LLM_CHK_STATUS_RET(CheckParam(cache_entry, pull_cache_param), "[cache_id:%ld] check param failed", cache_id);
   LLMLOGI("pull cache with tensor num per layer:%lu.", pull_cache_param.tensor_num_per_layer);
+  if ((prefetcher_ != nullptr) && CanPrefetch(cache_entry, cache_key, pull_cache_param)) {
+    return PullCacheWithPrefetch(cache_id, cache_entry, cache_key, pull_cache_param, start);
+  }
+  return DoPullCache(cache_id, cache_entry, cache_key, pull_cache_param, start);
+}
+
+ge::Status DataCacheEngine::DoPullCache(int64_t cache_id, const CacheEntry &cache_entry, const CacheKey &cache_key,
+                                        const PullCacheParam &pull_cache_param, const TimePoint &start) {
   const auto entity = comm_entity_manager_->GetEntityByRemoteClusterId(cache_key.prompt_cluster_id);
   LLM_CHK_BOOL_RET_STATUS(entity != nullptr, ge::LLM_NOT_YET_LINK,
                          "current cluster is not linked with remote cluster:%lu", cache_key.prompt_cluster_id);
@@ -160,14 +273,168 @@ ge::Status DataCacheEngine::PullCache(int64_t cache_id, const CacheKey &cache_ke
   return ge::SUCCESS;
 }
 
+bool DataCacheEngine::CanPrefetch(const CacheEntry &cache_entry, const CacheKey &cache_key,
+                                  const PullCacheParam &pull_cache_param) {
+  // only whole blocks of a device cache named by prompt cache id and block index can be held in the prefetch area,
+  // and only while the generation of the prompt cache tells whether they changed since.
+  // a MIX cache pulled without blocks is pulled as a whole and bypasses prefetch
+  const bool whole_blocks = (cache_entry.num_blocks > 0U) && (!pull_cache_param.decoder_blocks.empty()) &&
+                            (pull_cache_param.prompt_blocks.size() == pull_cache_param.decoder_blocks.size()) &&
+                            (pull_cache_param.size < 0) && pull_cache_param.src_tensor_indices.empty() &&
+                            pull_cache_param.dst_tensor_indices.empty() && (pull_cache_param.src_cache_offset < 0) &&
+                            (pull_cache_param.dst_cache_offset < 0);
+  return (cache_entry.placement == CachePlacement::DEVICE) && (cache_key.prompt_cache_id >= 0) && (cache_key.prompt_cache_generation != KvPrefetcher::kNoGeneration) &&
+         whole_blocks && EnsurePrefetchArea(cache_entry);
+}
+
+bool DataCacheEngine::EnsurePrefetchArea(const CacheEntry &cache_entry) {
+  std::lock_guard<std::mutex> lock(prefetch_mu_);
+  if (prefetch_area_failed_) {
+    return false;
+  }
+  if (prefetch_area_.cache_addrs.empty()) {
+    const uint64_t slot_num = prefetcher_->GetOptions().slot_num;
+    CacheEntry area{};
+    area.num_blocks = slot_num;
+    area.batch_size = 1U;
+    area.stride = cache_entry.stride;
+    area.tensor_size = cache_entry.stride * slot_num;
+    area.placement = CachePlacement::DEVICE;
+    area.is_owned = true;
+    area.cache_mem_type = CacheMemType::BLOCKS;
+    for (size_t i = 0U; i < cache_entry.cache_addrs.size(); ++i) {
+      auto tensor_addr = npu_mem_pool_->AllocShared(static_cast<size_t>(area.tensor_size));
+      if (tensor_addr == nullptr) {
+        LLMLOGW("failed to allocate kv prefetch area, tensor_num = %zu, tensor_size = %lu, prefetch is disabled",
+                cache_entry.cache_addrs.size(), area.tensor_size);
+        prefetch_area_failed_ = true;
+        return false;
+      }
+      (void)area.cache_addrs.emplace_back(std::move(tensor_addr));
+    }
+    prefetch_area_ = std::move(area);
+    LLMLOGI("kv prefetch area allocated, tensor_num = %zu, block_size = %lu, slot_num = %lu",
+            prefetch_area_.cache_addrs.size(), prefetch_area_.stride, slot_num);
+  }
+  // caches laid out differently from the first one bypass prefetch
+  return (prefetch_area_.cache_addrs.size() == cache_entry.cache_addrs.size()) &&
+         (prefetch_area_.stride == cache_entry.stride);
+}
+
+ge::Status DataCacheEngine::PullCacheWithPrefetch(int64_t cache_id, const CacheEntry &cache_entry,
+                                                  const CacheKey &cache_key, const PullCacheParam &pull_cache_param,
+                                                  const TimePoint &start) {
+  // must be done before the pull lock of the entity is taken, prefetch in flight holds it until its blocks landed
+  std::vector<KvPrefetchHit> hits;
+  prefetcher_->Acquire(cache_key, pull_cache_param.prompt_blocks, hits);
+  PullCacheParam miss_param = pull_cache_param;
+  if (!hits.empty()) {
+    LLM_MAKE_GUARD(release_hits, [this, &hits]() { prefetcher_->Release(hits); });
+    CopyCacheParam copy_cache_param{};
+    copy_cache_param.dst_cache_id = cache_id;
+    copy_cache_param.req_id = cache_key.req_id;
+    std::vector<bool> is_hit(pull_cache_param.decoder_blocks.size(), false);
+    for (const auto &hit : hits) {
+      (void)copy_cache_param.copy_block_infos.emplace_back(hit.slot, pull_cache_param.decoder_blocks[hit.index]);
+      is_hit[hit.index] = true;
+    }
+    TemporaryRtContext with_context(aclrt_context_);
+    LLM_CHK_STATUS_RET(cache_manager_->CopyCacheForBlocks(prefetch_area_, cache_entry, copy_cache_param,
+                                                          cache_entry.cache_addrs.size()),
+                      "[cache_id:%ld] copy prefetched blocks failed", cache_id);
+    miss_param.prompt_blocks.clear();
+    miss_param.decoder_blocks.clear();
+    for (size_t i = 0U; i < is_hit.size(); ++i) {
+      if (!is_hit[i]) {
+        (void)miss_param.prompt_blocks.emplace_back(pull_cache_param.prompt_blocks[i]);
+        (void)miss_param.decoder_blocks.emplace_back(pull_cache_param.decoder_blocks[i]);
+      }
+    }
+  }
+  if (!miss_param.decoder_blocks.empty()) {
+    LLM_CHK_STATUS_RET(DoPullCache(cache_id, cache_entry, cache_key, miss_param, start));
+  }
+  prefetcher_->Record(cache_key, pull_cache_param.prompt_blocks);
+  LLMLOGI("[PullCache] success, cache_id = %ld, block_cnt = %zu, served from prefetch area = %zu", cache_id,
+          pull_cache_param.decoder_blocks.size(), hits.size());
+  return ge::SUCCESS;
+}
+
+ge::Status DataCacheEngine::PullToPrefetchArea(const CacheKey &cache_key, const std::vector<uint64_t> &remote_blocks,
+                                               const std::vector<uint64_t> &slots) {
+  const auto entity = comm_entity_manager_->GetEntityByRemoteClusterId(cache_key.prompt_cluster_id);
+  LLM_CHK_BOOL_RET_STATUS(entity != nullptr, ge::LLM_NOT_YET_LINK,
+                         "current cluster is not linked with remote cluster:%lu", cache_key.prompt_cluster_id);
+  std::lock_guard<std::mutex> pull_lock(entity->GetPullMutex());
+  LLM_CHK_BOOL_RET_STATUS((entity->GetCurState() != FsmState::FSM_DESTROYED_STATE), ge::LLM_NOT_YET_LINK,
+                         "current cluster is not linked with remote cluster:%lu", cache_key.prompt_cluster_id);
+  TemporaryRtContext with_context(aclrt_context_);
+  LLM_CHK_BOOL_RET_STATUS(entity->CheckEntityInfo(), ge::LLM_NOT_YET_LINK,
+                         "prefetch must wait until the query_register_mem_status return ok");
+  LLM_DISMISSABLE_GUARD(abort_stream, [this]() -> void {
+    LLM_CHK_ACL(aclrtStreamAbort(prefetch_stream_));
+  });
+  PullCacheParam pull_cache_param{};
+  pull_cache_param.prompt_blocks = remote_blocks;
+  pull_cache_param.decoder_blocks = slots;
+  DataTransferClient client(*entity, prefetch_stream_);
+  if (access_remote_cache_) {
+    // the prefetch area is carved from the memory pool, which is registered to the remote as well
+    LLM_CHK_STATUS_RET(client.PullCacheByGet(prefetch_area_, cache_key, pull_cache_param, sync_cache_timeout_),
+                      "Failed to prefetch kv from remote cluster:%lu", cache_key.prompt_cluster_id);
+    LLM_DISMISS_GUARD(abort_stream);
+    return ge::SUCCESS;
+  }
+  entity->ClearResponseFlags();
+  LLM_CHK_STATUS_RET(client.PullCache(prefetch_area_, cache_key, pull_cache_param, sync_cache_timeout_),
+                    "Failed to prefetch kv from remote cluster:%lu", cache_key.prompt_cluster_id);
+  LLM_DISMISS_GUARD(abort_stream);
+  return ge::SUCCESS;
+}
+
 ge::Status DataCacheEngine::SwapBlocks(const Cache &src, const Cache &dst, const uint64_t block_size,
                                        const uint32_t type,
                                        const std::vector<std::pair<int64_t, int64_t>> &block_mapping) const {
+  if ((type == kSwapOutToDisk) || (type == kSwapInFromDisk)) {
+    return SwapBlocksWithDisk(src, dst, block_size, type, block_mapping);
+  }
   SwapImpl swap_impl(device_id_);
   LLM_CHK_STATUS_RET(swap_impl.SwapBlocksV2(src, dst, block_size, type, block_mapping));
   return ge::SUCCESS;
 }
 
+ge::Status DataCacheEngine::SwapBlocksWithDisk(const Cache &src, const Cache &dst, const uint64_t block_size,
+                                               const uint32_t type,
+                                               const std::vector<std::pair<int64_t, int64_t>> &block_mapping) const {
+  LLM_CHK_BOOL_RET_STATUS(disk_store_ != nullptr, ge::LLM_FEATURE_NOT_ENABLED, "disk tier is not enabled, set %s",
+                         LLM_OPTION_DISK_TIER_CONFIG);
+  // the disk side is identified by its cache id only, its tensor addresses are not used
+  const Cache &host_cache = (type == kSwapOutToDisk) ? src : dst;
+  const int64_t disk_cache_id = (type == kSwapOutToDisk) ? dst.cache_id : src.cache_id;
+  LLM_CHK_BOOL_RET_STATUS(host_cache.per_device_tensor_addrs.size() == 1U, ge::LLM_PARAM_INVALID,
+                         "currently support kv cache in one device");
+  // the io threads read and write the tensor addresses directly, device memory would fail in the middle of a swap
+  CacheEntry host_cache_entry;
+  LLM_CHK_BOOL_RET_STATUS(cache_manager_->GetCacheEntry(host_cache.cache_id, host_cache_entry),
+                         ge::LLM_KV_CACHE_NOT_EXIST, "cache:%ld swapped with disk is not allocated or registered",
+                         host_cache.cache_id);
+  LLM_CHK_BOOL_RET_STATUS(host_cache_entry.placement == CachePlacement::HOST, ge::LLM_PARAM_INVALID,
+                         "cache:%ld swapped with disk must be placed on host, placement:%u", host_cache.cache_id,
+                         static_cast<uint32_t>(host_cache_entry.placement));
+  const auto start = std::chrono::steady_clock::now();
+  if (type == kSwapOutToDisk) {
+    LLM_CHK_STATUS_RET(disk_store_->SwapOut(host_cache.per_device_tensor_addrs.front(), disk_cache_id, block_size,
+                                            block_mapping), "swap blocks out to disk failed");
+  } else {
+    LLM_CHK_STATUS_RET(disk_store_->SwapIn(disk_cache_id, host_cache.per_device_tensor_addrs.front(), block_size,
+                                           block_mapping), "swap blocks in from disk failed");
+  }
+  LLMLOGI("[LlmPerf] swap blocks with disk success, type:%u, disk cache_id:%ld, block num:%zu, cost time:%ld us",
+          type, disk_cache_id, block_mapping.size(),
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+  return ge::SUCCESS;
+}
+
 ge::Status DataCacheEngine::Initialize(const std::map<ge::AscendString, ge::AscendString> &options) {
   int32_t device_id;
   LLM_CHK_STATUS_RET(LLMUtils::ParseDeviceId(options, device_id), "Failed to get device id");
@@ -180,6 +447,8 @@ ge::Status DataCacheEngine::Initialize(const std::map<ge::AscendString, ge::Asce
   LLM_CHK_STATUS_RET(LLMUtils::ParserWaitTimeInfo(options, wait_time_info), "parser wait time info failed");
   sync_cache_timeout_ = wait_time_info.sync_kv_wait_time;
   LLM_CHK_STATUS_RET(InitializeMemoryPool(options), "Failed to initialize memory pool");
+  LLM_CHK_STATUS_RET(InitializeDiskTier(options), "Failed to initialize disk tier");
+  LLM_CHK_STATUS_RET(InitializePrefetcher(options), "Failed to initialize kv prefetch");
   // create stream
   LLM_ASSERT_RT_OK(
       aclrtCreateStreamWithConfig(&req_stream_, 0, ACL_STREAM_FAST_LAUNCH | ACL_STREAM_FAST_SYNC));
@@ -190,14 +459,28 @@ ge::Status DataCacheEngine::Initialize(const std::map<ge::AscendString, ge::Asce
 }
 
 void DataCacheEngine::Finalize() const{
+  if (layer_transfer_pool_ != nullptr) {
+    // tasks run in order on one worker, once a no-op queued behind them is done they are all done
+    const auto drained = layer_transfer_pool_->commit([]() {});
+    if (drained.valid()) {
+      drained.wait();
+    }
+    layer_transfer_pool_->Destroy();
+  }
   {
     TemporaryRtContext with_context(aclrt_context_);
+    if (prefetcher_ != nullptr) {
+      prefetcher_->Finalize();
+    }
     cache_manager_->Finalize();
     if (npu_pool_memory_ != nullptr) {
       LLM_CHK_ACL(aclrtFree(npu_pool_memory_));
     }
-    if (host_pool_memory_ != nullptr) {
-      LLM_CHK_ACL(aclrtFreeHost(host_pool_memory_));
+    if (host_arena_ != nullptr) {
+      host_arena_->Finalize();
+    }
+    if (disk_store_ != nullptr) {
+      disk_store_->Finalize();
     }
     if (req_stream_ != nullptr) {
       LLM_CHK_ACL(aclrtDestroyStream(req_stream_));
@@ -205,6 +488,9 @@ void DataCacheEngine::Finalize() const{
     if (transfer_stream_ != nullptr) {
       LLM_CHK_ACL(aclrtDestroyStream(transfer_stream_));
     }
+    if (prefetch_stream_ != nullptr) {
+      LLM_CHK_ACL(aclrtDestroyStream(prefetch_stream_));
+    }
   }
 }
 
@@ -262,16 +548,67 @@ ge::Status DataCacheEngine::InitializeHostMemoryPool(const std::map<ge::AscendSt
   ScalableConfig config{};
   config.page_idem_num = page_shift;
   config.page_mem_size_total_threshold = host_pool_size;
+  hixl::PinnedHostArenaOptions arena_options{};
+  LLM_CHK_STATUS_RET(ParseHostArenaOptions(json_str, arena_options), "parse %s failed",
+                    LLM_OPTION_HOST_MEM_POOL_CONFIG);
   host_mem_pool_ = MakeUnique<LlmMemPool>(config);
   LLM_CHECK_NOTNULL(host_mem_pool_);
-  LLM_CHK_ACL_RET(aclrtMallocHost(&host_pool_memory_, host_pool_size));
+  host_arena_ = MakeUnique<hixl::PinnedHostArena>(arena_options);
+  LLM_CHECK_NOTNULL(host_arena_);
+  LLM_CHK_BOOL_RET_STATUS(host_arena_->Initialize() == hixl::SUCCESS, ge::LLM_PARAM_INVALID,
+                         "Failed to initialize host arena, config = %s", json_str.c_str());
+  LLM_CHK_BOOL_RET_STATUS(host_arena_->Alloc(host_pool_size, host_pool_memory_) == hixl::SUCCESS,
+                         ge::LLM_OUT_OF_MEMORY, "Failed to allocate memory for host memory pool, config = %s",
+                         json_str.c_str());
   LLM_CHK_STATUS_RET(host_mem_pool_->Initialize(host_pool_memory_, host_pool_size),
                     "Failed to initialize host memory pool, config = %s", json_str.c_str());
   LLM_CHK_STATUS_RET(
       comm_mem_manager_->RegisterCommMemAddr(host_pool_memory_, host_pool_size, HCCL_MEM_TYPE_HOST));
   cache_manager_->SetHostMemPool(host_mem_pool_.get());
-  LLMLOGI("host memory_size = %lu B, page_shift = %zu, page_size = %lu B", host_pool_size, page_shift,
-         (1UL << page_shift));
+  LLMLOGI("host memory_size = %lu B, page_shift = %zu, page_size = %lu B, numa_node = %d, huge_page = %d",
+         host_pool_size, page_shift, (1UL << page_shift), host_arena_->GetNumaNode(),
+         static_cast<int32_t>(arena_options.huge_page));
+  return ge::SUCCESS;
+}
+
+ge::Status DataCacheEngine::InitializeDiskTier(const std::map<ge::AscendString, ge::AscendString> &options) {
+  const auto it = options.find(LLM_OPTION_DISK_TIER_CONFIG);
+  if (it == options.cend()) {
+    LLMLOGI("disk tier is not enabled");
+    return ge::SUCCESS;
+  }
+  const std::string &json_str = it->second.GetString();
+  DiskTierOptions disk_options{};
+  LLM_CHK_STATUS_RET(ParseDiskTierOptions(json_str, disk_options), "parse %s failed", LLM_OPTION_DISK_TIER_CONFIG);
+  disk_store_ = MakeUnique<DiskBlockStore>(disk_options);
+  LLM_CHECK_NOTNULL(disk_store_);
+  LLM_CHK_STATUS_RET(disk_store_->Initialize(), "Failed to initialize disk tier, config = %s", json_str.c_str());
+  return ge::SUCCESS;
+}
+
+ge::Status DataCacheEngine::InitializePrefetcher(const std::map<ge::AscendString, ge::AscendString> &options) {
+  const auto it = options.find(LLM_OPTION_KV_PREFETCH_CONFIG);
+  if (it == options.cend()) {
+    LLMLOGI("kv prefetch is not enabled");
+    return ge::SUCCESS;
+  }
+  const std::string &json_str = it->second.GetString();
+  LLM_CHK_BOOL_RET_STATUS(npu_mem_pool_ != nullptr, ge::LLM_PARAM_INVALID,
+                         "kv prefetch places its blocks in the memory pool, %s must be set",
+                         LLM_OPTION_MEM_POOL_CONFIG);
+  KvPrefetchOptions prefetch_options{};
+  LLM_CHK_STATUS_RET(ParseKvPrefetchOptions(json_str, prefetch_options), "parse %s failed",
+                    LLM_OPTION_KV_PREFETCH_CONFIG);
+  LLM_ASSERT_RT_OK(
+      aclrtCreateStreamWithConfig(&prefetch_stream_, 0, ACL_STREAM_FAST_LAUNCH | ACL_STREAM_FAST_SYNC));
+  prefetcher_ = MakeUnique<KvPrefetcher>(
+      prefetch_options,
+      [this](const CacheKey &cache_key, const std::vector<uint64_t> &remote_blocks,
+             const std::vector<uint64_t> &slots) -> ge::Status {
+        return PullToPrefetchArea(cache_key, remote_blocks, slots);
+      });
+  LLM_CHECK_NOTNULL(prefetcher_);
+  LLM_CHK_STATUS_RET(prefetcher_->Initialize(), "Failed to initialize kv prefetch, config = %s", json_str.c_str());
   return ge::SUCCESS;
 }
 
@@ -401,8 +738,9 @@ ge::Status DataCacheEngine::CheckTensorIndices(const CacheEntry &cache_entry, co
   return ge::SUCCESS;
 }
 
-ge::Status DataCacheEngine::TransferCache(const uint64_t task_id, const TransferCacheConfig &transfer_cache_config,
-                                          const TransferBlockConfig &transfer_block_config) {
+ge::Status DataCacheEngine::DoTransferCache(
+    const uint64_t task_id, const TransferCacheConfig &transfer_cache_config,
+    const std::function<ge::Status(CommEntity &, const CacheEntry &)> &transfer_func) {
   // cache_id is local, find local addr by cache_id
   CacheEntry cache_entry;
   LLM_CHK_BOOL_RET_STATUS(cache_manager_->GetCacheEntry(transfer_cache_config.src_cache_id, cache_entry),
@@ -411,6 +749,7 @@ ge::Status DataCacheEngine::TransferCache(const uint64_t task_id, const Transfer
   const auto entity = comm_entity_manager_->GetEntityByRemoteClusterId(transfer_cache_config.cluster_id);
   LLM_CHK_BOOL_RET_STATUS(entity != nullptr, ge::LLM_NOT_YET_LINK,
                          "current cluster is not linked with remote cluster:%lu", transfer_cache_config.cluster_id);
+  std::lock_guard<std::mutex> transfer_lock(transfer_mu_);
   std::lock_guard<std::mutex> pull_lock(entity->GetPullMutex());
   // in case of entity is erased here, can not delete.
   LLM_CHK_BOOL_RET_STATUS((entity->GetCurState() != FsmState::FSM_DESTROYED_STATE), ge::LLM_NOT_YET_LINK,
@@ -432,12 +771,55 @@ ge::Status DataCacheEngine::TransferCache(const uint64_t task_id, const Transfer
   LLM_DISMISSABLE_GUARD(abort_stream, [this]() -> void {
     LLM_CHK_ACL(aclrtStreamAbort(transfer_stream_));
   });
-  LayerWiseTransferJob layer_wise_transfer_job(*entity, transfer_stream_);
-  LLM_CHK_STATUS_RET(layer_wise_transfer_job.TransferCache(cache_entry, transfer_cache_config, transfer_block_config,
-                                                          sync_cache_timeout_, access_remote_cache_),
+  LLM_CHK_STATUS_RET(transfer_func(*entity, cache_entry),
                     "task:%lu of cluster:%lu transfer cache of layer[%lu] failed", task_id,
                     transfer_cache_config.cluster_id, transfer_cache_config.layer_index);
   LLM_DISMISS_GUARD(abort_stream);
   return ge::SUCCESS;
 }
+
+ge::Status DataCacheEngine::TransferCache(const uint64_t task_id, const TransferCacheConfig &transfer_cache_config,
+                                          const TransferBlockConfig &transfer_block_config) {
+  return DoTransferCache(task_id, transfer_cache_config,
+                         [this, &transfer_cache_config, &transfer_block_config](
+                             CommEntity &entity, const CacheEntry &cache_entry) -> ge::Status {
+                           LayerWiseTransferJob layer_wise_transfer_job(entity, transfer_stream_);
+                           return layer_wise_transfer_job.TransferCache(cache_entry, transfer_cache_config,
+                                                                        transfer_block_config, sync_cache_timeout_,
+                                                                        access_remote_cache_);
+                         });
+}
+
+ge::Status DataCacheEngine::TransferCacheByLayers(const uint64_t task_id,
+                                                  const TransferCacheConfig &transfer_cache_config,
+                                                  const TransferBlockConfig &transfer_block_config,
+                                                  const uint64_t layer_num,
+                                                  const LayerReadyCallback &callback,
+                                                  std::shared_ptr<LayerTransferProgress> &progress) {
+  LLM_CHK_BOOL_RET_STATUS((layer_num > 0U) && (layer_num <= LayerTransferProgress::kMaxLayerNum),
+                         ge::LLM_PARAM_INVALID, "layer num[%lu] is out of range[1, %lu]", layer_num,
+                         LayerTransferProgress::kMaxLayerNum);
+  // one worker, layer-wise transfers share transfer_stream_ and run one after another
+  std::call_once(layer_transfer_once_flag_, [this]() {
+    layer_transfer_pool_ = MakeUnique<LLMThreadPool>("llm_layer_xfer", 1U);
+  });
+  LLM_CHECK_NOTNULL(layer_transfer_pool_);
+  auto task_progress = MakeShared<LayerTransferProgress>(layer_num);
+  LLM_CHECK_NOTNULL(task_progress);
+  auto run = [this, task_id, transfer_cache_config, transfer_block_config, callback, task_progress]() {
+    const auto ret = DoTransferCache(task_id, transfer_cache_config,
+                                     [this, &transfer_cache_config, &transfer_block_config, &callback, &task_progress](
+                                         CommEntity &entity, const CacheEntry &cache_entry) -> ge::Status {
+                                       LayerWiseTransferJob layer_wise_transfer_job(entity, transfer_stream_);
+                                       return layer_wise_transfer_job.TransferCacheByLayers(
+                                           cache_entry, transfer_cache_config, transfer_block_config,
+                                           sync_cache_timeout_, access_remote_cache_, *task_progress, callback);
+                                     });
+    task_progress->Finish(ret);
+  };
+  const auto future = layer_transfer_pool_->commit(run);
+  LLM_CHK_BOOL_RET_STATUS(future.valid(), ge::FAILED, "task:%lu commit layer-wise transfer failed", task_id);
+  progress = task_progress;
+  return ge::SUCCESS;
+}
 }  // namespace llm
@@ -13,12 +13,18 @@
 
 #include <vector>
 #include <mutex>
+#include <functional>
 #include "llm_datadist/llm_error_codes.h"
 #include "ge_common/ge_api_types.h"
 #include "common/llm_inner_types.h"
 #include "link_mgr/comm_entity_manager.h"
 #include "cache_manager.h"
 #include "common/llm_mem_pool.h"
+#include "data_transfer/layer_wise_transfer_job.h"
+#include "common/pinned_host_arena.h"
+#include "disk_block_store.h"
+#include "kv_prefetcher.h"
+#include "common/llm_thread_pool.h"
 
 namespace llm {
 using TimePoint = std::chrono::time_point<std::chrono::steady_clock>;
@@ -39,6 +45,12 @@ class DataCacheEngine {
   ge::Status CheckCapacity(size_t size);
   ge::Status TransferCache(const uint64_t task_id, const TransferCacheConfig &transfer_cache_config,
                            const TransferBlockConfig &transfer_block_config);
+  // queues the transfer on a worker thread and returns, completed layers are polled or waited through progress,
+  // callback is invoked on the worker thread
+  ge::Status TransferCacheByLayers(const uint64_t task_id, const TransferCacheConfig &transfer_cache_config,
+                                   const TransferBlockConfig &transfer_block_config, const uint64_t layer_num,
+                                   const LayerReadyCallback &callback,
+                                   std::shared_ptr<LayerTransferProgress> &progress);
   void SetCommEntityManager(CommEntityManager *comm_entity_manager);
   void SetCommMemManager(CommMemManager *comm_mem_manager);
   void SetCacheManager(CacheManager *cache_manager);
@@ -50,6 +62,20 @@ class DataCacheEngine {
   ge::Status InitializeMemoryPool(const std::map<ge::AscendString, ge::AscendString> &options);
   ge::Status InitializeDeviceMemoryPool(const std::map<ge::AscendString, ge::AscendString> &options);
   ge::Status InitializeHostMemoryPool(const std::map<ge::AscendString, ge::AscendString> &options);
+  ge::Status InitializeDiskTier(const std::map<ge::AscendString, ge::AscendString> &options);
+  ge::Status InitializePrefetcher(const std::map<ge::AscendString, ge::AscendString> &options);
+  ge::Status DoPullCache(int64_t cache_id, const CacheEntry &cache_entry, const CacheKey &cache_key,
+                         const PullCacheParam &pull_cache_param, const TimePoint &start);
+  bool CanPrefetch(const CacheEntry &cache_entry, const CacheKey &cache_key, const PullCacheParam &pull_cache_param);
+  bool EnsurePrefetchArea(const CacheEntry &cache_entry);
+  ge::Status PullCacheWithPrefetch(int64_t cache_id, const CacheEntry &cache_entry, const CacheKey &cache_key,
+                                   const PullCacheParam &pull_cache_param, const TimePoint &start);
+  ge::Status PullToPrefetchArea(const CacheKey &cache_key, const std::vector<uint64_t> &remote_blocks,
+                                const std::vector<uint64_t> &slots);
+  ge::Status SwapBlocksWithDisk(const Cache &src, const Cache &dst, const uint64_t block_size, const uint32_t type,
+                                const std::vector<std::pair<int64_t, int64_t>> &block_mapping) const;
+  ge::Status DoTransferCache(const uint64_t task_id, const TransferCacheConfig &transfer_cache_config,
+                             const std::function<ge::Status(CommEntity &, const CacheEntry &)> &transfer_func);
 
   std::mutex mu_;
   std::atomic_int64_t cache_id_gen_{1};
@@ -66,8 +92,18 @@ class DataCacheEngine {
   std::unique_ptr<LlmMemPool> npu_mem_pool_{};
   aclrtStream transfer_stream_{nullptr};
   std::once_flag create_stream_once_flag_;
+  std::mutex transfer_mu_;  // transfer_stream_ is shared by TransferCache and the layer-wise worker
+  std::once_flag layer_transfer_once_flag_;
+  std::unique_ptr<LLMThreadPool> layer_transfer_pool_{};
   void *host_pool_memory_{nullptr};
   std::unique_ptr<LlmMemPool> host_mem_pool_{};
+  std::unique_ptr<hixl::PinnedHostArena> host_arena_{};
+  std::unique_ptr<DiskBlockStore> disk_store_{};
+  std::unique_ptr<KvPrefetcher> prefetcher_{};
+  aclrtStream prefetch_stream_{nullptr};
+  std::mutex prefetch_mu_;
+  bool prefetch_area_failed_ = false;
+  CacheEntry prefetch_area_{};  // blocks from npu_mem_pool_, laid out as the first cache pulled with prefetch
 };
 }  // namespace llm
 
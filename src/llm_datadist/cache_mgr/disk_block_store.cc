@@ -0,0 +1,686 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "disk_block_store.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <set>
+#include "common/llm_utils.h"
+#include "common/llm_checker.h"
+#include "common/mem_utils.h"
+
+namespace llm {
+namespace {
+// logical block size of nvme devices, O_DIRECT needs buffer, offset and length aligned to it
+constexpr uint64_t kDirectIoAlign = 4096UL;
+// upper bound of one io, contiguous ranges are split at it to keep every io thread busy
+constexpr uint64_t kMaxIoSize = 2UL * 1024UL * 1024UL;
+// sequential streams whose read ahead blocks are kept at the same time
+constexpr size_t kReadAheadStreams = 8U;
+
+ge::Status FullIo(bool is_write, int32_t fd, uint8_t *buffer, uint64_t len, uint64_t offset) {
+  uint64_t done = 0UL;
+  while (done < len) {
+    const ssize_t ret = is_write ? pwrite(fd, buffer + done, len - done, static_cast<off_t>(offset + done))
+                                 : pread(fd, buffer + done, len - done, static_cast<off_t>(offset + done));
+    if ((ret < 0) && (errno == EINTR)) {
+      continue;
+    }
+    LLM_CHK_BOOL_RET_STATUS(ret > 0, ge::FAILED, "disk tier %s failed, offset = %lu, len = %lu, ret = %zd, errno = %d",
+                           is_write ? "write" : "read", offset + done, len - done, ret, errno);
+    done += static_cast<uint64_t>(ret);
+  }
+  return ge::SUCCESS;
+}
+
+// block_mapping holds (src block index, dst block index)
+ge::Status CheckSwapParam(const std::vector<uintptr_t> &tensor_addrs, uint64_t block_size,
+                          const std::vector<std::pair<int64_t, int64_t>> &block_mapping) {
+  LLM_CHK_BOOL_RET_STATUS(!tensor_addrs.empty(), ge::LLM_PARAM_INVALID, "tensor addrs is empty");
+  LLM_CHK_BOOL_RET_STATUS(block_size > 0UL, ge::LLM_PARAM_INVALID, "block size is 0");
+  for (const auto tensor_addr : tensor_addrs) {
+    LLM_CHK_BOOL_RET_STATUS(tensor_addr != 0UL, ge::LLM_PARAM_INVALID, "tensor addr is nullptr");
+  }
+  std::set<int64_t> dst_blocks;
+  for (const auto &block : block_mapping) {
+    LLM_CHK_BOOL_RET_STATUS((block.first >= 0) && (block.second >= 0), ge::LLM_PARAM_INVALID,
+                           "invalid block mapping (%ld, %ld)", block.first, block.second);
+    LLM_CHK_BOOL_RET_STATUS(dst_blocks.emplace(block.second).second, ge::LLM_PARAM_INVALID,
+                           "dst block %ld is mapped more than once", block.second);
+  }
+  return ge::SUCCESS;
+}
+}  // namespace
+
+void DiskIoRequest::AddPending() {
+  std::lock_guard<std::mutex> lock(mu_);
+  ++pending_;
+}
+
+void DiskIoRequest::Complete(ge::Status status) {
+  std::lock_guard<std::mutex> lock(mu_);
+  if ((status != ge::SUCCESS) && (status_ == ge::SUCCESS)) {
+    status_ = status;
+  }
+  --pending_;
+  if (pending_ == 0U) {
+    cv_.notify_all();
+  }
+}
+
+ge::Status DiskIoRequest::Wait() {
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this]() { return pending_ == 0U; });
+  return status_;
+}
+
+bool DiskIoRequest::IsCompleted() {
+  std::lock_guard<std::mutex> lock(mu_);
+  return pending_ == 0U;
+}
+
+DiskBlockStore::~DiskBlockStore() {
+  Finalize();
+}
+
+ge::Status DiskBlockStore::Initialize() {
+  LLM_CHK_BOOL_RET_STATUS(!options_.path.empty(), ge::LLM_PARAM_INVALID, "disk tier path is empty");
+  const uint64_t capacity = options_.capacity / kDirectIoAlign * kDirectIoAlign;
+  LLM_CHK_BOOL_RET_STATUS(capacity > 0UL, ge::LLM_PARAM_INVALID, "disk tier capacity %lu is less than %lu",
+                         options_.capacity, kDirectIoAlign);
+  std::string file_name = options_.path + "/llm_disk_tier_XXXXXX";
+  const int32_t fd = mkostemp(&file_name[0], O_CLOEXEC);
+  LLM_CHK_BOOL_RET_STATUS(fd >= 0, ge::LLM_PARAM_INVALID, "failed to create disk tier file under %s, errno = %d",
+                         options_.path.c_str(), errno);
+  fd_ = fd;
+  direct_io_ = false;
+  if (options_.direct_io) {
+    const int32_t direct_fd = open(file_name.c_str(), O_RDWR | O_DIRECT | O_CLOEXEC);
+    if (direct_fd >= 0) {
+      (void)close(fd_);
+      fd_ = direct_fd;
+      direct_io_ = true;
+    } else {
+      LLMLOGW("O_DIRECT is not supported under %s, errno = %d, fall back to buffered io", options_.path.c_str(),
+              errno);
+    }
+  }
+  // the file is released together with the last descriptor, nothing is left behind on crash
+  (void)unlink(file_name.c_str());
+  if (posix_fallocate(fd_, 0, static_cast<off_t>(capacity)) != 0) {
+    LLM_CHK_BOOL_RET_STATUS(ftruncate(fd_, static_cast<off_t>(capacity)) == 0, ge::LLM_OUT_OF_MEMORY,
+                           "failed to reserve %lu bytes under %s, errno = %d", capacity, options_.path.c_str(), errno);
+  }
+  capacity_ = capacity;
+  free_extents_.clear();
+  free_extents_[0UL] = capacity;
+  io_pool_ = MakeUnique<LLMThreadPool>("llm_disk_io", options_.io_thread_num);
+  LLM_CHECK_NOTNULL(io_pool_);
+  LLMLOGI("disk tier initialized, path = %s, capacity = %lu B, direct_io = %d, io_thread_num = %u, "
+          "read_ahead_blocks = %u", options_.path.c_str(), capacity, static_cast<int32_t>(direct_io_),
+          options_.io_thread_num, options_.read_ahead_blocks);
+  return ge::SUCCESS;
+}
+
+void DiskBlockStore::Finalize() {
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [this]() { return inflight_tasks_ == 0U; });
+  }
+  io_pool_.reset();
+  if (fd_ >= 0) {
+    (void)close(fd_);
+    fd_ = -1;
+  }
+  std::lock_guard<std::mutex> lock(mu_);
+  index_.clear();
+  lru_.clear();
+  read_ahead_.clear();
+  read_ahead_order_.clear();
+  next_sequential_block_.clear();
+  free_extents_.clear();
+  used_size_ = 0UL;
+}
+
+uint64_t DiskBlockStore::SlotSize(uint64_t block_size) const {
+  if (!direct_io_) {
+    return block_size;
+  }
+  return (block_size + kDirectIoAlign - 1UL) / kDirectIoAlign * kDirectIoAlign;
+}
+
+bool DiskBlockStore::AllocateExtent(uint64_t size, uint64_t &offset) {
+  for (auto it = free_extents_.begin(); it != free_extents_.end(); ++it) {
+    if (it->second < size) {
+      continue;
+    }
+    offset = it->first;
+    const uint64_t remain = it->second - size;
+    free_extents_.erase(it);
+    if (remain > 0UL) {
+      free_extents_[offset + size] = remain;
+    }
+    return true;
+  }
+  return false;
+}
+
+void DiskBlockStore::FreeExtent(uint64_t offset, uint64_t size) {
+  auto it = free_extents_.emplace(offset, size).first;
+  const auto next = std::next(it);
+  if ((next != free_extents_.end()) && (offset + size == next->first)) {
+    it->second += next->second;
+    free_extents_.erase(next);
+  }
+  if (it != free_extents_.begin()) {
+    const auto prev = std::prev(it);
+    if (prev->first + prev->second == offset) {
+      prev->second += it->second;
+      free_extents_.erase(it);
+    }
+  }
+}
+
+bool DiskBlockStore::EvictOne() {
+  for (const auto &key : lru_) {
+    const auto it = index_.find(key);
+    if ((it != index_.end()) && (it->second.io_refs == 0U)) {
+      LLMLOGD("evict disk block, cache_id = %ld, tensor_index = %u, block_index = %ld", key.cache_id,
+              key.tensor_index, key.block_index);
+      EraseBlock(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+void DiskBlockStore::EraseBlock(std::map<DiskBlockKey, Extent>::iterator iter) {
+  const uint64_t slot_size = SlotSize(iter->second.block_size);
+  FreeExtent(iter->second.offset, slot_size);
+  used_size_ -= slot_size;
+  lru_.erase(iter->second.lru_iter);
+  DropReadAhead(iter->first);
+  index_.erase(iter);
+}
+
+void DiskBlockStore::DropReadAhead(const DiskBlockKey &key) {
+  const auto it = read_ahead_.find(key);
+  if (it != read_ahead_.end()) {
+    read_ahead_order_.erase(it->second.order_iter);
+    read_ahead_.erase(it);
+  }
+}
+
+ge::Status DiskBlockStore::DropIdleBlocks(const std::vector<DiskBlockKey> &keys, std::unique_lock<std::mutex> &lock) {
+  // a repeated key would be reserved twice, leaking the first extent and its lru entry
+  const std::set<DiskBlockKey> unique_keys(keys.cbegin(), keys.cend());
+  LLM_CHK_BOOL_RET_STATUS(unique_keys.size() == keys.size(), ge::LLM_PARAM_INVALID,
+                         "disk blocks to reserve are not unique, block num = %zu", keys.size());
+  // old content may still be read by an earlier request. nothing is reserved while waiting and all keys are checked
+  // in one predicate, so two swap outs sharing blocks can not each hold a block the other waits for
+  cv_.wait(lock, [this, &keys]() {
+    return std::all_of(keys.cbegin(), keys.cend(), [this](const DiskBlockKey &key) {
+      const auto it = index_.find(key);
+      return (it == index_.end()) || (it->second.io_refs == 0U);
+    });
+  });
+  for (const auto &key : keys) {
+    const auto it = index_.find(key);
+    if (it != index_.end()) {
+      EraseBlock(it);
+    }
+  }
+  return ge::SUCCESS;
+}
+
+ge::Status DiskBlockStore::ReserveBlocks(const std::vector<DiskBlockKey> &keys, uint64_t block_size) {
+  const uint64_t slot_size = SlotSize(block_size);
+  // evicting can not help a request larger than the whole file
+  LLM_CHK_BOOL_RET_STATUS(slot_size * keys.size() <= capacity_, ge::LLM_OUT_OF_MEMORY,
+                         "%zu blocks of %lu bytes exceed disk tier capacity %lu", keys.size(), block_size, capacity_);
+  auto insert_block = [this, block_size, slot_size](const DiskBlockKey &key, uint64_t offset) {
+    Extent extent{};
+    extent.offset = offset;
+    extent.block_size = block_size;
+    extent.io_refs = 1U;
+    extent.writing = true;
+    extent.lru_iter = lru_.insert(lru_.end(), key);
+    index_[key] = extent;
+    used_size_ += slot_size;
+  };
+  uint64_t offset = 0UL;
+  // contiguous blocks go to one extent and are written by as few ios as possible
+  if (AllocateExtent(slot_size * keys.size(), offset)) {
+    for (size_t i = 0U; i < keys.size(); ++i) {
+      insert_block(keys[i], offset + i * slot_size);
+    }
+    return ge::SUCCESS;
+  }
+  for (size_t i = 0U; i < keys.size(); ++i) {
+    while (!AllocateExtent(slot_size, offset)) {
+      if (!EvictOne()) {
+        LLMLOGE(ge::LLM_OUT_OF_MEMORY, "disk tier is full, used size = %lu, block size = %lu", used_size_,
+                block_size);
+        for (size_t j = 0U; j < i; ++j) {
+          EraseBlock(index_.find(keys[j]));
+        }
+        return ge::LLM_OUT_OF_MEMORY;
+      }
+    }
+    insert_block(keys[i], offset);
+  }
+  return ge::SUCCESS;
+}
+
+void DiskBlockStore::BuildPieces(const std::vector<std::pair<DiskBlockKey, uintptr_t>> &blocks,
+                                 uint64_t block_size, std::vector<IoPiece> &pieces) const {
+  const uint64_t slot_size = SlotSize(block_size);
+  const size_t max_blocks = std::max(kMaxIoSize / slot_size, static_cast<uint64_t>(1UL));
+  IoPiece *current = nullptr;
+  for (const auto &block : blocks) {
+    const uint64_t offset = index_.at(block.first).offset;
+    if ((current != nullptr) && (current->keys.size() < max_blocks) &&
+        (offset == current->file_offset + current->keys.size() * slot_size) &&
+        (block.second == current->host_addr + current->keys.size() * block_size)) {
+      current->keys.emplace_back(block.first);
+      continue;
+    }
+    pieces.emplace_back();
+    current = &pieces.back();
+    current->keys.emplace_back(block.first);
+    current->file_offset = offset;
+    current->host_addr = block.second;
+    current->block_size = block_size;
+    current->slot_size = slot_size;
+  }
+}
+
+void DiskBlockStore::Submit(const DiskIoHandle &handle, std::function<ge::Status()> task) {
+  if (handle != nullptr) {
+    handle->AddPending();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    ++inflight_tasks_;
+  }
+  auto run = [this, handle, task]() {
+    const ge::Status status = task();
+    if (handle != nullptr) {
+      handle->Complete(status);
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    --inflight_tasks_;
+    cv_.notify_all();
+  };
+  const auto future = io_pool_->commit(run);
+  if (!future.valid()) {
+    LLMLOGW("failed to commit disk io task, run it in place");
+    run();
+  }
+}
+
+ge::Status DiskBlockStore::AcquireBounceBuffer(uint64_t size, std::unique_ptr<AlignedPtr> &buffer,
+                                               uint64_t &buffer_size) {
+  {
+    std::lock_guard<std::mutex> lock(bounce_mu_);
+    for (auto it = bounce_buffers_.begin(); it != bounce_buffers_.end(); ++it) {
+      if (it->second >= size) {
+        buffer = std::move(it->first);
+        buffer_size = it->second;
+        (void)bounce_buffers_.erase(it);
+        return ge::SUCCESS;
+      }
+    }
+  }
+  buffer_size = std::max(size, kMaxIoSize);
+  buffer = MakeUnique<AlignedPtr>(buffer_size, kDirectIoAlign);
+  LLM_CHK_BOOL_RET_STATUS((buffer != nullptr) && (buffer->MutableGet() != nullptr), ge::LLM_OUT_OF_MEMORY,
+                         "failed to allocate %lu bytes bounce buffer", buffer_size);
+  return ge::SUCCESS;
+}
+
+void DiskBlockStore::ReleaseBounceBuffer(std::unique_ptr<AlignedPtr> buffer, uint64_t buffer_size) {
+  std::lock_guard<std::mutex> lock(bounce_mu_);
+  // at most one buffer per io thread is ever in use
+  if (bounce_buffers_.size() < options_.io_thread_num) {
+    bounce_buffers_.emplace_back(std::move(buffer), buffer_size);
+  }
+}
+
+ge::Status DiskBlockStore::WritePiece(const IoPiece &piece) {
+  const uint64_t len = piece.keys.size() * piece.slot_size;
+  auto host = reinterpret_cast<uint8_t *>(piece.host_addr);
+  if ((piece.block_size == piece.slot_size) && (!direct_io_ || (piece.host_addr % kDirectIoAlign == 0UL))) {
+    return FullIo(true, fd_, host, len, piece.file_offset);
+  }
+  std::unique_ptr<AlignedPtr> buffer;
+  uint64_t buffer_size = 0UL;
+  LLM_CHK_STATUS_RET(AcquireBounceBuffer(len, buffer, buffer_size));
+  uint8_t *const bounce = buffer->MutableGet();
+  for (size_t i = 0U; i < piece.keys.size(); ++i) {
+    LLM_CHK_BOOL_RET_STATUS(memcpy_s(bounce + i * piece.slot_size, piece.slot_size, host + i * piece.block_size,
+                                     piece.block_size) == EOK, ge::FAILED, "copy block to bounce buffer failed");
+  }
+  const ge::Status ret = FullIo(true, fd_, bounce, len, piece.file_offset);
+  ReleaseBounceBuffer(std::move(buffer), buffer_size);
+  return ret;
+}
+
+ge::Status DiskBlockStore::ReadPiece(const IoPiece &piece) {
+  const uint64_t len = piece.keys.size() * piece.slot_size;
+  auto host = reinterpret_cast<uint8_t *>(piece.host_addr);
+  if ((piece.block_size == piece.slot_size) && (!direct_io_ || (piece.host_addr % kDirectIoAlign == 0UL))) {
+    return FullIo(false, fd_, host, len, piece.file_offset);
+  }
+  std::unique_ptr<AlignedPtr> buffer;
+  uint64_t buffer_size = 0UL;
+  LLM_CHK_STATUS_RET(AcquireBounceBuffer(len, buffer, buffer_size));
+  uint8_t *const bounce = buffer->MutableGet();
+  LLM_CHK_STATUS_RET(FullIo(false, fd_, bounce, len, piece.file_offset));
+  for (size_t i = 0U; i < piece.keys.size(); ++i) {
+    LLM_CHK_BOOL_RET_STATUS(memcpy_s(host + i * piece.block_size, piece.block_size, bounce + i * piece.slot_size,
+                                     piece.block_size) == EOK, ge::FAILED, "copy block from bounce buffer failed");
+  }
+  ReleaseBounceBuffer(std::move(buffer), buffer_size);
+  return ge::SUCCESS;
+}
+
+void DiskBlockStore::FinishPiece(const IoPiece &piece, bool is_write, ge::Status status) {
+  std::lock_guard<std::mutex> lock(mu_);
+  for (const auto &key : piece.keys) {
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+      continue;
+    }
+    --it->second.io_refs;
+    if (is_write) {
+      it->second.writing = false;
+      // a block that never reached the file must not be read back
+      if (status != ge::SUCCESS) {
+        EraseBlock(it);
+        continue;
+      }
+    }
+    lru_.splice(lru_.end(), lru_, it->second.lru_iter);
+  }
+  cv_.notify_all();
+}
+
+ge::Status DiskBlockStore::SwapOutAsync(const std::vector<uintptr_t> &tensor_addrs, int64_t disk_cache_id,
+                                        uint64_t block_size,
+                                        const std::vector<std::pair<int64_t, int64_t>> &block_mapping,
+                                        DiskIoHandle &handle) {
+  LLM_CHK_BOOL_RET_STATUS(fd_ >= 0, ge::LLM_FEATURE_NOT_ENABLED, "disk tier is not initialized");
+  LLM_CHK_STATUS_RET(CheckSwapParam(tensor_addrs, block_size, block_mapping), "check swap out param failed");
+  std::vector<std::vector<std::pair<int64_t, int64_t>>> ordered_block_mapping;
+  LLM_CHK_STATUS_RET(LLMUtils::FindContiguousBlockIndexPair(block_mapping, ordered_block_mapping));
+  handle = MakeShared<DiskIoRequest>();
+  LLM_CHECK_NOTNULL(handle);
+  std::vector<std::vector<DiskBlockKey>> key_groups;
+  std::vector<std::vector<std::pair<DiskBlockKey, uintptr_t>>> block_groups;
+  std::vector<DiskBlockKey> all_keys;
+  for (size_t i = 0U; i < tensor_addrs.size(); ++i) {
+    for (const auto &ordered_block : ordered_block_mapping) {
+      std::vector<DiskBlockKey> keys;
+      std::vector<std::pair<DiskBlockKey, uintptr_t>> blocks;
+      for (const auto &block : ordered_block) {
+        const DiskBlockKey key{disk_cache_id, static_cast<uint32_t>(i), block.second};
+        keys.emplace_back(key);
+        blocks.emplace_back(key, tensor_addrs[i] + static_cast<uint64_t>(block.first) * block_size);
+      }
+      all_keys.insert(all_keys.end(), keys.begin(), keys.end());
+      key_groups.emplace_back(std::move(keys));
+      block_groups.emplace_back(std::move(blocks));
+    }
+  }
+  std::vector<IoPiece> pieces;
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    LLM_CHK_STATUS_RET(DropIdleBlocks(all_keys, lock), "wait disk blocks idle failed");
+    std::vector<DiskBlockKey> reserved;
+    for (size_t i = 0U; i < key_groups.size(); ++i) {
+      const ge::Status ret = ReserveBlocks(key_groups[i], block_size);
+      if (ret != ge::SUCCESS) {
+        for (const auto &key : reserved) {
+          EraseBlock(index_.find(key));
+        }
+        cv_.notify_all();
+        return ret;
+      }
+      reserved.insert(reserved.end(), key_groups[i].begin(), key_groups[i].end());
+      BuildPieces(block_groups[i], block_size, pieces);
+    }
+  }
+  for (const auto &piece : pieces) {
+    Submit(handle, [this, piece]() -> ge::Status {
+      const ge::Status ret = WritePiece(piece);
+      FinishPiece(piece, true, ret);
+      return ret;
+    });
+  }
+  LLMLOGI("swap out to disk submitted, disk cache_id = %ld, tensor num = %zu, block num = %zu, io num = %zu",
+          disk_cache_id, tensor_addrs.size(), block_mapping.size(), pieces.size());
+  return ge::SUCCESS;
+}
+
+void DiskBlockStore::ReadAhead(int64_t disk_cache_id, uint32_t tensor_index, int64_t next_block,
+                               uint64_t block_size, std::vector<Prefetch> &prefetches) {
+  if (options_.read_ahead_blocks == 0U) {
+    return;
+  }
+  std::vector<std::pair<DiskBlockKey, uintptr_t>> blocks;
+  for (int64_t block_index = next_block; block_index < next_block + options_.read_ahead_blocks; ++block_index) {
+    const DiskBlockKey key{disk_cache_id, tensor_index, block_index};
+    if (read_ahead_.count(key) > 0U) {
+      continue;
+    }
+    const auto it = index_.find(key);
+    if ((it == index_.end()) || it->second.writing || (it->second.block_size != block_size)) {
+      break;
+    }
+    // read ahead data lands in its own buffer slot by slot, so only file adjacency matters
+    blocks.emplace_back(key, it->second.offset);
+  }
+  const uint64_t slot_size = SlotSize(block_size);
+  std::vector<IoPiece> pieces;
+  BuildPieces(blocks, slot_size, pieces);
+  for (auto &piece : pieces) {
+    auto chunk = MakeShared<ReadAheadChunk>();
+    auto promise = MakeShared<std::promise<ge::Status>>();
+    if ((chunk == nullptr) || (promise == nullptr)) {
+      return;
+    }
+    chunk->buffer = MakeUnique<AlignedPtr>(piece.keys.size() * slot_size, kDirectIoAlign);
+    if ((chunk->buffer == nullptr) || (chunk->buffer->MutableGet() == nullptr)) {
+      return;
+    }
+    chunk->slot_size = slot_size;
+    chunk->done = promise->get_future().share();
+    piece.host_addr = reinterpret_cast<uintptr_t>(chunk->buffer->MutableGet());
+    piece.block_size = slot_size;
+    piece.slot_size = slot_size;
+    for (size_t i = 0U; i < piece.keys.size(); ++i) {
+      ++index_[piece.keys[i]].io_refs;
+      ReadAheadEntry entry{};
+      entry.chunk = chunk;
+      entry.slot_index = i;
+      entry.order_iter = read_ahead_order_.insert(read_ahead_order_.end(), piece.keys[i]);
+      read_ahead_[piece.keys[i]] = entry;
+    }
+    prefetches.emplace_back(Prefetch{piece, chunk, promise});
+  }
+  const size_t max_read_ahead_blocks = static_cast<size_t>(options_.read_ahead_blocks) * kReadAheadStreams;
+  while (read_ahead_.size() > max_read_ahead_blocks) {
+    DropReadAhead(read_ahead_order_.front());
+  }
+}
+
+ge::Status DiskBlockStore::SwapInAsync(int64_t disk_cache_id, const std::vector<uintptr_t> &tensor_addrs,
+                                       uint64_t block_size,
+                                       const std::vector<std::pair<int64_t, int64_t>> &block_mapping,
+                                       DiskIoHandle &handle) {
+  LLM_CHK_BOOL_RET_STATUS(fd_ >= 0, ge::LLM_FEATURE_NOT_ENABLED, "disk tier is not initialized");
+  LLM_CHK_STATUS_RET(CheckSwapParam(tensor_addrs, block_size, block_mapping), "check swap in param failed");
+  std::vector<std::vector<std::pair<int64_t, int64_t>>> ordered_block_mapping;
+  LLM_CHK_STATUS_RET(LLMUtils::FindContiguousBlockIndexPair(block_mapping, ordered_block_mapping));
+  handle = MakeShared<DiskIoRequest>();
+  LLM_CHECK_NOTNULL(handle);
+  struct ReadAheadHit {
+    std::shared_ptr<ReadAheadChunk> chunk;
+    size_t slot_index;
+    uintptr_t host_addr;
+  };
+  std::vector<IoPiece> pieces;
+  std::vector<ReadAheadHit> hits;
+  std::vector<Prefetch> prefetches;
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    bool missing = false;
+    DiskBlockKey key{disk_cache_id, 0U, 0};
+    // blocks still being written are waited for, missing blocks fail the whole request before any io is issued
+    cv_.wait(lock, [this, &tensor_addrs, &block_mapping, &key, &missing]() {
+      for (size_t i = 0U; i < tensor_addrs.size(); ++i) {
+        for (const auto &block : block_mapping) {
+          key.tensor_index = static_cast<uint32_t>(i);
+          key.block_index = block.first;
+          const auto it = index_.find(key);
+          if (it == index_.end()) {
+            missing = true;
+            return true;
+          }
+          if (it->second.writing) {
+            return false;
+          }
+        }
+      }
+      return true;
+    });
+    LLM_CHK_BOOL_RET_STATUS(!missing, ge::LLM_KV_CACHE_NOT_EXIST,
+                           "block is not on disk, cache_id = %ld, tensor_index = %u, block_index = %ld",
+                           key.cache_id, key.tensor_index, key.block_index);
+    for (size_t i = 0U; i < tensor_addrs.size(); ++i) {
+      for (const auto &block : block_mapping) {
+        const auto &extent = index_.at(DiskBlockKey{disk_cache_id, static_cast<uint32_t>(i), block.first});
+        LLM_CHK_BOOL_RET_STATUS(extent.block_size == block_size, ge::LLM_PARAM_INVALID,
+                               "block %ld was swapped out with block size %lu, not %lu", block.first,
+                               extent.block_size, block_size);
+      }
+    }
+    for (size_t i = 0U; i < tensor_addrs.size(); ++i) {
+      const auto stream = std::make_pair(disk_cache_id, static_cast<uint32_t>(i));
+      for (const auto &ordered_block : ordered_block_mapping) {
+        std::vector<std::pair<DiskBlockKey, uintptr_t>> blocks;
+        for (const auto &block : ordered_block) {
+          key = DiskBlockKey{disk_cache_id, static_cast<uint32_t>(i), block.first};
+          const uintptr_t host_addr = tensor_addrs[i] + static_cast<uint64_t>(block.second) * block_size;
+          auto &extent = index_.at(key);
+          lru_.splice(lru_.end(), lru_, extent.lru_iter);
+          const auto read_ahead_it = read_ahead_.find(key);
+          if (read_ahead_it != read_ahead_.end()) {
+            hits.emplace_back(ReadAheadHit{read_ahead_it->second.chunk, read_ahead_it->second.slot_index, host_addr});
+            DropReadAhead(key);
+            continue;
+          }
+          ++extent.io_refs;
+          blocks.emplace_back(key, host_addr);
+        }
+        BuildPieces(blocks, block_size, pieces);
+        const auto stream_it = next_sequential_block_.find(stream);
+        const bool sequential =
+            (stream_it != next_sequential_block_.end()) && (stream_it->second == ordered_block.front().first);
+        next_sequential_block_[stream] = ordered_block.back().first + 1;
+        if (sequential) {
+          ReadAhead(disk_cache_id, static_cast<uint32_t>(i), ordered_block.back().first + 1, block_size,
+                    prefetches);
+        }
+      }
+    }
+  }
+  for (const auto &piece : pieces) {
+    Submit(handle, [this, piece]() -> ge::Status {
+      const ge::Status ret = ReadPiece(piece);
+      FinishPiece(piece, false, ret);
+      return ret;
+    });
+  }
+  for (const auto &prefetch : prefetches) {
+    Submit(nullptr, [this, prefetch]() -> ge::Status {
+      const ge::Status ret = ReadPiece(prefetch.piece);
+      FinishPiece(prefetch.piece, false, ret);
+      prefetch.promise->set_value(ret);
+      return ret;
+    });
+  }
+  // hits wait for read ahead submitted before them, io threads take tasks in order so this never blocks forever
+  for (const auto &hit : hits) {
+    Submit(handle, [hit, block_size]() -> ge::Status {
+      LLM_CHK_STATUS_RET(hit.chunk->done.get(), "read ahead of block failed");
+      const uint8_t *const src = hit.chunk->buffer->Get() + hit.slot_index * hit.chunk->slot_size;
+      LLM_CHK_BOOL_RET_STATUS(memcpy_s(reinterpret_cast<void *>(hit.host_addr), block_size, src, block_size) == EOK,
+                             ge::FAILED, "copy block from read ahead buffer failed");
+      return ge::SUCCESS;
+    });
+  }
+  LLMLOGI("swap in from disk submitted, disk cache_id = %ld, tensor num = %zu, block num = %zu, io num = %zu, "
+          "read ahead hit num = %zu, prefetch num = %zu", disk_cache_id, tensor_addrs.size(), block_mapping.size(),
+          pieces.size(), hits.size(), prefetches.size());
+  return ge::SUCCESS;
+}
+
+ge::Status DiskBlockStore::SwapOut(const std::vector<uintptr_t> &tensor_addrs, int64_t disk_cache_id,
+                                   uint64_t block_size,
+                                   const std::vector<std::pair<int64_t, int64_t>> &block_mapping) {
+  DiskIoHandle handle;
+  LLM_CHK_STATUS_RET(SwapOutAsync(tensor_addrs, disk_cache_id, block_size, block_mapping, handle));
+  return handle->Wait();
+}
+
+ge::Status DiskBlockStore::SwapIn(int64_t disk_cache_id, const std::vector<uintptr_t> &tensor_addrs,
+                                  uint64_t block_size, const std::vector<std::pair<int64_t, int64_t>> &block_mapping) {
+  DiskIoHandle handle;
+  LLM_CHK_STATUS_RET(SwapInAsync(disk_cache_id, tensor_addrs, block_size, block_mapping, handle));
+  return handle->Wait();
+}
+
+void DiskBlockStore::Remove(int64_t disk_cache_id) {
+  std::unique_lock<std::mutex> lock(mu_);
+  const DiskBlockKey first_key{disk_cache_id, 0U, INT64_MIN};
+  cv_.wait(lock, [this, &first_key]() {
+    for (auto it = index_.lower_bound(first_key); (it != index_.end()) && (it->first.cache_id == first_key.cache_id);
+         ++it) {
+      if (it->second.io_refs > 0U) {
+        return false;
+      }
+    }
+    return true;
+  });
+  auto it = index_.lower_bound(first_key);
+  while ((it != index_.end()) && (it->first.cache_id == disk_cache_id)) {
+    EraseBlock(it++);
+  }
+  auto stream_it = next_sequential_block_.lower_bound(std::make_pair(disk_cache_id, 0U));
+  while ((stream_it != next_sequential_block_.end()) && (stream_it->first.first == disk_cache_id)) {
+    stream_it = next_sequential_block_.erase(stream_it);
+  }
+}
+
+bool DiskBlockStore::Contains(const DiskBlockKey &key) {
+  std::lock_guard<std::mutex> lock(mu_);
+  return index_.count(key) > 0U;
+}
+
+uint64_t DiskBlockStore::GetUsedSize() {
+  std::lock_guard<std::mutex> lock(mu_);
+  return used_size_;
+}
+}  // namespace llm
@@ -0,0 +1,172 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_DISK_BLOCK_STORE_H_
+#define CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_DISK_BLOCK_STORE_H_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "common/llm_inner_types.h"
+#include "common/llm_thread_pool.h"
+#include "common/aligned_ptr.h"
+
+namespace llm {
+struct DiskTierOptions {
+  std::string path;                 // directory of the backing file, normally on a local nvme device
+  uint64_t capacity = 0UL;          // size of the backing file in bytes
+  bool direct_io = true;            // bypass the page cache, falls back to buffered io if the file system refuses
+  uint32_t io_thread_num = 4U;      // io requests kept in flight
+  uint32_t read_ahead_blocks = 8U;  // blocks prefetched behind a sequential swap in, 0 disables read ahead
+};
+
+struct DiskBlockKey {
+  int64_t cache_id;
+  uint32_t tensor_index;
+  int64_t block_index;
+  bool operator<(const DiskBlockKey &other) const {
+    if (cache_id != other.cache_id) {
+      return cache_id < other.cache_id;
+    }
+    if (tensor_index != other.tensor_index) {
+      return tensor_index < other.tensor_index;
+    }
+    return block_index < other.block_index;
+  }
+};
+
+class DiskIoRequest {
+ public:
+  // blocks until every io of the request finished, returns the first failure
+  ge::Status Wait();
+  bool IsCompleted();
+
+ private:
+  friend class DiskBlockStore;
+  void AddPending();
+  void Complete(ge::Status status);
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  uint32_t pending_ = 0U;
+  ge::Status status_ = ge::SUCCESS;
+};
+using DiskIoHandle = std::shared_ptr<DiskIoRequest>;
+
+// Third tier of kv blocks below the host memory pool. Blocks live in extents of one backing file, an index maps
+// (cache id, tensor index, block index) to its extent, least recently used blocks are dropped once the file is full.
+class DiskBlockStore {
+ public:
+  explicit DiskBlockStore(DiskTierOptions options) : options_(std::move(options)) {}
+  ~DiskBlockStore();
+  DiskBlockStore(const DiskBlockStore &) = delete;
+  DiskBlockStore &operator=(const DiskBlockStore &) = delete;
+
+  ge::Status Initialize();
+  void Finalize();
+  // block_mapping holds (host block index, disk block index), tensor_addrs are host addresses of each tensor
+  ge::Status SwapOutAsync(const std::vector<uintptr_t> &tensor_addrs, int64_t disk_cache_id, uint64_t block_size,
+                          const std::vector<std::pair<int64_t, int64_t>> &block_mapping, DiskIoHandle &handle);
+  // block_mapping holds (disk block index, host block index)
+  ge::Status SwapInAsync(int64_t disk_cache_id, const std::vector<uintptr_t> &tensor_addrs, uint64_t block_size,
+                         const std::vector<std::pair<int64_t, int64_t>> &block_mapping, DiskIoHandle &handle);
+  ge::Status SwapOut(const std::vector<uintptr_t> &tensor_addrs, int64_t disk_cache_id, uint64_t block_size,
+                     const std::vector<std::pair<int64_t, int64_t>> &block_mapping);
+  ge::Status SwapIn(int64_t disk_cache_id, const std::vector<uintptr_t> &tensor_addrs, uint64_t block_size,
+                    const std::vector<std::pair<int64_t, int64_t>> &block_mapping);
+  // drops every block of the disk cache
+  void Remove(int64_t disk_cache_id);
+  bool Contains(const DiskBlockKey &key);
+  uint64_t GetUsedSize();
+  bool IsDirectIo() const {
+    return direct_io_;
+  }
+
+ private:
+  struct Extent {
+    uint64_t offset = 0UL;
+    uint64_t block_size = 0UL;
+    uint32_t io_refs = 0U;  // pinned while io is in flight, never evicted or freed then
+    bool writing = false;
+    std::list<DiskBlockKey>::iterator lru_iter;
+  };
+  // one contiguous file range and the host blocks it maps to
+  struct IoPiece {
+    std::vector<DiskBlockKey> keys;
+    uint64_t file_offset = 0UL;
+    uintptr_t host_addr = 0UL;  // host address of the first block, following blocks are contiguous
+    uint64_t block_size = 0UL;
+    uint64_t slot_size = 0UL;
+  };
+  struct ReadAheadChunk {
+    std::unique_ptr<AlignedPtr> buffer;
+    uint64_t slot_size = 0UL;
+    std::shared_future<ge::Status> done;
+  };
+  struct ReadAheadEntry {
+    std::shared_ptr<ReadAheadChunk> chunk;
+    size_t slot_index = 0U;
+    std::list<DiskBlockKey>::iterator order_iter;
+  };
+  struct Prefetch {
+    IoPiece piece;
+    std::shared_ptr<ReadAheadChunk> chunk;
+    std::shared_ptr<std::promise<ge::Status>> promise;
+  };
+
+  uint64_t SlotSize(uint64_t block_size) const;
+  bool AllocateExtent(uint64_t size, uint64_t &offset);
+  void FreeExtent(uint64_t offset, uint64_t size);
+  bool EvictOne();
+  void EraseBlock(std::map<DiskBlockKey, Extent>::iterator iter);
+  // waits until no io uses any of the keys, then drops their old content
+  ge::Status DropIdleBlocks(const std::vector<DiskBlockKey> &keys, std::unique_lock<std::mutex> &lock);
+  ge::Status ReserveBlocks(const std::vector<DiskBlockKey> &keys, uint64_t block_size);
+  void DropReadAhead(const DiskBlockKey &key);
+  // merges blocks adjacent both in the file and in host memory
+  void BuildPieces(const std::vector<std::pair<DiskBlockKey, uintptr_t>> &blocks, uint64_t block_size,
+                   std::vector<IoPiece> &pieces) const;
+  // handle may be nullptr for read ahead
+  void Submit(const DiskIoHandle &handle, std::function<ge::Status()> task);
+  ge::Status WritePiece(const IoPiece &piece);
+  ge::Status ReadPiece(const IoPiece &piece);
+  void FinishPiece(const IoPiece &piece, bool is_write, ge::Status status);
+  void ReadAhead(int64_t disk_cache_id, uint32_t tensor_index, int64_t next_block, uint64_t block_size,
+                 std::vector<Prefetch> &prefetches);
+  ge::Status AcquireBounceBuffer(uint64_t size, std::unique_ptr<AlignedPtr> &buffer, uint64_t &buffer_size);
+  void ReleaseBounceBuffer(std::unique_ptr<AlignedPtr> buffer, uint64_t buffer_size);
+
+  DiskTierOptions options_;
+  int32_t fd_ = -1;
+  bool direct_io_ = false;
+  uint64_t capacity_ = 0UL;
+  std::unique_ptr<LLMThreadPool> io_pool_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  uint32_t inflight_tasks_ = 0U;
+  uint64_t used_size_ = 0UL;
+  std::map<uint64_t, uint64_t> free_extents_;  // offset -> size
+  std::map<DiskBlockKey, Extent> index_;
+  std::list<DiskBlockKey> lru_;                // front is the least recently used
+  std::map<DiskBlockKey, ReadAheadEntry> read_ahead_;
+  std::list<DiskBlockKey> read_ahead_order_;
+  std::map<std::pair<int64_t, uint32_t>, int64_t> next_sequential_block_;
+  std::mutex bounce_mu_;
+  std::vector<std::pair<std::unique_ptr<AlignedPtr>, uint64_t>> bounce_buffers_;
+};
+}  // namespace llm
+
+#endif  // CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_DISK_BLOCK_STORE_H_
@@ -0,0 +1,351 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "kv_prefetcher.h"
+#include <algorithm>
+#include <set>
+#include "common/llm_checker.h"
+#include "common/llm_log.h"
+#include "common/mem_utils.h"
+
+namespace llm {
+KvPrefetcher::KvPrefetcher(KvPrefetchOptions options, KvPrefetchPullFunc pull_func)
+    : options_(options), pull_func_(std::move(pull_func)) {}
+
+KvPrefetcher::~KvPrefetcher() {
+  Finalize();
+}
+
+ge::Status KvPrefetcher::Initialize() {
+  LLM_CHK_BOOL_RET_STATUS(options_.slot_num > 0UL, ge::LLM_PARAM_INVALID, "slot_num must be positive");
+  LLM_CHK_BOOL_RET_STATUS(options_.min_repeat > 0U, ge::LLM_PARAM_INVALID, "min_repeat must be positive");
+  LLM_CHK_BOOL_RET_STATUS(options_.max_prefixes > 0U, ge::LLM_PARAM_INVALID, "max_prefixes must be positive");
+  LLM_CHK_BOOL_RET_STATUS(pull_func_ != nullptr, ge::LLM_PARAM_INVALID, "pull function is not set");
+  if ((options_.admission_blocks == 0UL) || (options_.admission_blocks > options_.slot_num)) {
+    options_.admission_blocks = options_.slot_num;
+  }
+  slots_.assign(options_.slot_num, Slot{});
+  free_slots_.clear();
+  // popped from the back, low slots go first
+  for (uint64_t slot = options_.slot_num; slot > 0UL; --slot) {
+    free_slots_.emplace_back(slot - 1UL);
+  }
+  // one puller, prefetch never competes with itself for the link
+  pull_pool_ = MakeUnique<LLMThreadPool>("llm_kv_prefetch", 1U);
+  LLM_CHECK_NOTNULL(pull_pool_);
+  LLMLOGI("kv prefetch initialized, slot_num = %lu, admission_blocks = %lu, lookahead_blocks = %u, min_repeat = %u, "
+          "max_prefixes = %u", options_.slot_num, options_.admission_blocks, options_.lookahead_blocks,
+          options_.min_repeat, options_.max_prefixes);
+  return ge::SUCCESS;
+}
+
+void KvPrefetcher::Finalize() {
+  WaitIdle();
+  pull_pool_.reset();
+  std::lock_guard<std::mutex> lock(mu_);
+  if (stats_.requested_blocks > 0UL) {
+    LLMLOGI("kv prefetch stats: requested = %lu, hit = %lu, prefetched = %lu, wasted = %lu, unused = %lu, "
+            "dropped = %lu, failed = %lu, invalidated = %lu", stats_.requested_blocks, stats_.hit_blocks,
+            stats_.prefetched_blocks, stats_.wasted_blocks, unused_slots_, stats_.dropped_blocks,
+            stats_.failed_blocks, stats_.invalidated_blocks);
+  }
+  resident_.clear();
+  generations_.clear();
+  lru_.clear();
+  history_.clear();
+  history_lru_.clear();
+  slots_.clear();
+  free_slots_.clear();
+  unused_slots_ = 0UL;
+}
+
+void KvPrefetcher::WaitIdle() {
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this]() { return inflight_pulls_ == 0U; });
+}
+
+KvPrefetchStats KvPrefetcher::GetStats() {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto stats = stats_;
+  stats.unused_blocks = unused_slots_;
+  return stats;
+}
+
+KvPrefetcher::BlockKey KvPrefetcher::ToBlockKey(const CacheKey &cache_key, uint64_t block_index) {
+  return BlockKey{cache_key.prompt_cluster_id, cache_key.prompt_cache_id, cache_key.prompt_cache_generation,
+                  block_index};
+}
+
+void KvPrefetcher::UpdateGeneration(const CacheKey &cache_key) {
+  const auto cache = std::make_pair(cache_key.prompt_cluster_id, cache_key.prompt_cache_id);
+  const auto it = generations_.find(cache);
+  if (it == generations_.end()) {
+    generations_[cache] = cache_key.prompt_cache_generation;
+    return;
+  }
+  if (it->second == cache_key.prompt_cache_generation) {
+    return;
+  }
+  LLMLOGI("prompt cache generation changed from %lu to %lu, remote cluster = %lu, cache_id = %ld", it->second,
+          cache_key.prompt_cache_generation, cache_key.prompt_cluster_id, cache_key.prompt_cache_id);
+  it->second = cache_key.prompt_cache_generation;
+  const auto in_cache = [&cache_key](const BlockKey &key) {
+    return (key.cluster_id == cache_key.prompt_cluster_id) && (key.cache_id == cache_key.prompt_cache_id);
+  };
+  const BlockKey first{cache_key.prompt_cluster_id, cache_key.prompt_cache_id, 0UL, 0UL};
+  for (auto resident = resident_.lower_bound(first); (resident != resident_.end()) && in_cache(resident->first);) {
+    const uint64_t slot = resident->second;
+    ++resident;
+    if (slots_[slot].key.generation == cache_key.prompt_cache_generation) {
+      continue;
+    }
+    ++stats_.invalidated_blocks;
+    auto &entry = slots_[slot];
+    if ((entry.state == SlotState::kReady) && (entry.pins == 0U)) {
+      Evict(slot);
+    } else {
+      // still being pulled or copied out, no longer found by requests
+      (void)resident_.erase(entry.key);
+      entry.stale = true;
+    }
+  }
+  for (auto history = history_.lower_bound(first); (history != history_.end()) && in_cache(history->first);) {
+    if (history->first.generation == cache_key.prompt_cache_generation) {
+      ++history;
+      continue;
+    }
+    history_lru_.erase(history->second.lru_iter);
+    history = history_.erase(history);
+  }
+}
+
+void KvPrefetcher::Acquire(const CacheKey &cache_key, const std::vector<uint64_t> &remote_blocks,
+                           std::vector<KvPrefetchHit> &hits) {
+  hits.clear();
+  if (remote_blocks.empty()) {
+    return;
+  }
+  PendingPull pull;
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    stats_.requested_blocks += remote_blocks.size();
+    // nothing tells whether the remote blocks still hold what was prefetched
+    if (cache_key.prompt_cache_generation == kNoGeneration) {
+      return;
+    }
+    UpdateGeneration(cache_key);
+    cv_.wait(lock, [this, &cache_key, &remote_blocks]() {
+      return std::none_of(remote_blocks.cbegin(), remote_blocks.cend(), [this, &cache_key](uint64_t block_index) {
+        const auto it = resident_.find(ToBlockKey(cache_key, block_index));
+        return (it != resident_.cend()) && (slots_[it->second].state == SlotState::kInFlight);
+      });
+    });
+    for (size_t i = 0U; i < remote_blocks.size(); ++i) {
+      const auto it = resident_.find(ToBlockKey(cache_key, remote_blocks[i]));
+      if (it == resident_.cend()) {
+        continue;
+      }
+      auto &slot = slots_[it->second];
+      if (!slot.used) {
+        slot.used = true;
+        --unused_slots_;
+      }
+      if (slot.in_lru) {
+        lru_.erase(slot.lru_iter);
+        slot.in_lru = false;
+      }
+      ++slot.pins;
+      hits.emplace_back(KvPrefetchHit{i, it->second});
+    }
+    stats_.hit_blocks += hits.size();
+
+    const auto history = history_.find(ToBlockKey(cache_key, remote_blocks.front()));
+    if ((history != history_.cend()) && (options_.lookahead_blocks > 0U)) {
+      const std::set<uint64_t> requested(remote_blocks.cbegin(), remote_blocks.cend());
+      std::vector<uint64_t> candidates;
+      for (const auto block_index : history->second.blocks) {
+        if ((requested.count(block_index) == 0U) && (resident_.count(ToBlockKey(cache_key, block_index)) == 0U)) {
+          candidates.emplace_back(block_index);
+          if (candidates.size() >= options_.lookahead_blocks) {
+            break;
+          }
+        }
+      }
+      Schedule(cache_key, candidates, pull);
+    }
+  }
+  Submit(std::move(pull));
+}
+
+void KvPrefetcher::Release(const std::vector<KvPrefetchHit> &hits) {
+  std::lock_guard<std::mutex> lock(mu_);
+  for (const auto &hit : hits) {
+    auto &slot = slots_[hit.slot];
+    if ((slot.pins > 0U) && (--slot.pins == 0U)) {
+      if (slot.stale) {
+        Evict(hit.slot);
+        continue;
+      }
+      slot.lru_iter = lru_.insert(lru_.end(), hit.slot);
+      slot.in_lru = true;
+    }
+  }
+}
+
+void KvPrefetcher::Record(const CacheKey &cache_key, const std::vector<uint64_t> &remote_blocks) {
+  if (remote_blocks.empty() || (cache_key.prompt_cache_generation == kNoGeneration)) {
+    return;
+  }
+  PendingPull pull;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    UpdateGeneration(cache_key);
+    const auto prefix = ToBlockKey(cache_key, remote_blocks.front());
+    auto it = history_.find(prefix);
+    if (it == history_.end()) {
+      if (history_.size() >= options_.max_prefixes) {
+        (void)history_.erase(history_lru_.front());
+        history_lru_.pop_front();
+      }
+      it = history_.emplace(prefix, PrefixHistory{}).first;
+      it->second.lru_iter = history_lru_.insert(history_lru_.end(), prefix);
+    } else {
+      history_lru_.splice(history_lru_.end(), history_lru_, it->second.lru_iter);
+    }
+    auto &history = it->second;
+    std::vector<uint64_t> candidates;
+    for (const auto block_index : remote_blocks) {
+      auto &pull_count = history.pull_counts[block_index];
+      if (pull_count == 0U) {
+        // the area can not hold more than slot_num blocks of a prefix anyway
+        if (history.blocks.size() >= options_.slot_num) {
+          (void)history.pull_counts.erase(block_index);
+          continue;
+        }
+        history.blocks.emplace_back(block_index);
+      }
+      ++pull_count;
+      // a block pulled again and again by the prefix is likely pulled by its next turn too
+      const auto resident = resident_.find(ToBlockKey(cache_key, block_index));
+      if (resident != resident_.cend()) {
+        Touch(resident->second);
+      } else if (pull_count >= options_.min_repeat) {
+        candidates.emplace_back(block_index);
+      }
+    }
+    Schedule(cache_key, candidates, pull);
+  }
+  Submit(std::move(pull));
+}
+
+void KvPrefetcher::Touch(uint64_t slot) {
+  auto &entry = slots_[slot];
+  if (entry.in_lru) {
+    lru_.splice(lru_.end(), lru_, entry.lru_iter);
+  }
+}
+
+void KvPrefetcher::Evict(uint64_t slot) {
+  auto &entry = slots_[slot];
+  if (!entry.used) {
+    ++stats_.wasted_blocks;
+    --unused_slots_;
+  }
+  if (entry.in_lru) {
+    lru_.erase(entry.lru_iter);
+  }
+  if (!entry.stale) {
+    (void)resident_.erase(entry.key);
+  }
+  entry = Slot{};
+  free_slots_.emplace_back(slot);
+}
+
+bool KvPrefetcher::AllocateSlot(uint64_t &slot) {
+  if (free_slots_.empty()) {
+    if (lru_.empty()) {
+      return false;
+    }
+    Evict(lru_.front());
+  }
+  slot = free_slots_.back();
+  free_slots_.pop_back();
+  return true;
+}
+
+void KvPrefetcher::Schedule(const CacheKey &cache_key, const std::vector<uint64_t> &candidates, PendingPull &pull) {
+  for (size_t i = 0U; i < candidates.size(); ++i) {
+    const auto key = ToBlockKey(cache_key, candidates[i]);
+    if (resident_.count(key) > 0U) {
+      continue;
+    }
+    uint64_t slot = 0UL;
+    if ((unused_slots_ >= options_.admission_blocks) || !AllocateSlot(slot)) {
+      stats_.dropped_blocks += candidates.size() - i;
+      break;
+    }
+    auto &entry = slots_[slot];
+    entry.key = key;
+    entry.state = SlotState::kInFlight;
+    resident_[key] = slot;
+    ++unused_slots_;
+    pull.remote_blocks.emplace_back(candidates[i]);
+    pull.slots.emplace_back(slot);
+  }
+  if (!pull.slots.empty()) {
+    pull.cache_key = cache_key;
+    ++inflight_pulls_;
+  }
+}
+
+void KvPrefetcher::Submit(PendingPull pull) {
+  if (pull.slots.empty()) {
+    return;
+  }
+  auto run = [this, pull]() { RunPull(pull); };
+  const auto future = (pull_pool_ != nullptr) ? pull_pool_->commit(run) : std::future<void>();
+  if (!future.valid()) {
+    LLMLOGW("failed to commit kv prefetch task, run it in place");
+    run();
+  }
+}
+
+void KvPrefetcher::RunPull(const PendingPull &pull) {
+  const ge::Status ret = pull_func_(pull.cache_key, pull.remote_blocks, pull.slots);
+  if (ret != ge::SUCCESS) {
+    LLMLOGW("kv prefetch failed, ret = %u, remote cluster = %lu, cache_id = %ld, block num = %zu", ret,
+            pull.cache_key.prompt_cluster_id, pull.cache_key.prompt_cache_id, pull.slots.size());
+  }
+  std::lock_guard<std::mutex> lock(mu_);
+  for (const auto slot : pull.slots) {
+    auto &entry = slots_[slot];
+    if (ret == ge::SUCCESS) {
+      ++stats_.prefetched_blocks;
+      entry.state = SlotState::kReady;
+      if (entry.stale) {
+        Evict(slot);
+        continue;
+      }
+      entry.lru_iter = lru_.insert(lru_.end(), slot);
+      entry.in_lru = true;
+    } else {
+      if (!entry.stale) {
+        (void)resident_.erase(entry.key);
+      }
+      entry = Slot{};
+      free_slots_.emplace_back(slot);
+      --unused_slots_;
+      ++stats_.failed_blocks;
+    }
+  }
+  --inflight_pulls_;
+  cv_.notify_all();
+}
+}  // namespace llm
@@ -0,0 +1,157 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_KV_PREFETCHER_H_
+#define CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_KV_PREFETCHER_H_
+
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "common/llm_inner_types.h"
+#include "common/llm_thread_pool.h"
+
+namespace llm {
+struct KvPrefetchOptions {
+  uint64_t slot_num = 0UL;          // blocks the prefetch area holds
+  uint64_t admission_blocks = 0UL;  // prefetched blocks allowed to wait unused in the area, 0 means slot_num
+  uint32_t lookahead_blocks = 16U;  // blocks that followed a prefix before, issued as its request starts
+  uint32_t min_repeat = 2U;         // pulls of a block before it is kept for the next turn
+  uint32_t max_prefixes = 1024U;    // prefixes whose pull history is kept
+};
+
+struct KvPrefetchStats {
+  uint64_t requested_blocks = 0UL;
+  uint64_t hit_blocks = 0UL;         // served from the prefetch area
+  uint64_t prefetched_blocks = 0UL;  // pulled into the prefetch area
+  uint64_t wasted_blocks = 0UL;      // prefetched but evicted before any request used them
+  uint64_t unused_blocks = 0UL;      // prefetched and not used yet
+  uint64_t dropped_blocks = 0UL;     // predicted but refused by the admission budget or a full area
+  uint64_t failed_blocks = 0UL;
+  uint64_t invalidated_blocks = 0UL;  // dropped as their prompt cache moved to another generation
+};
+
+struct KvPrefetchHit {
+  size_t index;   // position in the remote blocks of the request
+  uint64_t slot;  // block index in the prefetch area
+};
+
+// pulls remote blocks of the cache named by cache_key into blocks of the prefetch area
+using KvPrefetchPullFunc = std::function<ge::Status(const CacheKey &cache_key,
+                                                    const std::vector<uint64_t> &remote_blocks,
+                                                    const std::vector<uint64_t> &slots)>;
+
+// Records which remote blocks are pulled for each prefix, a prefix being the first remote block of a request to
+// one prompt cache. Blocks a prefix keeps pulling again, and blocks that followed it before, are pulled ahead of
+// time into a bounded area of local blocks, requests take them from there instead of the remote side.
+// A block is identified by its prompt cache, the prompt_cache_generation of the cache key and its index. Requests
+// without a generation are never served from the area, a new generation of a prompt cache drops its blocks and
+// history.
+class KvPrefetcher {
+ public:
+  static constexpr uint64_t kNoGeneration = UINT64_MAX;
+
+  KvPrefetcher(KvPrefetchOptions options, KvPrefetchPullFunc pull_func);
+  ~KvPrefetcher();
+  KvPrefetcher(const KvPrefetcher &) = delete;
+  KvPrefetcher &operator=(const KvPrefetcher &) = delete;
+
+  ge::Status Initialize();
+  // waits for prefetch in flight
+  void Finalize();
+  // called as a request starts, before anything pull_func locks is taken. returns the blocks resident in the area,
+  // waiting for those still in flight, and issues prefetch of the blocks the prefix was followed by before.
+  // hits are pinned until Release
+  void Acquire(const CacheKey &cache_key, const std::vector<uint64_t> &remote_blocks,
+               std::vector<KvPrefetchHit> &hits);
+  void Release(const std::vector<KvPrefetchHit> &hits);
+  // called once the request finished, remote_blocks are all blocks of the request
+  void Record(const CacheKey &cache_key, const std::vector<uint64_t> &remote_blocks);
+  void WaitIdle();
+  KvPrefetchStats GetStats();
+  const KvPrefetchOptions &GetOptions() const {
+    return options_;
+  }
+
+ private:
+  enum class SlotState : uint32_t { kFree = 0U, kInFlight = 1U, kReady = 2U };
+  struct BlockKey {
+    uint64_t cluster_id;
+    int64_t cache_id;
+    uint64_t generation;
+    uint64_t block_index;
+    bool operator<(const BlockKey &other) const {
+      if (cluster_id != other.cluster_id) {
+        return cluster_id < other.cluster_id;
+      }
+      if (cache_id != other.cache_id) {
+        return cache_id < other.cache_id;
+      }
+      if (generation != other.generation) {
+        return generation < other.generation;
+      }
+      return block_index < other.block_index;
+    }
+  };
+  struct Slot {
+    BlockKey key{};
+    SlotState state = SlotState::kFree;
+    bool used = false;
+    bool stale = false;  // of an old generation, freed once its pull finished and nothing pins it
+    uint32_t pins = 0U;  // pinned while copied out, never evicted then
+    bool in_lru = false;
+    std::list<uint64_t>::iterator lru_iter;
+  };
+  struct PendingPull {
+    CacheKey cache_key{};
+    std::vector<uint64_t> remote_blocks;
+    std::vector<uint64_t> slots;
+  };
+  struct PrefixHistory {
+    std::vector<uint64_t> blocks;  // in the order they were first pulled
+    std::map<uint64_t, uint32_t> pull_counts;
+    std::list<BlockKey>::iterator lru_iter;
+  };
+
+  static BlockKey ToBlockKey(const CacheKey &cache_key, uint64_t block_index);
+  // drops blocks and history of the prompt cache left from other generations, needs mu_
+  void UpdateGeneration(const CacheKey &cache_key);
+  bool AllocateSlot(uint64_t &slot);
+  void Evict(uint64_t slot);
+  void Touch(uint64_t slot);
+  // reserves slots for the candidates the admission budget lets in, needs mu_
+  void Schedule(const CacheKey &cache_key, const std::vector<uint64_t> &candidates, PendingPull &pull);
+  // issues the pull without holding mu_
+  void Submit(PendingPull pull);
+  void RunPull(const PendingPull &pull);
+
+  KvPrefetchOptions options_;
+  KvPrefetchPullFunc pull_func_;
+  std::unique_ptr<LLMThreadPool> pull_pool_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  uint32_t inflight_pulls_ = 0U;
+  uint64_t unused_slots_ = 0UL;  // in flight or ready, not used by any request yet
+  std::vector<Slot> slots_;
+  std::vector<uint64_t> free_slots_;
+  std::map<BlockKey, uint64_t> resident_;
+  std::map<std::pair<uint64_t, int64_t>, uint64_t> generations_;  // latest generation of each prompt cache
+  std::list<uint64_t> lru_;  // front is the least recently used, holds ready slots that are not pinned
+  std::map<BlockKey, PrefixHistory> history_;
+  std::list<BlockKey> history_lru_;
+  KvPrefetchStats stats_;
+};
+}  // namespace llm
+
+#endif  // CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_KV_PREFETCHER_H_
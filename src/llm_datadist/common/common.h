@@ -18,6 +18,9 @@
 namespace llm {
 constexpr const char LLM_OPTION_MEM_POOL_CONFIG[] = "llm.MemPoolConfig";
 constexpr const char LLM_OPTION_HOST_MEM_POOL_CONFIG[] = "llm.HostMemPoolConfig";
+constexpr const char LLM_OPTION_DISK_TIER_CONFIG[] = "llm.DiskTierConfig";
+constexpr const char LLM_OPTION_KV_PREFETCH_CONFIG[] = "llm.KvPrefetchConfig";
+constexpr const char LLM_OPTION_FSM_SCHEDULER_CONFIG[] = "llm.FsmSchedulerConfig";
 
 enum class FsmState : int32_t {
   FSM_INIT_STATE = 0,
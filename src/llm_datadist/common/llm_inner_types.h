@@ -57,6 +57,8 @@ struct CacheKey {
   uint64_t prefix_id = UINT64_MAX;
   uint64_t model_id;
   bool is_allocate_blocks = false;
+  // changes whenever the prompt side rewrites blocks of prompt_cache_id, UINT64_MAX if unknown
+  uint64_t prompt_cache_generation = UINT64_MAX;
 };
 
 enum class CachePlacement : uint32_t { HOST = 0U, DEVICE = 1U };
@@ -0,0 +1,93 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "rank_table_cache.h"
+#include <algorithm>
+#include "common/llm_checker.h"
+#include "common/llm_log.h"
+
+namespace llm {
+ge::Status RankTableCache::Get(int32_t local_device_id, const std::string &local_comm_res,
+                               const std::string &peer_comm_res, CachedRankTable &rank_table) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if ((local_device_id != device_id_) || (local_comm_res != local_comm_res_)) {
+    ResetLocal(local_device_id, local_comm_res);
+  }
+  const auto it = peer_to_entry_.find(peer_comm_res);
+  if (it != peer_to_entry_.end()) {
+    entries_.splice(entries_.begin(), entries_, it->second);
+    rank_table = it->second->second;
+    ++hit_num_;
+    LLMLOGI("Rank table cache hit, size:%zu, local rank id:%d, peer rank id:%d", rank_table.rank_table.size(),
+            rank_table.local_rank_id, rank_table.peer_rank_id);
+    return ge::SUCCESS;
+  }
+  ++miss_num_;
+  CachedRankTable generated{};
+  LLM_CHK_STATUS_RET(Generate(peer_comm_res, generated), "Failed to generate rank table");
+  entries_.emplace_front(peer_comm_res, generated);
+  peer_to_entry_[peer_comm_res] = entries_.begin();
+  if (entries_.size() > capacity_) {
+    (void) peer_to_entry_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  rank_table = std::move(generated);
+  return ge::SUCCESS;
+}
+
+ge::Status RankTableCache::Generate(const std::string &peer_comm_res, CachedRankTable &rank_table) {
+  std::string peer_version;
+  if (local_version_.empty()) {
+    LLM_CHK_STATUS_RET(RankTableGeneratorFactory::GetVersion(local_comm_res_, local_version_),
+                      "Failed to get version of local comm res");
+  }
+  LLM_CHK_STATUS_RET(RankTableGeneratorFactory::GetVersion(peer_comm_res, peer_version),
+                    "Failed to get version of peer comm res");
+  const auto version = std::min(local_version_, peer_version);
+  auto &generator = generators_[version];
+  if (generator == nullptr) {
+    generator = RankTableGeneratorFactory::CreateByVersion(version, local_comm_res_, peer_comm_res);
+    LLM_CHECK_NOTNULL(generator);
+  } else {
+    generator->ResetPeer(peer_comm_res);
+  }
+  LLM_CHK_STATUS_RET(generator->Generate(device_id_, rank_table.rank_table), "Failed to generate rank table");
+  rank_table.local_rank_id = generator->GetLocalRankId();
+  rank_table.peer_rank_id = generator->GetPeerRankId();
+  return ge::SUCCESS;
+}
+
+void RankTableCache::ResetLocal(int32_t local_device_id, const std::string &local_comm_res) {
+  if (device_id_ >= 0) {
+    LLMLOGI("Local comm res or device changed, drop %zu cached rank tables", entries_.size());
+  }
+  device_id_ = local_device_id;
+  local_comm_res_ = local_comm_res;
+  local_version_.clear();
+  generators_.clear();
+  entries_.clear();
+  peer_to_entry_.clear();
+}
+
+void RankTableCache::Invalidate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ResetLocal(-1, "");
+}
+
+uint64_t RankTableCache::GetHitNum() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hit_num_;
+}
+
+uint64_t RankTableCache::GetMissNum() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return miss_num_;
+}
+}  // namespace llm
@@ -0,0 +1,66 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_RANK_TABLE_CACHE_H_
+#define CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_RANK_TABLE_CACHE_H_
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "common/rank_table_generator.h"
+
+namespace llm {
+struct CachedRankTable {
+  std::string rank_table;
+  int32_t local_rank_id = -1;
+  int32_t peer_rank_id = -1;
+};
+
+// Rank tables generated for the peers of one local comm res, least recently used ones are dropped beyond capacity.
+// Relinking a known peer returns the table built before; a new peer reuses the parsed and checked local side and
+// only parses its own comm res. Another local comm res or device is a topology change and drops everything.
+class RankTableCache {
+ public:
+  explicit RankTableCache(size_t capacity = kDefaultCapacity) : capacity_(std::max(capacity, static_cast<size_t>(1U))) {}
+  ~RankTableCache() = default;
+  RankTableCache(const RankTableCache &) = delete;
+  RankTableCache &operator=(const RankTableCache &) = delete;
+
+  ge::Status Get(int32_t local_device_id, const std::string &local_comm_res, const std::string &peer_comm_res,
+                 CachedRankTable &rank_table);
+  void Invalidate();
+  uint64_t GetHitNum() const;
+  uint64_t GetMissNum() const;
+
+ private:
+  static constexpr size_t kDefaultCapacity = 1024U;
+  using EntryList = std::list<std::pair<std::string, CachedRankTable>>;
+
+  void ResetLocal(int32_t local_device_id, const std::string &local_comm_res);
+  ge::Status Generate(const std::string &peer_comm_res, CachedRankTable &rank_table);
+
+  mutable std::mutex mutex_;
+  size_t capacity_;
+  int32_t device_id_ = -1;
+  std::string local_comm_res_;
+  std::string local_version_;
+  // one generator per rank table version, each keeps the parsed local side
+  std::map<std::string, std::unique_ptr<RankTableGenerator>> generators_;
+  EntryList entries_;  // most recently used first
+  std::unordered_map<std::string, EntryList::iterator> peer_to_entry_;
+  uint64_t hit_num_ = 0UL;
+  uint64_t miss_num_ = 0UL;
+};
+}  // namespace llm
+#endif  // CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_RANK_TABLE_CACHE_H_
@@ -33,35 +33,38 @@ constexpr uint32_t kBufferMaxSize = 128U;
 
 std::unique_ptr<RankTableGenerator> RankTableGeneratorFactory::Create(const std::string &local_comm_res,
                                                                       const std::string &peer_comm_res) {
-  nlohmann::json local_res;
-  nlohmann::json peer_res;
   std::string local_version;
   std::string peer_version;
-  try {
-    local_res = nlohmann::json::parse(local_comm_res);
-    peer_res = nlohmann::json::parse(peer_comm_res);
-    LLMUtils::AssignRequired(local_version, kConfigVersion, local_res);
-    LLMUtils::AssignRequired(peer_version, kConfigVersion, peer_res);
-  } catch (const nlohmann::json::exception &e) {
-    LLMLOGE(ge::LLM_PARAM_INVALID, "Invalid json, exception:%s", e.what());
-    return nullptr;
-  }
-
-  if ((local_version != kConfigVersionV1 && local_version != kConfigVersionV2) ||
-      (peer_version != kConfigVersionV1 && peer_version != kConfigVersionV2)) {
-    LLMLOGE(ge::LLM_PARAM_INVALID, "version in option:%s only support %s and %s, local version:%s, peer version:%s.",
-           llm_datadist::OPTION_LOCAL_COMM_RES, kConfigVersionV1, kConfigVersionV2,
-           local_version.c_str(), peer_version.c_str());
+  if ((GetVersion(local_comm_res, local_version) != ge::SUCCESS) ||
+      (GetVersion(peer_comm_res, peer_version) != ge::SUCCESS)) {
     return nullptr;
   }
+  return CreateByVersion(std::min(local_version, peer_version), local_comm_res, peer_comm_res);
+}
 
-  auto version = std::min(local_version, peer_version);
+std::unique_ptr<RankTableGenerator> RankTableGeneratorFactory::CreateByVersion(const std::string &version,
+                                                                               const std::string &local_comm_res,
+                                                                               const std::string &peer_comm_res) {
   if (version == kConfigVersionV1) {
     return MakeUnique<RankTableGeneratorV1>(local_comm_res, peer_comm_res);
   }
   return MakeUnique<RankTableGeneratorV2>(local_comm_res, peer_comm_res);
 }
 
+ge::Status RankTableGeneratorFactory::GetVersion(const std::string &comm_res, std::string &version) {
+  try {
+    const auto res = nlohmann::json::parse(comm_res);
+    LLMUtils::AssignRequired(version, kConfigVersion, res);
+  } catch (const nlohmann::json::exception &e) {
+    LLMLOGE(ge::LLM_PARAM_INVALID, "Invalid json, exception:%s", e.what());
+    return ge::LLM_PARAM_INVALID;
+  }
+  LLM_CHK_BOOL_RET_STATUS((version == kConfigVersionV1) || (version == kConfigVersionV2), ge::LLM_PARAM_INVALID,
+                         "version in option:%s only support %s and %s, version:%s.",
+                         llm_datadist::OPTION_LOCAL_COMM_RES, kConfigVersionV1, kConfigVersionV2, version.c_str());
+  return ge::SUCCESS;
+}
+
 ge::Status LocalCommResGenerator::Generate(const std::string &server_id,
                                            int32_t device_id,
                                            std::string &local_comm_res) {
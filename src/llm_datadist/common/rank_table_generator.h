@@ -22,6 +22,8 @@ class RankTableGenerator {
   RankTableGenerator() = default;
   virtual ~RankTableGenerator() = default;
   virtual ge::Status Generate(int32_t local_device_id, std::string &rank_table) = 0;
+  // points the generator at another peer, the next Generate reuses the parsed local comm res
+  virtual void ResetPeer(const std::string &peer_comm_res) = 0;
   virtual int32_t GetLocalRankId() = 0;
   virtual int32_t GetPeerRankId() = 0;
 };
@@ -41,6 +43,11 @@ class LocalCommResGenerator {
 class RankTableGeneratorFactory {
  public:
   static std::unique_ptr<RankTableGenerator> Create(const std::string &local_comm_res, const std::string &peer_comm_res);
+  // version is the lower one of the two comm res
+  static std::unique_ptr<RankTableGenerator> CreateByVersion(const std::string &version,
+                                                             const std::string &local_comm_res,
+                                                             const std::string &peer_comm_res);
+  static ge::Status GetVersion(const std::string &comm_res, std::string &version);
 };
 }  // namespace llm
 #endif  // CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_RANK_TABLE_GENERATOR_H_
@@ -67,22 +67,28 @@ rank_table_v1::RankTableInfo RankTableGeneratorV1::LoadFromJsonStr(const std::st
   return j.get<rank_table_v1::RankTableInfo>();
 }
 
-ge::Status RankTableGeneratorV1::MergeRankTable(int32_t local_device_id,
-                                                const rank_table_v1::RankTableInfo &local_rank_table,
-                                                const rank_table_v1::RankTableInfo &peer_rank_table,
-                                                rank_table_v1::RankTableInfo &merged_rank_table) {
-  std::map<std::string, std::set<rank_table_v1::DeviceInfo>> merged_info;
+ge::Status RankTableGeneratorV1::CheckLocalRankTable(int32_t local_device_id,
+                                                     const rank_table_v1::RankTableInfo &local_rank_table) {
+  int32_t phy_device_id = 0U;
   for (const auto &server : local_rank_table.server_list) {
     LLM_CHK_BOOL_RET_STATUS(server.device_list.size() == 1U, ge::LLM_PARAM_INVALID,
                            "Please check local option:%s, it only supports one device that is used.",
                            llm_datadist::OPTION_LOCAL_COMM_RES);
-    int32_t phy_device_id = 0U;
     LLM_CHK_RT_RET(aclrtGetPhyDevIdByLogicDevId(local_device_id, &phy_device_id));
     LLM_CHK_BOOL_RET_STATUS(std::to_string(phy_device_id) == server.device_list[0].device_id,
                            ge::LLM_PARAM_INVALID,
                            "Please check local option:%s, device_id:%s should be %u, logic device id:%d.",
                            llm_datadist::OPTION_LOCAL_COMM_RES, server.device_list[0].device_id.c_str(),
                            phy_device_id, local_device_id);
+  }
+  return ge::SUCCESS;
+}
+
+ge::Status RankTableGeneratorV1::MergeRankTable(const rank_table_v1::RankTableInfo &local_rank_table,
+                                                const rank_table_v1::RankTableInfo &peer_rank_table,
+                                                rank_table_v1::RankTableInfo &merged_rank_table) {
+  std::map<std::string, std::set<rank_table_v1::DeviceInfo>> merged_info;
+  for (const auto &server : local_rank_table.server_list) {
     merged_info[server.server_id].emplace(server.device_list[0]);
   }
   for (const auto &server : peer_rank_table.server_list) {
@@ -119,13 +125,22 @@ ge::Status RankTableGeneratorV1::Generate(int32_t local_device_id, std::string &
   LLMLOGI("Rank table generate begin, local comm res:%s, peer comm res:%s",
          local_comm_res_.c_str(), peer_comm_res_.c_str());
   try {
-    local_rank_table = RankTableGeneratorV1::LoadFromJsonStr(local_comm_res_);
+    // the local side is parsed and checked once, later peers only parse their own comm res
+    if (loaded_device_id_ != local_device_id) {
+      local_rank_table = RankTableGeneratorV1::LoadFromJsonStr(local_comm_res_);
+    }
     peer_rank_table = RankTableGeneratorV1::LoadFromJsonStr(peer_comm_res_);
   } catch (const nlohmann::json::exception &e) {
     LLMLOGE(ge::LLM_PARAM_INVALID, "Failed to load rank table, exception:%s", e.what());
     return ge::LLM_PARAM_INVALID;
   }
-  LLM_CHK_STATUS_RET(MergeRankTable(local_device_id, local_rank_table, peer_rank_table, merged_rank_table_),
+  if (loaded_device_id_ != local_device_id) {
+    LLM_CHK_STATUS_RET(CheckLocalRankTable(local_device_id, local_rank_table), "Failed to check local rank table");
+    local_rank_table_ = std::move(local_rank_table);
+    loaded_device_id_ = local_device_id;
+  }
+  merged_rank_table_ = rank_table_v1::RankTableInfo{};
+  LLM_CHK_STATUS_RET(MergeRankTable(local_rank_table_, peer_rank_table, merged_rank_table_),
                     "Failed to merge rank table");
   try {
     nlohmann::json j = merged_rank_table_;
@@ -134,10 +149,15 @@ ge::Status RankTableGeneratorV1::Generate(int32_t local_device_id, std::string &
     LLMLOGE(ge::LLM_PARAM_INVALID, "Failed to dump rank table, exception:%s", e.what());
     return ge::LLM_PARAM_INVALID;
   }
-  LLMLOGI("Rank table generated successfully, rank table:%s", rank_table.c_str());
+  LLMLOGI("Rank table generated successfully, size:%zu", rank_table.size());
+  LLMLOGD("rank table:%s", rank_table.c_str());
   return ge::SUCCESS;
 }
 
+void RankTableGeneratorV1::ResetPeer(const std::string &peer_comm_res) {
+  peer_comm_res_ = peer_comm_res;
+}
+
 int32_t RankTableGeneratorV1::GetLocalRankId() {
   for (const auto &server : merged_rank_table_.server_list) {
     for (const auto &device : server.device_list) {
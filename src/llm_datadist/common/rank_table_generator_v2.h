@@ -66,6 +66,7 @@ class RankTableGeneratorV2 : public RankTableGenerator {
       : local_comm_res_(local_comm_res), peer_comm_res_(peer_comm_res), merged_rank_table_{} {};
   ~RankTableGeneratorV2() override = default;
   ge::Status Generate(int32_t local_device_id, std::string &rank_table) override;
+  void ResetPeer(const std::string &peer_comm_res) override;
   int32_t GetLocalRankId() override;
   int32_t GetPeerRankId() override;
   static ge::Status GenerateLocalCommRes(const std::string &server_id,
@@ -74,13 +75,16 @@ class RankTableGeneratorV2 : public RankTableGenerator {
 
  private:
   static rank_table_v2::RankTableInfo LoadFromJsonStr(const std::string &rank_table);
-  static ge::Status MergeRankTable(int32_t local_device_id,
-                                   const rank_table_v2::RankTableInfo &local_rank_table,
+  static ge::Status CheckLocalRankTable(int32_t local_device_id,
+                                        const rank_table_v2::RankTableInfo &local_rank_table);
+  static ge::Status MergeRankTable(const rank_table_v2::RankTableInfo &local_rank_table,
                                    const rank_table_v2::RankTableInfo &peer_rank_table,
                                    rank_table_v2::RankTableInfo &merged_rank_table);
 
   std::string local_comm_res_;
   std::string peer_comm_res_;
+  rank_table_v2::RankTableInfo local_rank_table_;
+  int32_t loaded_device_id_ = -1;  // device the parsed local rank table was checked against
   rank_table_v2::RankTableInfo merged_rank_table_;
 };
 }  // namespace llm
@@ -9,6 +9,7 @@
  */
 
 #include "data_transfer/d2d_data_transfer_job.h"
+#include <algorithm>
 #include "utils/extern_math_util.h"
 #include "llm_datadist/llm_error_codes.h"
 #include "common/def_types.h"
@@ -137,12 +138,23 @@ ge::Status D2DDataTransferJob::GenerateSendTask(const CacheEntry &cache_entry, c
 ge::Status D2DDataTransferJob::PullCache() {
   const auto start = std::chrono::steady_clock::now();
   const auto stream = comm_entity_->GetStream();
+  BufferedSenderOptions sender_options;
+  sender_options.merge_contiguous = true;
   BufferedSender buffered_sender;
-  buffered_sender.Initialize(*comm_entity_, stream, false);
+  buffered_sender.Initialize(*comm_entity_, stream, false, sender_options);
+  // tasks are generated tensor by tensor, buffer_info_count of them each, and every tensor is a registration
+  // of its own on both sides, so blocks are only merged inside one tensor
+  const size_t tensor_task_num = std::max(static_cast<size_t>(comm_entity_->GetRequest().buffer_info_count),
+                                         static_cast<size_t>(1U));
   LLMLOGI("task num = %zu", send_tasks_.size());
+  size_t task_index = 0UL;
   while (!send_tasks_.empty()) {
     auto op_desc = send_tasks_.front();
     send_tasks_.pop_front();
+    if ((task_index > 0UL) && (task_index % tensor_task_num == 0UL)) {
+      buffered_sender.EndRegion();
+    }
+    ++task_index;
     // local, remote is reversed in get mode
     LLM_CHK_STATUS_RET(buffered_sender.Put(op_desc.remoteAddr, op_desc.localAddr, op_desc.count));
   }
@@ -154,7 +166,9 @@ ge::Status D2DDataTransferJob::PullCache() {
   const auto end = std::chrono::steady_clock::now();
   const auto cost = static_cast<uint64_t>(
       std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
-  LLMLOGI("sync stream success, cost = %ld us.", cost);
+  const auto &sender_statistic = buffered_sender.GetStatistic();
+  LLMLOGI("sync stream success, cost = %ld us, put_num = %lu, merged_num = %lu, batch_num = %lu.", cost,
+          sender_statistic.put_num, sender_statistic.merged_num, sender_statistic.flush_num);
   auto &recv_statistic_info = comm_entity_->GetRecvStatisticInfo();
   StatisticManager::UpdateCost(cost, recv_statistic_info.pull_times, recv_statistic_info.pull_min_cost,
                                recv_statistic_info.pull_max_cost, recv_statistic_info.pull_total_cost);
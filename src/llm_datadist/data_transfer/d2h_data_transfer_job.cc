@@ -33,7 +33,9 @@ D2HDataTransferJob::~D2HDataTransferJob() {
 
 ge::Status D2HDataTransferJob::Initialize(const CacheEntry &cache_entry, CommEntity &comm_entity, uint64_t offset) {
   stream_ = comm_entity.GetStream();
-  buffered_sender_.Initialize(comm_entity);
+  BufferedSenderOptions sender_options;
+  sender_options.merge_contiguous = true;
+  buffered_sender_.Initialize(comm_entity, nullptr, true, sender_options);
   const auto &req = comm_entity.GetRequest();
   auto resp_len = sizeof(ResponseInfo) + req.dst_addr_count * sizeof(uint64_t);
   auto *local_recv_flag_addr_base = PtrToPtr<void, uint8_t>(comm_entity.GetEntityInfo().local_resp_ptr) + resp_len;
@@ -98,6 +100,11 @@ ge::Status D2HDataTransferJob::Process(bool &is_done) {
       LLMLOGI("Buffer[%u] wait sync flag success", task.buffer_index);
     } else if (task.task_type == kTaskTypeTransferBlock) {
       auto buffer_index = task.buffer_index;
+      // one buffer gathers blocks of several tensors, each tensor is a registration of its own
+      if ((task_index > 0U) && (tasks_[task_index - 1U].task_type == kTaskTypeTransferBlock) &&
+          (tasks_[task_index - 1U].block_span.tensor_index != task.block_span.tensor_index)) {
+        buffered_sender_.EndRegion();
+      }
       auto src_addr = data_addresses_[task.block_span.tensor_index] + task.block_span.tensor_offset;
       auto dst_addr =
           dst_buffers_[buffer_index] + task.block_span.buffer_block_start * block_size_;
@@ -132,7 +139,9 @@ ge::Status D2HDataTransferJob::Process(bool &is_done) {
     return ge::SUCCESS;
   }
   // all task done
-  LLMLOGI("pull cache done");
+  const auto &sender_statistic = buffered_sender_.GetStatistic();
+  LLMLOGI("pull cache done, put_num = %lu, merged_num = %lu, batch_num = %lu", sender_statistic.put_num,
+          sender_statistic.merged_num, sender_statistic.flush_num);
   is_done = true;
   return ge::SUCCESS;
 }
@@ -384,6 +393,7 @@ std::vector<TransferBlocksTask> DataTransferTaskGenerator::GenerateTasks(uint32_
 
 D2HDataTransferClient::D2HDataTransferClient(CommEntity &comm_entity, aclrtStream stream)
     : comm_entity_(&comm_entity), stream_(stream) {
+  // only puts single flags, each flushed at once, so there is nothing to merge
   buffered_sender_.Initialize(comm_entity, stream);
 }
 
@@ -20,10 +20,70 @@ constexpr uint32_t kMaxTaskNum = 1024U;
 constexpr uint64_t kMaxBatchPutNum = 64U;
 constexpr uint64_t kBlocksCacheKey = 1UL;
 constexpr uint64_t kCacheKeyByIdType = 2UL;
+constexpr uint64_t kBitsPerWord = 64UL;
+
+// tasks left in flight after the last submission of a layer, earlier submissions are synchronized by SubmitLayerGroup
+size_t GetInflightTaskNum(size_t task_num) {
+  return (task_num == 0U) ? 0U : ((task_num - 1U) % kMaxTaskNum) + 1U;
+}
 }  // namespace
+LayerTransferProgress::LayerTransferProgress(uint64_t layer_num)
+    : layer_num_(layer_num), ready_bitmap_((layer_num + kBitsPerWord - 1UL) / kBitsPerWord) {}
+
+void LayerTransferProgress::MarkLayerReady(uint64_t layer_offset) {
+  ready_bitmap_[layer_offset / kBitsPerWord].fetch_or(1UL << (layer_offset % kBitsPerWord),
+                                                      std::memory_order_release);
+  ready_layer_num_.fetch_add(1U, std::memory_order_release);
+}
+
+bool LayerTransferProgress::IsLayerReady(uint64_t layer_offset) const {
+  if (layer_offset >= layer_num_) {
+    return false;
+  }
+  const uint64_t word = ready_bitmap_[layer_offset / kBitsPerWord].load(std::memory_order_acquire);
+  return (word & (1UL << (layer_offset % kBitsPerWord))) != 0U;
+}
+
+uint64_t LayerTransferProgress::GetReadyLayerNum() const {
+  return ready_layer_num_.load(std::memory_order_acquire);
+}
+
+void LayerTransferProgress::Finish(ge::Status status) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    finished_ = true;
+    status_ = status;
+  }
+  cv_.notify_all();
+}
+
+bool LayerTransferProgress::IsFinished() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return finished_;
+}
+
+ge::Status LayerTransferProgress::Wait() {
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this]() { return finished_; });
+  return status_;
+}
+
 LayerWiseTransferJob::LayerWiseTransferJob(CommEntity &comm_entity, aclrtStream stream)
     : stream_(stream), comm_entity_(&comm_entity) {}
 
+LayerWiseTransferJob::~LayerWiseTransferJob() {
+  DestroyLayerEvents();
+}
+
+void LayerWiseTransferJob::DestroyLayerEvents() {
+  for (auto &group : layer_groups_) {
+    if (group.event != nullptr) {
+      LLM_CHK_ACL(aclrtDestroyEvent(group.event));
+      group.event = nullptr;
+    }
+  }
+}
+
 ge::Status LayerWiseTransferJob::GenerateCacheToCacheTask(const CacheEntry &cache_entry,
                                                           const std::vector<std::shared_ptr<void>> &src_layer_addrs,
                                                           const TransferCacheConfig &transfer_cache_config) {
@@ -253,6 +313,149 @@ ge::Status LayerWiseTransferJob::ValidateRemoteCache(const CacheEntry &remote_ca
   return ge::SUCCESS;
 }
 
+ge::Status LayerWiseTransferJob::PrepareLayerGroups(const CacheEntry &cache_entry,
+                                                    const TransferCacheConfig &transfer_cache_config,
+                                                    const TransferBlockConfig &transfer_block_config,
+                                                    uint64_t layer_num,
+                                                    int32_t timeout_in_ms,
+                                                    bool access_remote_cache) {
+  const uint64_t tensor_num_per_layer = transfer_cache_config.tensor_num_per_layer;
+  if (!access_remote_cache) {
+    LLM_CHK_BOOL_RET_STATUS(transfer_cache_config.dst_addrs.size() == layer_num * tensor_num_per_layer,
+                           ge::LLM_PARAM_INVALID, "dst_addrs size[%zu] is not match layer_num[%lu] * tensor_num[%lu]",
+                           transfer_cache_config.dst_addrs.size(), layer_num, tensor_num_per_layer);
+  }
+  layer_groups_.clear();
+  layer_groups_.reserve(layer_num);
+  TransferCacheConfig layer_config = transfer_cache_config;
+  for (uint64_t i = 0UL; i < layer_num; ++i) {
+    layer_config.layer_index = transfer_cache_config.layer_index + i;
+    layer_config.dst_layer_index = transfer_cache_config.dst_layer_index + i;
+    layer_config.dst_addrs.clear();
+    if (access_remote_cache) {
+      LLM_CHK_STATUS_RET(FillRemoteLayerAddrs(timeout_in_ms, layer_config, transfer_block_config),
+                        "Fill remote addrs of layer[%lu] failed.", layer_config.dst_layer_index);
+    } else {
+      const auto begin = transfer_cache_config.dst_addrs.cbegin() + i * tensor_num_per_layer;
+      layer_config.dst_addrs.assign(begin, begin + tensor_num_per_layer);
+    }
+    LLM_CHK_STATUS_RET(Prepare(cache_entry, layer_config, transfer_block_config),
+                      "prepare transfer task of layer[%lu] failed", layer_config.layer_index);
+    LayerTransferGroup group;
+    group.layer_index = layer_config.layer_index;
+    group.task_num = layer_transfer_tasks_.size();
+    group.tasks.swap(layer_transfer_tasks_);
+    layer_groups_.emplace_back(std::move(group));
+  }
+  return ge::SUCCESS;
+}
+
+ge::Status LayerWiseTransferJob::WaitEvent(aclrtEvent event, const std::chrono::steady_clock::time_point &start,
+                                           int32_t timeout_in_ms) const {
+  aclrtEventRecordedStatus status = ACL_EVENT_RECORDED_STATUS_NOT_READY;
+  while (status != ACL_EVENT_RECORDED_STATUS_COMPLETE) {
+    if (std::chrono::steady_clock::now() > start + std::chrono::milliseconds(timeout_in_ms)) {
+      LLMLOGE(ge::LLM_TIMEOUT, "stream handle transfer request timeout");
+      return ge::LLM_TIMEOUT;
+    }
+    LLM_CHK_STATUS_RET(DataTransferUtils::QueryEventStatus(event, status), "comm_entity:%s query event status failed",
+                      comm_entity_->GetDesc().c_str());
+  }
+  return ge::SUCCESS;
+}
+
+ge::Status LayerWiseTransferJob::SubmitLayerGroup(LayerTransferGroup &group,
+                                                  const std::chrono::steady_clock::time_point &start,
+                                                  int32_t timeout_in_ms) {
+  while (!group.tasks.empty()) {
+    LLM_CHK_STATUS_RET(DataTransferUtils::SendCache(stream_, *comm_entity_, group.tasks, group.event),
+                      "comm_entity:%s send cache of layer[%lu] failed", comm_entity_->GetDesc().c_str(),
+                      group.layer_index);
+    if (!group.tasks.empty()) {
+      // layer is larger than one submission, keep the same in flight limit as SynchronizeTransferCacheWithRecord
+      LLM_CHK_STATUS_RET(WaitEvent(group.event, start, timeout_in_ms), "wait layer[%lu] failed", group.layer_index);
+      LLM_ASSERT_RT_OK(aclrtDestroyEvent(group.event));
+      group.event = nullptr;
+    }
+  }
+  if (group.event == nullptr) {
+    // no task in layer, still record an event to keep layers completed in order
+    LLM_CHK_ACL_RET(aclrtCreateEvent(&group.event));
+    LLM_ASSERT_RT_OK(aclrtRecordEvent(group.event, stream_));
+  }
+  LLMLOGI("comm_entity:%s layer[%lu] submitted, task num:%zu", comm_entity_->GetDesc().c_str(), group.layer_index,
+         group.task_num);
+  return ge::SUCCESS;
+}
+
+ge::Status LayerWiseTransferJob::WaitLayerGroup(size_t group_index,
+                                                const std::chrono::steady_clock::time_point &start,
+                                                int32_t timeout_in_ms, LayerTransferProgress &progress,
+                                                const LayerReadyCallback &callback) {
+  auto &group = layer_groups_[group_index];
+  LLM_CHK_STATUS_RET(WaitEvent(group.event, start, timeout_in_ms), "wait layer[%lu] failed", group.layer_index);
+  LLM_ASSERT_RT_OK(aclrtDestroyEvent(group.event));
+  group.event = nullptr;
+  progress.MarkLayerReady(group_index);
+  LLMLOGI("comm_entity:%s layer[%lu] is ready", comm_entity_->GetDesc().c_str(), group.layer_index);
+  if (callback != nullptr) {
+    callback(group.layer_index);
+  }
+  return ge::SUCCESS;
+}
+
+ge::Status LayerWiseTransferJob::TransferCacheByLayers(const CacheEntry &cache_entry,
+                                                       const TransferCacheConfig &transfer_cache_config,
+                                                       const TransferBlockConfig &transfer_block_config,
+                                                       int32_t timeout_in_ms,
+                                                       bool access_remote_cache,
+                                                       LayerTransferProgress &progress,
+                                                       const LayerReadyCallback &callback) {
+  const uint64_t layer_num = progress.GetLayerNum();
+  LLM_CHK_BOOL_RET_STATUS((layer_num > 0U) && (layer_num <= LayerTransferProgress::kMaxLayerNum),
+                         ge::LLM_PARAM_INVALID, "layer num[%lu] is out of range[1, %lu]", layer_num,
+                         LayerTransferProgress::kMaxLayerNum);
+  LLM_DISMISSABLE_GUARD(stream, [this]() -> void {
+    LLM_CHK_ACL(aclrtStreamAbort(comm_entity_->GetStream()));
+  });
+  if (access_remote_cache) {
+    LLM_CHK_BOOL_RET_STATUS(cache_entry.remote_accessible, ge::LLM_PARAM_INVALID,
+                           "local cache is not remote accessible.");
+  }
+  LLM_CHK_STATUS_RET(PrepareLayerGroups(cache_entry, transfer_cache_config, transfer_block_config, layer_num,
+                                       timeout_in_ms, access_remote_cache),
+                    "prepare layer transfer tasks failed");
+
+  const auto start = std::chrono::steady_clock::now();
+  size_t next_wait_index = 0U;
+  size_t inflight_task_num = 0U;
+  for (size_t i = 0U; i < layer_groups_.size(); ++i) {
+    const size_t task_num = GetInflightTaskNum(layer_groups_[i].task_num);
+    // without remote cache access, remote side relies on at most kMaxTaskNum tasks in flight
+    while ((!access_remote_cache) && (next_wait_index < i) && (inflight_task_num + task_num > kMaxTaskNum)) {
+      LLM_CHK_STATUS_RET(WaitLayerGroup(next_wait_index, start, timeout_in_ms, progress, callback));
+      inflight_task_num -= GetInflightTaskNum(layer_groups_[next_wait_index].task_num);
+      ++next_wait_index;
+    }
+    LLM_CHK_STATUS_RET(SubmitLayerGroup(layer_groups_[i], start, timeout_in_ms));
+    inflight_task_num += task_num;
+  }
+  for (; next_wait_index < layer_groups_.size(); ++next_wait_index) {
+    LLM_CHK_STATUS_RET(WaitLayerGroup(next_wait_index, start, timeout_in_ms, progress, callback));
+  }
+  LLM_CHK_ACL_RET(aclrtSynchronizeStreamWithTimeout(stream_, timeout_in_ms));
+
+  const auto finished = std::chrono::steady_clock::now();
+  const auto cost =
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(finished - start).count());
+  auto &send_statistic_info = comm_entity_->GetSendStatisticInfo(stream_);
+  StatisticManager::GetInstance().UpdateCost(cost, send_statistic_info.send_times, send_statistic_info.send_min_cost,
+                                             send_statistic_info.send_max_cost, send_statistic_info.send_total_cost);
+  LLMLOGI("comm_entity:%s send all %lu layers of request finished", comm_entity_->GetDesc().c_str(), layer_num);
+  LLM_DISMISS_GUARD(stream);
+  return ge::SUCCESS;
+}
+
 ge::Status LayerWiseTransferJob::TransferCache(const CacheEntry &cache_entry,
                                                const TransferCacheConfig &transfer_cache_config,
                                                const TransferBlockConfig &transfer_block_config,
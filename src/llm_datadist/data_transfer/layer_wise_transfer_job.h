@@ -11,19 +11,72 @@
 #ifndef CANN_GRAPH_ENGINE_RUNTIME_LLM_ENGINE_DATA_TRANSFER_LAYER_WISE_TRANSFER_JOB_H_
 #define CANN_GRAPH_ENGINE_RUNTIME_LLM_ENGINE_DATA_TRANSFER_LAYER_WISE_TRANSFER_JOB_H_
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
 #include "ge_common/ge_api_types.h"
 #include "link_mgr/comm_entity.h"
 
 namespace llm {
+// invoked on the transferring thread, in layer order, once all tasks of a layer are completed
+using LayerReadyCallback = std::function<void(uint64_t layer_index)>;
+
+// progress of one streaming transfer, shared by the transferring thread and the threads polling it
+class LayerTransferProgress {
+ public:
+  static constexpr uint64_t kMaxLayerNum = 4096UL;
+  explicit LayerTransferProgress(uint64_t layer_num);
+  ~LayerTransferProgress() = default;
+  LayerTransferProgress(const LayerTransferProgress &) = delete;
+  LayerTransferProgress &operator=(const LayerTransferProgress &) = delete;
+
+  // layer_offset is relative to the first layer of the transfer
+  bool IsLayerReady(uint64_t layer_offset) const;
+  uint64_t GetReadyLayerNum() const;
+  uint64_t GetLayerNum() const {
+    return layer_num_;
+  }
+  void MarkLayerReady(uint64_t layer_offset);
+  void Finish(ge::Status status);
+  bool IsFinished() const;
+  // blocks until the transfer finished, returns its result
+  ge::Status Wait();
+
+ private:
+  uint64_t layer_num_;
+  std::vector<std::atomic<uint64_t>> ready_bitmap_;
+  std::atomic<uint64_t> ready_layer_num_{0U};
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  bool finished_ = false;
+  ge::Status status_ = ge::SUCCESS;
+};
+
 class LayerWiseTransferJob {
  public:
   LayerWiseTransferJob(CommEntity &comm_entity, aclrtStream stream);
-  ~LayerWiseTransferJob() = default;
+  ~LayerWiseTransferJob();
   ge::Status TransferCache(const CacheEntry &cache_entry,
                            const TransferCacheConfig &transfer_cache_config,
                            const TransferBlockConfig &transfer_block_config,
                            int32_t timeout_in_ms,
                            bool access_remote_cache);
+  /**
+   * Streaming mode: transfer layers [layer_index, layer_index + progress.GetLayerNum()) of transfer_cache_config,
+   * each layer is submitted as an independent group with its own event, so that
+   * consumers can start on early layers while later layers are still in flight.
+   * When access_remote_cache is false, dst_addrs must hold tensor_num_per_layer addresses per layer.
+   * Completed layers are marked in progress, the caller finishes it with the returned status.
+   */
+  ge::Status TransferCacheByLayers(const CacheEntry &cache_entry,
+                                   const TransferCacheConfig &transfer_cache_config,
+                                   const TransferBlockConfig &transfer_block_config,
+                                   int32_t timeout_in_ms,
+                                   bool access_remote_cache,
+                                   LayerTransferProgress &progress,
+                                   const LayerReadyCallback &callback = nullptr);
 
  private:
   ge::Status Prepare(const CacheEntry &cache_entry,
@@ -49,10 +102,32 @@ class LayerWiseTransferJob {
   ge::Status ValidateRemoteCache(const CacheEntry &remote_cache_entry, const TransferCacheConfig &transfer_cache_config,
                                  const TransferBlockConfig &transfer_block_config) const;
 
+  struct LayerTransferGroup {
+    uint64_t layer_index = 0U;
+    size_t task_num = 0U;
+    std::list<HcclOneSideOpDesc> tasks;
+    aclrtEvent event = nullptr;
+  };
+  ge::Status PrepareLayerGroups(const CacheEntry &cache_entry,
+                                const TransferCacheConfig &transfer_cache_config,
+                                const TransferBlockConfig &transfer_block_config,
+                                uint64_t layer_num,
+                                int32_t timeout_in_ms,
+                                bool access_remote_cache);
+  ge::Status SubmitLayerGroup(LayerTransferGroup &group, const std::chrono::steady_clock::time_point &start,
+                              int32_t timeout_in_ms);
+  ge::Status WaitLayerGroup(size_t group_index, const std::chrono::steady_clock::time_point &start,
+                            int32_t timeout_in_ms, LayerTransferProgress &progress,
+                            const LayerReadyCallback &callback);
+  ge::Status WaitEvent(aclrtEvent event, const std::chrono::steady_clock::time_point &start,
+                       int32_t timeout_in_ms) const;
+  void DestroyLayerEvents();
+
   aclrtStream stream_;
   CommEntity *comm_entity_;
   std::list<HcclOneSideOpDesc> layer_transfer_tasks_;
   aclrtEvent event_{nullptr};
+  std::vector<LayerTransferGroup> layer_groups_;
 };
 }  // namespace llm
 #endif  // CANN_GRAPH_ENGINE_RUNTIME_LLM_ENGINE_DATA_TRANSFER_LAYER_WISE_TRANSFER_JOB_H_
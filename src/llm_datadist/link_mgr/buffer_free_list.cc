@@ -0,0 +1,193 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "buffer_free_list.h"
+#include <algorithm>
+#include <chrono>
+#include "llm_datadist/llm_error_codes.h"
+#include "common/llm_checker.h"
+#include "common/llm_log.h"
+
+namespace llm {
+namespace {
+constexpr uint64_t kIndexMask = 0xFFFFFFFFUL;
+constexpr uint32_t kTagShift = 32U;
+
+uint64_t MakeHead(uint64_t old_head, uint32_t index) {
+  return (((old_head >> kTagShift) + 1UL) << kTagShift) | index;
+}
+}  // namespace
+
+uint64_t BufferFreeList::GetRegionSize(const std::vector<BufferSizeClass> &size_classes) {
+  uint64_t region_size = 0UL;
+  for (const auto &size_class : size_classes) {
+    region_size += size_class.buffer_size * size_class.buffer_num;
+  }
+  return region_size;
+}
+
+ge::Status BufferFreeList::Initialize(void *base, uint64_t region_size, std::vector<BufferSizeClass> size_classes) {
+  LLM_CHECK_NOTNULL(base);
+  LLM_CHK_BOOL_RET_STATUS(!size_classes.empty(), ge::LLM_PARAM_INVALID, "size classes are empty");
+  std::sort(size_classes.begin(), size_classes.end(), [](const BufferSizeClass &lhs, const BufferSizeClass &rhs) {
+    return lhs.buffer_size < rhs.buffer_size;
+  });
+  uint64_t total_num = 0UL;
+  for (size_t i = 0U; i < size_classes.size(); ++i) {
+    LLM_CHK_BOOL_RET_STATUS((size_classes[i].buffer_size > 0UL) && (size_classes[i].buffer_num > 0UL),
+                           ge::LLM_PARAM_INVALID, "invalid size class, buffer size:%lu, buffer num:%lu",
+                           size_classes[i].buffer_size, size_classes[i].buffer_num);
+    LLM_CHK_BOOL_RET_STATUS((i == 0U) || (size_classes[i].buffer_size != size_classes[i - 1U].buffer_size),
+                           ge::LLM_PARAM_INVALID, "duplicated size class, buffer size:%lu",
+                           size_classes[i].buffer_size);
+    total_num += size_classes[i].buffer_num;
+  }
+  LLM_CHK_BOOL_RET_STATUS(total_num < kNilIndex, ge::LLM_PARAM_INVALID, "too many buffers:%lu", total_num);
+  const uint64_t required_size = GetRegionSize(size_classes);
+  LLM_CHK_BOOL_RET_STATUS(required_size <= region_size, ge::LLM_PARAM_INVALID,
+                         "region size:%lu is smaller than required size:%lu", region_size, required_size);
+
+  base_ = static_cast<uint8_t *>(base);
+  region_size_ = region_size;
+  class_num_ = size_classes.size();
+  classes_.reset(new (std::nothrow) SizeClass[class_num_]);
+  next_.reset(new (std::nothrow) std::atomic<uint32_t>[total_num]);
+  in_use_.reset(new (std::nothrow) std::atomic<bool>[total_num]);
+  LLM_CHK_BOOL_RET_STATUS((classes_ != nullptr) && (next_ != nullptr) && (in_use_ != nullptr), ge::LLM_OUT_OF_MEMORY,
+                         "Failed to alloc free list of %lu buffers", total_num);
+  uint64_t offset = 0UL;
+  uint32_t first_index = 0U;
+  for (size_t i = 0U; i < class_num_; ++i) {
+    auto &size_class = classes_[i];
+    size_class.buffer_size = size_classes[i].buffer_size;
+    size_class.offset = offset;
+    size_class.first_index = first_index;
+    size_class.buffer_num = static_cast<uint32_t>(size_classes[i].buffer_num);
+    // lower addresses are handed out first
+    for (uint32_t j = 0U; j < size_class.buffer_num; ++j) {
+      const uint32_t index = first_index + j;
+      next_[index].store((j + 1U < size_class.buffer_num) ? index + 1U : kNilIndex, std::memory_order_relaxed);
+      in_use_[index].store(false, std::memory_order_relaxed);
+    }
+    size_class.head.store(first_index, std::memory_order_release);
+    size_class.free_num.store(size_class.buffer_num, std::memory_order_relaxed);
+    offset += size_class.buffer_size * size_class.buffer_num;
+    first_index += size_class.buffer_num;
+  }
+  return ge::SUCCESS;
+}
+
+bool BufferFreeList::Pop(SizeClass &size_class, uint32_t &index) {
+  uint64_t head = size_class.head.load(std::memory_order_acquire);
+  while (true) {
+    index = static_cast<uint32_t>(head & kIndexMask);
+    if (index == kNilIndex) {
+      return false;
+    }
+    // a stale next is harmless, the tag makes the exchange fail then
+    const uint32_t next = next_[index].load(std::memory_order_relaxed);
+    if (size_class.head.compare_exchange_weak(head, MakeHead(head, next), std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+      (void) size_class.free_num.fetch_sub(1UL, std::memory_order_relaxed);
+      return true;
+    }
+  }
+}
+
+void BufferFreeList::Push(SizeClass &size_class, uint32_t index) {
+  uint64_t head = size_class.head.load(std::memory_order_relaxed);
+  do {
+    next_[index].store(static_cast<uint32_t>(head & kIndexMask), std::memory_order_relaxed);
+  } while (!size_class.head.compare_exchange_weak(head, MakeHead(head, index), std::memory_order_release,
+                                                  std::memory_order_relaxed));
+  (void) size_class.free_num.fetch_add(1UL, std::memory_order_relaxed);
+}
+
+bool BufferFreeList::TryAlloc(uint64_t size, void *&buffer) {
+  for (size_t i = 0U; i < class_num_; ++i) {
+    auto &size_class = classes_[i];
+    uint32_t index = 0U;
+    if ((size_class.buffer_size >= size) && Pop(size_class, index)) {
+      in_use_[index].store(true, std::memory_order_relaxed);
+      buffer = base_ + size_class.offset + (index - size_class.first_index) * size_class.buffer_size;
+      return true;
+    }
+  }
+  return false;
+}
+
+ge::Status BufferFreeList::Alloc(uint64_t size, void *&buffer, int32_t timeout_ms) {
+  LLM_CHK_BOOL_RET_STATUS(class_num_ > 0U, ge::FAILED, "buffer free list is not initialized");
+  LLM_CHK_BOOL_RET_STATUS(size <= classes_[class_num_ - 1U].buffer_size, ge::LLM_PARAM_INVALID,
+                         "size:%lu is larger than the largest buffer:%lu", size,
+                         classes_[class_num_ - 1U].buffer_size);
+  if (TryAlloc(size, buffer)) {
+    return ge::SUCCESS;
+  }
+  if (timeout_ms <= 0) {
+    return ge::LLM_OUT_OF_MEMORY;
+  }
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  std::unique_lock<std::mutex> lock(mutex_);
+  // registered before the retry, so a free racing with it sees the waiter and notifies
+  (void) waiter_num_.fetch_add(1U);
+  bool allocated = TryAlloc(size, buffer);
+  while ((!allocated) && (cv_.wait_until(lock, deadline) != std::cv_status::timeout)) {
+    allocated = TryAlloc(size, buffer);
+  }
+  if (!allocated) {
+    allocated = TryAlloc(size, buffer);
+  }
+  (void) waiter_num_.fetch_sub(1U);
+  LLM_CHK_BOOL_RET_STATUS(allocated, ge::LLM_OUT_OF_MEMORY, "no free buffer of size:%lu within %d ms", size,
+                         timeout_ms);
+  return ge::SUCCESS;
+}
+
+void BufferFreeList::Free(void *buffer) {
+  const auto *addr = static_cast<const uint8_t *>(buffer);
+  if ((buffer == nullptr) || (addr < base_) || (addr >= base_ + region_size_)) {
+    return;
+  }
+  const uint64_t offset = static_cast<uint64_t>(addr - base_);
+  for (size_t i = 0U; i < class_num_; ++i) {
+    auto &size_class = classes_[i];
+    const uint64_t class_end = size_class.offset + size_class.buffer_size * size_class.buffer_num;
+    if ((offset < size_class.offset) || (offset >= class_end)) {
+      continue;
+    }
+    const uint64_t class_offset = offset - size_class.offset;
+    if (class_offset % size_class.buffer_size != 0UL) {
+      LLMLOGW("buffer %p is not the start of a buffer of size:%lu", buffer, size_class.buffer_size);
+      return;
+    }
+    const uint32_t index = size_class.first_index + static_cast<uint32_t>(class_offset / size_class.buffer_size);
+    if (!in_use_[index].exchange(false, std::memory_order_relaxed)) {
+      LLMLOGW("buffer %p is already free", buffer);
+      return;
+    }
+    Push(size_class, index);
+    if (waiter_num_.load() > 0U) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cv_.notify_all();
+    }
+    return;
+  }
+}
+
+size_t BufferFreeList::GetFreeNum(uint64_t buffer_size) const {
+  for (size_t i = 0U; i < class_num_; ++i) {
+    if (classes_[i].buffer_size == buffer_size) {
+      return classes_[i].free_num.load(std::memory_order_relaxed);
+    }
+  }
+  return 0U;
+}
+}  // namespace llm
@@ -0,0 +1,73 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_BUFFER_FREE_LIST_H_
+#define CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_BUFFER_FREE_LIST_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "common/llm_inner_types.h"
+
+namespace llm {
+struct BufferSizeClass {
+  uint64_t buffer_size;
+  uint64_t buffer_num;
+};
+
+// Carves fixed size buffers of several size classes out of one region, every class is a contiguous slice of it.
+// Alloc and Free are a lock free stack push or pop, a mutex is only taken when an allocation has to wait.
+class BufferFreeList {
+ public:
+  BufferFreeList() = default;
+  ~BufferFreeList() = default;
+  BufferFreeList(const BufferFreeList &) = delete;
+  BufferFreeList &operator=(const BufferFreeList &) = delete;
+
+  // size classes are sorted by buffer size, the region must hold all of them
+  ge::Status Initialize(void *base, uint64_t region_size, std::vector<BufferSizeClass> size_classes);
+  static uint64_t GetRegionSize(const std::vector<BufferSizeClass> &size_classes);
+  // takes a buffer of the smallest class holding size, falls back to larger classes when it is used up;
+  // waits up to timeout_ms for a free buffer, 0 fails at once
+  ge::Status Alloc(uint64_t size, void *&buffer, int32_t timeout_ms = 0);
+  // buffers not from the region and buffers already freed are ignored
+  void Free(void *buffer);
+  size_t GetFreeNum(uint64_t buffer_size) const;
+
+ private:
+  static constexpr uint32_t kNilIndex = UINT32_MAX;
+  struct SizeClass {
+    uint64_t buffer_size = 0UL;
+    uint64_t offset = 0UL;  // of the first buffer in the region
+    uint32_t first_index = 0U;
+    uint32_t buffer_num = 0U;
+    // low 32 bits hold the index of the top buffer, high 32 bits a tag bumped by every change against aba
+    std::atomic<uint64_t> head{kNilIndex};
+    std::atomic<uint64_t> free_num{0UL};
+  };
+
+  bool TryAlloc(uint64_t size, void *&buffer);
+  bool Pop(SizeClass &size_class, uint32_t &index);
+  void Push(SizeClass &size_class, uint32_t index);
+
+  uint8_t *base_ = nullptr;
+  uint64_t region_size_ = 0UL;
+  std::unique_ptr<SizeClass[]> classes_;
+  size_t class_num_ = 0U;
+  std::unique_ptr<std::atomic<uint32_t>[]> next_;
+  std::unique_ptr<std::atomic<bool>[]> in_use_;
+  std::atomic<uint32_t> waiter_num_{0U};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+}  // namespace llm
+#endif  // CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_BUFFER_FREE_LIST_H_
@@ -0,0 +1,133 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "buffered_sender.h"
+#include <algorithm>
+#include "common/def_types.h"
+#include "common/llm_checker.h"
+#include "common/llm_log.h"
+#include "link_mgr/comm_entity.h"
+
+namespace llm {
+void BufferedSender::Initialize(CommEntity &comm_entity, aclrtStream stream, bool put_or_get,
+                                const BufferedSenderOptions &options) {
+  auto *entity = &comm_entity;
+  if (put_or_get) {
+    Initialize([entity, stream](std::vector<HcclOneSideOpDesc> &op_descs) -> ge::Status {
+      LLM_CHK_STATUS_RET(entity->BatchPutAsync(op_descs, stream), "Failed to invoke HcclBatchPut");
+      return ge::SUCCESS;
+    }, options);
+  } else {
+    Initialize([entity, stream](std::vector<HcclOneSideOpDesc> &op_descs) -> ge::Status {
+      LLM_CHK_STATUS_RET(entity->BatchGetAsync(op_descs, stream), "Failed to invoke HcclBatchGet");
+      return ge::SUCCESS;
+    }, options);
+  }
+}
+
+void BufferedSender::Initialize(BatchFunc batch_func, const BufferedSenderOptions &options) {
+  batch_func_ = std::move(batch_func);
+  options_ = options;
+  options_.max_op_num = std::max(options_.max_op_num, static_cast<size_t>(1U));
+  op_descs_.clear();
+  op_descs_.reserve(options_.max_op_num);
+  queued_bytes_ = 0UL;
+  region_ended_ = false;
+  statistic_ = BufferedSenderStatistic{};
+}
+
+bool BufferedSender::TryMerge(void *local_addr, void *remote_addr, size_t size) {
+  if ((!options_.merge_contiguous) || op_descs_.empty() || region_ended_) {
+    return false;
+  }
+  auto &last = op_descs_.back();
+  if ((PtrToValue(last.localAddr) + last.count != PtrToValue(local_addr)) ||
+      (PtrToValue(last.remoteAddr) + last.count != PtrToValue(remote_addr))) {
+    return false;
+  }
+  last.count += size;
+  ++statistic_.merged_num;
+  return true;
+}
+
+ge::Status BufferedSender::Put(void *local_addr, void *remote_addr, size_t size, bool flush) {
+  ++statistic_.put_num;
+  const bool merged = TryMerge(local_addr, remote_addr, size);
+  region_ended_ = false;
+  if (!merged) {
+    if (op_descs_.empty() && (options_.flush_delay_us > 0UL)) {
+      first_put_time_ = std::chrono::steady_clock::now();
+    }
+    HcclOneSideOpDesc desc{};
+    desc.dataType = HCCL_DATA_TYPE_UINT8;
+    desc.localAddr = local_addr;
+    desc.remoteAddr = remote_addr;
+    desc.count = size;
+    op_descs_.emplace_back(desc);
+  }
+  queued_bytes_ += size;
+  if (flush) {
+    return DoFlush(FlushReason::kExplicit);
+  }
+  if (op_descs_.size() >= options_.max_op_num) {
+    return DoFlush(FlushReason::kCount);
+  }
+  if ((options_.max_bytes > 0UL) && (queued_bytes_ >= options_.max_bytes)) {
+    return DoFlush(FlushReason::kBytes);
+  }
+  if ((options_.flush_delay_us > 0UL) &&
+      (std::chrono::steady_clock::now() - first_put_time_ >= std::chrono::microseconds(options_.flush_delay_us))) {
+    return DoFlush(FlushReason::kDeadline);
+  }
+  return ge::SUCCESS;
+}
+
+ge::Status BufferedSender::Flush() {
+  return DoFlush(FlushReason::kExplicit);
+}
+
+void BufferedSender::EndRegion() {
+  region_ended_ = true;
+}
+
+ge::Status BufferedSender::DoFlush(FlushReason reason) {
+  if (op_descs_.empty()) {
+    return ge::SUCCESS;
+  }
+  LLM_CHK_BOOL_RET_STATUS(batch_func_ != nullptr, ge::FAILED, "buffered sender is not initialized");
+  LLM_CHK_STATUS_RET(batch_func_(op_descs_), "Failed to flush %zu ops", op_descs_.size());
+  ++statistic_.flush_num;
+  statistic_.op_num += op_descs_.size();
+  statistic_.bytes += queued_bytes_;
+  statistic_.max_flush_op_num = std::max(statistic_.max_flush_op_num, static_cast<uint64_t>(op_descs_.size()));
+  statistic_.max_flush_bytes = std::max(statistic_.max_flush_bytes, queued_bytes_);
+  switch (reason) {
+    case FlushReason::kCount:
+      ++statistic_.count_flush_num;
+      break;
+    case FlushReason::kBytes:
+      ++statistic_.bytes_flush_num;
+      break;
+    case FlushReason::kDeadline:
+      ++statistic_.deadline_flush_num;
+      break;
+    default:
+      ++statistic_.explicit_flush_num;
+      break;
+  }
+  op_descs_.clear();
+  queued_bytes_ = 0UL;
+  return ge::SUCCESS;
+}
+
+const BufferedSenderStatistic &BufferedSender::GetStatistic() const {
+  return statistic_;
+}
+}  // namespace llm
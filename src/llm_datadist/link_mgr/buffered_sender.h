@@ -0,0 +1,84 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_BUFFERED_SENDER_H_
+#define CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_BUFFERED_SENDER_H_
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "acl/acl.h"
+#include "hccl/hccl_mem_comm.h"
+#include "common/llm_inner_types.h"
+
+namespace llm {
+class CommEntity;
+
+struct BufferedSenderOptions {
+  size_t max_op_num = 64U;                      // descriptors of one HcclBatchPut/HcclBatchGet
+  uint64_t max_bytes = 64UL * 1024UL * 1024UL;  // queued bytes that trigger a flush, 0 disables it
+  uint64_t flush_delay_us = 500UL;              // age of the oldest queued op that triggers a flush, 0 disables it
+  // extend the last op when both sides continue it, an op spanning two adjacent registrations is rejected by hccl,
+  // so callers whose ops cross registered regions call BufferedSender::EndRegion at each crossing
+  bool merge_contiguous = false;
+};
+
+struct BufferedSenderStatistic {
+  uint64_t put_num = 0UL;
+  uint64_t merged_num = 0UL;  // puts folded into the previous op
+  uint64_t flush_num = 0UL;   // HCCL batch calls
+  uint64_t op_num = 0UL;      // descriptors submitted
+  uint64_t bytes = 0UL;
+  uint64_t max_flush_op_num = 0UL;
+  uint64_t max_flush_bytes = 0UL;
+  // why the flushes happened
+  uint64_t explicit_flush_num = 0UL;
+  uint64_t count_flush_num = 0UL;
+  uint64_t bytes_flush_num = 0UL;
+  uint64_t deadline_flush_num = 0UL;
+};
+
+// Queues one sided ops and submits them in batches. A batch is sent when it is flushed explicitly, holds
+// max_op_num descriptors or max_bytes, or its oldest op waited flush_delay_us; the deadline is checked on Put,
+// so callers still flush before waiting. With merge_contiguous, ops continuing the previous one on both sides are
+// merged into it.
+class BufferedSender {
+ public:
+  using BatchFunc = std::function<ge::Status(std::vector<HcclOneSideOpDesc> &op_descs)>;
+
+  void Initialize(CommEntity &comm_entity, aclrtStream stream = nullptr, bool put_or_get = true,
+                  const BufferedSenderOptions &options = {});
+  void Initialize(BatchFunc batch_func, const BufferedSenderOptions &options = {});
+
+  ge::Status Put(void *local_addr, void *remote_addr, size_t size, bool flush = false);
+
+  ge::Status Flush();
+
+  // the next put starts a new op even if it continues the last one, called where the ops leave a registered region
+  void EndRegion();
+
+  const BufferedSenderStatistic &GetStatistic() const;
+
+ private:
+  enum class FlushReason : int32_t { kExplicit, kCount, kBytes, kDeadline };
+
+  bool TryMerge(void *local_addr, void *remote_addr, size_t size);
+  ge::Status DoFlush(FlushReason reason);
+
+  std::vector<HcclOneSideOpDesc> op_descs_;
+  BatchFunc batch_func_;
+  BufferedSenderOptions options_;
+  BufferedSenderStatistic statistic_;
+  uint64_t queued_bytes_ = 0UL;
+  bool region_ended_ = false;
+  std::chrono::steady_clock::time_point first_put_time_;
+};
+}  // namespace llm
+#endif  // CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_BUFFERED_SENDER_H_
@@ -9,6 +9,7 @@
  */
 
 #include "comm_entity.h"
+#include <algorithm>
 #include "common/def_types.h"
 #include "common/mem_utils.h"
 #include "common/llm_log.h"
@@ -27,20 +28,45 @@ constexpr uint64_t kDefaultMsgBufferSize = 128U * 1024U;
 constexpr uint64_t kDefaultReqBufferSize = 112U * 1024U;
 constexpr uint64_t kDefaultRespBufferSize = 16U * 1024U;
 constexpr uint32_t kFlagSize = 8U;
-constexpr size_t kMaxOpDescNum = 64U;
 constexpr size_t kMinRemoteMemSize = 3U;
 constexpr int32_t kRetryCountMin = 1;
 constexpr int32_t kRetryCountMax = 100;
-// hccl HcclCommInitClusterInfoMemConfig not support parallel call, so use mutex to protect it
-std::mutex g_mutex_;
 }  // namespace
 
+HcclCommInitGate &HcclCommInitGate::GetInstance() {
+  static HcclCommInitGate instance;
+  return instance;
+}
+
+void HcclCommInitGate::SetLimit(uint32_t limit) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    limit_ = std::max(limit, 1U);
+  }
+  cv_.notify_all();
+}
+
+void HcclCommInitGate::Acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this]() { return in_use_ < limit_; });
+  ++in_use_;
+}
+
+void HcclCommInitGate::Release() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --in_use_;
+  }
+  cv_.notify_one();
+}
+
 
 RegBufferPool::RegBufferPool(uint64_t capacity, bool is_host)
-    : capacity_(capacity), is_host_(is_host), buffer_(nullptr), handle_(nullptr) {}
+    : size_classes_{{kDefaultMsgBufferSize, capacity}}, is_host_(is_host), buffer_(nullptr), handle_(nullptr) {}
 
 ge::Status RegBufferPool::Initialize() {
-  uint64_t buffer_size = kDefaultMsgBufferSize * capacity_;
+  uint64_t buffer_size = BufferFreeList::GetRegionSize(size_classes_);
+  LLM_CHK_BOOL_RET_STATUS(buffer_size > 0UL, ge::LLM_PARAM_INVALID, "reg buffer pool is empty");
   if (is_host_) {
     LLM_CHK_ACL_RET(aclrtMallocHost(&buffer_, buffer_size));
   } else {
@@ -53,16 +79,13 @@ ge::Status RegBufferPool::Initialize() {
     } else {
       LLM_CHK_ACL(aclrtFree(buffer_));
     }
+    buffer_ = nullptr;
   }));
+  LLM_CHK_STATUS_RET(free_list_.Initialize(buffer_, buffer_size, size_classes_), "Failed to init buffer free list.");
   auto type = is_host_ ? HcclMemType::HCCL_MEM_TYPE_HOST : HcclMemType::HCCL_MEM_TYPE_DEVICE;
   LLM_CHK_STATUS_RET(GlobalMemManager::GetInstance().RegisterMem(buffer_, buffer_size, type, handle_),
                     "Failed to register buffer pool addr.");
   LLM_DISMISS_GUARD(fail_guard);
-
-  for (uint64_t i = 0; i < capacity_; ++i) {
-    void *ptr = static_cast<uint8_t *>(buffer_) + i * kDefaultMsgBufferSize;
-    reg_buffers_[ptr] = false;
-  }
   return ge::SUCCESS;
 }
 
@@ -86,25 +109,11 @@ void RegBufferPool::Finalize() {
 }
 
 ge::Status RegBufferPool::Alloc(void *&buffer) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  ge::Status ret = ge::FAILED;
-  for (auto &it : reg_buffers_) {
-    if (it.second == false) {
-      buffer = it.first;
-      it.second = true;
-      ret = ge::SUCCESS;
-      break;
-    }
-  }
-  return ret;
+  return free_list_.Alloc(kDefaultMsgBufferSize, buffer);
 }
 
 void RegBufferPool::Free(void *buffer) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto it = reg_buffers_.find(buffer);
-  if (it != reg_buffers_.end()) {
-    it->second = false;
-  }
+  free_list_.Free(buffer);
 }
 
 EntityMemInfo::EntityMemInfo(bool remote_cache_accessible, 
@@ -168,11 +177,12 @@ EntityCommInfo::EntityCommInfo(const HcclComm &comm, std::vector<void *> mem_han
 ge::Status EntityCommInfo::Initialize() {
   std::lock_guard<std::mutex> lock(mutex_);
   if (!comm_inited_) {
-    std::lock_guard<std::mutex> g_lock(g_mutex_);
-    HcclResult ret = HcclAdapter::GetInstance().HcclCommInitClusterInfoMemConfig(params_.rank_table.c_str(),
-                                                                                 params_.rank_id,
-                                                                                 &params_.comm_config,
-                                                                                 &comm_);
+    HcclResult ret = HcclResult::HCCL_SUCCESS;
+    {
+      HcclCommInitGate::Guard init_guard;
+      ret = HcclAdapter::GetInstance().HcclCommInitClusterInfoMemConfig(params_.rank_table.c_str(), params_.rank_id,
+                                                                        &params_.comm_config, &comm_);
+    }
     LLM_CHK_BOOL_RET_STATUS(ret == HcclResult::HCCL_SUCCESS, ge::LLM_LINK_FAILED,
                           "Call HcclCommInitClusterInfoMemConfig failed, ret:%d.", ret);
     comm_inited_ = true;
@@ -519,7 +529,7 @@ ge::Status CommEntity::BatchPutAsync(std::vector<HcclOneSideOpDesc> &op_descs, a
                          static_cast<int32_t>(ret));
   const auto end = std::chrono::steady_clock::now();
   const auto cost = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-  LLMLOGI("HcclBatchPut success, num = %zu, cost = %ld us.", op_descs.size(), cost);
+  LLMLOGD("HcclBatchPut success, num = %zu, cost = %ld us.", op_descs.size(), cost);
   auto &send_statistic_info = GetSendStatisticInfo(stream_to_use);
   StatisticManager::GetInstance().UpdateCost(
       cost, send_statistic_info.batch_put_times, send_statistic_info.batch_put_min_cost,
@@ -551,7 +561,7 @@ ge::Status CommEntity::BatchGetAsync(std::vector<HcclOneSideOpDesc> &op_descs, a
                          static_cast<int32_t>(ret));
   const auto end = std::chrono::steady_clock::now();
   const auto cost = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-  LLMLOGI("HcclBatchGet success, num = %zu, cost = %ld us.", op_descs.size(), cost);;
+  LLMLOGD("HcclBatchGet success, num = %zu, cost = %ld us.", op_descs.size(), cost);
   StatisticManager::UpdateCost(
       cost, recv_statistic_info_.batch_get_times, recv_statistic_info_.batch_get_min_cost,
       recv_statistic_info_.batch_get_max_cost, recv_statistic_info_.batch_get_total_cost);
@@ -715,42 +725,6 @@ void *CommEntity::GetTransferBuffer() const {
   return mem_info_ptr_->transfer_buffer_;
 }
 
-void BufferedSender::Initialize(CommEntity &comm_entity, aclrtStream stream, bool put_or_get) {
-  comm_entity_ = &comm_entity;
-  stream_ = stream;
-  put_or_get_ = put_or_get;
-  op_descs_.reserve(kMaxOpDescNum);
-}
-
-ge::Status BufferedSender::Put(void *local_addr, void *remote_addr, size_t size, bool flush) {
-  HcclOneSideOpDesc desc{};
-  desc.dataType = HCCL_DATA_TYPE_UINT8;
-  desc.localAddr = local_addr;
-  desc.remoteAddr = remote_addr;
-  desc.count = size;
-  op_descs_.emplace_back(desc);
-  if (flush || (op_descs_.size() == op_descs_.capacity())) {
-    return Flush();
-  }
-  return ge::SUCCESS;
-}
-
-ge::Status BufferedSender::Flush() {
-  if (!op_descs_.empty()) {
-    if (put_or_get_) {
-      auto ret = comm_entity_->BatchPutAsync(op_descs_, stream_);
-      LLM_CHK_STATUS_RET(ret, "Failed to invoke HcclBatchPut");
-      LLMLOGI("BatchPut success, buffer_num = %zu", op_descs_.size());
-    } else {
-      auto ret = comm_entity_->BatchGetAsync(op_descs_, stream_);
-      LLM_CHK_STATUS_RET(ret, "Failed to invoke HcclBatchGet");
-      LLMLOGI("BatchGet success, buffer_num = %zu", op_descs_.size());
-    }
-    op_descs_.clear();
-  }
-  return ge::SUCCESS;
-}
-
 CacheAccessTable &CommEntity::GetCacheAccessTable() {
   return cache_access_table_;
 }
@@ -13,6 +13,7 @@
 
 #include <vector>
 #include <list>
+#include <condition_variable>
 
 #include "acl/acl.h"
 
@@ -24,6 +25,8 @@
 #include "hccl/hccl_adapter.h"
 #include "common/llm_mem_pool.h"
 #include "statistic_manager.h"
+#include "buffer_free_list.h"
+#include "buffered_sender.h"
 #include "utils/cache_access_table.h"
 
 namespace llm {
@@ -54,6 +57,7 @@ using FillResponseFunc = std::function<void(ResponseInfo &, uint64_t &size)>;
 
 class DataTransferJob;
 
+// One registered region split into capacity buffers of the default message buffer size
 class RegBufferPool {
  public:
   RegBufferPool(uint64_t capacity, bool is_host);
@@ -64,12 +68,45 @@ class RegBufferPool {
   void Free(void *buffer);
 
  private:
-  uint64_t capacity_;
+  std::vector<BufferSizeClass> size_classes_;
   bool is_host_;
-  std::mutex mutex_;
   void *buffer_;
   void *handle_;
-  std::map<void *, bool> reg_buffers_;
+  BufferFreeList free_list_;
+};
+
+// Default bound of concurrent HcclCommInitClusterInfoMemConfig calls, a few calls in flight keep one slow peer from
+// holding up every other link while staying far below the link thread num
+constexpr uint32_t kDefaultCommInitConcurrency = 4U;
+
+// Bounds concurrent HcclCommInitClusterInfoMemConfig calls of the process. A limit of 1 serializes them for hccl
+// versions that do not support parallel calls of it.
+class HcclCommInitGate {
+ public:
+  static HcclCommInitGate &GetInstance();
+  void SetLimit(uint32_t limit);
+
+  // holds one slot of the gate in its scope
+  class Guard {
+   public:
+    Guard() {
+      HcclCommInitGate::GetInstance().Acquire();
+    }
+    ~Guard() {
+      HcclCommInitGate::GetInstance().Release();
+    }
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+  };
+
+ private:
+  HcclCommInitGate() = default;
+  void Acquire();
+  void Release();
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint32_t limit_ = kDefaultCommInitConcurrency;
+  uint32_t in_use_ = 0U;
 };
 
 class EntityMemInfo {
@@ -220,20 +257,5 @@ class CommEntity {
   bool is_exchanged_mem_{false};
   std::mutex pull_mutex_;
 };
-
-class BufferedSender {
- public:
-  void Initialize(CommEntity &comm_entity, aclrtStream stream = nullptr, bool put_or_get = true);
-
-  ge::Status Put(void *local_addr, void *remote_addr, size_t size, bool flush = false);
-
-  ge::Status Flush();
-
- private:
-  std::vector<HcclOneSideOpDesc> op_descs_;
-  CommEntity *comm_entity_ = nullptr;
-  aclrtStream stream_ = nullptr;
-  bool put_or_get_ = true;
-};
 }  // namespace llm
 #endif  // CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_ENTITY_H_
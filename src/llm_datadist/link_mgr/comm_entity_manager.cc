@@ -9,6 +9,7 @@
  */
 
 #include "comm_entity_manager.h"
+#include "nlohmann/json.hpp"
 #include "common/def_types.h"
 #include "llm_datadist/llm_error_codes.h"
 #include "common/llm_checker.h"
@@ -21,8 +22,21 @@ namespace llm {
 namespace {
 constexpr size_t kHostBufferSize = 1UL * 1024 * 1024 * 1024;
 constexpr size_t kAlignment = 4096U;
+constexpr const char kFsmThreadName[] = "ge_llm_fsm";
+constexpr uint32_t kMaxFsmWorkerNum = 16U;
 }  // namespace
 
+void CommEntityManager::AddEntity(uint64_t entity_id, const EntityPtr &entity) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    (void)entity_map_.emplace(entity_id, entity);
+    cluster_id_to_entity_id_[entity->GetClusterId()] = entity_id;
+  }
+  if (scheduler_ != nullptr) {
+    scheduler_->Watch(entity_id, [entity]() { return IsEntityReady(*entity); });
+  }
+}
+
 ge::Status CommEntityManager::CreateEntity(const CommEntityParams &entity_params,
                                            const EntityCommInfo::CommParams &comm_params,
                                            EntityPtr &entity_ptr) {
@@ -40,11 +54,7 @@ ge::Status CommEntityManager::CreateEntity(const CommEntityParams &entity_params
   LLM_CHK_STATUS_RET(entity->Initialize(entity_params.remote_cache_accessible, comm_params),
                     "Failed to init entity");
   auto entity_id = entity_id_gen_.fetch_add(1UL, std::memory_order::memory_order_relaxed);
-  mgr_high_priority_flag_.store(true);
-  std::lock_guard<std::mutex> lock(mutex_);
-  (void)entity_map_.emplace(entity_id, entity);
-  cluster_id_to_entity_id_[entity_params.peer_cluster_id] = entity_id;
-  mgr_high_priority_flag_.store(false);
+  AddEntity(entity_id, entity);
   entity_ptr = entity;
   LLMLOGI("Create entity success, peer cluster id:%lu, local cluster id:%lu",
          entity_params.peer_cluster_id, entity_params.local_cluster_id);
@@ -60,11 +70,7 @@ ge::Status CommEntityManager::CreateEntity(const CommEntityParams &entity_params
   LLM_CHK_STATUS_RET(entity->Initialize(entity_params.remote_cache_accessible),
                     "Failed to init entity");
   auto entity_id = entity_id_gen_.fetch_add(1UL, std::memory_order::memory_order_relaxed);
-  mgr_high_priority_flag_.store(true);
-  std::lock_guard<std::mutex> lock(mutex_);
-  (void)entity_map_.emplace(entity_id, entity);
-  cluster_id_to_entity_id_[entity_params.peer_cluster_id] = entity_id;
-  mgr_high_priority_flag_.store(false);
+  AddEntity(entity_id, entity);
   entity_ptr = entity;
   LLMLOGI("Create entity success, peer cluster id:%lu, local cluster id:%lu",
          entity_params.peer_cluster_id, entity_params.local_cluster_id);
@@ -82,8 +88,14 @@ ge::Status CommEntityManager::DestroyEntity(uint64_t peer_cluster_id) {
     auto entity_ret = entity->Finalize();
     ret = entity_ret != ge::SUCCESS ? entity_ret : ret;
     if (start_service_) {
-      std::lock_guard<std::mutex> process_lock(entity->GetProcessMutex());
-      entity->MarkEntityDestroyed();
+      {
+        std::lock_guard<std::mutex> process_lock(entity->GetProcessMutex());
+        entity->MarkEntityDestroyed();
+      }
+      // removed from the map by the fsm worker
+      if (scheduler_ != nullptr) {
+        scheduler_->Notify(entity_id);
+      }
     } else {
       cluster_id_to_entity_id_.erase(it);
       entity_map_.erase(entity_id);
@@ -125,6 +137,9 @@ void CommEntityManager::DeleteEntities() {
   for (auto it = entity_map_.begin(); it != entity_map_.end();) {
     auto entity = it->second;
     if (entity->GetCurState() == FsmState::FSM_DESTROYED_STATE) {
+      if (scheduler_ != nullptr) {
+        scheduler_->Unwatch(it->first);
+      }
       cluster_id_to_entity_id_.erase(entity->GetClusterId());
       it = entity_map_.erase(it);
       continue;
@@ -144,52 +159,105 @@ size_t CommEntityManager::GetEntitySize() {
   return num;
 }
 
-void CommEntityManager::HandleAllEntities() {
-  if (mgr_high_priority_flag_.load()) {
-    return;
+bool CommEntityManager::IsEntityReady(const CommEntity &entity) {
+  const auto state = entity.GetCurState();
+  if ((state == FsmState::FSM_INIT_STATE) || (state == FsmState::FSM_ERROR_STATE)) {
+    return false;
   }
-  std::lock_guard<std::mutex> lock(mutex_);
-  for (auto it = entity_map_.begin(); it != entity_map_.end();) {
-    auto entity = it->second;
-    if ((entity->GetCurState() == FsmState::FSM_INIT_STATE) ||
-        (entity->GetCurState() == FsmState::FSM_ERROR_STATE)) {
-      it++;
-      continue;
+  if (state == FsmState::FSM_RECEIVE_STATE) {
+    // written by the requester with a one sided put
+    const volatile int8_t *const flag = entity.GetCacheInfoFlag();
+    return *flag == 1;
+  }
+  // idle moves to receive at once, send has a transfer in flight, destroyed is waiting to be removed
+  return true;
+}
+
+bool CommEntityManager::ProcessEntity(uint64_t entity_id) {
+  EntityPtr entity;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entity_map_.find(entity_id);
+    if (it == entity_map_.cend()) {
+      scheduler_->Unwatch(entity_id);
+      return false;
     }
-    if (entity->GetProcessMutex().try_lock()) {
-      std::lock_guard<std::mutex> process_lock(entity->GetProcessMutex(), std::adopt_lock);
-      if (entity->GetCurState() == FsmState::FSM_DESTROYED_STATE) {
-        cluster_id_to_entity_id_.erase(entity->GetClusterId());
-        it = entity_map_.erase(it);
-        continue;
-      }
+    entity = it->second;
+  }
+  {
+    std::lock_guard<std::mutex> process_lock(entity->GetProcessMutex());
+    const auto state = entity->GetCurState();
+    if ((state == FsmState::FSM_INIT_STATE) || (state == FsmState::FSM_ERROR_STATE)) {
+      return false;
+    }
+    if (state != FsmState::FSM_DESTROYED_STATE) {
       LLM_CHK_BOOL_EXEC(entity->ProcessState() == ge::SUCCESS, entity->MarkEntityError(),
                        "Failed to process state");
+      // the timeout of a transfer is checked by the send state on every step
+      return entity->GetCurState() == FsmState::FSM_SEND_STATE;
     }
-    it++;
   }
-}
-
-void CommEntityManager::HandleCacheRequest() {
-  (void) pthread_setname_np(pthread_self(), "ge_llm_fsm");
-  LLM_CHK_ACL(aclrtSetCurrentContext(aclrt_context_));
-  while (running_) {
-    HandleAllEntities();
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = cluster_id_to_entity_id_.find(entity->GetClusterId());
+  if ((it != cluster_id_to_entity_id_.cend()) && (it->second == entity_id)) {
+    cluster_id_to_entity_id_.erase(it);
   }
+  entity_map_.erase(entity_id);
+  scheduler_->Unwatch(entity_id);
+  return false;
 }
 
 void CommEntityManager::SetCommMemManager(CommMemManager *comm_mem_manager) {
   comm_mem_manager_ = comm_mem_manager;
 }
 
-ge::Status CommEntityManager::Initialize(bool start_service) {
+ge::Status CommEntityManager::ParseSchedulerOptions(const std::map<ge::AscendString, ge::AscendString> &options,
+                                                    EntitySchedulerOptions &scheduler_options) {
+  const auto it = options.find(LLM_OPTION_FSM_SCHEDULER_CONFIG);
+  if (it == options.cend()) {
+    return ge::SUCCESS;
+  }
+  const std::string json_str = it->second.GetString();
+  try {
+    const auto json_obj = nlohmann::json::parse(json_str);
+    if (json_obj.contains("worker_num")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("worker_num").is_number_unsigned() &&
+                             (json_obj.at("worker_num").get<uint64_t>() > 0UL) &&
+                             (json_obj.at("worker_num").get<uint64_t>() <= kMaxFsmWorkerNum), ge::LLM_PARAM_INVALID,
+                             "worker_num must be in range [1, %u]: config = %s", kMaxFsmWorkerNum, json_str.c_str());
+      scheduler_options.worker_num = json_obj.at("worker_num").get<uint32_t>();
+    }
+    if (json_obj.contains("spin_time_us")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("spin_time_us").is_number_unsigned(), ge::LLM_PARAM_INVALID,
+                             "spin_time_us is not an unsigned integer: config = %s", json_str.c_str());
+      scheduler_options.spin_time_us = json_obj.at("spin_time_us").get<uint64_t>();
+    }
+    if (json_obj.contains("max_sleep_time_us")) {
+      LLM_CHK_BOOL_RET_STATUS(json_obj.at("max_sleep_time_us").is_number_unsigned(), ge::LLM_PARAM_INVALID,
+                             "max_sleep_time_us is not an unsigned integer: config = %s", json_str.c_str());
+      scheduler_options.max_sleep_time_us = json_obj.at("max_sleep_time_us").get<uint64_t>();
+    }
+  } catch (nlohmann::json::exception &e) {
+    LLMLOGE(ge::LLM_PARAM_INVALID, "Failed to parse %s: \"%s\", exception = %s", LLM_OPTION_FSM_SCHEDULER_CONFIG,
+            json_str.c_str(), e.what());
+    return ge::LLM_PARAM_INVALID;
+  }
+  return ge::SUCCESS;
+}
+
+ge::Status CommEntityManager::Initialize(bool start_service, const EntitySchedulerOptions &scheduler_options) {
   start_service_ = start_service;
   if (!start_service) {
     LLMLOGI("No need to start FSM thread");
     return ge::SUCCESS;
   }
   LLM_CHK_ACL_RET(aclrtGetCurrentContext(&aclrt_context_));
-  cache_engine_thread_ = std::thread(&CommEntityManager::HandleCacheRequest, this);
+  scheduler_ = MakeUnique<EntityScheduler>(scheduler_options,
+                                           [this](uint64_t entity_id) { return ProcessEntity(entity_id); });
+  LLM_CHECK_NOTNULL(scheduler_);
+  LLM_CHK_STATUS_RET(scheduler_->Start(kFsmThreadName, [this]() {
+    LLM_CHK_ACL(aclrtSetCurrentContext(aclrt_context_));
+  }), "Failed to start entity scheduler");
   ScalableConfig config{};
   config.page_mem_size_total_threshold = kHostBufferSize;
   host_mem_pool_ = MakeUnique<LlmMemPool>(config);
@@ -208,9 +276,8 @@ ge::Status CommEntityManager::Initialize(bool start_service) {
 
 void CommEntityManager::Finalize() {
   LLMLOGI("CommEntityManager finalize start");
-  running_ = false;
-  if (cache_engine_thread_.joinable()) {
-    cache_engine_thread_.join();
+  if (scheduler_ != nullptr) {
+    scheduler_->Stop();
   }
   std::lock_guard<std::mutex> lock(mutex_);
   for (auto &entity_pair : entity_map_) {
@@ -15,6 +15,7 @@
 #include <thread>
 #include "common/llm_inner_types.h"
 #include "comm_entity.h"
+#include "entity_scheduler.h"
 #include "cache_mgr/comm_mem_manager.h"
 #include "common/aligned_ptr.h"
 
@@ -35,7 +36,7 @@ class CommEntityManager {
  public:
   CommEntityManager() = default;
   ~CommEntityManager() = default;
-  ge::Status Initialize(bool start_service = true);
+  ge::Status Initialize(bool start_service = true, const EntitySchedulerOptions &scheduler_options = {});
   void Finalize();
   ge::Status CreateEntity(const CommEntityParams &entity_params, EntityPtr &entity_ptr);
   ge::Status CreateEntity(const CommEntityParams &entity_params,
@@ -51,19 +52,20 @@ class CommEntityManager {
   ge::Status RemapRegisteredMemory(const std::vector<LLMMemInfo> &mem_infos);
   RegBufferPool *GetHostRegPool();
   RegBufferPool *GetDeviceRegPool();
+  static ge::Status ParseSchedulerOptions(const std::map<ge::AscendString, ge::AscendString> &options,
+                                          EntitySchedulerOptions &scheduler_options);
 
  private:
-  void HandleCacheRequest();
-  void HandleAllEntities();
-  std::atomic_bool running_{true};
-  bool need_handle_request_ = false;
-  std::thread cache_engine_thread_;
+  void AddEntity(uint64_t entity_id, const EntityPtr &entity);
+  static bool IsEntityReady(const CommEntity &entity);
+  // runs one step of the entity state machine, returns true while a transfer is in progress
+  bool ProcessEntity(uint64_t entity_id);
+  std::unique_ptr<EntityScheduler> scheduler_;
   std::unique_ptr<LlmMemPool> host_mem_pool_{};
   std::shared_ptr<AlignedPtr> host_buffer_;
   aclrtContext aclrt_context_{};
   std::atomic_uint64_t entity_id_gen_{1LU};
   CommMemManager *comm_mem_manager_{};
-  std::atomic_bool mgr_high_priority_flag_{false};
   std::mutex mutex_;
   std::unordered_map<uint64_t, EntityPtr> entity_map_{};
   std::map<uint64_t, uint64_t> cluster_id_to_entity_id_{};
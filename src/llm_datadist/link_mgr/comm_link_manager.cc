@@ -25,6 +25,7 @@ constexpr const char LLM_OPTION_RDMA_TRAFFIC_CLASS[] = "llm.RdmaTrafficClass";
 constexpr const char LLM_OPTION_RDMA_SERVICE_LEVEL[] = "llm.RdmaServiceLevel";
 constexpr const char LLM_OPTION_LINK_TOTAL_TIME[] = "llm.LinkTotalTime";
 constexpr const char LLM_OPTION_LINK_RETRY_COUNT[] = "llm.LinkRetryCount";
+constexpr const char LLM_OPTION_LINK_CONCURRENCY[] = "llm.LinkConcurrency";
 }  // namespace
 
 static void from_json(const nlohmann::json &j, ExchangeMemInfo &e) {
@@ -147,24 +148,13 @@ void CommLinkManager::FreeFlagGuard(PrepareMemArg &req) {
   }
 }
 
-void CommLinkManager::FlagGuard(PrepareMemArg &req) {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  if (comm_to_status_.find(req.comm_id) != comm_to_status_.end()) {
-    comm_to_status_[req.comm_id].prepare_mem_flag.store(true);
-  }
-}
-
-ge::Status CommLinkManager::PrepareComm(const PrepareMemArg &req,
-                                        EntityCommInfoPtr &comm_info_ptr) {
+ge::Status CommLinkManager::CreateCommInfo(const PrepareMemArg &req, EntityCommInfoPtr &comm_info_ptr) {
   comm_info_ptr = MakeShared<EntityCommInfo>(req.comm, req.mem_handles, req.link_total_time, req.link_retry_count);
   LLM_CHECK_NOTNULL(comm_info_ptr);
-  {
-    std::lock_guard<std::mutex> lock(map_mutex_);
-    if (comm_to_status_.find(req.comm_id) != comm_to_status_.end()) {
-      comm_to_status_[req.comm_id].comm_ptr = comm_info_ptr;
-    }
+  std::lock_guard<std::mutex> lock(map_mutex_);
+  if (comm_to_status_.find(req.comm_id) != comm_to_status_.end()) {
+    comm_to_status_[req.comm_id].comm_ptr = comm_info_ptr;
   }
-  LLM_CHK_STATUS_RET(comm_info_ptr->Initialize(), "Failed to init comm info");
   return ge::SUCCESS;
 }
 
@@ -214,9 +204,7 @@ ge::Status CommLinkManager::PrepareMem(PrepareMemArg &req) {
   std::map<uint64_t, EntityPtr> cluster2entity;
   LLM_CHK_STATUS_RET(CreateClustersEntity(req, cluster2entity), "Failed to create clusters entity.");
   EntityCommInfoPtr comm_info_ptr = nullptr;
-  FreeFlagGuard(req);
-  LLM_CHK_STATUS_RET(PrepareComm(req, comm_info_ptr), "Failed to prepare comm info");
-  FlagGuard(req);
+  LLM_CHK_STATUS_RET(CreateCommInfo(req, comm_info_ptr), "Failed to create comm info");
   std::vector<uint64_t> cluster_ids;
   std::vector<uint32_t> rank_ids;
   for (auto &iter : req.cluster2rank) {
@@ -225,25 +213,84 @@ ge::Status CommLinkManager::PrepareMem(PrepareMemArg &req) {
   }
   LLMEVENT("Begin to prepare memory for clusters[%s], ranks[%s].", ToString(cluster_ids).c_str(),
           ToString(rank_ids).c_str());
-  std::vector<EntityPtr> new_entities;
-  auto local_rank_id = req.cluster2rank[cluster_id_];
+  std::vector<std::pair<EntityPtr, uint32_t>> peers;
   for (auto &iter : req.cluster2rank) {
     if (iter.first != cluster_id_) {
-      CheckUnlink(req, check_unlink_flag);
       auto entity = cluster2entity[iter.first];
       entity->SetEntityCommInfo(comm_info_ptr);
-      LLM_CHK_STATUS_RET(ExchangeMem(entity, local_rank_id, iter.second), "Failed to exchange mem");
-      LLM_CHK_STATUS_RET(entity->SetInfo(), "Failed to set entity info");
-      (void)new_entities.emplace_back(entity);
+      (void)peers.emplace_back(entity, iter.second);
     }
   }
-  for (auto &entity : new_entities) {
-    std::lock_guard<std::mutex> process_lock(entity->GetProcessMutex());
-    entity->MarkEntityIdle();
+  LLM_CHK_STATUS_RET(ExchangeMemWithPeers(req, comm_info_ptr, peers), "Failed to exchange mem with peers");
+  for (auto &peer : peers) {
+    std::lock_guard<std::mutex> process_lock(peer.first->GetProcessMutex());
+    peer.first->MarkEntityIdle();
   }
   return ge::SUCCESS;
 }
 
+bool CommLinkManager::IsUnlinking(uint64_t comm_id) {
+  std::lock_guard<std::mutex> lock(map_mutex_);
+  const auto iter = comm_to_status_.find(comm_id);
+  return (iter == comm_to_status_.end()) || iter->second.unlink_flag.load();
+}
+
+ge::Status CommLinkManager::ExchangeMemWithPeers(PrepareMemArg &req, const EntityCommInfoPtr &comm_info_ptr,
+                                                 const std::vector<std::pair<EntityPtr, uint32_t>> &peers) {
+  const auto local_rank_id = req.cluster2rank[cluster_id_];
+  // entity info is read from the peer through the comm, so it is only set once the comm is prepared
+  std::promise<ge::Status> comm_prepared;
+  std::shared_future<ge::Status> prepare_ret = comm_prepared.get_future().share();
+  // prepare_mem_flag stays set until every exchange returned, unlink only waits for it
+  auto exchange_func = [this, &req, local_rank_id, prepare_ret](const EntityPtr &entity,
+                                                                uint32_t remote_rank) -> ge::Status {
+    LLM_CHK_BOOL_RET_STATUS(!IsUnlinking(req.comm_id), ge::FAILED,
+                           "Comm:%lu is unlinking, abort exchanging mem with rank:%u.", req.comm_id, remote_rank);
+    LLM_CHK_STATUS_RET(ExchangeMem(entity, local_rank_id, remote_rank), "Failed to exchange mem");
+    LLM_CHK_BOOL_RET_STATUS(prepare_ret.get() == ge::SUCCESS, ge::FAILED,
+                           "Comm:%lu is not prepared, abort setting info of rank:%u.", req.comm_id, remote_rank);
+    LLM_CHK_STATUS_RET(entity->SetInfo(), "Failed to set entity info");
+    return ge::SUCCESS;
+  };
+  // HcclCommPrepare and every HcclExchangeMemDesc wait for the remote side, so the exchanges run on the pool while
+  // this thread prepares the comm, a two rank link overlaps its single exchange with the prepare as well.
+  // the pool is bounded by kLinkThreadNum, llm.LinkConcurrency only bounds comm init
+  const auto thread_num = static_cast<uint32_t>(std::min(kLinkThreadNum, peers.size()));
+  LLMThreadPool thread_pool("llm_prepare_mem", thread_num);
+  std::vector<std::future<ge::Status>> fut_rets;
+  for (const auto &peer : peers) {
+    auto fut = thread_pool.commit([this, &exchange_func, &peer]() -> ge::Status {
+      LLM_CHK_BOOL_RET_STATUS(aclrtSetCurrentContext(aclrt_context_) == ACL_ERROR_NONE, ge::FAILED,
+                             "Set aclrt context failed.");
+      return exchange_func(peer.first, peer.second);
+    });
+    if (!fut.valid()) {
+      comm_prepared.set_value(ge::FAILED);
+      LLMLOGE(ge::FAILED, "Failed to commit exchange mem task.");
+      return ge::FAILED;
+    }
+    fut_rets.emplace_back(std::move(fut));
+  }
+  auto ret = ge::FAILED;
+  if (IsUnlinking(req.comm_id)) {
+    LLMLOGI("Comm:%lu is unlinking, abort preparing comm.", req.comm_id);
+  } else {
+    ret = comm_info_ptr->Initialize();
+    if (ret != ge::SUCCESS) {
+      LLMLOGE(ret, "Failed to init comm info, comm_id:%lu.", req.comm_id);
+    }
+  }
+  comm_prepared.set_value(ret);
+  for (size_t i = 0U; i < fut_rets.size(); ++i) {
+    const auto fut_ret = fut_rets[i].get();
+    if (fut_ret != ge::SUCCESS) {
+      LLMLOGE(fut_ret, "Failed to exchange mem with rank:%u.", peers[i].second);
+      ret = fut_ret;
+    }
+  }
+  return ret;
+}
+
 ge::Status CommLinkManager::PrepareMemTask(CommLinkManager *link_manager, PrepareMemArg request) {
   LLMLOGI("New prepare mem request arrived.");
   const auto start = std::chrono::steady_clock::now();
@@ -297,6 +344,16 @@ ge::Status CommLinkManager::Initialize(const std::map<ge::AscendString, ge::Asce
                       "llm.linkRetryCount is invalid, value = %s",
                       retry_count->second.GetString());
   }
+  const auto concurrency = options.find(LLM_OPTION_LINK_CONCURRENCY);
+  if (concurrency != options.end()) {
+    LLM_CHK_STATUS_RET(LLMUtils::ToNumber(concurrency->second.GetString(), link_concurrency_),
+                      "llm.LinkConcurrency is invalid, value = %s", concurrency->second.GetString());
+    LLM_CHK_BOOL_RET_STATUS((link_concurrency_ > 0U) && (link_concurrency_ <= kMaxLinkConcurrency),
+                           ge::LLM_PARAM_INVALID, "llm.LinkConcurrency should be in range [1, %u], value = %u",
+                           kMaxLinkConcurrency, link_concurrency_);
+  }
+  HcclCommInitGate::GetInstance().SetLimit(link_concurrency_);
+  LLMLOGI("Concurrent hccl comm init num is %u.", link_concurrency_);
   return ge::SUCCESS;
 }
 
@@ -312,13 +369,16 @@ ge::Status CommLinkManager::Link(std::string &cluster_name, const std::map<uint6
                          "param cluster_name size should be smaller than:%u", COMM_NAME_MAX_LENGTH);
   LLM_CHK_BOOL_RET_STATUS(cluster2rank.find(cluster_id_) != cluster2rank.end(), ge::LLM_PARAM_INVALID,
                          "local cluster id does not exist in cluster2rank");
-  // lock for process
-  std::lock_guard<std::mutex> lock(mutex_);
   {
     std::lock_guard<std::mutex> map_lock(map_mutex_);
-    LLM_CHK_BOOL_RET_STATUS(comm_to_status_.size() < kMaxLinkNum, ge::LLM_PARAM_INVALID,
+    LLM_CHK_BOOL_RET_STATUS(comm_to_status_.size() + pending_link_num_ < kMaxLinkNum, ge::LLM_PARAM_INVALID,
                            "Link num is over limit:%u.", kMaxLinkNum);
+    ++pending_link_num_;
   }
+  LLM_MAKE_GUARD(pending_link, ([this]() {
+    std::lock_guard<std::mutex> map_lock(map_mutex_);
+    --pending_link_num_;
+  }));
   auto local_rank = cluster2rank.at(cluster_id_);
   LLM_CHK_BOOL_RET_STATUS(aclrtSetCurrentContext(aclrt_context_) == ACL_ERROR_NONE, ge::LLM_UNLINK_FAILED,
                          "Set aclrt context failed.");
@@ -334,39 +394,52 @@ ge::Status CommLinkManager::Link(std::string &cluster_name, const std::map<uint6
     config.hcclRdmaServiceLevel = rdmaServiceLevel_;
   }
 
-  LLMLOGI("HcclCommInitClusterInfoMemConfig begin, comm_name=%s, local rank_id=%u, rank_table=%s",
-         config.hcclCommName, local_rank, rank_table.c_str());
+  LLMLOGI("HcclCommInitClusterInfoMemConfig begin, comm_name=%s, local rank_id=%u, rank_table size=%zu",
+         config.hcclCommName, local_rank, rank_table.size());
+  LLMLOGD("rank_table=%s", rank_table.c_str());
   HcclComm comm{};
-  HcclResult ret = HcclAdapter::GetInstance().HcclCommInitClusterInfoMemConfig(rank_table.c_str(), local_rank,
-                                                                               &config, &comm);
+  const auto init_start = std::chrono::steady_clock::now();
+  HcclResult ret = HcclResult::HCCL_SUCCESS;
+  {
+    HcclCommInitGate::Guard init_guard;
+    ret = HcclAdapter::GetInstance().HcclCommInitClusterInfoMemConfig(rank_table.c_str(), local_rank, &config, &comm);
+  }
   LLM_CHK_BOOL_RET_STATUS(ret == HcclResult::HCCL_SUCCESS, ge::LLM_LINK_FAILED,
                          "Call HcclCommInitClusterInfoMemConfig failed, ret:%d.", ret);
 
   comm_id = GenerateCommId();
+  // taken before map_mutex_, queries of other comms do not wait for the handle list
+  auto mem_handles = comm_mem_manager_->GetAllRegisterMemHandles();
   {
     std::lock_guard<std::mutex> map_lock(map_mutex_);
     auto &comm_status = comm_to_status_[comm_id];
     comm_status.unlink_flag.store(false);
     comm_status.prepare_mem_flag.store(false);
     comm_status.status = RegisterMemoryStatus::PREPARING;
-    PrepareMemArg prepare_mem_arg{comm_id, comm, cluster2rank, comm_mem_manager_->GetAllRegisterMemHandles(), 
-                                  link_total_time_, link_retry_count_};
+    PrepareMemArg prepare_mem_arg{comm_id, comm, cluster2rank, std::move(mem_handles), link_total_time_,
+                                  link_retry_count_};
     auto fut = thread_pool_.commit(&CommLinkManager::PrepareMemTask, this, prepare_mem_arg);
     comm_status.task_fut = std::move(fut);
   }
-  LLMLOGI("Init comm success, comm id:%lu.", comm_id);
+  const auto init_cost =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - init_start).count();
+  LLMLOGI("Init comm success, comm name:%s, comm id:%lu, cost:%ld us.", config.hcclCommName, comm_id, init_cost);
   return ge::SUCCESS;
 }
 
 ge::Status CommLinkManager::Unlink(uint64_t comm_id) {
   ge::Status ret;
-  // lock for process
+  // link no longer takes this lock, a comm id is only known to unlink once its link finished
   std::lock_guard<std::mutex> lock(mutex_);
   {
     std::lock_guard<std::mutex> map_lock(map_mutex_);
     auto iter = comm_to_status_.find(comm_id);
     LLM_CHK_BOOL_RET_STATUS(iter != comm_to_status_.end(), ge::LLM_NOT_YET_LINK, "Comm:%lu is not yet link.", comm_id);
     iter->second.unlink_flag.store(true);
+    // prepare mem holds its flag while the comm is prepared, a failed HcclCommPrepare is not retried any more
+    if (iter->second.comm_ptr != nullptr) {
+      iter->second.comm_ptr->stop_flag_ = true;
+    }
   }
   LLMLOGI("Start unlink, comm_id:%lu", comm_id);
   while (true) {
@@ -22,6 +22,7 @@
 namespace llm {
 constexpr const char_t *kLinkThreadNamePrefix = "ge_llm_link";
 constexpr size_t kLinkThreadNum = 16U;
+constexpr uint32_t kMaxLinkConcurrency = 64U;
 
 struct PrepareMemArg {
   uint64_t comm_id;
@@ -76,13 +77,15 @@ class CommLinkManager {
 
  private:
   void FreeFlagGuard(PrepareMemArg &req);
-  void FlagGuard(PrepareMemArg &req);
   void CheckUnlink(PrepareMemArg &req, bool &check_unlink_flag);
   ge::Status PrepareMem(PrepareMemArg &req);
   ge::Status ExchangeMem(const EntityPtr &entity, uint32_t local_rank, uint32_t remote_rank) const;
+  ge::Status ExchangeMemWithPeers(PrepareMemArg &req, const EntityCommInfoPtr &comm_info_ptr,
+                                  const std::vector<std::pair<EntityPtr, uint32_t>> &peers);
+  bool IsUnlinking(uint64_t comm_id);
   static void SetMemAttribute(const ExchangeMemInfo &remote_mem_info, std::vector<HcclMem> &remote_mems, HcclMem &mem);
   ge::Status DestroyRes(EntityCommInfoPtr comm_ptr, std::vector<EntityPtr> &comm_entities) const;
-  ge::Status PrepareComm(const PrepareMemArg &req, EntityCommInfoPtr &comm_info_ptr);
+  ge::Status CreateCommInfo(const PrepareMemArg &req, EntityCommInfoPtr &comm_info_ptr);
   uint64_t GenerateCommId();
   ge::Status CreateClustersEntity(PrepareMemArg &req, std::map<uint64_t, EntityPtr> &cluster2entity);
 
@@ -92,6 +95,10 @@ class CommLinkManager {
   uint64_t cluster_id_;
   int32_t link_total_time_ = 0;
   int32_t link_retry_count_ = 1;
+  // concurrent hccl comm init calls, llm.LinkConcurrency 1 makes them serial
+  uint32_t link_concurrency_ = kDefaultCommInitConcurrency;
+  // links passed the link num check but not yet in comm_to_status_
+  uint32_t pending_link_num_ = 0U;
   CommEntityManager *comm_entity_manager_{};
   CommMemManager *comm_mem_manager_{};
   CacheManager *cache_manager_{};
@@ -99,7 +106,7 @@ class CommLinkManager {
   int32_t device_id_{-1};
   aclrtContext aclrt_context_{nullptr};
   bool remote_cache_accessible_;
-  // process mutex
+  // serializes unlink
   std::mutex mutex_;
   std::mutex map_mutex_;
   uint32_t rdmaTrafficClass_{0U};
@@ -0,0 +1,221 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "entity_scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <pthread.h>
+#include "llm_datadist/llm_error_codes.h"
+#include "common/llm_checker.h"
+#include "common/llm_log.h"
+
+namespace llm {
+namespace {
+void InitSchedulerThread(const std::string &thread_name, const EntityScheduler::ThreadInitFunc &thread_init_func) {
+  (void) pthread_setname_np(pthread_self(), thread_name.c_str());
+  if (thread_init_func != nullptr) {
+    thread_init_func();
+  }
+}
+}  // namespace
+
+EntityScheduler::~EntityScheduler() {
+  Stop();
+}
+
+ge::Status EntityScheduler::Start(const std::string &thread_name, const ThreadInitFunc &thread_init_func) {
+  LLM_CHK_BOOL_RET_STATUS(options_.worker_num > 0U, ge::LLM_PARAM_INVALID, "worker_num must be positive");
+  LLM_CHK_BOOL_RET_STATUS(process_func_ != nullptr, ge::LLM_PARAM_INVALID, "process func is nullptr");
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LLM_CHK_BOOL_RET_STATUS(!running_, ge::FAILED, "entity scheduler is already started");
+    running_ = true;
+  }
+  poll_thread_ = std::thread(&EntityScheduler::PollLoop, this, thread_name + "_poll", thread_init_func);
+  for (uint32_t i = 0U; i < options_.worker_num; ++i) {
+    work_threads_.emplace_back(&EntityScheduler::WorkLoop, this, thread_name + "_" + std::to_string(i),
+                               thread_init_func);
+  }
+  LLMLOGI("entity scheduler started, worker_num = %u, spin_time_us = %lu, max_sleep_time_us = %lu",
+          options_.worker_num, options_.spin_time_us, options_.max_sleep_time_us);
+  return ge::SUCCESS;
+}
+
+void EntityScheduler::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  poll_cv_.notify_all();
+  ready_cv_.notify_all();
+  if (poll_thread_.joinable()) {
+    poll_thread_.join();
+  }
+  for (auto &work_thread : work_threads_) {
+    if (work_thread.joinable()) {
+      work_thread.join();
+    }
+  }
+  work_threads_.clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  slots_.clear();
+  ready_queue_.clear();
+  watched_num_ = 0U;
+}
+
+void EntityScheduler::Watch(uint64_t id, ProbeFunc probe_func) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = slots_.find(id);
+    if (it == slots_.end()) {
+      it = slots_.emplace(id, Slot{}).first;
+      ++watched_num_;
+    }
+    // a slot still running keeps its state, the worker counts it as watched when the step returns
+    it->second.probe_func = std::move(probe_func);
+    it->second.removed = false;
+    poll_wakeup_ = true;
+  }
+  poll_cv_.notify_one();
+}
+
+void EntityScheduler::Unwatch(uint64_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = slots_.find(id);
+  if (it == slots_.end()) {
+    return;
+  }
+  if (it->second.state == SlotState::kRunning) {
+    it->second.removed = true;
+    return;
+  }
+  if (it->second.state == SlotState::kWatched) {
+    --watched_num_;
+  }
+  // a stale id left in the ready queue is skipped by the workers
+  (void) slots_.erase(it);
+}
+
+void EntityScheduler::Notify(uint64_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = slots_.find(id);
+  if (it == slots_.end()) {
+    return;
+  }
+  if (it->second.state == SlotState::kWatched) {
+    MakeReady(id, it->second);
+  } else if ((it->second.state == SlotState::kRunning) && (!it->second.removed)) {
+    it->second.notified = true;
+  }
+}
+
+EntityScheduler::PollStats EntityScheduler::GetPollStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PollStats stats = poll_stats_;
+  stats.watched_num = watched_num_;
+  return stats;
+}
+
+void EntityScheduler::MakeReady(uint64_t id, Slot &slot) {
+  slot.state = SlotState::kReady;
+  --watched_num_;
+  ready_queue_.push_back(id);
+  ready_cv_.notify_one();
+}
+
+bool EntityScheduler::PollOnce() {
+  ++poll_stats_.poll_rounds;
+  bool found = false;
+  for (auto &it : slots_) {
+    if ((it.second.state == SlotState::kWatched) && it.second.probe_func()) {
+      MakeReady(it.first, it.second);
+      found = true;
+    }
+  }
+  return found;
+}
+
+void EntityScheduler::PollLoop(const std::string &thread_name, const ThreadInitFunc &thread_init_func) {
+  InitSchedulerThread(thread_name, thread_init_func);
+  const auto spin_time = std::chrono::microseconds(options_.spin_time_us);
+  auto last_active_time = std::chrono::steady_clock::now();
+  uint64_t sleep_time_us = 1UL;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    if (watched_num_ == 0U) {
+      // every entity is running or queued, nothing to probe until one comes back
+      poll_cv_.wait(lock, [this]() { return (!running_) || (watched_num_ > 0U); });
+      poll_wakeup_ = true;
+      continue;
+    }
+    const bool found = PollOnce();
+    if (found || poll_wakeup_) {
+      // traffic is likely to follow, spin again before backing off
+      poll_wakeup_ = false;
+      last_active_time = std::chrono::steady_clock::now();
+      sleep_time_us = 1UL;
+      continue;
+    }
+    if (std::chrono::steady_clock::now() - last_active_time < spin_time) {
+      lock.unlock();
+      std::this_thread::yield();
+      lock.lock();
+      continue;
+    }
+    const uint64_t wait_time_us = std::min(sleep_time_us, options_.max_sleep_time_us);
+    ++poll_stats_.sleeps;
+    poll_stats_.last_sleep_us = wait_time_us;
+    (void) poll_cv_.wait_for(lock, std::chrono::microseconds(wait_time_us),
+                             [this]() { return (!running_) || poll_wakeup_; });
+    sleep_time_us = std::min(sleep_time_us * 2UL, std::max(options_.max_sleep_time_us, 1UL));
+  }
+}
+
+void EntityScheduler::WorkLoop(const std::string &thread_name, const ThreadInitFunc &thread_init_func) {
+  InitSchedulerThread(thread_name, thread_init_func);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    ready_cv_.wait(lock, [this]() { return (!running_) || (!ready_queue_.empty()); });
+    if (!running_) {
+      break;
+    }
+    const uint64_t id = ready_queue_.front();
+    ready_queue_.pop_front();
+    auto it = slots_.find(id);
+    if ((it == slots_.end()) || (it->second.state != SlotState::kReady)) {
+      continue;
+    }
+    it->second.state = SlotState::kRunning;
+    it->second.notified = false;
+    lock.unlock();
+    const bool run_again = process_func_(id);
+    lock.lock();
+    it = slots_.find(id);
+    if (it == slots_.end()) {
+      continue;
+    }
+    if (it->second.removed) {
+      (void) slots_.erase(it);
+      continue;
+    }
+    if (run_again || it->second.notified) {
+      // requeued behind other ready entities so a long transfer does not starve them
+      it->second.state = SlotState::kReady;
+      it->second.notified = false;
+      ready_queue_.push_back(id);
+    } else {
+      it->second.state = SlotState::kWatched;
+      ++watched_num_;
+      poll_wakeup_ = true;
+      poll_cv_.notify_one();
+    }
+  }
+}
+}  // namespace llm
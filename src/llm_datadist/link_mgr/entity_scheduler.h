@@ -0,0 +1,96 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_ENTITY_SCHEDULER_H_
+#define CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_ENTITY_SCHEDULER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "common/llm_inner_types.h"
+
+namespace llm {
+struct EntitySchedulerOptions {
+  uint32_t worker_num = 1U;              // threads running entity state machines
+  uint64_t spin_time_us = 1000UL;        // doorbells are polled back to back this long after the last ready entity
+  uint64_t max_sleep_time_us = 200UL;    // upper bound of the backoff between polls once spinning stopped
+};
+
+// Runs entity state machines from a ready queue. Request flags are written by the remote side with one sided
+// writes, so no local event exists for them: a doorbell thread probes idle entities, spinning for a while after
+// traffic and backing off to sleeps when quiet, and blocks when nothing is watched. An entity is either watched,
+// ready or running, so it is never processed by two workers at once.
+class EntityScheduler {
+ public:
+  // cheap readiness check, called by the doorbell thread without holding any entity lock
+  using ProbeFunc = std::function<bool()>;
+  // advances the entity, returns true while it has work in progress and must be run again
+  using ProcessFunc = std::function<bool(uint64_t)>;
+  // called once in every scheduler thread before it starts
+  using ThreadInitFunc = std::function<void()>;
+  struct PollStats {
+    uint64_t poll_rounds = 0UL;    // passes over the watched entities
+    uint64_t sleeps = 0UL;         // backoff sleeps once spinning stopped
+    uint64_t last_sleep_us = 0UL;
+    size_t watched_num = 0UL;
+  };
+
+  EntityScheduler(EntitySchedulerOptions options, ProcessFunc process_func)
+      : options_(options), process_func_(std::move(process_func)) {}
+  ~EntityScheduler();
+  EntityScheduler(const EntityScheduler &) = delete;
+  EntityScheduler &operator=(const EntityScheduler &) = delete;
+
+  ge::Status Start(const std::string &thread_name, const ThreadInitFunc &thread_init_func = nullptr);
+  void Stop();
+  void Watch(uint64_t id, ProbeFunc probe_func);
+  // the entity is dropped once its running step returns, Unwatch does not wait for it
+  void Unwatch(uint64_t id);
+  // makes the entity ready without probing, for events raised locally
+  void Notify(uint64_t id);
+  PollStats GetPollStats();
+
+ private:
+  enum class SlotState : int32_t { kWatched, kReady, kRunning };
+  struct Slot {
+    ProbeFunc probe_func;
+    SlotState state = SlotState::kWatched;
+    bool notified = false;
+    // unwatched while running, the worker drops it when the step returns unless it is watched again
+    bool removed = false;
+  };
+
+  void PollLoop(const std::string &thread_name, const ThreadInitFunc &thread_init_func);
+  void WorkLoop(const std::string &thread_name, const ThreadInitFunc &thread_init_func);
+  // returns true if any entity became ready
+  bool PollOnce();
+  void MakeReady(uint64_t id, Slot &slot);
+
+  EntitySchedulerOptions options_;
+  ProcessFunc process_func_;
+  std::mutex mutex_;
+  std::condition_variable poll_cv_;
+  std::condition_variable ready_cv_;
+  std::unordered_map<uint64_t, Slot> slots_;
+  std::deque<uint64_t> ready_queue_;
+  size_t watched_num_ = 0U;
+  PollStats poll_stats_;
+  bool poll_wakeup_ = false;
+  bool running_ = false;
+  std::thread poll_thread_;
+  std::vector<std::thread> work_threads_;
+};
+}  // namespace llm
+#endif  // CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_ENTITY_SCHEDULER_H_
@@ -292,15 +292,13 @@ ge::Status LinkMsgHandler::SetEntityMemInfo(const LLMExchangeInfo &peer_exchange
 
 ge::Status LinkMsgHandler::ExchangeInfoProcess(const LLMExchangeInfo &peer_exchange_info, int32_t timeout,
                                                bool force_link, EntityMemInfoPtr &mem_info_ptr) {
-  auto rank_table_generator = RankTableGeneratorFactory::Create(local_comm_res_, peer_exchange_info.comm_res);
-  LLM_CHK_BOOL_RET_STATUS(rank_table_generator != nullptr, ge::LLM_PARAM_INVALID,
-                         "Failed to create rank table generator.");
-  std::string rank_table;
-  LLM_CHK_STATUS_RET(rank_table_generator->Generate(device_id_, rank_table), "Failed to generate rank table");
-  auto local_rank_id = rank_table_generator->GetLocalRankId();
+  CachedRankTable cached_rank_table{};
+  LLM_CHK_STATUS_RET(rank_table_cache_.Get(device_id_, local_comm_res_, peer_exchange_info.comm_res, cached_rank_table),
+                    "Failed to generate rank table");
+  auto local_rank_id = cached_rank_table.local_rank_id;
   LLM_CHK_BOOL_RET_STATUS(local_rank_id >= 0, ge::LLM_PARAM_INVALID,
                          "Failed to get local rank id, please check rank table.");
-  auto peer_rank_id = rank_table_generator->GetPeerRankId();
+  auto peer_rank_id = cached_rank_table.peer_rank_id;
   if (force_link) {
     LLM_CHK_STATUS_RET(comm_entity_manager_->DestroyEntity(peer_exchange_info.cluster_id),
                       "Failed to destroy previous entity, peer cluster id:%lu.",
@@ -318,7 +316,7 @@ ge::Status LinkMsgHandler::ExchangeInfoProcess(const LLMExchangeInfo &peer_excha
   comm_params.comm_config = comm_config_;
   LLM_ASSERT_EOK(strcpy_s(comm_params.comm_config.hcclCommName, COMM_NAME_MAX_LENGTH,
                          peer_exchange_info.comm_name.c_str()));
-  comm_params.rank_table = rank_table;
+  comm_params.rank_table = std::move(cached_rank_table.rank_table);
   comm_params.mem_handles = comm_mem_manager_->GetAllRegisterMemHandles();
   constexpr uint32_t kTimeInSec = 1000;
   auto left_time = timeout % kTimeInSec == 0 ? 0 : 1;
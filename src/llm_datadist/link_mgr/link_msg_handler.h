@@ -19,6 +19,7 @@
 #include "cache_mgr/comm_mem_manager.h"
 #include "cache_mgr/cache_manager.h"
 #include "common/msg_handler_plugin.h"
+#include "common/rank_table_cache.h"
 
 namespace llm {
 enum class LinkMsgType : int32_t {
@@ -107,6 +108,7 @@ class LinkMsgHandler {
   std::mutex mutex_;
   std::string local_ip_;
   std::string local_comm_res_;
+  RankTableCache rank_table_cache_;
 };
 }  // namespace llm
 #endif  // CANN_GRAPH_ENGINE_RUNTIME_LLM_DATADIST_V2_LINK_MSG_HANDLER_H_
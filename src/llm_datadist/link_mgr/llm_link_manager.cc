@@ -9,6 +9,8 @@
  */
 
 #include "llm_link_manager.h"
+#include <algorithm>
+#include <chrono>
 #include "common/llm_checker.h"
 #include "common/llm_utils.h"
 #include "common/llm_thread_pool.h"
@@ -22,7 +24,7 @@ void LLMLinkManager::Finalize() {
 
 ge::Status LLMLinkManager::Initialize(const std::map<ge::AscendString, ge::AscendString> &options) {
   LLM_ASSERT_RT_OK(aclrtGetCurrentContext(&aclrt_context_));
-  CommLinkManager::Initialize(options);
+  LLM_CHK_STATUS_RET(CommLinkManager::Initialize(options), "Failed to init comm link manager");
   LLM_CHK_STATUS_RET(msg_handler_.Initialize(options), "Failed to init msg handler");
   const auto &iter = options.find(kLlmOptionListenPort);
   if (iter != options.cend()) {
@@ -46,16 +48,33 @@ ge::Status LLMLinkManager::LinkClusters(const std::vector<ClusterInfo> &clusters
                                         std::vector<ge::Status> &rets,
                                         int32_t timeout) {
   LLM_CHK_BOOL_RET_STATUS(clusters.size() > 0, ge::LLM_PARAM_INVALID, "clusters size must > 0");
-  LLMThreadPool thread_pool("llm_link_mem", 16U);
+  const auto start = std::chrono::steady_clock::now();
+  const auto thread_num = static_cast<uint32_t>(std::min(kLinkThreadNum, clusters.size()));
+  LLMThreadPool thread_pool("llm_link_mem", thread_num);
   std::vector<std::future<ge::Status>> fut_rets;
-  for (const auto &cluster : clusters) {
-    auto fut = thread_pool.commit([this, cluster, timeout]() -> ge::Status {
+  for (size_t i = 0U; i < clusters.size(); ++i) {
+    auto fut = thread_pool.commit([this, cluster = clusters[i], i, timeout, start]() -> ge::Status {
       LLM_CHK_BOOL_RET_STATUS(aclrtSetCurrentContext(aclrt_context_) == ACL_ERROR_NONE, ge::LLM_PARAM_INVALID,
                              "Set aclrt context failed.");
-      LLM_CHK_STATUS_RET(msg_handler_.LinkCluster(cluster, timeout),
-                        "Failed to link cluster, remote_cluster_id = %lu, remote_role_type = %d.",
-                        cluster.remote_cluster_id, cluster.remote_role_type);
-      return ge::SUCCESS;
+      // the timeout also covers the time queued behind other clusters
+      const auto queued_time =
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+      auto ret = ge::LLM_TIMEOUT;
+      if ((timeout <= 0) || (queued_time < timeout)) {
+        const int32_t left_time = timeout > 0 ? timeout - static_cast<int32_t>(queued_time) : timeout;
+        ret = msg_handler_.LinkCluster(cluster, left_time);
+      }
+      const auto cost =
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+      if (ret == ge::SUCCESS) {
+        LLMEVENT("Link cluster success, index = %zu, remote_cluster_id = %lu, queued = %ld ms, cost = %ld ms.", i,
+                 cluster.remote_cluster_id, queued_time, cost);
+      } else {
+        LLMLOGE(ret, "Failed to link cluster, index = %zu, remote_cluster_id = %lu, remote_role_type = %d, "
+                "queued = %ld ms, cost = %ld ms, timeout = %d ms.", i, cluster.remote_cluster_id,
+                cluster.remote_role_type, queued_time, cost, timeout);
+      }
+      return ret;
     });
     fut_rets.emplace_back(std::move(fut));
   }
@@ -64,7 +83,6 @@ ge::Status LLMLinkManager::LinkClusters(const std::vector<ClusterInfo> &clusters
   for (size_t i = 0; i < fut_rets.size(); ++i) {
     auto fut_ret = fut_rets[i].get();
     ret = fut_ret != ge::SUCCESS ? fut_ret : ret;
-    LLM_CHK_STATUS(fut_ret, "Failed to link clusters, index = %zu", i);
     rets.emplace_back(fut_ret);
   }
   return ret;
@@ -75,7 +93,8 @@ ge::Status LLMLinkManager::UnlinkClusters(const std::vector<ClusterInfo> &cluste
                                           int32_t timeout,
                                           bool force_flag) {
   LLM_CHK_BOOL_RET_STATUS(clusters.size() > 0, ge::LLM_PARAM_INVALID, "clusters size must > 0");
-  LLMThreadPool thread_pool("llm_link_mem", 16U);
+  const auto thread_num = static_cast<uint32_t>(std::min(kLinkThreadNum, clusters.size()));
+  LLMThreadPool thread_pool("llm_link_mem", thread_num);
   std::vector<std::future<ge::Status>> fut_rets;
   for (const auto &cluster : clusters) {
     auto fut = thread_pool.commit([this, cluster, timeout, force_flag]() -> ge::Status {
@@ -38,7 +38,10 @@ ge::Status LLMDataDistV2::DoInnerInitialize(int32_t device_id,
   LLMEVENT("Switch new aclrt ctx:%p, device_id:%d", aclrt_context_, device_id_);
   LLM_CHK_STATUS_RET(data_cache_engine_->Initialize(options), "DataCacheEngine initialize failed.");
   LLM_CHK_STATUS_RET(llm_link_mgr_->Initialize(options), "CommLinkManager initialize failed.");
-  LLM_CHK_STATUS_RET(comm_entity_manager_->Initialize(!remote_cache_accessible),
+  EntitySchedulerOptions scheduler_options{};
+  LLM_CHK_STATUS_RET(CommEntityManager::ParseSchedulerOptions(options, scheduler_options),
+                    "parse %s failed", LLM_OPTION_FSM_SCHEDULER_CONFIG);
+  LLM_CHK_STATUS_RET(comm_entity_manager_->Initialize(!remote_cache_accessible, scheduler_options),
                     "CommEntityManager initialize failed.");
 
   LlmDatadistTimer::Instance().Init();
@@ -327,6 +330,26 @@ ge::Status LLMDataDistV2::TransferCache(const uint64_t task_id, const TransferCa
   return ge::SUCCESS;
 }
 
+ge::Status LLMDataDistV2::TransferCacheByLayers(const uint64_t task_id,
+                                                const TransferCacheConfig &transfer_cache_config,
+                                                const TransferBlockConfig &transfer_block_config,
+                                                const uint64_t layer_num,
+                                                const LayerReadyCallback &callback,
+                                                std::shared_ptr<LayerTransferProgress> &progress) {
+  LLM_CHK_BOOL_RET_STATUS(is_initialized_.load(std::memory_order::memory_order_relaxed), ge::FAILED,
+                         "Llm datadist of cluster:%lu is not initialized.", cluster_id_);
+  LLM_CHK_BOOL_RET_STATUS(transfer_cache_config.tensor_num_per_layer > 0UL,
+                         ge::LLM_PARAM_INVALID, "tensor_num_per_layer is invalid, must > 0");
+  LLM_CHK_STATUS_RET(data_cache_engine_->TransferCacheByLayers(task_id, transfer_cache_config, transfer_block_config,
+                                                              layer_num, callback, progress),
+                    "task:%lu of cluster:%lu transfer cache of layers[%lu, %lu) failed", task_id,
+                    transfer_cache_config.cluster_id, transfer_cache_config.layer_index,
+                    transfer_cache_config.layer_index + layer_num);
+  LLMLOGI("task:%lu of cluster:%lu transfer cache of %lu layers submitted", task_id, transfer_cache_config.cluster_id,
+         layer_num);
+  return ge::SUCCESS;
+}
+
 ge::Status LLMDataDistV2::UnregisterCache(int64_t cache_id) {
   LLM_CHK_BOOL_RET_STATUS(is_initialized_.load(std::memory_order::memory_order_relaxed), ge::FAILED,
                          "Llm datadist of cluster:%lu is not initialized.", cluster_id_);
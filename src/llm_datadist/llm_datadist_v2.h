@@ -60,6 +60,11 @@ class LLMDataDistV2  {
   ge::Status TransferCache(const uint64_t task_id, const TransferCacheConfig &transfer_cache_config,
                            const TransferBlockConfig &transfer_block_config);
 
+  ge::Status TransferCacheByLayers(const uint64_t task_id, const TransferCacheConfig &transfer_cache_config,
+                                   const TransferBlockConfig &transfer_block_config, const uint64_t layer_num,
+                                   const LayerReadyCallback &callback,
+                                   std::shared_ptr<LayerTransferProgress> &progress);
+
   ge::Status LinkClusters(const std::vector<ClusterInfo> &clusters, std::vector<ge::Status> &rets,
                           const int32_t timeout);
 
@@ -0,0 +1,170 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef H7E2B4C19_5A0D_4F63_9C1E_3B8D6A2F4E71
+#define H7E2B4C19_5A0D_4F63_9C1E_3B8D6A2F4E71
+
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "memory/span/span_layer_id.h"
+
+namespace llm {
+// Hierarchical bitmap of non-empty span layers, bit i of levels_[0] is set when layer i holds free spans,
+// bit j of levels_[k + 1] is set when word j of levels_[k] is not zero. The top level is a single word, so
+// a pool of 256K pages needs two levels, and lookup is one find-first-set per level up and down.
+class SpanLayerBitmap {
+  using Word = uint64_t;
+  static constexpr size_t kWordBits = 64U;
+  static constexpr size_t kWordShift = 6U;
+  static constexpr size_t kBitMask = kWordBits - 1U;
+
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = SpanLayerId;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const SpanLayerId *;
+    using reference = SpanLayerId;
+
+    Iterator(const SpanLayerBitmap &bitmap, SpanLayerId layer_id) noexcept
+        : bitmap_{&bitmap}, layer_id_{layer_id} {
+    }
+
+    SpanLayerId operator*() const noexcept {
+      return layer_id_;
+    }
+
+    Iterator &operator++() noexcept {
+      layer_id_ = bitmap_->FindFirst(layer_id_ + 1U);
+      return *this;
+    }
+
+    bool operator==(const Iterator &rhs) const noexcept {
+      return layer_id_ == rhs.layer_id_;
+    }
+
+    bool operator!=(const Iterator &rhs) const noexcept {
+      return !(*this == rhs);
+    }
+
+   private:
+    const SpanLayerBitmap *bitmap_;
+    SpanLayerId layer_id_;
+  };
+
+  explicit SpanLayerBitmap(size_t capacity = 0U) {
+    Resize(capacity);
+  }
+
+  void Resize(size_t capacity) {
+    capacity_ = capacity;
+    count_ = 0U;
+    levels_.clear();
+    size_t bit_num = capacity;
+    while (bit_num > 0U) {
+      const size_t word_num = (bit_num + kBitMask) >> kWordShift;
+      levels_.emplace_back(word_num, 0U);
+      bit_num = (word_num > 1U) ? word_num : 0U;
+    }
+  }
+
+  void Set(SpanLayerId layer_id) {
+    if ((layer_id >= capacity_) || Test(layer_id)) {
+      return;
+    }
+    size_t index = layer_id;
+    for (auto &level : levels_) {
+      Word &word = level[index >> kWordShift];
+      const bool was_empty = (word == 0U);
+      word |= Word{1U} << (index & kBitMask);
+      if (!was_empty) {
+        break;
+      }
+      index >>= kWordShift;
+    }
+    ++count_;
+  }
+
+  void Reset(SpanLayerId layer_id) {
+    if (!Test(layer_id)) {
+      return;
+    }
+    size_t index = layer_id;
+    for (auto &level : levels_) {
+      Word &word = level[index >> kWordShift];
+      word &= ~(Word{1U} << (index & kBitMask));
+      if (word != 0U) {
+        break;
+      }
+      index >>= kWordShift;
+    }
+    --count_;
+  }
+
+  bool Test(SpanLayerId layer_id) const {
+    return (layer_id < capacity_) &&
+           ((levels_[0U][layer_id >> kWordShift] & (Word{1U} << (layer_id & kBitMask))) != 0U);
+  }
+
+  // smallest set layer id not less than layer_id, same as std::set::lower_bound
+  SpanLayerId FindFirst(SpanLayerId layer_id) const {
+    if (layer_id >= capacity_) {
+      return SPAN_LAYER_ID_INVALID;
+    }
+    size_t index = layer_id;
+    for (size_t level_index = 0U; level_index < levels_.size(); ++level_index) {
+      const auto &level = levels_[level_index];
+      const size_t word_index = index >> kWordShift;
+      if (word_index >= level.size()) {
+        break;
+      }
+      const Word word = level[word_index] & (~Word{0U} << (index & kBitMask));
+      if (word != 0U) {
+        size_t found = (word_index << kWordShift) + static_cast<size_t>(__builtin_ctzll(word));
+        while (level_index > 0U) {
+          --level_index;
+          found = (found << kWordShift) + static_cast<size_t>(__builtin_ctzll(levels_[level_index][found]));
+        }
+        return static_cast<SpanLayerId>(found);
+      }
+      index = word_index + 1U;
+    }
+    return SPAN_LAYER_ID_INVALID;
+  }
+
+  void Clear() {
+    for (auto &level : levels_) {
+      level.assign(level.size(), 0U);
+    }
+    count_ = 0U;
+  }
+
+  size_t Count() const {
+    return count_;
+  }
+
+  Iterator begin() const {
+    return Iterator(*this, FindFirst(0U));
+  }
+
+  Iterator end() const {
+    return Iterator(*this, SPAN_LAYER_ID_INVALID);
+  }
+
+ private:
+  size_t capacity_{0U};
+  size_t count_{0U};
+  std::vector<std::vector<Word>> levels_;
+};
+}
+
+#endif
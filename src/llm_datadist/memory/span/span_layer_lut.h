@@ -12,16 +12,16 @@
 #define H46CE8BDB_A361_403B_AB8B_D4CFAE40604E
 
 #include <vector>
-#include <set>
 #include "memory/span/span_layer.h"
 #include "memory/span/span_allocator.h"
+#include "memory/span/span_layer_bitmap.h"
 
 namespace llm {
 class SpanLayerLut {
-  using SpanLayerIdIterator = std::set<SpanLayerId>::iterator;
+  using SpanLayerIdIterator = SpanLayerBitmap::Iterator;
  public:
   explicit SpanLayerLut(const std::vector<SpanLayer *> &span_layers)
-      : span_layers_{span_layers} {
+      : span_layer_ids_{span_layers.size()}, span_layers_{span_layers} {
   }
 
  public:
@@ -33,14 +33,6 @@ class SpanLayerLut {
   virtual ~SpanLayerLut() = default;
 
  public:
-  SpanLayerIdIterator begin() {
-    return span_layer_ids_.begin();
-  }
-
-  SpanLayerIdIterator end() {
-    return span_layer_ids_.end();
-  }
-
   SpanLayerIdIterator begin() const {
     return span_layer_ids_.begin();
   }
@@ -49,12 +41,12 @@ class SpanLayerLut {
     return span_layer_ids_.end();
   }
 
-  size_t size() {
-    return span_layer_ids_.size();
+  size_t size() const {
+    return span_layer_ids_.Count();
   }
 
  protected:
-  std::set<SpanLayerId> span_layer_ids_;
+  SpanLayerBitmap span_layer_ids_;
   const std::vector<SpanLayer *> &span_layers_;
 };
 
@@ -67,20 +59,19 @@ class SpanLayerQuickLut : public SpanLayerLut {
   }
   void OnLayerAddSpan(const SpanLayer &layer) override {
     if (layer.GetSize() == 1) {
-      span_layer_ids_.emplace(layer.GetLayerId());
+      span_layer_ids_.Set(layer.GetLayerId());
     }
   }
   void OnLayerRemoveSpan(const SpanLayer &layer) override {
     if (layer.IsEmpty()) {
-      span_layer_ids_.erase(layer.GetLayerId());
+      span_layer_ids_.Reset(layer.GetLayerId());
     }
   }
   SpanLayerId FindFitLayerId(PageLen page_len, size_t max_lift_level) const override {
     if (max_lift_level == 0U) {
       return SPAN_LAYER_ID_INVALID;
     }
-    auto layer_idIter = span_layer_ids_.lower_bound(page_len);
-    return (layer_idIter == span_layer_ids_.end()) ? SPAN_LAYER_ID_INVALID : *layer_idIter;
+    return span_layer_ids_.FindFirst(page_len);
   }
   void Release(SpanAllocator &span_allocator) override {
     for (auto &layer : span_layers_) {
@@ -88,7 +79,7 @@ class SpanLayerQuickLut : public SpanLayerLut {
         layer->Release(span_allocator);
       }
     }
-    span_layer_ids_.clear();
+    span_layer_ids_.Clear();
   }
 };
 }
@@ -117,6 +117,7 @@ class LlmConfig(object):
         self._buf_pool_cfg = ""
         self._mem_pool_cfg = ""
         self._host_mem_pool_cfg = ""
+        self._disk_tier_cfg = ""
         self._enable_cache_manager = None
         self._enable_remote_cache_accessible = None
         self._rdma_traffic_class = None
@@ -153,6 +154,8 @@ class LlmConfig(object):
             self._options["llm.MemPoolConfig"] = str(self._mem_pool_cfg)
         if self._host_mem_pool_cfg:
             self._options["llm.HostMemPoolConfig"] = str(self._host_mem_pool_cfg)
+        if self._disk_tier_cfg:
+            self._options["llm.DiskTierConfig"] = str(self._disk_tier_cfg)
         if self._enable_cache_manager is not None:
             self._options["llm.EnableCacheManager"] = "1" if self._enable_cache_manager else "0"
         if self._enable_remote_cache_accessible is not None:
@@ -349,6 +352,15 @@ class LlmConfig(object):
         check_isinstance("host_mem_pool_cfg", host_mem_pool_cfg, str)
         self._host_mem_pool_cfg = host_mem_pool_cfg
 
+    @property
+    def disk_tier_cfg(self) -> str:
+        return self._disk_tier_cfg
+
+    @disk_tier_cfg.setter
+    def disk_tier_cfg(self, disk_tier_cfg: str):
+        check_isinstance("disk_tier_cfg", disk_tier_cfg, str)
+        self._disk_tier_cfg = disk_tier_cfg
+
     @property
     def rdma_traffic_class(self) -> str:
         return self._rdma_traffic_class
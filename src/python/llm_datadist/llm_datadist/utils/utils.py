@@ -20,6 +20,7 @@ _MAX_UINT32 = ctypes.c_uint32(2**32 - 1).value
 _MAX_INT64 = ctypes.c_int64(2**63 - 1).value
 _MIN_INT64 = ctypes.c_int64(0 - 2**63).value
 _MAX_UINT64 = ctypes.c_uint64(2**64 - 1).value
+_INT64_BUFFER_FORMATS = ('q', 'l')
 
 
 def check_inner(arg_name, arg_value, inner_class):
@@ -58,6 +59,34 @@ def check_isinstance(arg_name, arg_value, classes, inner_class=None, extra_fmt="
     return arg_value
 
 
+def int64_buffer_shape(arg_name, arg_value):
+    """
+    numpy array, array.array('q') and memoryview are passed to wrapper as a whole int64 buffer
+    Returns:
+        shape of buffer, or None if arg_value does not support buffer protocol
+    """
+    if arg_value is None or isinstance(arg_value, (list, tuple, dict, str, bytes, bytearray)):
+        return None
+    try:
+        view = memoryview(arg_value)
+    except TypeError:
+        return None
+    with view:
+        if view.itemsize != 8 or view.format.lstrip('@=<') not in _INT64_BUFFER_FORMATS or not view.c_contiguous:
+            raise TypeError(f"{arg_name} only support contiguous int64 buffer, "
+                            f"but got format:{view.format}, itemsize:{view.itemsize}.")
+        return view.shape
+
+
+def check_int_sequence(arg_name, arg_value, allow_none: bool = True):
+    shape = int64_buffer_shape(arg_name, arg_value)
+    if shape is None:
+        return check_isinstance(arg_name, arg_value, [list, tuple], int, allow_none=allow_none)
+    if len(shape) != 1:
+        raise TypeError(f"{arg_name} only support 1-D int64 buffer, but got shape:{shape}.")
+    return arg_value
+
+
 def check_uint64(arg_name, arg_value):
     check_isinstance(arg_name, arg_value, [int], allow_none=False)
     if arg_value < 0 or arg_value > _MAX_UINT64:
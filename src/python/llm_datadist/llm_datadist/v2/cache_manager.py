@@ -12,9 +12,10 @@
 
 from typing import List, Optional, Tuple, Union, Dict
 
-from llm_datadist.status import handle_llm_status, raise_if_false, raise_if_true
+from llm_datadist.status import handle_llm_status, raise_if_false, raise_if_true, LLMStatusCode
 from llm_datadist.utils import log
-from llm_datadist.utils.utils import check_isinstance, check_dict, check_uint32, check_int64, check_uint64, check_uint8
+from llm_datadist.utils.utils import check_isinstance, check_dict, check_uint32, check_int64, check_uint64, check_uint8, \
+    check_int_sequence, int64_buffer_shape
 from llm_datadist.v2.llm_types import CacheDesc, Cache, CacheKey, CacheKeyByIdAndIndex, BlocksCacheKey, Placement, \
     TransferConfig, CacheTask, LayerSynchronizer, TransferWithCacheKeyConfig, PushType, check_layer_range, MemInfo, \
     Memtype
@@ -23,9 +24,13 @@ from llm_datadist.v2.llm_utils import (
     pack_cache_key_by_id, transfer_cache_async, TransferCacheParameters, layer_range_to_tensor_indices, \
     is_invalid_id, is_valid_id
 )
+from llm_datadist import llm_datadist_wrapper
 
 _NUM_TENSORS_PER_LAYER = 2
 _INVALID_ID = 2 ** 64 - 1
+# 与C++侧SwapBlocks的swap type一致，磁盘侧仅通过cache id标识
+_SWAP_OUT_TO_DISK = 2
+_SWAP_IN_FROM_DISK = 3
 
 
 class CacheManager(object):
@@ -49,6 +54,7 @@ class CacheManager(object):
         self._is_call_linked = False
         self._enabled_mem_pool = "llm.MemPoolConfig" in options and len(options["llm.MemPoolConfig"]) > 0
         self._enable_host_mem_pool = "llm.HostMemPoolConfig" in options and len(options["llm.HostMemPoolConfig"]) > 0
+        self._enable_disk_tier = "llm.DiskTierConfig" in options and len(options["llm.DiskTierConfig"]) > 0
         self._enable_remote_cache_accessible = options.get("llm.EnableRemoteCacheAccessible", '0') == '1'
         self._enable_local_comm_res = "llm.LocalCommRes" in options
 
@@ -213,16 +219,16 @@ class CacheManager(object):
         log.info('[deallocate_cache] success')
 
     def pull_blocks(self, src_cache_key: Union[CacheKey, CacheKeyByIdAndIndex, BlocksCacheKey],
-                    dst_cache: Cache, src_blocks: Optional[Union[Tuple[int], List[int]]] = (),
-                    dst_blocks: Union[Tuple[int], List[int]] = (),
+                    dst_cache: Cache, src_blocks: Optional[Union[Tuple[int], List[int], memoryview]] = (),
+                    dst_blocks: Union[Tuple[int], List[int], memoryview] = (),
                     **kwargs):
         """
         PA模式下拉取KV
         Args:
             src_cache_key: prompt缓存key
             dst_cache: decoder目标缓存
-            src_blocks: prompt block列表
-            dst_blocks: decoder block列表
+            src_blocks: prompt block列表, 也支持int64的numpy array/array.array/memoryview
+            dst_blocks: decoder block列表, 也支持int64的numpy array/array.array/memoryview
             **kwargs:
                 src_layer_range: 源层范围
                 dst_layer_range: 目的层范围
@@ -233,8 +239,8 @@ class CacheManager(object):
         tensor_num_per_layer = kwargs.get("tensor_num_per_layer", _NUM_TENSORS_PER_LAYER)
         check_isinstance("src_cache_key", src_cache_key, [CacheKey, CacheKeyByIdAndIndex, BlocksCacheKey])
         check_isinstance("dst_cache", dst_cache, Cache)
-        check_isinstance("src_blocks", src_blocks, [list, tuple], int)
-        check_isinstance("dst_blocks", dst_blocks, [list, tuple], int)
+        check_int_sequence("src_blocks", src_blocks)
+        check_int_sequence("dst_blocks", dst_blocks)
         raise_if_false(dst_cache.is_blocks_cache, 'param check failed, dst_cache should be blocks cache.')
         raise_if_false(len(dst_blocks) > 0, "dst_blocks can not be empty.")
         check_uint32("tensor_num_per_layer", tensor_num_per_layer)
@@ -318,12 +324,13 @@ class CacheManager(object):
         """
         Args:
             cache_desc: Cache描述
-            addrs: device addrs of cache tensors
+            addrs: device addrs of cache tensors, list or int64 buffer
             cache_keys: cache keys
             remote_accessible(Optional): whether remote cache is accessible
         """
         check_isinstance("cache_desc", cache_desc, CacheDesc)
-        check_isinstance("addrs", addrs, list, int)
+        if int64_buffer_shape("addrs", addrs) is None:
+            check_isinstance("addrs", addrs, list, int)
         check_isinstance("cache_keys", cache_keys, [tuple, list], CacheKey)
         check_isinstance("remote_accessible", remote_accessible, bool)
         raise_if_true(self._is_call_linked and remote_accessible,
@@ -353,7 +360,8 @@ class CacheManager(object):
             remote_accessible(Optional): whether remote cache is accessible
         """
         check_isinstance("cache_desc", cache_desc, CacheDesc)
-        check_isinstance("addrs", addrs, list, int)
+        if int64_buffer_shape("addrs", addrs) is None:
+            check_isinstance("addrs", addrs, list, int)
         check_isinstance("blocks_cache_key", blocks_cache_key, BlocksCacheKey)
         check_isinstance("remote_accessible", remote_accessible, bool)
         raise_if_true(self._is_call_linked and remote_accessible == True,
@@ -432,12 +440,17 @@ class CacheManager(object):
         self._is_call_linked = True
 
     @staticmethod
-    def _verify_caches(src_cache: Cache, dst_cache: Cache, src_to_dst: Dict[int, int]):
+    def _verify_caches(src_cache: Cache, dst_cache: Cache, src_to_dst: Union[Dict[int, int], memoryview]):
         check_isinstance("src", src_cache, Cache)
         check_isinstance("dst", dst_cache, Cache)
         raise_if_false(src_cache.is_blocks_cache, 'param check failed, src cache should be blocks cache.')
         raise_if_false(dst_cache.is_blocks_cache, 'param check failed, dst cache should be blocks cache.')
-        check_isinstance("src_to_dst", src_to_dst, dict, int)
+        mapping_shape = int64_buffer_shape("src_to_dst", src_to_dst)
+        if mapping_shape is None:
+            check_isinstance("src_to_dst", src_to_dst, dict, int)
+        else:
+            raise_if_false(len(mapping_shape) == 2 and mapping_shape[1] == 2,
+                           f"src_to_dst buffer should be in shape (n, 2), but got {mapping_shape}")
 
         src_block_size = src_cache.cache_desc.size // src_cache.cache_desc.batch_size
         dst_block_size = dst_cache.cache_desc.size // dst_cache.cache_desc.batch_size
@@ -454,20 +467,26 @@ class CacheManager(object):
         src_block_num = src_cache.cache_desc.batch_size
         dst_block_num = dst_cache.cache_desc.batch_size
         log.info("src num block:%d, dst num block:%d", src_block_num, dst_block_num)
+        if mapping_shape is not None:
+            for (min_index, max_index), block_num, name in zip(llm_datadist_wrapper.block_mapping_range(src_to_dst),
+                                                               (src_block_num, dst_block_num), ("src", "dst")):
+                raise_if_false(0 <= min_index and max_index < block_num,
+                               f"{name}_block_index range:[{min_index}, {max_index}] must be in [0, {block_num})")
+            return
         for src_block_index, dst_block_index in src_to_dst.items():
             raise_if_false(0 <= src_block_index < src_block_num,
                            f"src_block_index:{src_block_index} must be in [0, {src_block_num})")
             raise_if_false(0 <= dst_block_index < dst_block_num,
                            f"dst_block_index:{dst_block_index} must be in [0, {dst_block_num})")
 
-    def swap_blocks(self, src_cache: Cache, dst_cache: Cache, src_to_dst: Dict[int, int]) -> None:
+    def swap_blocks(self, src_cache: Cache, dst_cache: Cache, src_to_dst: Union[Dict[int, int], memoryview]) -> None:
         """
         交换blocks
 
         Args:
             src: 源Cache
             dst: 目的Cache
-            src_to_dst: block index的字典
+            src_to_dst: block index的字典, 也支持shape为(n, 2)的int64 numpy array/memoryview
         """
         self._verify_caches(src_cache, dst_cache, src_to_dst)
         src_placement = src_cache.cache_desc.placement
@@ -483,10 +502,70 @@ class CacheManager(object):
         default_cache_id = -1
         ret = self._llm_datadist.swap_blocks_v2((default_cache_id, [src_cache.tensor_addrs]),
                                                 (default_cache_id, [dst_cache.tensor_addrs]),
-                                                block_size, swap_type, self._llm_datadist.dict_to_vector(src_to_dst))
+                                                block_size, swap_type, src_to_dst)
         handle_llm_status(ret, '[swap_blocks]', 'swap blocks failed')
         log.info('[swap_blocks] success')
 
+    def _verify_disk_swap(self, host_cache: Cache, disk_cache_id: int,
+                          src_to_dst: Union[Dict[int, int], memoryview], host_is_src: bool) -> None:
+        raise_if_false(self._enable_disk_tier, 'disk tier is not enabled, set LlmConfig.disk_tier_cfg',
+                       status_code=LLMStatusCode.LLM_FEATURE_NOT_ENABLED)
+        check_isinstance("host_cache", host_cache, Cache)
+        raise_if_false(host_cache.is_blocks_cache, 'param check failed, host cache should be blocks cache.')
+        raise_if_false(host_cache.cache_desc.placement == Placement.HOST,
+                       f"host cache placement:{host_cache.cache_desc.placement} should be HOST")
+        check_int64("disk_cache_id", disk_cache_id)
+        raise_if_false(disk_cache_id >= 0, f"disk_cache_id:{disk_cache_id} must be non-negative")
+        mapping_shape = int64_buffer_shape("src_to_dst", src_to_dst)
+        if mapping_shape is None:
+            check_isinstance("src_to_dst", src_to_dst, dict, int)
+            if not src_to_dst:
+                return
+            ranges = [(min(indices), max(indices)) for indices in (src_to_dst.keys(), src_to_dst.values())]
+        else:
+            raise_if_false(len(mapping_shape) == 2 and mapping_shape[1] == 2,
+                           f"src_to_dst buffer should be in shape (n, 2), but got {mapping_shape}")
+            ranges = list(llm_datadist_wrapper.block_mapping_range(src_to_dst))
+        (host_min, host_max), (disk_min, _) = ranges if host_is_src else reversed(ranges)
+        host_block_num = host_cache.cache_desc.batch_size
+        raise_if_false(0 <= host_min and host_max < host_block_num,
+                       f"host block index range:[{host_min}, {host_max}] must be in [0, {host_block_num})")
+        raise_if_false(disk_min >= 0, f"disk block index:{disk_min} must be non-negative")
+
+    def swap_blocks_to_disk(self, src_cache: Cache, disk_cache_id: int,
+                            src_to_dst: Union[Dict[int, int], memoryview]) -> None:
+        """
+        将host blocks换出到磁盘层, 需要配置LlmConfig.disk_tier_cfg
+
+        Args:
+            src_cache: 源host Cache
+            disk_cache_id: 磁盘侧cache id, 换入时使用相同的id
+            src_to_dst: host block index到磁盘block index的字典, 也支持shape为(n, 2)的int64 numpy array/memoryview
+        """
+        self._verify_disk_swap(src_cache, disk_cache_id, src_to_dst, True)
+        block_size = src_cache.cache_desc.size // src_cache.cache_desc.batch_size
+        ret = self._llm_datadist.swap_blocks_v2((-1, [src_cache.tensor_addrs]), (disk_cache_id, []),
+                                                block_size, _SWAP_OUT_TO_DISK, src_to_dst)
+        handle_llm_status(ret, '[swap_blocks_to_disk]', 'swap blocks to disk failed')
+        log.info('[swap_blocks_to_disk] success, disk_cache_id:%d', disk_cache_id)
+
+    def swap_blocks_from_disk(self, disk_cache_id: int, dst_cache: Cache,
+                              src_to_dst: Union[Dict[int, int], memoryview]) -> None:
+        """
+        从磁盘层换入blocks到host, 需要配置LlmConfig.disk_tier_cfg
+
+        Args:
+            disk_cache_id: 换出时使用的磁盘侧cache id
+            dst_cache: 目的host Cache
+            src_to_dst: 磁盘block index到host block index的字典, 也支持shape为(n, 2)的int64 numpy array/memoryview
+        """
+        self._verify_disk_swap(dst_cache, disk_cache_id, src_to_dst, False)
+        block_size = dst_cache.cache_desc.size // dst_cache.cache_desc.batch_size
+        ret = self._llm_datadist.swap_blocks_v2((disk_cache_id, []), (-1, [dst_cache.tensor_addrs]),
+                                                block_size, _SWAP_IN_FROM_DISK, src_to_dst)
+        handle_llm_status(ret, '[swap_blocks_from_disk]', 'swap blocks from disk failed')
+        log.info('[swap_blocks_from_disk] success, disk_cache_id:%d', disk_cache_id)
+
     def transfer_cache_async(self,
                              src_cache: Cache,
                              layer_synchronizer: LayerSynchronizer,
@@ -589,8 +668,8 @@ class CacheManager(object):
                        "push_blocks is only supported while enable_remote_cache_accessible is True")
         check_isinstance("dst_cache_key", dst_cache_key, [BlocksCacheKey])
         check_isinstance("src_cache", src_cache, Cache)
-        check_isinstance("src_blocks", src_blocks, [list, tuple], int)
-        check_isinstance("dst_blocks", dst_blocks, [list, tuple], int)
+        check_int_sequence("src_blocks", src_blocks)
+        check_int_sequence("dst_blocks", dst_blocks)
         raise_if_false(src_cache.is_blocks_cache, 'param check failed, cache should be blocks cache.')
         raise_if_false(len(dst_blocks) > 0, "dst_blocks can not be empty.")
 
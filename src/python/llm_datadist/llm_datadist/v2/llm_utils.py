@@ -13,7 +13,8 @@ from dataclasses import dataclass
 from threading import Thread
 from typing import Dict, List, Optional, Union, Tuple
 from llm_datadist.utils import log
-from llm_datadist.utils.utils import check_isinstance, check_list_uint64, check_uint64, check_uint32
+from llm_datadist.utils.utils import check_isinstance, check_list_uint64, check_uint64, check_uint32, \
+    check_int_sequence
 from llm_datadist.status import LLMException, LLMStatusCode, raise_if_false, code_2_status, raise_if_true
 from llm_datadist.data_type import DataType, python_dtype_2_dwrapper_dtype
 from llm_datadist.v2.llm_types import CacheDesc, KvCache, CacheKey, CacheKeyByIdAndIndex, BlocksCacheKey, Placement, \
@@ -212,12 +213,17 @@ class TransferCacheJob:
         block_config = (self._dst_block_memory_size if self._dst_block_memory_size is not None else 0,
                         self._src_block_indices if self._src_block_indices is not None else [],
                         self._dst_block_indices if self._dst_block_indices is not None else [])
-        ret = self._transfer_cache_func(TransferCacheJob.task_id, transfer_config, block_config)
+        try:
+            ret = self._transfer_cache_func(TransferCacheJob.task_id, transfer_config, block_config)
+        except ValueError as e:
+            # negative values of int64 block index buffers are only rejected by the wrapper
+            log.error(f'Invalid block indices: {e}')
+            return LLMStatusCode.LLM_PARAM_INVALID
         TransferCacheJob.task_id += 1
         return code_2_status(ret)
 
     def check_transfer_config(self, transfer_config: Union[TransferConfig, TransferWithCacheKeyConfig]):
-        if self._src_block_indices:
+        if _has_block_indices(self._src_block_indices):
             raise_if_false(transfer_config.src_batch_index == 0,
                            'Invalid TransferConfig, src_batch_index ({0}) != 0 while src is blocks',
                            transfer_config.src_batch_index)
@@ -275,8 +281,14 @@ class TransferAsyncThread(Thread):
 
 def _check_block_indices(arg_name, arg_value):
     if arg_value is not None:
-        check_isinstance(arg_name, arg_value, [list, tuple], int)
-        check_list_uint64(arg_name, arg_value)
+        check_int_sequence(arg_name, arg_value)
+        if isinstance(arg_value, (list, tuple)):
+            check_list_uint64(arg_name, arg_value)
+
+
+def _has_block_indices(block_indices) -> bool:
+    # numpy array has no unambiguous truth value
+    return block_indices is not None and len(block_indices) > 0
 
 
 def transfer_cache_async(params: TransferCacheParameters,
@@ -288,8 +300,8 @@ def transfer_cache_async(params: TransferCacheParameters,
     _check_block_indices("src_block_indices", params.src_block_indices)
     if params.dst_block_memory_size is not None:
         check_uint64("dst_block_memory_size", params.dst_block_memory_size)
-    if params.src_block_indices:  # src is blocks
-        raise_if_false(params.dst_block_indices, "transfer from blocks to cache is not supported")
+    if _has_block_indices(params.src_block_indices):  # src is blocks
+        raise_if_false(_has_block_indices(params.dst_block_indices), "transfer from blocks to cache is not supported")
         raise_if_false(len(params.src_block_indices) == len(params.dst_block_indices),
                        "num_block_indices mismatches, src_num = {0}, dst_num = {1}",
                        len(params.src_block_indices), len(params.dst_block_indices))
@@ -300,7 +312,7 @@ def transfer_cache_async(params: TransferCacheParameters,
                       "transfer from cache to blocks is not supported")
         except ModuleNotFoundError:
             pass
-        if params.dst_block_indices:
+        if _has_block_indices(params.dst_block_indices):
             raise_if_false(params.dst_block_memory_size is not None,
                            "dst_block_memory_size must be set when transfer from cache to blocks")
     check_isinstance("layer_synchronizer", layer_synchronizer, LayerSynchronizer, allow_none=False)
@@ -309,7 +321,7 @@ def transfer_cache_async(params: TransferCacheParameters,
     else:
         check_isinstance("transfer_configs", params.transfer_configs, [list, tuple], TransferWithCacheKeyConfig,
                          'While enable_remote_cache_accessible is True, ', allow_none=False)
-    raise_if_false(params.dst_block_indices or params.dst_block_memory_size in (None, 0),
+    raise_if_false(_has_block_indices(params.dst_block_indices) or params.dst_block_memory_size in (None, 0),
                    "dst_block_memory_size ({0}) is neither None nor 0 while dst is not blocks",
                    params.dst_block_memory_size)
     transfer_job = TransferCacheJob(params, layer_synchronizer, transfer_cache_func)
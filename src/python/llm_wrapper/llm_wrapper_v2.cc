@@ -13,9 +13,11 @@
 #undef PyCFunction_NewEx
 #endif
 
+#include <cstring>
 #include <map>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 #include "acl/acl.h"
@@ -62,17 +64,156 @@ void BindStatusCodes(py::module &m) {
   m.attr("kLLMSuspectRemoteError") = py::int_(ACL_ERROR_RT_SUSPECT_REMOTE_ERROR);
 }
 
-std::vector<std::pair<int64_t, int64_t>> PyDictToVector(const py::dict &py_dict) {
-  std::vector<std::pair<int64_t, int64_t>> result;
+constexpr py::ssize_t kBlockMappingRowSize = 2;
+
+bool IsInt64Format(const std::string &format) {
+  // numpy exports int64 as 'l' while array.array and memoryview export 'q'
+  const auto pos = format.find_first_not_of("@=<");
+  return (pos != std::string::npos) && (pos + 1U == format.size()) && ((format[pos] == 'q') || (format[pos] == 'l'));
+}
+
+bool IsBufferObject(const py::handle &obj) {
+  return (PyObject_CheckBuffer(obj.ptr()) != 0) && (!PyBytes_Check(obj.ptr())) && (!PyByteArray_Check(obj.ptr()));
+}
+
+// only C-contiguous buffers are accepted, strided views are rejected by the exporter instead of being gathered
+py::buffer_info RequestInt64Buffer(const py::handle &obj, py::ssize_t ndim) {
+  auto view = new Py_buffer();
+  if (PyObject_GetBuffer(obj.ptr(), view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+    delete view;
+    throw py::error_already_set();
+  }
+  py::buffer_info info(view);
+  if ((info.itemsize != static_cast<py::ssize_t>(sizeof(int64_t))) || (!IsInt64Format(info.format)) ||
+      (info.ndim != ndim)) {
+    throw py::type_error("only support contiguous int64 buffer with " + std::to_string(ndim) +
+                         " dim(s), but got format:" + info.format + ", ndim:" + std::to_string(info.ndim));
+  }
+  if ((ndim == kBlockMappingRowSize) && (info.shape[1] != kBlockMappingRowSize)) {
+    throw py::type_error("block mapping buffer should be in shape (n, 2), but got (" + std::to_string(info.shape[0]) +
+                         ", " + std::to_string(info.shape[1]) + ")");
+  }
+  return info;
+}
 
-  for (const auto &item : py_dict) {
-    int64_t key = item.first.cast<int64_t>();
-    int64_t value = item.second.cast<int64_t>();
-    result.emplace_back(key, value);
+// int64 buffers are taken in one bulk copy, any other sequence falls back to element-wise conversion
+template <typename T>
+std::vector<T> ToIndexVector(const py::object &obj) {
+  static_assert(sizeof(T) == sizeof(int64_t), "index type should be 8 bytes");
+  if (!IsBufferObject(obj)) {
+    return obj.cast<std::vector<T>>();
+  }
+  const auto info = RequestInt64Buffer(obj, 1);
+  // the values are copied as is, so a negative one would turn into a huge index
+  const auto begin = static_cast<const int64_t *>(info.ptr);
+  const auto end = begin + info.size;
+  const auto negative = std::find_if(begin, end, [](int64_t value) { return value < 0; });
+  if (negative != end) {
+    throw py::value_error("index buffer value is out of range, " + std::to_string(*negative) +
+                          " is not a uint64 value");
+  }
+  std::vector<T> result(static_cast<size_t>(info.size));
+  if (!result.empty()) {
+    (void)std::memcpy(result.data(), info.ptr, result.size() * sizeof(T));
+  }
+  return result;
+}
+
+// accepts dict, sequence of pairs, or int64 buffer in shape (n, 2)
+std::vector<std::pair<int64_t, int64_t>> ToBlockMapping(const py::object &obj) {
+  std::vector<std::pair<int64_t, int64_t>> result;
+  if (py::isinstance<py::dict>(obj)) {
+    const auto py_dict = py::reinterpret_borrow<py::dict>(obj);
+    result.reserve(py_dict.size());
+    for (const auto &item : py_dict) {
+      result.emplace_back(item.first.cast<int64_t>(), item.second.cast<int64_t>());
+    }
+    return result;
+  }
+  if (!IsBufferObject(obj)) {
+    return obj.cast<std::vector<std::pair<int64_t, int64_t>>>();
+  }
+  const auto info = RequestInt64Buffer(obj, kBlockMappingRowSize);
+  const auto *data = static_cast<const int64_t *>(info.ptr);
+  result.reserve(static_cast<size_t>(info.shape[0]));
+  for (py::ssize_t i = 0; i < info.shape[0]; ++i) {
+    result.emplace_back(data[i * kBlockMappingRowSize], data[i * kBlockMappingRowSize + 1]);
   }
   return result;
 }
 
+std::vector<std::pair<int64_t, int64_t>> PyDictToVector(const py::dict &py_dict) {
+  return ToBlockMapping(py_dict);
+}
+
+// returns [(src_min, src_max), (dst_min, dst_max)], or empty if mapping is empty
+std::vector<std::pair<int64_t, int64_t>> BlockMappingRange(const py::object &block_mapping) {
+  const auto mapping = ToBlockMapping(block_mapping);
+  if (mapping.empty()) {
+    return {};
+  }
+  const auto src_range = std::minmax_element(mapping.cbegin(), mapping.cend(),
+                                             [](const std::pair<int64_t, int64_t> &lhs,
+                                                const std::pair<int64_t, int64_t> &rhs) {
+                                               return lhs.first < rhs.first;
+                                             });
+  const auto dst_range = std::minmax_element(mapping.cbegin(), mapping.cend(),
+                                             [](const std::pair<int64_t, int64_t> &lhs,
+                                                const std::pair<int64_t, int64_t> &rhs) {
+                                               return lhs.second < rhs.second;
+                                             });
+  return {{src_range.first->first, src_range.second->first}, {dst_range.first->second, dst_range.second->second}};
+}
+
+// arguments are converted while holding the GIL, which is released only around the blocking call
+std::pair<ge::Status, CacheTuple> RegisterCacheV2(const CacheDescTuple &cache_desc, const py::object &tensor_addrs,
+                                                  const std::vector<CacheKeyTuple> &cache_keys,
+                                                  bool remote_accessible) {
+  const auto addrs = ToIndexVector<uintptr_t>(tensor_addrs);
+  py::gil_scoped_release release;
+  return LLMDataDistV2Wrapper::RegisterCache(cache_desc, addrs, cache_keys, remote_accessible);
+}
+
+ge::Status PullCacheV2(int64_t cache_id, const CacheKeyTuple &cache_key, const py::tuple &pull_cache_param) {
+  if (pull_cache_param.size() != std::tuple_size<PullCacheParamTuple>::value) {
+    throw py::value_error("pull cache param size should be " +
+                          std::to_string(std::tuple_size<PullCacheParamTuple>::value) + ", but got " +
+                          std::to_string(pull_cache_param.size()));
+  }
+  const PullCacheParamTuple param = std::make_tuple(pull_cache_param[0].cast<int64_t>(),
+                                                    pull_cache_param[1].cast<uint32_t>(),
+                                                    ToIndexVector<uint64_t>(pull_cache_param[2]),
+                                                    ToIndexVector<uint64_t>(pull_cache_param[3]),
+                                                    ToIndexVector<uint64_t>(pull_cache_param[4]),
+                                                    ToIndexVector<uint64_t>(pull_cache_param[5]),
+                                                    pull_cache_param[6].cast<int64_t>(),
+                                                    pull_cache_param[7].cast<int64_t>(),
+                                                    pull_cache_param[8].cast<uint64_t>());
+  py::gil_scoped_release release;
+  return LLMDataDistV2Wrapper::PullCache(cache_id, cache_key, param);
+}
+
+ge::Status SwapBlocksV2(const CacheTuple &src, const CacheTuple &dst, const uint64_t block_size, const uint32_t type,
+                        const py::object &block_mapping) {
+  const auto mapping = ToBlockMapping(block_mapping);
+  py::gil_scoped_release release;
+  return LLMDataDistV2Wrapper::SwapBlocks(src, dst, block_size, type, mapping);
+}
+
+ge::Status TransferCacheV2(const uint64_t task_id, const TransferCacheConfigTuple &transfer_cache_param,
+                           const py::tuple &transfer_block_param) {
+  if (transfer_block_param.size() != std::tuple_size<TransferBlockConfigTuple>::value) {
+    throw py::value_error("transfer block param size should be " +
+                          std::to_string(std::tuple_size<TransferBlockConfigTuple>::value) + ", but got " +
+                          std::to_string(transfer_block_param.size()));
+  }
+  const TransferBlockConfigTuple block_param = std::make_tuple(transfer_block_param[0].cast<uint64_t>(),
+                                                               ToIndexVector<uint64_t>(transfer_block_param[1]),
+                                                               ToIndexVector<uint64_t>(transfer_block_param[2]));
+  py::gil_scoped_release release;
+  return LLMDataDistV2Wrapper::TransferCache(task_id, transfer_cache_param, block_param);
+}
+
 int64_t CalcTensorSize(const std::vector<int64_t> &shape, int32_t data_type) {
   int64_t tensor_size = -1;
   (void) LLMUtils::CalcTensorMemSize(shape,
@@ -83,25 +224,26 @@ int64_t CalcTensorSize(const std::vector<int64_t> &shape, int32_t data_type) {
 
 void BuildDataDistV2Funcs(py::module &m) {
   (void)m.def("calc_tensor_size", &CalcTensorSize);
-  (void)m.def("dict_to_vector", &PyDictToVector, py::call_guard<py::gil_scoped_release>());
+  (void)m.def("dict_to_vector", &PyDictToVector);
+  (void)m.def("block_mapping_range", &BlockMappingRange);
   (void)m.def("initialize_v2", &LLMDataDistV2Wrapper::Init, py::call_guard<py::gil_scoped_release>());
   (void)m.def("finalize_v2", &LLMDataDistV2Wrapper::Finalize, py::call_guard<py::gil_scoped_release>());
   (void)m.def("link", &LLMDataDistV2Wrapper::Link, py::call_guard<py::gil_scoped_release>());
   (void)m.def("unlink", &LLMDataDistV2Wrapper::Unlink, py::call_guard<py::gil_scoped_release>());
   (void)m.def("query_register_mem_status", &LLMDataDistV2Wrapper::QueryRegisterMemStatus,
               py::call_guard<py::gil_scoped_release>());
-  (void)m.def("register_cache", &LLMDataDistV2Wrapper::RegisterCache, py::call_guard<py::gil_scoped_release>());
+  (void)m.def("register_cache", &RegisterCacheV2);
   (void)m.def("unregister_cache", &LLMDataDistV2Wrapper::UnregisterCache, py::call_guard<py::gil_scoped_release>());
   (void)m.def("allocate_cache_v2", &LLMDataDistV2Wrapper::AllocateCache, py::call_guard<py::gil_scoped_release>());
   (void)m.def("deallocate_cache_v2", &LLMDataDistV2Wrapper::DeallocateCache, py::call_guard<py::gil_scoped_release>());
   (void)m.def("remove_cache_key_v2", &LLMDataDistV2Wrapper::RemoveCacheKey, py::call_guard<py::gil_scoped_release>());
   (void)m.def("remap_registered_memory", &LLMDataDistV2Wrapper::RemapRegisteredMemory,
               py::call_guard<py::gil_scoped_release>());
-  (void)m.def("pull_cache_v2", &LLMDataDistV2Wrapper::PullCache, py::call_guard<py::gil_scoped_release>());
+  (void)m.def("pull_cache_v2", &PullCacheV2);
   (void)m.def("copy_cache_v2", &LLMDataDistV2Wrapper::CopyCache, py::call_guard<py::gil_scoped_release>());
-  (void)m.def("swap_blocks_v2", &LLMDataDistV2Wrapper::SwapBlocks, py::call_guard<py::gil_scoped_release>());
+  (void)m.def("swap_blocks_v2", &SwapBlocksV2);
   (void)m.def("check_capacity_v2", &LLMDataDistV2Wrapper::CheckCapacity, py::call_guard<py::gil_scoped_release>());
-  (void) m.def("transfer_cache_v2", &LLMDataDistV2Wrapper::TransferCache, py::call_guard<py::gil_scoped_release>());
+  (void) m.def("transfer_cache_v2", &TransferCacheV2);
   (void) m.def("link_clusters_v2", &LLMDataDistV2Wrapper::LinkClusters, py::call_guard<py::gil_scoped_release>());
   (void) m.def("unlink_clusters_v2", &LLMDataDistV2Wrapper::UnlinkClusters, py::call_guard<py::gil_scoped_release>());
   (void) m.def("switch_role_v2", &LLMDataDistV2Wrapper::SwitchRole, py::call_guard<py::gil_scoped_release>());
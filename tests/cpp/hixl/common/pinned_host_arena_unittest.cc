@@ -0,0 +1,226 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <cstring>
+#include <map>
+#include <set>
+#include <gtest/gtest.h>
+#include "common/pinned_host_arena.h"
+#include "depends/ascendcl/src/ascendcl_stub.h"
+
+namespace hixl {
+namespace {
+constexpr size_t kChunkSize = 4UL * 1024UL * 1024UL;
+
+PinnedHostArenaOptions MakeMmapOptions(int32_t numa_node = kAnyNumaNode) {
+  PinnedHostArenaOptions options;
+  options.backend = HostArenaBackend::kMmap;
+  options.numa_node = numa_node;
+  options.chunk_size = kChunkSize;
+  return options;
+}
+
+uint64_t SumNodeBytes(const PinnedHostArenaStats &stats) {
+  uint64_t total = 0UL;
+  for (const auto &it : stats.node_bytes) {
+    total += it.second;
+  }
+  return total;
+}
+
+class HostRegisterRecordStub : public llm::AclRuntimeStub {
+ public:
+  aclError aclrtHostRegister(void *ptr, uint64_t size, aclrtHostRegisterType type, void **devPtr) override {
+    registered_[ptr] = size;
+    return llm::AclRuntimeStub::aclrtHostRegister(ptr, size, type, devPtr);
+  }
+
+  aclError aclrtHostUnregister(void *ptr) override {
+    (void)registered_.erase(ptr);
+    return llm::AclRuntimeStub::aclrtHostUnregister(ptr);
+  }
+
+  std::map<void *, uint64_t> registered_;
+};
+}  // namespace
+
+class PinnedHostArenaUTest : public ::testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {
+    llm::AclRuntimeStub::Reset();
+  }
+};
+
+TEST_F(PinnedHostArenaUTest, SlabAllocAndReuse) {
+  PinnedHostArena arena(MakeMmapOptions());
+  ASSERT_EQ(arena.Initialize(), SUCCESS);
+  std::set<void *> ptrs;
+  for (size_t i = 0U; i < 1000U; ++i) {
+    void *ptr = nullptr;
+    ASSERT_EQ(arena.Alloc(100U, ptr), SUCCESS);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 128U, 0U);
+    (void)memset(ptr, 1, 100U);
+    EXPECT_TRUE(ptrs.emplace(ptr).second);
+  }
+  void *big_object = nullptr;
+  ASSERT_EQ(arena.Alloc(64U * 1024U, big_object), SUCCESS);
+  auto stats = arena.GetStats();
+  EXPECT_EQ(stats.slab_num, 2U);
+  EXPECT_EQ(stats.chunk_num, 1U);
+  EXPECT_EQ(stats.large_alloc_num, 0U);
+  EXPECT_EQ(stats.allocated_bytes, 1000U * 128U + 64U * 1024U);
+
+  void *first = *ptrs.begin();
+  arena.Free(first);
+  void *reused = nullptr;
+  ASSERT_EQ(arena.Alloc(128U, reused), SUCCESS);
+  EXPECT_EQ(reused, first);
+  for (const auto ptr : ptrs) {
+    arena.Free(ptr);
+  }
+  arena.Free(big_object);
+  EXPECT_EQ(arena.GetStats().allocated_bytes, 0U);
+  arena.Finalize();
+}
+
+TEST_F(PinnedHostArenaUTest, LargeAllocWithHugePage) {
+  const int32_t local_node = PinnedHostArena::GetCurrentNumaNode() < 0 ? 0 : PinnedHostArena::GetCurrentNumaNode();
+  PinnedHostArena arena(MakeMmapOptions(local_node));
+  ASSERT_EQ(arena.Initialize(), SUCCESS);
+  constexpr size_t kSize = 3UL * 1024UL * 1024UL;
+  void *ptr = nullptr;
+  ASSERT_EQ(arena.Alloc(kSize, ptr), SUCCESS);
+  (void)memset(ptr, 0xA5, kSize);
+  const auto stats = arena.GetStats();
+  EXPECT_EQ(stats.large_alloc_num, 1U);
+  EXPECT_GE(stats.reserved_bytes, kSize);
+  ASSERT_EQ(stats.page_type_bytes.size(), 1U);
+  EXPECT_EQ(SumNodeBytes(stats), stats.reserved_bytes);
+  ASSERT_EQ(arena.GetNumaNode(), local_node);
+  const auto local_it = stats.node_bytes.find(arena.GetNumaNode());
+  const auto unknown_it = stats.node_bytes.find(kAnyNumaNode);
+  const uint64_t placed_bytes = (local_it == stats.node_bytes.end()) ? 0UL : local_it->second;
+  const uint64_t unknown_bytes = (unknown_it == stats.node_bytes.end()) ? 0UL : unknown_it->second;
+  EXPECT_EQ(placed_bytes + unknown_bytes, stats.reserved_bytes);
+  arena.Free(ptr);
+  EXPECT_EQ(arena.GetStats().reserved_bytes, 0U);
+}
+
+TEST_F(PinnedHostArenaUTest, NormalPageWithoutHugePage) {
+  auto options = MakeMmapOptions();
+  options.huge_page = false;
+  options.lock_pages = false;
+  PinnedHostArena arena(options);
+  ASSERT_EQ(arena.Initialize(), SUCCESS);
+  void *ptr = nullptr;
+  ASSERT_EQ(arena.Alloc(1024U * 1024U, ptr), SUCCESS);
+  const auto stats = arena.GetStats();
+  ASSERT_EQ(stats.page_type_bytes.size(), 1U);
+  EXPECT_EQ(stats.page_type_bytes.begin()->first, HostPageType::kNormal);
+}
+
+TEST_F(PinnedHostArenaUTest, RuntimeBackend) {
+  PinnedHostArenaOptions options;
+  options.chunk_size = kChunkSize;
+  PinnedHostArena arena(options);
+  ASSERT_EQ(arena.Initialize(), SUCCESS);
+  void *small = nullptr;
+  void *large = nullptr;
+  ASSERT_EQ(arena.Alloc(256U, small), SUCCESS);
+  ASSERT_EQ(arena.Alloc(kChunkSize, large), SUCCESS);
+  (void)memset(small, 0, 256U);
+  (void)memset(large, 0, kChunkSize);
+  const auto stats = arena.GetStats();
+  EXPECT_EQ(stats.chunk_num, 2U);
+  EXPECT_EQ(stats.reserved_bytes, kChunkSize * 2U);
+  arena.Free(small);
+  arena.Free(large);
+  arena.Finalize();
+}
+
+TEST_F(PinnedHostArenaUTest, InvalidParam) {
+  PinnedHostArena arena(MakeMmapOptions(PinnedHostArena::GetNumaNodeNum()));
+  EXPECT_EQ(arena.Initialize(), PARAM_INVALID);
+  void *ptr = nullptr;
+  EXPECT_EQ(arena.Alloc(64U, ptr), FAILED);
+
+  PinnedHostArena valid_arena(MakeMmapOptions());
+  ASSERT_EQ(valid_arena.Initialize(), SUCCESS);
+  EXPECT_EQ(valid_arena.Initialize(), FAILED);
+  EXPECT_EQ(valid_arena.Alloc(0U, ptr), PARAM_INVALID);
+  int32_t not_from_arena = 0;
+  valid_arena.Free(&not_from_arena);
+  EXPECT_EQ(valid_arena.GetStats().allocated_bytes, 0U);
+}
+
+TEST_F(PinnedHostArenaUTest, NoNumaPolicyByDefault) {
+  PinnedHostArena arena(MakeMmapOptions());
+  ASSERT_EQ(arena.Initialize(), SUCCESS);
+  EXPECT_EQ(arena.GetNumaNode(), kAnyNumaNode);
+  void *ptr = nullptr;
+  ASSERT_EQ(arena.Alloc(1024U, ptr), SUCCESS);
+  EXPECT_EQ(arena.GetStats().numa_node, kAnyNumaNode);
+  arena.Free(ptr);
+}
+
+TEST_F(PinnedHostArenaUTest, MmapChunkRegisteredToRuntime) {
+  auto runtime = std::make_shared<HostRegisterRecordStub>();
+  llm::AclRuntimeStub::SetInstance(runtime);
+  PinnedHostArena arena(MakeMmapOptions());
+  ASSERT_EQ(arena.Initialize(), SUCCESS);
+  void *small = nullptr;
+  void *large = nullptr;
+  ASSERT_EQ(arena.Alloc(256U, small), SUCCESS);
+  ASSERT_EQ(arena.Alloc(kChunkSize, large), SUCCESS);
+  const auto stats = arena.GetStats();
+  ASSERT_EQ(runtime->registered_.size(), 2U);
+  uint64_t registered_bytes = 0UL;
+  for (const auto &it : runtime->registered_) {
+    registered_bytes += it.second;
+  }
+  EXPECT_EQ(registered_bytes, stats.reserved_bytes);
+  EXPECT_EQ(runtime->registered_.count(large), 1U);
+  arena.Free(large);
+  EXPECT_EQ(runtime->registered_.size(), 1U);
+  arena.Finalize();
+  EXPECT_TRUE(runtime->registered_.empty());
+}
+
+TEST_F(PinnedHostArenaUTest, FreeRejectsMisalignedAndDoubleFree) {
+  PinnedHostArena arena(MakeMmapOptions());
+  ASSERT_EQ(arena.Initialize(), SUCCESS);
+  void *first = nullptr;
+  void *second = nullptr;
+  ASSERT_EQ(arena.Alloc(128U, first), SUCCESS);
+  ASSERT_EQ(arena.Alloc(128U, second), SUCCESS);
+  EXPECT_EQ(arena.GetStats().allocated_bytes, 256U);
+
+  arena.Free(static_cast<uint8_t *>(first) + 64U);
+  EXPECT_EQ(arena.GetStats().allocated_bytes, 256U);
+  arena.Free(first);
+  EXPECT_EQ(arena.GetStats().allocated_bytes, 128U);
+  arena.Free(first);
+  EXPECT_EQ(arena.GetStats().allocated_bytes, 128U);
+
+  // a slot freed twice would be handed out twice
+  void *third = nullptr;
+  void *fourth = nullptr;
+  ASSERT_EQ(arena.Alloc(128U, third), SUCCESS);
+  ASSERT_EQ(arena.Alloc(128U, fourth), SUCCESS);
+  EXPECT_EQ(third, first);
+  EXPECT_NE(fourth, first);
+  EXPECT_NE(fourth, second);
+  arena.Free(second);
+  arena.Free(third);
+  arena.Free(fourth);
+  EXPECT_EQ(arena.GetStats().allocated_bytes, 0U);
+}
+}  // namespace hixl
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "common/priority_mutex.h"
+
+namespace hixl {
+namespace {
+uint32_t WaiterNum(PriorityMutex &mutex, bool high_priority) {
+  std::lock_guard<std::mutex> lock(mutex.mutex_);
+  return high_priority ? mutex.high_waiters_ : mutex.normal_waiters_;
+}
+
+void WaitForWaiters(PriorityMutex &mutex, bool high_priority, uint32_t num) {
+  while (WaiterNum(mutex, high_priority) < num) {
+    std::this_thread::yield();
+  }
+}
+}  // namespace
+
+TEST(PriorityMutexTest, MutualExclusion) {
+  PriorityMutex mutex;
+  int64_t counter = 0;
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&mutex, &counter, i]() {
+      for (int32_t j = 0; j < 10000; ++j) {
+        PriorityLockGuard lock(mutex, (i % 2) == 0);
+        ++counter;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter, 40000);
+}
+
+TEST(PriorityMutexTest, HighPriorityGoesFirst) {
+  PriorityMutex mutex;
+  std::vector<int32_t> order;
+  mutex.lock();
+  std::thread normal([&]() {
+    std::lock_guard<PriorityMutex> lock(mutex);
+    order.emplace_back(0);
+  });
+  WaitForWaiters(mutex, false, 1U);
+  std::thread high([&]() {
+    PriorityLockGuard lock(mutex, true);
+    order.emplace_back(1);
+  });
+  WaitForWaiters(mutex, true, 1U);
+  mutex.unlock();
+  normal.join();
+  high.join();
+  ASSERT_EQ(order.size(), 2U);
+  EXPECT_EQ(order[0], 1);
+  EXPECT_EQ(order[1], 0);
+}
+
+TEST(PriorityMutexTest, HighPriorityOvertakesQueuedBulk) {
+  // a bulk stream has queued its batches behind the one being posted when latency critical requests arrive,
+  // they are handed the lock before any of the queued bulk batches
+  constexpr uint32_t kBulkSubmitters = 4U;
+  constexpr uint32_t kHighRequests = 2U;
+  PriorityMutex mutex;
+  std::mutex order_mutex;
+  std::vector<bool> order;
+  const auto submit = [&](bool high_priority) {
+    PriorityLockGuard lock(mutex, high_priority);
+    std::lock_guard<std::mutex> order_lock(order_mutex);
+    order.emplace_back(high_priority);
+  };
+  mutex.lock();
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0U; i < kBulkSubmitters; ++i) {
+    threads.emplace_back(submit, false);
+  }
+  WaitForWaiters(mutex, false, kBulkSubmitters);
+  for (uint32_t i = 0U; i < kHighRequests; ++i) {
+    threads.emplace_back(submit, true);
+  }
+  WaitForWaiters(mutex, true, kHighRequests);
+  mutex.unlock();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(order.size(), kBulkSubmitters + kHighRequests);
+  for (size_t i = 0U; i < order.size(); ++i) {
+    EXPECT_EQ(order[i], i < kHighRequests) << "acquisition " << i;
+  }
+}
+}  // namespace hixl
@@ -0,0 +1,233 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "common/rail_striper.h"
+
+namespace hixl {
+namespace {
+constexpr uint64_t kMiB = 1024UL * 1024UL;
+
+uint64_t TotalBytes(const std::vector<TransferOpDesc> &op_descs) {
+  uint64_t total = 0U;
+  for (const auto &op_desc : op_descs) {
+    total += op_desc.len;
+  }
+  return total;
+}
+
+// stub transport, every rail copies its ops on its own thread
+void RunRails(const std::vector<std::vector<TransferOpDesc>> &rail_op_descs) {
+  std::vector<std::thread> rails;
+  for (const auto &op_descs : rail_op_descs) {
+    rails.emplace_back([&op_descs]() {
+      for (const auto &op_desc : op_descs) {
+        (void)memcpy(reinterpret_cast<void *>(op_desc.remote_addr), reinterpret_cast<const void *>(op_desc.local_addr),
+                     op_desc.len);
+      }
+    });
+  }
+  for (auto &rail : rails) {
+    rail.join();
+  }
+}
+
+// bytes that every rail got from a split of op_descs
+std::vector<uint64_t> SplitBytes(RailStriper &striper, const std::vector<TransferOpDesc> &op_descs) {
+  std::vector<std::vector<TransferOpDesc>> rail_op_descs;
+  striper.Split(op_descs, rail_op_descs);
+  std::vector<uint64_t> bytes;
+  for (const auto &rail : rail_op_descs) {
+    bytes.emplace_back(TotalBytes(rail));
+  }
+  return bytes;
+}
+
+void ExpectShares(const std::vector<uint64_t> &bytes, const std::vector<double> &shares, uint64_t total) {
+  ASSERT_EQ(bytes.size(), shares.size());
+  uint64_t sum = 0U;
+  for (size_t i = 0U; i < bytes.size(); ++i) {
+    sum += bytes[i];
+    const double expected = static_cast<double>(total) * shares[i];
+    EXPECT_LE(std::abs(static_cast<double>(bytes[i]) - expected), static_cast<double>(2U * RailStriper::kStripeAlign))
+        << "rail " << i;
+  }
+  EXPECT_EQ(sum, total);
+}
+
+RailStripeConfig MakeConfig(std::vector<double> bandwidths, uint64_t min_stripe_bytes = kMiB) {
+  RailStripeConfig config;
+  config.enable = true;
+  config.min_stripe_bytes = min_stripe_bytes;
+  config.bandwidths = std::move(bandwidths);
+  return config;
+}
+}  // namespace
+
+TEST(RailStriperTest, SmallBatchStaysOnFirstRail) {
+  RailStriper striper;
+  striper.Init(3U, MakeConfig({}, kMiB));
+  const std::vector<TransferOpDesc> op_descs = {{0x1000U, 0x9000U, 4096U}, {0x3000U, 0xB000U, 8192U}};
+  std::vector<std::vector<TransferOpDesc>> rail_op_descs;
+  striper.Split(op_descs, rail_op_descs);
+  ASSERT_EQ(rail_op_descs.size(), 3U);
+  ASSERT_EQ(rail_op_descs[0U].size(), 2U);
+  EXPECT_EQ(rail_op_descs[0U][1U].remote_addr, 0xB000U);
+  EXPECT_TRUE(rail_op_descs[1U].empty());
+  EXPECT_TRUE(rail_op_descs[2U].empty());
+
+  // disabled or single rail never stripes
+  RailStripeConfig disabled = MakeConfig({}, 0U);
+  disabled.enable = false;
+  striper.Init(3U, disabled);
+  EXPECT_FALSE(striper.ShouldStripe({{0x1000U, 0x9000U, 64U * kMiB}}));
+  striper.Init(1U, MakeConfig({}, 0U));
+  EXPECT_FALSE(striper.ShouldStripe({{0x1000U, 0x9000U, 64U * kMiB}}));
+}
+
+TEST(RailStriperTest, ByteExactReassembly) {
+  const std::vector<double> bandwidths = {1.0, 2.0, 5.0};
+  RailStriper striper;
+  striper.Init(bandwidths.size(), MakeConfig(bandwidths));
+  std::mt19937 rng(7U);
+  std::vector<uint8_t> src(16U * kMiB);
+  for (auto &byte : src) {
+    byte = static_cast<uint8_t>(rng());
+  }
+  std::vector<uint8_t> dst(src.size(), 0U);
+  // ops of random size, the remote side is laid out in reverse so that a misplaced piece shows up
+  std::vector<TransferOpDesc> op_descs;
+  std::vector<std::pair<size_t, size_t>> ranges;
+  size_t offset = 0U;
+  while (offset < src.size()) {
+    const size_t len = std::min(src.size() - offset, static_cast<size_t>(rng() % (512U * 1024U)) + 1U);
+    ranges.emplace_back(offset, len);
+    offset += len;
+  }
+  size_t remote_offset = dst.size();
+  for (const auto &range : ranges) {
+    remote_offset -= range.second;
+    op_descs.emplace_back(TransferOpDesc{reinterpret_cast<uintptr_t>(src.data() + range.first),
+                                         reinterpret_cast<uintptr_t>(dst.data() + remote_offset), range.second});
+  }
+  std::vector<std::vector<TransferOpDesc>> rail_op_descs;
+  striper.Split(op_descs, rail_op_descs);
+  RunRails(rail_op_descs);
+
+  remote_offset = dst.size();
+  for (const auto &range : ranges) {
+    remote_offset -= range.second;
+    ASSERT_EQ(memcmp(src.data() + range.first, dst.data() + remote_offset, range.second), 0);
+  }
+  // every rail gets its weighted share up to one alignment unit
+  uint64_t total = 0U;
+  for (size_t i = 0U; i < rail_op_descs.size(); ++i) {
+    const uint64_t bytes = TotalBytes(rail_op_descs[i]);
+    total += bytes;
+    const double expected = static_cast<double>(src.size()) * bandwidths[i] / 8.0;
+    EXPECT_LE(std::abs(static_cast<double>(bytes) - expected), static_cast<double>(2U * RailStriper::kStripeAlign));
+  }
+  EXPECT_EQ(total, src.size());
+}
+
+TEST(RailStriperTest, MeasuredWeights) {
+  RailStriper striper;
+  striper.Init(2U, MakeConfig({}));
+  auto weights = striper.GetWeights();
+  EXPECT_DOUBLE_EQ(weights[0U], 0.5);
+  // an unmeasured rail is assumed to be as fast as the average measured one
+  striper.RecordTransfer(0U, 1000U, 100U);
+  weights = striper.GetWeights();
+  EXPECT_DOUBLE_EQ(weights[0U], 0.5);
+  for (int32_t i = 0; i < 50; ++i) {
+    striper.RecordTransfer(1U, 3000U, 100U);
+  }
+  weights = striper.GetWeights();
+  EXPECT_NEAR(weights[0U], 0.25, 1e-6);
+  EXPECT_NEAR(weights[1U], 0.75, 1e-6);
+
+  // a very slow rail keeps a minimum share so that it is still measured
+  striper.Init(2U, MakeConfig({}));
+  striper.RecordTransfer(0U, 1U, 1000000U);
+  striper.RecordTransfer(1U, 1000000U, 1U);
+  weights = striper.GetWeights();
+  EXPECT_GT(weights[0U], 0.01);
+
+  // configured bandwidths win over measurement, a mismatched list falls back to measurement
+  striper.Init(2U, MakeConfig({1.0, 3.0}));
+  striper.RecordTransfer(0U, 1000000U, 1U);
+  EXPECT_NEAR(striper.GetWeights()[1U], 0.75, 1e-9);
+  striper.Init(3U, MakeConfig({1.0, 3.0}));
+  EXPECT_NEAR(striper.GetWeights()[2U], 1.0 / 3.0, 1e-9);
+}
+
+TEST(RailStriperTest, LoadConfigFromEnv) {
+  std::vector<double> bandwidths;
+  EXPECT_EQ(RailStriper::ParseBandwidths("100,200.5,50", bandwidths), SUCCESS);
+  EXPECT_EQ(bandwidths, (std::vector<double>{100.0, 200.5, 50.0}));
+  EXPECT_NE(RailStriper::ParseBandwidths("100,,50", bandwidths), SUCCESS);
+  EXPECT_NE(RailStriper::ParseBandwidths("100,-1", bandwidths), SUCCESS);
+  EXPECT_NE(RailStriper::ParseBandwidths("fast", bandwidths), SUCCESS);
+
+  (void)setenv("HIXL_MULTI_RAIL", "1", 1);
+  (void)setenv("HIXL_MULTI_RAIL_MIN_BYTES", "65536", 1);
+  (void)setenv("HIXL_RAIL_BANDWIDTH", "25,50", 1);
+  RailStripeConfig config;
+  EXPECT_EQ(RailStriper::LoadConfigFromEnv(config), SUCCESS);
+  EXPECT_TRUE(config.enable);
+  EXPECT_EQ(config.min_stripe_bytes, 65536U);
+  EXPECT_EQ(config.bandwidths, (std::vector<double>{25.0, 50.0}));
+  (void)setenv("HIXL_MULTI_RAIL_MIN_BYTES", "64k", 1);
+  EXPECT_NE(RailStriper::LoadConfigFromEnv(config), SUCCESS);
+  (void)unsetenv("HIXL_MULTI_RAIL");
+  (void)unsetenv("HIXL_MULTI_RAIL_MIN_BYTES");
+  (void)unsetenv("HIXL_RAIL_BANDWIDTH");
+  config = RailStripeConfig{};
+  EXPECT_EQ(RailStriper::LoadConfigFromEnv(config), SUCCESS);
+  EXPECT_FALSE(config.enable);
+}
+
+TEST(RailStriperTest, SplitFollowsRailBandwidth) {
+  // bytes per microsecond, i.e. 1, 2 and 4 GB/s
+  const std::vector<double> bandwidths = {1000.0, 2000.0, 4000.0};
+  std::vector<TransferOpDesc> op_descs;
+  for (uint64_t i = 0U; i < 64U; ++i) {
+    op_descs.emplace_back(TransferOpDesc{0x10000000U + i * 256U * 1024U, 0x80000000U + i * 256U * 1024U,
+                                         256U * 1024U});
+  }
+  const uint64_t total = TotalBytes(op_descs);
+  RailStriper single;
+  single.Init(1U, MakeConfig({}));
+  ExpectShares(SplitBytes(single, op_descs), {1.0}, total);
+  RailStriper equal;
+  equal.Init(bandwidths.size(), MakeConfig({1.0, 1.0, 1.0}));
+  ExpectShares(SplitBytes(equal, op_descs), {1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0}, total);
+  RailStriper configured;
+  configured.Init(bandwidths.size(), MakeConfig(bandwidths));
+  ExpectShares(SplitBytes(configured, op_descs), {1.0 / 7.0, 2.0 / 7.0, 4.0 / 7.0}, total);
+
+  // measured rails converge to the same split once every rail has reported its rate
+  RailStriper measured;
+  measured.Init(bandwidths.size(), MakeConfig({}));
+  ExpectShares(SplitBytes(measured, op_descs), {1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0}, total);
+  for (int32_t loop = 0; loop < 50; ++loop) {
+    for (size_t i = 0U; i < bandwidths.size(); ++i) {
+      measured.RecordTransfer(i, static_cast<uint64_t>(bandwidths[i]) * 1000U, 1000U);
+    }
+  }
+  ExpectShares(SplitBytes(measured, op_descs), {1.0 / 7.0, 2.0 / 7.0, 4.0 / 7.0}, total);
+}
+}  // namespace hixl
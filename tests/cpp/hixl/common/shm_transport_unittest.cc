@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "common/shm_transport.h"
+
+namespace hixl {
+namespace {
+Status TransferAndWait(ShmImporter &importer, const std::vector<TransferOpDesc> &op_descs, TransferOp operation) {
+  void *handle = nullptr;
+  Status ret = importer.TransferAsync(op_descs, operation, false, handle);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  bool completed = false;
+  while (true) {
+    ret = importer.QueryCompleteStatus(handle, completed);
+    if ((ret != SUCCESS) || completed) {
+      return ret;
+    }
+    std::this_thread::yield();
+  }
+}
+
+void FillPattern(uint8_t *buf, size_t len, uint8_t seed) {
+  for (size_t i = 0U; i < len; ++i) {
+    buf[i] = static_cast<uint8_t>(i * 31U + seed);
+  }
+}
+
+bool CheckPattern(const uint8_t *buf, size_t len, uint8_t seed) {
+  for (size_t i = 0U; i < len; ++i) {
+    if (buf[i] != static_cast<uint8_t>(i * 31U + seed)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+class ShmTransportTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(exporter_.Initialize(), SUCCESS);
+  }
+  void TearDown() override {
+    exporter_.Finalize();
+  }
+  ShmExporter exporter_;
+};
+
+TEST_F(ShmTransportTest, EndPointAdvertisesLocalPeer) {
+  const auto endpoint = exporter_.GetEndPointConfig();
+  EXPECT_EQ(endpoint.protocol, kProtocolShm);
+  EXPECT_TRUE(ShmImporter::IsLocalPeer(endpoint));
+  auto other_host = endpoint;
+  other_host.net_instance_id = "other";
+  EXPECT_FALSE(ShmImporter::IsLocalPeer(other_host));
+}
+
+TEST_F(ShmTransportTest, OnlyWholeShmBlocksAreExported) {
+  constexpr size_t kLen = 64U * 1024U;
+  std::vector<uint8_t> heap(kLen, 0U);
+  void *block = nullptr;
+  ASSERT_EQ(ShmHostMemory::Alloc(kLen, block), SUCCESS);
+  const auto block_addr = reinterpret_cast<uintptr_t>(block);
+  // heap memory and part of a block would hand the peer more than what was registered
+  exporter_.AddRegion(reinterpret_cast<uintptr_t>(heap.data()), kLen);
+  exporter_.AddRegion(block_addr + 4096U, kLen - 4096U);
+
+  ShmImporter importer;
+  ASSERT_EQ(importer.Connect(exporter_.GetEndPointConfig(), 1000U), SUCCESS);
+  EXPECT_TRUE(importer.regions_.empty());
+  EXPECT_FALSE(importer.Contains(reinterpret_cast<uintptr_t>(heap.data()), kLen));
+  EXPECT_FALSE(importer.Contains(block_addr + 4096U, 4096U));
+  importer.Finalize();
+  ShmHostMemory::Free(block);
+}
+
+TEST_F(ShmTransportTest, MappedRegionRoundTrip) {
+  constexpr size_t kLen = 8U * 1024U * 1024U;
+  void *remote = nullptr;
+  ASSERT_EQ(ShmHostMemory::Alloc(kLen, remote), SUCCESS);
+  FillPattern(static_cast<uint8_t *>(remote), kLen, 3U);
+  const auto remote_addr = reinterpret_cast<uintptr_t>(remote);
+  exporter_.AddRegion(remote_addr, kLen);
+
+  ShmTransportConfig config{};
+  config.copy_thread_num = 4U;
+  config.parallel_min_bytes = 1U;
+  ShmImporter importer(config);
+  ASSERT_EQ(importer.Connect(exporter_.GetEndPointConfig(), 1000U), SUCCESS);
+  ASSERT_EQ(importer.regions_.size(), 1U);
+  EXPECT_NE(importer.regions_.begin()->second.mapped, nullptr);
+  EXPECT_NE(importer.regions_.begin()->second.mapped, reinterpret_cast<uint8_t *>(remote_addr));
+
+  // an op in the middle of the block lands at the right offset
+  std::vector<uint8_t> local(kLen - 4096U, 0U);
+  const auto local_addr = reinterpret_cast<uintptr_t>(local.data());
+  ASSERT_EQ(TransferAndWait(importer, {{local_addr, remote_addr + 4096U, local.size()}}, READ), SUCCESS);
+  EXPECT_EQ(memcmp(local.data(), static_cast<uint8_t *>(remote) + 4096U, local.size()), 0);
+  FillPattern(local.data(), local.size(), 5U);
+  ASSERT_EQ(TransferAndWait(importer, {{local_addr, remote_addr + 4096U, local.size()}}, WRITE), SUCCESS);
+  EXPECT_TRUE(CheckPattern(static_cast<uint8_t *>(remote) + 4096U, local.size(), 5U));
+  EXPECT_TRUE(CheckPattern(static_cast<uint8_t *>(remote), 4096U, 3U));
+  importer.Finalize();
+  ShmHostMemory::Free(remote);
+}
+
+TEST_F(ShmTransportTest, RemovedRegionIsRevoked) {
+  constexpr size_t kLen = 64U * 1024U;
+  void *remote = nullptr;
+  ASSERT_EQ(ShmHostMemory::Alloc(kLen, remote), SUCCESS);
+  const auto remote_addr = reinterpret_cast<uintptr_t>(remote);
+  exporter_.AddRegion(remote_addr, kLen);
+  ShmImporter importer;
+  ASSERT_EQ(importer.Connect(exporter_.GetEndPointConfig(), 1000U), SUCCESS);
+  std::vector<uint8_t> local(kLen, 0U);
+  const auto local_addr = reinterpret_cast<uintptr_t>(local.data());
+  ASSERT_EQ(TransferAndWait(importer, {{local_addr, remote_addr, kLen}}, READ), SUCCESS);
+
+  exporter_.RemoveRegion(remote_addr);
+  EXPECT_FALSE(importer.Contains(remote_addr, kLen));
+  void *handle = nullptr;
+  EXPECT_EQ(importer.TransferAsync({{local_addr, remote_addr, kLen}}, WRITE, false, handle), PARAM_INVALID);
+  // registered again it takes the same slot with a new generation, the old import stays revoked
+  exporter_.AddRegion(remote_addr, kLen);
+  EXPECT_FALSE(importer.Contains(remote_addr, kLen));
+  ShmImporter refreshed;
+  ASSERT_EQ(refreshed.Connect(exporter_.GetEndPointConfig(), 1000U), SUCCESS);
+  EXPECT_TRUE(refreshed.Contains(remote_addr, kLen));
+  refreshed.Finalize();
+  importer.Finalize();
+  ShmHostMemory::Free(remote);
+}
+
+TEST_F(ShmTransportTest, RejectWrongTokenAndUnexportedRange) {
+  void *remote = nullptr;
+  ASSERT_EQ(ShmHostMemory::Alloc(4096U, remote), SUCCESS);
+  std::vector<uint8_t> local(4096U, 0U);
+  const auto remote_addr = reinterpret_cast<uintptr_t>(remote);
+  exporter_.AddRegion(remote_addr, 4096U);
+  auto endpoint = exporter_.GetEndPointConfig();
+  auto wrong_token = endpoint;
+  wrong_token.dst_eid[0] = (wrong_token.dst_eid[0] == 'a') ? 'b' : 'a';
+  ShmImporter rejected;
+  EXPECT_NE(rejected.Connect(wrong_token, 1000U), SUCCESS);
+  EXPECT_FALSE(rejected.IsConnected());
+
+  ShmImporter importer;
+  ASSERT_EQ(importer.Connect(endpoint, 1000U), SUCCESS);
+  const auto local_addr = reinterpret_cast<uintptr_t>(local.data());
+  EXPECT_TRUE(importer.Contains(remote_addr, 4096U));
+  EXPECT_FALSE(importer.Contains(remote_addr + 1U, 4096U));
+  void *handle = nullptr;
+  EXPECT_EQ(importer.TransferAsync({{local_addr, remote_addr + 1U, 4096U}}, READ, false, handle), PARAM_INVALID);
+  importer.Finalize();
+  ShmHostMemory::Free(remote);
+}
+
+TEST(ShmTransportCrossProcessTest, PeerProcessReadWrite) {
+  constexpr size_t kLen = 4U * 1024U * 1024U;
+  int32_t to_parent[2] = {-1, -1};
+  int32_t to_child[2] = {-1, -1};
+  ASSERT_EQ(pipe(to_parent), 0);
+  ASSERT_EQ(pipe(to_child), 0);
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // peer process: registers one memfd block and one heap buffer, only the block is exported
+    void *mapped = nullptr;
+    std::vector<uint8_t> heap(kLen, 0U);
+    ShmExporter exporter;
+    if ((ShmHostMemory::Alloc(kLen, mapped) != SUCCESS) || (exporter.Initialize() != SUCCESS)) {
+      _exit(2);
+    }
+    FillPattern(static_cast<uint8_t *>(mapped), kLen, 11U);
+    FillPattern(heap.data(), kLen, 13U);
+    exporter.AddRegion(reinterpret_cast<uintptr_t>(mapped), kLen);
+    exporter.AddRegion(reinterpret_cast<uintptr_t>(heap.data()), kLen);
+    const auto endpoint = exporter.GetEndPointConfig();
+    const std::string info = endpoint.comm_id + " " + endpoint.dst_eid + " " + endpoint.net_instance_id + " " +
+                             std::to_string(reinterpret_cast<uintptr_t>(mapped)) + " " +
+                             std::to_string(reinterpret_cast<uintptr_t>(heap.data())) + "\n";
+    (void)write(to_parent[1], info.data(), info.size());
+    char done = 0;
+    (void)read(to_child[0], &done, 1U);
+    const bool ok = CheckPattern(static_cast<uint8_t *>(mapped), kLen, 17U) && CheckPattern(heap.data(), kLen, 13U);
+    exporter.Finalize();
+    _exit(ok ? 0 : 1);
+  }
+  std::string info;
+  char c = 0;
+  while ((read(to_parent[0], &c, 1U) == 1) && (c != '\n')) {
+    info.push_back(c);
+  }
+  std::stringstream ss(info);
+  EndPointConfig endpoint{};
+  endpoint.protocol = kProtocolShm;
+  uintptr_t mapped_addr = 0U;
+  uintptr_t heap_addr = 0U;
+  ss >> endpoint.comm_id >> endpoint.dst_eid >> endpoint.net_instance_id >> mapped_addr >> heap_addr;
+  EXPECT_TRUE(ShmImporter::IsLocalPeer(endpoint));
+
+  ShmImporter importer;
+  ASSERT_EQ(importer.Connect(endpoint, 1000U), SUCCESS);
+  std::vector<uint8_t> local(kLen, 0U);
+  const auto local_addr = reinterpret_cast<uintptr_t>(local.data());
+  ASSERT_EQ(TransferAndWait(importer, {{local_addr, mapped_addr, kLen}}, READ), SUCCESS);
+  EXPECT_TRUE(CheckPattern(local.data(), kLen, 11U));
+  EXPECT_FALSE(importer.Contains(heap_addr, kLen));
+  FillPattern(local.data(), kLen, 17U);
+  ASSERT_EQ(TransferAndWait(importer, {{local_addr, mapped_addr, kLen}}, WRITE), SUCCESS);
+  importer.Finalize();
+
+  const char done = 1;
+  (void)write(to_child[1], &done, 1U);
+  int32_t status = -1;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  for (const auto fd : {to_parent[0], to_parent[1], to_child[0], to_child[1]}) {
+    (void)close(fd);
+  }
+}
+}  // namespace hixl
@@ -0,0 +1,225 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <pthread.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+#include "nlohmann/json.hpp"
+#include "common/trace_recorder.h"
+
+namespace hixl {
+namespace {
+std::vector<nlohmann::json> GetSpans(const nlohmann::json &trace, const std::string &name) {
+  std::vector<nlohmann::json> spans;
+  for (const auto &event : trace.at("traceEvents")) {
+    if ((event.at("ph") == "X") && (event.at("name") == name)) {
+      spans.emplace_back(event);
+    }
+  }
+  return spans;
+}
+
+size_t CountSpans(const nlohmann::json &trace) {
+  size_t count = 0U;
+  for (const auto &event : trace.at("traceEvents")) {
+    count += (event.at("ph") == "X") ? 1U : 0U;
+  }
+  return count;
+}
+
+size_t CountThreads(const nlohmann::json &trace, const std::string &thread_name) {
+  size_t count = 0U;
+  for (const auto &event : trace.at("traceEvents")) {
+    count += ((event.at("ph") == "M") && (event.at("args").at("name") == thread_name)) ? 1U : 0U;
+  }
+  return count;
+}
+
+void InnerStage() {
+  HIXL_TRACE_SPAN("InnerStage");
+  std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+void TracedRequest(uint64_t request_id) {
+  HIXL_TRACE_REQUEST("TracedRequest", request_id);
+  InnerStage();
+}
+}  // namespace
+
+class TraceRecorderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    TraceRecorder::GetInstance().SetEnabled(true);
+    TraceRecorder::GetInstance().Clear();
+  }
+
+  void TearDown() override {
+    TraceRecorder::GetInstance().SetEnabled(false);
+    TraceRecorder::GetInstance().Clear();
+  }
+};
+
+TEST_F(TraceRecorderTest, DisabledRecordsNothing) {
+  TraceRecorder::GetInstance().SetEnabled(false);
+  TracedRequest(1UL);
+  const auto trace = nlohmann::json::parse(TraceRecorder::GetInstance().DumpToJson());
+  EXPECT_EQ(CountSpans(trace), 0U);
+}
+
+TEST_F(TraceRecorderTest, ChromeTraceFormat) {
+  auto &recorder = TraceRecorder::GetInstance();
+  const uint64_t request_id = recorder.NewRequestId();
+  std::thread worker([request_id]() {
+    (void)pthread_setname_np(pthread_self(), "trace_worker");
+    TracedRequest(request_id);
+  });
+  worker.join();
+  {
+    HIXL_TRACE_SPAN_WITH_ID("MainSpan", 7UL);
+  }
+
+  const auto trace = nlohmann::json::parse(recorder.DumpToJson());
+  EXPECT_EQ(trace.at("displayTimeUnit"), "ns");
+  const auto outer = GetSpans(trace, "TracedRequest");
+  const auto inner = GetSpans(trace, "InnerStage");
+  const auto main_span = GetSpans(trace, "MainSpan");
+  ASSERT_EQ(outer.size(), 1U);
+  ASSERT_EQ(inner.size(), 1U);
+  ASSERT_EQ(main_span.size(), 1U);
+  for (const auto &span : {outer[0U], inner[0U], main_span[0U]}) {
+    EXPECT_EQ(span.at("cat"), "hixl");
+    EXPECT_TRUE(span.at("ts").is_number());
+    EXPECT_TRUE(span.at("dur").is_number());
+    EXPECT_EQ(span.at("pid").get<uint64_t>(), static_cast<uint64_t>(getpid()));
+  }
+  // the nested span inherits the request id and lies inside the request span
+  EXPECT_EQ(outer[0U].at("args").at("request_id").get<uint64_t>(), request_id);
+  EXPECT_EQ(inner[0U].at("args").at("request_id").get<uint64_t>(), request_id);
+  EXPECT_EQ(main_span[0U].at("args").at("request_id").get<uint64_t>(), 7UL);
+  EXPECT_EQ(outer[0U].at("tid"), inner[0U].at("tid"));
+  EXPECT_NE(outer[0U].at("tid"), main_span[0U].at("tid"));
+  EXPECT_LE(outer[0U].at("ts").get<double>(), inner[0U].at("ts").get<double>());
+  EXPECT_GE(outer[0U].at("dur").get<double>(), inner[0U].at("dur").get<double>());
+  EXPECT_GE(inner[0U].at("dur").get<double>(), 50.0);
+  EXPECT_EQ(TraceRecorder::GetCurrentRequestId(), 0UL);
+
+  bool found_thread_name = false;
+  for (const auto &event : trace.at("traceEvents")) {
+    if ((event.at("ph") == "M") && (event.at("tid") == outer[0U].at("tid"))) {
+      EXPECT_EQ(event.at("name"), "thread_name");
+      EXPECT_EQ(event.at("args").at("name"), "trace_worker");
+      found_thread_name = true;
+    }
+  }
+  EXPECT_TRUE(found_thread_name);
+
+  // spans are taken out by a dump
+  EXPECT_EQ(CountSpans(nlohmann::json::parse(recorder.DumpToJson())), 0U);
+}
+
+TEST_F(TraceRecorderTest, RingKeepsLatestSpans) {
+  const size_t span_num = TraceRecorder::kRingCapacity + 100U;
+  for (size_t i = 0U; i < span_num; ++i) {
+    HIXL_TRACE_SPAN_WITH_ID("RingSpan", i);
+  }
+  const auto spans = GetSpans(nlohmann::json::parse(TraceRecorder::GetInstance().DumpToJson()), "RingSpan");
+  ASSERT_EQ(spans.size(), TraceRecorder::kRingCapacity);
+  EXPECT_EQ(spans.front().at("args").at("request_id").get<uint64_t>(), 100UL);
+  EXPECT_EQ(spans.back().at("args").at("request_id").get<uint64_t>(), span_num - 1U);
+}
+
+TEST_F(TraceRecorderTest, DumpWhileRecording) {
+  std::atomic<bool> stop{false};
+  std::thread writer([&stop]() {
+    uint64_t request_id = 0UL;
+    while (!stop.load()) {
+      HIXL_TRACE_SPAN_WITH_ID("ConcurrentSpan", request_id++);
+    }
+  });
+  uint64_t last_request_id = 0UL;
+  size_t total = 0U;
+  for (int32_t i = 0; i < 5; ++i) {
+    const auto spans =
+        GetSpans(nlohmann::json::parse(TraceRecorder::GetInstance().DumpToJson()), "ConcurrentSpan");
+    for (const auto &span : spans) {
+      const auto request_id = span.at("args").at("request_id").get<uint64_t>();
+      // every emitted span is complete and spans come out in order
+      EXPECT_TRUE((total == 0U) || (request_id > last_request_id));
+      EXPECT_GE(span.at("dur").get<double>(), 0.0);
+      last_request_id = request_id;
+      ++total;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  stop.store(true);
+  writer.join();
+  EXPECT_GT(total, 0U);
+}
+
+TEST_F(TraceRecorderTest, FlushToFile) {
+  {
+    HIXL_TRACE_SPAN("FlushSpan");
+  }
+  const std::string file_path = "./hixl_trace_unittest.json";
+  ASSERT_EQ(TraceRecorder::GetInstance().Flush(file_path), SUCCESS);
+  std::ifstream ifs(file_path);
+  std::stringstream content;
+  content << ifs.rdbuf();
+  EXPECT_EQ(GetSpans(nlohmann::json::parse(content.str()), "FlushSpan").size(), 1U);
+  (void)std::remove(file_path.c_str());
+
+  EXPECT_EQ(TraceRecorder::GetInstance().Flush("/nonexistent_dir/trace.json"), FAILED);
+}
+
+TEST_F(TraceRecorderTest, DisabledSkipsRequestId) {
+  auto &recorder = TraceRecorder::GetInstance();
+  recorder.SetEnabled(false);
+  const uint64_t first_id = recorder.NewRequestId();
+  for (int32_t i = 0; i < 100; ++i) {
+    HIXL_TRACE_REQUEST("DisabledRequest", recorder.NewRequestId());
+    HIXL_TRACE_SPAN("DisabledSpan");
+    EXPECT_EQ(TraceRecorder::GetCurrentRequestId(), 0UL);
+  }
+  EXPECT_EQ(recorder.NewRequestId(), first_id + 1U);
+  EXPECT_EQ(CountSpans(nlohmann::json::parse(recorder.DumpToJson())), 0U);
+
+  recorder.SetEnabled(true);
+  {
+    HIXL_TRACE_REQUEST("EnabledRequest", recorder.NewRequestId());
+    EXPECT_EQ(TraceRecorder::GetCurrentRequestId(), first_id + 2U);
+  }
+  const auto spans = GetSpans(nlohmann::json::parse(recorder.DumpToJson()), "EnabledRequest");
+  ASSERT_EQ(spans.size(), 1U);
+  EXPECT_EQ(spans[0U].at("args").at("request_id").get<uint64_t>(), first_id + 2U);
+}
+TEST_F(TraceRecorderTest, DropBuffersOfExitedThreads) {
+  constexpr size_t kThreadNum = 8U;
+  std::vector<std::thread> workers;
+  for (size_t i = 0U; i < kThreadNum; ++i) {
+    workers.emplace_back([]() {
+      (void)pthread_setname_np(pthread_self(), "exited_worker");
+      TracedRequest(1UL);
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  // spans of exited threads are still collected once, then their ring buffers are released
+  auto trace = nlohmann::json::parse(TraceRecorder::GetInstance().DumpToJson());
+  EXPECT_EQ(CountThreads(trace, "exited_worker"), kThreadNum);
+  EXPECT_EQ(GetSpans(trace, "TracedRequest").size(), kThreadNum);
+  trace = nlohmann::json::parse(TraceRecorder::GetInstance().DumpToJson());
+  EXPECT_EQ(CountThreads(trace, "exited_worker"), 0U);
+}
+}  // namespace hixl
@@ -0,0 +1,251 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "common/work_stealing_executor.h"
+#include "common/thread_pool.h"
+
+namespace hixl {
+namespace {
+void WaitUntil(const std::function<bool()> &cond) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while ((!cond()) && (std::chrono::steady_clock::now() < deadline)) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+}  // namespace
+
+TEST(WorkStealingExecutorTest, TaskStorage) {
+  int32_t value = 0;
+  ExecutorTask small([&value]() { value += 1; });
+  std::array<uint64_t, 16U> big_payload{};
+  big_payload[15U] = 10U;
+  ExecutorTask big([&value, big_payload]() { value += static_cast<int32_t>(big_payload[15U]); });
+  ExecutorTask moved(std::move(small));
+  EXPECT_FALSE(static_cast<bool>(small));
+  ASSERT_TRUE(static_cast<bool>(moved));
+  ASSERT_TRUE(static_cast<bool>(big));
+  moved();
+  big();
+  moved = std::move(big);
+  moved();
+  EXPECT_EQ(value, 21);
+
+  auto counter = std::make_shared<int32_t>(0);
+  {
+    ExecutorTask holder([counter]() { ++(*counter); });
+    EXPECT_EQ(counter.use_count(), 2);
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(WorkStealingExecutorTest, RunsAllTasks) {
+  std::atomic<uint32_t> init_count{0U};
+  WorkStealingExecutor executor("ws_test", 4U, [&init_count]() { (void)init_count.fetch_add(1U); });
+  std::atomic<int32_t> done{0};
+  constexpr int32_t kTaskNum = 10000;
+  std::vector<std::thread> submitters;
+  for (int32_t t = 0; t < 4; ++t) {
+    submitters.emplace_back([&executor, &done]() {
+      for (int32_t i = 0; i < kTaskNum / 4; ++i) {
+        EXPECT_TRUE(executor.Submit([&done]() { (void)done.fetch_add(1); },
+                                    (i % 2 == 0) ? TaskPriority::kHigh : TaskPriority::kNormal));
+      }
+    });
+  }
+  for (auto &submitter : submitters) {
+    submitter.join();
+  }
+  WaitUntil([&done]() { return done.load() == kTaskNum; });
+  EXPECT_EQ(done.load(), kTaskNum);
+  EXPECT_EQ(init_count.load(), 4U);
+}
+
+TEST(WorkStealingExecutorTest, HighPriorityFirst) {
+  WorkStealingExecutor executor("ws_test", 1U);
+  std::atomic<bool> release{false};
+  std::atomic<bool> blocked{false};
+  ASSERT_TRUE(executor.Submit([&release, &blocked]() {
+    blocked.store(true);
+    while (!release.load()) {
+      std::this_thread::yield();
+    }
+  }));
+  WaitUntil([&blocked]() { return blocked.load(); });
+  std::mutex mutex;
+  std::vector<int32_t> order;
+  for (int32_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(executor.Submit([&mutex, &order, i]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.emplace_back(i);
+    }));
+  }
+  for (int32_t i = 4; i < 8; ++i) {
+    ASSERT_TRUE(executor.Submit([&mutex, &order, i]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.emplace_back(i);
+    }, TaskPriority::kHigh));
+  }
+  release.store(true);
+  WaitUntil([&mutex, &order]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return order.size() == 8U;
+  });
+  // high priority tasks overtake the queued normal ones, each level keeps submission order
+  EXPECT_EQ(order, (std::vector<int32_t>{4, 5, 6, 7, 0, 1, 2, 3}));
+}
+
+TEST(WorkStealingExecutorTest, IdleWorkerSteals) {
+  WorkStealingExecutor executor("ws_test", 2U);
+  std::atomic<int32_t> done{0};
+  constexpr int32_t kTaskNum = 8;
+  // tasks submitted on a worker go to its own queue, the other worker has to steal them
+  ASSERT_TRUE(executor.Submit([&executor, &done]() {
+    for (int32_t i = 0; i < kTaskNum; ++i) {
+      (void)executor.Submit([&done]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        (void)done.fetch_add(1);
+      });
+    }
+  }));
+  WaitUntil([&done]() { return done.load() == kTaskNum; });
+  EXPECT_EQ(done.load(), kTaskNum);
+  EXPECT_GT(executor.GetStealCount(), 0UL);
+}
+
+TEST(WorkStealingExecutorTest, StopRunsPendingTasks) {
+  auto executor = std::make_unique<WorkStealingExecutor>("ws_test", 1U);
+  std::atomic<bool> started{false};
+  std::atomic<int32_t> done{0};
+  ASSERT_TRUE(executor->Submit([&started, &done]() {
+    started.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    (void)done.fetch_add(1);
+  }));
+  auto counter = std::make_shared<int32_t>(0);
+  ASSERT_TRUE(executor->Submit([counter, &done, &executor]() {
+    (void)done.fetch_add(1);
+    // a running task may still queue follow-up work while the executor drains
+    EXPECT_TRUE(executor->Submit([&done]() { (void)done.fetch_add(1); }));
+  }));
+  WaitUntil([&started]() { return started.load(); });
+  executor->Stop();
+  EXPECT_EQ(done.load(), 3);
+  EXPECT_FALSE(executor->Submit([]() {}));
+  executor.reset();
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(WorkStealingExecutorTest, SerialQueueKeepsOrder) {
+  WorkStealingExecutor executor("ws_test", 4U);
+  constexpr size_t kQueueNum = 3U;
+  constexpr int32_t kItemNum = 3000;
+  std::array<std::vector<int32_t>, kQueueNum> handled;
+  std::array<std::atomic<int32_t>, kQueueNum> running{};
+  std::atomic<bool> overlapped{false};
+  std::vector<std::unique_ptr<SerialTaskQueue<int32_t>>> queues;
+  for (size_t q = 0U; q < kQueueNum; ++q) {
+    queues.emplace_back(std::make_unique<SerialTaskQueue<int32_t>>(
+        executor, (q == 0U) ? TaskPriority::kHigh : TaskPriority::kNormal,
+        [&handled, &running, &overlapped, q](int32_t &item) {
+          if (running[q].fetch_add(1) != 0) {
+            overlapped.store(true);
+          }
+          handled[q].emplace_back(item);
+          (void)running[q].fetch_sub(1);
+        }));
+  }
+  std::vector<std::thread> producers;
+  for (size_t q = 0U; q < kQueueNum; ++q) {
+    producers.emplace_back([&queues, q]() {
+      for (int32_t i = 0; i < kItemNum; ++i) {
+        EXPECT_TRUE(queues[q]->Push(i));
+      }
+    });
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  WaitUntil([&queues]() {
+    return std::all_of(queues.begin(), queues.end(), [](const auto &queue) { return queue->Size() == 0U; });
+  });
+  executor.Stop();
+  EXPECT_FALSE(overlapped.load());
+  for (size_t q = 0U; q < kQueueNum; ++q) {
+    ASSERT_EQ(handled[q].size(), static_cast<size_t>(kItemNum));
+    for (int32_t i = 0; i < kItemNum; ++i) {
+      ASSERT_EQ(handled[q][static_cast<size_t>(i)], i);
+    }
+  }
+}
+
+TEST(WorkStealingExecutorTest, SerialQueueRejectsAfterStop) {
+  WorkStealingExecutor executor("ws_test", 1U);
+  std::atomic<int32_t> handled{0};
+  SerialTaskQueue<int32_t> queue(executor, TaskPriority::kNormal, [&handled](int32_t &) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    (void)handled.fetch_add(1);
+  });
+  for (int32_t i = 0; i < 40; ++i) {
+    EXPECT_TRUE(queue.Push(i));
+  }
+  executor.Stop();
+  // items pushed before the stop are handled, later ones are rejected even while a drain is scheduled
+  EXPECT_EQ(handled.load(), 40);
+  EXPECT_FALSE(queue.Push(1));
+  EXPECT_EQ(queue.Size(), 0U);
+  EXPECT_EQ(handled.load(), 40);
+}
+
+TEST(WorkStealingExecutorTest, ThreadPoolCommit) {
+  ThreadPool pool("ws_pool", 2U);
+  std::vector<std::future<int32_t>> futures;
+  for (int32_t i = 0; i < 100; ++i) {
+    futures.emplace_back(pool.commit([](int32_t value) { return value * 2; }, i));
+  }
+  for (int32_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(futures[static_cast<size_t>(i)].valid());
+    EXPECT_EQ(futures[static_cast<size_t>(i)].get(), i * 2);
+  }
+  pool.Destroy();
+  EXPECT_FALSE(pool.commit([]() { return 0; }).valid());
+}
+
+TEST(WorkStealingExecutorTest, ThreadPoolDestroyKeepsPromises) {
+  ThreadPool pool("ws_pool", 1U);
+  std::atomic<bool> release{false};
+  auto blocker = pool.commit([&release]() {
+    while (!release.load()) {
+      std::this_thread::yield();
+    }
+  });
+  std::vector<std::future<int32_t>> futures;
+  for (int32_t i = 0; i < 10; ++i) {
+    futures.emplace_back(pool.commit([](int32_t value) { return value + 1; }, i));
+  }
+  std::thread destroyer([&pool]() { pool.Destroy(); });
+  WaitUntil([&pool]() { return pool.executor_.IsStopped(); });
+  release.store(true);
+  destroyer.join();
+  blocker.get();
+  for (int32_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(futures[static_cast<size_t>(i)].get(), i + 1);
+  }
+}
+}  // namespace hixl
@@ -10,6 +10,7 @@
 #include <array>
 #include <cstdint>
 #include <cstdlib>
+#include <set>
 #include <thread>
 #include <chrono>
 #include <vector>
@@ -258,4 +259,27 @@ TEST_F(HixlCSClientUbFixture, BatchPutUbDeviceSlotExhaustedFail) {
   }
 }
 
+TEST(HixlCSClientFlagIndexUT, ReleasedIndexIsPushedAtStackTop) {
+  HixlCSClient cli;
+  cli.top_index_ = HixlCSClient::kFlagQueueSize;
+  const int32_t first = cli.AcquireFlagIndex();
+  const int32_t second = cli.AcquireFlagIndex();
+  ASSERT_GE(first, 0);
+  ASSERT_GE(second, 0);
+  ASSERT_NE(first, second);
+
+  // 多rail时每个rail完成即回收, 回收后栈应恢复为满且不重复发放索引
+  EXPECT_EQ(cli.ReleaseCompleteHandle(new CompleteHandle{0U, second, nullptr}), SUCCESS);
+  EXPECT_EQ(cli.ReleaseCompleteHandle(new CompleteHandle{0U, first, nullptr}), SUCCESS);
+  EXPECT_EQ(cli.top_index_, HixlCSClient::kFlagQueueSize);
+
+  std::set<int32_t> indices;
+  for (size_t i = 0U; i < HixlCSClient::kFlagQueueSize; ++i) {
+    const int32_t idx = cli.AcquireFlagIndex();
+    ASSERT_GE(idx, 0);
+    ASSERT_LT(idx, static_cast<int32_t>(HixlCSClient::kFlagQueueSize));
+    EXPECT_TRUE(indices.insert(idx).second) << "flag index " << idx << " handed out twice";
+  }
+  EXPECT_EQ(cli.AcquireFlagIndex(), -1);
+}
 }  // namespace hixl
@@ -0,0 +1,323 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "common/hixl_cs.h"
+#include "hixl/hixl_types.h"
+#include "loopback_transport.h"
+#include "hixl_test.h"
+
+#define RET_IF_FAILED(expr)    \
+  do {                         \
+    const Status ret = (expr); \
+    if (ret != SUCCESS) {      \
+      return ret;              \
+    }                          \
+  } while (false)
+
+namespace hixl {
+namespace {
+constexpr uint32_t kLoopbackPort = 16300U;
+constexpr uint32_t kLoopbackCrossProcessPort = 16301U;
+constexpr uint32_t kLoopbackLatencyPort = 16302U;
+constexpr uint32_t kBufNum = 4U;
+constexpr uint64_t kBufSize = 64UL * 1024UL;
+constexpr uint32_t kTimeoutMs = 1000U;
+constexpr uint32_t kBackLog = 1024U;
+constexpr uint32_t kSleepMs = 10U;
+constexpr uint32_t kWaitCompleteMs = 5000U;
+
+std::vector<EndpointDesc> MakeHostEndpoints() {
+  std::vector<EndpointDesc> eps(2U);
+  for (uint32_t i = 0U; i < eps.size(); ++i) {
+    eps[i].loc.locType = ENDPOINT_LOC_TYPE_HOST;
+    eps[i].protocol = COMM_PROTOCOL_ROCE;
+    eps[i].commAddr.type = COMM_ADDR_TYPE_ID;
+    eps[i].commAddr.id = i + 1U;
+  }
+  return eps;
+}
+
+uint8_t Pattern(uint32_t buf_idx, uint64_t offset) {
+  return static_cast<uint8_t>((buf_idx * 31U + offset * 7U) & 0xFFU);
+}
+
+void FillPattern(std::vector<std::vector<uint8_t>> &bufs) {
+  for (uint32_t i = 0U; i < bufs.size(); ++i) {
+    for (uint64_t j = 0UL; j < bufs[i].size(); ++j) {
+      bufs[i][j] = Pattern(i, j);
+    }
+  }
+}
+
+bool CheckPattern(const std::vector<std::vector<uint8_t>> &bufs) {
+  for (uint32_t i = 0U; i < bufs.size(); ++i) {
+    for (uint64_t j = 0UL; j < bufs[i].size(); ++j) {
+      if (bufs[i][j] != Pattern(i, j)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+class LoopbackServer {
+ public:
+  Status Start(uint32_t port, std::vector<std::vector<uint8_t>> &bufs) {
+    HixlServerConfig config{};
+    auto eps = MakeHostEndpoints();
+    RET_IF_FAILED(HixlCSServerCreate("127.0.0.1", port, eps.data(), eps.size(), &config, &handle_));
+    for (uint32_t i = 0U; i < bufs.size(); ++i) {
+      HcommMem mem = MakeMem(bufs[i].data(), bufs[i].size(), HCCL_MEM_TYPE_HOST);
+      MemHandle mem_handle = nullptr;
+      RET_IF_FAILED(HixlCSServerRegMem(handle_, ("buf" + std::to_string(i)).c_str(), &mem, &mem_handle));
+      mem_handles_.emplace_back(mem_handle);
+    }
+    RET_IF_FAILED(HixlCSServerListen(handle_, kBackLog));
+    std::this_thread::sleep_for(std::chrono::milliseconds(kSleepMs));
+    return SUCCESS;
+  }
+
+  void Stop() {
+    if (handle_ == nullptr) {
+      return;
+    }
+    for (auto mem_handle : mem_handles_) {
+      (void)HixlCSServerUnregMem(handle_, mem_handle);
+    }
+    (void)HixlCSServerDestroy(handle_);
+    handle_ = nullptr;
+    mem_handles_.clear();
+  }
+
+ private:
+  HixlServerHandle handle_ = nullptr;
+  std::vector<MemHandle> mem_handles_;
+};
+
+class LoopbackClient {
+ public:
+  Status Start(uint32_t port, std::vector<std::vector<uint8_t>> &bufs) {
+    auto eps = MakeHostEndpoints();
+    RET_IF_FAILED(HixlCSClientCreate("127.0.0.1", port, &eps[0U], &eps[1U], &handle_));
+    for (auto &buf : bufs) {
+      HcommMem mem = MakeMem(buf.data(), buf.size(), HCCL_MEM_TYPE_HOST);
+      MemHandle mem_handle = nullptr;
+      RET_IF_FAILED(HixlCSClientRegMem(handle_, nullptr, &mem, &mem_handle));
+      mem_handles_.emplace_back(mem_handle);
+    }
+    RET_IF_FAILED(HixlCSClientConnectSync(handle_, kTimeoutMs));
+    HcommMem *remote_mem_list = nullptr;
+    char **mem_tag_list = nullptr;
+    uint32_t list_num = 0U;
+    RET_IF_FAILED(HixlCSClientGetRemoteMem(handle_, &remote_mem_list, &mem_tag_list, &list_num, kTimeoutMs));
+    remote_bufs_.assign(bufs.size(), nullptr);
+    for (uint32_t i = 0U; i < list_num; ++i) {
+      const std::string tag = (mem_tag_list[i] != nullptr) ? mem_tag_list[i] : "";
+      for (uint32_t j = 0U; j < bufs.size(); ++j) {
+        if (tag == "buf" + std::to_string(j)) {
+          remote_bufs_[j] = remote_mem_list[i].addr;
+        }
+      }
+    }
+    for (auto addr : remote_bufs_) {
+      if (addr == nullptr) {
+        return FAILED;
+      }
+    }
+    return SUCCESS;
+  }
+
+  Status Transfer(bool is_get, std::vector<std::vector<uint8_t>> &bufs) {
+    std::vector<void *> local_list;
+    std::vector<uint64_t> len_list;
+    for (auto &buf : bufs) {
+      local_list.emplace_back(buf.data());
+      len_list.emplace_back(buf.size());
+    }
+    void *complete_handle = nullptr;
+    if (is_get) {
+      std::vector<const void *> remote_list(remote_bufs_.begin(), remote_bufs_.end());
+      RET_IF_FAILED(HixlCSClientBatchGet(handle_, bufs.size(), local_list.data(), remote_list.data(),
+                                         len_list.data(), &complete_handle));
+    } else {
+      std::vector<const void *> const_local_list(local_list.begin(), local_list.end());
+      RET_IF_FAILED(HixlCSClientBatchPut(handle_, bufs.size(), remote_bufs_.data(), const_local_list.data(),
+                                         len_list.data(), &complete_handle));
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kWaitCompleteMs);
+    while (std::chrono::steady_clock::now() < deadline) {
+      int32_t status = BatchTransferStatus::WAITING;
+      RET_IF_FAILED(HixlCSClientQueryCompleteStatus(handle_, complete_handle, &status));
+      if (status == BatchTransferStatus::COMPLETED) {
+        return SUCCESS;
+      }
+      std::this_thread::yield();
+    }
+    return TIMEOUT;
+  }
+
+  void Stop() {
+    if (handle_ == nullptr) {
+      return;
+    }
+    for (auto mem_handle : mem_handles_) {
+      (void)HixlCSClientUnregMem(handle_, mem_handle);
+    }
+    (void)HixlCSClientDestroy(handle_);
+    handle_ = nullptr;
+    mem_handles_.clear();
+  }
+
+ private:
+  HixlClientHandle handle_ = nullptr;
+  std::vector<MemHandle> mem_handles_;
+  std::vector<void *> remote_bufs_;
+};
+}  // namespace
+
+class HixlCSLoopbackTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    LoopbackConfig config{};
+    config.enable = true;
+    SetLoopbackConfig(config);
+  }
+  void TearDown() override {
+    SetLoopbackConfig(LoopbackConfig{});
+  }
+};
+
+TEST_F(HixlCSLoopbackTest, PutThenGetInProcess) {
+  std::vector<std::vector<uint8_t>> server_bufs(kBufNum, std::vector<uint8_t>(kBufSize, 0U));
+  std::vector<std::vector<uint8_t>> client_bufs(kBufNum, std::vector<uint8_t>(kBufSize, 0U));
+  LoopbackServer server;
+  ASSERT_EQ(server.Start(kLoopbackPort, server_bufs), SUCCESS);
+  LoopbackClient client;
+  ASSERT_EQ(client.Start(kLoopbackPort, client_bufs), SUCCESS);
+
+  FillPattern(client_bufs);
+  EXPECT_EQ(client.Transfer(false, client_bufs), SUCCESS);
+  EXPECT_TRUE(CheckPattern(server_bufs));
+
+  for (auto &buf : client_bufs) {
+    std::fill(buf.begin(), buf.end(), 0U);
+  }
+  EXPECT_EQ(client.Transfer(true, client_bufs), SUCCESS);
+  EXPECT_TRUE(CheckPattern(client_bufs));
+  client.Stop();
+  server.Stop();
+}
+
+TEST_F(HixlCSLoopbackTest, EmulateLatencyAndBandwidth) {
+  LoopbackConfig config{};
+  config.enable = true;
+  config.latency_us = 20000UL;
+  config.bandwidth_mbps = 64UL;
+  SetLoopbackConfig(config);
+  std::vector<std::vector<uint8_t>> server_bufs(kBufNum, std::vector<uint8_t>(kBufSize, 0U));
+  std::vector<std::vector<uint8_t>> client_bufs(kBufNum, std::vector<uint8_t>(kBufSize, 0U));
+  LoopbackServer server;
+  ASSERT_EQ(server.Start(kLoopbackLatencyPort, server_bufs), SUCCESS);
+  LoopbackClient client;
+  ASSERT_EQ(client.Start(kLoopbackLatencyPort, client_bufs), SUCCESS);
+
+  // 256KB在64MB/s下需要约4ms, 加上20ms时延
+  FillPattern(client_bufs);
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(client.Transfer(false, client_bufs), SUCCESS);
+  const auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  EXPECT_GE(cost.count(), 23000);
+  EXPECT_TRUE(CheckPattern(server_bufs));
+  client.Stop();
+  server.Stop();
+}
+
+TEST_F(HixlCSLoopbackTest, PutThenGetCrossProcess) {
+  int32_t ready_pipe[2] = {-1, -1};
+  int32_t done_pipe[2] = {-1, -1};
+  ASSERT_EQ(pipe(ready_pipe), 0);
+  ASSERT_EQ(pipe(done_pipe), 0);
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // server进程: client写入后校验数据, 再把数据取反供client读回
+    std::vector<std::vector<uint8_t>> server_bufs(kBufNum, std::vector<uint8_t>(kBufSize, 0U));
+    LoopbackServer server;
+    char result = ((AllowLoopbackPeerAccess(getppid()) == SUCCESS) &&
+                   (server.Start(kLoopbackCrossProcessPort, server_bufs) == SUCCESS)) ? 1 : 0;
+    (void)write(ready_pipe[1], &result, 1U);
+    char step = 0;
+    (void)read(done_pipe[0], &step, 1U);
+    int32_t exit_code = CheckPattern(server_bufs) ? 0 : 1;
+    for (auto &buf : server_bufs) {
+      for (auto &byte : buf) {
+        byte = static_cast<uint8_t>(~byte);
+      }
+    }
+    (void)write(ready_pipe[1], &result, 1U);
+    (void)read(done_pipe[0], &step, 1U);
+    server.Stop();
+    _exit(exit_code);
+  }
+  char result = 0;
+  ASSERT_EQ(read(ready_pipe[0], &result, 1U), 1);
+  ASSERT_EQ(result, 1);
+  std::vector<std::vector<uint8_t>> client_bufs(kBufNum, std::vector<uint8_t>(kBufSize, 0U));
+  LoopbackClient client;
+  EXPECT_EQ(client.Start(kLoopbackCrossProcessPort, client_bufs), SUCCESS);
+  FillPattern(client_bufs);
+  EXPECT_EQ(client.Transfer(false, client_bufs), SUCCESS);
+  char step = 1;
+  EXPECT_EQ(write(done_pipe[1], &step, 1U), 1);
+  EXPECT_EQ(read(ready_pipe[0], &result, 1U), 1);
+  EXPECT_EQ(client.Transfer(true, client_bufs), SUCCESS);
+  for (auto &buf : client_bufs) {
+    for (auto &byte : buf) {
+      byte = static_cast<uint8_t>(~byte);
+    }
+  }
+  EXPECT_TRUE(CheckPattern(client_bufs));
+  client.Stop();
+  EXPECT_EQ(write(done_pipe[1], &step, 1U), 1);
+  int32_t status = -1;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  for (auto fd : {ready_pipe[0], ready_pipe[1], done_pipe[0], done_pipe[1]}) {
+    (void)close(fd);
+  }
+}
+
+TEST_F(HixlCSLoopbackTest, InvalidMemDesc) {
+  uint64_t value = 0UL;
+  void *desc = nullptr;
+  uint32_t desc_len = 0U;
+  EXPECT_NE(BuildLoopbackMemDesc(MakeMem(&value, sizeof(value), HCCL_MEM_TYPE_DEVICE), desc, desc_len), SUCCESS);
+  ASSERT_EQ(BuildLoopbackMemDesc(MakeMem(&value, sizeof(value), HCCL_MEM_TYPE_HOST), desc, desc_len), SUCCESS);
+  LoopbackMemDesc mem_desc{};
+  EXPECT_EQ(ParseLoopbackMemDesc(desc, desc_len, mem_desc), SUCCESS);
+  EXPECT_EQ(mem_desc.pid, static_cast<int32_t>(getpid()));
+  EXPECT_EQ(mem_desc.addr, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&value)));
+  EXPECT_EQ(mem_desc.size, sizeof(value));
+  EXPECT_NE(ParseLoopbackMemDesc(desc, desc_len - 1U, mem_desc), SUCCESS);
+  static_cast<LoopbackMemDesc *>(desc)->magic = 0U;
+  EXPECT_NE(ParseLoopbackMemDesc(desc, desc_len, mem_desc), SUCCESS);
+  std::free(desc);
+}
+}  // namespace hixl
@@ -0,0 +1,325 @@
+/**
+ * Copyright (c) 2026 Huawei Technologies Co., Ltd.
+ * This program is free software, you can redistribute it and/or modify it under the terms and conditions of
+ * CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "nlohmann/json.hpp"
+#include "common/ctrl_msg_plugin.h"
+#include "mem_msg_handler.h"
+#include "msg_receiver.h"
+
+namespace hixl {
+namespace {
+using Clock = std::chrono::steady_clock;
+constexpr uint32_t kExportLen = 128U;
+
+void AppendMsg(std::vector<uint8_t> &stream, CtrlMsgType msg_type, const std::string &body) {
+  CtrlMsgHeader header{};
+  header.magic = kMagicNumber;
+  header.body_size = sizeof(CtrlMsgType) + body.size();
+  const auto *header_ptr = reinterpret_cast<const uint8_t *>(&header);
+  const auto *type_ptr = reinterpret_cast<const uint8_t *>(&msg_type);
+  stream.insert(stream.end(), header_ptr, header_ptr + sizeof(header));
+  stream.insert(stream.end(), type_ptr, type_ptr + sizeof(msg_type));
+  stream.insert(stream.end(), body.begin(), body.end());
+}
+
+std::string MakeBody(size_t idx, size_t size) {
+  std::string body(size, '\0');
+  for (size_t i = 0U; i < size; ++i) {
+    body[i] = static_cast<char>((idx * 31U + i) & 0xFFU);
+  }
+  return body;
+}
+
+void SetNonBlock(int32_t fd) {
+  const int32_t flags = ::fcntl(fd, F_GETFL, 0);
+  ASSERT_GE(flags, 0);
+  ASSERT_EQ(::fcntl(fd, F_SETFL, flags | O_NONBLOCK), 0);
+}
+
+// 等待fd可读后调用一次IRecv, 直到收齐msg_num个消息
+void RecvMsgs(MsgReceiver &receiver, int32_t fd, size_t msg_num, std::vector<CtrlMsgPtr> &msgs) {
+  const auto deadline = Clock::now() + std::chrono::seconds(10);
+  while ((msgs.size() < msg_num) && (Clock::now() < deadline)) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (::poll(&pfd, 1, 100) <= 0) {
+      continue;
+    }
+    ASSERT_EQ(receiver.IRecv(msgs), SUCCESS);
+  }
+  ASSERT_EQ(msgs.size(), msg_num);
+}
+
+GetRemoteMemResp MakeResp(size_t desc_num) {
+  GetRemoteMemResp resp{};
+  resp.result = SUCCESS;
+  resp.mem_descs.resize(desc_num);
+  for (size_t i = 0U; i < desc_num; ++i) {
+    auto &desc = resp.mem_descs[i];
+    desc.mem.type = (i % 2U == 0U) ? HCCL_MEM_TYPE_DEVICE : HCCL_MEM_TYPE_HOST;
+    desc.mem.addr = reinterpret_cast<void *>(static_cast<uintptr_t>(0x100000000ULL + i * 0x200000ULL));
+    desc.mem.size = 0x200000ULL + i;
+    desc.tag = "kv_cache_" + std::to_string(i);
+    desc.export_desc = std::malloc(kExportLen);
+    desc.export_len = kExportLen;
+    auto *data = static_cast<uint8_t *>(desc.export_desc);
+    for (uint32_t j = 0U; j < kExportLen; ++j) {
+      data[j] = static_cast<uint8_t>((i + j) & 0xFFU);
+    }
+  }
+  return resp;
+}
+
+void FreeDescs(std::vector<HixlMemDesc> &descs) {
+  for (auto &desc : descs) {
+    std::free(desc.export_desc);
+    desc.export_desc = nullptr;
+  }
+  descs.clear();
+}
+
+void ExpectSameDescs(const std::vector<HixlMemDesc> &expect, const std::vector<HixlMemDesc> &actual) {
+  ASSERT_EQ(expect.size(), actual.size());
+  for (size_t i = 0U; i < expect.size(); ++i) {
+    EXPECT_EQ(expect[i].tag, actual[i].tag);
+    EXPECT_EQ(expect[i].mem.type, actual[i].mem.type);
+    EXPECT_EQ(expect[i].mem.addr, actual[i].mem.addr);
+    EXPECT_EQ(expect[i].mem.size, actual[i].mem.size);
+    ASSERT_EQ(expect[i].export_len, actual[i].export_len);
+    ASSERT_NE(actual[i].export_desc, nullptr);
+    EXPECT_EQ(memcmp(expect[i].export_desc, actual[i].export_desc, expect[i].export_len), 0);
+  }
+}
+
+// 旧版本server的json格式
+std::string ToLegacyJson(const GetRemoteMemResp &resp) {
+  nlohmann::json j;
+  j["result"] = resp.result;
+  j["mem_descs"] = nlohmann::json::array();
+  for (const auto &desc : resp.mem_descs) {
+    nlohmann::json item;
+    item["tag"] = desc.tag;
+    item["mem"] = {{"type", desc.mem.type},
+                   {"addr", static_cast<uint64_t>(reinterpret_cast<uintptr_t>(desc.mem.addr))},
+                   {"size", desc.mem.size}};
+    item["export_desc"] = nlohmann::json::array();
+    const auto *data = static_cast<const uint8_t *>(desc.export_desc);
+    for (uint32_t i = 0U; i < desc.export_len; ++i) {
+      item["export_desc"].push_back(static_cast<int>(data[i]));
+    }
+    j["mem_descs"].push_back(item);
+  }
+  return j.dump();
+}
+
+const uint8_t *PayloadOf(const std::vector<uint8_t> &msg) {
+  return msg.data() + sizeof(CtrlMsgHeader) + sizeof(CtrlMsgType);
+}
+
+size_t PayloadLenOf(const std::vector<uint8_t> &msg) {
+  return msg.size() - sizeof(CtrlMsgHeader) - sizeof(CtrlMsgType);
+}
+
+// 按HixlCSServer::GetRemoteMem的长度校验处理req_num个请求, 旧版本server只接受kLegacyGetRemoteMemReqSize长度的请求
+void ServeGetRemoteMem(int32_t fd, bool legacy_server, const GetRemoteMemResp &resp, size_t req_num,
+                       std::vector<size_t> &req_lens) {
+  for (size_t i = 0U; i < req_num; ++i) {
+    CtrlMsgHeader header{};
+    CtrlMsgType msg_type{};
+    ASSERT_EQ(CtrlMsgPlugin::Recv(fd, &header, sizeof(header), 10000U), SUCCESS);
+    ASSERT_EQ(CtrlMsgPlugin::Recv(fd, &msg_type, sizeof(msg_type), 10000U), SUCCESS);
+    ASSERT_EQ(msg_type, CtrlMsgType::kGetRemoteMemReq);
+    const size_t req_len = static_cast<size_t>(header.body_size) - sizeof(CtrlMsgType);
+    ASSERT_LE(req_len, sizeof(GetRemoteMemReq));
+    GetRemoteMemReq req{};
+    ASSERT_EQ(CtrlMsgPlugin::Recv(fd, &req, req_len, 10000U), SUCCESS);
+    req_lens.emplace_back(req_len);
+    const bool accepted =
+        (req_len == kLegacyGetRemoteMemReqSize) || ((!legacy_server) && (req_len == sizeof(GetRemoteMemReq)));
+    if (!accepted) {
+      GetRemoteMemResp failed_resp{};
+      failed_resp.result = FAILED;
+      ASSERT_EQ(MemMsgHandler::SendGetRemoteMemResponse(fd, failed_resp, false), SUCCESS);
+      continue;
+    }
+    EXPECT_EQ(req.dst_ep_handle, 0x1234UL);
+    const bool binary = (!legacy_server) && ((req.flags & kGetRemoteMemFlagBinaryResp) != 0U);
+    ASSERT_EQ(MemMsgHandler::SendGetRemoteMemResponse(fd, resp, binary), SUCCESS);
+  }
+}
+}  // namespace
+
+class MsgReceiverTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds_), 0);
+  }
+  void TearDown() override {
+    for (auto &fd : fds_) {
+      if (fd >= 0) {
+        (void)::close(fd);
+        fd = -1;
+      }
+    }
+  }
+  int32_t fds_[2] = {-1, -1};
+};
+
+TEST_F(MsgReceiverTest, MsgsSplitAtAnyOffset) {
+  constexpr size_t kMsgNum = 200U;
+  std::vector<uint8_t> stream;
+  for (size_t i = 0U; i < kMsgNum; ++i) {
+    AppendMsg(stream, (i % 2U == 0U) ? CtrlMsgType::kGetRemoteMemReq : CtrlMsgType::kCreateChannelReq,
+              MakeBody(i, (i * 37U) % 3000U));
+  }
+  SetNonBlock(fds_[0]);
+  MsgReceiver receiver(fds_[0]);
+  std::vector<CtrlMsgPtr> msgs;
+  // 分片长度与消息边界错开, 覆盖header和body被拆开的情况
+  const size_t chunk_sizes[] = {1U, 3U, 7U, 13U, 4095U, 4097U, 9000U};
+  size_t offset = 0U;
+  size_t round = 0U;
+  while (offset < stream.size()) {
+    const size_t len = std::min(chunk_sizes[round++ % (sizeof(chunk_sizes) / sizeof(chunk_sizes[0]))],
+                                stream.size() - offset);
+    ASSERT_EQ(::write(fds_[1], stream.data() + offset, len), static_cast<ssize_t>(len));
+    offset += len;
+    ASSERT_EQ(receiver.IRecv(msgs), SUCCESS);
+  }
+  RecvMsgs(receiver, fds_[0], kMsgNum, msgs);
+  for (size_t i = 0U; i < kMsgNum; ++i) {
+    EXPECT_EQ(msgs[i]->msg_type, (i % 2U == 0U) ? CtrlMsgType::kGetRemoteMemReq : CtrlMsgType::kCreateChannelReq);
+    EXPECT_EQ(msgs[i]->msg, MakeBody(i, (i * 37U) % 3000U));
+  }
+}
+
+TEST_F(MsgReceiverTest, LargeBodyAndDisconnect) {
+  const std::string large_body = MakeBody(1U, 3U * 1024U * 1024U + 5U);
+  std::vector<uint8_t> stream;
+  AppendMsg(stream, CtrlMsgType::kGetRemoteMemReq, large_body);
+  AppendMsg(stream, CtrlMsgType::kCreateChannelReq, MakeBody(2U, 16U));
+  SetNonBlock(fds_[0]);
+  std::thread writer([this, &stream]() {
+    EXPECT_EQ(CtrlMsgPlugin::Send(fds_[1], stream.data(), stream.size()), SUCCESS);
+  });
+  MsgReceiver receiver(fds_[0]);
+  std::vector<CtrlMsgPtr> msgs;
+  RecvMsgs(receiver, fds_[0], 2U, msgs);
+  writer.join();
+  EXPECT_EQ(msgs[0]->msg, large_body);
+  EXPECT_EQ(msgs[1]->msg, MakeBody(2U, 16U));
+
+  (void)::close(fds_[1]);
+  fds_[1] = -1;
+  RecvMsgs(receiver, fds_[0], 3U, msgs);
+  EXPECT_EQ(msgs[2]->msg_type, CtrlMsgType::kDestroyChannelReq);
+}
+
+TEST_F(MsgReceiverTest, InvalidHeader) {
+  std::vector<uint8_t> stream;
+  AppendMsg(stream, CtrlMsgType::kCreateChannelReq, MakeBody(0U, 8U));
+  stream[0] ^= 0xFFU;
+  ASSERT_EQ(::write(fds_[1], stream.data(), stream.size()), static_cast<ssize_t>(stream.size()));
+  MsgReceiver receiver(fds_[0]);
+  std::vector<CtrlMsgPtr> msgs;
+  EXPECT_EQ(receiver.IRecv(msgs), PARAM_INVALID);
+  EXPECT_TRUE(msgs.empty());
+}
+
+TEST_F(MsgReceiverTest, GetRemoteMemRoundTrip) {
+  // 二进制格式之后的json格式回复在大消息之后复用同一个接收缓冲区
+  for (const bool binary : {true, false}) {
+    for (const size_t desc_num : {0U, 1U, 100U, 10000U}) {
+      auto resp = MakeResp(desc_num);
+      std::thread writer([this, &resp, binary]() {
+        EXPECT_EQ(MemMsgHandler::SendGetRemoteMemResponse(fds_[1], resp, binary), SUCCESS);
+      });
+      std::vector<HixlMemDesc> descs;
+      EXPECT_EQ(MemMsgHandler::RecvGetRemoteMemResponse(fds_[0], descs, 10000U), SUCCESS);
+      writer.join();
+      ExpectSameDescs(resp.mem_descs, descs);
+      FreeDescs(descs);
+      FreeDescs(resp.mem_descs);
+    }
+  }
+}
+
+TEST_F(MsgReceiverTest, GetRemoteMemFromOldAndNewServer) {
+  auto resp = MakeResp(8U);
+  // 旧版本server拒绝带flags的请求, client用旧格式的请求重试
+  std::vector<size_t> req_lens;
+  std::thread old_server([this, &resp, &req_lens]() { ServeGetRemoteMem(fds_[1], true, resp, 2U, req_lens); });
+  std::vector<HixlMemDesc> descs;
+  EXPECT_EQ(MemMsgHandler::GetRemoteMem(fds_[0], 0x1234UL, descs, 10000U), SUCCESS);
+  old_server.join();
+  EXPECT_EQ(req_lens, (std::vector<size_t>{sizeof(GetRemoteMemReq), kLegacyGetRemoteMemReqSize}));
+  ExpectSameDescs(resp.mem_descs, descs);
+  FreeDescs(descs);
+
+  // 新版本server一次请求即回复二进制格式
+  req_lens.clear();
+  std::thread new_server([this, &resp, &req_lens]() { ServeGetRemoteMem(fds_[1], false, resp, 1U, req_lens); });
+  EXPECT_EQ(MemMsgHandler::GetRemoteMem(fds_[0], 0x1234UL, descs, 10000U), SUCCESS);
+  new_server.join();
+  EXPECT_EQ(req_lens, (std::vector<size_t>{sizeof(GetRemoteMemReq)}));
+  ExpectSameDescs(resp.mem_descs, descs);
+  FreeDescs(descs);
+  FreeDescs(resp.mem_descs);
+}
+
+TEST_F(MsgReceiverTest, ParseLegacyJsonResp) {
+  auto resp = MakeResp(16U);
+  const std::string json = ToLegacyJson(resp);
+  std::vector<HixlMemDesc> descs;
+  EXPECT_EQ(MemMsgHandler::ParseGetRemoteMemResp(reinterpret_cast<const uint8_t *>(json.data()), json.size(), descs),
+            SUCCESS);
+  ExpectSameDescs(resp.mem_descs, descs);
+  FreeDescs(descs);
+
+  // 未声明支持二进制格式的旧版本client收到的json与旧版本server一致
+  std::vector<uint8_t> msg;
+  ASSERT_EQ(MemMsgHandler::SerializeGetRemoteMemResp(resp, false, msg), SUCCESS);
+  const auto *payload = reinterpret_cast<const char *>(PayloadOf(msg));
+  EXPECT_EQ(nlohmann::json::parse(payload, payload + PayloadLenOf(msg)), nlohmann::json::parse(json));
+  FreeDescs(resp.mem_descs);
+}
+
+TEST_F(MsgReceiverTest, ParseInvalidBinaryResp) {
+  auto resp = MakeResp(4U);
+  std::vector<uint8_t> msg;
+  ASSERT_EQ(MemMsgHandler::SerializeGetRemoteMemResp(resp, true, msg), SUCCESS);
+  std::vector<HixlMemDesc> descs;
+  // 截断在最后一个export_desc中间
+  EXPECT_EQ(MemMsgHandler::ParseGetRemoteMemResp(PayloadOf(msg), PayloadLenOf(msg) - 1U, descs), PARAM_INVALID);
+  EXPECT_TRUE(descs.empty());
+  // 多余的尾部数据
+  msg.push_back(0U);
+  EXPECT_EQ(MemMsgHandler::ParseGetRemoteMemResp(PayloadOf(msg), PayloadLenOf(msg), descs), PARAM_INVALID);
+  EXPECT_TRUE(descs.empty());
+
+  FreeDescs(resp.mem_descs);
+  resp.result = FAILED;
+  ASSERT_EQ(MemMsgHandler::SerializeGetRemoteMemResp(resp, true, msg), SUCCESS);
+  EXPECT_EQ(MemMsgHandler::ParseGetRemoteMemResp(PayloadOf(msg), PayloadLenOf(msg), descs), FAILED);
+  EXPECT_TRUE(descs.empty());
+}
+
+}  // namespace hixl
@@ -905,6 +905,23 @@ TEST_F(HixlClientUTest, GetTransferStatusSuccessTest) {
   std::cout << "TransferStatus: " << static_cast<int>(status) << std::endl;
 }
 
+// GetTransferStatus 接口测试：并发的异步请求各自独立查询
+TEST_F(HixlClientUTest, GetTransferStatusMultiRequestTest) {
+  SetupTransferTest();
+  auto op_descs = CreateTransferOps();
+  auto first = CreateAsyncTransfer(op_descs, WRITE);
+  auto second = CreateAsyncTransfer(op_descs, READ);
+  EXPECT_NE(first, second);
+  TransferStatus status = TransferStatus::TIMEOUT;
+  EXPECT_EQ(client_->GetTransferStatus(first, status), SUCCESS);
+  EXPECT_EQ(status, TransferStatus::COMPLETED);
+  // 第一个请求结束后不应影响第二个请求
+  status = TransferStatus::TIMEOUT;
+  EXPECT_EQ(client_->GetTransferStatus(second, status), SUCCESS);
+  EXPECT_EQ(status, TransferStatus::COMPLETED);
+  EXPECT_EQ(client_->GetTransferStatus(first, status), FAILED);
+}
+
 // GetTransferStatus 接口测试：异常场景 - 未传输
 TEST_F(HixlClientUTest, GetTransferStatusNoTransferTest) {
   SetupTransferTest();
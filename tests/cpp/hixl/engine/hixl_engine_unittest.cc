@@ -8,9 +8,14 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 
+#include <cstdlib>
+#include <sstream>
 #include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 #include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include "engine/hixl_engine.h"
@@ -195,10 +200,10 @@ TEST_F(HixlEngineTest, TestHixlEngine) {
 
     EXPECT_EQ(engine3.Connect("[::1]:26000", kTimeOut), SUCCESS);
     TransferOpDesc desc2{reinterpret_cast<uintptr_t>(&num3), reinterpret_cast<uintptr_t>(&num4), sizeof(int32_t)};
-    EXPECT_EQ(engine3.TransferSync("[::1]:26000", READ, {desc2}, kTimeOut), SUCCESS);
+    EXPECT_EQ(engine3.TransferSync("[::1]:26000", READ, {desc2}, TransferArgs{}, kTimeOut), SUCCESS);
     EXPECT_EQ(num3, 4);
     num3 = 3;
-    EXPECT_EQ(engine3.TransferSync("[::1]:26000", WRITE, {desc2}, kTimeOut), SUCCESS);
+    EXPECT_EQ(engine3.TransferSync("[::1]:26000", WRITE, {desc2}, TransferArgs{}, kTimeOut), SUCCESS);
     EXPECT_EQ(num4, 3);
 
     EXPECT_EQ(engine3.Disconnect("[::1]:26000", kTimeOut), SUCCESS);
@@ -354,4 +359,104 @@ TEST_F(HixlEngineTest, TestSendAndGetNotifies) {
   engine1.Finalize();
   engine2.Finalize();
 }
+
+TEST_F(HixlEngineTest, TestMallocHostMem) {
+  Hixl engine;
+  void *ptr = nullptr;
+  // 不依赖Initialize
+  ASSERT_EQ(engine.MallocHostMem(4096U, ptr), SUCCESS);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(engine.MallocHostMem(0U, ptr), PARAM_INVALID);
+  int32_t not_allocated = 0;
+  EXPECT_EQ(engine.FreeHostMem(&not_allocated), PARAM_INVALID);
+  EXPECT_EQ(engine.FreeHostMem(nullptr), PARAM_INVALID);
+  EXPECT_EQ(engine.FreeHostMem(ptr), SUCCESS);
+  EXPECT_EQ(engine.FreeHostMem(ptr), PARAM_INVALID);
+}
+
+TEST_F(HixlEngineTest, TestHostMemCopiedThroughShmFromPeerProcess) {
+  constexpr size_t kLen = 1024U * 1024U;
+  (void)setenv("HIXL_SHM_TRANSPORT", "1", 1);
+  int32_t to_parent[2] = {-1, -1};
+  int32_t to_child[2] = {-1, -1};
+  ASSERT_EQ(pipe(to_parent), 0);
+  ASSERT_EQ(pipe(to_child), 0);
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // server 进程：MallocHostMem 申请的内存注册后导出给同机 client
+    Hixl server;
+    void *ptr = nullptr;
+    MemHandle handle = nullptr;
+    if ((server.Initialize("127.0.0.1:16000", options2) != SUCCESS) || (server.MallocHostMem(kLen, ptr) != SUCCESS)) {
+      _exit(2);
+    }
+    auto *mem = static_cast<uint8_t *>(ptr);
+    for (size_t i = 0U; i < kLen; ++i) {
+      mem[i] = static_cast<uint8_t>(i * 7U + 1U);
+    }
+    MemDesc mem_desc{};
+    mem_desc.addr = reinterpret_cast<uintptr_t>(ptr);
+    mem_desc.len = kLen;
+    if (server.RegisterMem(mem_desc, MEM_HOST, handle) != SUCCESS) {
+      _exit(3);
+    }
+    const std::string info = std::to_string(reinterpret_cast<uintptr_t>(ptr)) + "\n";
+    (void)write(to_parent[1], info.data(), info.size());
+    char done = 0;
+    (void)read(to_child[0], &done, 1U);
+    bool ok = true;
+    for (size_t i = 0U; i < kLen; ++i) {
+      ok = ok && (mem[i] == static_cast<uint8_t>(i * 3U + 5U));
+    }
+    ok = ok && (server.DeregisterMem(handle) == SUCCESS) && (server.FreeHostMem(ptr) == SUCCESS);
+    server.Finalize();
+    _exit(ok ? 0 : 1);
+  }
+  std::string info;
+  char c = 0;
+  while ((read(to_parent[0], &c, 1U) == 1) && (c != '\n')) {
+    info.push_back(c);
+  }
+  std::stringstream ss(info);
+  uintptr_t remote_addr = 0U;
+  ss >> remote_addr;
+  ASSERT_NE(remote_addr, 0U);
+
+  // 对端内存只在 server 进程中存在，数据正确说明经共享内存直接拷贝
+  Hixl client;
+  EXPECT_EQ(client.Initialize("127.0.0.1", options1), SUCCESS);
+  std::vector<uint8_t> local(kLen, 0U);
+  MemDesc local_mem{};
+  local_mem.addr = reinterpret_cast<uintptr_t>(local.data());
+  local_mem.len = kLen;
+  MemHandle local_handle = nullptr;
+  EXPECT_EQ(client.RegisterMem(local_mem, MEM_HOST, local_handle), SUCCESS);
+  EXPECT_EQ(client.Connect("127.0.0.1:16000", kTimeOut), SUCCESS);
+  TransferOpDesc desc{local_mem.addr, remote_addr, kLen};
+  EXPECT_EQ(client.TransferSync("127.0.0.1:16000", READ, {desc}, kTimeOut), SUCCESS);
+  bool read_ok = true;
+  for (size_t i = 0U; i < kLen; ++i) {
+    read_ok = read_ok && (local[i] == static_cast<uint8_t>(i * 7U + 1U));
+  }
+  EXPECT_TRUE(read_ok);
+  for (size_t i = 0U; i < kLen; ++i) {
+    local[i] = static_cast<uint8_t>(i * 3U + 5U);
+  }
+  EXPECT_EQ(client.TransferSync("127.0.0.1:16000", WRITE, {desc}, kTimeOut), SUCCESS);
+  EXPECT_EQ(client.Disconnect("127.0.0.1:16000", kTimeOut), SUCCESS);
+  EXPECT_EQ(client.DeregisterMem(local_handle), SUCCESS);
+  client.Finalize();
+
+  const char done = 1;
+  (void)write(to_child[1], &done, 1U);
+  int32_t status = -1;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  for (const auto fd : {to_parent[0], to_parent[1], to_child[0], to_child[1]}) {
+    (void)close(fd);
+  }
+  (void)unsetenv("HIXL_SHM_TRANSPORT");
+}
 }  // namespace hixl
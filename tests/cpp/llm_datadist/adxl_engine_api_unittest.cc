@@ -8,6 +8,8 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <vector>
 #include <cstdlib>
@@ -18,6 +20,7 @@
 
 #include "adxl/adxl_engine.h"
 #include "adxl/channel_manager.h"
+#include "adxl/kv_codec.h"
 #include "adxl/virtual_memory_manager.h"
 #include "dlog_pub.h"
 #include "depends/mmpa/src/mmpa_stub.h"
@@ -244,6 +247,96 @@ TEST_F(AdxlEngineUTest, TestAdxlEngineH2HWithBuffer) {
   engine2.Finalize();
 }
 
+TEST_F(AdxlEngineUTest, TestAdxlEngineH2HWithCompressedBuffer) {
+  llm::AutoCommResRuntimeMock::SetDevice(0);
+  AdxlEngine engine1;
+  std::map<AscendString, AscendString> options1;
+  options1["adxl.BufferPool"] = "4:8";
+  options1["adxl.BufferCompression"] = "lossless";
+  EXPECT_EQ(engine1.Initialize("127.0.0.1", options1), SUCCESS);
+
+  llm::AutoCommResRuntimeMock::SetDevice(1);
+  AdxlEngine engine2;
+  std::map<AscendString, AscendString> options2;
+  options2["adxl.BufferPool"] = "4:8";
+  EXPECT_EQ(engine2.Initialize("127.0.0.1:26001", options2), SUCCESS);
+
+  size_t size = 16 * 1024 * 1024;
+  std::vector<int8_t> src(size);
+  std::vector<int8_t> dst(size);
+  for (size_t i = 0; i < size; ++i) {
+    dst[i] = static_cast<int8_t>(i % 13);
+  }
+  EXPECT_EQ(engine1.Connect("127.0.0.1:26001"), SUCCESS);
+  TransferOpDesc desc{reinterpret_cast<uintptr_t>(src.data()), reinterpret_cast<uintptr_t>(dst.data()), size};
+  EXPECT_EQ(engine1.TransferSync("127.0.0.1:26001", READ, {desc}), SUCCESS);
+  EXPECT_EQ(src, dst);
+
+  // small blocks are batched into one buffer before encoding
+  for (size_t i = 0; i < size; ++i) {
+    src[i] = static_cast<int8_t>(i % 7);
+  }
+  size_t block_size = 256 * 1024;
+  std::vector<TransferOpDesc> descs;
+  for (size_t i = 0; i < size / block_size; ++i) {
+    descs.emplace_back(TransferOpDesc{reinterpret_cast<uintptr_t>(src.data()) + i * block_size,
+                                      reinterpret_cast<uintptr_t>(dst.data()) + i * block_size, block_size});
+  }
+  EXPECT_EQ(engine1.TransferSync("127.0.0.1:26001", WRITE, descs), SUCCESS);
+  EXPECT_EQ(src, dst);
+
+  EXPECT_EQ(engine1.Disconnect("127.0.0.1:26001"), SUCCESS);
+  engine1.Finalize();
+  engine2.Finalize();
+
+  AdxlEngine engine3;
+  std::map<AscendString, AscendString> options3;
+  options3["adxl.BufferCompression"] = "zstd";
+  EXPECT_EQ(engine3.Initialize("127.0.0.1", options3), PARAM_INVALID);
+}
+
+TEST_F(AdxlEngineUTest, TestAdxlEngineH2HWithLossyBuffer) {
+  llm::AutoCommResRuntimeMock::SetDevice(0);
+  AdxlEngine engine1;
+  std::map<AscendString, AscendString> options1;
+  options1["adxl.BufferPool"] = "4:8";
+  options1["adxl.BufferCompression"] = "fp8";
+  EXPECT_EQ(engine1.Initialize("127.0.0.1", options1), SUCCESS);
+
+  llm::AutoCommResRuntimeMock::SetDevice(1);
+  AdxlEngine engine2;
+  std::map<AscendString, AscendString> options2;
+  options2["adxl.BufferPool"] = "4:8";
+  EXPECT_EQ(engine2.Initialize("127.0.0.1:26001", options2), SUCCESS);
+
+  size_t num = 4 * 1024 * 1024;
+  std::vector<uint16_t> src(num);
+  std::vector<uint16_t> dst(num);
+  for (size_t i = 0; i < num; ++i) {
+    src[i] = KvCodec::FloatToHalf(0.1F * static_cast<float>(static_cast<int32_t>(i % 101) - 50));
+  }
+  EXPECT_EQ(engine1.Connect("127.0.0.1:26001"), SUCCESS);
+  TransferOpDesc desc{reinterpret_cast<uintptr_t>(src.data()), reinterpret_cast<uintptr_t>(dst.data()),
+                      num * sizeof(uint16_t)};
+  // transfers that do not allow lossy compression are sent raw
+  EXPECT_EQ(engine1.TransferSync("127.0.0.1:26001", WRITE, {desc}), SUCCESS);
+  EXPECT_EQ(src, dst);
+
+  TransferArgs args;
+  args.allow_lossy_compression = true;
+  std::fill(dst.begin(), dst.end(), 0U);
+  EXPECT_EQ(engine1.TransferSync("127.0.0.1:26001", WRITE, {desc}, args), SUCCESS);
+  EXPECT_NE(src, dst);
+  for (size_t i = 0; i < num; ++i) {
+    const float expect = KvCodec::HalfToFloat(src[i]);
+    EXPECT_LE(std::fabs(KvCodec::HalfToFloat(dst[i]) - expect), std::fabs(expect) / 16.0F + 1e-3F);
+  }
+
+  EXPECT_EQ(engine1.Disconnect("127.0.0.1:26001"), SUCCESS);
+  engine1.Finalize();
+  engine2.Finalize();
+}
+
 TEST_F(AdxlEngineUTest, TestAdxlEngineRD2HWithBuffer) {
   llm::AutoCommResRuntimeMock::SetDevice(0);
   AdxlEngine engine1;
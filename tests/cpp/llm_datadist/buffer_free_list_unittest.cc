@@ -0,0 +1,173 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "link_mgr/buffer_free_list.h"
+#include "llm_datadist/llm_error_codes.h"
+
+namespace llm {
+namespace {
+using Clock = std::chrono::steady_clock;
+constexpr uint64_t kSmallSize = 4U * 1024U;
+constexpr uint64_t kLargeSize = 128U * 1024U;
+}  // namespace
+
+class BufferFreeListTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    size_classes_ = {{kLargeSize, 2U}, {kSmallSize, 4U}};
+    region_.resize(BufferFreeList::GetRegionSize(size_classes_));
+  }
+
+  std::vector<BufferSizeClass> size_classes_;
+  std::vector<uint8_t> region_;
+};
+
+TEST_F(BufferFreeListTest, AllocFromSmallestFittingClass) {
+  BufferFreeList free_list;
+  ASSERT_EQ(free_list.Initialize(region_.data(), region_.size(), size_classes_), ge::SUCCESS);
+  EXPECT_EQ(free_list.GetFreeNum(kSmallSize), 4U);
+  EXPECT_EQ(free_list.GetFreeNum(kLargeSize), 2U);
+
+  std::set<void *> buffers;
+  for (size_t i = 0U; i < 4U; ++i) {
+    void *buffer = nullptr;
+    ASSERT_EQ(free_list.Alloc(100U, buffer), ge::SUCCESS);
+    // small buffers are carved first, right at the start of the region
+    EXPECT_LT(static_cast<uint8_t *>(buffer), region_.data() + 4U * kSmallSize);
+    EXPECT_EQ((static_cast<uint8_t *>(buffer) - region_.data()) % kSmallSize, 0);
+    buffers.emplace(buffer);
+  }
+  EXPECT_EQ(buffers.size(), 4U);
+  EXPECT_EQ(free_list.GetFreeNum(kSmallSize), 0U);
+
+  // small class used up, falls back to the large one
+  void *buffer = nullptr;
+  ASSERT_EQ(free_list.Alloc(kSmallSize, buffer), ge::SUCCESS);
+  EXPECT_GE(static_cast<uint8_t *>(buffer), region_.data() + 4U * kSmallSize);
+  EXPECT_EQ(free_list.GetFreeNum(kLargeSize), 1U);
+  free_list.Free(buffer);
+  EXPECT_EQ(free_list.GetFreeNum(kLargeSize), 2U);
+
+  EXPECT_EQ(free_list.Alloc(kLargeSize + 1U, buffer), ge::LLM_PARAM_INVALID);
+  for (auto small_buffer : buffers) {
+    free_list.Free(small_buffer);
+  }
+  EXPECT_EQ(free_list.GetFreeNum(kSmallSize), 4U);
+}
+
+TEST_F(BufferFreeListTest, ExhaustAndIgnoreInvalidFree) {
+  BufferFreeList free_list;
+  ASSERT_EQ(free_list.Initialize(region_.data(), region_.size(), size_classes_), ge::SUCCESS);
+  std::vector<void *> buffers(2U, nullptr);
+  ASSERT_EQ(free_list.Alloc(kLargeSize, buffers[0U]), ge::SUCCESS);
+  ASSERT_EQ(free_list.Alloc(kLargeSize, buffers[1U]), ge::SUCCESS);
+  void *buffer = nullptr;
+  EXPECT_EQ(free_list.Alloc(kLargeSize, buffer), ge::LLM_OUT_OF_MEMORY);
+
+  free_list.Free(nullptr);
+  int32_t foreign = 0;
+  free_list.Free(&foreign);
+  free_list.Free(static_cast<uint8_t *>(buffers[0U]) + 1);
+  EXPECT_EQ(free_list.GetFreeNum(kLargeSize), 0U);
+
+  free_list.Free(buffers[0U]);
+  free_list.Free(buffers[0U]);
+  EXPECT_EQ(free_list.GetFreeNum(kLargeSize), 1U);
+  ASSERT_EQ(free_list.Alloc(kLargeSize, buffer), ge::SUCCESS);
+  EXPECT_EQ(buffer, buffers[0U]);
+  EXPECT_EQ(free_list.Alloc(kLargeSize, buffer), ge::LLM_OUT_OF_MEMORY);
+}
+
+TEST_F(BufferFreeListTest, InvalidSizeClasses) {
+  BufferFreeList free_list;
+  EXPECT_EQ(free_list.Initialize(region_.data(), region_.size(), {}), ge::LLM_PARAM_INVALID);
+  EXPECT_EQ(free_list.Initialize(region_.data(), region_.size(), {{0U, 1U}}), ge::LLM_PARAM_INVALID);
+  EXPECT_EQ(free_list.Initialize(region_.data(), region_.size(), {{kSmallSize, 1U}, {kSmallSize, 1U}}),
+            ge::LLM_PARAM_INVALID);
+  EXPECT_EQ(free_list.Initialize(region_.data(), region_.size() - 1U, size_classes_), ge::LLM_PARAM_INVALID);
+  void *buffer = nullptr;
+  EXPECT_NE(free_list.Alloc(kSmallSize, buffer), ge::SUCCESS);
+}
+
+TEST_F(BufferFreeListTest, BlockingAllocWithTimeout) {
+  BufferFreeList free_list;
+  ASSERT_EQ(free_list.Initialize(region_.data(), region_.size(), {{kLargeSize, 1U}}), ge::SUCCESS);
+  void *held = nullptr;
+  ASSERT_EQ(free_list.Alloc(kLargeSize, held), ge::SUCCESS);
+
+  auto start = Clock::now();
+  void *buffer = nullptr;
+  EXPECT_EQ(free_list.Alloc(kLargeSize, buffer, 50), ge::LLM_OUT_OF_MEMORY);
+  EXPECT_GE(Clock::now() - start, std::chrono::milliseconds(50));
+
+  std::thread releaser([&free_list, held]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    free_list.Free(held);
+  });
+  start = Clock::now();
+  EXPECT_EQ(free_list.Alloc(kLargeSize, buffer, 5000), ge::SUCCESS);
+  EXPECT_LT(Clock::now() - start, std::chrono::milliseconds(2000));
+  EXPECT_EQ(buffer, held);
+  releaser.join();
+}
+
+TEST_F(BufferFreeListTest, ConcurrentAllocFree) {
+  constexpr size_t kThreadNum = 8U;
+  constexpr size_t kBufferNum = 64U;
+  std::vector<uint8_t> region(BufferFreeList::GetRegionSize({{64U, kBufferNum}, {256U, kBufferNum}}));
+  BufferFreeList free_list;
+  ASSERT_EQ(free_list.Initialize(region.data(), region.size(), {{64U, kBufferNum}, {256U, kBufferNum}}),
+            ge::SUCCESS);
+  std::vector<std::atomic<int32_t>> owners(region.size() / 64U);
+  std::atomic<int32_t> overlapped{0};
+  std::vector<std::thread> threads;
+  for (size_t t = 0U; t < kThreadNum; ++t) {
+    threads.emplace_back([&, t]() {
+      std::vector<void *> held;
+      for (size_t round = 0U; round < 2000U; ++round) {
+        void *buffer = nullptr;
+        const uint64_t size = ((round + t) % 3U == 0U) ? 200U : 64U;
+        if (free_list.Alloc(size, buffer, 100) == ge::SUCCESS) {
+          const size_t slot = static_cast<size_t>(static_cast<uint8_t *>(buffer) - region.data()) / 64U;
+          if (owners[slot].fetch_add(1) != 0) {
+            ++overlapped;
+          }
+          held.emplace_back(buffer);
+        }
+        if ((held.size() > 8U) || ((round % 5U == 0U) && !held.empty())) {
+          void *to_free = held.back();
+          held.pop_back();
+          const size_t slot = static_cast<size_t>(static_cast<uint8_t *>(to_free) - region.data()) / 64U;
+          (void) owners[slot].fetch_sub(1);
+          free_list.Free(to_free);
+        }
+      }
+      for (auto buffer : held) {
+        const size_t slot = static_cast<size_t>(static_cast<uint8_t *>(buffer) - region.data()) / 64U;
+        (void) owners[slot].fetch_sub(1);
+        free_list.Free(buffer);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(overlapped.load(), 0);
+  EXPECT_EQ(free_list.GetFreeNum(64U), kBufferNum);
+  EXPECT_EQ(free_list.GetFreeNum(256U), kBufferNum);
+}
+
+}  // namespace llm
@@ -0,0 +1,259 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "link_mgr/buffered_sender.h"
+#include "common/def_types.h"
+#include "llm_datadist/llm_error_codes.h"
+
+namespace llm {
+namespace {
+// stands in for HcclBatchPut: records every batch and applies it to host memory
+class BatchRecorder {
+ public:
+  BufferedSender::BatchFunc GetBatchFunc() {
+    return [this](std::vector<HcclOneSideOpDesc> &op_descs) -> ge::Status {
+      if (fail_) {
+        return ge::FAILED;
+      }
+      batches_.emplace_back(op_descs);
+      for (const auto &desc : op_descs) {
+        (void) memcpy(desc.remoteAddr, desc.localAddr, desc.count);
+      }
+      return ge::SUCCESS;
+    };
+  }
+
+  std::vector<std::vector<HcclOneSideOpDesc>> batches_;
+  bool fail_ = false;
+};
+
+BufferedSenderOptions LegacyOptions() {
+  BufferedSenderOptions options;
+  options.max_op_num = 64U;
+  options.max_bytes = 0UL;
+  options.flush_delay_us = 0UL;
+  options.merge_contiguous = false;
+  return options;
+}
+
+struct KvLayout {
+  const char *name;
+  uint64_t block_size;
+  size_t block_num;
+  double contiguous_ratio;  // chance that the next block follows the previous one on both sides
+};
+
+// puts blocks of layer_num tensors the way a kv pull does and returns the sender statistic
+BufferedSenderStatistic RunKvTransfer(const KvLayout &layout, const BufferedSenderOptions &options,
+                                      size_t layer_num) {
+  BufferedSender sender;
+  sender.Initialize([](std::vector<HcclOneSideOpDesc> &) -> ge::Status { return ge::SUCCESS; }, options);
+  std::mt19937 rng(1234U);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  // addresses are only compared, the blocks are never touched
+  constexpr uint64_t kLocalBase = 0x100000000UL;
+  constexpr uint64_t kRemoteBase = 0x800000000UL;
+  const uint64_t tensor_size = layout.block_size * layout.block_num * 4U;
+  for (size_t layer = 0U; layer < layer_num; ++layer) {
+    uint64_t local_block = 0U;
+    uint64_t remote_block = 0U;
+    for (size_t i = 0U; i < layout.block_num; ++i) {
+      if ((i > 0U) && (dist(rng) >= layout.contiguous_ratio)) {
+        local_block += 2U + static_cast<uint64_t>(dist(rng) * 3.0);
+        remote_block += 1U;
+      } else if (i > 0U) {
+        ++local_block;
+        ++remote_block;
+      }
+      void *local = ValueToPtr(kLocalBase + layer * tensor_size + local_block * layout.block_size);
+      void *remote = ValueToPtr(kRemoteBase + layer * tensor_size + remote_block * layout.block_size);
+      EXPECT_EQ(sender.Put(local, remote, layout.block_size), ge::SUCCESS);
+    }
+  }
+  EXPECT_EQ(sender.Flush(), ge::SUCCESS);
+  return sender.GetStatistic();
+}
+}  // namespace
+
+class BufferedSenderTest : public ::testing::Test {};
+
+TEST_F(BufferedSenderTest, MergeContiguousPuts) {
+  std::vector<uint8_t> src(1024U);
+  std::vector<uint8_t> dst(1024U, 0U);
+  for (size_t i = 0U; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>(i * 7U);
+  }
+  BatchRecorder recorder;
+  BufferedSender sender;
+  BufferedSenderOptions options;
+  options.merge_contiguous = true;
+  sender.Initialize(recorder.GetBatchFunc(), options);
+  // three contiguous puts, then a gap on the remote side only, then a gap on the local side only
+  EXPECT_EQ(sender.Put(&src[0], &dst[0], 100U), ge::SUCCESS);
+  EXPECT_EQ(sender.Put(&src[100], &dst[100], 100U), ge::SUCCESS);
+  EXPECT_EQ(sender.Put(&src[200], &dst[200], 56U), ge::SUCCESS);
+  EXPECT_EQ(sender.Put(&src[256], &dst[300], 44U), ge::SUCCESS);
+  EXPECT_EQ(sender.Put(&src[400], &dst[344], 56U), ge::SUCCESS);
+  EXPECT_EQ(sender.Put(&src[456], &dst[400], 100U), ge::SUCCESS);
+  EXPECT_TRUE(recorder.batches_.empty());
+  EXPECT_EQ(sender.Flush(), ge::SUCCESS);
+
+  ASSERT_EQ(recorder.batches_.size(), 1U);
+  const auto &batch = recorder.batches_[0U];
+  ASSERT_EQ(batch.size(), 3U);
+  EXPECT_EQ(batch[0U].localAddr, &src[0]);
+  EXPECT_EQ(batch[0U].count, 256U);
+  EXPECT_EQ(batch[1U].remoteAddr, &dst[300]);
+  EXPECT_EQ(batch[1U].count, 44U);
+  EXPECT_EQ(batch[2U].localAddr, &src[400]);
+  EXPECT_EQ(batch[2U].count, 156U);
+  for (const auto &desc : batch) {
+    EXPECT_EQ(desc.dataType, HCCL_DATA_TYPE_UINT8);
+  }
+  EXPECT_EQ(memcmp(&dst[0], &src[0], 256U), 0);
+  EXPECT_EQ(memcmp(&dst[300], &src[256], 44U), 0);
+  EXPECT_EQ(memcmp(&dst[344], &src[400], 156U), 0);
+
+  const auto &statistic = sender.GetStatistic();
+  EXPECT_EQ(statistic.put_num, 6U);
+  EXPECT_EQ(statistic.merged_num, 3U);
+  EXPECT_EQ(statistic.op_num, 3U);
+  EXPECT_EQ(statistic.bytes, 456U);
+  EXPECT_EQ(statistic.flush_num, 1U);
+  EXPECT_EQ(statistic.explicit_flush_num, 1U);
+}
+
+TEST_F(BufferedSenderTest, EndRegionKeepsAdjacentRegionsApart) {
+  // two tensors registered one after the other on each side
+  std::vector<uint8_t> src(512U);
+  std::vector<uint8_t> dst(512U);
+  BatchRecorder recorder;
+  BufferedSender sender;
+  BufferedSenderOptions options;
+  options.flush_delay_us = 0UL;
+  options.merge_contiguous = true;
+  sender.Initialize(recorder.GetBatchFunc(), options);
+  EXPECT_EQ(sender.Put(&src[0], &dst[0], 128U), ge::SUCCESS);
+  EXPECT_EQ(sender.Put(&src[128], &dst[128], 128U), ge::SUCCESS);
+  sender.EndRegion();
+  EXPECT_EQ(sender.Put(&src[256], &dst[256], 128U), ge::SUCCESS);
+  EXPECT_EQ(sender.Put(&src[384], &dst[384], 128U), ge::SUCCESS);
+  EXPECT_EQ(sender.Flush(), ge::SUCCESS);
+  ASSERT_EQ(recorder.batches_.size(), 1U);
+  const auto &batch = recorder.batches_[0U];
+  ASSERT_EQ(batch.size(), 2U);
+  EXPECT_EQ(batch[0U].localAddr, &src[0]);
+  EXPECT_EQ(batch[0U].count, 256U);
+  EXPECT_EQ(batch[1U].localAddr, &src[256]);
+  EXPECT_EQ(batch[1U].count, 256U);
+  EXPECT_EQ(sender.GetStatistic().merged_num, 2U);
+
+  // a region ended on an empty queue does not hold back later merges
+  sender.EndRegion();
+  EXPECT_EQ(sender.Put(&src[0], &dst[0], 8U), ge::SUCCESS);
+  EXPECT_EQ(sender.Put(&src[8], &dst[8], 8U, true), ge::SUCCESS);
+  ASSERT_EQ(recorder.batches_.size(), 2U);
+  EXPECT_EQ(recorder.batches_[1U].size(), 1U);
+}
+
+TEST_F(BufferedSenderTest, FlushByCountBytesAndDeadline) {
+  std::vector<uint8_t> src(4096U);
+  std::vector<uint8_t> dst(8192U);
+  BatchRecorder recorder;
+  BufferedSender sender;
+  BufferedSenderOptions options;
+  options.max_op_num = 4U;
+  options.max_bytes = 1000UL;
+  options.flush_delay_us = 0UL;
+  sender.Initialize(recorder.GetBatchFunc(), options);
+  // gaps on the remote side keep the puts apart
+  for (size_t i = 0U; i < 4U; ++i) {
+    EXPECT_EQ(sender.Put(&src[i * 10U], &dst[i * 20U], 10U), ge::SUCCESS);
+  }
+  ASSERT_EQ(recorder.batches_.size(), 1U);
+  EXPECT_EQ(recorder.batches_[0U].size(), 4U);
+  EXPECT_EQ(sender.Put(&src[0], &dst[1000], 600U), ge::SUCCESS);
+  EXPECT_EQ(sender.Put(&src[1000], &dst[3000], 600U), ge::SUCCESS);
+  ASSERT_EQ(recorder.batches_.size(), 2U);
+  EXPECT_EQ(recorder.batches_[1U].size(), 2U);
+  EXPECT_EQ(sender.GetStatistic().count_flush_num, 1U);
+  EXPECT_EQ(sender.GetStatistic().bytes_flush_num, 1U);
+  EXPECT_EQ(sender.GetStatistic().max_flush_bytes, 1200U);
+
+  options.max_op_num = 64U;
+  options.max_bytes = 0UL;
+  options.flush_delay_us = 1000UL;
+  sender.Initialize(recorder.GetBatchFunc(), options);
+  EXPECT_EQ(sender.Put(&src[0], &dst[0], 10U), ge::SUCCESS);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  EXPECT_EQ(sender.Put(&src[100], &dst[200], 10U), ge::SUCCESS);
+  ASSERT_EQ(recorder.batches_.size(), 3U);
+  EXPECT_EQ(recorder.batches_[2U].size(), 2U);
+  EXPECT_EQ(sender.GetStatistic().deadline_flush_num, 1U);
+  // the deadline restarts with the next batch
+  EXPECT_EQ(sender.Put(&src[200], &dst[400], 10U), ge::SUCCESS);
+  EXPECT_EQ(recorder.batches_.size(), 3U);
+  EXPECT_EQ(sender.Put(&src[300], &dst[600], 10U, true), ge::SUCCESS);
+  EXPECT_EQ(recorder.batches_.size(), 4U);
+  EXPECT_EQ(sender.GetStatistic().explicit_flush_num, 1U);
+  EXPECT_EQ(sender.Flush(), ge::SUCCESS);
+  EXPECT_EQ(recorder.batches_.size(), 4U);
+}
+
+TEST_F(BufferedSenderTest, NoMergeWhenDisabledAndFailedBatch) {
+  std::vector<uint8_t> src(64U);
+  std::vector<uint8_t> dst(64U);
+  BatchRecorder recorder;
+  BufferedSender sender;
+  // merging is opt in, contiguous addresses may still belong to two registrations
+  EXPECT_FALSE(BufferedSenderOptions{}.merge_contiguous);
+  sender.Initialize(recorder.GetBatchFunc(), LegacyOptions());
+  EXPECT_EQ(sender.Put(&src[0], &dst[0], 8U), ge::SUCCESS);
+  EXPECT_EQ(sender.Put(&src[8], &dst[8], 8U), ge::SUCCESS);
+  recorder.fail_ = true;
+  EXPECT_NE(sender.Flush(), ge::SUCCESS);
+  EXPECT_EQ(sender.GetStatistic().flush_num, 0U);
+  recorder.fail_ = false;
+  EXPECT_EQ(sender.Flush(), ge::SUCCESS);
+  ASSERT_EQ(recorder.batches_.size(), 1U);
+  EXPECT_EQ(recorder.batches_[0U].size(), 2U);
+
+  BufferedSender uninitialized;
+  EXPECT_EQ(uninitialized.Flush(), ge::SUCCESS);
+  EXPECT_NE(uninitialized.Put(&src[0], &dst[0], 8U, true), ge::SUCCESS);
+}
+
+TEST_F(BufferedSenderTest, OpsPerBatchOfBlockSizeMixes) {
+  constexpr size_t kLayerNum = 64U;
+  const std::vector<KvLayout> layouts = {
+      {"16K blocks, contiguous", 16U * 1024U, 256U, 1.0},
+      {"16K blocks, 70% contiguous", 16U * 1024U, 256U, 0.7},
+      {"16K blocks, scattered", 16U * 1024U, 256U, 0.0},
+      {"2K blocks, 90% contiguous", 2U * 1024U, 1024U, 0.9},
+      {"512K blocks, scattered", 512U * 1024U, 64U, 0.0},
+  };
+  for (const auto &layout : layouts) {
+    const auto legacy = RunKvTransfer(layout, LegacyOptions(), kLayerNum);
+    BufferedSenderOptions options;
+    options.flush_delay_us = 0UL;  // keeps the count deterministic
+    options.merge_contiguous = true;  // every layer is a tensor of its own, so the blocks never cross a region
+    const auto adaptive = RunKvTransfer(layout, options, kLayerNum);
+    EXPECT_EQ(legacy.bytes, adaptive.bytes);
+    EXPECT_LE(adaptive.op_num, legacy.op_num);
+    EXPECT_LT(adaptive.max_flush_bytes, options.max_bytes + layout.block_size);
+  }
+}
+}  // namespace llm
@@ -0,0 +1,168 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "adxl/copy_stream_balancer.h"
+
+namespace adxl {
+namespace {
+constexpr size_t kStreamNum = 4U;
+constexpr uintptr_t kLocalBase = 0x10000000UL;
+constexpr uintptr_t kRemoteBase = 0x80000000UL;
+constexpr size_t kLargeBlock = 8UL << 20U;
+constexpr size_t kSmallBlock = 64UL << 10U;
+
+// blocks of the given sizes with a hole after each of them, so nothing merges
+std::vector<TransferOpDesc> MakeSparseDescs(const std::vector<size_t> &lens) {
+  std::vector<TransferOpDesc> descs;
+  uintptr_t offset = 0U;
+  for (const auto len : lens) {
+    descs.emplace_back(TransferOpDesc{kLocalBase + offset, kRemoteBase + offset, len});
+    offset += len * 2U;
+  }
+  return descs;
+}
+
+std::vector<std::vector<TransferOpDesc>> RoundRobin(const std::vector<TransferOpDesc> &descs, size_t stream_num) {
+  std::vector<std::vector<TransferOpDesc>> stream_copies(stream_num);
+  for (size_t i = 0U; i < descs.size(); ++i) {
+    stream_copies[i % stream_num].emplace_back(descs[i]);
+  }
+  return stream_copies;
+}
+
+// every byte of the input is copied exactly once, with the same local to remote mapping
+void CheckCoverage(const std::vector<TransferOpDesc> &descs,
+                   const std::vector<std::vector<TransferOpDesc>> &stream_copies) {
+  std::vector<TransferOpDesc> copies;
+  for (const auto &stream : stream_copies) {
+    copies.insert(copies.end(), stream.cbegin(), stream.cend());
+  }
+  std::sort(copies.begin(), copies.end(),
+            [](const TransferOpDesc &lhs, const TransferOpDesc &rhs) { return lhs.local_addr < rhs.local_addr; });
+  uint64_t desc_bytes = 0U;
+  for (const auto &desc : descs) {
+    desc_bytes += desc.len;
+  }
+  uint64_t copy_bytes = 0U;
+  for (size_t i = 0U; i < copies.size(); ++i) {
+    const auto &copy = copies[i];
+    EXPECT_GT(copy.len, 0U);
+    copy_bytes += copy.len;
+    if (i > 0U) {
+      EXPECT_LE(copies[i - 1U].local_addr + copies[i - 1U].len, copy.local_addr);
+    }
+    const auto begin = copy.local_addr;
+    const auto end = copy.local_addr + copy.len;
+    // merged copies span several descs, all of them with the same offset between the two sides
+    uint64_t covered = 0U;
+    for (const auto &desc : descs) {
+      const auto lo = std::max(begin, desc.local_addr);
+      const auto hi = std::min(end, desc.local_addr + desc.len);
+      if (lo < hi) {
+        EXPECT_EQ(copy.remote_addr - copy.local_addr, desc.remote_addr - desc.local_addr);
+        covered += hi - lo;
+      }
+    }
+    EXPECT_EQ(covered, copy.len);
+  }
+  EXPECT_EQ(copy_bytes, desc_bytes);
+}
+}  // namespace
+
+TEST(CopyStreamBalancerUTest, EmptyInput) {
+  std::vector<std::vector<TransferOpDesc>> stream_copies;
+  CopyStreamBalancer::Balance({}, kStreamNum, stream_copies);
+  ASSERT_EQ(stream_copies.size(), kStreamNum);
+  for (const auto &copies : stream_copies) {
+    EXPECT_TRUE(copies.empty());
+  }
+  EXPECT_DOUBLE_EQ(CopyStreamBalancer::Imbalance(stream_copies), 1.0);
+
+  CopyStreamBalancer::Balance(MakeSparseDescs({kSmallBlock}), 0U, stream_copies);
+  EXPECT_TRUE(stream_copies.empty());
+}
+
+TEST(CopyStreamBalancerUTest, SplitLargeDesc) {
+  const auto descs = MakeSparseDescs({64UL << 20U});
+  std::vector<std::vector<TransferOpDesc>> stream_copies;
+  CopyStreamBalancer::Balance(descs, kStreamNum, stream_copies);
+  for (const auto &copies : stream_copies) {
+    ASSERT_EQ(copies.size(), 1U);
+    EXPECT_EQ(copies[0].len, 16UL << 20U);
+  }
+  EXPECT_DOUBLE_EQ(CopyStreamBalancer::Imbalance(stream_copies), 1.0);
+  CheckCoverage(descs, stream_copies);
+}
+
+TEST(CopyStreamBalancerUTest, NotSplitSmallDesc) {
+  const auto descs = MakeSparseDescs({CopyStreamBalancer::kMinSplitSize});
+  std::vector<std::vector<TransferOpDesc>> stream_copies;
+  CopyStreamBalancer::Balance(descs, kStreamNum, stream_copies);
+  ASSERT_EQ(stream_copies[0].size(), 1U);
+  EXPECT_EQ(stream_copies[0][0].len, CopyStreamBalancer::kMinSplitSize);
+  for (size_t i = 1U; i < kStreamNum; ++i) {
+    EXPECT_TRUE(stream_copies[i].empty());
+  }
+}
+
+TEST(CopyStreamBalancerUTest, MergeContiguousDescs) {
+  // 256 kv blocks laid out back to back on both sides
+  std::vector<TransferOpDesc> descs;
+  for (size_t i = 0U; i < 256U; ++i) {
+    descs.emplace_back(TransferOpDesc{kLocalBase + i * kSmallBlock, kRemoteBase + i * kSmallBlock, kSmallBlock});
+  }
+  std::reverse(descs.begin(), descs.end());
+  std::vector<std::vector<TransferOpDesc>> stream_copies;
+  CopyStreamBalancer::Balance(descs, kStreamNum, stream_copies);
+  for (const auto &copies : stream_copies) {
+    ASSERT_EQ(copies.size(), 1U);
+    EXPECT_EQ(copies[0].len, 64U * kSmallBlock);
+  }
+  CheckCoverage(descs, stream_copies);
+
+  // contiguous on the local side only
+  for (size_t i = 0U; i < descs.size(); ++i) {
+    descs[i].remote_addr = kRemoteBase + i * kSmallBlock * 2U;
+  }
+  CopyStreamBalancer::Balance(descs, kStreamNum, stream_copies);
+  for (const auto &copies : stream_copies) {
+    EXPECT_EQ(copies.size(), 64U);
+  }
+  CheckCoverage(descs, stream_copies);
+}
+
+TEST(CopyStreamBalancerUTest, BalanceMixedSizes) {
+  // a few large layers behind many small blocks, round robin puts every large one on its own stream
+  std::vector<size_t> lens(3U, kLargeBlock);
+  lens.insert(lens.end(), 125U, kSmallBlock);
+  const auto descs = MakeSparseDescs(lens);
+  std::vector<std::vector<TransferOpDesc>> stream_copies;
+  CopyStreamBalancer::Balance(descs, kStreamNum, stream_copies);
+  CheckCoverage(descs, stream_copies);
+
+  const double round_robin = CopyStreamBalancer::Imbalance(RoundRobin(descs, kStreamNum));
+  const double balanced = CopyStreamBalancer::Imbalance(stream_copies);
+  EXPECT_GT(round_robin, 1.2);
+  EXPECT_LT(balanced, 1.05);
+}
+
+TEST(CopyStreamBalancerUTest, LargestFirst) {
+  const auto descs = MakeSparseDescs({kSmallBlock, 512UL << 10U, 256UL << 10U, kSmallBlock, 768UL << 10U});
+  std::vector<std::vector<TransferOpDesc>> stream_copies;
+  CopyStreamBalancer::Balance(descs, 2U, stream_copies);
+  ASSERT_EQ(stream_copies.size(), 2U);
+  EXPECT_EQ(stream_copies[0][0].len, 768UL << 10U);
+  EXPECT_EQ(stream_copies[1][0].len, 512UL << 10U);
+  CheckCoverage(descs, stream_copies);
+}
+}  // namespace adxl
@@ -10,6 +10,8 @@
 
 #include <vector>
 #include <cstdlib>
+#include <string>
+#include <unistd.h>
 #include <gtest/gtest.h>
 #include "data_transfer/d2h_data_transfer_job.h"
 #include "llm_datadist_v2.h"
@@ -1538,6 +1540,55 @@ TEST_F(DataCacheEngineTest, SwapBlocks) {
   EXPECT_EQ(llm_data_dist.DeallocateCache(cached_tensors_2.cache_id), ge::SUCCESS);
 }
 
+TEST_F(DataCacheEngineTest, SwapBlocksWithDiskOnlyFromHost) {
+  llm::HcclAdapter::GetInstance().Finalize();
+  char dir[] = "/tmp/llm_disk_tier_engine_ut_XXXXXX";
+  ASSERT_NE(mkdtemp(dir), nullptr);
+  llm::LLMDataDistV2 llm_data_dist(1);
+  std::map<ge::AscendString, ge::AscendString> default_options{
+      {llm::LLM_OPTION_ROLE, llm::kDecoder},
+      {ge::OPTION_EXEC_DEVICE_ID, "0"},
+      {llm::LLM_OPTION_SYNC_KV_CACHE_WAIT_TIME, "600000"},
+      {llm::LLM_OPTION_MEM_POOL_CONFIG, "{\"memory_size\": 102428800}"},
+      {llm::LLM_OPTION_HOST_MEM_POOL_CONFIG, "{\"memory_size\": 102428800}"}
+  };
+  const std::string disk_config = std::string("{\"path\": \"") + dir + "\", \"capacity\": 4194304}";
+  default_options[llm::LLM_OPTION_DISK_TIER_CONFIG] = disk_config.c_str();
+  ASSERT_EQ(llm_data_dist.LLMDataDistInitialize(default_options), ge::SUCCESS);
+
+  llm::CacheDesc kv_desc{};
+  kv_desc.num_tensors = 2;
+  kv_desc.data_type = ge::DT_FLOAT16;
+  kv_desc.shape = {10, 128};
+  llm::Cache device_cache;
+  ASSERT_EQ(llm_data_dist.AllocateCache(kv_desc, device_cache), ge::SUCCESS);
+  kv_desc.placement = static_cast<uint32_t>(llm::CachePlacement::HOST);
+  llm::Cache host_cache;
+  ASSERT_EQ(llm_data_dist.AllocateCache(kv_desc, host_cache), ge::SUCCESS);
+  // the disk side is named by its cache id only
+  llm::Cache disk_cache;
+  disk_cache.cache_id = 100;
+
+  constexpr uint32_t kSwapOutToDisk = 2U;
+  constexpr uint32_t kSwapInFromDisk = 3U;
+  const std::vector<std::pair<int64_t, int64_t>> block_mapping{{0, 0}, {1, 1}, {5, 2}};
+  EXPECT_EQ(llm_data_dist.SwapBlocks(device_cache, disk_cache, 256, kSwapOutToDisk, block_mapping),
+            ge::LLM_PARAM_INVALID);
+  llm::Cache unknown_cache = host_cache;
+  unknown_cache.cache_id = 1000;
+  EXPECT_EQ(llm_data_dist.SwapBlocks(unknown_cache, disk_cache, 256, kSwapOutToDisk, block_mapping),
+            ge::LLM_KV_CACHE_NOT_EXIST);
+  EXPECT_EQ(llm_data_dist.SwapBlocks(host_cache, disk_cache, 256, kSwapOutToDisk, block_mapping), ge::SUCCESS);
+  EXPECT_EQ(llm_data_dist.SwapBlocks(disk_cache, device_cache, 256, kSwapInFromDisk, block_mapping),
+            ge::LLM_PARAM_INVALID);
+  EXPECT_EQ(llm_data_dist.SwapBlocks(disk_cache, host_cache, 256, kSwapInFromDisk, block_mapping), ge::SUCCESS);
+
+  EXPECT_EQ(llm_data_dist.DeallocateCache(device_cache.cache_id), ge::SUCCESS);
+  EXPECT_EQ(llm_data_dist.DeallocateCache(host_cache.cache_id), ge::SUCCESS);
+  llm_data_dist.LLMDataDistFinalize();
+  (void)rmdir(dir);
+}
+
 TEST_F(DataCacheEngineTest, TransferCache_D2D_B2B_with_cache_key) {
   llm::CacheDesc src_cache_desc{};
   src_cache_desc.num_tensors = 2;
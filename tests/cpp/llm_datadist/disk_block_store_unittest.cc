@@ -0,0 +1,289 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "cache_mgr/disk_block_store.h"
+
+namespace llm {
+namespace {
+constexpr uint64_t kBlockSize = 64UL * 1024UL;
+
+std::vector<std::pair<int64_t, int64_t>> MakeMapping(int64_t src_start, int64_t dst_start, int64_t num) {
+  std::vector<std::pair<int64_t, int64_t>> mapping;
+  for (int64_t i = 0; i < num; ++i) {
+    mapping.emplace_back(src_start + i, dst_start + i);
+  }
+  return mapping;
+}
+
+void FillBlocks(std::vector<uint8_t> &buffer, uint8_t seed) {
+  for (size_t i = 0U; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<uint8_t>((i / 7U) + seed);
+  }
+}
+
+uintptr_t Addr(std::vector<uint8_t> &buffer, uint64_t offset = 0UL) {
+  return reinterpret_cast<uintptr_t>(buffer.data() + offset);
+}
+}  // namespace
+
+class DiskBlockStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char dir[] = "/tmp/llm_disk_tier_ut_XXXXXX";
+    ASSERT_NE(mkdtemp(dir), nullptr);
+    dir_ = dir;
+  }
+  void TearDown() override {
+    (void)rmdir(dir_.c_str());
+  }
+  DiskTierOptions MakeOptions(uint64_t capacity, bool direct_io = true) const {
+    DiskTierOptions options{};
+    options.path = dir_;
+    options.capacity = capacity;
+    options.direct_io = direct_io;
+    return options;
+  }
+
+  std::string dir_;
+};
+
+TEST_F(DiskBlockStoreTest, SwapOutAndSwapInRoundTrip) {
+  for (const bool direct_io : {true, false}) {
+    DiskBlockStore store(MakeOptions(64UL * kBlockSize, direct_io));
+    ASSERT_EQ(store.Initialize(), ge::SUCCESS);
+    std::vector<uint8_t> k_cache(16UL * kBlockSize);
+    std::vector<uint8_t> v_cache(16UL * kBlockSize);
+    FillBlocks(k_cache, 1U);
+    FillBlocks(v_cache, 2U);
+    // two runs, the second one lands at disk blocks that are not adjacent to the first
+    auto mapping = MakeMapping(0, 100, 8);
+    const auto tail = MakeMapping(8, 200, 8);
+    mapping.insert(mapping.end(), tail.begin(), tail.end());
+    ASSERT_EQ(store.SwapOut({Addr(k_cache), Addr(v_cache)}, 1, kBlockSize, mapping), ge::SUCCESS);
+    EXPECT_TRUE(store.Contains(DiskBlockKey{1, 1U, 207}));
+    EXPECT_EQ(store.GetUsedSize(), 32UL * kBlockSize);
+
+    std::vector<uint8_t> k_restore(16UL * kBlockSize);
+    std::vector<uint8_t> v_restore(16UL * kBlockSize);
+    std::vector<std::pair<int64_t, int64_t>> reverse;
+    for (const auto &block : mapping) {
+      reverse.emplace_back(block.second, block.first);
+    }
+    ASSERT_EQ(store.SwapIn(1, {Addr(k_restore), Addr(v_restore)}, kBlockSize, reverse), ge::SUCCESS);
+    EXPECT_EQ(k_restore, k_cache);
+    EXPECT_EQ(v_restore, v_cache);
+    store.Finalize();
+  }
+}
+
+TEST_F(DiskBlockStoreTest, UnalignedBlocksGoThroughBounceBuffer) {
+  constexpr uint64_t kOddBlockSize = 1000UL;
+  DiskBlockStore store(MakeOptions(1024UL * 1024UL));
+  ASSERT_EQ(store.Initialize(), ge::SUCCESS);
+  std::vector<uint8_t> cache(8UL * kOddBlockSize + 1UL);
+  FillBlocks(cache, 3U);
+  // host address deliberately off the direct io alignment
+  ASSERT_EQ(store.SwapOut({Addr(cache, 1UL)}, 7, kOddBlockSize, MakeMapping(0, 0, 8)), ge::SUCCESS);
+  std::vector<uint8_t> restore(8UL * kOddBlockSize + 1UL);
+  ASSERT_EQ(store.SwapIn(7, {Addr(restore, 1UL)}, kOddBlockSize, {{2, 2}, {3, 3}, {6, 6}}), ge::SUCCESS);
+  for (const int64_t block : {2, 3, 6}) {
+    EXPECT_TRUE(std::equal(cache.begin() + 1 + block * kOddBlockSize, cache.begin() + 1 + (block + 1) * kOddBlockSize,
+                           restore.begin() + 1 + block * kOddBlockSize));
+  }
+  EXPECT_EQ(restore[1UL], 0U);
+}
+
+TEST_F(DiskBlockStoreTest, InvalidSwapIsRejected) {
+  DiskBlockStore store(MakeOptions(16UL * kBlockSize));
+  std::vector<uint8_t> cache(4UL * kBlockSize);
+  EXPECT_EQ(store.SwapOut({Addr(cache)}, 1, kBlockSize, MakeMapping(0, 0, 1)), ge::LLM_FEATURE_NOT_ENABLED);
+  ASSERT_EQ(store.Initialize(), ge::SUCCESS);
+  EXPECT_EQ(store.SwapOut({Addr(cache)}, 1, kBlockSize, {{0, 1}, {1, 1}}), ge::LLM_PARAM_INVALID);
+  EXPECT_EQ(store.SwapOut({Addr(cache)}, 1, 0UL, MakeMapping(0, 0, 1)), ge::LLM_PARAM_INVALID);
+  ASSERT_EQ(store.SwapOut({Addr(cache)}, 1, kBlockSize, MakeMapping(0, 0, 2)), ge::SUCCESS);
+  EXPECT_EQ(store.SwapIn(1, {Addr(cache)}, kBlockSize, MakeMapping(1, 0, 2)), ge::LLM_KV_CACHE_NOT_EXIST);
+  EXPECT_EQ(store.SwapIn(2, {Addr(cache)}, kBlockSize, MakeMapping(0, 0, 1)), ge::LLM_KV_CACHE_NOT_EXIST);
+  EXPECT_EQ(store.SwapIn(1, {Addr(cache)}, kBlockSize / 2UL, MakeMapping(0, 0, 1)), ge::LLM_PARAM_INVALID);
+}
+
+TEST_F(DiskBlockStoreTest, ReservationKeepsIndexConsistent) {
+  DiskBlockStore store(MakeOptions(8UL * kBlockSize));
+  ASSERT_EQ(store.Initialize(), ge::SUCCESS);
+  std::vector<uint8_t> cache(4UL * kBlockSize);
+  ASSERT_EQ(store.SwapOut({Addr(cache)}, 1, kBlockSize, MakeMapping(0, 0, 4)), ge::SUCCESS);
+  {
+    std::unique_lock<std::mutex> lock(store.mu_);
+    // a repeated key is rejected before anything is reserved
+    EXPECT_EQ(store.DropIdleBlocks({DiskBlockKey{2, 0U, 0}, DiskBlockKey{2, 0U, 0}}, lock), ge::LLM_PARAM_INVALID);
+    EXPECT_EQ(store.index_.size(), 4U);
+    EXPECT_EQ(store.lru_.size(), 4U);
+    EXPECT_EQ(store.used_size_, 4UL * kBlockSize);
+    // eviction skips lru entries without a block
+    store.lru_.push_front(DiskBlockKey{9, 0U, 0});
+    EXPECT_TRUE(store.EvictOne());
+    EXPECT_EQ(store.index_.count(DiskBlockKey{1, 0U, 0}), 0U);
+    store.lru_.pop_front();
+  }
+  EXPECT_EQ(store.GetUsedSize(), 3UL * kBlockSize);
+}
+
+TEST_F(DiskBlockStoreTest, LeastRecentlyUsedBlocksAreEvictedWhenFull) {
+  DiskBlockStore store(MakeOptions(8UL * kBlockSize));
+  ASSERT_EQ(store.Initialize(), ge::SUCCESS);
+  std::vector<uint8_t> cache(8UL * kBlockSize);
+  FillBlocks(cache, 4U);
+  ASSERT_EQ(store.SwapOut({Addr(cache)}, 1, kBlockSize, MakeMapping(0, 0, 8)), ge::SUCCESS);
+  std::vector<uint8_t> restore(8UL * kBlockSize);
+  // touch blocks 4~7, so blocks 0~3 become the least recently used
+  ASSERT_EQ(store.SwapIn(1, {Addr(restore)}, kBlockSize, MakeMapping(4, 4, 4)), ge::SUCCESS);
+  ASSERT_EQ(store.SwapOut({Addr(cache)}, 2, kBlockSize, MakeMapping(0, 0, 3)), ge::SUCCESS);
+  for (int64_t block = 0; block < 8; ++block) {
+    EXPECT_EQ(store.Contains(DiskBlockKey{1, 0U, block}), block >= 3) << block;
+  }
+  EXPECT_EQ(store.GetUsedSize(), 8UL * kBlockSize);
+  ASSERT_EQ(store.SwapIn(2, {Addr(restore)}, kBlockSize, MakeMapping(0, 0, 3)), ge::SUCCESS);
+  EXPECT_TRUE(std::equal(cache.begin(), cache.begin() + 3 * kBlockSize, restore.begin()));
+  // a swap out larger than the whole file can not be served
+  std::vector<uint8_t> large(9UL * kBlockSize);
+  EXPECT_EQ(store.SwapOut({Addr(large)}, 3, kBlockSize, MakeMapping(0, 0, 9)), ge::LLM_OUT_OF_MEMORY);
+  EXPECT_FALSE(store.Contains(DiskBlockKey{3, 0U, 0}));
+  EXPECT_TRUE(store.Contains(DiskBlockKey{2, 0U, 0}));
+}
+
+TEST_F(DiskBlockStoreTest, OverwriteAndRemove) {
+  DiskBlockStore store(MakeOptions(16UL * kBlockSize));
+  ASSERT_EQ(store.Initialize(), ge::SUCCESS);
+  std::vector<uint8_t> cache(4UL * kBlockSize);
+  FillBlocks(cache, 5U);
+  ASSERT_EQ(store.SwapOut({Addr(cache)}, 1, kBlockSize, MakeMapping(0, 0, 4)), ge::SUCCESS);
+  FillBlocks(cache, 6U);
+  ASSERT_EQ(store.SwapOut({Addr(cache)}, 1, kBlockSize, MakeMapping(0, 0, 4)), ge::SUCCESS);
+  EXPECT_EQ(store.GetUsedSize(), 4UL * kBlockSize);
+  std::vector<uint8_t> restore(4UL * kBlockSize);
+  ASSERT_EQ(store.SwapIn(1, {Addr(restore)}, kBlockSize, MakeMapping(0, 0, 4)), ge::SUCCESS);
+  EXPECT_EQ(restore, cache);
+  store.Remove(1);
+  EXPECT_EQ(store.GetUsedSize(), 0UL);
+  EXPECT_FALSE(store.Contains(DiskBlockKey{1, 0U, 0}));
+  ASSERT_EQ(store.free_extents_.size(), 1U);
+  EXPECT_EQ(store.free_extents_.begin()->second, 16UL * kBlockSize);
+}
+
+TEST_F(DiskBlockStoreTest, SequentialSwapInIsReadAhead) {
+  auto options = MakeOptions(64UL * kBlockSize);
+  options.read_ahead_blocks = 4U;
+  DiskBlockStore store(options);
+  ASSERT_EQ(store.Initialize(), ge::SUCCESS);
+  std::vector<uint8_t> cache(32UL * kBlockSize);
+  FillBlocks(cache, 7U);
+  ASSERT_EQ(store.SwapOut({Addr(cache)}, 1, kBlockSize, MakeMapping(0, 0, 32)), ge::SUCCESS);
+  std::vector<uint8_t> restore(32UL * kBlockSize);
+  ASSERT_EQ(store.SwapIn(1, {Addr(restore)}, kBlockSize, MakeMapping(0, 0, 4)), ge::SUCCESS);
+  EXPECT_TRUE(store.read_ahead_.empty());
+  ASSERT_EQ(store.SwapIn(1, {Addr(restore)}, kBlockSize, MakeMapping(4, 4, 4)), ge::SUCCESS);
+  EXPECT_EQ(store.read_ahead_.size(), 4U);
+  EXPECT_EQ(store.read_ahead_.count(DiskBlockKey{1, 0U, 8}), 1U);
+  // served from the read ahead buffer, which is consumed and refilled further ahead
+  ASSERT_EQ(store.SwapIn(1, {Addr(restore)}, kBlockSize, MakeMapping(8, 8, 4)), ge::SUCCESS);
+  EXPECT_EQ(store.read_ahead_.count(DiskBlockKey{1, 0U, 8}), 0U);
+  EXPECT_EQ(store.read_ahead_.count(DiskBlockKey{1, 0U, 12}), 1U);
+  ASSERT_EQ(store.SwapIn(1, {Addr(restore)}, kBlockSize, MakeMapping(12, 12, 20)), ge::SUCCESS);
+  EXPECT_EQ(restore, cache);
+
+  // an overwritten block is never served from a stale read ahead copy
+  ASSERT_EQ(store.SwapIn(1, {Addr(restore)}, kBlockSize, MakeMapping(0, 0, 4)), ge::SUCCESS);
+  ASSERT_EQ(store.SwapIn(1, {Addr(restore)}, kBlockSize, MakeMapping(4, 4, 4)), ge::SUCCESS);
+  ASSERT_EQ(store.read_ahead_.count(DiskBlockKey{1, 0U, 8}), 1U);
+  std::vector<uint8_t> update(kBlockSize, 0xAB);
+  ASSERT_EQ(store.SwapOut({Addr(update)}, 1, kBlockSize, {{0, 8}}), ge::SUCCESS);
+  ASSERT_EQ(store.SwapIn(1, {Addr(restore)}, kBlockSize, {{8, 8}}), ge::SUCCESS);
+  EXPECT_TRUE(std::equal(update.begin(), update.end(), restore.begin() + 8 * kBlockSize));
+  store.Finalize();
+  EXPECT_TRUE(store.read_ahead_.empty());
+}
+
+TEST_F(DiskBlockStoreTest, AsyncSwapOverlapsRequests) {
+  DiskBlockStore store(MakeOptions(64UL * kBlockSize));
+  ASSERT_EQ(store.Initialize(), ge::SUCCESS);
+  std::vector<std::vector<uint8_t>> caches(4U, std::vector<uint8_t>(8UL * kBlockSize));
+  std::vector<DiskIoHandle> handles(caches.size());
+  for (size_t i = 0U; i < caches.size(); ++i) {
+    FillBlocks(caches[i], static_cast<uint8_t>(i));
+    ASSERT_EQ(store.SwapOutAsync({Addr(caches[i])}, static_cast<int64_t>(i), kBlockSize, MakeMapping(0, 0, 8),
+                                 handles[i]), ge::SUCCESS);
+  }
+  std::vector<std::vector<uint8_t>> restores(caches.size(), std::vector<uint8_t>(8UL * kBlockSize));
+  // swap in of a block still being written waits for the write
+  for (size_t i = 0U; i < caches.size(); ++i) {
+    ASSERT_EQ(store.SwapInAsync(static_cast<int64_t>(i), {Addr(restores[i])}, kBlockSize, MakeMapping(0, 0, 8),
+                                handles[i]), ge::SUCCESS);
+  }
+  for (size_t i = 0U; i < caches.size(); ++i) {
+    EXPECT_EQ(handles[i]->Wait(), ge::SUCCESS);
+    EXPECT_TRUE(handles[i]->IsCompleted());
+    EXPECT_EQ(restores[i], caches[i]);
+  }
+}
+
+TEST_F(DiskBlockStoreTest, CrossedSwapOutsDoNotDeadlock) {
+  DiskBlockStore store(MakeOptions(16UL * kBlockSize));
+  ASSERT_EQ(store.Initialize(), ge::SUCCESS);
+  std::vector<uint8_t> cache_a(2UL * kBlockSize);
+  std::vector<uint8_t> cache_b(2UL * kBlockSize);
+  FillBlocks(cache_a, 1U);
+  FillBlocks(cache_b, 2U);
+  const std::vector<std::pair<int64_t, int64_t>> mapping_a = {{0, 10}, {1, 20}};
+  const std::vector<std::pair<int64_t, int64_t>> mapping_b = {{0, 20}, {1, 10}};
+  ASSERT_EQ(store.SwapOut({Addr(cache_a)}, 1, kBlockSize, mapping_a), ge::SUCCESS);
+  // pins the blocks as a swap in still reading them would
+  const auto set_io_refs = [&store](int64_t block_index, uint32_t io_refs) {
+    std::lock_guard<std::mutex> lock(store.mu_);
+    store.index_.at(DiskBlockKey{1, 0U, block_index}).io_refs = io_refs;
+    store.cv_.notify_all();
+  };
+  set_io_refs(10, 1U);
+  set_io_refs(20, 1U);
+  DiskIoHandle handle_a;
+  DiskIoHandle handle_b;
+  // both swap outs wait for the pinned blocks, reached in opposite order
+  auto swap_a = std::async(std::launch::async, [&]() {
+    return store.SwapOutAsync({Addr(cache_a)}, 1, kBlockSize, mapping_a, handle_a);
+  });
+  auto swap_b = std::async(std::launch::async, [&]() {
+    return store.SwapOutAsync({Addr(cache_b)}, 1, kBlockSize, mapping_b, handle_b);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  // a swap out reserving block 10 alone here and waiting for 20 would deadlock with the other one
+  set_io_refs(10, 0U);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  set_io_refs(20, 0U);
+  ASSERT_EQ(swap_a.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  ASSERT_EQ(swap_b.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  EXPECT_EQ(swap_a.get(), ge::SUCCESS);
+  EXPECT_EQ(swap_b.get(), ge::SUCCESS);
+  EXPECT_EQ(handle_a->Wait(), ge::SUCCESS);
+  EXPECT_EQ(handle_b->Wait(), ge::SUCCESS);
+  EXPECT_EQ(store.GetUsedSize(), 2UL * kBlockSize);
+  // the later swap out wrote both blocks
+  std::vector<uint8_t> restore(2UL * kBlockSize);
+  ASSERT_EQ(store.SwapIn(1, {Addr(restore)}, kBlockSize, {{10, 0}, {20, 1}}), ge::SUCCESS);
+  const bool a_last = std::equal(restore.begin(), restore.end(), cache_a.begin());
+  const bool b_last = std::equal(restore.begin(), restore.begin() + kBlockSize, cache_b.begin() + kBlockSize) &&
+                      std::equal(restore.begin() + kBlockSize, restore.end(), cache_b.begin());
+  EXPECT_TRUE(a_last || b_last);
+}
+}  // namespace llm
@@ -0,0 +1,297 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "link_mgr/entity_scheduler.h"
+#include "link_mgr/comm_entity_manager.h"
+
+namespace llm {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// stands in for a comm entity: the request flag is flipped by the "remote" test thread
+struct StubEntity {
+  std::atomic<int8_t> req_flag{0};
+  std::atomic<int32_t> steps_left{0};  // steps of the transfer started by the request
+  std::atomic<int32_t> running{0};
+  std::atomic<int32_t> overlapped{0};
+  std::atomic<int32_t> served{0};
+};
+
+class StubEntities {
+ public:
+  explicit StubEntities(size_t num, int32_t steps_per_request = 1) : steps_per_request_(steps_per_request) {
+    for (size_t i = 0U; i < num; ++i) {
+      entities_.emplace_back(new StubEntity());
+    }
+  }
+  EntityScheduler::ProcessFunc ProcessFunc() {
+    return [this](uint64_t id) {
+      auto &entity = *entities_[id];
+      if (entity.running.fetch_add(1) != 0) {
+        entity.overlapped++;
+      }
+      bool run_again = false;
+      if (entity.steps_left.load() > 0) {
+        run_again = (--entity.steps_left > 0);
+        if (!run_again) {
+          entity.served++;
+        }
+      } else if (entity.req_flag.load() == 1) {
+        entity.req_flag = 0;
+        entity.steps_left = steps_per_request_;
+        run_again = true;
+      }
+      entity.running--;
+      return run_again;
+    };
+  }
+  void WatchAll(EntityScheduler &scheduler) {
+    for (size_t i = 0U; i < entities_.size(); ++i) {
+      StubEntity *entity = entities_[i].get();
+      scheduler.Watch(i, [entity]() { return entity->req_flag.load(std::memory_order_relaxed) == 1; });
+    }
+  }
+  StubEntity &operator[](size_t index) {
+    return *entities_[index];
+  }
+  size_t size() const {
+    return entities_.size();
+  }
+
+ private:
+  int32_t steps_per_request_;
+  std::vector<std::unique_ptr<StubEntity>> entities_;
+};
+
+bool WaitUntil(const std::function<bool()> &cond, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+  const auto deadline = Clock::now() + timeout;
+  while (!cond()) {
+    if (Clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+}  // namespace
+
+class EntitySchedulerTest : public ::testing::Test {};
+
+TEST_F(EntitySchedulerTest, ServeRequestsOfAllEntities) {
+  StubEntities entities(16U, 4);
+  EntityScheduler scheduler(EntitySchedulerOptions{}, entities.ProcessFunc());
+  ASSERT_EQ(scheduler.Start("ut_fsm"), ge::SUCCESS);
+  entities.WatchAll(scheduler);
+  for (int32_t round = 0; round < 10; ++round) {
+    for (size_t i = 0U; i < entities.size(); ++i) {
+      entities[i].req_flag = 1;
+    }
+    ASSERT_TRUE(WaitUntil([&entities, round]() {
+      for (size_t i = 0U; i < entities.size(); ++i) {
+        if (entities[i].served.load() != round + 1) {
+          return false;
+        }
+      }
+      return true;
+    }));
+  }
+  scheduler.Stop();
+}
+
+TEST_F(EntitySchedulerTest, NeverRunOneEntityOnTwoWorkers) {
+  StubEntities entities(8U, 16);
+  EntitySchedulerOptions options{};
+  options.worker_num = 4U;
+  options.spin_time_us = 0UL;
+  EntityScheduler scheduler(options, entities.ProcessFunc());
+  ASSERT_EQ(scheduler.Start("ut_fsm"), ge::SUCCESS);
+  entities.WatchAll(scheduler);
+  constexpr int32_t kRounds = 50;
+  for (int32_t round = 0; round < kRounds; ++round) {
+    for (size_t i = 0U; i < entities.size(); ++i) {
+      entities[i].req_flag = 1;
+      // a local event racing with the doorbell must not start a second run
+      scheduler.Notify(i);
+    }
+    ASSERT_TRUE(WaitUntil([&entities, round]() {
+      for (size_t i = 0U; i < entities.size(); ++i) {
+        if (entities[i].served.load() < round + 1) {
+          return false;
+        }
+      }
+      return true;
+    }));
+  }
+  scheduler.Stop();
+  for (size_t i = 0U; i < entities.size(); ++i) {
+    EXPECT_EQ(entities[i].overlapped.load(), 0);
+    EXPECT_EQ(entities[i].served.load(), kRounds);
+  }
+}
+
+TEST_F(EntitySchedulerTest, UnwatchAndNotify) {
+  StubEntities entities(2U);
+  std::atomic<int32_t> notified_runs{0};
+  auto stub_process = entities.ProcessFunc();
+  EntityScheduler scheduler(EntitySchedulerOptions{}, [&notified_runs, &stub_process](uint64_t id) {
+    if (id == 1U) {
+      notified_runs++;
+      return false;
+    }
+    return stub_process(id);
+  });
+  ASSERT_EQ(scheduler.Start("ut_fsm"), ge::SUCCESS);
+  entities.WatchAll(scheduler);
+  // entity 1 is never probed ready, a notify still runs it once
+  scheduler.Notify(1U);
+  ASSERT_TRUE(WaitUntil([&notified_runs]() { return notified_runs.load() == 1; }));
+  scheduler.Unwatch(0U);
+  entities[0].req_flag = 1;
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(entities[0].served.load(), 0);
+  EXPECT_EQ(entities[0].req_flag.load(), 1);
+  scheduler.Notify(0U);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(entities[0].req_flag.load(), 1);
+  EXPECT_EQ(notified_runs.load(), 1);
+  scheduler.Stop();
+}
+
+TEST_F(EntitySchedulerTest, InvalidOptions) {
+  EntitySchedulerOptions options{};
+  options.worker_num = 0U;
+  EntityScheduler scheduler(options, [](uint64_t) { return false; });
+  EXPECT_EQ(scheduler.Start("ut_fsm"), ge::LLM_PARAM_INVALID);
+  EntityScheduler no_process(EntitySchedulerOptions{}, nullptr);
+  EXPECT_EQ(no_process.Start("ut_fsm"), ge::LLM_PARAM_INVALID);
+}
+
+TEST_F(EntitySchedulerTest, NoPollWithoutWatchedEntity) {
+  StubEntities entities(1U);
+  EntityScheduler scheduler(EntitySchedulerOptions{}, entities.ProcessFunc());
+  ASSERT_EQ(scheduler.Start("ut_fsm"), ge::SUCCESS);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  auto stats = scheduler.GetPollStats();
+  EXPECT_EQ(stats.poll_rounds, 0UL);
+  EXPECT_EQ(stats.sleeps, 0UL);
+
+  entities.WatchAll(scheduler);
+  ASSERT_TRUE(WaitUntil([&scheduler]() { return scheduler.GetPollStats().sleeps > 0UL; }));
+  scheduler.Unwatch(0U);
+  // the poller blocks again once its current sleep ends
+  const auto unwatched_stats = scheduler.GetPollStats();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  stats = scheduler.GetPollStats();
+  EXPECT_EQ(stats.watched_num, 0U);
+  EXPECT_EQ(stats.poll_rounds, unwatched_stats.poll_rounds);
+  scheduler.Stop();
+}
+
+TEST_F(EntitySchedulerTest, BackoffDoublesUpToMaxSleep) {
+  StubEntities entities(1U);
+  EntitySchedulerOptions options{};
+  options.spin_time_us = 0UL;
+  options.max_sleep_time_us = 64UL;
+  EntityScheduler scheduler(options, entities.ProcessFunc());
+  ASSERT_EQ(scheduler.Start("ut_fsm"), ge::SUCCESS);
+  entities.WatchAll(scheduler);
+  // 1, 2, 4, ... us between passes, so the 7th sleep is the first one at the cap
+  for (uint64_t sleeps = 1UL; sleeps <= 10UL; ++sleeps) {
+    ASSERT_TRUE(WaitUntil([&scheduler, sleeps]() { return scheduler.GetPollStats().sleeps >= sleeps; }));
+  }
+  const auto stats = scheduler.GetPollStats();
+  EXPECT_EQ(stats.last_sleep_us, 64UL);
+  // one pass after the watch wakeup, then one pass per sleep
+  EXPECT_EQ(stats.poll_rounds, stats.sleeps + 1UL);
+  scheduler.Stop();
+}
+
+TEST_F(EntitySchedulerTest, SpinPhaseNeverSleeps) {
+  StubEntities entities(4U);
+  EntitySchedulerOptions options{};
+  options.spin_time_us = 3600UL * 1000UL * 1000UL;
+  EntityScheduler scheduler(options, entities.ProcessFunc());
+  ASSERT_EQ(scheduler.Start("ut_fsm"), ge::SUCCESS);
+  entities.WatchAll(scheduler);
+  ASSERT_TRUE(WaitUntil([&scheduler]() { return scheduler.GetPollStats().poll_rounds >= 100UL; }));
+  EXPECT_EQ(scheduler.GetPollStats().sleeps, 0UL);
+  scheduler.Stop();
+}
+
+TEST_F(EntitySchedulerTest, RewatchWhileRunning) {
+  StubEntities entities(1U);
+  std::atomic<bool> in_step{false};
+  std::atomic<bool> release{false};
+  std::atomic<int32_t> runs{0};
+  auto stub_process = entities.ProcessFunc();
+  EntityScheduler scheduler(EntitySchedulerOptions{}, [&](uint64_t id) {
+    runs++;
+    in_step = true;
+    while (!release.load()) {
+      std::this_thread::yield();
+    }
+    in_step = false;
+    return stub_process(id);
+  });
+  ASSERT_EQ(scheduler.Start("ut_fsm"), ge::SUCCESS);
+  entities.WatchAll(scheduler);
+  scheduler.Notify(0U);
+  ASSERT_TRUE(WaitUntil([&in_step]() { return in_step.load(); }));
+  // the id is reused while its former step still runs
+  scheduler.Unwatch(0U);
+  entities.WatchAll(scheduler);
+  entities[0].req_flag = 1;
+  scheduler.Notify(0U);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(runs.load(), 1);
+  EXPECT_EQ(scheduler.GetPollStats().watched_num, 0U);
+  release = true;
+  ASSERT_TRUE(WaitUntil([&entities]() { return entities[0].served.load() == 1; }));
+  ASSERT_TRUE(WaitUntil([&scheduler]() { return scheduler.GetPollStats().watched_num == 1U; }));
+  EXPECT_EQ(entities[0].overlapped.load(), 0);
+
+  // unwatched while running and not watched again, dropped when the step returns
+  release = false;
+  entities[0].req_flag = 1;
+  ASSERT_TRUE(WaitUntil([&in_step]() { return in_step.load(); }));
+  scheduler.Unwatch(0U);
+  release = true;
+  ASSERT_TRUE(WaitUntil([&in_step]() { return !in_step.load(); }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(scheduler.GetPollStats().watched_num, 0U);
+  scheduler.Stop();
+}
+
+TEST_F(EntitySchedulerTest, ParseSchedulerOptions) {
+  EntitySchedulerOptions options{};
+  std::map<ge::AscendString, ge::AscendString> llm_options;
+  EXPECT_EQ(CommEntityManager::ParseSchedulerOptions(llm_options, options), ge::SUCCESS);
+  EXPECT_EQ(options.worker_num, 1U);
+  llm_options[LLM_OPTION_FSM_SCHEDULER_CONFIG] = "{\"worker_num\": 4, \"spin_time_us\": 0, \"max_sleep_time_us\": 50}";
+  EXPECT_EQ(CommEntityManager::ParseSchedulerOptions(llm_options, options), ge::SUCCESS);
+  EXPECT_EQ(options.worker_num, 4U);
+  EXPECT_EQ(options.spin_time_us, 0UL);
+  EXPECT_EQ(options.max_sleep_time_us, 50UL);
+  llm_options[LLM_OPTION_FSM_SCHEDULER_CONFIG] = "{\"worker_num\": 0}";
+  EXPECT_EQ(CommEntityManager::ParseSchedulerOptions(llm_options, options), ge::LLM_PARAM_INVALID);
+  llm_options[LLM_OPTION_FSM_SCHEDULER_CONFIG] = "{\"spin_time_us\": -1}";
+  EXPECT_EQ(CommEntityManager::ParseSchedulerOptions(llm_options, options), ge::LLM_PARAM_INVALID);
+  llm_options[LLM_OPTION_FSM_SCHEDULER_CONFIG] = "{\"worker_num\": ";
+  EXPECT_EQ(CommEntityManager::ParseSchedulerOptions(llm_options, options), ge::LLM_PARAM_INVALID);
+}
+}  // namespace llm
@@ -15,12 +15,14 @@
 #include <cstring>
 #include <algorithm>
 #include <cstdlib>
+#include <map>
 #include "adxl/fabric_mem_transfer_service.h"
 #include "adxl/channel.h"
 #include "depends/ascendcl/src/ascendcl_stub.h"
 #include "acl/acl.h"
 #include "common/def_types.h"
 #include "adxl/virtual_memory_manager.h"
+#include "adxl/copy_stream_balancer.h"
 
 namespace adxl {
 namespace {
@@ -96,6 +98,22 @@ void *GetBackingRemotePtr(const ChannelPtr &channel, uint64_t remote_addr) {
   }
   return nullptr;
 }
+// counts what each stream is asked to copy, copies nothing
+class MemcpyRecordRuntimeStub : public llm::AclRuntimeStub {
+ public:
+  aclError aclrtMemcpyAsync(void *dst, size_t dest_max, const void *src, size_t src_count, aclrtMemcpyKind kind,
+                            aclrtStream stream) override {
+    (void)dst;
+    (void)dest_max;
+    (void)src;
+    (void)kind;
+    stream_bytes_[stream] += src_count;
+    ++launch_num_;
+    return ACL_ERROR_NONE;
+  }
+  std::map<aclrtStream, uint64_t> stream_bytes_;
+  size_t launch_num_ = 0U;
+};
 }  // namespace
 
 class FabricMemTransferServiceUTest : public ::testing::Test {
@@ -414,4 +432,42 @@ TEST_F(FabricMemTransferServiceUTest, TestGetShareHandles) {
   EXPECT_EQ(service_->DeregisterMem(handle), SUCCESS);
 }
 
+TEST_F(FabricMemTransferServiceUTest, TestProcessCopyWithAsync_BalanceStreams) {
+  auto record_runtime = std::make_shared<MemcpyRecordRuntimeStub>();
+  ScopedRuntimeMock record_mock(record_runtime);
+  constexpr size_t kStreamNum = 4U;
+  constexpr size_t kLargeLen = 8UL << 20U;
+  constexpr size_t kSmallLen = 64UL << 10U;
+  std::vector<aclrtStream> streams;
+  for (size_t i = 0U; i < kStreamNum; ++i) {
+    streams.emplace_back(llm::ValueToPtr(kReqBase + i));
+  }
+  // large layers in front of many small kv blocks, with holes between so nothing merges
+  std::vector<TransferOpDesc> descs;
+  uintptr_t offset = 0U;
+  for (size_t i = 0U; i < 128U; ++i) {
+    const size_t len = (i < 3U) ? kLargeLen : kSmallLen;
+    descs.emplace_back(TransferOpDesc{kMemAddr + offset, kRemoteAddr + offset, len});
+    offset += len * 2U;
+  }
+  ASSERT_EQ(FabricMemTransferService::ProcessCopyWithAsync(streams, TransferOp::READ, descs), SUCCESS);
+
+  std::vector<std::vector<TransferOpDesc>> round_robin(kStreamNum);
+  for (size_t i = 0U; i < descs.size(); ++i) {
+    round_robin[i % kStreamNum].emplace_back(descs[i]);
+  }
+  uint64_t total_bytes = 0U;
+  uint64_t max_bytes = 0U;
+  for (const auto &stream : streams) {
+    total_bytes += record_runtime->stream_bytes_[stream];
+    max_bytes = std::max(max_bytes, record_runtime->stream_bytes_[stream]);
+  }
+  const double balanced = static_cast<double>(max_bytes) * kStreamNum / static_cast<double>(total_bytes);
+  const double before = CopyStreamBalancer::Imbalance(round_robin);
+  EXPECT_EQ(total_bytes, 3U * kLargeLen + 125U * kSmallLen);
+  EXPECT_EQ(record_runtime->stream_bytes_.size(), kStreamNum);
+  EXPECT_LT(balanced, 1.05);
+  EXPECT_LT(balanced, before);
+}
+
 }  // namespace adxl
@@ -0,0 +1,241 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "adxl/adxl_inner_engine.h"
+#include "adxl/channel_manager.h"
+#include "adxl/channel_msg_handler.h"
+#include "depends/mmpa/src/mmpa_stub.h"
+#include "depends/llm_datadist/src/data_cache_engine_test_helper.h"
+
+namespace adxl {
+namespace {
+constexpr const char *kClientEngine = "127.0.0.1";
+constexpr const char *kServerEngine = "127.0.0.1:26001";
+constexpr int32_t kTimeoutInMillis = 3000;
+
+struct CommInitRecord {
+  std::string comm_name;
+  uint32_t traffic_class;
+  uint32_t service_level;
+};
+
+// gives every comm a distinct handle and records which comm each transfer goes through
+class RecordingHcclApiStub : public llm::HcclApiStub {
+ public:
+  HcclResult HcclCommInitClusterInfoMem(const char *cluster, uint32_t rank, HcclCommConfig *config,
+                                        HcclComm *comm) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    init_records_.push_back({config->hcclCommName, config->hcclRdmaTrafficClass, config->hcclRdmaServiceLevel});
+    *comm = reinterpret_cast<HcclComm>(++comm_count_);
+    return HCCL_SUCCESS;
+  }
+
+  HcclResult HcclBatchGet(HcclComm comm, uint32_t remoteRank, HcclOneSideOpDesc *desc, uint32_t descNum,
+                          aclrtStream stream) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      transfer_comms_.push_back(comm);
+    }
+    return llm::HcclApiStub::HcclBatchGet(comm, remoteRank, desc, descNum, stream);
+  }
+
+  std::vector<CommInitRecord> GetInitRecords() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return init_records_;
+  }
+
+  std::vector<HcclComm> GetTransferComms() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return transfer_comms_;
+  }
+
+ private:
+  std::mutex mutex_;
+  uintptr_t comm_count_ = 0U;
+  std::vector<CommInitRecord> init_records_;
+  std::vector<HcclComm> transfer_comms_;
+};
+
+bool EndsWith(const std::string &str, const std::string &suffix) {
+  return (str.size() >= suffix.size()) && (str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0);
+}
+}  // namespace
+
+class HighPriorityCommUTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    llm::MockMmpaForHcclApi::Install();
+    llm::AutoCommResRuntimeMock::Install();
+    auto stub = std::make_unique<RecordingHcclApiStub>();
+    stub_ = stub.get();
+    llm::HcclApiStub::SetStub(std::move(stub));
+    llm::HcclAdapter::GetInstance().Initialize();
+  }
+  void TearDown() override {
+    llm::HcclAdapter::GetInstance().Finalize();
+    llm::AutoCommResRuntimeMock::Reset();
+    llm::MockMmpaForHcclApi::Reset();
+    stub_ = nullptr;
+  }
+
+  void SetupEngines(AdxlInnerEngine &client, AdxlInnerEngine &server, bool client_high_priority,
+                    bool server_high_priority) {
+    llm::AutoCommResRuntimeMock::SetDevice(0);
+    std::map<AscendString, AscendString> client_options;
+    client_options[OPTION_RDMA_TRAFFIC_CLASS] = "1";
+    client_options[OPTION_RDMA_SERVICE_LEVEL] = "1";
+    if (client_high_priority) {
+      client_options[OPTION_RDMA_HIGH_PRIORITY_TRAFFIC_CLASS] = "2";
+      client_options[OPTION_RDMA_HIGH_PRIORITY_SERVICE_LEVEL] = "3";
+    }
+    EXPECT_EQ(client.Initialize(client_options), SUCCESS);
+
+    llm::AutoCommResRuntimeMock::SetDevice(1);
+    std::map<AscendString, AscendString> server_options;
+    if (server_high_priority) {
+      server_options[OPTION_RDMA_HIGH_PRIORITY_TRAFFIC_CLASS] = "2";
+      server_options[OPTION_RDMA_HIGH_PRIORITY_SERVICE_LEVEL] = "3";
+    }
+    EXPECT_EQ(server.Initialize(server_options), SUCCESS);
+  }
+
+  void RegisterInt32Mem(AdxlInnerEngine &engine, int32_t *ptr, MemHandle &handle) {
+    adxl::MemDesc mem_desc{};
+    mem_desc.addr = reinterpret_cast<uintptr_t>(ptr);
+    mem_desc.len = sizeof(int32_t);
+    EXPECT_EQ(engine.RegisterMem(mem_desc, MEM_DEVICE, handle), SUCCESS);
+  }
+
+  RecordingHcclApiStub *stub_ = nullptr;
+};
+
+TEST_F(HighPriorityCommUTest, BothEndsConfiguredCreatesHighPriorityComm) {
+  AdxlInnerEngine client(kClientEngine);
+  AdxlInnerEngine server(kServerEngine);
+  SetupEngines(client, server, true, true);
+  int32_t src = 1;
+  int32_t dst = 2;
+  MemHandle handle1 = nullptr;
+  MemHandle handle2 = nullptr;
+  RegisterInt32Mem(client, &src, handle1);
+  RegisterInt32Mem(server, &dst, handle2);
+  EXPECT_EQ(client.Connect(kServerEngine, kTimeoutInMillis), SUCCESS);
+
+  auto client_channel = client.channel_manager_.GetChannel(ChannelType::kClient, kServerEngine);
+  auto server_channel = server.channel_manager_.GetChannel(ChannelType::kServer, kClientEngine);
+  ASSERT_NE(client_channel, nullptr);
+  ASSERT_NE(server_channel, nullptr);
+  for (const auto &channel : {client_channel, server_channel}) {
+    EXPECT_TRUE(channel->channel_info_.with_high_priority_comm);
+    EXPECT_NE(channel->GetComm(TransferPriority::NORMAL), nullptr);
+    EXPECT_NE(channel->GetComm(TransferPriority::HIGH), nullptr);
+    EXPECT_NE(channel->GetComm(TransferPriority::HIGH), channel->GetComm(TransferPriority::NORMAL));
+  }
+  // both ends must name the hp comm alike, otherwise the two comms never pair up
+  EXPECT_STREQ(client_channel->channel_info_.high_priority_comm_config.hcclCommName,
+               server_channel->channel_info_.high_priority_comm_config.hcclCommName);
+
+  size_t high_priority_inits = 0U;
+  for (const auto &record : stub_->GetInitRecords()) {
+    if (EndsWith(record.comm_name, "_hp")) {
+      ++high_priority_inits;
+      EXPECT_EQ(record.traffic_class, 2U);
+      EXPECT_EQ(record.service_level, 3U);
+    }
+  }
+  EXPECT_EQ(high_priority_inits, 2U);
+
+  TransferOpDesc desc{reinterpret_cast<uintptr_t>(&src), reinterpret_cast<uintptr_t>(&dst), sizeof(int32_t)};
+  TransferArgs high_args;
+  high_args.priority = TransferPriority::HIGH;
+  EXPECT_EQ(client.TransferSync(kServerEngine, READ, {desc}, high_args, kTimeoutInMillis), SUCCESS);
+  EXPECT_EQ(src, 2);
+  TransferArgs normal_args;
+  EXPECT_EQ(client.TransferSync(kServerEngine, READ, {desc}, normal_args, kTimeoutInMillis), SUCCESS);
+  const auto transfer_comms = stub_->GetTransferComms();
+  ASSERT_EQ(transfer_comms.size(), 2U);
+  EXPECT_EQ(transfer_comms[0], client_channel->GetComm(TransferPriority::HIGH));
+  EXPECT_EQ(transfer_comms[1], client_channel->GetComm(TransferPriority::NORMAL));
+
+  EXPECT_EQ(client.Disconnect(kServerEngine, kTimeoutInMillis), SUCCESS);
+  EXPECT_EQ(client.DeregisterMem(handle1), SUCCESS);
+  EXPECT_EQ(server.DeregisterMem(handle2), SUCCESS);
+  client.Finalize();
+  server.Finalize();
+}
+
+TEST_F(HighPriorityCommUTest, OneEndConfiguredFallsBackToNormalComm) {
+  AdxlInnerEngine client(kClientEngine);
+  AdxlInnerEngine server(kServerEngine);
+  SetupEngines(client, server, true, false);
+  int32_t src = 1;
+  int32_t dst = 2;
+  MemHandle handle1 = nullptr;
+  MemHandle handle2 = nullptr;
+  RegisterInt32Mem(client, &src, handle1);
+  RegisterInt32Mem(server, &dst, handle2);
+  EXPECT_EQ(client.Connect(kServerEngine, kTimeoutInMillis), SUCCESS);
+
+  auto client_channel = client.channel_manager_.GetChannel(ChannelType::kClient, kServerEngine);
+  auto server_channel = server.channel_manager_.GetChannel(ChannelType::kServer, kClientEngine);
+  ASSERT_NE(client_channel, nullptr);
+  ASSERT_NE(server_channel, nullptr);
+  for (const auto &channel : {client_channel, server_channel}) {
+    EXPECT_FALSE(channel->channel_info_.with_high_priority_comm);
+    EXPECT_EQ(channel->channel_info_.high_priority_comm, nullptr);
+    EXPECT_EQ(channel->GetComm(TransferPriority::HIGH), channel->GetComm(TransferPriority::NORMAL));
+  }
+  for (const auto &record : stub_->GetInitRecords()) {
+    EXPECT_FALSE(EndsWith(record.comm_name, "_hp"));
+  }
+
+  TransferOpDesc desc{reinterpret_cast<uintptr_t>(&src), reinterpret_cast<uintptr_t>(&dst), sizeof(int32_t)};
+  TransferArgs high_args;
+  high_args.priority = TransferPriority::HIGH;
+  EXPECT_EQ(client.TransferSync(kServerEngine, READ, {desc}, high_args, kTimeoutInMillis), SUCCESS);
+  EXPECT_EQ(src, 2);
+  const auto transfer_comms = stub_->GetTransferComms();
+  ASSERT_EQ(transfer_comms.size(), 1U);
+  EXPECT_EQ(transfer_comms[0], client_channel->GetComm(TransferPriority::NORMAL));
+
+  EXPECT_EQ(client.Disconnect(kServerEngine, kTimeoutInMillis), SUCCESS);
+  EXPECT_EQ(client.DeregisterMem(handle1), SUCCESS);
+  EXPECT_EQ(server.DeregisterMem(handle2), SUCCESS);
+  client.Finalize();
+  server.Finalize();
+}
+
+TEST_F(HighPriorityCommUTest, ShortCommNameGetsSuffix) {
+  EXPECT_EQ(ChannelMsgHandler::GetHighPriorityCommName("127.0.0.1_127.0.0.1:26001"), "127.0.0.1_127.0.0.1:26001_hp");
+}
+
+TEST_F(HighPriorityCommUTest, LongCommNameKeptWithinMaxLength) {
+  const std::string long_name(COMM_NAME_MAX_LENGTH - 2U, 'a');
+  const std::string name = ChannelMsgHandler::GetHighPriorityCommName(long_name);
+  EXPECT_LT(name.size(), static_cast<size_t>(COMM_NAME_MAX_LENGTH));
+  EXPECT_TRUE(EndsWith(name, "_hp"));
+  EXPECT_EQ(name, ChannelMsgHandler::GetHighPriorityCommName(long_name));
+
+  // names that only differ past the kept prefix must stay distinct
+  std::string other_name = long_name;
+  other_name.back() = 'b';
+  EXPECT_NE(name, ChannelMsgHandler::GetHighPriorityCommName(other_name));
+
+  const std::string max_name(COMM_NAME_MAX_LENGTH - 1U, 'a');
+  EXPECT_LT(ChannelMsgHandler::GetHighPriorityCommName(max_name).size(), static_cast<size_t>(COMM_NAME_MAX_LENGTH));
+}
+}  // namespace adxl
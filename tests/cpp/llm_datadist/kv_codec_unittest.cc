@@ -0,0 +1,240 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include "adxl/kv_codec.h"
+
+namespace adxl {
+namespace {
+constexpr size_t kHeadDim = 128U;
+
+// fp16 kv of normally distributed values with a few outlier channels, the tail of the last blocks is left zero
+// like the unused slots of a paged cache
+std::vector<uint8_t> MakeKv(size_t token_num, size_t padded_tokens, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::normal_distribution<float> dist(0.0F, 0.5F);
+  std::vector<float> channel_scale(kHeadDim, 1.0F);
+  for (size_t c = 0U; c < kHeadDim; c += 16U) {
+    channel_scale[c] = 8.0F;
+  }
+  std::vector<uint8_t> data((token_num + padded_tokens) * kHeadDim * sizeof(uint16_t), 0U);
+  for (size_t t = 0U; t < token_num; ++t) {
+    for (size_t c = 0U; c < kHeadDim; ++c) {
+      const uint16_t half = KvCodec::FloatToHalf(dist(gen) * channel_scale[c]);
+      (void)memcpy(&data[(t * kHeadDim + c) * sizeof(uint16_t)], &half, sizeof(half));
+    }
+  }
+  return data;
+}
+
+std::vector<float> ToFloats(const std::vector<uint8_t> &data) {
+  std::vector<float> values(data.size() / sizeof(uint16_t));
+  for (size_t i = 0U; i < values.size(); ++i) {
+    uint16_t half = 0U;
+    (void)memcpy(&half, &data[i * sizeof(uint16_t)], sizeof(half));
+    values[i] = KvCodec::HalfToFloat(half);
+  }
+  return values;
+}
+
+std::vector<uint8_t> RoundTrip(KvCodecType type, const std::vector<uint8_t> &src, size_t &encoded_len) {
+  std::vector<uint8_t> encoded(KvCodec::MaxEncodedSize(type, src.size()));
+  EXPECT_EQ(KvCodec::Encode(type, src.data(), src.size(), encoded.data(), encoded.size(), encoded_len), SUCCESS);
+  std::vector<uint8_t> decoded(src.size());
+  size_t decoded_len = 0U;
+  EXPECT_EQ(KvCodec::Decode(encoded.data(), encoded_len, decoded.data(), decoded.size(), decoded_len), SUCCESS);
+  EXPECT_EQ(decoded_len, src.size());
+  return decoded;
+}
+
+// largest scale of the groups, lossy error bounds are relative to it
+std::vector<float> GroupScales(const std::vector<float> &values, float max_code) {
+  std::vector<float> scales;
+  for (size_t start = 0U; start < values.size(); start += KvCodec::kScaleGroupSize) {
+    float abs_max = 0.0F;
+    for (size_t i = start; i < std::min(values.size(), start + KvCodec::kScaleGroupSize); ++i) {
+      abs_max = std::max(abs_max, std::fabs(values[i]));
+    }
+    scales.emplace_back(abs_max / max_code);
+  }
+  return scales;
+}
+}  // namespace
+
+class KvCodecTest : public ::testing::Test {};
+
+TEST_F(KvCodecTest, ParseType) {
+  KvCodecType type = KvCodecType::kNone;
+  EXPECT_EQ(KvCodec::ParseType("lossless", type), SUCCESS);
+  EXPECT_EQ(type, KvCodecType::kLossless);
+  EXPECT_EQ(KvCodec::ParseType("fp8", type), SUCCESS);
+  EXPECT_EQ(type, KvCodecType::kFp8);
+  EXPECT_EQ(KvCodec::ParseType("int8", type), SUCCESS);
+  EXPECT_EQ(type, KvCodecType::kInt8);
+  EXPECT_EQ(KvCodec::ParseType("none", type), SUCCESS);
+  EXPECT_EQ(type, KvCodecType::kNone);
+  EXPECT_EQ(KvCodec::ParseType("lz4", type), PARAM_INVALID);
+}
+
+TEST_F(KvCodecTest, HalfAndFp8Conversion) {
+  for (uint32_t bits = 0U; bits <= 0xFFFFU; ++bits) {
+    const auto half = static_cast<uint16_t>(bits);
+    const float value = KvCodec::HalfToFloat(half);
+    if (std::isnan(value)) {
+      EXPECT_TRUE(std::isnan(KvCodec::HalfToFloat(KvCodec::FloatToHalf(value))));
+    } else {
+      EXPECT_EQ(KvCodec::FloatToHalf(value), half);
+    }
+  }
+  // ties round to even
+  EXPECT_EQ(KvCodec::FloatToHalf(1.0F + 1.0F / 2048.0F), 0x3C00U);
+  EXPECT_EQ(KvCodec::FloatToHalf(65520.0F), 0x7C00U);
+  for (uint32_t code = 0U; code <= 0xFFU; ++code) {
+    if ((code & 0x7FU) == 0x7FU) {
+      continue;  // nan
+    }
+    EXPECT_EQ(KvCodec::FloatToFp8(KvCodec::Fp8ToFloat(static_cast<uint8_t>(code))), code);
+  }
+  EXPECT_EQ(KvCodec::Fp8ToFloat(0x7EU), 448.0F);
+  EXPECT_EQ(KvCodec::FloatToFp8(1000.0F), 0x7EU);
+  EXPECT_EQ(KvCodec::FloatToFp8(-1000.0F), 0xFEU);
+}
+
+TEST_F(KvCodecTest, LosslessRoundTrip) {
+  std::mt19937 gen(7U);
+  std::vector<std::vector<uint8_t>> inputs;
+  inputs.emplace_back();
+  inputs.emplace_back(1U, 0x5AU);
+  inputs.emplace_back(4097U, 0U);
+  std::vector<uint8_t> random_bytes(100003U);
+  for (auto &byte : random_bytes) {
+    byte = static_cast<uint8_t>(gen());
+  }
+  inputs.emplace_back(random_bytes);
+  std::vector<uint8_t> pattern(70001U);
+  for (size_t i = 0U; i < pattern.size(); ++i) {
+    pattern[i] = static_cast<uint8_t>((i % 300U) < 200U ? i % 7U : gen());
+  }
+  inputs.emplace_back(pattern);
+  inputs.emplace_back(MakeKv(1000U, 24U, 1U));
+  for (const auto &input : inputs) {
+    size_t encoded_len = 0U;
+    const auto decoded = RoundTrip(KvCodecType::kLossless, input, encoded_len);
+    EXPECT_EQ(decoded, input);
+    EXPECT_LE(encoded_len, KvCodec::MaxEncodedSize(KvCodecType::kLossless, input.size()));
+  }
+  size_t zero_len = 0U;
+  (void)RoundTrip(KvCodecType::kLossless, std::vector<uint8_t>(1U << 20U, 0U), zero_len);
+  EXPECT_LT(zero_len, (1U << 20U) / 100U);
+}
+
+TEST_F(KvCodecTest, Fp8ErrorBound) {
+  const auto src = MakeKv(2048U, 0U, 2U);
+  size_t encoded_len = 0U;
+  const auto decoded = RoundTrip(KvCodecType::kFp8, src, encoded_len);
+  EXPECT_LT(encoded_len * 3U, src.size() * 2U);
+  const auto expect = ToFloats(src);
+  const auto actual = ToFloats(decoded);
+  const auto scales = GroupScales(expect, 448.0F);
+  for (size_t i = 0U; i < expect.size(); ++i) {
+    const float scale = scales[i / KvCodec::kScaleGroupSize];
+    // 3 mantissa bits for normal codes, a step of 2^-9 below them, then the fp16 rounding of the result
+    const float bound = std::fabs(expect[i]) * (1.0F / 16.0F + 1.0F / 1024.0F) + scale / 1024.0F + 6e-8F;
+    ASSERT_LE(std::fabs(actual[i] - expect[i]), bound) << "index " << i;
+  }
+}
+
+TEST_F(KvCodecTest, Int8ErrorBound) {
+  const auto src = MakeKv(2048U, 0U, 3U);
+  size_t encoded_len = 0U;
+  const auto decoded = RoundTrip(KvCodecType::kInt8, src, encoded_len);
+  EXPECT_LT(encoded_len * 3U, src.size() * 2U);
+  const auto expect = ToFloats(src);
+  const auto actual = ToFloats(decoded);
+  const auto scales = GroupScales(expect, 127.0F);
+  double square_error = 0.0;
+  for (size_t i = 0U; i < expect.size(); ++i) {
+    const float scale = scales[i / KvCodec::kScaleGroupSize];
+    const float bound = scale * 0.5F * 1.0001F + std::fabs(expect[i]) / 1024.0F + 6e-8F;
+    ASSERT_LE(std::fabs(actual[i] - expect[i]), bound) << "index " << i;
+    square_error += static_cast<double>(actual[i] - expect[i]) * (actual[i] - expect[i]);
+  }
+  EXPECT_LT(std::sqrt(square_error / expect.size()), 0.05);
+}
+
+TEST_F(KvCodecTest, LossyKeepsZeroGroupsAndRejectsInvalidInput) {
+  const std::vector<uint8_t> zeros(KvCodec::kScaleGroupSize * 4U, 0U);
+  for (const auto type : {KvCodecType::kFp8, KvCodecType::kInt8}) {
+    size_t encoded_len = 0U;
+    EXPECT_EQ(RoundTrip(type, zeros, encoded_len), zeros);
+    std::vector<uint8_t> encoded(KvCodec::MaxEncodedSize(type, 64U));
+    std::vector<uint8_t> odd(63U, 1U);
+    EXPECT_EQ(KvCodec::Encode(type, odd.data(), odd.size(), encoded.data(), encoded.size(), encoded_len),
+              PARAM_INVALID);
+    std::vector<uint8_t> inf(64U, 0U);
+    const uint16_t inf_half = 0x7C00U;
+    (void)memcpy(&inf[10], &inf_half, sizeof(inf_half));
+    EXPECT_EQ(KvCodec::Encode(type, inf.data(), inf.size(), encoded.data(), encoded.size(), encoded_len),
+              PARAM_INVALID);
+  }
+}
+
+TEST_F(KvCodecTest, DecodeRejectsCorruptedInput) {
+  const auto src = MakeKv(64U, 0U, 4U);
+  for (const auto type : {KvCodecType::kLossless, KvCodecType::kFp8, KvCodecType::kInt8}) {
+    std::vector<uint8_t> encoded(KvCodec::MaxEncodedSize(type, src.size()));
+    size_t encoded_len = 0U;
+    ASSERT_EQ(KvCodec::Encode(type, src.data(), src.size(), encoded.data(), encoded.size(), encoded_len), SUCCESS);
+    std::vector<uint8_t> decoded(src.size());
+    size_t decoded_len = 0U;
+    EXPECT_EQ(KvCodec::Decode(encoded.data(), encoded_len - 1U, decoded.data(), decoded.size(), decoded_len),
+              PARAM_INVALID);
+    EXPECT_EQ(KvCodec::Decode(encoded.data(), encoded_len, decoded.data(), decoded.size() - 2U, decoded_len),
+              PARAM_INVALID);
+    encoded[0] ^= 0xFFU;
+    EXPECT_EQ(KvCodec::Decode(encoded.data(), encoded_len, decoded.data(), decoded.size(), decoded_len),
+              PARAM_INVALID);
+  }
+}
+
+TEST_F(KvCodecTest, CompressionRatio) {
+  // dense kv and a paged cache whose blocks are a quarter empty
+  const std::vector<std::vector<uint8_t>> inputs = {MakeKv(4096U, 0U, 5U), MakeKv(3072U, 1024U, 6U)};
+  for (const auto &src : inputs) {
+    for (const auto type : {KvCodecType::kLossless, KvCodecType::kFp8, KvCodecType::kInt8}) {
+      size_t encoded_len = 0U;
+      (void)RoundTrip(type, src, encoded_len);
+      EXPECT_LT(encoded_len, src.size());
+      if (KvCodec::IsLossy(type)) {
+        // one byte per fp16 element plus a float scale per group and the stream header
+        const size_t group_num = src.size() / sizeof(uint16_t) / KvCodec::kScaleGroupSize;
+        EXPECT_LE(encoded_len, src.size() / 2U + group_num * sizeof(float) + 64U);
+      }
+    }
+  }
+}
+
+TEST_F(KvCodecTest, LossyAndDecodableTypes) {
+  EXPECT_FALSE(KvCodec::IsLossy(KvCodecType::kNone));
+  EXPECT_FALSE(KvCodec::IsLossy(KvCodecType::kLossless));
+  EXPECT_TRUE(KvCodec::IsLossy(KvCodecType::kFp8));
+  EXPECT_TRUE(KvCodec::IsLossy(KvCodecType::kInt8));
+  const auto types = KvCodec::DecodableTypes();
+  EXPECT_EQ(std::count(types.cbegin(), types.cend(), KvCodecType::kNone), 0);
+  for (const auto type : {KvCodecType::kLossless, KvCodecType::kFp8, KvCodecType::kInt8}) {
+    EXPECT_EQ(std::count(types.cbegin(), types.cend(), type), 1);
+  }
+}
+}  // namespace adxl
@@ -0,0 +1,349 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "cache_mgr/kv_prefetcher.h"
+
+namespace llm {
+namespace {
+constexpr uint64_t kBlockSize = 256UL;
+constexpr uint64_t kClusterId = 1UL;
+
+CacheKey MakeKey(int64_t cache_id, uint64_t generation = 0UL) {
+  CacheKey cache_key{};
+  cache_key.prompt_cluster_id = kClusterId;
+  cache_key.prompt_cache_id = cache_id;
+  cache_key.req_id = 0UL;
+  cache_key.model_id = 0UL;
+  cache_key.prompt_cache_generation = generation;
+  return cache_key;
+}
+
+std::vector<uint64_t> MakeBlocks(uint64_t start, uint64_t num) {
+  std::vector<uint64_t> blocks;
+  for (uint64_t i = 0UL; i < num; ++i) {
+    blocks.emplace_back(start + i);
+  }
+  return blocks;
+}
+
+uint8_t RemoteByte(int64_t cache_id, uint64_t block_index, uint64_t offset) {
+  return static_cast<uint8_t>(static_cast<uint64_t>(cache_id) * 31UL + block_index * 7UL + offset);
+}
+
+// stands in for the remote prompt cache and the link to it, the prefetch area is plain host memory
+class StubTransfer {
+ public:
+  explicit StubTransfer(uint64_t slot_num) : area_(slot_num, std::vector<uint8_t>(kBlockSize, 0U)) {}
+
+  KvPrefetchPullFunc PullFunc() {
+    return [this](const CacheKey &cache_key, const std::vector<uint64_t> &remote_blocks,
+                  const std::vector<uint64_t> &slots) -> ge::Status {
+      if (delay_ms_ > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms_));
+      }
+      if (fail_) {
+        return ge::FAILED;
+      }
+      for (size_t i = 0U; i < slots.size(); ++i) {
+        Fetch(cache_key, remote_blocks[i], area_[slots[i]]);
+      }
+      prefetch_bytes_ += remote_blocks.size() * kBlockSize;
+      return ge::SUCCESS;
+    };
+  }
+
+  // serves one request the way DataCacheEngine does, hits are copied from the area and the rest pulled on demand
+  bool Serve(KvPrefetcher &prefetcher, const CacheKey &cache_key, const std::vector<uint64_t> &blocks,
+             size_t &hit_num) {
+    std::vector<KvPrefetchHit> hits;
+    prefetcher.Acquire(cache_key, blocks, hits);
+    std::vector<std::vector<uint8_t>> dst(blocks.size());
+    std::vector<bool> is_hit(blocks.size(), false);
+    for (const auto &hit : hits) {
+      dst[hit.index] = area_[hit.slot];
+      is_hit[hit.index] = true;
+    }
+    prefetcher.Release(hits);
+    for (size_t i = 0U; i < blocks.size(); ++i) {
+      if (!is_hit[i]) {
+        Fetch(cache_key, blocks[i], dst[i]);
+      }
+    }
+    prefetcher.Record(cache_key, blocks);
+    hit_num = hits.size();
+    for (size_t i = 0U; i < blocks.size(); ++i) {
+      for (uint64_t offset = 0UL; offset < kBlockSize; ++offset) {
+        if (dst[i][offset] != RemoteByte(cache_key.prompt_cache_id, blocks[i], offset)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void SetDelay(int32_t delay_ms) {
+    delay_ms_ = delay_ms;
+  }
+  void SetFail(bool fail) {
+    fail_ = fail;
+  }
+  uint64_t PrefetchBytes() const {
+    return prefetch_bytes_;
+  }
+
+ private:
+  static void Fetch(const CacheKey &cache_key, uint64_t block_index, std::vector<uint8_t> &block) {
+    block.resize(kBlockSize);
+    for (uint64_t offset = 0UL; offset < kBlockSize; ++offset) {
+      block[offset] = RemoteByte(cache_key.prompt_cache_id, block_index, offset);
+    }
+  }
+
+  std::vector<std::vector<uint8_t>> area_;
+  std::atomic<int32_t> delay_ms_{0};
+  std::atomic<bool> fail_{false};
+  std::atomic<uint64_t> prefetch_bytes_{0UL};
+};
+
+KvPrefetchOptions MakeOptions(uint64_t slot_num, uint64_t admission_blocks, uint32_t min_repeat) {
+  KvPrefetchOptions options{};
+  options.slot_num = slot_num;
+  options.admission_blocks = admission_blocks;
+  options.min_repeat = min_repeat;
+  return options;
+}
+}  // namespace
+
+class KvPrefetcherTest : public ::testing::Test {};
+
+TEST_F(KvPrefetcherTest, InvalidOptions) {
+  StubTransfer transfer(1U);
+  KvPrefetcher no_slot(MakeOptions(0U, 0U, 1U), transfer.PullFunc());
+  EXPECT_EQ(no_slot.Initialize(), ge::LLM_PARAM_INVALID);
+  KvPrefetcher no_repeat(MakeOptions(4U, 0U, 0U), transfer.PullFunc());
+  EXPECT_EQ(no_repeat.Initialize(), ge::LLM_PARAM_INVALID);
+  KvPrefetcher no_pull(MakeOptions(4U, 0U, 1U), nullptr);
+  EXPECT_EQ(no_pull.Initialize(), ge::LLM_PARAM_INVALID);
+}
+
+TEST_F(KvPrefetcherTest, RepeatedPrefixServedFromArea) {
+  StubTransfer transfer(16U);
+  KvPrefetcher prefetcher(MakeOptions(16U, 0U, 2U), transfer.PullFunc());
+  ASSERT_EQ(prefetcher.Initialize(), ge::SUCCESS);
+  const auto cache_key = MakeKey(3);
+  size_t hit_num = 0U;
+  // first turn is new, second one repeats the prefix and is kept for the third
+  ASSERT_TRUE(transfer.Serve(prefetcher, cache_key, MakeBlocks(0U, 4U), hit_num));
+  prefetcher.WaitIdle();
+  EXPECT_EQ(hit_num, 0U);
+  EXPECT_EQ(prefetcher.GetStats().prefetched_blocks, 0U);
+  ASSERT_TRUE(transfer.Serve(prefetcher, cache_key, MakeBlocks(0U, 6U), hit_num));
+  prefetcher.WaitIdle();
+  EXPECT_EQ(hit_num, 0U);
+  EXPECT_EQ(prefetcher.GetStats().prefetched_blocks, 4U);
+  ASSERT_TRUE(transfer.Serve(prefetcher, cache_key, MakeBlocks(0U, 8U), hit_num));
+  prefetcher.WaitIdle();
+  EXPECT_EQ(hit_num, 4U);
+  // blocks of another prompt cache with the same index are not hits
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(4), MakeBlocks(0U, 4U), hit_num));
+  EXPECT_EQ(hit_num, 0U);
+  const auto stats = prefetcher.GetStats();
+  EXPECT_EQ(stats.requested_blocks, 22U);
+  EXPECT_EQ(stats.hit_blocks, 4U);
+  EXPECT_EQ(stats.prefetched_blocks, 6U);
+  EXPECT_EQ(stats.unused_blocks, 2U);
+  EXPECT_EQ(stats.wasted_blocks, 0U);
+}
+
+TEST_F(KvPrefetcherTest, LookaheadOfKnownPrefix) {
+  StubTransfer transfer(16U);
+  // kept by history only, nothing is pulled again often enough to be kept for the next turn
+  auto options = MakeOptions(16U, 0U, 8U);
+  options.lookahead_blocks = 4U;
+  KvPrefetcher prefetcher(options, transfer.PullFunc());
+  ASSERT_EQ(prefetcher.Initialize(), ge::SUCCESS);
+  const auto cache_key = MakeKey(1);
+  size_t hit_num = 0U;
+  ASSERT_TRUE(transfer.Serve(prefetcher, cache_key, MakeBlocks(0U, 8U), hit_num));
+  prefetcher.WaitIdle();
+  // the prefix is pulled in pieces now, the first piece brings the blocks that followed it last time
+  ASSERT_TRUE(transfer.Serve(prefetcher, cache_key, MakeBlocks(0U, 2U), hit_num));
+  EXPECT_EQ(hit_num, 0U);
+  ASSERT_TRUE(transfer.Serve(prefetcher, cache_key, MakeBlocks(2U, 6U), hit_num));
+  EXPECT_EQ(hit_num, 4U);
+  prefetcher.WaitIdle();
+  EXPECT_EQ(prefetcher.GetStats().prefetched_blocks, 4U);
+}
+
+TEST_F(KvPrefetcherTest, WaitForBlocksInFlight) {
+  StubTransfer transfer(8U);
+  KvPrefetcher prefetcher(MakeOptions(8U, 0U, 1U), transfer.PullFunc());
+  ASSERT_EQ(prefetcher.Initialize(), ge::SUCCESS);
+  transfer.SetDelay(50);
+  const auto cache_key = MakeKey(1);
+  size_t hit_num = 0U;
+  ASSERT_TRUE(transfer.Serve(prefetcher, cache_key, MakeBlocks(0U, 8U), hit_num));
+  ASSERT_TRUE(transfer.Serve(prefetcher, cache_key, MakeBlocks(0U, 8U), hit_num));
+  EXPECT_EQ(hit_num, 8U);
+}
+
+TEST_F(KvPrefetcherTest, AdmissionBudgetBoundsUnusedBlocks) {
+  StubTransfer transfer(16U);
+  KvPrefetcher prefetcher(MakeOptions(16U, 4U, 1U), transfer.PullFunc());
+  ASSERT_EQ(prefetcher.Initialize(), ge::SUCCESS);
+  size_t hit_num = 0U;
+  for (int64_t cache_id = 0; cache_id < 4; ++cache_id) {
+    ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(cache_id), MakeBlocks(0U, 3U), hit_num));
+  }
+  prefetcher.WaitIdle();
+  auto stats = prefetcher.GetStats();
+  EXPECT_EQ(stats.prefetched_blocks, 4U);
+  EXPECT_EQ(stats.unused_blocks, 4U);
+  EXPECT_EQ(stats.dropped_blocks, 8U);
+  // using them frees the budget again
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0), MakeBlocks(0U, 3U), hit_num));
+  EXPECT_EQ(hit_num, 3U);
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(5), MakeBlocks(0U, 3U), hit_num));
+  prefetcher.WaitIdle();
+  stats = prefetcher.GetStats();
+  EXPECT_EQ(stats.prefetched_blocks, 7U);
+  EXPECT_EQ(stats.unused_blocks, 4U);
+}
+
+TEST_F(KvPrefetcherTest, EvictLeastRecentlyUsed) {
+  StubTransfer transfer(4U);
+  KvPrefetcher prefetcher(MakeOptions(4U, 3U, 1U), transfer.PullFunc());
+  ASSERT_EQ(prefetcher.Initialize(), ge::SUCCESS);
+  size_t hit_num = 0U;
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0), MakeBlocks(0U, 3U), hit_num));
+  prefetcher.WaitIdle();
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0), MakeBlocks(0U, 1U), hit_num));
+  EXPECT_EQ(hit_num, 1U);
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(1), MakeBlocks(0U, 1U), hit_num));
+  prefetcher.WaitIdle();
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(1), MakeBlocks(0U, 1U), hit_num));
+  EXPECT_EQ(hit_num, 1U);
+  // the area is full, block 1 of cache 0 is the least recently used and was never used
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(2), MakeBlocks(0U, 1U), hit_num));
+  prefetcher.WaitIdle();
+  auto stats = prefetcher.GetStats();
+  EXPECT_EQ(stats.wasted_blocks, 1U);
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0), MakeBlocks(1U, 2U), hit_num));
+  EXPECT_EQ(hit_num, 1U);
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(2), MakeBlocks(0U, 1U), hit_num));
+  EXPECT_EQ(hit_num, 1U);
+}
+
+TEST_F(KvPrefetcherTest, FailedPrefetchFallsBackToDemandPull) {
+  StubTransfer transfer(8U);
+  KvPrefetcher prefetcher(MakeOptions(8U, 0U, 1U), transfer.PullFunc());
+  ASSERT_EQ(prefetcher.Initialize(), ge::SUCCESS);
+  transfer.SetFail(true);
+  size_t hit_num = 0U;
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0), MakeBlocks(0U, 4U), hit_num));
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0), MakeBlocks(0U, 4U), hit_num));
+  EXPECT_EQ(hit_num, 0U);
+  prefetcher.WaitIdle();
+  auto stats = prefetcher.GetStats();
+  EXPECT_EQ(stats.failed_blocks, 8U);
+  EXPECT_EQ(stats.unused_blocks, 0U);
+  transfer.SetFail(false);
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0), MakeBlocks(0U, 4U), hit_num));
+  prefetcher.WaitIdle();
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0), MakeBlocks(0U, 4U), hit_num));
+  EXPECT_EQ(hit_num, 4U);
+}
+
+TEST_F(KvPrefetcherTest, NoHitsWithoutGeneration) {
+  StubTransfer transfer(8U);
+  KvPrefetcher prefetcher(MakeOptions(8U, 0U, 1U), transfer.PullFunc());
+  ASSERT_EQ(prefetcher.Initialize(), ge::SUCCESS);
+  const auto cache_key = MakeKey(0, KvPrefetcher::kNoGeneration);
+  size_t hit_num = 0U;
+  for (int32_t turn = 0; turn < 3; ++turn) {
+    ASSERT_TRUE(transfer.Serve(prefetcher, cache_key, MakeBlocks(0U, 4U), hit_num));
+    prefetcher.WaitIdle();
+    EXPECT_EQ(hit_num, 0U);
+  }
+  EXPECT_EQ(prefetcher.GetStats().prefetched_blocks, 0U);
+}
+
+TEST_F(KvPrefetcherTest, NewGenerationDropsBlocks) {
+  StubTransfer transfer(8U);
+  KvPrefetcher prefetcher(MakeOptions(8U, 0U, 1U), transfer.PullFunc());
+  ASSERT_EQ(prefetcher.Initialize(), ge::SUCCESS);
+  size_t hit_num = 0U;
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0, 1UL), MakeBlocks(0U, 4U), hit_num));
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(1, 1UL), MakeBlocks(0U, 2U), hit_num));
+  prefetcher.WaitIdle();
+  // the prompt side rewrote cache 0, its prefetched blocks and history are gone, cache 1 is kept
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0, 2UL), MakeBlocks(0U, 4U), hit_num));
+  EXPECT_EQ(hit_num, 0U);
+  prefetcher.WaitIdle();
+  auto stats = prefetcher.GetStats();
+  EXPECT_EQ(stats.invalidated_blocks, 4U);
+  EXPECT_EQ(stats.wasted_blocks, 4U);
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(1, 1UL), MakeBlocks(0U, 2U), hit_num));
+  EXPECT_EQ(hit_num, 2U);
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0, 2UL), MakeBlocks(0U, 4U), hit_num));
+  EXPECT_EQ(hit_num, 4U);
+  // blocks still in flight when the generation changes are dropped once they land
+  transfer.SetDelay(50);
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0, 2UL), MakeBlocks(4U, 2U), hit_num));
+  ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(0, 3UL), MakeBlocks(4U, 2U), hit_num));
+  EXPECT_EQ(hit_num, 0U);
+  prefetcher.WaitIdle();
+  stats = prefetcher.GetStats();
+  EXPECT_EQ(stats.invalidated_blocks, 10U);
+  EXPECT_EQ(stats.unused_blocks, 2U);
+}
+
+// multi-turn conversations interleaved on one decode node, every turn pulls the whole context again
+TEST_F(KvPrefetcherTest, ReplayConversationTraces) {
+  constexpr int64_t kConversationNum = 16;
+  constexpr uint64_t kTurnNum = 8U;
+  constexpr uint64_t kFirstTurnBlocks = 8U;
+  constexpr uint64_t kBlocksPerTurn = 4U;
+  constexpr uint64_t kSlotNum = 512U;
+  for (const uint32_t min_repeat : {1U, 2U}) {
+    StubTransfer transfer(kSlotNum);
+    KvPrefetcher prefetcher(MakeOptions(kSlotNum, kSlotNum / 2U, min_repeat), transfer.PullFunc());
+    ASSERT_EQ(prefetcher.Initialize(), ge::SUCCESS);
+    std::mt19937 rng(1234U);
+    std::vector<int64_t> order(kConversationNum);
+    for (int64_t i = 0; i < kConversationNum; ++i) {
+      order[i] = i;
+    }
+    for (uint64_t turn = 0U; turn < kTurnNum; ++turn) {
+      std::shuffle(order.begin(), order.end(), rng);
+      for (const auto conversation : order) {
+        size_t hit_num = 0U;
+        ASSERT_TRUE(transfer.Serve(prefetcher, MakeKey(conversation),
+                                   MakeBlocks(0U, kFirstTurnBlocks + turn * kBlocksPerTurn), hit_num));
+      }
+    }
+    prefetcher.WaitIdle();
+    const auto stats = prefetcher.GetStats();
+    const double hit_rate = static_cast<double>(stats.hit_blocks) / static_cast<double>(stats.requested_blocks);
+    const uint64_t wasted_bytes = (stats.wasted_blocks + stats.unused_blocks) * kBlockSize;
+    EXPECT_EQ(stats.prefetched_blocks * kBlockSize, transfer.PrefetchBytes());
+    EXPECT_LE(stats.unused_blocks, kSlotNum / 2U);
+    EXPECT_GT(hit_rate, 0.5);
+    EXPECT_LT(wasted_bytes, transfer.PrefetchBytes() / 2U);
+  }
+}
+}  // namespace llm
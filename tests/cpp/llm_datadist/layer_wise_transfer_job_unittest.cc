@@ -0,0 +1,236 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <numeric>
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <gtest/gtest.h>
+#include "data_transfer/layer_wise_transfer_job.h"
+#include "depends/llm_datadist/src/data_cache_engine_test_helper.h"
+#include "depends/ascendcl/src/ascendcl_stub.h"
+
+namespace llm {
+namespace {
+constexpr uint64_t kLayerNum = 16U;
+constexpr uint64_t kTensorNum = kLayerNum * kDefaultTensorNumPerLayer;
+
+// simulate a serial link: every recorded event completes one layer cost after the previous one
+class LayerLatencyRuntimeMock : public llm::AclRuntimeStub {
+ public:
+  explicit LayerLatencyRuntimeMock(std::chrono::microseconds layer_cost) : layer_cost_(layer_cost) {}
+
+  aclError aclrtRecordEvent(aclrtEvent event, aclrtStream stream) override {
+    (void)stream;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    busy_until_ = std::max(busy_until_, now) + layer_cost_;
+    complete_time_[event] = busy_until_;
+    return ACL_ERROR_NONE;
+  }
+
+  aclError aclrtQueryEventStatus(aclrtEvent event, aclrtEventRecordedStatus *status) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = complete_time_.find(event);
+    const bool completed = (it == complete_time_.end()) || (std::chrono::steady_clock::now() >= it->second);
+    *status = completed ? ACL_EVENT_RECORDED_STATUS_COMPLETE : ACL_EVENT_RECORDED_STATUS_NOT_READY;
+    return ACL_ERROR_NONE;
+  }
+
+  aclError aclrtDestroyEvent(aclrtEvent event) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      complete_time_.erase(event);
+    }
+    return AclRuntimeStub::aclrtDestroyEvent(event);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::chrono::microseconds layer_cost_;
+  std::chrono::steady_clock::time_point busy_until_{};
+  std::map<aclrtEvent, std::chrono::steady_clock::time_point> complete_time_;
+};
+
+CacheDesc MakeCacheDesc() {
+  CacheDesc cache_desc{};
+  cache_desc.num_tensors = kTensorNum;
+  cache_desc.shape = {4, 128};
+  cache_desc.data_type = ge::DT_INT32;
+  cache_desc.placement = 1;
+  return cache_desc;
+}
+
+void FillSrcCache(const Cache &src_cache) {
+  for (const auto tensor_addr : src_cache.per_device_tensor_addrs[0]) {
+    auto start = reinterpret_cast<int32_t *>(tensor_addr);
+    std::iota(start, start + 4 * 128, 1);
+  }
+}
+
+TransferCacheConfig MakeAllLayersConfig(const Cache &src_cache, const Cache &dst_cache) {
+  TransferCacheConfig transfer_cache_config{};
+  transfer_cache_config.src_cache_id = src_cache.cache_id;
+  transfer_cache_config.layer_index = 0U;
+  transfer_cache_config.dst_addrs = dst_cache.per_device_tensor_addrs[0];
+  return transfer_cache_config;
+}
+}  // namespace
+
+class LayerWiseTransferJobTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    llm::MockMmpaForHcclApi::Install();
+    llm::AclRuntimeStub::SetInstance(std::make_shared<DataCacheEngineRuntimeMock>());
+    llm::HcclAdapter::GetInstance().Initialize();
+  }
+  void TearDown() override {
+    llm::AclRuntimeStub::Reset();
+    llm::HcclAdapter::GetInstance().Finalize();
+    llm::MockMmpaForHcclApi::Reset();
+  }
+};
+
+TEST_F(LayerWiseTransferJobTest, TransferCacheByLayers_CallbackInLayerOrder) {
+  PullCacheParam pull_cache_param{};
+  DataCacheEngineTestRunner test_runner;
+  test_runner.Initialize(MakeCacheDesc(), MakeCacheDesc(), pull_cache_param);
+  FillSrcCache(test_runner.GetSrcCache());
+  const auto &dst_cache = test_runner.GetDstCache();
+  auto transfer_cache_config = MakeAllLayersConfig(test_runner.GetSrcCache(), dst_cache);
+  TransferBlockConfig transfer_block_config{};
+
+  std::vector<uint64_t> ready_layers;
+  std::vector<bool> data_ready_in_callback;
+  auto callback = [&ready_layers, &data_ready_in_callback, &dst_cache](uint64_t layer_index) {
+    ready_layers.emplace_back(layer_index);
+    const auto *data = reinterpret_cast<const int32_t *>(
+        dst_cache.per_device_tensor_addrs[0][layer_index * kDefaultTensorNumPerLayer]);
+    data_ready_in_callback.emplace_back(data[0] == 1);
+  };
+  auto &cache_engine = test_runner.GetSrcTestContext().CacheEngine();
+  std::shared_ptr<LayerTransferProgress> progress;
+  ASSERT_EQ(cache_engine.TransferCacheByLayers(0U, transfer_cache_config, transfer_block_config, kLayerNum, callback,
+                                               progress),
+            ge::SUCCESS);
+  ASSERT_NE(progress, nullptr);
+  ASSERT_EQ(progress->Wait(), ge::SUCCESS);
+  EXPECT_TRUE(progress->IsFinished());
+  EXPECT_EQ(progress->GetReadyLayerNum(), kLayerNum);
+
+  std::vector<uint64_t> expect_layers(kLayerNum);
+  std::iota(expect_layers.begin(), expect_layers.end(), 0U);
+  EXPECT_EQ(ready_layers, expect_layers);
+  EXPECT_EQ(data_ready_in_callback, std::vector<bool>(kLayerNum, true));
+  std::vector<int32_t> last_tensor(4);
+  test_runner.GetCacheData(last_tensor, kTensorNum - 1U);
+  EXPECT_EQ(last_tensor, (std::vector<int32_t>{1, 2, 3, 4}));
+}
+
+// the caller gets back control at once and sees the first layer while the worker still holds the rest
+TEST_F(LayerWiseTransferJobTest, TransferCacheByLayers_PollWhileTransferring) {
+  PullCacheParam pull_cache_param{};
+  DataCacheEngineTestRunner test_runner;
+  test_runner.Initialize(MakeCacheDesc(), MakeCacheDesc(), pull_cache_param);
+  auto transfer_cache_config = MakeAllLayersConfig(test_runner.GetSrcCache(), test_runner.GetDstCache());
+  TransferBlockConfig transfer_block_config{};
+
+  const auto caller_id = std::this_thread::get_id();
+  std::promise<void> release;
+  const auto released = release.get_future().share();
+  std::vector<std::thread::id> callback_threads;
+  auto callback = [&callback_threads, released](uint64_t layer_index) {
+    callback_threads.emplace_back(std::this_thread::get_id());
+    if (layer_index == 0U) {
+      released.wait();
+    }
+  };
+  auto &cache_engine = test_runner.GetSrcTestContext().CacheEngine();
+  std::shared_ptr<LayerTransferProgress> progress;
+  ASSERT_EQ(cache_engine.TransferCacheByLayers(0U, transfer_cache_config, transfer_block_config, kLayerNum, callback,
+                                               progress),
+            ge::SUCCESS);
+  while (!progress->IsLayerReady(0U)) {
+    std::this_thread::yield();
+  }
+  EXPECT_FALSE(progress->IsLayerReady(1U));
+  EXPECT_FALSE(progress->IsFinished());
+  release.set_value();
+  ASSERT_EQ(progress->Wait(), ge::SUCCESS);
+  EXPECT_EQ(progress->GetReadyLayerNum(), kLayerNum);
+  ASSERT_EQ(callback_threads.size(), kLayerNum);
+  for (const auto &thread_id : callback_threads) {
+    EXPECT_NE(thread_id, caller_id);
+  }
+}
+
+TEST_F(LayerWiseTransferJobTest, TransferCacheByLayers_EarlyLayerAvailable) {
+  llm::AclRuntimeStub::SetInstance(std::make_shared<LayerLatencyRuntimeMock>(std::chrono::milliseconds(2)));
+  PullCacheParam pull_cache_param{};
+  DataCacheEngineTestRunner test_runner;
+  test_runner.Initialize(MakeCacheDesc(), MakeCacheDesc(), pull_cache_param);
+  auto transfer_cache_config = MakeAllLayersConfig(test_runner.GetSrcCache(), test_runner.GetDstCache());
+  TransferBlockConfig transfer_block_config{};
+
+  auto &src_context = test_runner.GetSrcTestContext();
+  CacheEntry cache_entry;
+  ASSERT_TRUE(src_context.CacheEngine().cache_manager_->GetCacheEntry(transfer_cache_config.src_cache_id,
+                                                                      cache_entry));
+  aclrtStream stream = nullptr;
+  ASSERT_EQ(aclrtCreateStream(&stream), ACL_ERROR_NONE);
+  LayerWiseTransferJob job(src_context.GetCommEntry(), stream);
+  LayerTransferProgress progress(kLayerNum);
+
+  std::vector<uint64_t> ready_num_in_callback;
+  std::vector<bool> last_layer_ready_in_callback;
+  auto callback = [&progress, &ready_num_in_callback, &last_layer_ready_in_callback](uint64_t layer_index) {
+    EXPECT_TRUE(progress.IsLayerReady(layer_index));
+    ready_num_in_callback.emplace_back(progress.GetReadyLayerNum());
+    last_layer_ready_in_callback.emplace_back(progress.IsLayerReady(kLayerNum - 1U));
+  };
+  ASSERT_EQ(job.TransferCacheByLayers(cache_entry, transfer_cache_config, transfer_block_config, 2000, false,
+                                      progress, callback),
+            ge::SUCCESS);
+  ASSERT_EQ(ready_num_in_callback.size(), kLayerNum);
+  for (uint64_t i = 0U; i < kLayerNum; ++i) {
+    EXPECT_EQ(ready_num_in_callback[i], i + 1U);
+    EXPECT_EQ(last_layer_ready_in_callback[i], i == kLayerNum - 1U);
+  }
+  EXPECT_EQ(progress.GetReadyLayerNum(), kLayerNum);
+  EXPECT_FALSE(progress.IsLayerReady(kLayerNum));
+  (void)aclrtDestroyStream(stream);
+}
+
+TEST_F(LayerWiseTransferJobTest, TransferCacheByLayers_DstAddrsNotMatch) {
+  PullCacheParam pull_cache_param{};
+  DataCacheEngineTestRunner test_runner;
+  test_runner.Initialize(MakeCacheDesc(), MakeCacheDesc(), pull_cache_param);
+  auto transfer_cache_config = MakeAllLayersConfig(test_runner.GetSrcCache(), test_runner.GetDstCache());
+  transfer_cache_config.dst_addrs.pop_back();
+  TransferBlockConfig transfer_block_config{};
+  auto &cache_engine = test_runner.GetSrcTestContext().CacheEngine();
+  std::shared_ptr<LayerTransferProgress> progress;
+  ASSERT_EQ(cache_engine.TransferCacheByLayers(0U, transfer_cache_config, transfer_block_config, kLayerNum, nullptr,
+                                               progress),
+            ge::SUCCESS);
+  EXPECT_EQ(progress->Wait(), ge::LLM_PARAM_INVALID);
+  EXPECT_EQ(progress->GetReadyLayerNum(), 0U);
+  transfer_cache_config.dst_addrs.clear();
+  std::shared_ptr<LayerTransferProgress> empty_progress;
+  EXPECT_EQ(cache_engine.TransferCacheByLayers(0U, transfer_cache_config, transfer_block_config, 0U, nullptr,
+                                               empty_progress),
+            ge::LLM_PARAM_INVALID);
+  EXPECT_EQ(empty_progress, nullptr);
+}
+}  // namespace llm
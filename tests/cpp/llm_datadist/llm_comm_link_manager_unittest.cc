@@ -9,6 +9,9 @@
  */
 
 #include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <gtest/gtest.h>
 
 #include "llm_datadist_v2.h"
@@ -175,6 +178,162 @@ class MockMmpaLongTimeRegister : public MmpaStubApiGe {
     return 0;
   }
 };
+constexpr int64_t kCommInitDelayMs = 2;
+std::atomic<int32_t> g_comm_init_running{0};
+std::atomic<int32_t> g_comm_init_max_running{0};
+std::atomic<int32_t> g_comm_init_entered{0};
+std::atomic<int32_t> g_comm_init_first_wave{1};
+
+// the first g_comm_init_first_wave inits wait for each other, so the in flight count reaches the gate width when the
+// gate lets them through together, every init then takes kCommInitDelayMs
+HcclResult HcclCommInitClusterInfoMemConfigDelayed(const char *cluster, uint32_t rank, HcclCommConfig *config,
+                                                   HcclComm *comm) {
+  const int32_t running = ++g_comm_init_running;
+  int32_t max_running = g_comm_init_max_running.load();
+  while ((running > max_running) && !g_comm_init_max_running.compare_exchange_weak(max_running, running)) {
+  }
+  ++g_comm_init_entered;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while ((g_comm_init_entered.load() < g_comm_init_first_wave.load()) &&
+         (std::chrono::steady_clock::now() < deadline)) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(kCommInitDelayMs));
+  --g_comm_init_running;
+  return HcclCommInitClusterInfoMemConfig(cluster, rank, config, comm);
+}
+
+class MockMmpaDelayedCommInit : public MmpaStubApiGe {
+ public:
+  void *DlOpen(const char *file_name, int32_t mode) override {
+    return reinterpret_cast<void *>(mock_handle);
+  }
+
+  void *DlSym(void *handle, const char *func_name) override {
+    static const std::map<std::string, void*> func_map = {
+        {"HcclCommInitClusterInfoMemConfig", reinterpret_cast<void*>(&HcclCommInitClusterInfoMemConfigDelayed)},
+        {"HcclExchangeMemDesc",              reinterpret_cast<void*>(&HcclExchangeMemDesc1)},
+        {"HcclCommDestroy",                  reinterpret_cast<void*>(&HcclCommDestroy)},
+        {"HcclBatchPut",                     reinterpret_cast<void*>(&HcclBatchPut)},
+        {"HcclBatchGet",                     reinterpret_cast<void*>(&HcclBatchGet1)},
+        {"HcclRemapRegistedMemory",          reinterpret_cast<void*>(&HcclRemapRegistedMemory)},
+        {"HcclRegisterGlobalMem",            reinterpret_cast<void*>(&HcclRegisterGlobalMem)},
+        {"HcclDeregisterGlobalMem",          reinterpret_cast<void*>(&HcclDeregisterGlobalMem)},
+        {"HcclCommBindMem",                  reinterpret_cast<void*>(&HcclCommBindMem)},
+        {"HcclCommUnbindMem",                reinterpret_cast<void*>(&HcclCommUnbindMem)},
+        {"HcclCommPrepare",                  reinterpret_cast<void*>(&HcclCommPrepare)},
+    };
+    auto it = func_map.find(func_name);
+    if (it != func_map.end()) {
+      return it->second;
+    }
+    return nullptr;
+  }
+
+  int32_t DlClose(void *handle) override {
+    return 0;
+  }
+};
+
+constexpr int64_t kExchangeDelayMs = 20;
+std::atomic<int32_t> g_exchange_running{0};
+std::atomic<int32_t> g_exchange_max_running{0};
+std::atomic<int32_t> g_bind_num{0};
+std::atomic<uint32_t> g_fail_exchange_rank{UINT32_MAX};
+
+// waits kExchangeDelayMs for the remote side, counted in g_exchange_running
+void WaitRemote() {
+  const int32_t running = ++g_exchange_running;
+  int32_t max_running = g_exchange_max_running.load();
+  while ((running > max_running) && !g_exchange_max_running.compare_exchange_weak(max_running, running)) {
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(kExchangeDelayMs));
+  --g_exchange_running;
+}
+
+// every exchange waits for its peer, the exchange with g_fail_exchange_rank times out
+HcclResult HcclExchangeMemDescDelayed(HcclComm comm, uint32_t remoteRank, HcclMemDescs *local, int timeout,
+                                      HcclMemDescs *remote, uint32_t *actualNum) {
+  WaitRemote();
+  if (remoteRank == g_fail_exchange_rank.load()) {
+    return HcclResult::HCCL_E_TIMEOUT;
+  }
+  return HcclExchangeMemDesc1(comm, remoteRank, local, timeout, remote, actualNum);
+}
+
+// the comm prepare waits for the peers as well
+HcclResult HcclCommPrepareDelayed(HcclComm comm, HcclPrepareConfig *prepareConfig, int32_t timeout) {
+  WaitRemote();
+  return HcclCommPrepare(comm, prepareConfig, timeout);
+}
+
+HcclResult HcclCommBindMemCounted(HcclComm comm, void *memHandle) {
+  ++g_bind_num;
+  return HcclCommBindMem(comm, memHandle);
+}
+
+class MockMmpaDelayedExchange : public MmpaStubApiGe {
+ public:
+  void *DlOpen(const char *file_name, int32_t mode) override {
+    return reinterpret_cast<void *>(mock_handle);
+  }
+
+  void *DlSym(void *handle, const char *func_name) override {
+    static const std::map<std::string, void*> func_map = {
+        {"HcclCommInitClusterInfoMemConfig", reinterpret_cast<void*>(&HcclCommInitClusterInfoMemConfig)},
+        {"HcclExchangeMemDesc",              reinterpret_cast<void*>(&HcclExchangeMemDescDelayed)},
+        {"HcclCommDestroy",                  reinterpret_cast<void*>(&HcclCommDestroy)},
+        {"HcclBatchPut",                     reinterpret_cast<void*>(&HcclBatchPut)},
+        {"HcclBatchGet",                     reinterpret_cast<void*>(&HcclBatchGet1)},
+        {"HcclRemapRegistedMemory",          reinterpret_cast<void*>(&HcclRemapRegistedMemory)},
+        {"HcclRegisterGlobalMem",            reinterpret_cast<void*>(&HcclRegisterGlobalMem)},
+        {"HcclDeregisterGlobalMem",          reinterpret_cast<void*>(&HcclDeregisterGlobalMem)},
+        {"HcclCommBindMem",                  reinterpret_cast<void*>(&HcclCommBindMemCounted)},
+        {"HcclCommUnbindMem",                reinterpret_cast<void*>(&HcclCommUnbindMem)},
+        {"HcclCommPrepare",                  reinterpret_cast<void*>(&HcclCommPrepareDelayed)},
+    };
+    auto it = func_map.find(func_name);
+    if (it != func_map.end()) {
+      return it->second;
+    }
+    return nullptr;
+  }
+
+  int32_t DlClose(void *handle) override {
+    return 0;
+  }
+};
+
+// registers one cache of tensor_num tensors, each tensor is a registered mem handle
+void RegisterTensors(LLMDataDistV2 &llm_datadist, uint32_t tensor_num) {
+  CacheDesc cache_desc{};
+  cache_desc.num_tensors = tensor_num;
+  cache_desc.data_type = ge::DT_FLOAT;
+  cache_desc.shape = {2, 3};
+  cache_desc.placement = 1U;
+  Cache cache{};
+  std::vector<uint64_t> addrs;
+  for (uint32_t i = 0U; i < tensor_num; ++i) {
+    addrs.emplace_back(0x8001U + i * 0x1000U);
+  }
+  (void)cache.per_device_tensor_addrs.emplace_back(addrs);
+  CacheKey cache_key{};
+  cache_key.is_allocate_blocks = true;
+  cache_key.model_id = 0;
+  cache_key.req_id = UINT64_MAX;
+  EXPECT_EQ(llm_datadist.RegisterCache(cache_desc, cache, {cache_key}), ge::SUCCESS);
+}
+
+RegisterMemoryStatus WaitPrepared(LLMDataDistV2 &llm_datadist, uint64_t comm_id) {
+  RegisterMemoryStatus status = RegisterMemoryStatus::PREPARING;
+  for (int32_t retry = 0; (retry < 2000) && (status == RegisterMemoryStatus::PREPARING); ++retry) {
+    EXPECT_EQ(llm_datadist.QueryRegisterMemStatus(comm_id, status), ge::SUCCESS);
+    if (status == RegisterMemoryStatus::PREPARING) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  }
+  return status;
+}
 }  // namespace
 class LLMCommLinkManagerUTest : public ::testing::Test {
  protected:
@@ -425,4 +584,123 @@ TEST_F(LLMCommLinkManagerUTest, RemapRegisteredMemorySuc) {
   EXPECT_EQ(llm_datadist.RemapRegisteredMemory({mem_info}), ge::SUCCESS);
   llm_datadist.LLMDataDistFinalize();
 }
+TEST_F(LLMCommLinkManagerUTest, ConcurrentLinkInitGate) {
+  MmpaStub::GetInstance().SetImpl(std::make_shared<MockMmpaDelayedCommInit>());
+  constexpr int32_t kClusterNum = 16;
+  // no option takes the default gate width, the option sets it and 1 makes comm init serial
+  for (const char *concurrency : {"", "1", "16"}) {
+    const int32_t gate_width = (std::string(concurrency).empty()) ? static_cast<int32_t>(kDefaultCommInitConcurrency)
+                                                                  : std::stoi(concurrency);
+    g_comm_init_max_running = 0;
+    g_comm_init_entered = 0;
+    g_comm_init_first_wave = gate_width;
+    LLMDataDistV2 llm_datadist(1U);
+    std::map<ge::AscendString, ge::AscendString> options{};
+    options["llm.Role"] = "Decoder";
+    if (!std::string(concurrency).empty()) {
+      options["llm.LinkConcurrency"] = concurrency;
+    }
+    ASSERT_EQ(llm_datadist.LLMDataDistInitialize(options), ge::SUCCESS);
+
+    std::vector<ge::Status> rets(kClusterNum, ge::FAILED);
+    std::vector<uint64_t> comm_ids(kClusterNum, 0UL);
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < kClusterNum; ++i) {
+      threads.emplace_back([&, i]() {
+        std::map<uint64_t, uint32_t> cluster2rank{{1, 0}, {100 + i, 1}};
+        std::string rank_table;
+        std::string cluster_name = "link_" + std::to_string(i);
+        rets[i] = llm_datadist.Link(cluster_name, cluster2rank, rank_table, comm_ids[i]);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (int32_t i = 0; i < kClusterNum; ++i) {
+      EXPECT_EQ(rets[i], ge::SUCCESS);
+    }
+    EXPECT_EQ(g_comm_init_entered.load(), kClusterNum);
+    EXPECT_EQ(g_comm_init_max_running.load(), gate_width);
+    for (int32_t i = 0; i < kClusterNum; ++i) {
+      RegisterMemoryStatus status = RegisterMemoryStatus::PREPARING;
+      for (int32_t retry = 0; (retry < 100) && (status == RegisterMemoryStatus::PREPARING); ++retry) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        EXPECT_EQ(llm_datadist.QueryRegisterMemStatus(comm_ids[i], status), ge::SUCCESS);
+      }
+      EXPECT_EQ(status, RegisterMemoryStatus::OK);
+    }
+    llm_datadist.LLMDataDistFinalize();
+  }
+}
+
+TEST_F(LLMCommLinkManagerUTest, InvalidLinkConcurrency) {
+  MmpaStub::GetInstance().SetImpl(std::make_shared<MockMmpa>());
+  for (const char *value : {"0", "65", "abc"}) {
+    LLMDataDistV2 llm_datadist(1U);
+    std::map<ge::AscendString, ge::AscendString> options{};
+    options["llm.Role"] = "Decoder";
+    options["llm.LinkConcurrency"] = value;
+    EXPECT_NE(llm_datadist.LLMDataDistInitialize(options), ge::SUCCESS);
+  }
+}
+
+TEST_F(LLMCommLinkManagerUTest, PrepareMemScaling) {
+  MmpaStub::GetInstance().SetImpl(std::make_shared<MockMmpaDelayedExchange>());
+  for (uint32_t handle_num : {1U, 64U, 256U}) {
+    // a single peer is the two rank link
+    for (uint64_t peer_num : {1UL, 4UL, 8UL}) {
+      g_exchange_max_running = 0;
+      g_bind_num = 0;
+      LLMDataDistV2 llm_datadist(1U);
+      std::map<ge::AscendString, ge::AscendString> options{};
+      options["llm.Role"] = "Decoder";
+      ASSERT_EQ(llm_datadist.LLMDataDistInitialize(options), ge::SUCCESS);
+      RegisterTensors(llm_datadist, handle_num);
+
+      std::map<uint64_t, uint32_t> cluster2rank{{1, 0}};
+      for (uint64_t i = 0UL; i < peer_num; ++i) {
+        cluster2rank[100UL + i] = static_cast<uint32_t>(i + 1UL);
+      }
+      std::string rank_table;
+      uint64_t comm_id;
+      std::string cluster_name = "link";
+      ASSERT_EQ(llm_datadist.Link(cluster_name, cluster2rank, rank_table, comm_id), ge::SUCCESS);
+      EXPECT_EQ(WaitPrepared(llm_datadist, comm_id), RegisterMemoryStatus::OK);
+      // every handle is bound once per comm whatever the peer num, besides a few buffers of the engine
+      EXPECT_GE(g_bind_num.load(), static_cast<int32_t>(handle_num));
+      EXPECT_LE(g_bind_num.load(), static_cast<int32_t>(handle_num) + 8);
+      // the exchanges with all peers and the comm prepare overlap instead of running one after another
+      EXPECT_EQ(g_exchange_max_running.load(), static_cast<int32_t>(peer_num) + 1);
+      EXPECT_EQ(llm_datadist.Unlink(comm_id), ge::SUCCESS);
+      llm_datadist.LLMDataDistFinalize();
+    }
+  }
+}
+
+TEST_F(LLMCommLinkManagerUTest, PrepareMemFailedWhenOnePeerFailed) {
+  MmpaStub::GetInstance().SetImpl(std::make_shared<MockMmpaDelayedExchange>());
+  g_fail_exchange_rank = 2U;
+  LLMDataDistV2 llm_datadist(1U);
+  std::map<ge::AscendString, ge::AscendString> options{};
+  options["llm.Role"] = "Decoder";
+  ASSERT_EQ(llm_datadist.LLMDataDistInitialize(options), ge::SUCCESS);
+  RegisterTensors(llm_datadist, 4U);
+
+  std::map<uint64_t, uint32_t> cluster2rank{{1, 0}, {2, 1}, {3, 2}, {4, 3}};
+  std::string rank_table;
+  uint64_t comm_id;
+  std::string cluster_name = "link";
+  ASSERT_EQ(llm_datadist.Link(cluster_name, cluster2rank, rank_table, comm_id), ge::SUCCESS);
+  EXPECT_EQ(WaitPrepared(llm_datadist, comm_id), RegisterMemoryStatus::FAILED);
+  EXPECT_EQ(llm_datadist.Unlink(comm_id), ge::SUCCESS);
+  g_fail_exchange_rank = UINT32_MAX;
+
+  // unlink while the exchanges are still running
+  uint64_t comm_id2;
+  std::string cluster_name2 = "link2";
+  ASSERT_EQ(llm_datadist.Link(cluster_name2, cluster2rank, rank_table, comm_id2), ge::SUCCESS);
+  std::this_thread::sleep_for(std::chrono::milliseconds(kExchangeDelayMs / 2));
+  EXPECT_EQ(llm_datadist.Unlink(comm_id2), ge::SUCCESS);
+  llm_datadist.LLMDataDistFinalize();
+}
 }  // namespace llm
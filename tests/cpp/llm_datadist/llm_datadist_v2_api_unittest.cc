@@ -8,7 +8,9 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <vector>
 #include <cstdlib>
 #include <gtest/gtest.h>
@@ -939,4 +941,137 @@ TEST_F(LlmDataDistUTest, TestPullWithRangeAndTensorNumV2) {
   llm_datadist_p.Finalize();
   llm_datadist_d.Finalize();
 }
+
+TEST_F(LlmDataDistUTest, PullKvBlocksServedFromPrefetchAreaUntilGenerationChanges) {
+  uint64_t prompt_cluster_id = 0U;
+  uint64_t decoder_cluster_id = 1U;
+  LlmDataDist llm_datadist_p(prompt_cluster_id, LlmRole::kPrompt);
+  std::map<AscendString, AscendString> options_p;
+  options_p[llm_datadist::OPTION_LISTEN_IP_INFO] = "127.0.0.1:26000";
+  options_p[llm_datadist::OPTION_DEVICE_ID] = "0";
+  options_p["llm.LocalCommRes"] = R"(
+    {
+      "server_count": "1",
+      "server_list": [{
+        "device": [{
+          "device_id": "0",
+          "device_ip": "1.1.1.1"
+        }],
+        "server_id": "127.0.0.1"
+      }],
+      "status": "completed",
+      "version": "1.0"
+    }
+    )";
+  EXPECT_EQ(llm_datadist_p.Initialize(options_p), SUCCESS);
+
+  LlmDataDist llm_datadist_d(decoder_cluster_id, LlmRole::kDecoder);
+  std::map<AscendString, AscendString> options_d;
+  options_d[llm_datadist::OPTION_DEVICE_ID] = "1";
+  options_d["llm.LocalCommRes"] = R"(
+    {
+      "server_count": "1",
+      "server_list": [{
+        "device": [{
+          "device_id": "1",
+          "device_ip": "1.1.1.2"
+        }],
+        "server_id": "127.0.0.1"
+      }],
+      "status": "completed",
+      "version": "1.0"
+    }
+    )";
+  options_d["llm.MemPoolConfig"] = R"({"memory_size": 10000000})";
+  options_d["llm.KvPrefetchConfig"] = R"({"slot_num": 4, "min_repeat": 1})";
+  EXPECT_EQ(llm_datadist_d.Initialize(options_d), SUCCESS);
+
+  // 4 blocks of 16 int32 per tensor
+  CacheDesc kv_desc{};
+  kv_desc.num_tensors = 10;
+  kv_desc.data_type = DT_INT32;
+  kv_desc.shape = {4, 16};
+  constexpr size_t kBlockElements = 16U;
+  RegisterCfg cfg{};
+  std::vector<uint64_t> d_tensor_addrs;
+  auto d_buffers = std::vector<std::vector<int32_t>>(10, std::vector<int32_t>(4 * 16));
+  for (uint32_t i = 0; i < kv_desc.num_tensors; ++i) {
+    d_tensor_addrs.emplace_back(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(d_buffers[i].data())));
+  }
+  int64_t d_cache_id = 0;
+  EXPECT_EQ(llm_datadist_d.RegisterKvCache(kv_desc, d_tensor_addrs, cfg, d_cache_id), ge::SUCCESS);
+
+  std::vector<uint64_t> p_tensor_addrs;
+  auto p_buffers = std::vector<std::vector<int32_t>>(10, std::vector<int32_t>(4 * 16));
+  for (uint32_t i = 0; i < kv_desc.num_tensors; ++i) {
+    std::iota(p_buffers[i].begin(), p_buffers[i].end(), static_cast<int32_t>(i * 100U));
+    p_tensor_addrs.emplace_back(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p_buffers[i].data())));
+  }
+  int64_t p_cache_id = 0;
+  EXPECT_EQ(llm_datadist_p.RegisterKvCache(kv_desc, p_tensor_addrs, cfg, p_cache_id), ge::SUCCESS);
+
+  ClusterInfo cluster_info;
+  IpInfo ip_info;
+  ip_info.ip = "127.0.0.1";
+  ip_info.port = 26000;
+  cluster_info.local_ip_infos = {ip_info};
+  cluster_info.remote_ip_infos = {ip_info};
+  std::vector<ge::Status> rets;
+  EXPECT_EQ(llm_datadist_d.LinkLlmClusters({cluster_info}, rets), ge::SUCCESS);
+
+  CacheIndex cache_index{};
+  cache_index.cluster_id = prompt_cluster_id;
+  cache_index.cache_id = p_cache_id;
+  cache_index.generation = 1U;
+  Cache dst_cache{};
+  dst_cache.cache_id = d_cache_id;
+  dst_cache.cache_desc = kv_desc;
+  KvCacheExtParam ext_param = {};
+  const auto expect_block = [&d_buffers](uint64_t dst_block, int32_t first_value) {
+    for (size_t i = 0U; i < d_buffers.size(); ++i) {
+      for (size_t j = 0U; j < kBlockElements; ++j) {
+        ASSERT_EQ(d_buffers[i][dst_block * kBlockElements + j], first_value + static_cast<int32_t>(i * 100U + j));
+      }
+    }
+  };
+  const auto clear_dst = [&d_buffers]() {
+    for (auto &buffer : d_buffers) {
+      std::fill(buffer.begin(), buffer.end(), -1);
+    }
+  };
+
+  // the first turn pulls from the remote, with min_repeat 1 its blocks are prefetched right after
+  EXPECT_EQ(llm_datadist_d.PullKvBlocks(cache_index, dst_cache, {0U, 1U}, {0U, 1U}, ext_param), ge::SUCCESS);
+  expect_block(0U, 0);
+  expect_block(1U, static_cast<int32_t>(kBlockElements));
+  // the next turn waits for the prefetch in flight and takes the blocks from the prefetch area
+  EXPECT_EQ(llm_datadist_d.PullKvBlocks(cache_index, dst_cache, {0U, 1U}, {2U, 3U}, ext_param), ge::SUCCESS);
+  expect_block(2U, 0);
+  expect_block(3U, static_cast<int32_t>(kBlockElements));
+
+  // the prompt side rewrites block 0 but keeps the generation, the stale prefetched block is still served,
+  // which tells it is not pulled from the remote
+  for (auto &buffer : p_buffers) {
+    std::fill(buffer.begin(), buffer.begin() + kBlockElements, 0);
+  }
+  clear_dst();
+  EXPECT_EQ(llm_datadist_d.PullKvBlocks(cache_index, dst_cache, {0U, 1U}, {0U, 1U}, ext_param), ge::SUCCESS);
+  expect_block(0U, 0);
+
+  // a new generation drops the prefetched blocks and pulls the rewritten one
+  cache_index.generation = 2U;
+  clear_dst();
+  EXPECT_EQ(llm_datadist_d.PullKvBlocks(cache_index, dst_cache, {0U, 1U}, {0U, 1U}, ext_param), ge::SUCCESS);
+  for (size_t i = 0U; i < d_buffers.size(); ++i) {
+    EXPECT_TRUE(std::all_of(d_buffers[i].begin(), d_buffers[i].begin() + kBlockElements,
+                            [](int32_t value) { return value == 0; }));
+  }
+  expect_block(1U, static_cast<int32_t>(kBlockElements));
+
+  EXPECT_EQ(llm_datadist_d.UnlinkLlmClusters({cluster_info}, rets), ge::SUCCESS);
+  EXPECT_EQ(llm_datadist_p.UnregisterKvCache(p_cache_id), ge::SUCCESS);
+  EXPECT_EQ(llm_datadist_d.UnregisterKvCache(d_cache_id), ge::SUCCESS);
+  llm_datadist_p.Finalize();
+  llm_datadist_d.Finalize();
+}
 }  // namespace llm_datadist
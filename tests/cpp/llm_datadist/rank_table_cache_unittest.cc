@@ -0,0 +1,141 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "common/rank_table_cache.h"
+#include "common/rank_table_generator.h"
+#include "llm_datadist/llm_error_codes.h"
+
+namespace llm {
+namespace {
+std::string MakeCommResV1(const std::string &server_id, int32_t device_id) {
+  return R"({"server_count": "1", "server_list": [{"device": [{"device_id": ")" + std::to_string(device_id) +
+         R"(", "device_ip": "10.0.0.)" + std::to_string(device_id + 1) + R"("}], "server_id": ")" + server_id +
+         R"("}], "status": "completed", "version": "1.0"})";
+}
+
+std::string MakeCommResV2(const std::string &server_id, int32_t device_id) {
+  return R"({"server_count": "1", "server_list": [{"device": [{"device_id": ")" + std::to_string(device_id) +
+         R"(", "super_device_id": ")" + std::to_string(device_id) + R"(", "device_ip": "10.0.1.)" +
+         std::to_string(device_id + 1) + R"("}], "server_id": ")" + server_id +
+         R"("}], "super_pod_list": [{"super_pod_id": "0", "server_list": [{"server_id": ")" + server_id +
+         R"("}]}], "status": "completed", "version": "1.2"})";
+}
+
+// prompt nodes a decode node links to, some sort before the local server and some after it
+std::vector<std::string> MakePeers(size_t num, bool v2) {
+  std::vector<std::string> peers;
+  for (size_t i = 0U; i < num; ++i) {
+    const std::string server_id = "192.168." + std::to_string(i % 3U) + "." + std::to_string(i);
+    const int32_t device_id = static_cast<int32_t>(i % 8U);
+    peers.emplace_back(v2 ? MakeCommResV2(server_id, device_id) : MakeCommResV1(server_id, device_id));
+  }
+  return peers;
+}
+
+CachedRankTable GenerateFresh(int32_t device_id, const std::string &local_comm_res,
+                              const std::string &peer_comm_res) {
+  CachedRankTable fresh{};
+  auto generator = RankTableGeneratorFactory::Create(local_comm_res, peer_comm_res);
+  EXPECT_NE(generator, nullptr);
+  if (generator != nullptr) {
+    EXPECT_EQ(generator->Generate(device_id, fresh.rank_table), ge::SUCCESS);
+    fresh.local_rank_id = generator->GetLocalRankId();
+    fresh.peer_rank_id = generator->GetPeerRankId();
+  }
+  return fresh;
+}
+
+void ExpectSameAsFresh(RankTableCache &cache, int32_t device_id, const std::string &local_comm_res,
+                       const std::string &peer_comm_res) {
+  CachedRankTable cached{};
+  ASSERT_EQ(cache.Get(device_id, local_comm_res, peer_comm_res, cached), ge::SUCCESS);
+  const auto fresh = GenerateFresh(device_id, local_comm_res, peer_comm_res);
+  EXPECT_EQ(cached.rank_table, fresh.rank_table);
+  EXPECT_EQ(cached.local_rank_id, fresh.local_rank_id);
+  EXPECT_EQ(cached.peer_rank_id, fresh.peer_rank_id);
+  EXPECT_GE(cached.local_rank_id, 0);
+  EXPECT_GE(cached.peer_rank_id, 0);
+}
+}  // namespace
+
+class RankTableCacheTest : public ::testing::Test {};
+
+TEST_F(RankTableCacheTest, CachedSameAsFresh) {
+  for (const bool local_v2 : {false, true}) {
+    const std::string local_comm_res =
+        local_v2 ? MakeCommResV2("192.168.1.100", 0) : MakeCommResV1("192.168.1.100", 0);
+    RankTableCache cache;
+    auto peers = MakePeers(16U, false);
+    const auto v2_peers = MakePeers(16U, true);
+    peers.insert(peers.end(), v2_peers.begin(), v2_peers.end());
+    // first round builds every table on the reused local side, second round is served from the cache
+    for (size_t round = 0U; round < 2U; ++round) {
+      for (const auto &peer : peers) {
+        ExpectSameAsFresh(cache, 0, local_comm_res, peer);
+      }
+    }
+    EXPECT_EQ(cache.GetMissNum(), peers.size());
+    EXPECT_EQ(cache.GetHitNum(), peers.size());
+  }
+}
+
+TEST_F(RankTableCacheTest, InvalidateOnTopologyChange) {
+  const auto peers = MakePeers(4U, false);
+  RankTableCache cache;
+  for (const auto &peer : peers) {
+    ExpectSameAsFresh(cache, 0, MakeCommResV1("192.168.1.100", 0), peer);
+  }
+  // the local server moved, every table changes
+  for (const auto &peer : peers) {
+    ExpectSameAsFresh(cache, 0, MakeCommResV1("192.168.2.200", 0), peer);
+  }
+  EXPECT_EQ(cache.GetMissNum(), 8U);
+  // another device of the same server
+  ExpectSameAsFresh(cache, 1, MakeCommResV1("192.168.2.200", 1), peers[0U]);
+  EXPECT_EQ(cache.GetMissNum(), 9U);
+  ExpectSameAsFresh(cache, 1, MakeCommResV1("192.168.2.200", 1), peers[0U]);
+  EXPECT_EQ(cache.GetHitNum(), 1U);
+  cache.Invalidate();
+  ExpectSameAsFresh(cache, 1, MakeCommResV1("192.168.2.200", 1), peers[0U]);
+  EXPECT_EQ(cache.GetMissNum(), 10U);
+}
+
+TEST_F(RankTableCacheTest, EvictLeastRecentlyUsed) {
+  const auto local_comm_res = MakeCommResV1("192.168.1.100", 0);
+  const auto peers = MakePeers(3U, false);
+  RankTableCache cache(2U);
+  CachedRankTable cached{};
+  ASSERT_EQ(cache.Get(0, local_comm_res, peers[0U], cached), ge::SUCCESS);
+  ASSERT_EQ(cache.Get(0, local_comm_res, peers[1U], cached), ge::SUCCESS);
+  ASSERT_EQ(cache.Get(0, local_comm_res, peers[0U], cached), ge::SUCCESS);
+  ASSERT_EQ(cache.Get(0, local_comm_res, peers[2U], cached), ge::SUCCESS);
+  EXPECT_EQ(cache.GetMissNum(), 3U);
+  ASSERT_EQ(cache.Get(0, local_comm_res, peers[0U], cached), ge::SUCCESS);
+  EXPECT_EQ(cache.GetHitNum(), 2U);
+  ASSERT_EQ(cache.Get(0, local_comm_res, peers[1U], cached), ge::SUCCESS);
+  EXPECT_EQ(cache.GetMissNum(), 4U);
+}
+
+TEST_F(RankTableCacheTest, InvalidCommRes) {
+  const auto local_comm_res = MakeCommResV1("192.168.1.100", 0);
+  RankTableCache cache;
+  CachedRankTable cached{};
+  EXPECT_NE(cache.Get(0, local_comm_res, "{invalid", cached), ge::SUCCESS);
+  EXPECT_NE(cache.Get(0, local_comm_res, R"({"version": "2.0", "server_list": []})", cached), ge::SUCCESS);
+  // device id does not match the local comm res
+  EXPECT_NE(cache.Get(1, local_comm_res, MakeCommResV1("192.168.0.1", 1), cached), ge::SUCCESS);
+  // failures are not cached and leave the generator usable
+  ExpectSameAsFresh(cache, 0, local_comm_res, MakeCommResV1("192.168.0.1", 1));
+  EXPECT_EQ(cache.GetHitNum(), 0U);
+}
+}  // namespace llm
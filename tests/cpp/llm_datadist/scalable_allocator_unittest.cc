@@ -0,0 +1,219 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <set>
+#include <random>
+#include <gtest/gtest.h>
+#include "common/llm_mem_pool.h"
+#include "memory/span/span_layer_bitmap.h"
+
+namespace llm {
+namespace {
+constexpr size_t kPageShift = 16U;
+constexpr size_t kPoolSize = 4UL * 1024UL * 1024UL * 1024UL;
+constexpr size_t kTraceLength = 200000U;
+constexpr size_t kMaxLiveBlocks = 2048U;
+void *const kPoolBaseAddr = reinterpret_cast<void *>(0x1000000000UL);
+
+// the std::set based lookup table replaced by SpanLayerBitmap, kept as reference
+class SetSpanLayerLut : public SpanLayerLut {
+ public:
+  using SpanLayerLut::SpanLayerLut;
+
+ private:
+  void OnLayerCreated(const SpanLayer &) override {
+  }
+  void OnLayerAddSpan(const SpanLayer &layer) override {
+    if (layer.GetSize() == 1) {
+      layer_ids_.emplace(layer.GetLayerId());
+    }
+  }
+  void OnLayerRemoveSpan(const SpanLayer &layer) override {
+    if (layer.IsEmpty()) {
+      layer_ids_.erase(layer.GetLayerId());
+    }
+  }
+  SpanLayerId FindFitLayerId(PageLen page_len, size_t max_lift_level) const override {
+    if (max_lift_level == 0U) {
+      return SPAN_LAYER_ID_INVALID;
+    }
+    auto layer_id_iter = layer_ids_.lower_bound(page_len);
+    return (layer_id_iter == layer_ids_.end()) ? SPAN_LAYER_ID_INVALID : *layer_id_iter;
+  }
+  void Release(SpanAllocator &span_allocator) override {
+    for (auto &layer : span_layers_) {
+      if (layer != nullptr) {
+        layer->Release(span_allocator);
+      }
+    }
+    layer_ids_.clear();
+  }
+
+  std::set<SpanLayerId> layer_ids_;
+};
+
+struct TraceOp {
+  bool is_alloc;
+  size_t value;  // size to alloc or index of live block to free
+};
+
+// KV blocks mixed with a few large tensors, frees pick random live blocks
+std::vector<TraceOp> MakeRandomTrace(uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<size_t> small_size(1U, 1024U * 1024U);
+  std::uniform_int_distribution<size_t> large_size(1024U * 1024U, 64U * 1024U * 1024U);
+  std::uniform_int_distribution<uint32_t> percent(0U, 99U);
+  std::vector<TraceOp> trace;
+  size_t live_num = 0U;
+  for (size_t i = 0U; i < kTraceLength; ++i) {
+    const bool is_alloc = (live_num == 0U) || ((live_num < kMaxLiveBlocks) && (percent(rng) < 55U));
+    if (is_alloc) {
+      trace.emplace_back(TraceOp{true, (percent(rng) < 90U) ? small_size(rng) : large_size(rng)});
+      ++live_num;
+    } else {
+      trace.emplace_back(TraceOp{false, std::uniform_int_distribution<size_t>(0U, live_num - 1U)(rng)});
+      --live_num;
+    }
+  }
+  return trace;
+}
+
+struct TraceResult {
+  std::vector<void *> addrs;
+  double fragmentation = 0.0;
+  size_t alloc_failed_num = 0U;
+};
+
+// 1 - largest free span / total free, measured with live blocks still held
+double GetFragmentation(LlmMemPool &mem_pool) {
+  auto &allocator = mem_pool.scalable_allocator_;
+  size_t free_pages = 0U;
+  size_t largest_pages = 0U;
+  for (const auto layer : allocator.span_layers_) {
+    if ((layer != nullptr) && !layer->IsEmpty()) {
+      free_pages += layer->GetPageSize();
+      largest_pages = std::max(largest_pages, static_cast<size_t>(layer->GetLayerId()));
+    }
+  }
+  return (free_pages == 0U) ? 0.0 : 1.0 - static_cast<double>(largest_pages) / static_cast<double>(free_pages);
+}
+
+TraceResult RunTrace(const std::vector<TraceOp> &trace, bool use_set_lut) {
+  ScalableConfig config{};
+  config.page_idem_num = kPageShift;
+  config.page_mem_size_total_threshold = kPoolSize;
+  LlmMemPool mem_pool(config);
+  auto &allocator = mem_pool.scalable_allocator_;
+  if (use_set_lut) {
+    allocator.span_layer_lut_.reset(new SetSpanLayerLut{allocator.span_layers_});
+  }
+  EXPECT_EQ(mem_pool.Initialize(kPoolBaseAddr, kPoolSize), ge::SUCCESS);
+
+  TraceResult result;
+  result.addrs.reserve(trace.size());
+  std::vector<PageSpan *> live_spans;
+  for (const auto &op : trace) {
+    if (op.is_alloc) {
+      auto span = allocator.Alloc(mem_pool.allocator_, op.value);
+      result.addrs.emplace_back(span == nullptr ? nullptr : span->GetAddr());
+      if (span != nullptr) {
+        live_spans.emplace_back(span);
+      } else {
+        ++result.alloc_failed_num;
+      }
+    } else if (!live_spans.empty()) {
+      const size_t index = op.value % live_spans.size();
+      std::swap(live_spans[index], live_spans.back());
+      live_spans.back()->Free();
+      live_spans.pop_back();
+    }
+  }
+  result.fragmentation = GetFragmentation(mem_pool);
+  for (const auto span : live_spans) {
+    span->Free();
+  }
+  return result;
+}
+}  // namespace
+
+class ScalableAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(ScalableAllocatorTest, SpanLayerBitmap_SameAsSet) {
+  constexpr size_t kCapacity = 64U * 64U * 3U + 17U;
+  SpanLayerBitmap bitmap(kCapacity);
+  std::set<SpanLayerId> expect;
+  std::mt19937 rng(2025U);
+  std::uniform_int_distribution<SpanLayerId> layer_id_dist(0U, kCapacity - 1U);
+  for (size_t i = 0U; i < 20000U; ++i) {
+    const auto layer_id = layer_id_dist(rng);
+    if ((rng() % 3U) == 0U) {
+      bitmap.Reset(layer_id);
+      expect.erase(layer_id);
+    } else {
+      bitmap.Set(layer_id);
+      expect.emplace(layer_id);
+    }
+    const auto query = layer_id_dist(rng);
+    const auto it = expect.lower_bound(query);
+    ASSERT_EQ(bitmap.FindFirst(query), (it == expect.end()) ? SPAN_LAYER_ID_INVALID : *it);
+    ASSERT_EQ(bitmap.Test(query), expect.count(query) > 0U);
+  }
+  EXPECT_EQ(bitmap.Count(), expect.size());
+  EXPECT_EQ(std::vector<SpanLayerId>(bitmap.begin(), bitmap.end()),
+            std::vector<SpanLayerId>(expect.begin(), expect.end()));
+  EXPECT_EQ(bitmap.FindFirst(kCapacity), SPAN_LAYER_ID_INVALID);
+  bitmap.Set(kCapacity);
+  EXPECT_EQ(bitmap.Count(), expect.size());
+  bitmap.Clear();
+  EXPECT_EQ(bitmap.Count(), 0U);
+  EXPECT_EQ(bitmap.begin(), bitmap.end());
+}
+
+TEST_F(ScalableAllocatorTest, AllocAndMerge) {
+  ScalableConfig config{};
+  config.page_idem_num = kPageShift;
+  config.page_mem_size_total_threshold = 16U << kPageShift;
+  LlmMemPool mem_pool(config);
+  ASSERT_EQ(mem_pool.Initialize(kPoolBaseAddr, config.page_mem_size_total_threshold), ge::SUCCESS);
+  auto &lut = *mem_pool.scalable_allocator_.span_layer_lut_;
+  EXPECT_EQ(std::vector<SpanLayerId>(lut.begin(), lut.end()), std::vector<SpanLayerId>({16U}));
+
+  void *block0 = mem_pool.Alloc(1U);
+  void *block1 = mem_pool.Alloc(3U << kPageShift);
+  void *block2 = mem_pool.Alloc(2U << kPageShift);
+  ASSERT_NE(block2, nullptr);
+  EXPECT_EQ(std::vector<SpanLayerId>(lut.begin(), lut.end()), std::vector<SpanLayerId>({10U}));
+  EXPECT_EQ(mem_pool.Alloc(11U << kPageShift), nullptr);
+  mem_pool.Free(block1);
+  EXPECT_EQ(std::vector<SpanLayerId>(lut.begin(), lut.end()), std::vector<SpanLayerId>({3U, 10U}));
+  mem_pool.Free(block2);
+  EXPECT_EQ(std::vector<SpanLayerId>(lut.begin(), lut.end()), std::vector<SpanLayerId>({15U}));
+  mem_pool.Free(block0);
+  EXPECT_EQ(std::vector<SpanLayerId>(lut.begin(), lut.end()), std::vector<SpanLayerId>({16U}));
+  EXPECT_EQ(mem_pool.Alloc(16U << kPageShift), kPoolBaseAddr);
+}
+
+// replay the same random alloc/free trace on the bitmap lookup and the std::set lookup
+TEST_F(ScalableAllocatorTest, RandomTrace_SameAsSetLut) {
+  const auto trace = MakeRandomTrace(20250101U);
+  const auto bitmap_result = RunTrace(trace, false);
+  const auto set_result = RunTrace(trace, true);
+  ASSERT_EQ(bitmap_result.addrs.size(), set_result.addrs.size());
+  for (size_t i = 0U; i < bitmap_result.addrs.size(); ++i) {
+    ASSERT_EQ(bitmap_result.addrs[i], set_result.addrs[i]) << "alloc index:" << i;
+  }
+  EXPECT_EQ(bitmap_result.alloc_failed_num, set_result.alloc_failed_num);
+  EXPECT_DOUBLE_EQ(bitmap_result.fragmentation, set_result.fragmentation);
+}
+}  // namespace llm
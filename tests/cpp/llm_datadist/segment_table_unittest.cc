@@ -8,6 +8,11 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
 #include <vector>
 #include <gtest/gtest.h>
 
@@ -24,6 +29,39 @@ constexpr uint32_t kSegmentStart3 = 206;
 constexpr uint32_t kSegmentEnd3 = 300;
 constexpr uint32_t kSegmentQueryStart2 = 201;
 constexpr uint32_t kSegmentQueryEnd = 310;
+constexpr uint64_t kRangeStride = 1000UL;
+constexpr uint64_t kRangeLen = 500UL;
+
+using Ranges = std::vector<std::pair<uint64_t, uint64_t>>;
+
+// the previous Segment::Contains, scans left of start then right of it
+bool ScanContains(const Ranges &ranges, uint64_t start, uint64_t end) {
+  if (start > end) {
+    return false;
+  }
+  auto it = std::upper_bound(ranges.begin(), ranges.end(), start,
+                             [](uint64_t val, const std::pair<uint64_t, uint64_t> &range) {
+                               return val < range.first;
+                             });
+  uint64_t max_reached = start;
+  bool covered_start = false;
+  for (auto r_it = std::make_reverse_iterator(it); r_it != ranges.rend(); ++r_it) {
+    if (r_it->second > start) {
+      max_reached = std::max(max_reached, r_it->second);
+      covered_start = true;
+    }
+  }
+  if (!covered_start) {
+    return false;
+  }
+  for (; it != ranges.end(); ++it) {
+    if (it->first > (max_reached + 1)) {
+      break;
+    }
+    max_reached = std::max(max_reached, it->second);
+  }
+  return max_reached >= end;
+}
 }  // namespace
 class SegmentTableUTest : public ::testing::Test {
  protected:
@@ -70,4 +108,117 @@ TEST_F(SegmentTableUTest, TestNotContains) {
   auto channel = table.FindSegment(kChannelId, kSegmentMiddle, kSegmentQueryEnd);
   ASSERT_EQ(channel, nullptr);
 }
+
+TEST_F(SegmentTableUTest, TestRandomRanges_SameAsScan) {
+  std::mt19937_64 rng(2026U);
+  for (int32_t round = 0; round < 50; ++round) {
+    Segment segment(MemType::MEM_DEVICE);
+    Ranges ranges;
+    for (int32_t i = 0; i < 40; ++i) {
+      const uint64_t start = rng() % 2000UL;
+      const uint64_t end = start + rng() % 100UL;
+      segment.AddRange(start, end);
+      ranges.emplace_back(start, end);
+    }
+    for (int32_t i = 0; i < 10; ++i) {
+      const auto range = ranges[rng() % ranges.size()];
+      segment.RemoveRange(range.first, range.second);
+      ranges.erase(std::find(ranges.begin(), ranges.end(), range));
+    }
+    std::sort(ranges.begin(), ranges.end());
+    for (int32_t i = 0; i < 2000; ++i) {
+      const uint64_t start = rng() % 2200UL;
+      const uint64_t end = start + rng() % 300UL;
+      ASSERT_EQ(segment.Contains(start, end), ScanContains(ranges, start, end))
+          << "round:" << round << ", query:" << start << "-" << end;
+    }
+  }
+}
+
+TEST_F(SegmentTableUTest, TestFindMemType) {
+  SegmentTable table;
+  table.AddRange(kChannelId, kSegmentStart1, kSegmentStart2, MemType::MEM_DEVICE);
+  table.AddRange(kChannelId, kSegmentStart3, kSegmentEnd3, MemType::MEM_HOST);
+  MemType type = MemType::MEM_HOST;
+  EXPECT_TRUE(table.FindMemType(kChannelId, kSegmentStart1, kSegmentMiddle, type));
+  EXPECT_EQ(type, MemType::MEM_DEVICE);
+  EXPECT_TRUE(table.FindMemType(kChannelId, kSegmentStart3, kSegmentEnd3, type));
+  EXPECT_EQ(type, MemType::MEM_HOST);
+  EXPECT_FALSE(table.FindMemType(kChannelId, kSegmentStart1, kSegmentEnd3, type));
+  EXPECT_FALSE(table.FindMemType("unknown", kSegmentStart1, kSegmentMiddle, type));
+
+  // a segment handed out keeps its ranges after the table changes
+  auto segment = table.FindSegment(kChannelId, kSegmentStart1, kSegmentMiddle);
+  ASSERT_NE(segment, nullptr);
+  table.RemoveRange(kChannelId, kSegmentStart1, kSegmentStart2, MemType::MEM_DEVICE);
+  EXPECT_TRUE(segment->Contains(kSegmentStart1, kSegmentMiddle));
+  EXPECT_EQ(table.FindSegment(kChannelId, kSegmentStart1, kSegmentMiddle), nullptr);
+  table.RemoveChannel(kChannelId);
+  EXPECT_FALSE(table.FindMemType(kChannelId, kSegmentStart3, kSegmentEnd3, type));
+
+  // a new table must not reuse the snapshot cached by this thread for an old one
+  for (int32_t i = 0; i < 2; ++i) {
+    auto new_table = std::make_unique<SegmentTable>();
+    EXPECT_FALSE(new_table->FindMemType(kChannelId, kSegmentStart3, kSegmentEnd3, type));
+    new_table->AddRange(kChannelId, kSegmentStart3, kSegmentEnd3, MemType::MEM_HOST);
+    EXPECT_TRUE(new_table->FindMemType(kChannelId, kSegmentStart3, kSegmentEnd3, type));
+  }
+}
+
+TEST_F(SegmentTableUTest, TestConcurrentRegisterLookup) {
+  constexpr int32_t kReaderNum = 4;
+  constexpr uint64_t kRangeNum = 200UL;
+  SegmentTable table;
+  // always registered
+  table.AddRange(kChannelId, 0UL, kRangeLen, MemType::MEM_DEVICE);
+  std::atomic<uint64_t> registered_num{1UL};
+  std::atomic<bool> stop{false};
+  std::atomic<int32_t> error_num{0};
+  std::vector<std::thread> readers;
+  for (int32_t i = 0; i < kReaderNum; ++i) {
+    readers.emplace_back([&]() {
+      while (!stop.load()) {
+        MemType type = MemType::MEM_HOST;
+        if (!table.FindMemType(kChannelId, 0UL, kRangeLen, type) || (type != MemType::MEM_DEVICE)) {
+          error_num++;
+        }
+        // every range registered before the lookup started must be found
+        const uint64_t known = registered_num.load();
+        const uint64_t index = known - 1UL;
+        if (!table.FindMemType(kChannelId, index * kRangeStride, index * kRangeStride + kRangeLen, type)) {
+          error_num++;
+        }
+        // the gap between two ranges is never registered
+        if (table.FindMemType(kChannelId, kRangeLen + 1UL, kRangeStride, type)) {
+          error_num++;
+        }
+      }
+    });
+  }
+  std::thread writer([&]() {
+    for (uint64_t i = 1UL; i < kRangeNum; ++i) {
+      table.AddRange(kChannelId, i * kRangeStride, i * kRangeStride + kRangeLen,
+                     (i % 2UL == 0UL) ? MemType::MEM_DEVICE : MemType::MEM_HOST);
+      registered_num.store(i + 1UL);
+      // churn another channel and an unrelated range of this one
+      table.AddRange("other", i, i + 1UL, MemType::MEM_HOST);
+      table.AddRange(kChannelId, kRangeNum * kRangeStride, kRangeNum * kRangeStride + 1UL, MemType::MEM_HOST);
+      table.RemoveRange(kChannelId, kRangeNum * kRangeStride, kRangeNum * kRangeStride + 1UL, MemType::MEM_HOST);
+      std::this_thread::yield();
+    }
+    table.RemoveChannel("other");
+  });
+  writer.join();
+  stop.store(true);
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(error_num.load(), 0);
+  MemType type = MemType::MEM_DEVICE;
+  for (uint64_t i = 1UL; i < kRangeNum; ++i) {
+    ASSERT_TRUE(table.FindMemType(kChannelId, i * kRangeStride, i * kRangeStride + kRangeLen, type));
+    EXPECT_EQ(type, (i % 2UL == 0UL) ? MemType::MEM_DEVICE : MemType::MEM_HOST);
+  }
+  EXPECT_FALSE(table.FindMemType("other", 1UL, 2UL, type));
+}
 }  // namespace adxl
@@ -8,6 +8,8 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 
+#include <random>
+#include <thread>
 #include <vector>
 #include <gtest/gtest.h>
 
@@ -29,4 +31,95 @@ TEST_F(StatisticManagerUTest, TestDump) {
   StatisticManager::GetInstance().Dump();
 }
 
+TEST_F(StatisticManagerUTest, TestCostSnapshot) {
+  auto &manager = StatisticManager::GetInstance();
+  manager.RemoveChannel(kChannelId);
+  LatencySnapshot snapshot;
+  EXPECT_FALSE(manager.GetCostSnapshot(kChannelId, StatisticCostType::kServerCopy, snapshot));
+  for (uint64_t cost = 1U; cost <= 1000U; ++cost) {
+    manager.UpdateServerCopyCost(kChannelId, cost);
+  }
+  manager.UpdateFabricMemRealCopyCost(kChannelId, kCost);
+  ASSERT_TRUE(manager.GetCostSnapshot(kChannelId, StatisticCostType::kServerCopy, snapshot));
+  EXPECT_EQ(snapshot.count, 1000U);
+  EXPECT_EQ(snapshot.min, 1U);
+  EXPECT_EQ(snapshot.max, 1000U);
+  EXPECT_EQ(snapshot.GetAvg(), 500U);
+  EXPECT_NEAR(snapshot.p50, 500U, 500U / LatencyHistogram::kSubBucketNum);
+  EXPECT_NEAR(snapshot.p99, 990U, 990U / LatencyHistogram::kSubBucketNum);
+  ASSERT_TRUE(manager.GetCostSnapshot(kChannelId, StatisticCostType::kFabricMemRealCopy, snapshot));
+  EXPECT_EQ(snapshot.count, 1U);
+  EXPECT_EQ(snapshot.p999, kCost);
+  manager.SetEnableUseFabricMem(true);
+  manager.Dump();
+  manager.SetEnableUseFabricMem(false);
+  manager.Dump();
+  manager.Reset();
+  ASSERT_TRUE(manager.GetCostSnapshot(kChannelId, StatisticCostType::kServerCopy, snapshot));
+  EXPECT_EQ(snapshot.count, 0U);
+  manager.RemoveChannel(kChannelId);
+}
+
+TEST_F(StatisticManagerUTest, TestHistogramBucketAccuracy) {
+  for (uint64_t value = 0U; value < LatencyHistogram::kSubBucketNum; ++value) {
+    const auto index = LatencyHistogram::GetBucketIndex(value);
+    EXPECT_EQ(LatencyHistogram::GetBucketLowerBound(index), value);
+    EXPECT_EQ(LatencyHistogram::GetBucketUpperBound(index), value);
+  }
+  std::mt19937_64 rng(2025U);
+  size_t last_index = 0U;
+  for (size_t magnitude = LatencyHistogram::kSubBucketBits; magnitude < LatencyHistogram::kMaxValueBits; ++magnitude) {
+    for (size_t i = 0U; i < 1000U; ++i) {
+      const uint64_t value = (1UL << magnitude) + rng() % (1UL << magnitude);
+      const auto index = LatencyHistogram::GetBucketIndex(value);
+      ASSERT_LT(index, LatencyHistogram::kBucketNum);
+      const auto lower = LatencyHistogram::GetBucketLowerBound(index);
+      const auto upper = LatencyHistogram::GetBucketUpperBound(index);
+      ASSERT_LE(lower, value);
+      ASSERT_GE(upper, value);
+      ASSERT_LE((upper - lower + 1U) * LatencyHistogram::kSubBucketNum, lower);
+    }
+    // buckets are contiguous across powers of two
+    const auto first_index = LatencyHistogram::GetBucketIndex(1UL << magnitude);
+    EXPECT_EQ(LatencyHistogram::GetBucketUpperBound(first_index - 1U) + 1U,
+              LatencyHistogram::GetBucketLowerBound(first_index));
+    last_index = LatencyHistogram::GetBucketIndex((1UL << (magnitude + 1U)) - 1U);
+  }
+  EXPECT_EQ(last_index, LatencyHistogram::kBucketNum - 1U);
+  EXPECT_EQ(LatencyHistogram::GetBucketIndex(UINT64_MAX), LatencyHistogram::kBucketNum - 1U);
+}
+
+TEST_F(StatisticManagerUTest, TestHistogramPercentileWithThreads) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Snapshot().count, 0U);
+  constexpr uint64_t kValueNum = 100000U;
+  constexpr size_t kThreadNum = 4U;
+  std::vector<std::thread> threads;
+  for (size_t i = 0U; i < kThreadNum; ++i) {
+    threads.emplace_back([&histogram, i]() {
+      for (uint64_t value = i + 1U; value <= kValueNum; value += kThreadNum) {
+        histogram.Record(value);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  // long tail sample beyond the trackable range is kept exactly in max
+  histogram.Record(1UL << 40U);
+  const auto snapshot = histogram.Snapshot();
+  EXPECT_EQ(snapshot.count, kValueNum + 1U);
+  EXPECT_EQ(snapshot.total, kValueNum * (kValueNum + 1U) / 2U + (1UL << 40U));
+  EXPECT_EQ(snapshot.min, 1U);
+  EXPECT_EQ(snapshot.max, 1UL << 40U);
+  const std::vector<std::pair<uint64_t, uint64_t>> expects = {
+      {snapshot.p50, 50000U}, {snapshot.p90, 90000U}, {snapshot.p99, 99000U}, {snapshot.p999, 99900U}};
+  for (const auto &expect : expects) {
+    EXPECT_GE(expect.first, expect.second);
+    EXPECT_LE(expect.first - expect.second, expect.second / LatencyHistogram::kSubBucketNum);
+  }
+  histogram.Reset();
+  EXPECT_EQ(histogram.Snapshot().count, 0U);
+}
+
 }  // namespace adxl
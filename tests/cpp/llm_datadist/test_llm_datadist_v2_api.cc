@@ -8,6 +8,7 @@
  * See LICENSE in the root of the software repository for the full text of the License.
  */
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <cstdlib>
@@ -666,6 +667,22 @@ TEST_F(LlmDataDistSTest, TestPushWithRangeAndTensorNumV2) {
                                       ext_param), ge::SUCCESS);
   EXPECT_EQ(llm_datadist_p.PushKvCache(src_cache, dst_cache_index, 0, -1, ext_param), ge::SUCCESS);
 
+  // 10 tensors of 2 per layer are 5 layers
+  std::shared_ptr<LayerTransferTask> layer_task;
+  std::atomic<uint32_t> callback_num{0U};
+  EXPECT_EQ(llm_datadist_p.PushKvCacheByLayers(src_cache, dst_cache_index, 0, ext_param, layer_task,
+                                               [&callback_num](uint32_t layer_index) {
+                                                 (void)layer_index;
+                                                 callback_num.fetch_add(1U);
+                                               }),
+            ge::SUCCESS);
+  ASSERT_NE(layer_task, nullptr);
+  EXPECT_EQ(layer_task->Wait(), ge::SUCCESS);
+  EXPECT_EQ(layer_task->GetReadyLayerNum(), 5U);
+  EXPECT_TRUE(layer_task->IsLayerReady(4U));
+  EXPECT_FALSE(layer_task->IsLayerReady(5U));
+  EXPECT_EQ(callback_num.load(), 5U);
+
   // test appointed range and tensor num
   ext_param.src_layer_range = std::make_pair(0, 1);
   ext_param.dst_layer_range = std::make_pair(0, 1);
@@ -8,10 +8,14 @@
  */
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <random>
 #include <thread>
 #include <vector>
 #include "adxl/virtual_memory_manager.h"
+#include "adxl/va_block_bitmap.h"
 #include "depends/ascendcl/src/ascendcl_stub.h"
 #include "acl/acl.h"
 #include "common/def_types.h"
@@ -34,8 +38,183 @@ class ScopedRuntimeMockForVmManager {
   ScopedRuntimeMockForVmManager(const ScopedRuntimeMockForVmManager &) = delete;
   ScopedRuntimeMockForVmManager &operator=(const ScopedRuntimeMockForVmManager &) = delete;
 };
+
+// the previous allocator, linear first-fit scan of std::vector<bool> under a mutex
+class ScanBitmap {
+ public:
+  explicit ScanBitmap(size_t block_num) : bitmap_(block_num, false) {}
+
+  bool Reserve(size_t count, size_t &start_block) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t contiguous_free = 0U;
+    for (size_t i = 0U; i < bitmap_.size(); ++i) {
+      if (bitmap_[i]) {
+        contiguous_free = 0U;
+        continue;
+      }
+      if (contiguous_free == 0U) {
+        start_block = i;
+      }
+      if (++contiguous_free >= count) {
+        for (size_t j = start_block; j < start_block + count; ++j) {
+          bitmap_[j] = true;
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Release(size_t start_block, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = start_block; i < start_block + count; ++i) {
+      bitmap_[i] = false;
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<bool> bitmap_;
+};
 }  // namespace
 
+TEST(VaBlockBitmapTest, ReserveFirstFit) {
+  VaBlockBitmap bitmap;
+  bitmap.Init(200U);
+  size_t start = 0U;
+  EXPECT_TRUE(bitmap.Reserve(10U, start));
+  EXPECT_EQ(start, 0U);
+  EXPECT_TRUE(bitmap.Reserve(60U, start));
+  EXPECT_EQ(start, 10U);
+  // crosses the first word boundary
+  EXPECT_TRUE(bitmap.Reserve(70U, start));
+  EXPECT_EQ(start, 70U);
+  EXPECT_TRUE(bitmap.IsUsed(139U));
+  EXPECT_FALSE(bitmap.IsUsed(140U));
+  EXPECT_FALSE(bitmap.Reserve(61U, start));
+  EXPECT_TRUE(bitmap.Reserve(60U, start));
+  EXPECT_EQ(start, 140U);
+  EXPECT_FALSE(bitmap.Reserve(1U, start));
+
+  bitmap.Release(10U, 60U);
+  EXPECT_FALSE(bitmap.Reserve(61U, start));
+  EXPECT_TRUE(bitmap.Reserve(5U, start));
+  EXPECT_EQ(start, 10U);
+  EXPECT_FALSE(bitmap.Reserve(0U, start));
+  EXPECT_FALSE(bitmap.Reserve(201U, start));
+}
+
+TEST(VaBlockBitmapTest, Stats) {
+  VaBlockBitmap bitmap;
+  bitmap.Init(128U);
+  auto stats = bitmap.GetStats();
+  EXPECT_EQ(stats.total_blocks, 128U);
+  EXPECT_EQ(stats.free_blocks, 128U);
+  EXPECT_EQ(stats.largest_free_run, 128U);
+  EXPECT_EQ(stats.free_fragments, 1U);
+  EXPECT_DOUBLE_EQ(stats.GetFragmentation(), 0.0);
+
+  std::vector<size_t> starts;
+  size_t start = 0U;
+  while (bitmap.Reserve(8U, start)) {
+    starts.emplace_back(start);
+  }
+  ASSERT_EQ(starts.size(), 16U);
+  // free every other range, 8 holes of 8 blocks
+  for (size_t i = 0U; i < starts.size(); i += 2U) {
+    bitmap.Release(starts[i], 8U);
+  }
+  stats = bitmap.GetStats();
+  EXPECT_EQ(stats.free_blocks, 64U);
+  EXPECT_EQ(stats.largest_free_run, 8U);
+  EXPECT_EQ(stats.free_fragments, 8U);
+  EXPECT_DOUBLE_EQ(stats.GetFragmentation(), 1.0 - 8.0 / 64.0);
+  EXPECT_FALSE(bitmap.Reserve(9U, start));
+}
+
+TEST(VaBlockBitmapTest, RandomTrace_SameAsScan) {
+  constexpr size_t kBlockNum = 5000U;
+  VaBlockBitmap bitmap;
+  bitmap.Init(kBlockNum);
+  ScanBitmap reference(kBlockNum);
+  std::mt19937 rng(2026U);
+  std::vector<std::pair<size_t, size_t>> ranges;
+  for (int32_t i = 0; i < 20000; ++i) {
+    if (ranges.empty() || (rng() % 3U != 0U)) {
+      const size_t count = (rng() % 8U == 0U) ? (rng() % 300U + 1U) : (rng() % 6U + 1U);
+      size_t start = 0U;
+      size_t expected_start = 0U;
+      const bool expected = reference.Reserve(count, expected_start);
+      ASSERT_EQ(bitmap.Reserve(count, start), expected);
+      if (expected) {
+        ASSERT_EQ(start, expected_start);
+        ranges.emplace_back(start, count);
+      }
+    } else {
+      const size_t index = rng() % ranges.size();
+      bitmap.Release(ranges[index].first, ranges[index].second);
+      reference.Release(ranges[index].first, ranges[index].second);
+      ranges[index] = ranges.back();
+      ranges.pop_back();
+    }
+  }
+}
+
+TEST(VaBlockBitmapTest, ConcurrentReserveRelease_NoOverlap) {
+  constexpr size_t kBlockNum = 4096U;
+  constexpr int32_t kThreadNum = 8;
+  VaBlockBitmap bitmap;
+  bitmap.Init(kBlockNum);
+  std::vector<std::atomic<int32_t>> owners(kBlockNum);
+  std::atomic<int32_t> overlap_count{0};
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i < kThreadNum; ++i) {
+    threads.emplace_back([&, i]() {
+      std::mt19937 rng(static_cast<uint32_t>(i));
+      std::vector<std::pair<size_t, size_t>> ranges;
+      for (int32_t loop = 0; loop < 20000; ++loop) {
+        if (ranges.size() < 16U && (rng() % 2U == 0U)) {
+          const size_t count = rng() % 100U + 1U;
+          size_t start = 0U;
+          if (!bitmap.Reserve(count, start)) {
+            continue;
+          }
+          for (size_t block = start; block < start + count; ++block) {
+            if (owners[block].exchange(i + 1) != 0) {
+              overlap_count++;
+            }
+          }
+          ranges.emplace_back(start, count);
+        } else if (!ranges.empty()) {
+          const auto range = ranges.back();
+          ranges.pop_back();
+          for (size_t block = range.first; block < range.first + range.second; ++block) {
+            owners[block].store(0);
+          }
+          bitmap.Release(range.first, range.second);
+        }
+      }
+      for (const auto &range : ranges) {
+        for (size_t block = range.first; block < range.first + range.second; ++block) {
+          owners[block].store(0);
+        }
+        bitmap.Release(range.first, range.second);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(overlap_count.load(), 0);
+  const auto stats = bitmap.GetStats();
+  EXPECT_EQ(stats.free_blocks, kBlockNum);
+  EXPECT_EQ(stats.largest_free_run, kBlockNum);
+  // summaries are consistent again, the whole space can be taken at once
+  size_t start = 0U;
+  EXPECT_TRUE(bitmap.Reserve(kBlockNum, start));
+  EXPECT_EQ(start, 0U);
+}
+
 class VirtualMemoryManagerTest : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -174,6 +353,26 @@ TEST_F(VirtualMemoryManagerTest, Concurrency_MultipleThreads) {
   EXPECT_EQ(success_count.load(), kNumThreads);
 }
 
+TEST_F(VirtualMemoryManagerTest, GetStats_TracksFragmentation) {
+  VirtualMemoryManager& manager = VirtualMemoryManager::GetInstance();
+  manager.Initialize();
+  uintptr_t addr1 = 0, addr2 = 0, addr3 = 0;
+  EXPECT_EQ(manager.ReserveMemory(kTestSize1GB, addr1), SUCCESS);
+  EXPECT_EQ(manager.ReserveMemory(kTestSize2GB, addr2), SUCCESS);
+  EXPECT_EQ(manager.ReserveMemory(kTestSize1GB, addr3), SUCCESS);
+  EXPECT_EQ(manager.ReleaseMemory(addr2), SUCCESS);
+  EXPECT_EQ(manager.ReleaseMemory(addr2), PARAM_INVALID);
+  const auto stats = manager.GetStats();
+  EXPECT_EQ(stats.free_blocks, stats.total_blocks - 2U);
+  EXPECT_EQ(stats.largest_free_run, stats.total_blocks - 4U);
+  EXPECT_EQ(stats.free_fragments, 2U);
+  EXPECT_GT(stats.GetFragmentation(), 0.0);
+  // the 2GB hole is reused first
+  uintptr_t addr4 = 0;
+  EXPECT_EQ(manager.ReserveMemory(kTestSize2GB, addr4), SUCCESS);
+  EXPECT_EQ(addr4, addr2);
+}
+
 TEST_F(VirtualMemoryManagerTest, SetVirtualMemoryCapacity_Success) {
   VirtualMemoryManager& manager = VirtualMemoryManager::GetInstance();
   constexpr size_t kCustomCapacityTB = 32UL; // 32TB
@@ -0,0 +1,526 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "micro_bench.h"
+#include "cs/hixl_mem_store.h"
+#include "cs/mem_msg_handler.h"
+#include "common/segment.h"
+#include "common/shm_transport.h"
+#include "common/hixl_utils.h"
+#include "common/pinned_host_arena.h"
+#include "common/priority_mutex.h"
+#include "common/rail_striper.h"
+#include "common/trace_recorder.h"
+#include "common/work_stealing_executor.h"
+#include "engine/hixl_client.h"
+
+namespace hixl {
+namespace {
+constexpr uint64_t kRegionSize = 1UL << 20U;
+// leave a gap between regions so segments do not merge them
+constexpr uint64_t kRegionStride = kRegionSize * 2U;
+constexpr uint64_t kServerBase = 0x100000000000UL;
+constexpr uint64_t kClientBase = 0x200000000000UL;
+constexpr uint64_t kBlockSize = 4096U;
+constexpr size_t kQueryNum = 1024U;
+constexpr uint32_t kSeed = 1234U;
+constexpr size_t kStagingSize = 64UL * 1024UL * 1024UL;
+
+// deterministic block offsets spread over the registered regions
+std::vector<uint64_t> MakeOffsets(int64_t region_num, size_t num) {
+  std::mt19937_64 rng(kSeed);
+  std::uniform_int_distribution<uint64_t> region(0U, static_cast<uint64_t>(region_num) - 1U);
+  std::uniform_int_distribution<uint64_t> block(0U, kRegionSize / kBlockSize - 1U);
+  std::vector<uint64_t> offsets(num);
+  for (auto &offset : offsets) {
+    offset = region(rng) * kRegionStride + block(rng) * kBlockSize;
+  }
+  return offsets;
+}
+
+void *ToPtr(uint64_t addr) {
+  return reinterpret_cast<void *>(static_cast<uintptr_t>(addr));
+}
+
+void AddRanges(Segment &segment, uint64_t base, int64_t region_num) {
+  for (int64_t i = 0; i < region_num; ++i) {
+    (void)segment.AddRange(base + static_cast<uint64_t>(i) * kRegionStride, kRegionSize);
+  }
+}
+
+// stores are built once per region count and shared by all threads and calibration runs
+HixlMemStore &GetMemStore(int64_t region_num) {
+  static std::mutex mutex;
+  static std::map<int64_t, std::unique_ptr<HixlMemStore>> stores;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &store = stores[region_num];
+  if (store == nullptr) {
+    store.reset(new HixlMemStore());
+    for (int64_t i = 0; i < region_num; ++i) {
+      (void)store->RecordMemory(true, ToPtr(kServerBase + static_cast<uint64_t>(i) * kRegionStride), kRegionSize);
+      (void)store->RecordMemory(false, ToPtr(kClientBase + static_cast<uint64_t>(i) * kRegionStride), kRegionSize);
+    }
+  }
+  return *store;
+}
+
+// server side check of every remote request, all client threads share one store
+void BM_HixlMemStoreValidateMemoryAccess(micro_bench::State &state) {
+  const int64_t region_num = state.range(0);
+  auto &store = GetMemStore(region_num);
+  const auto offsets = MakeOffsets(region_num, kQueryNum);
+  size_t index = static_cast<size_t>(state.thread_index());
+  for (auto _ : state) {
+    const uint64_t offset = offsets[index++ % kQueryNum];
+    auto ret = store.ValidateMemoryAccess(ToPtr(kServerBase + offset), kBlockSize, ToPtr(kClientBase + offset));
+    micro_bench::DoNotOptimize(ret);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_HixlMemStoreValidateMemoryAccess)
+    ->ArgName("regions")
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Threads(1)
+    ->Threads(4);
+
+void BM_SegmentContains(micro_bench::State &state) {
+  const int64_t region_num = state.range(0);
+  Segment segment(MemType::MEM_DEVICE);
+  AddRanges(segment, kServerBase, region_num);
+  const auto offsets = MakeOffsets(region_num, kQueryNum);
+  size_t index = 0U;
+  for (auto _ : state) {
+    const uint64_t start = kServerBase + offsets[index++ % kQueryNum];
+    bool contains = segment.Contains(start, start + kBlockSize);
+    micro_bench::DoNotOptimize(contains);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_SegmentContains)->ArgName("regions")->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+
+// classification of one BatchTransfer call, half host and half device regions on both sides
+void BM_HixlClientClassifyTransfers(micro_bench::State &state) {
+  const int64_t desc_num = state.range(0);
+  const int64_t region_num = state.range(1);
+  HixlClient client("127.0.0.1", 16000U);
+  auto local_device = MakeShared<Segment>(MemType::MEM_DEVICE);
+  auto local_host = MakeShared<Segment>(MemType::MEM_HOST);
+  auto remote_device = MakeShared<Segment>(MemType::MEM_DEVICE);
+  auto remote_host = MakeShared<Segment>(MemType::MEM_HOST);
+  const uint64_t host_offset = static_cast<uint64_t>(region_num) * kRegionStride;
+  AddRanges(*local_device, kClientBase, region_num);
+  AddRanges(*local_host, kClientBase + host_offset, region_num);
+  AddRanges(*remote_device, kServerBase, region_num);
+  AddRanges(*remote_host, kServerBase + host_offset, region_num);
+  client.local_segments_ = {local_device, local_host};
+  client.remote_segments_ = {remote_device, remote_host};
+
+  const auto offsets = MakeOffsets(region_num, static_cast<size_t>(desc_num));
+  std::vector<TransferOpDesc> op_descs(static_cast<size_t>(desc_num));
+  for (size_t i = 0U; i < op_descs.size(); ++i) {
+    const uint64_t local_shift = ((i & 1U) != 0U) ? host_offset : 0U;
+    const uint64_t remote_shift = ((i & 2U) != 0U) ? host_offset : 0U;
+    op_descs[i].local_addr = kClientBase + local_shift + offsets[i];
+    op_descs[i].remote_addr = kServerBase + remote_shift + offsets[i];
+    op_descs[i].len = kBlockSize;
+  }
+  for (auto _ : state) {
+    std::map<CommType, std::vector<TransferOpDesc>> op_descs_table;
+    auto ret = client.ClassifyTransfers(op_descs, op_descs_table);
+    micro_bench::DoNotOptimize(ret);
+    micro_bench::DoNotOptimize(op_descs_table);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * desc_num);
+}
+BENCHMARK(BM_HixlClientClassifyTransfers)
+    ->ArgNames({"descs", "regions"})
+    ->ArgsProduct({{1, 64, 1024, 16384}, {1, 64, 1024}});
+
+// the single locked queue pool ThreadPool used before the work-stealing executor, kept as the baseline
+class LockedQueuePool {
+ public:
+  explicit LockedQueuePool(uint32_t size) {
+    for (uint32_t i = 0U; i < size; ++i) {
+      workers_.emplace_back([this]() {
+        while (true) {
+          std::function<void()> task;
+          {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopped_ || (!tasks_.empty()); });
+            if (stopped_ && tasks_.empty()) {
+              return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+          }
+          task();
+        }
+      });
+    }
+  }
+  ~LockedQueuePool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+  bool Submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace(std::move(task));
+    }
+    cv_.notify_one();
+    return true;
+  }
+
+ private:
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopped_ = false;
+};
+
+int64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+template <typename Executor>
+void SubmitBatches(micro_bench::State &state, Executor &executor) {
+  constexpr uint64_t kBatchSize = 256UL;
+  std::atomic<uint64_t> done{0UL};
+  uint64_t submitted = 0UL;
+  for (auto _ : state) {
+    for (uint64_t i = 0UL; i < kBatchSize; ++i) {
+      (void)executor.Submit([&done]() { (void)done.fetch_add(1UL, std::memory_order_relaxed); });
+    }
+    submitted += kBatchSize;
+    while (done.load(std::memory_order_relaxed) < submitted) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kBatchSize));
+}
+
+// one task at a time, submitted gap_us after the previous one started, so workers are idle or parked in between
+template <typename Executor>
+void SubmitOneByOne(micro_bench::State &state, Executor &executor) {
+  const int64_t gap_us = state.range(1);
+  std::vector<int64_t> latencies_ns;
+  for (auto _ : state) {
+    if (gap_us > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+    }
+    std::atomic<int64_t> started_ns{0};
+    const int64_t submit_ns = SteadyNowNs();
+    (void)executor.Submit([&started_ns]() { started_ns.store(SteadyNowNs()); });
+    while (started_ns.load() == 0) {
+      std::this_thread::yield();
+    }
+    latencies_ns.emplace_back(started_ns.load() - submit_ns);
+  }
+  if (!latencies_ns.empty()) {
+    std::sort(latencies_ns.begin(), latencies_ns.end());
+    const auto percentile_us = [&latencies_ns](double ratio) {
+      const auto index = static_cast<size_t>(ratio * static_cast<double>(latencies_ns.size() - 1U));
+      return static_cast<double>(latencies_ns[index]) / 1000.0;
+    };
+    state.counters["p50_us"] = percentile_us(0.5);
+    state.counters["p99_us"] = percentile_us(0.99);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// batches of small tasks submitted from outside the workers, each iteration waits for its batch to run
+void BM_WorkStealingExecutorSubmit(micro_bench::State &state) {
+  WorkStealingExecutor executor("bench_ws", static_cast<uint32_t>(state.range(0)));
+  SubmitBatches(state, executor);
+}
+BENCHMARK(BM_WorkStealingExecutorSubmit)->ArgName("workers")->Arg(1)->Arg(4);
+
+// baseline of BM_WorkStealingExecutorSubmit
+void BM_LockedQueuePoolSubmit(micro_bench::State &state) {
+  LockedQueuePool pool(static_cast<uint32_t>(state.range(0)));
+  SubmitBatches(state, pool);
+}
+BENCHMARK(BM_LockedQueuePoolSubmit)->ArgName("workers")->Arg(1)->Arg(4);
+
+// items are tasks and the time includes the gap, p50_us and p99_us are the time from Submit to the task starting
+void BM_WorkStealingExecutorLatency(micro_bench::State &state) {
+  WorkStealingExecutor executor("bench_ws", static_cast<uint32_t>(state.range(0)));
+  SubmitOneByOne(state, executor);
+}
+BENCHMARK(BM_WorkStealingExecutorLatency)->ArgNames({"workers", "gap_us"})->ArgsProduct({{1, 4}, {0, 200}});
+
+// baseline of BM_WorkStealingExecutorLatency
+void BM_LockedQueuePoolLatency(micro_bench::State &state) {
+  LockedQueuePool pool(static_cast<uint32_t>(state.range(0)));
+  SubmitOneByOne(state, pool);
+}
+BENCHMARK(BM_LockedQueuePoolLatency)->ArgNames({"workers", "gap_us"})->ArgsProduct({{1, 4}, {0, 200}});
+
+// span around a hot path call, with tracing disabled it should cost a relaxed load
+void BM_TraceSpan(micro_bench::State &state) {
+  auto &recorder = TraceRecorder::GetInstance();
+  recorder.SetEnabled(state.range(0) != 0);
+  for (auto _ : state) {
+    HIXL_TRACE_REQUEST("BenchmarkRequest", recorder.NewRequestId());
+    HIXL_TRACE_SPAN("BenchmarkSpan");
+  }
+  recorder.SetEnabled(false);
+  recorder.Clear();
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_TraceSpan)->ArgName("enabled")->Arg(0)->Arg(1);
+
+// memcpy from a staging buffer placed on the local node or on the farthest node, items are bytes copied
+void BM_PinnedHostArenaCopy(micro_bench::State &state) {
+  const bool remote = state.range(0) != 0;
+  const int32_t node_num = PinnedHostArena::GetNumaNodeNum();
+  const int32_t local_node = std::max(PinnedHostArena::GetCurrentNumaNode(), 0);
+  if (remote && (node_num < 2)) {
+    state.SkipWithError("single numa node");
+    return;
+  }
+  PinnedHostArenaOptions options;
+  options.backend = HostArenaBackend::kMmap;
+  options.numa_node = local_node;
+  PinnedHostArena local_arena(options);
+  options.numa_node = (local_node == node_num - 1) ? 0 : node_num - 1;
+  PinnedHostArena remote_arena(options);
+  void *src = nullptr;
+  void *dst = nullptr;
+  auto &src_arena = remote ? remote_arena : local_arena;
+  if ((local_arena.Initialize() != SUCCESS) || (remote && (remote_arena.Initialize() != SUCCESS))) {
+    state.SkipWithError("failed to initialize arena");
+    return;
+  }
+  if ((src_arena.Alloc(kStagingSize, src) != SUCCESS) || (local_arena.Alloc(kStagingSize, dst) != SUCCESS)) {
+    state.SkipWithError("failed to alloc staging buffer");
+    return;
+  }
+  (void)memcpy(dst, src, kStagingSize);
+  for (auto _ : state) {
+    (void)memcpy(dst, src, kStagingSize);
+    micro_bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kStagingSize));
+}
+BENCHMARK(BM_PinnedHostArenaCopy)->ArgName("remote")->Arg(0)->Arg(1);
+
+// rails are simulated, rail i moves kRailBaseBandwidth << i bytes per microsecond and a batch finishes when its
+// slowest rail does. weights is 0 for the whole batch on rail 0, 1 for configured bandwidths and 2 for bandwidths
+// measured from the simulated rail costs. items are ops split, makespan_us is the simulated batch time and speedup
+// is the single rail time over it
+void BM_RailStriperTransfer(micro_bench::State &state) {
+  constexpr uint64_t kOpSize = 256UL * 1024UL;
+  constexpr size_t kOpNum = 256U;
+  constexpr double kRailBaseBandwidth = 1024.0;
+  const int64_t weights = state.range(0);
+  const size_t rail_num = static_cast<size_t>(state.range(1));
+  std::vector<double> bandwidths;
+  for (size_t i = 0U; i < rail_num; ++i) {
+    bandwidths.emplace_back(kRailBaseBandwidth * static_cast<double>(1UL << i));
+  }
+  RailStripeConfig config;
+  config.enable = (weights != 0);
+  if (weights == 1) {
+    config.bandwidths = bandwidths;
+  }
+  RailStriper striper;
+  striper.Init(rail_num, config);
+  std::vector<TransferOpDesc> op_descs(kOpNum);
+  for (size_t i = 0U; i < op_descs.size(); ++i) {
+    op_descs[i] = TransferOpDesc{kClientBase + i * kOpSize, kServerBase + i * kOpSize, kOpSize};
+  }
+  std::vector<std::vector<TransferOpDesc>> rail_op_descs;
+  double makespan_sum = 0.0;
+  for (auto _ : state) {
+    striper.Split(op_descs, rail_op_descs);
+    double makespan = 0.0;
+    for (size_t rail = 0U; rail < rail_op_descs.size(); ++rail) {
+      uint64_t bytes = 0U;
+      for (const auto &op_desc : rail_op_descs[rail]) {
+        bytes += op_desc.len;
+      }
+      const double cost = static_cast<double>(bytes) / bandwidths[rail];
+      striper.RecordTransfer(rail, bytes, static_cast<uint64_t>(cost));
+      makespan = std::max(makespan, cost);
+    }
+    makespan_sum += makespan;
+  }
+  const double single_rail = static_cast<double>(kOpNum * kOpSize) / bandwidths[0U];
+  const double makespan_avg = makespan_sum / static_cast<double>(state.iterations());
+  state.counters["makespan_us"] = makespan_avg;
+  state.counters["speedup"] = single_rail / makespan_avg;
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kOpNum));
+}
+BENCHMARK(BM_RailStriperTransfer)->ArgNames({"weights", "rails"})->ArgsProduct({{0, 1, 2}, {2, 4}});
+
+// submit lock shared by all threads, thread 0 is the latency critical submitter and locks with high priority
+// when high is set, the rest stand for a bulk stream
+void BM_PriorityMutexLock(micro_bench::State &state) {
+  static PriorityMutex mutex;
+  static uint64_t posted = 0UL;
+  const bool high_priority = (state.range(0) != 0) && (state.thread_index() == 0);
+  for (auto _ : state) {
+    PriorityLockGuard lock(mutex, high_priority);
+    ++posted;
+    micro_bench::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_PriorityMutexLock)->ArgName("high")->Arg(0)->Arg(1)->Threads(1)->Threads(4);
+
+// same host read through an imported shm block, items are bytes copied
+void BM_ShmImporterRead(micro_bench::State &state) {
+  const auto len = static_cast<size_t>(state.range(0));
+  ShmExporter exporter;
+  void *remote = nullptr;
+  if ((exporter.Initialize() != SUCCESS) || (ShmHostMemory::Alloc(len, remote) != SUCCESS)) {
+    state.SkipWithError("failed to export shm block");
+    return;
+  }
+  const auto remote_addr = reinterpret_cast<uintptr_t>(remote);
+  exporter.AddRegion(remote_addr, len);
+  ShmTransportConfig config{};
+  config.copy_thread_num = static_cast<uint32_t>(state.range(1));
+  ShmImporter importer(config);
+  std::vector<uint8_t> local(len, 0U);
+  const std::vector<TransferOpDesc> op_descs = {{reinterpret_cast<uintptr_t>(local.data()), remote_addr, len}};
+  if (importer.Connect(exporter.GetEndPointConfig(), 1000U) != SUCCESS) {
+    state.SkipWithError("failed to import shm block");
+    ShmHostMemory::Free(remote);
+    return;
+  }
+  for (auto _ : state) {
+    void *handle = nullptr;
+    bool completed = false;
+    auto ret = importer.TransferAsync(op_descs, READ, false, handle);
+    while ((ret == SUCCESS) && (!completed)) {
+      ret = importer.QueryCompleteStatus(handle, completed);
+    }
+    micro_bench::DoNotOptimize(ret);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * len));
+  importer.Finalize();
+  exporter.Finalize();
+  ShmHostMemory::Free(remote);
+}
+BENCHMARK(BM_ShmImporterRead)->ArgNames({"bytes", "copy_threads"})->ArgsProduct({{4096, 64 << 20}, {1, 4}});
+
+// baseline of BM_ShmImporterRead: a peer thread streams the block through a unix socket, so the bytes are copied
+// into the kernel and out again, as on paths that stage through a buffer instead of mapping the peer memory.
+// items are bytes copied
+void BM_SocketCopyRead(micro_bench::State &state) {
+  const auto len = static_cast<size_t>(state.range(0));
+  int32_t fds[2] = {-1, -1};
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    state.SkipWithError("failed to create socket pair");
+    return;
+  }
+  std::vector<uint8_t> remote(len, 1U);
+  std::vector<uint8_t> local(len, 0U);
+  // every request byte asks the peer for the whole block, a zero byte stops it
+  std::thread peer([&remote, len, fd = fds[1]]() {
+    uint8_t request = 0U;
+    while ((read(fd, &request, 1U) == 1) && (request != 0U)) {
+      size_t sent = 0U;
+      while (sent < len) {
+        const ssize_t n = write(fd, remote.data() + sent, len - sent);
+        if (n <= 0) {
+          return;
+        }
+        sent += static_cast<size_t>(n);
+      }
+    }
+  });
+  for (auto _ : state) {
+    const uint8_t request = 1U;
+    bool ok = (write(fds[0], &request, 1U) == 1);
+    size_t received = 0U;
+    while (ok && (received < len)) {
+      const ssize_t n = read(fds[0], local.data() + received, len - received);
+      ok = (n > 0);
+      received += ok ? static_cast<size_t>(n) : 0U;
+    }
+    micro_bench::DoNotOptimize(ok);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * len));
+  const uint8_t stop = 0U;
+  (void)write(fds[0], &stop, 1U);
+  peer.join();
+  (void)close(fds[0]);
+  (void)close(fds[1]);
+}
+BENCHMARK(BM_SocketCopyRead)->ArgName("bytes")->Arg(4096)->Arg(64 << 20);
+
+// server encode plus client decode of one GetRemoteMemResp, json is what clients without binary support get,
+// items are mem descs
+void BM_GetRemoteMemRespRoundTrip(micro_bench::State &state) {
+  constexpr uint32_t kExportLen = 128U;
+  const auto desc_num = static_cast<size_t>(state.range(0));
+  const bool binary = (state.range(1) != 0);
+  GetRemoteMemResp resp{};
+  resp.result = SUCCESS;
+  resp.mem_descs.resize(desc_num);
+  std::vector<uint8_t> export_desc(kExportLen * desc_num, 0x5AU);
+  for (size_t i = 0U; i < desc_num; ++i) {
+    auto &desc = resp.mem_descs[i];
+    desc.mem.type = HCCL_MEM_TYPE_DEVICE;
+    desc.mem.addr = ToPtr(kServerBase + i * kRegionStride);
+    desc.mem.size = kRegionSize;
+    desc.tag = "kv_cache_" + std::to_string(i);
+    desc.export_desc = &export_desc[i * kExportLen];
+    desc.export_len = kExportLen;
+  }
+  const size_t header_len = sizeof(CtrlMsgHeader) + sizeof(CtrlMsgType);
+  std::vector<uint8_t> msg;
+  std::vector<HixlMemDesc> descs;
+  for (auto _ : state) {
+    auto ret = MemMsgHandler::SerializeGetRemoteMemResp(resp, binary, msg);
+    if (ret == SUCCESS) {
+      ret = MemMsgHandler::ParseGetRemoteMemResp(msg.data() + header_len, msg.size() - header_len, descs);
+    }
+    micro_bench::DoNotOptimize(ret);
+    for (auto &desc : descs) {
+      std::free(desc.export_desc);
+    }
+    descs.clear();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * desc_num));
+}
+BENCHMARK(BM_GetRemoteMemRespRoundTrip)->ArgNames({"descs", "binary"})->ArgsProduct({{1, 100, 10000}, {0, 1}});
+}  // namespace
+}  // namespace hixl
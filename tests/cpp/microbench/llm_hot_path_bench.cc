@@ -0,0 +1,1272 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "micro_bench.h"
+#include "common/llm_mem_pool.h"
+#include "common/rank_table_cache.h"
+#include "common/rank_table_generator.h"
+#include "cache_mgr/cache_manager.h"
+#include "cache_mgr/disk_block_store.h"
+#include "cache_mgr/kv_prefetcher.h"
+#include "link_mgr/buffer_free_list.h"
+#include "link_mgr/buffered_sender.h"
+#include "link_mgr/comm_entity.h"
+#include "link_mgr/comm_link_manager.h"
+#include "link_mgr/entity_scheduler.h"
+#include "data_transfer/layer_wise_transfer_job.h"
+#include "hccl/hccl_adapter.h"
+#include "adxl/copy_stream_balancer.h"
+#include "adxl/stream_pool.h"
+#include "adxl/channel_msg_handler.h"
+#include "adxl/kv_codec.h"
+#include "adxl/latency_histogram.h"
+#include "adxl/segment_table.h"
+#include "adxl/va_block_bitmap.h"
+#include "depends/llm_datadist/src/data_cache_engine_test_helper.h"
+#include "depends/ascendcl/src/ascendcl_stub.h"
+
+namespace {
+constexpr size_t kPageShift = 16U;
+constexpr size_t kPoolSize = 64UL * 1024UL * 1024UL * 1024UL;
+// the pool is never touched, the allocator only does address arithmetic
+void *const kPoolBaseAddr = reinterpret_cast<void *>(0x1000000000UL);
+constexpr size_t kQueryNum = 1024U;
+constexpr uint32_t kSeed = 1234U;
+constexpr uint64_t kModelId = 0U;
+constexpr int64_t kTensorSize = 1024 * 1024;
+constexpr uint32_t kTensorNum = 80U;
+
+template <typename T, typename Creator>
+T &GetShared(int64_t key, const Creator &creator) {
+  static std::mutex mutex;
+  static std::map<int64_t, std::unique_ptr<T>> objects;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &object = objects[key];
+  if (object == nullptr) {
+    object = creator();
+  }
+  return *object;
+}
+
+std::unique_ptr<llm::LlmMemPool> CreateMemPool() {
+  llm::ScalableConfig config{};
+  config.page_idem_num = kPageShift;
+  config.page_mem_size_total_threshold = kPoolSize;
+  std::unique_ptr<llm::LlmMemPool> mem_pool(new llm::LlmMemPool(config));
+  if (mem_pool->Initialize(kPoolBaseAddr, kPoolSize) != ge::SUCCESS) {
+    return nullptr;
+  }
+  return mem_pool;
+}
+
+// each iteration allocates a batch of kv blocks and frees them in random order
+void BM_ScalableAllocatorAllocFree(micro_bench::State &state) {
+  const auto block_num = static_cast<size_t>(state.range(0));
+  const auto block_size = static_cast<size_t>(state.range(1));
+  auto &mem_pool = GetShared<llm::LlmMemPool>(0, CreateMemPool);
+  std::vector<size_t> free_order(block_num);
+  for (size_t i = 0U; i < block_num; ++i) {
+    free_order[i] = i;
+  }
+  std::shuffle(free_order.begin(), free_order.end(), std::mt19937(kSeed + state.thread_index()));
+  std::vector<void *> blocks(block_num);
+  for (auto _ : state) {
+    for (auto &block : blocks) {
+      block = mem_pool.Alloc(block_size);
+    }
+    for (const auto index : free_order) {
+      mem_pool.Free(blocks[index]);
+    }
+  }
+  if (blocks.front() == nullptr) {
+    state.SkipWithError("alloc failed, pool exhausted");
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * block_num));
+}
+BENCHMARK(BM_ScalableAllocatorAllocFree)
+    ->ArgNames({"blocks", "size"})
+    ->ArgsProduct({{1, 64, 1024}, {64 * 1024, 1024 * 1024}})
+    ->Threads(1)
+    ->Threads(4);
+
+// random trace of kv blocks mixed with a few large tensors, frees pick random live blocks
+void BM_ScalableAllocatorRandomTrace(micro_bench::State &state) {
+  const auto max_live_num = static_cast<size_t>(state.range(0));
+  auto &mem_pool = GetShared<llm::LlmMemPool>(0, CreateMemPool);
+  std::mt19937 rng(kSeed);
+  std::uniform_int_distribution<size_t> small_size(1U, 1024U * 1024U);
+  std::uniform_int_distribution<size_t> large_size(1024U * 1024U, 64U * 1024U * 1024U);
+  std::uniform_int_distribution<uint32_t> percent(0U, 99U);
+  std::vector<void *> live_blocks;
+  live_blocks.reserve(max_live_num);
+  for (auto _ : state) {
+    const bool is_alloc = live_blocks.empty() || ((live_blocks.size() < max_live_num) && (percent(rng) < 55U));
+    if (is_alloc) {
+      void *block = mem_pool.Alloc((percent(rng) < 90U) ? small_size(rng) : large_size(rng));
+      if (block != nullptr) {
+        live_blocks.emplace_back(block);
+      }
+    } else {
+      const size_t index = std::uniform_int_distribution<size_t>(0U, live_blocks.size() - 1U)(rng);
+      std::swap(live_blocks[index], live_blocks.back());
+      mem_pool.Free(live_blocks.back());
+      live_blocks.pop_back();
+    }
+  }
+  for (const auto block : live_blocks) {
+    mem_pool.Free(block);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_ScalableAllocatorRandomTrace)->ArgName("live_blocks")->Arg(256)->Arg(2048);
+
+// every thread records into one shared histogram, as transfer threads do for a channel
+void BM_LatencyHistogramRecord(micro_bench::State &state) {
+  auto &histogram = GetShared<adxl::LatencyHistogram>(state.threads(), []() {
+    return std::unique_ptr<adxl::LatencyHistogram>(new adxl::LatencyHistogram());
+  });
+  uint64_t cost = static_cast<uint64_t>(state.thread_index());
+  for (auto _ : state) {
+    histogram.Record(cost++ % 4096U);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_LatencyHistogramRecord)->Threads(1)->Threads(8);
+
+// the max/total/count atomics StatisticManager::UpdateCost kept before the histograms, shared by all threads
+struct AtomicCostStatistic {
+  std::atomic<uint64_t> times{0UL};
+  std::atomic<uint64_t> max_cost{0UL};
+  std::atomic<uint64_t> total_cost{0UL};
+
+  void Update(uint64_t cost) {
+    (void)times.fetch_add(1U, std::memory_order_relaxed);
+    (void)total_cost.fetch_add(cost, std::memory_order_relaxed);
+    if (max_cost.load() < cost) {
+      max_cost.store(cost, std::memory_order_relaxed);
+    }
+  }
+};
+
+// baseline of BM_LatencyHistogramRecord with the same values
+void BM_AtomicCostStatisticUpdate(micro_bench::State &state) {
+  auto &statistic = GetShared<AtomicCostStatistic>(state.threads(), []() {
+    return std::unique_ptr<AtomicCostStatistic>(new AtomicCostStatistic());
+  });
+  uint64_t cost = static_cast<uint64_t>(state.thread_index());
+  for (auto _ : state) {
+    statistic.Update(cost++ % 4096U);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_AtomicCostStatisticUpdate)->Threads(1)->Threads(8);
+
+// the low half of the space stays used, so every reserve searches past it
+void BM_VaBlockBitmapReserveRelease(micro_bench::State &state) {
+  constexpr size_t kBlockNum = 64UL * 1024UL;
+  auto &bitmap = GetShared<adxl::VaBlockBitmap>(state.threads(), []() {
+    std::unique_ptr<adxl::VaBlockBitmap> bitmap(new adxl::VaBlockBitmap());
+    bitmap->Init(kBlockNum);
+    for (size_t i = 0U; i < kBlockNum / 2U; ++i) {
+      size_t start = 0U;
+      (void)bitmap->Reserve(1U, start);
+    }
+    return bitmap;
+  });
+  size_t loop = static_cast<size_t>(state.thread_index());
+  for (auto _ : state) {
+    const size_t count = loop++ % 4U + 1U;
+    size_t start = 0U;
+    if (bitmap.Reserve(count, start)) {
+      bitmap.Release(start, count);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_VaBlockBitmapReserveRelease)->Threads(1)->Threads(4);
+
+// lookup of the memory type of a transfer op, the host segment is searched first and misses
+void BM_SegmentTableFindMemType(micro_bench::State &state) {
+  constexpr uint64_t kRangeStride = 1000UL;
+  constexpr uint64_t kRangeLen = 500UL;
+  constexpr uint64_t kRangeNum = 64UL;
+  auto &table = GetShared<adxl::SegmentTable>(state.threads(), []() {
+    std::unique_ptr<adxl::SegmentTable> table(new adxl::SegmentTable());
+    for (uint64_t i = 0UL; i < kRangeNum; ++i) {
+      table->AddRange("bench", i * kRangeStride + kRangeLen + 1UL, i * kRangeStride + kRangeLen + 2UL,
+                      adxl::MemType::MEM_HOST);
+      table->AddRange("bench", i * kRangeStride, i * kRangeStride + kRangeLen, adxl::MemType::MEM_DEVICE);
+    }
+    return table;
+  });
+  const std::string channel_id = "bench";
+  uint64_t loop = static_cast<uint64_t>(state.thread_index()) * 8U;
+  for (auto _ : state) {
+    // several lookups in a row hit the same range, as the ops of one transfer usually do
+    const uint64_t base = (loop / 8U % kRangeNum) * kRangeStride;
+    auto type = adxl::MemType::MEM_HOST;
+    bool found = table.FindMemType(channel_id, base + loop % 8U, base + kRangeLen, type);
+    micro_bench::DoNotOptimize(found);
+    ++loop;
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_SegmentTableFindMemType)->Threads(1)->Threads(4);
+
+// the table SegmentTable replaced: one mutex over all channels, sorted ranges per segment scanned back from the
+// first range past start
+class LinearSegment {
+ public:
+  explicit LinearSegment(adxl::MemType type) : mem_type_(type) {}
+  void AddRange(uint64_t start, uint64_t end) {
+    auto it = std::upper_bound(ranges_.begin(), ranges_.end(), start,
+                               [](uint64_t val, const std::pair<uint64_t, uint64_t> &range) {
+                                 return val < range.first;
+                               });
+    ranges_.insert(it, {start, end});
+  }
+  bool Contains(uint64_t start, uint64_t end) const {
+    if (start > end) {
+      return false;
+    }
+    auto it = std::upper_bound(ranges_.begin(), ranges_.end(), start,
+                               [](uint64_t val, const std::pair<uint64_t, uint64_t> &range) {
+                                 return val < range.first;
+                               });
+    uint64_t max_reached = start;
+    bool covered_start = false;
+    for (auto r_it = std::make_reverse_iterator(it); r_it != ranges_.rend(); ++r_it) {
+      if (r_it->second > start) {
+        max_reached = std::max(max_reached, r_it->second);
+        covered_start = true;
+        if (max_reached >= end) {
+          return true;
+        }
+      }
+    }
+    if (!covered_start) {
+      return false;
+    }
+    for (; (it != ranges_.end()) && (it->first <= max_reached + 1U); ++it) {
+      max_reached = std::max(max_reached, it->second);
+      if (max_reached >= end) {
+        return true;
+      }
+    }
+    return max_reached >= end;
+  }
+  adxl::MemType GetMemType() const {
+    return mem_type_;
+  }
+
+ private:
+  std::vector<std::pair<uint64_t, uint64_t>> ranges_;
+  adxl::MemType mem_type_;
+};
+
+class LinearSegmentTable {
+ public:
+  void AddRange(const std::string &channel_id, uint64_t start, uint64_t end, adxl::MemType type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &segments = channel_2_segment_[channel_id];
+    auto it = std::find_if(segments.begin(), segments.end(),
+                           [type](const std::shared_ptr<LinearSegment> &seg) { return seg->GetMemType() == type; });
+    if (it == segments.end()) {
+      it = segments.emplace(segments.end(), std::make_shared<LinearSegment>(type));
+    }
+    (*it)->AddRange(start, end);
+  }
+  std::shared_ptr<LinearSegment> FindSegment(const std::string &channel_id, uint64_t start, uint64_t end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto channel_it = channel_2_segment_.find(channel_id);
+    if (channel_it == channel_2_segment_.end()) {
+      return nullptr;
+    }
+    for (const auto &segment : channel_it->second) {
+      if (segment->Contains(start, end)) {
+        return segment;
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<std::shared_ptr<LinearSegment>>> channel_2_segment_;
+};
+
+// baseline of BM_SegmentTableFindMemType with the same ranges and lookups
+void BM_LinearSegmentTableFindSegment(micro_bench::State &state) {
+  constexpr uint64_t kRangeStride = 1000UL;
+  constexpr uint64_t kRangeLen = 500UL;
+  constexpr uint64_t kRangeNum = 64UL;
+  auto &table = GetShared<LinearSegmentTable>(state.threads(), []() {
+    std::unique_ptr<LinearSegmentTable> table(new LinearSegmentTable());
+    for (uint64_t i = 0UL; i < kRangeNum; ++i) {
+      table->AddRange("bench", i * kRangeStride + kRangeLen + 1UL, i * kRangeStride + kRangeLen + 2UL,
+                      adxl::MemType::MEM_HOST);
+      table->AddRange("bench", i * kRangeStride, i * kRangeStride + kRangeLen, adxl::MemType::MEM_DEVICE);
+    }
+    return table;
+  });
+  const std::string channel_id = "bench";
+  uint64_t loop = static_cast<uint64_t>(state.thread_index()) * 8U;
+  for (auto _ : state) {
+    const uint64_t base = (loop / 8U % kRangeNum) * kRangeStride;
+    const auto segment = table.FindSegment(channel_id, base + loop % 8U, base + kRangeLen);
+    bool found = (segment != nullptr);
+    micro_bench::DoNotOptimize(found);
+    ++loop;
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_LinearSegmentTableFindSegment)->Threads(1)->Threads(4);
+
+// one stream per thread, a hit always finds a free stream
+void BM_StreamPoolAllocFree(micro_bench::State &state) {
+  auto &stream_pool = GetShared<adxl::StreamPool>(state.threads(), [&state]() {
+    return std::unique_ptr<adxl::StreamPool>(new adxl::StreamPool(static_cast<size_t>(state.threads())));
+  });
+  for (auto _ : state) {
+    aclrtStream stream = nullptr;
+    if (stream_pool.TryAllocStream(stream) != adxl::SUCCESS) {
+      state.SkipWithError("alloc stream failed");
+      break;
+    }
+    stream_pool.FreeStream(stream);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_StreamPoolAllocFree)->Threads(1)->Threads(4);
+
+struct FreeListRegion {
+  std::vector<uint8_t> region;
+  llm::BufferFreeList free_list;
+};
+
+// entity msg buffers, every thread holds hold_num of them at once and recycles them, items are alloc/free pairs
+void BM_BufferFreeListAllocFree(micro_bench::State &state) {
+  constexpr uint64_t kBufferSize = 64U;
+  constexpr uint64_t kCapacity = 512U;  // entities a CommEntityManager supports
+  const size_t hold_num = static_cast<size_t>(state.range(0));
+  auto &shared = GetShared<FreeListRegion>(state.threads() * 1000 + state.range(0), []() {
+    std::unique_ptr<FreeListRegion> shared(new FreeListRegion());
+    shared->region.resize(kBufferSize * kCapacity);
+    (void)shared->free_list.Initialize(shared->region.data(), shared->region.size(), {{kBufferSize, kCapacity}});
+    return shared;
+  });
+  std::vector<void *> held(hold_num, nullptr);
+  for (auto _ : state) {
+    // the threads hold at most half of the buffers, so an alloc never waits
+    for (auto &buffer : held) {
+      (void)shared.free_list.Alloc(kBufferSize, buffer);
+    }
+    for (auto buffer : held) {
+      shared.free_list.Free(buffer);
+    }
+  }
+  if (held.front() == nullptr) {
+    state.SkipWithError("alloc failed, free list exhausted");
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * hold_num));
+}
+BENCHMARK(BM_BufferFreeListAllocFree)->ArgName("held")->Arg(1)->Arg(64)->Threads(1)->Threads(4);
+
+// the former RegBufferPool, a mutex and a scan of the buffer map for the first free one
+struct MapScanPool {
+  ge::Status Alloc(void *&buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &it : buffers) {
+      if (!it.second) {
+        buffer = it.first;
+        it.second = true;
+        return ge::SUCCESS;
+      }
+    }
+    return ge::FAILED;
+  }
+  void Free(void *buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = buffers.find(buffer);
+    if (it != buffers.end()) {
+      it->second = false;
+    }
+  }
+
+  std::vector<uint8_t> region;
+  std::mutex mutex;
+  std::map<void *, bool> buffers;
+};
+
+// baseline of BM_BufferFreeListAllocFree with the same buffers and hold pattern, items are alloc/free pairs
+void BM_MapScanAllocFree(micro_bench::State &state) {
+  constexpr uint64_t kBufferSize = 64U;
+  constexpr uint64_t kCapacity = 512U;
+  const size_t hold_num = static_cast<size_t>(state.range(0));
+  auto &shared = GetShared<MapScanPool>(state.threads() * 1000 + state.range(0), []() {
+    std::unique_ptr<MapScanPool> shared(new MapScanPool());
+    shared->region.resize(kBufferSize * kCapacity);
+    for (uint64_t i = 0U; i < kCapacity; ++i) {
+      shared->buffers[shared->region.data() + i * kBufferSize] = false;
+    }
+    return shared;
+  });
+  std::vector<void *> held(hold_num, nullptr);
+  for (auto _ : state) {
+    for (auto &buffer : held) {
+      (void)shared.Alloc(buffer);
+    }
+    for (auto buffer : held) {
+      shared.Free(buffer);
+    }
+  }
+  if (held.front() == nullptr) {
+    state.SkipWithError("alloc failed, map exhausted");
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * hold_num));
+}
+BENCHMARK(BM_MapScanAllocFree)->ArgName("held")->Arg(1)->Arg(64)->Threads(1)->Threads(4);
+
+// LLMLinkManager::LinkClusters where the comm init of every cluster takes kCommInitMs, with slow_peer the one of
+// cluster 0 takes kSlowCommInitMs. gate is the width of the comm init gate, gate 1 is the former global init mutex.
+// items are clusters linked, fast_done_ms is the time until every cluster but the slow one is linked
+void BM_LinkClustersWallClock(micro_bench::State &state) {
+  constexpr int64_t kCommInitMs = 1;
+  constexpr int64_t kSlowCommInitMs = 20;
+  const auto cluster_num = static_cast<size_t>(state.range(0));
+  const bool slow_peer = (state.range(2) != 0);
+  llm::HcclCommInitGate::GetInstance().SetLimit(static_cast<uint32_t>(state.range(1)));
+  double fast_done_ms = 0.0;
+  for (auto _ : state) {
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<int64_t> fast_done_us{0};
+    llm::LLMThreadPool thread_pool("bench_link", static_cast<uint32_t>(std::min(llm::kLinkThreadNum, cluster_num)));
+    std::vector<std::future<void>> fut_rets;
+    for (size_t i = 0U; i < cluster_num; ++i) {
+      const bool is_slow = slow_peer && (i == 0U);
+      const int64_t init_ms = is_slow ? kSlowCommInitMs : kCommInitMs;
+      fut_rets.emplace_back(thread_pool.commit([&start, &fast_done_us, is_slow, init_ms]() {
+        {
+          llm::HcclCommInitGate::Guard init_guard;
+          std::this_thread::sleep_for(std::chrono::milliseconds(init_ms));
+        }
+        if (!is_slow) {
+          const int64_t done_us =
+              std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+          int64_t last_us = fast_done_us.load();
+          while ((done_us > last_us) && !fast_done_us.compare_exchange_weak(last_us, done_us)) {
+          }
+        }
+      }));
+    }
+    for (auto &fut : fut_rets) {
+      fut.get();
+    }
+    fast_done_ms += static_cast<double>(fast_done_us.load()) / 1000.0;
+  }
+  llm::HcclCommInitGate::GetInstance().SetLimit(llm::kDefaultCommInitConcurrency);
+  state.counters["fast_done_ms"] = fast_done_ms / static_cast<double>(state.iterations());
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * cluster_num));
+}
+BENCHMARK(BM_LinkClustersWallClock)
+    ->ArgNames({"clusters", "gate", "slow_peer"})
+    ->ArgsProduct({{1, 8, 64}, {1, 4, 16}, {0, 1}});
+
+// CommLinkManager::PrepareMem of one comm, HcclCommPrepare and the HcclExchangeMemDesc with every peer each wait
+// kRemoteWaitMs for the remote side. mode 0 prepares and then exchanges with one peer after another, mode 1 exchanges
+// with all peers on a pool after the prepare, mode 2 runs the exchanges on the pool while the comm is prepared.
+// items are peers prepared
+void BM_PrepareMemWallClock(micro_bench::State &state) {
+  constexpr int64_t kRemoteWaitMs = 2;
+  const auto peer_num = static_cast<size_t>(state.range(0));
+  const int64_t mode = state.range(1);
+  const std::chrono::milliseconds remote_wait_time(kRemoteWaitMs);
+  const auto remote_wait = [remote_wait_time]() { std::this_thread::sleep_for(remote_wait_time); };
+  for (auto _ : state) {
+    if (mode == 0) {
+      remote_wait();
+      for (size_t i = 0U; i < peer_num; ++i) {
+        remote_wait();
+      }
+      continue;
+    }
+    llm::LLMThreadPool thread_pool("bench_prepare", static_cast<uint32_t>(std::min(llm::kLinkThreadNum, peer_num)));
+    if (mode == 1) {
+      remote_wait();
+    }
+    std::vector<std::future<void>> fut_rets;
+    for (size_t i = 0U; i < peer_num; ++i) {
+      fut_rets.emplace_back(thread_pool.commit(remote_wait));
+    }
+    if (mode == 2) {
+      remote_wait();
+    }
+    for (auto &fut : fut_rets) {
+      fut.get();
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * peer_num));
+}
+BENCHMARK(BM_PrepareMemWallClock)->ArgNames({"peers", "mode"})->ArgsProduct({{1, 2, 8}, {0, 1, 2}});
+
+int64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int64_t ProcessCpuNs() {
+  struct timespec ts {};
+  (void)clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000L + ts.tv_nsec;
+}
+
+// comm entities whose request flag is written by the peer, the flag holds the time it was set
+class PickupEntities {
+ public:
+  explicit PickupEntities(size_t num) {
+    for (size_t i = 0U; i < num; ++i) {
+      req_ns_.emplace_back(new std::atomic<int64_t>(0));
+    }
+  }
+  bool Probe(uint64_t id) const {
+    return req_ns_[id]->load(std::memory_order_relaxed) != 0;
+  }
+  bool Process(uint64_t id) {
+    const int64_t req_ns = req_ns_[id]->exchange(0);
+    if (req_ns != 0) {
+      const int64_t latency_ns = SteadyNowNs() - req_ns;
+      std::lock_guard<std::mutex> lock(mutex_);
+      latencies_ns_.emplace_back(latency_ns);
+      cv_.notify_one();
+    }
+    return false;
+  }
+  void Request(uint64_t id) {
+    req_ns_[id]->store(SteadyNowNs());
+  }
+  void WaitServed(size_t served_num) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, served_num]() { return latencies_ns_.size() >= served_num; });
+  }
+  size_t size() const {
+    return req_ns_.size();
+  }
+  double PercentileUs(double ratio) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (latencies_ns_.empty()) {
+      return 0.0;
+    }
+    std::sort(latencies_ns_.begin(), latencies_ns_.end());
+    const auto index = static_cast<size_t>(ratio * static_cast<double>(latencies_ns_.size() - 1U));
+    return static_cast<double>(latencies_ns_[index]) / 1000.0;
+  }
+
+ private:
+  std::vector<std::unique_ptr<std::atomic<int64_t>>> req_ns_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<int64_t> latencies_ns_;
+};
+
+// one request at a time to a random one of 64 entities, sent gap_us after the previous one was run. loop 0 is the
+// EntityScheduler with default options, loop 1 the former fsm thread probing every entity back to back, loop 2 that
+// thread sleeping max_sleep_time_us between passes. items are requests and the time includes the gap, p50_us and
+// p99_us are the time from the flag being set to the entity being run, cpu_cores the cpu time of the process over
+// the wall time
+void BM_EntityPickupLatency(micro_bench::State &state) {
+  constexpr size_t kEntityNum = 64U;
+  const int64_t loop = state.range(0);
+  const int64_t gap_us = state.range(1);
+  const llm::EntitySchedulerOptions options{};
+  PickupEntities entities(kEntityNum);
+  llm::EntityScheduler scheduler(options, [&entities](uint64_t id) { return entities.Process(id); });
+  std::atomic<bool> running{true};
+  std::thread poll_thread;
+  if (loop == 0) {
+    if (scheduler.Start("bench_fsm") != ge::SUCCESS) {
+      state.SkipWithError("start scheduler failed");
+      return;
+    }
+    for (uint64_t id = 0U; id < kEntityNum; ++id) {
+      scheduler.Watch(id, [&entities, id]() { return entities.Probe(id); });
+    }
+  } else {
+    const int64_t sleep_us = (loop == 2) ? static_cast<int64_t>(options.max_sleep_time_us) : 0;
+    poll_thread = std::thread([&entities, &running, sleep_us]() {
+      while (running.load()) {
+        for (uint64_t id = 0U; id < entities.size(); ++id) {
+          if (entities.Probe(id)) {
+            (void)entities.Process(id);
+          }
+        }
+        if (sleep_us > 0) {
+          std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+        }
+      }
+    });
+  }
+  std::mt19937 rng(kSeed);
+  std::uniform_int_distribution<uint64_t> dist(0U, kEntityNum - 1U);
+  size_t served_num = 0U;
+  const int64_t cpu_start_ns = ProcessCpuNs();
+  const int64_t wall_start_ns = SteadyNowNs();
+  for (auto _ : state) {
+    if (gap_us > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+    }
+    entities.Request(dist(rng));
+    entities.WaitServed(++served_num);
+  }
+  const double cpu_cores =
+      static_cast<double>(ProcessCpuNs() - cpu_start_ns) / static_cast<double>(SteadyNowNs() - wall_start_ns);
+  running.store(false);
+  if (poll_thread.joinable()) {
+    poll_thread.join();
+  }
+  scheduler.Stop();
+  state.counters["p50_us"] = entities.PercentileUs(0.5);
+  state.counters["p99_us"] = entities.PercentileUs(0.99);
+  state.counters["cpu_cores"] = cpu_cores;
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_EntityPickupLatency)->ArgNames({"loop", "gap_us"})->ArgsProduct({{0, 1, 2}, {0, 2000}});
+
+std::unique_ptr<llm::CacheManager> CreateCacheManager(int64_t cache_num) {
+  std::unique_ptr<llm::CacheManager> cache_manager(new llm::CacheManager());
+  llm::CacheDesc cache_desc{};
+  cache_desc.num_tensors = kTensorNum;
+  cache_desc.data_type = ge::DT_FLOAT16;
+  cache_desc.shape = {1, kTensorSize / 2};
+  std::vector<uintptr_t> addrs(kTensorNum);
+  for (int64_t cache_id = 0; cache_id < cache_num; ++cache_id) {
+    for (size_t i = 0U; i < addrs.size(); ++i) {
+      addrs[i] = 0x1000000000UL + (static_cast<uintptr_t>(cache_id) * kTensorNum + i) * kTensorSize;
+    }
+    llm::CacheKey cache_key{};
+    cache_key.req_id = static_cast<uint64_t>(cache_id);
+    cache_key.model_id = kModelId;
+    if (cache_manager->RegisterCacheEntry(cache_id, {cache_key}, cache_desc, addrs, kTensorSize) != ge::SUCCESS) {
+      return nullptr;
+    }
+  }
+  return cache_manager;
+}
+
+// lookup done for every pull request: cache key -> cache entry
+void BM_CacheManagerGetCacheEntry(micro_bench::State &state) {
+  const int64_t cache_num = state.range(0);
+  auto &cache_manager =
+      GetShared<llm::CacheManager>(cache_num, [cache_num]() { return CreateCacheManager(cache_num); });
+  std::mt19937_64 rng(kSeed);
+  std::uniform_int_distribution<uint64_t> req_id(0U, static_cast<uint64_t>(cache_num) - 1U);
+  std::vector<llm::DataCacheKey> keys(kQueryNum);
+  for (auto &key : keys) {
+    key = std::make_pair(req_id(rng), kModelId);
+  }
+  size_t index = static_cast<size_t>(state.thread_index());
+  for (auto _ : state) {
+    llm::CacheEntry cache_entry;
+    bool found = cache_manager.GetCacheEntry(keys[index++ % kQueryNum], false, cache_entry);
+    micro_bench::DoNotOptimize(found);
+    micro_bench::DoNotOptimize(cache_entry);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_CacheManagerGetCacheEntry)
+    ->ArgName("caches")
+    ->Arg(16)
+    ->Arg(1024)
+    ->Arg(65536)
+    ->Threads(1)
+    ->Threads(4);
+
+adxl::ChannelConnectInfo MakeConnectInfo(int64_t addr_num) {
+  adxl::ChannelConnectInfo info{};
+  info.channel_id = "10.10.10.1:16000_10.10.10.2:16000";
+  info.comm_name = "10.10.10.1:16000_10.10.10.2:16000";
+  info.comm_res = std::string(512U, 'r');
+  info.timeout = 3000;
+  for (int64_t i = 0; i < addr_num; ++i) {
+    adxl::AddrInfo addr{};
+    addr.start_addr = 0x1000000000UL + static_cast<uintptr_t>(i) * kTensorSize;
+    addr.end_addr = addr.start_addr + kTensorSize;
+    addr.mem_type = ((i & 1) == 0) ? adxl::MemType::MEM_DEVICE : adxl::MemType::MEM_HOST;
+    info.addrs.emplace_back(addr);
+  }
+  return info;
+}
+
+// connect message carries one entry per registered memory
+void BM_ChannelMsgHandlerSerialize(micro_bench::State &state) {
+  const auto info = MakeConnectInfo(state.range(0));
+  for (auto _ : state) {
+    std::string msg_str;
+    auto ret = adxl::ChannelMsgHandler::Serialize(info, msg_str);
+    micro_bench::DoNotOptimize(ret);
+    micro_bench::DoNotOptimize(msg_str);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_ChannelMsgHandlerSerialize)->ArgName("addrs")->Arg(1)->Arg(64)->Arg(1024);
+
+void BM_ChannelMsgHandlerDeserialize(micro_bench::State &state) {
+  std::string msg_str;
+  (void)adxl::ChannelMsgHandler::Serialize(MakeConnectInfo(state.range(0)), msg_str);
+  std::vector<char> msg(msg_str.begin(), msg_str.end());
+  msg.push_back('\0');
+  for (auto _ : state) {
+    adxl::ChannelConnectInfo info{};
+    auto ret = adxl::ChannelMsgHandler::Deserialize(msg, info);
+    micro_bench::DoNotOptimize(ret);
+    micro_bench::DoNotOptimize(info);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_ChannelMsgHandlerDeserialize)->ArgName("addrs")->Arg(1)->Arg(64)->Arg(1024);
+
+// 256KB page aligned host blocks swapped in from the disk tier 4 at a time, in file order or shuffled, items are bytes
+void BM_DiskBlockStoreSwapIn(micro_bench::State &state) {
+  constexpr uint64_t kBlockSize = 256UL * 1024UL;
+  constexpr int64_t kBlockNum = 256;
+  constexpr int64_t kBlocksPerSwap = 4;
+  constexpr uint64_t kAlign = 4096UL;
+  const uint64_t total_size = kBlockSize * kBlockNum;
+  char dir[] = "/tmp/llm_disk_tier_bench_XXXXXX";
+  if (mkdtemp(dir) == nullptr) {
+    state.SkipWithError("failed to create disk tier directory");
+    return;
+  }
+  llm::DiskTierOptions options{};
+  options.path = dir;
+  options.capacity = total_size;
+  options.read_ahead_blocks = static_cast<uint32_t>(state.range(0));
+  std::vector<uint8_t> cache(total_size + kAlign, 1U);
+  std::vector<uint8_t> restore(total_size + kAlign);
+  const uintptr_t cache_addr = (reinterpret_cast<uintptr_t>(cache.data()) + kAlign - 1UL) & ~(kAlign - 1UL);
+  const uintptr_t restore_addr = (reinterpret_cast<uintptr_t>(restore.data()) + kAlign - 1UL) & ~(kAlign - 1UL);
+  std::vector<std::pair<int64_t, int64_t>> mapping;
+  for (int64_t i = 0; i < kBlockNum; ++i) {
+    mapping.emplace_back(i, i);
+  }
+  std::vector<int64_t> order(kBlockNum / kBlocksPerSwap);
+  std::iota(order.begin(), order.end(), 0);
+  if (state.range(1) != 0) {
+    std::shuffle(order.begin(), order.end(), std::mt19937(kSeed));
+  }
+  {
+    llm::DiskBlockStore store(options);
+    if ((store.Initialize() != ge::SUCCESS) || (store.SwapOut({cache_addr}, 1, kBlockSize, mapping) != ge::SUCCESS)) {
+      state.SkipWithError("failed to fill disk tier");
+    } else {
+      size_t index = 0U;
+      for (auto _ : state) {
+        const int64_t first = order[index++ % order.size()] * kBlocksPerSwap;
+        const std::vector<std::pair<int64_t, int64_t>> swap_mapping(mapping.begin() + first,
+                                                                    mapping.begin() + first + kBlocksPerSwap);
+        auto ret = store.SwapIn(1, {restore_addr}, kBlockSize, swap_mapping);
+        micro_bench::DoNotOptimize(ret);
+      }
+      state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kBlockSize * kBlocksPerSwap));
+    }
+    store.Finalize();
+  }
+  (void)rmdir(dir);
+}
+BENCHMARK(BM_DiskBlockStoreSwapIn)->ArgNames({"read_ahead", "random"})->ArgsProduct({{0, 8}, {0, 1}});
+
+// every iteration replays 16 conversations of 8 turns, each turn pulls the blocks of all previous turns and 4 new
+// ones of its prompt cache. the remote side and the prefetch area are host memory. items are requested blocks,
+// hit_rate is the share served from the prefetch area, wasted_bytes the prefetched bytes no request used
+void BM_KvPrefetcherReplayTrace(micro_bench::State &state) {
+  constexpr uint64_t kBlockSize = 16UL * 1024UL;
+  constexpr int64_t kConversationNum = 16;
+  constexpr uint64_t kTurnNum = 8U;
+  constexpr uint64_t kFirstTurnBlocks = 8U;
+  constexpr uint64_t kBlocksPerTurn = 4U;
+  constexpr uint64_t kRemoteBlockNum = kFirstTurnBlocks + kTurnNum * kBlocksPerTurn;
+  llm::KvPrefetchOptions options{};
+  options.min_repeat = static_cast<uint32_t>(state.range(0));
+  options.slot_num = static_cast<uint64_t>(state.range(1));
+  options.admission_blocks = options.slot_num / 2U;
+  std::vector<uint8_t> remote(kConversationNum * kRemoteBlockNum * kBlockSize, 1U);
+  std::vector<uint8_t> area(options.slot_num * kBlockSize);
+  std::vector<uint8_t> dst(kRemoteBlockNum * kBlockSize);
+  const auto remote_block = [&remote](const llm::CacheKey &cache_key, uint64_t block_index) {
+    return remote.data() + (static_cast<uint64_t>(cache_key.prompt_cache_id) * kRemoteBlockNum + block_index) *
+                               kBlockSize;
+  };
+  const auto pull_func = [&area, &remote_block](const llm::CacheKey &cache_key,
+                                                const std::vector<uint64_t> &remote_blocks,
+                                                const std::vector<uint64_t> &slots) -> ge::Status {
+    for (size_t i = 0U; i < slots.size(); ++i) {
+      (void)memcpy(area.data() + slots[i] * kBlockSize, remote_block(cache_key, remote_blocks[i]), kBlockSize);
+    }
+    return ge::SUCCESS;
+  };
+  std::vector<int64_t> order(kConversationNum);
+  std::iota(order.begin(), order.end(), 0);
+  std::vector<uint64_t> blocks(kRemoteBlockNum);
+  std::iota(blocks.begin(), blocks.end(), 0UL);
+  llm::KvPrefetchStats stats{};
+  for (auto _ : state) {
+    llm::KvPrefetcher prefetcher(options, pull_func);
+    if (prefetcher.Initialize() != ge::SUCCESS) {
+      state.SkipWithError("failed to initialize kv prefetcher");
+      return;
+    }
+    std::mt19937 rng(kSeed);
+    for (uint64_t turn = 0U; turn < kTurnNum; ++turn) {
+      std::shuffle(order.begin(), order.end(), rng);
+      const std::vector<uint64_t> turn_blocks(blocks.begin(),
+                                              blocks.begin() + kFirstTurnBlocks + turn * kBlocksPerTurn);
+      for (const auto conversation : order) {
+        llm::CacheKey cache_key{};
+        cache_key.prompt_cache_id = conversation;
+        cache_key.prompt_cache_generation = 1U;
+        std::vector<llm::KvPrefetchHit> hits;
+        prefetcher.Acquire(cache_key, turn_blocks, hits);
+        std::vector<bool> is_hit(turn_blocks.size(), false);
+        for (const auto &hit : hits) {
+          (void)memcpy(dst.data() + hit.index * kBlockSize, area.data() + hit.slot * kBlockSize, kBlockSize);
+          is_hit[hit.index] = true;
+        }
+        prefetcher.Release(hits);
+        for (size_t i = 0U; i < turn_blocks.size(); ++i) {
+          if (!is_hit[i]) {
+            (void)memcpy(dst.data() + i * kBlockSize, remote_block(cache_key, turn_blocks[i]), kBlockSize);
+          }
+        }
+        micro_bench::ClobberMemory();
+        prefetcher.Record(cache_key, turn_blocks);
+      }
+    }
+    prefetcher.WaitIdle();
+    stats = prefetcher.GetStats();
+    prefetcher.Finalize();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * stats.requested_blocks));
+  if (stats.requested_blocks > 0U) {
+    state.counters["hit_rate"] =
+        static_cast<double>(stats.hit_blocks) / static_cast<double>(stats.requested_blocks);
+    state.counters["wasted_bytes"] = static_cast<double>((stats.wasted_blocks + stats.unused_blocks) * kBlockSize);
+  }
+}
+BENCHMARK(BM_KvPrefetcherReplayTrace)->ArgNames({"min_repeat", "slot_num"})->ArgsProduct({{1, 2}, {64, 512}});
+
+// every iteration pulls 256 blocks of 16KB from each of 64 layers the way D2DDataTransferJob::PullCache does, the
+// batch call is a stub. contiguous is the percentage of blocks following the previous one on both sides, merge
+// turns merge_contiguous on with a region ended per layer. items are blocks, ops_per_call is descriptors per
+// HcclBatchGet and calls the HcclBatchGet calls of one pull
+void BM_BufferedSenderOpsPerCall(micro_bench::State &state) {
+  constexpr uint64_t kBlockSize = 16UL * 1024UL;
+  constexpr size_t kBlockNum = 256U;
+  constexpr size_t kLayerNum = 64U;
+  // addresses are only compared, the blocks are never touched
+  constexpr uint64_t kLocalBase = 0x100000000UL;
+  constexpr uint64_t kRemoteBase = 0x800000000UL;
+  constexpr uint64_t kTensorSize = kBlockSize * kBlockNum * 4U;
+  const double contiguous_ratio = static_cast<double>(state.range(0)) / 100.0;
+  std::vector<std::pair<void *, void *>> blocks;
+  std::mt19937 rng(kSeed);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  for (size_t layer = 0U; layer < kLayerNum; ++layer) {
+    uint64_t local_block = 0U;
+    uint64_t remote_block = 0U;
+    for (size_t i = 0U; i < kBlockNum; ++i) {
+      if ((i > 0U) && (dist(rng) >= contiguous_ratio)) {
+        local_block += 2U;
+        ++remote_block;
+      } else if (i > 0U) {
+        ++local_block;
+        ++remote_block;
+      }
+      blocks.emplace_back(reinterpret_cast<void *>(kLocalBase + layer * kTensorSize + local_block * kBlockSize),
+                          reinterpret_cast<void *>(kRemoteBase + layer * kTensorSize + remote_block * kBlockSize));
+    }
+  }
+  llm::BufferedSenderOptions options;
+  options.flush_delay_us = 0UL;  // keeps the batches deterministic
+  options.merge_contiguous = (state.range(1) != 0);
+  uint64_t batch_op_num = 0UL;
+  const auto batch_func = [&batch_op_num](std::vector<HcclOneSideOpDesc> &op_descs) -> ge::Status {
+    batch_op_num += op_descs.size();
+    return ge::SUCCESS;
+  };
+  llm::BufferedSenderStatistic statistic{};
+  for (auto _ : state) {
+    llm::BufferedSender sender;
+    sender.Initialize(batch_func, options);
+    for (size_t i = 0U; i < blocks.size(); ++i) {
+      if ((i > 0U) && (i % kBlockNum == 0U)) {
+        sender.EndRegion();
+      }
+      (void)sender.Put(blocks[i].first, blocks[i].second, kBlockSize);
+    }
+    (void)sender.Flush();
+    statistic = sender.GetStatistic();
+  }
+  micro_bench::DoNotOptimize(batch_op_num);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * blocks.size()));
+  if (statistic.flush_num > 0U) {
+    state.counters["ops_per_call"] = static_cast<double>(statistic.op_num) / static_cast<double>(statistic.flush_num);
+    state.counters["calls"] = static_cast<double>(statistic.flush_num);
+  }
+}
+BENCHMARK(BM_BufferedSenderOpsPerCall)->ArgNames({"contiguous", "merge"})->ArgsProduct({{0, 70, 100}, {0, 1}});
+
+// a serial link shared by the hccl and runtime stubs: every put descriptor keeps it busy task_cost longer, an event
+// completes once the link drained what was queued before it was recorded
+class SerialLink {
+ public:
+  explicit SerialLink(std::chrono::microseconds task_cost) : task_cost_(task_cost) {}
+  void Queue(uint32_t task_num) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    busy_until_ = std::max(busy_until_, std::chrono::steady_clock::now()) + task_cost_ * task_num;
+  }
+  std::chrono::steady_clock::time_point GetBusyUntil() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return busy_until_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::chrono::microseconds task_cost_;
+  std::chrono::steady_clock::time_point busy_until_{};
+};
+
+class SerialLinkHcclStub : public llm::HcclApiStub {
+ public:
+  explicit SerialLinkHcclStub(SerialLink &link) : link_(link) {}
+  HcclResult HcclBatchPut(HcclComm comm, uint32_t remoteRank, HcclOneSideOpDesc *desc, uint32_t descNum,
+                          aclrtStream stream) override {
+    link_.Queue(descNum);
+    return llm::HcclApiStub::HcclBatchPut(comm, remoteRank, desc, descNum, stream);
+  }
+
+ private:
+  SerialLink &link_;
+};
+
+class SerialLinkRuntimeStub : public llm::AclRuntimeStub {
+ public:
+  explicit SerialLinkRuntimeStub(SerialLink &link) : link_(link) {}
+  aclError aclrtRecordEvent(aclrtEvent event, aclrtStream stream) override {
+    (void)stream;
+    std::lock_guard<std::mutex> lock(mutex_);
+    complete_time_[event] = link_.GetBusyUntil();
+    return ACL_ERROR_NONE;
+  }
+  aclError aclrtQueryEventStatus(aclrtEvent event, aclrtEventRecordedStatus *status) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = complete_time_.find(event);
+    const bool completed = (it == complete_time_.end()) || (std::chrono::steady_clock::now() >= it->second);
+    *status = completed ? ACL_EVENT_RECORDED_STATUS_COMPLETE : ACL_EVENT_RECORDED_STATUS_NOT_READY;
+    return ACL_ERROR_NONE;
+  }
+  aclError aclrtDestroyEvent(aclrtEvent event) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      complete_time_.erase(event);
+    }
+    return llm::AclRuntimeStub::aclrtDestroyEvent(event);
+  }
+  aclError aclrtSynchronizeStreamWithTimeout(aclrtStream stream, int32_t timeout) override {
+    (void)stream;
+    (void)timeout;
+    std::this_thread::sleep_until(link_.GetBusyUntil());
+    return ACL_ERROR_NONE;
+  }
+
+ private:
+  SerialLink &link_;
+  std::mutex mutex_;
+  std::map<aclrtEvent, std::chrono::steady_clock::time_point> complete_time_;
+};
+
+// the path before layer-wise transfer: the tasks of all layers go out as one list and the caller waits for all of them
+ge::Status TransferWholeCache(llm::LayerWiseTransferJob &job, const llm::CacheEntry &cache_entry,
+                              const llm::TransferCacheConfig &transfer_cache_config, uint64_t layer_num,
+                              int32_t timeout_in_ms) {
+  const uint64_t tensor_num_per_layer = transfer_cache_config.tensor_num_per_layer;
+  llm::TransferCacheConfig layer_config = transfer_cache_config;
+  for (uint64_t i = 0U; i < layer_num; ++i) {
+    layer_config.layer_index = transfer_cache_config.layer_index + i;
+    const auto begin = transfer_cache_config.dst_addrs.cbegin() + i * tensor_num_per_layer;
+    layer_config.dst_addrs.assign(begin, begin + tensor_num_per_layer);
+    const auto ret = job.Prepare(cache_entry, layer_config, llm::TransferBlockConfig{});
+    if (ret != ge::SUCCESS) {
+      return ret;
+    }
+  }
+  return job.SynchronizeTransferCacheWithRecord(timeout_in_ms);
+}
+
+// pushes 64 layers of 2 tensors over a stub link on which every descriptor takes 20us. mode 0 is the former whole
+// cache path, mode 1 TransferCacheByLayers. items are layers, first_layer_us is the time until layer 0 can be used,
+// all_layers_us the time until the last one can
+void BM_TransferTimeToFirstLayer(micro_bench::State &state) {
+  constexpr uint64_t kLayerNum = 64U;
+  constexpr int32_t kTimeoutMs = 10000;
+  const bool by_layers = (state.range(0) != 0);
+  SerialLink link(std::chrono::microseconds(20));
+  llm::MockMmpaForHcclApi::Install();
+  llm::HcclApiStub::SetStub(std::unique_ptr<llm::HcclApiStub>(new SerialLinkHcclStub(link)));
+  llm::AclRuntimeStub::SetInstance(std::make_shared<SerialLinkRuntimeStub>(link));
+  (void)llm::HcclAdapter::GetInstance().Initialize();
+  {
+    llm::CacheDesc cache_desc{};
+    cache_desc.num_tensors = kLayerNum * llm::kDefaultTensorNumPerLayer;
+    cache_desc.shape = {4, 128};
+    cache_desc.data_type = ge::DT_INT32;
+    cache_desc.placement = 1;
+    llm::DataCacheEngineTestRunner test_runner;
+    test_runner.Initialize(cache_desc, cache_desc, llm::PullCacheParam{});
+    llm::TransferCacheConfig transfer_cache_config{};
+    transfer_cache_config.src_cache_id = test_runner.GetSrcCache().cache_id;
+    transfer_cache_config.dst_addrs = test_runner.GetDstCache().per_device_tensor_addrs[0];
+    auto &src_context = test_runner.GetSrcTestContext();
+    llm::CacheEntry cache_entry;
+    aclrtStream stream = nullptr;
+    const bool prepared =
+        src_context.CacheEngine().cache_manager_->GetCacheEntry(transfer_cache_config.src_cache_id, cache_entry) &&
+        (aclrtCreateStream(&stream) == ACL_ERROR_NONE);
+    if (!prepared) {
+      state.SkipWithError("prepare cache failed");
+    }
+    int64_t first_layer_ns = 0;
+    int64_t all_layers_ns = 0;
+    for (auto _ : state) {
+      if (!prepared) {
+        break;
+      }
+      llm::LayerWiseTransferJob job(src_context.GetCommEntry(), stream);
+      const auto start = std::chrono::steady_clock::now();
+      auto first_ready = start;
+      ge::Status ret = ge::SUCCESS;
+      if (by_layers) {
+        llm::LayerTransferProgress progress(kLayerNum);
+        ret = job.TransferCacheByLayers(cache_entry, transfer_cache_config, llm::TransferBlockConfig{}, kTimeoutMs,
+                                        false, progress, [&first_ready](uint64_t layer_index) {
+                                          if (layer_index == 0U) {
+                                            first_ready = std::chrono::steady_clock::now();
+                                          }
+                                        });
+      } else {
+        ret = TransferWholeCache(job, cache_entry, transfer_cache_config, kLayerNum, kTimeoutMs);
+        first_ready = std::chrono::steady_clock::now();
+      }
+      const auto finished = std::chrono::steady_clock::now();
+      if (ret != ge::SUCCESS) {
+        state.SkipWithError("transfer cache failed");
+        break;
+      }
+      first_layer_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(first_ready - start).count();
+      all_layers_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(finished - start).count();
+    }
+    if (stream != nullptr) {
+      (void)aclrtDestroyStream(stream);
+    }
+    if (state.iterations() > 0) {
+      const auto iterations = static_cast<double>(state.iterations());
+      state.counters["first_layer_us"] = static_cast<double>(first_layer_ns) / iterations / 1000.0;
+      state.counters["all_layers_us"] = static_cast<double>(all_layers_ns) / iterations / 1000.0;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kLayerNum));
+  }
+  llm::AclRuntimeStub::Reset();
+  llm::HcclAdapter::GetInstance().Finalize();
+  llm::MockMmpaForHcclApi::Reset();
+}
+BENCHMARK(BM_TransferTimeToFirstLayer)->ArgName("mode")->Arg(0)->Arg(1);
+
+// 4MB of normally distributed fp16 kv
+std::vector<uint8_t> MakeFp16Kv() {
+  constexpr size_t kKvBytes = 4UL * 1024UL * 1024UL;
+  std::mt19937 gen(kSeed);
+  std::normal_distribution<float> dist(0.0F, 0.5F);
+  std::vector<uint8_t> data(kKvBytes);
+  for (size_t i = 0U; i < kKvBytes; i += sizeof(uint16_t)) {
+    const uint16_t half = adxl::KvCodec::FloatToHalf(dist(gen));
+    data[i] = static_cast<uint8_t>(half & 0xFFU);
+    data[i + 1U] = static_cast<uint8_t>(half >> 8U);
+  }
+  return data;
+}
+
+// codec is the KvCodecType value, items are plain bytes, ratio is plain bytes over encoded bytes
+void BM_KvCodecEncode(micro_bench::State &state) {
+  const auto type = static_cast<adxl::KvCodecType>(state.range(0));
+  const auto src = MakeFp16Kv();
+  std::vector<uint8_t> encoded(adxl::KvCodec::MaxEncodedSize(type, src.size()));
+  size_t encoded_len = 0U;
+  for (auto _ : state) {
+    auto ret = adxl::KvCodec::Encode(type, src.data(), src.size(), encoded.data(), encoded.size(), encoded_len);
+    micro_bench::DoNotOptimize(ret);
+    micro_bench::DoNotOptimize(encoded_len);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * src.size()));
+  if (encoded_len > 0U) {
+    state.counters["ratio"] = static_cast<double>(src.size()) / static_cast<double>(encoded_len);
+  }
+}
+BENCHMARK(BM_KvCodecEncode)->ArgName("codec")->Arg(1)->Arg(2)->Arg(3);
+
+// codec is the KvCodecType value, items are plain bytes
+void BM_KvCodecDecode(micro_bench::State &state) {
+  const auto type = static_cast<adxl::KvCodecType>(state.range(0));
+  const auto src = MakeFp16Kv();
+  std::vector<uint8_t> encoded(adxl::KvCodec::MaxEncodedSize(type, src.size()));
+  size_t encoded_len = 0U;
+  if (adxl::KvCodec::Encode(type, src.data(), src.size(), encoded.data(), encoded.size(), encoded_len) !=
+      adxl::SUCCESS) {
+    state.SkipWithError("failed to encode kv");
+    return;
+  }
+  std::vector<uint8_t> decoded(src.size());
+  for (auto _ : state) {
+    size_t decoded_len = 0U;
+    auto ret = adxl::KvCodec::Decode(encoded.data(), encoded_len, decoded.data(), decoded.size(), decoded_len);
+    micro_bench::DoNotOptimize(ret);
+    micro_bench::DoNotOptimize(decoded_len);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * src.size()));
+}
+BENCHMARK(BM_KvCodecDecode)->ArgName("codec")->Arg(1)->Arg(2)->Arg(3);
+
+// comm res of the peers a decode node relinks to, v2 selects the super pod layout
+std::vector<std::string> MakePeerCommRes(size_t num, bool v2) {
+  std::vector<std::string> peers;
+  for (size_t i = 0U; i < num; ++i) {
+    const std::string server_id = "192.168." + std::to_string(i % 3U) + "." + std::to_string(i);
+    const std::string device_id = std::to_string(i % 8U);
+    const std::string device_ip = "10.0.0." + std::to_string(i % 8U + 1U);
+    peers.emplace_back(v2 ? R"({"server_count": "1", "server_list": [{"device": [{"device_id": ")" + device_id +
+                                R"(", "super_device_id": ")" + device_id + R"(", "device_ip": ")" + device_ip +
+                                R"("}], "server_id": ")" + server_id +
+                                R"("}], "super_pod_list": [{"super_pod_id": "0", "server_list": [{"server_id": ")" +
+                                server_id + R"("}]}], "status": "completed", "version": "1.2"})"
+                          : R"({"server_count": "1", "server_list": [{"device": [{"device_id": ")" + device_id +
+                                R"(", "device_ip": ")" + device_ip + R"("}], "server_id": ")" + server_id +
+                                R"("}], "status": "completed", "version": "1.0"})");
+  }
+  return peers;
+}
+
+// items are links, every one builds the rank table from both comm res
+void BM_RankTableGenerateFresh(micro_bench::State &state) {
+  constexpr size_t kPeerNum = 256U;
+  const bool v2 = (state.range(0) != 0);
+  const auto local_comm_res = MakePeerCommRes(1U, v2).front();
+  const auto peers = MakePeerCommRes(kPeerNum + 1U, v2);
+  size_t index = 0U;
+  for (auto _ : state) {
+    // peers[0] is the local server itself
+    index = (index % kPeerNum) + 1U;
+    auto generator = llm::RankTableGeneratorFactory::Create(local_comm_res, peers[index]);
+    std::string rank_table;
+    auto ret = (generator == nullptr) ? ge::FAILED : generator->Generate(0, rank_table);
+    micro_bench::DoNotOptimize(ret);
+    micro_bench::DoNotOptimize(rank_table);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_RankTableGenerateFresh)->ArgName("v2")->Arg(0)->Arg(1);
+
+// items are relinks of peers already in the cache
+void BM_RankTableCacheRelink(micro_bench::State &state) {
+  constexpr size_t kPeerNum = 256U;
+  const bool v2 = (state.range(0) != 0);
+  const auto local_comm_res = MakePeerCommRes(1U, v2).front();
+  const auto peers = MakePeerCommRes(kPeerNum + 1U, v2);
+  llm::RankTableCache cache;
+  llm::CachedRankTable cached{};
+  for (size_t i = 1U; i <= kPeerNum; ++i) {
+    if (cache.Get(0, local_comm_res, peers[i], cached) != ge::SUCCESS) {
+      state.SkipWithError("failed to generate rank table");
+      return;
+    }
+  }
+  size_t index = 0U;
+  for (auto _ : state) {
+    index = (index % kPeerNum) + 1U;
+    auto ret = cache.Get(0, local_comm_res, peers[index], cached);
+    micro_bench::DoNotOptimize(ret);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_RankTableCacheRelink)->ArgName("v2")->Arg(0)->Arg(1);
+
+// a few large layers behind many small kv blocks, with a hole after each block so nothing merges
+std::vector<adxl::TransferOpDesc> MakeMixedCopyDescs() {
+  constexpr uintptr_t kLocalBase = 0x10000000UL;
+  constexpr uintptr_t kRemoteBase = 0x80000000UL;
+  constexpr size_t kLargeBlock = 8UL << 20U;
+  constexpr size_t kSmallBlock = 64UL << 10U;
+  std::vector<adxl::TransferOpDesc> descs;
+  uintptr_t offset = 0U;
+  for (size_t i = 0U; i < 128U; ++i) {
+    const size_t len = (i < 3U) ? kLargeBlock : kSmallBlock;
+    descs.emplace_back(adxl::TransferOpDesc{kLocalBase + offset, kRemoteBase + offset, len});
+    offset += len * 2U;
+  }
+  return descs;
+}
+
+// items are descs, the round robin placement the balancer replaced. imbalance is the makespan of the most loaded
+// stream over the ideal one
+void BM_CopyStreamRoundRobin(micro_bench::State &state) {
+  const size_t stream_num = static_cast<size_t>(state.range(0));
+  const auto descs = MakeMixedCopyDescs();
+  std::vector<std::vector<adxl::TransferOpDesc>> stream_copies;
+  for (auto _ : state) {
+    stream_copies.assign(stream_num, {});
+    for (size_t i = 0U; i < descs.size(); ++i) {
+      stream_copies[i % stream_num].emplace_back(descs[i]);
+    }
+    micro_bench::DoNotOptimize(stream_copies);
+  }
+  state.counters["imbalance"] = adxl::CopyStreamBalancer::Imbalance(stream_copies);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * descs.size()));
+}
+BENCHMARK(BM_CopyStreamRoundRobin)->ArgName("streams")->Arg(2)->Arg(4)->Arg(8);
+
+// items are descs, imbalance as for BM_CopyStreamRoundRobin
+void BM_CopyStreamBalancerBalance(micro_bench::State &state) {
+  const size_t stream_num = static_cast<size_t>(state.range(0));
+  const auto descs = MakeMixedCopyDescs();
+  std::vector<std::vector<adxl::TransferOpDesc>> stream_copies;
+  for (auto _ : state) {
+    adxl::CopyStreamBalancer::Balance(descs, stream_num, stream_copies);
+    micro_bench::DoNotOptimize(stream_copies);
+  }
+  state.counters["imbalance"] = adxl::CopyStreamBalancer::Imbalance(stream_copies);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * descs.size()));
+}
+BENCHMARK(BM_CopyStreamBalancerBalance)->ArgName("streams")->Arg(2)->Arg(4)->Arg(8);
+}  // namespace
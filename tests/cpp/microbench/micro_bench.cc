@@ -0,0 +1,472 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#include "micro_bench.h"
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace micro_bench {
+namespace {
+constexpr uint64_t kMaxIterations = 1000000000UL;
+constexpr double kDefaultMinTime = 0.5;
+constexpr double kGrowthMultiplier = 1.4;
+constexpr uint64_t kMaxGrowth = 10U;
+constexpr double kNsPerSecond = 1e9;
+
+struct Options {
+  std::string filter = ".";
+  double min_time = kDefaultMinTime;
+  std::string out;
+  int32_t repetitions = 1;
+  bool list_only = false;
+};
+
+struct RunResult {
+  std::string name;
+  std::string run_name;
+  int32_t repetition_index = 0;
+  int32_t threads = 1;
+  uint64_t iterations = 0U;
+  double real_ns_per_iter = 0.0;
+  double cpu_ns_per_iter = 0.0;
+  double items_per_second = 0.0;
+  std::string label;
+  std::vector<std::pair<std::string, double>> counters;
+  std::string error;
+};
+
+std::vector<std::unique_ptr<Benchmark>> &Registry() {
+  static std::vector<std::unique_ptr<Benchmark>> registry;
+  return registry;
+}
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t ThreadCpuNs() {
+  struct timespec ts{};
+  (void)clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000L + ts.tv_nsec;
+}
+
+bool ParseFlag(const char *arg, const char *name, std::string &value) {
+  const size_t len = std::strlen(name);
+  if ((std::strncmp(arg, name, len) != 0) || (arg[len] != '=')) {
+    return false;
+  }
+  value = arg + len + 1;
+  return true;
+}
+
+bool ParseOptions(int32_t argc, char **argv, Options &options) {
+  for (int32_t i = 1; i < argc; ++i) {
+    std::string value;
+    try {
+      if (ParseFlag(argv[i], "--benchmark_filter", value)) {
+        options.filter = value;
+      } else if (ParseFlag(argv[i], "--benchmark_min_time", value)) {
+        // stod ignores the trailing "s" google benchmark accepts
+        options.min_time = std::stod(value);
+      } else if (ParseFlag(argv[i], "--benchmark_out", value)) {
+        options.out = value;
+      } else if (ParseFlag(argv[i], "--benchmark_repetitions", value)) {
+        options.repetitions = std::max(1, std::stoi(value));
+      } else if (std::strcmp(argv[i], "--benchmark_list_tests") == 0) {
+        options.list_only = true;
+      } else if (std::strncmp(argv[i], "--benchmark_out_format", std::strlen("--benchmark_out_format")) == 0) {
+        // only json is written
+      } else {
+        std::cerr << "unknown argument: " << argv[i] << std::endl;
+        return false;
+      }
+    } catch (const std::exception &) {
+      std::cerr << "invalid argument: " << argv[i] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string JsonEscape(const std::string &str) {
+  std::string escaped;
+  for (const char c : str) {
+    if ((c == '"') || (c == '\\')) {
+      escaped.push_back('\\');
+    }
+    escaped.push_back(c);
+  }
+  return escaped;
+}
+
+std::string LocalDate() {
+  const std::time_t now = std::time(nullptr);
+  struct tm local{};
+  (void)localtime_r(&now, &local);
+  char buf[64] = {};
+  (void)std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S%z", &local);
+  return buf;
+}
+
+// counters of all threads are summed, then scaled as their flags ask
+std::vector<std::pair<std::string, double>> FinishCounters(const UserCounters &summed, int32_t threads,
+                                                           uint64_t iterations, double seconds) {
+  std::vector<std::pair<std::string, double>> counters;
+  for (const auto &item : summed) {
+    const auto flags = item.second.flags;
+    double value = item.second.value;
+    if ((flags & Counter::kIsIterationInvariant) != 0U) {
+      value *= static_cast<double>(iterations);
+    }
+    if ((flags & Counter::kAvgIterations) != 0U) {
+      value /= static_cast<double>(iterations);
+    }
+    if ((flags & Counter::kAvgThreads) != 0U) {
+      value /= static_cast<double>(threads);
+    }
+    if ((flags & Counter::kIsRate) != 0U) {
+      value = (seconds > 0.0) ? (value / seconds) : 0.0;
+    }
+    counters.emplace_back(item.first, value);
+  }
+  return counters;
+}
+
+std::string HostName() {
+  char buf[256] = {};
+  (void)gethostname(buf, sizeof(buf) - 1U);
+  return buf;
+}
+}  // namespace
+
+void State::StartTimer() {
+  running_ = true;
+  real_start_ns_ = NowNs();
+  cpu_start_ns_ = ThreadCpuNs();
+}
+
+void State::StopTimer() {
+  if (!running_) {
+    return;
+  }
+  real_ns_ += NowNs() - real_start_ns_;
+  cpu_ns_ += ThreadCpuNs() - cpu_start_ns_;
+  running_ = false;
+}
+
+void State::PauseTiming() {
+  StopTimer();
+}
+
+void State::ResumeTiming() {
+  StartTimer();
+}
+
+Benchmark *Benchmark::Arg(int64_t arg) {
+  args_.push_back({arg});
+  return this;
+}
+
+Benchmark *Benchmark::Args(const std::vector<int64_t> &args) {
+  args_.push_back(args);
+  return this;
+}
+
+Benchmark *Benchmark::ArgName(const std::string &name) {
+  arg_names_ = {name};
+  return this;
+}
+
+Benchmark *Benchmark::ArgNames(const std::vector<std::string> &names) {
+  arg_names_ = names;
+  return this;
+}
+
+Benchmark *Benchmark::ArgsProduct(const std::vector<std::vector<int64_t>> &arg_lists) {
+  std::vector<std::vector<int64_t>> product = {{}};
+  for (const auto &arg_list : arg_lists) {
+    std::vector<std::vector<int64_t>> next;
+    for (const auto &prefix : product) {
+      for (const auto arg : arg_list) {
+        next.push_back(prefix);
+        next.back().push_back(arg);
+      }
+    }
+    product = std::move(next);
+  }
+  args_.insert(args_.end(), product.begin(), product.end());
+  return this;
+}
+
+Benchmark *Benchmark::Threads(int32_t threads) {
+  threads_.push_back(threads);
+  return this;
+}
+
+Benchmark *RegisterBenchmark(const std::string &name, Function func) {
+  Registry().emplace_back(new Benchmark(name, func));
+  return Registry().back().get();
+}
+
+class Runner {
+ public:
+  explicit Runner(const Options &options) : options_(options) {}
+
+  int32_t Run() {
+    std::regex filter;
+    try {
+      filter = std::regex(options_.filter);
+    } catch (const std::regex_error &) {
+      std::cerr << "invalid filter: " << options_.filter << std::endl;
+      return 1;
+    }
+    std::vector<RunResult> results;
+    for (const auto &bench : Registry()) {
+      for (const auto &instance : Expand(*bench)) {
+        if (!std::regex_search(instance.name, filter)) {
+          continue;
+        }
+        if (options_.list_only) {
+          std::cout << instance.name << std::endl;
+          continue;
+        }
+        for (int32_t rep = 0; rep < options_.repetitions; ++rep) {
+          auto result = RunInstance(instance);
+          result.repetition_index = rep;
+          PrintConsole(result);
+          results.emplace_back(std::move(result));
+        }
+      }
+    }
+    if (!options_.out.empty() && !options_.list_only) {
+      return WriteJson(results) ? 0 : 1;
+    }
+    return 0;
+  }
+
+ private:
+  struct Instance {
+    std::string name;
+    const Benchmark *bench;
+    std::vector<int64_t> args;
+    int32_t threads;
+  };
+
+  static std::vector<Instance> Expand(const Benchmark &bench) {
+    std::vector<std::vector<int64_t>> arg_sets = bench.args_;
+    if (arg_sets.empty()) {
+      arg_sets.emplace_back();
+    }
+    std::vector<int32_t> thread_counts = bench.threads_;
+    if (thread_counts.empty()) {
+      thread_counts.push_back(1);
+    }
+    std::vector<Instance> instances;
+    for (const auto &args : arg_sets) {
+      for (const auto threads : thread_counts) {
+        std::string name = bench.name_;
+        for (size_t i = 0U; i < args.size(); ++i) {
+          name += "/";
+          if ((i < bench.arg_names_.size()) && !bench.arg_names_[i].empty()) {
+            name += bench.arg_names_[i] + ":";
+          }
+          name += std::to_string(args[i]);
+        }
+        if (!bench.threads_.empty()) {
+          name += "/threads:" + std::to_string(threads);
+        }
+        instances.push_back(Instance{name, &bench, args, threads});
+      }
+    }
+    return instances;
+  }
+
+  // every thread runs the same number of iterations, real time is taken from the slowest one
+  static std::vector<State> RunOnce(const Instance &instance, uint64_t iterations) {
+    std::vector<State> states;
+    for (int32_t i = 0; i < instance.threads; ++i) {
+      states.emplace_back(iterations, instance.args, instance.threads, i);
+    }
+    if (instance.threads == 1) {
+      instance.bench->func_(states[0]);
+      return states;
+    }
+    std::mutex mutex;
+    std::condition_variable cv;
+    int32_t ready = 0;
+    std::vector<std::thread> workers;
+    for (int32_t i = 0; i < instance.threads; ++i) {
+      workers.emplace_back([&, i]() {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          ++ready;
+          cv.notify_all();
+          cv.wait(lock, [&]() { return ready == instance.threads; });
+        }
+        instance.bench->func_(states[i]);
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    return states;
+  }
+
+  RunResult RunInstance(const Instance &instance) const {
+    RunResult result;
+    result.name = instance.name;
+    result.run_name = instance.name;
+    result.threads = instance.threads;
+    uint64_t iterations = 1U;
+    while (true) {
+      auto states = RunOnce(instance, iterations);
+      int64_t real_ns = 0;
+      int64_t cpu_ns = 0;
+      int64_t items = 0;
+      UserCounters counters;
+      for (const auto &state : states) {
+        real_ns = std::max(real_ns, state.real_ns_);
+        cpu_ns += state.cpu_ns_;
+        items += state.items_processed_;
+        if (!state.error_.empty()) {
+          result.error = state.error_;
+        }
+        if (!state.label_.empty()) {
+          result.label = state.label_;
+        }
+        for (const auto &counter : state.counters) {
+          auto &sum = counters[counter.first];
+          sum.value += counter.second.value;
+          sum.flags = counter.second.flags;
+        }
+      }
+      const double seconds = static_cast<double>(real_ns) / kNsPerSecond;
+      if (!result.error.empty() || (seconds >= options_.min_time) || (iterations >= kMaxIterations)) {
+        result.iterations = iterations;
+        result.real_ns_per_iter = static_cast<double>(real_ns) / static_cast<double>(iterations);
+        result.cpu_ns_per_iter =
+            static_cast<double>(cpu_ns) / static_cast<double>(iterations) / static_cast<double>(instance.threads);
+        result.items_per_second = (seconds > 0.0) ? static_cast<double>(items) / seconds : 0.0;
+        result.counters = FinishCounters(counters, instance.threads, iterations, seconds);
+        return result;
+      }
+      iterations = NextIterations(iterations, seconds);
+    }
+  }
+
+  uint64_t NextIterations(uint64_t iterations, double seconds) const {
+    double multiplier = kMaxGrowth;
+    if (seconds > 0.0) {
+      multiplier = std::min(static_cast<double>(kMaxGrowth), options_.min_time * kGrowthMultiplier / seconds);
+    }
+    const auto next = static_cast<uint64_t>(static_cast<double>(iterations) * multiplier);
+    return std::min(kMaxIterations, std::max(iterations + 1U, next));
+  }
+
+  static void PrintConsole(const RunResult &result) {
+    if (!result.error.empty()) {
+      std::printf("%-60s ERROR: %s\n", result.name.c_str(), result.error.c_str());
+      return;
+    }
+    std::printf("%-60s %12.1f ns %12.1f ns %12lu", result.name.c_str(), result.real_ns_per_iter,
+                result.cpu_ns_per_iter, result.iterations);
+    if (result.items_per_second > 0.0) {
+      std::printf(" items_per_second=%.4gM/s", result.items_per_second / 1e6);
+    }
+    for (const auto &counter : result.counters) {
+      std::printf(" %s=%.4g", counter.first.c_str(), counter.second);
+    }
+    if (!result.label.empty()) {
+      std::printf(" %s", result.label.c_str());
+    }
+    std::printf("\n");
+  }
+
+  bool WriteJson(const std::vector<RunResult> &results) const {
+    std::ofstream out(options_.out);
+    if (!out.is_open()) {
+      std::cerr << "failed to open " << options_.out << std::endl;
+      return false;
+    }
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": \"" << LocalDate() << "\",\n";
+    out << "    \"host_name\": \"" << JsonEscape(HostName()) << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"\n";
+#else
+    out << "    \"library_build_type\": \"debug\"\n";
+#endif
+    out << "  },\n  \"benchmarks\": [";
+    for (size_t i = 0U; i < results.size(); ++i) {
+      const auto &result = results[i];
+      out << ((i == 0U) ? "\n" : ",\n") << "    {\n";
+      out << "      \"name\": \"" << JsonEscape(result.name) << "\",\n";
+      out << "      \"run_name\": \"" << JsonEscape(result.run_name) << "\",\n";
+      out << "      \"run_type\": \"iteration\",\n";
+      out << "      \"repetitions\": " << options_.repetitions << ",\n";
+      out << "      \"repetition_index\": " << result.repetition_index << ",\n";
+      out << "      \"threads\": " << result.threads << ",\n";
+      if (!result.error.empty()) {
+        out << "      \"error_occurred\": true,\n";
+        out << "      \"error_message\": \"" << JsonEscape(result.error) << "\"\n    }";
+        continue;
+      }
+      out << "      \"iterations\": " << result.iterations << ",\n";
+      out << "      \"real_time\": " << result.real_ns_per_iter << ",\n";
+      out << "      \"cpu_time\": " << result.cpu_ns_per_iter << ",\n";
+      out << "      \"time_unit\": \"ns\"";
+      if (result.items_per_second > 0.0) {
+        out << ",\n      \"items_per_second\": " << result.items_per_second;
+      }
+      for (const auto &counter : result.counters) {
+        out << ",\n      \"" << JsonEscape(counter.first) << "\": " << counter.second;
+      }
+      if (!result.label.empty()) {
+        out << ",\n      \"label\": \"" << JsonEscape(result.label) << "\"";
+      }
+      out << "\n    }";
+    }
+    out << "\n  ]\n}\n";
+    return true;
+  }
+
+  Options options_;
+};
+
+int32_t RunSpecifiedBenchmarks(int32_t argc, char **argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    return 1;
+  }
+  if (!options.list_only) {
+    std::printf("%-60s %15s %15s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+  }
+  return Runner(options).Run();
+}
+}  // namespace micro_bench
+
+int main(int argc, char **argv) {
+  return micro_bench::RunSpecifiedBenchmarks(argc, argv);
+}
@@ -0,0 +1,183 @@
+/**
+ * This program is free software, you can redistribute it and/or modify it.
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd.
+ * This file is a part of the CANN Open Software.
+ * Licensed under CANN Open Software License Agreement Version 2.0 (the "License").
+ * Please refer to the License for details. You may not use this file except in compliance with the License.
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE.
+ * See LICENSE in the root of the software repository for the full text of the License.
+ */
+
+#ifndef HIXL_TESTS_CPP_MICROBENCH_MICRO_BENCH_H_
+#define HIXL_TESTS_CPP_MICROBENCH_MICRO_BENCH_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// a minimal subset of the google benchmark api, benchmarks written against it build with either one.
+// results are written in the google benchmark json format so tools/compare.py can diff two runs.
+namespace micro_bench {
+// a value reported next to the timings, summed over threads unless flags say otherwise
+class Counter {
+ public:
+  enum Flags : uint32_t {
+    kDefaults = 0U,
+    kIsRate = 1U << 0U,                // divided by the real time of the run in seconds
+    kAvgThreads = 1U << 1U,            // divided by the number of threads
+    kAvgThreadsRate = kIsRate | kAvgThreads,
+    kIsIterationInvariant = 1U << 2U,  // multiplied by the iterations, for values set once per run
+    kIsIterationInvariantRate = kIsRate | kIsIterationInvariant,
+    kAvgIterations = 1U << 3U,         // divided by the iterations
+    kAvgIterationsRate = kIsRate | kAvgIterations
+  };
+
+  Counter(double value = 0.0, Flags flags = kDefaults) : value(value), flags(flags) {}
+  operator double const &() const {
+    return value;
+  }
+  operator double &() {
+    return value;
+  }
+
+  double value;
+  Flags flags;
+};
+
+using UserCounters = std::map<std::string, Counter>;
+
+class State {
+ public:
+  struct __attribute__((unused)) Value {};
+
+  class Iterator {
+   public:
+    Iterator(State *state, uint64_t remaining) : state_(state), remaining_(remaining) {}
+    Value operator*() const {
+      return Value{};
+    }
+    Iterator &operator++() {
+      --remaining_;
+      return *this;
+    }
+    bool operator!=(const Iterator &) {
+      if (remaining_ != 0U) {
+        return true;
+      }
+      state_->StopTimer();
+      return false;
+    }
+
+   private:
+    State *state_;
+    uint64_t remaining_;
+  };
+
+  State(uint64_t max_iterations, const std::vector<int64_t> &args, int32_t threads, int32_t thread_index)
+      : max_iterations_(max_iterations), args_(args), threads_(threads), thread_index_(thread_index) {}
+
+  Iterator begin() {
+    StartTimer();
+    return Iterator(this, max_iterations_);
+  }
+  Iterator end() {
+    return Iterator(this, 0U);
+  }
+
+  int64_t range(size_t index = 0U) const {
+    return args_.at(index);
+  }
+  int32_t threads() const {
+    return threads_;
+  }
+  int32_t thread_index() const {
+    return thread_index_;
+  }
+  uint64_t iterations() const {
+    return max_iterations_;
+  }
+  void SetItemsProcessed(int64_t items) {
+    items_processed_ = items;
+  }
+  void SkipWithError(const std::string &msg) {
+    error_ = msg;
+  }
+  void SetLabel(const std::string &label) {
+    label_ = label;
+  }
+  // exclude setup done inside the loop from the measurement
+  void PauseTiming();
+  void ResumeTiming();
+
+  UserCounters counters;
+
+ private:
+  friend class Runner;
+  void StartTimer();
+  void StopTimer();
+
+  uint64_t max_iterations_;
+  std::vector<int64_t> args_;
+  int32_t threads_;
+  int32_t thread_index_;
+  int64_t items_processed_ = 0;
+  std::string error_;
+  std::string label_;
+  bool running_ = false;
+  int64_t real_start_ns_ = 0;
+  int64_t cpu_start_ns_ = 0;
+  int64_t real_ns_ = 0;
+  int64_t cpu_ns_ = 0;
+};
+
+using Function = void (*)(State &);
+
+class Benchmark {
+ public:
+  Benchmark(const std::string &name, Function func) : name_(name), func_(func) {}
+  Benchmark *Arg(int64_t arg);
+  Benchmark *Args(const std::vector<int64_t> &args);
+  Benchmark *ArgName(const std::string &name);
+  Benchmark *ArgNames(const std::vector<std::string> &names);
+  // cartesian product of every argument list
+  Benchmark *ArgsProduct(const std::vector<std::vector<int64_t>> &arg_lists);
+  Benchmark *Threads(int32_t threads);
+
+ private:
+  friend class Runner;
+  std::string name_;
+  Function func_;
+  std::vector<std::vector<int64_t>> args_;
+  std::vector<std::string> arg_names_;
+  std::vector<int32_t> threads_;
+};
+
+Benchmark *RegisterBenchmark(const std::string &name, Function func);
+
+// supported flags: --benchmark_filter=<regex> --benchmark_min_time=<seconds>
+// --benchmark_out=<file> --benchmark_repetitions=<n> --benchmark_list_tests
+int32_t RunSpecifiedBenchmarks(int32_t argc, char **argv);
+
+template <typename T>
+inline void DoNotOptimize(T const &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename T>
+inline void DoNotOptimize(T &value) {
+  asm volatile("" : "+r,m"(value) : : "memory");
+}
+
+inline void ClobberMemory() {
+  asm volatile("" : : : "memory");
+}
+}  // namespace micro_bench
+
+#define MICRO_BENCH_CONCAT_IMPL(a, b) a##b
+#define MICRO_BENCH_CONCAT(a, b) MICRO_BENCH_CONCAT_IMPL(a, b)
+#define BENCHMARK(func)                                                                      \
+  static ::micro_bench::Benchmark *MICRO_BENCH_CONCAT(micro_bench_registered_, __LINE__) \
+      __attribute__((unused)) = ::micro_bench::RegisterBenchmark(#func, func)
+
+#endif  // HIXL_TESTS_CPP_MICROBENCH_MICRO_BENCH_H_
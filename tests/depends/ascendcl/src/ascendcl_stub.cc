@@ -353,6 +353,18 @@ aclError AclRuntimeStub::aclrtFreeHost(void *devPtr) {
   return ACL_ERROR_NONE;
 }
 
+aclError AclRuntimeStub::aclrtHostRegister(void *ptr, uint64_t size, aclrtHostRegisterType type, void **devPtr) {
+  (void)size;
+  (void)type;
+  *devPtr = ptr;
+  return ACL_ERROR_NONE;
+}
+
+aclError AclRuntimeStub::aclrtHostUnregister(void *ptr) {
+  (void)ptr;
+  return ACL_ERROR_NONE;
+}
+
 aclError AclRuntimeStub::aclrtMemcpy(void *dst, size_t dest_max, const void *src, size_t count, aclrtMemcpyKind kind) {
   const char * const kEnvRecordPath = "CONSTANT_FOLDING_PASS";
   char record_path[MMPA_MAX_PATH] = {};
@@ -659,6 +671,14 @@ aclError aclrtFreeHost(void *devPtr) {
   return llm::AclRuntimeStub::GetInstance()->aclrtFreeHost(devPtr);
 }
 
+aclError aclrtHostRegister(void *ptr, uint64_t size, aclrtHostRegisterType type, void **devPtr) {
+  return llm::AclRuntimeStub::GetInstance()->aclrtHostRegister(ptr, size, type, devPtr);
+}
+
+aclError aclrtHostUnregister(void *ptr) {
+  return llm::AclRuntimeStub::GetInstance()->aclrtHostUnregister(ptr);
+}
+
 aclError aclrtMemcpy(void *dst, size_t dest_max, const void *src, size_t count, aclrtMemcpyKind kind) {
   return llm::AclRuntimeStub::GetInstance()->aclrtMemcpy(dst, dest_max, src, count, kind);
 }
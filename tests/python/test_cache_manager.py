@@ -11,7 +11,10 @@
 # See LICENSE in the root of the software repository for the full text of the License.
 # ----------------------------------------------------------------------------
 
+import array
+import json
 import os.path
+import tempfile
 import time
 import unittest
 import ctypes
@@ -244,6 +247,77 @@ class LlmCacheManagerSt(unittest.TestCase):
             self.has_exception = True
         self.assertEqual(self.has_exception, False)
 
+    def test_swap_blocks_with_disk_not_enabled(self):
+        cache_manager = self.llm_datadist.cache_manager
+        cpu_cache, tmp_cache = self._allocate_cpu_cache(cache_manager, 64 * 1024, 4, 2)
+        with self.assertRaises(LLMException) as ex:
+            cache_manager.swap_blocks_to_disk(cpu_cache, 1, {0: 0})
+        self.assertEqual(ex.exception.status_code, LLMStatusCode.LLM_FEATURE_NOT_ENABLED)
+        cache_manager.deallocate_blocks_cache(tmp_cache)
+
+    @staticmethod
+    def _to_block_mapping_buffer(src_to_dst):
+        flat = array.array('q', [index for pair in src_to_dst.items() for index in pair])
+        return memoryview(flat).cast('B').cast('q', [len(src_to_dst), 2])
+
+    def test_pull_blocks_with_buffer(self):
+        self.create_link()
+        cache_mgr = self.llm_datadist.cache_manager
+        cache_desc = CacheDesc(1, [2, 4], DataType.DT_INT8, Placement.DEVICE)
+        src_blocks_cache_key = BlocksCacheKey(2, 0)
+        src_blocks_cache = cache_mgr.allocate_blocks_cache(cache_desc, src_blocks_cache_key)
+        dst_blocks_cache = cache_mgr.allocate_blocks_cache(cache_desc)
+        cache_mgr.pull_blocks(src_blocks_cache_key, dst_blocks_cache, array.array('q', [0, 1]),
+                              memoryview(array.array('q', [1, 0])))
+        with self.assertRaises(TypeError):
+            cache_mgr.pull_blocks(src_blocks_cache_key, dst_blocks_cache, array.array('i', [0]), [0])
+        with self.assertRaises(TypeError):
+            cache_mgr.pull_blocks(src_blocks_cache_key, dst_blocks_cache, [0],
+                                  self._to_block_mapping_buffer({0: 0}))
+        with self.assertRaises(ValueError):
+            cache_mgr.pull_blocks(src_blocks_cache_key, dst_blocks_cache, array.array('q', [0, -1]),
+                                  array.array('q', [1, 0]))
+        cache_mgr.deallocate_blocks_cache(dst_blocks_cache)
+        cache_mgr.deallocate_blocks_cache(src_blocks_cache)
+
+    def test_swap_blocks_with_buffer(self):
+        cache_manager = self.llm_datadist.cache_manager
+        npu_cache, npu_cache_key = self._allocate_npu_cache(cache_manager, 64 * 1024, 10, 10)
+        cpu_cache, tmp_cache = self._allocate_cpu_cache(cache_manager, 64 * 1024, 20, 10)
+        src_to_dst = self._to_block_mapping_buffer({3: 4, 0: 0, 1: 1, 2: 2, 5: 6, 6: 7, 7: 8, 9: 9})
+        cache_manager.swap_blocks(npu_cache, cpu_cache, src_to_dst)
+        cache_manager.swap_blocks(cpu_cache, npu_cache, src_to_dst)
+        with self.assertRaises(LLMException) as ex:
+            cache_manager.swap_blocks(npu_cache, cpu_cache, self._to_block_mapping_buffer({10: 0}))
+        self.assertEqual(ex.exception.status_code, LLMStatusCode.LLM_PARAM_INVALID)
+        with self.assertRaises(LLMException):
+            cache_manager.swap_blocks(npu_cache, cpu_cache, array.array('q', [0, 0]))
+        cache_manager.deallocate_blocks_cache(npu_cache)
+        cache_manager.deallocate_blocks_cache(cpu_cache)
+
+    def test_swap_blocks_list_vs_buffer(self):
+        num_blocks = 10000
+        cache_manager = self.llm_datadist.cache_manager
+        npu_cache, npu_cache_key = self._allocate_npu_cache(cache_manager, 64, num_blocks, 2)
+        cpu_cache, tmp_cache = self._allocate_cpu_cache(cache_manager, 64, num_blocks, 2)
+        src_to_dst = {i: num_blocks - 1 - i for i in range(num_blocks)}
+        src_to_dst_buffer = self._to_block_mapping_buffer(src_to_dst)
+        block_bytes = 64 * 2
+        tensor_bytes = num_blocks * block_bytes
+        for addr in npu_cache.tensor_addrs:
+            ctypes.memmove(addr, os.urandom(tensor_bytes), tensor_bytes)
+        cache_manager.swap_blocks(npu_cache, cpu_cache, src_to_dst)
+        dict_result = [ctypes.string_at(addr, tensor_bytes) for addr in cpu_cache.tensor_addrs]
+        for addr in cpu_cache.tensor_addrs:
+            ctypes.memset(addr, 0, tensor_bytes)
+        cache_manager.swap_blocks(npu_cache, cpu_cache, src_to_dst_buffer)
+        buffer_result = [ctypes.string_at(addr, tensor_bytes) for addr in cpu_cache.tensor_addrs]
+        self.assertEqual(dict_result, buffer_result)
+        src_first_block = ctypes.string_at(npu_cache.tensor_addrs[0], block_bytes)
+        self.assertEqual(buffer_result[0][-block_bytes:], src_first_block)
+        cache_manager.deallocate_blocks_cache(npu_cache)
+        cache_manager.deallocate_blocks_cache(cpu_cache)
+
     def test_switch_role(self):
         try:
             self.llm_datadist.switch_role(LLMRole.DECODER)
@@ -402,6 +476,40 @@ class LlmCacheManagerSt(unittest.TestCase):
         cache_mgr.deallocate_blocks_cache(dst_blocks_cache)
         cache_mgr.deallocate_cache(src_cache)
 
+class LlmCacheManagerDiskTierSt(unittest.TestCase):
+
+    def setUp(self) -> None:
+        print("Begin ", self._testMethodName)
+        self.disk_dir = tempfile.TemporaryDirectory()
+        config = LlmConfig()
+        config.device_id = 0
+        config.enable_cache_manager = True
+        config.mem_pool_cfg = "{\"memory_size\": 102428800}"
+        config.disk_tier_cfg = json.dumps({"path": self.disk_dir.name, "capacity": 64 * 64 * 1024})
+        engine_options = config.generate_options()
+        self.assertEqual(engine_options["llm.DiskTierConfig"], config.disk_tier_cfg)
+        self.llm_datadist = LLMDataDist(LLMRole.PROMPT, 3)
+        self.llm_datadist.init(engine_options)
+
+    def tearDown(self) -> None:
+        print("End ", self._testMethodName)
+        self.llm_datadist.finalize()
+        self.disk_dir.cleanup()
+
+    def test_swap_blocks_with_disk(self):
+        cache_manager = self.llm_datadist.cache_manager
+        cpu_cache, tmp_cache = LlmCacheManagerSt._allocate_cpu_cache(cache_manager, 64 * 1024, 8, 2)
+        cache_manager.swap_blocks_to_disk(cpu_cache, 1, {0: 10, 1: 11, 5: 12})
+        cache_manager.swap_blocks_from_disk(1, cpu_cache, {10: 2, 11: 3, 12: 4})
+        with self.assertRaises(LLMException) as ex:
+            cache_manager.swap_blocks_from_disk(2, cpu_cache, {10: 2})
+        self.assertEqual(ex.exception.status_code, LLMStatusCode.LLM_KV_CACHE_NOT_EXIST)
+        with self.assertRaises(LLMException) as ex:
+            cache_manager.swap_blocks_to_disk(cpu_cache, 1, {8: 0})
+        self.assertEqual(ex.exception.status_code, LLMStatusCode.LLM_PARAM_INVALID)
+        cache_manager.deallocate_blocks_cache(tmp_cache)
+
+
 class LlmCacheManagerDecoderSt(unittest.TestCase):
 
     def setUp(self) -> None:
@@ -16,7 +16,7 @@ BASEPATH=$(cd "$(dirname $0)/.."; pwd)
 # print usage message
 usage() {
   echo "Usage:"
-  echo "sh run_test.sh [-c | --cov] [-j<N>] [-h | --help] [-v | --verbose]"
+  echo "sh run_test.sh [-c | --cov] [-b | --bench] [-j<N>] [-h | --help] [-v | --verbose]"
   echo "               [--cann_3rd_lib_path=<PATH> | --cann-3rd-lib-path=<PATH>] [--asan]"
   echo ""
   echo "Options:"
@@ -27,6 +27,8 @@ usage() {
   echo "    -c, --cov      Build test with coverage tag"
   echo "                   Please ensure that the environment has correctly installed lcov, gcov, and genhtml."
   echo "                   and the version matched gcc/g++, default is OFF."
+  echo "    -b, --bench    Build and run the host side microbenchmarks after cpp test,"
+  echo "                   results are written to report/hixl_microbench.json, default is OFF."
   echo "    -v, --verbose  Display build command"
   echo "    -j<N>          Set the number of threads used for building Parser, default 8"
   echo "        --cann_3rd_lib_path=<PATH> | --cann-3rd-lib-path=<PATH>"
@@ -51,10 +53,11 @@ checkopts() {
   ENABLE_PY_TEST=ON
   ENABLE_ASAN=OFF
   ENABLE_GCOV=OFF
+  ENABLE_BENCHMARKS=OFF
 
   CANN_3RD_LIB_PATH="$BASEPATH/third_party"
 
-  parsed_args=$(getopt -a -o t::cj:hv -l test::,cov,help,verbose,cann_3rd_lib_path:,cann-3rd-lib-path:,asan -- "$@") || {
+  parsed_args=$(getopt -a -o t::cbj:hv -l test::,cov,bench,help,verbose,cann_3rd_lib_path:,cann-3rd-lib-path:,asan -- "$@") || {
     usage
     exit 1
   }
@@ -95,6 +98,10 @@ checkopts() {
         ENABLE_ASAN=ON
         shift
         ;;
+      -b | --bench)
+        ENABLE_BENCHMARKS=ON
+        shift
+        ;;
       -h | --help)
         usage
         exit 1
@@ -129,6 +136,7 @@ build() {
   cmake -D ENABLE_TEST=ON \
         -D ENABLE_ASAN=${ENABLE_ASAN} \
         -D ENABLE_GCOV=${ENABLE_GCOV} \
+        -D ENABLE_BENCHMARKS=${ENABLE_BENCHMARKS} \
         -D CANN_3RD_LIB_PATH=${CANN_3RD_LIB_PATH} \
         -D CMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE} \
         -D CMAKE_INSTALL_PREFIX=${OUTPUT_PATH} \
@@ -183,6 +191,10 @@ run() {
       fi
   fi
 
+  if [[ "X$ENABLE_BENCHMARKS" = "XON" ]]; then
+      ${BUILD_PATH}/tests/cpp/microbench/hixl_microbench --benchmark_out=${report_dir}/hixl_microbench.json
+  fi
+
   if [[ "X$ENABLE_PY_TEST" = "XON" ]]; then
       unset LD_PRELOAD
       cp ${BUILD_PATH}/tests/depends/python/llm_datadist_wrapper.so ${BASEPATH}/src/python/llm_datadist/llm_datadist/